@@ -172,6 +172,8 @@ declare namespace jsb {
 
         export function getPlayingAudioCount (): number;
         export function getMaxAudioInstance (): number;
+        export function getPCMCacheBudget (): number;
+        export function setPCMCacheBudget (bytes: number);
         export function getState (id: number): any;
         export function getDuration (id: number): number;
         export function getVolume (id: number): number;
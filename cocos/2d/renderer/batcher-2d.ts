@@ -64,6 +64,23 @@ export class Batcher2D implements IBatcher {
         return this._nativeObj;
     }
 
+    /**
+     * @en
+     * Whether the native batcher reuses the batches of root nodes whose subtree did not change since last frame.
+     * The switch takes effect from the next frame. Only supported on native platforms.
+     * @zh
+     * 原生合批器是否复用上一帧后子树未变化的根节点的合批结果。切换在下一帧生效，仅原生平台支持。
+     */
+    get retainedMode (): boolean {
+        return JSB ? this._nativeObj.retainedMode : false;
+    }
+
+    set retainedMode (value: boolean) {
+        if (JSB) {
+            this._nativeObj.retainedMode = value;
+        }
+    }
+
     get currBufferAccessor () {
         if (this._staticVBBuffer) return this._staticVBBuffer;
         // create if not set
@@ -105,6 +105,7 @@ export declare class NativeUIMeshBuffer {
 }
 
 export declare class NativeBatcher2d {
+    retainedMode: boolean;
     syncMeshBuffersToNative(accId: number, buffers: NativeUIMeshBuffer[]);
     update();
     uploadBuffers();
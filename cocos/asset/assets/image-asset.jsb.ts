@@ -177,6 +177,9 @@ imageAssetProto._syncDataToNative = function () {
     }
     else if (data instanceof jsbWindow.HTMLImageElement) {
         this.setData(data._data);
+        if (data._format !== undefined) {
+            this.format = data._format;
+        }
         if (data._mipmapLevelDataSize){
             this.setMipmapLevelDataSize(data._mipmapLevelDataSize);
         }
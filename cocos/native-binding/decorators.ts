@@ -715,13 +715,15 @@ interface cc_OctreeInfo_Context_Args {
    DEFAULT_WORLD_MIN_POS: any;
    DEFAULT_WORLD_MAX_POS: any;
    DEFAULT_OCTREE_DEPTH: any;
+   SpatialIndexType: any;
 }
 export function patch_cc_OctreeInfo(ctx: cc_OctreeInfo_Context_Args, apply = defaultExec) {
-  const { OctreeInfo, CCInteger, Vec3, DEFAULT_WORLD_MIN_POS, DEFAULT_WORLD_MAX_POS, DEFAULT_OCTREE_DEPTH } = { ...ctx };
+  const { OctreeInfo, CCInteger, Vec3, DEFAULT_WORLD_MIN_POS, DEFAULT_WORLD_MAX_POS, DEFAULT_OCTREE_DEPTH, SpatialIndexType } = { ...ctx };
   const enabledDescriptor = Object.getOwnPropertyDescriptor(OctreeInfo.prototype, 'enabled');
   const minPosDescriptor = Object.getOwnPropertyDescriptor(OctreeInfo.prototype, 'minPos');
   const maxPosDescriptor = Object.getOwnPropertyDescriptor(OctreeInfo.prototype, 'maxPos');
   const depthDescriptor = Object.getOwnPropertyDescriptor(OctreeInfo.prototype, 'depth');
+  const spatialIndexDescriptor = Object.getOwnPropertyDescriptor(OctreeInfo.prototype, 'spatialIndex');
   apply(() => { $.tooltip('i18n:octree_culling.enabled')(OctreeInfo.prototype, 'enabled',  enabledDescriptor); }, 'tooltip', 'enabled');
   apply(() => { $.editable(OctreeInfo.prototype, 'enabled',  enabledDescriptor); }, 'editable', 'enabled');
   apply(() => { $.displayName('World MinPos')(OctreeInfo.prototype, 'minPos',  minPosDescriptor); }, 'displayName', 'minPos');
@@ -735,10 +737,14 @@ export function patch_cc_OctreeInfo(ctx: cc_OctreeInfo_Context_Args, apply = def
   apply(() => { $.slide(OctreeInfo.prototype, 'depth',  depthDescriptor); }, 'slide', 'depth');
   apply(() => { $.range([4, 12, 1])(OctreeInfo.prototype, 'depth',  depthDescriptor); }, 'range', 'depth');
   apply(() => { $.editable(OctreeInfo.prototype, 'depth',  depthDescriptor); }, 'editable', 'depth');
+  apply(() => { $.tooltip('i18n:octree_culling.spatialIndex')(OctreeInfo.prototype, 'spatialIndex',  spatialIndexDescriptor); }, 'tooltip', 'spatialIndex');
+  apply(() => { $.type(SpatialIndexType)(OctreeInfo.prototype, 'spatialIndex'); }, 'type', 'spatialIndex');
+  apply(() => { $.editable(OctreeInfo.prototype, 'spatialIndex',  spatialIndexDescriptor); }, 'editable', 'spatialIndex');
   apply(() => { $.serializable(OctreeInfo.prototype, '_enabled',  () => { return false; }); }, 'serializable', '_enabled');
   apply(() => { $.serializable(OctreeInfo.prototype, '_minPos',  () => { return new Vec3(DEFAULT_WORLD_MIN_POS); }); }, 'serializable', '_minPos');
   apply(() => { $.serializable(OctreeInfo.prototype, '_maxPos',  () => { return new Vec3(DEFAULT_WORLD_MAX_POS); }); }, 'serializable', '_maxPos');
   apply(() => { $.serializable(OctreeInfo.prototype, '_depth',  () => { return DEFAULT_OCTREE_DEPTH; }); }, 'serializable', '_depth');
+  apply(() => { $.serializable(OctreeInfo.prototype, '_spatialIndex',  () => { return SpatialIndexType.OCTREE; }); }, 'serializable', '_spatialIndex');
   apply(() => { $.ccclass('cc.OctreeInfo')(OctreeInfo); }, 'ccclass', null);
 } // end of patch_cc_OctreeInfo
 
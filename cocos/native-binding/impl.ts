@@ -144,6 +144,7 @@ export const native = {
     DownloaderHints: globalJsb.DownloaderHints,
     Downloader: globalJsb.Downloader,
     zipUtils: globalJsb.zipUtils,
+    profiler: globalJsb.profiler,
     fileUtils: globalJsb.fileUtils,
     DebugRenderer: globalJsb.DebugRenderer,
     copyTextToClipboard: globalJsb.copyTextToClipboard?.bind(globalJsb),
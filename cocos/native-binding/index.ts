@@ -738,6 +738,30 @@ export declare namespace native {
         export function setPvrEncryptionKey(keyPart1: number, keyPart2: number, keyPart3: number, keyPart4: number): void;
     }
 
+    /**
+     * @en Native profiler tracing. Only works in builds with the native profiler enabled.
+     * @zh 原生性能分析器的跟踪功能，仅在启用了原生性能分析器的构建中有效。
+     */
+    export namespace profiler {
+        /**
+         * @en
+         * Record the profiled blocks of all native threads into a Chrome trace file,
+         * which can be opened in chrome://tracing or ui.perfetto.dev.
+         * @zh
+         * 将所有原生线程的性能分析区块记录到 Chrome trace 文件中，可以在 chrome://tracing 或 ui.perfetto.dev 中打开。
+         *
+         * @param path @en The trace file path. @zh 跟踪文件的路径。
+         * @param frameCount @en Stop and save after this many frames, 0 to go on until stopTrace. @zh 记录多少帧后自动停止并保存，0 表示一直记录直到调用 stopTrace。
+         */
+        export function startTrace(path: string, frameCount?: number): void;
+
+        /**
+         * @en Stop the running trace and save it.
+         * @zh 停止当前的跟踪并保存。
+         */
+        export function stopTrace(): void;
+    }
+
     /**
      * FileUtils  Helper class to handle file operations.
      */
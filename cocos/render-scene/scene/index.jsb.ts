@@ -316,6 +316,18 @@ export const EnvironmentLightingType = Enum({
      */
     DIFFUSEMAP_WITH_REFLECTION: 2,
 });
+export const SpatialIndexType = Enum({
+    /**
+     * @en Octree bounded by the world bounding box
+     * @zh 以世界包围盒为界的八叉树
+     */
+    OCTREE: 0,
+    /**
+     * @en Dynamic AABB tree without fixed world bounds, suits scenes with many moving models
+     * @zh 无固定世界边界的动态包围盒树，适合大量移动模型的场景
+     */
+    AABB_TREE: 1,
+});
 
 export const ShadowsInfo: typeof JsbShadowsInfo = jsb.ShadowsInfo;
 export type ShadowsInfo = JsbShadowsInfo;
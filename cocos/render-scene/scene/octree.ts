@@ -22,9 +22,27 @@
  THE SOFTWARE.
 */
 
-import { Vec3 } from '../../core';
+import { Vec3, Enum } from '../../core';
 import { OctreeInfo } from '../../scene-graph/scene-globals';
 
+/**
+ * @en The spatial index used to cull the models of the render scene
+ * @zh 渲染场景剔除模型使用的空间索引
+ */
+export const SpatialIndexType = Enum({
+    /**
+     * @en Octree bounded by the world bounding box
+     * @zh 以世界包围盒为界的八叉树
+     */
+    OCTREE: 0,
+    /**
+     * @en Dynamic AABB tree without fixed world bounds, suits scenes with many moving models
+     * @zh 无固定世界边界的动态包围盒树，适合大量移动模型的场景
+     */
+    AABB_TREE: 1,
+});
+export type SpatialIndexType = EnumAlias<typeof SpatialIndexType>;
+
 /**
  * @en The octree culling configuration of the render scene
  * @zh 渲染场景的八叉树剔除配置
@@ -75,15 +93,29 @@ export class Octree {
         this._depth = val;
     }
 
+    /**
+     * @en The spatial index used to store the models
+     * @zh 存储模型使用的空间索引
+     */
+    get spatialIndex (): SpatialIndexType {
+        return this._spatialIndex;
+    }
+
+    set spatialIndex (val: SpatialIndexType) {
+        this._spatialIndex = val;
+    }
+
     protected _enabled = false;
     protected _minPos = new Vec3(0, 0, 0);
     protected _maxPos = new Vec3(0, 0, 0);
     protected _depth = 0;
+    protected _spatialIndex: SpatialIndexType = SpatialIndexType.OCTREE;
 
     public initialize (octreeInfo: OctreeInfo) {
         this._enabled = octreeInfo.enabled;
         this._minPos = octreeInfo.minPos;
         this._maxPos = octreeInfo.maxPos;
         this._depth = octreeInfo.depth;
+        this._spatialIndex = octreeInfo.spatialIndex;
     }
 }
@@ -30,7 +30,7 @@ import { Color, Quat, Vec3, Vec2, Vec4 } from '../core/math';
 import { Ambient } from '../render-scene/scene/ambient';
 import { Shadows, ShadowType, ShadowSize } from '../render-scene/scene/shadows';
 import { Skybox, EnvironmentLightingType } from '../render-scene/scene/skybox';
-import { Octree } from '../render-scene/scene/octree';
+import { Octree, SpatialIndexType } from '../render-scene/scene/octree';
 import { Fog, FogType } from '../render-scene/scene/fog';
 import { LightProbesData, LightProbes } from '../gi/light-probe/light-probe';
 import { Node } from './node';
@@ -1033,6 +1033,21 @@ export class OctreeInfo {
         return this._depth;
     }
 
+    /**
+     * @en The spatial index used for culling, the AABB tree has no fixed world bounds and suits many moving models.
+     * @zh 剔除使用的空间索引，包围盒树没有固定的世界边界，适合大量移动模型的场景。
+     */
+    @editable
+    @type(SpatialIndexType)
+    @tooltip('i18n:octree_culling.spatialIndex')
+    set spatialIndex (val: SpatialIndexType) {
+        this._spatialIndex = val;
+        if (this._resource) { this._resource.spatialIndex = val; }
+    }
+    get spatialIndex () {
+        return this._spatialIndex;
+    }
+
     @serializable
     protected _enabled = false;
     @serializable
@@ -1041,6 +1056,8 @@ export class OctreeInfo {
     protected _maxPos = new Vec3(DEFAULT_WORLD_MAX_POS);
     @serializable
     protected _depth = DEFAULT_OCTREE_DEPTH;
+    @serializable
+    protected _spatialIndex: SpatialIndexType = SpatialIndexType.OCTREE;
 
     protected _resource: Octree | null = null;
 
@@ -1111,6 +1111,7 @@ module.exports = {
         minPos: 'The minimum position of the world bounding box.',
         maxPos: 'The maximum position of the world bounding box.',
         depth: 'The depth of octree.',
+        spatialIndex: 'The spatial index used for culling. The AABB tree has no fixed world bounds and suits many moving models.',
     },
     light_probe: {
         giScale: 'The value of GI multiplier.',
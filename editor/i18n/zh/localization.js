@@ -1092,6 +1092,7 @@ module.exports = {
         minPos: '世界包围盒最小顶点的坐标',
         maxPos: '世界包围盒最大顶点的坐标',
         depth: '八叉树深度',
+        spatialIndex: '剔除使用的空间索引，包围盒树没有固定的世界边界，适合大量移动模型的场景',
     },
     light_probe: {
         giScale: 'GI乘数',
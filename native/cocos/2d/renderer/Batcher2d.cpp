@@ -23,11 +23,13 @@
 ****************************************************************************/
 
 #include "2d/renderer/Batcher2d.h"
+#include <algorithm>
 #include "application/ApplicationManager.h"
 #include "base/TypeDef.h"
 #include "core/Root.h"
 #include "core/scene-graph/Scene.h"
 #include "editor-support/MiddlewareManager.h"
+#include "profiler/Profiler.h"
 #include "renderer/pipeline/Define.h"
 #include "scene/Pass.h"
 
@@ -47,6 +49,15 @@ Batcher2d::Batcher2d(Root* root)
 }
 
 Batcher2d::~Batcher2d() { // NOLINT
+    if (_retainedMode) {
+        // batches of the current frame belong to the retained roots or are transient
+        for (auto* batch : _transientBatches) {
+            _drawBatchPool.free(batch);
+        }
+        _transientBatches.clear();
+        _batches.clear();
+    }
+    releaseRetainedRoots();
     _drawBatchPool.destroy();
 
     for (auto iter : _descriptorSetCache) {
@@ -94,11 +105,20 @@ void Batcher2d::syncRootNodesToNative(ccstd::vector<Node*>&& rootNodes) {
 }
 
 void Batcher2d::fillBuffersAndMergeBatches() {
+    _rebatchedEntityCount = 0;
+    _retainedEntityCount = 0;
+    if (_retainedMode) {
+        fillRetainedBatches();
+        return;
+    }
+
     size_t index = 0;
     for (auto* rootNode : _rootNodeArr) {
         // _batches will add by generateBatch
         walk(rootNode, 1);
         generateBatch(_currEntity, _currDrawInfo);
+        // the last batch is flushed, the next root must not flush it again as an empty batch
+        resetRenderStates();
 
         auto* scene = rootNode->getScene()->getRenderScene();
         size_t const count = _batches.size();
@@ -132,6 +152,11 @@ void Batcher2d::walk(Node* node, float parentOpacity) { // NOLINT(misc-no-recurs
                 handleDrawInfo(entity, drawInfo, node);
             }
             entity->setVBColorDirty(false);
+            entity->setBatchDirty(false);
+            ++_rebatchedEntityCount;
+            if (_recordingRoot && (entity->getIsMask() || entity->getUseLocal())) {
+                _recordingRoot->retainable = false;
+            }
         }
         if (entity->getRenderEntityType() == RenderEntityType::CROSSED) {
             breakWalk = true;
@@ -302,6 +327,14 @@ CC_FORCE_INLINE void Batcher2d::handleDrawInfo(RenderEntity* entity, RenderDrawI
     CC_ASSERT(drawInfo);
     RenderDrawInfoType drawInfoType = drawInfo->getEnumDrawInfoType();
 
+    if (_recordingRoot) {
+        if (drawInfoType == RenderDrawInfoType::COMP && !drawInfo->getIsMeshBuffer()) {
+            recordRetainedDraw(entity, drawInfo);
+        } else {
+            _recordingRoot->retainable = false;
+        }
+    }
+
     switch (drawInfoType) {
         case RenderDrawInfoType::COMP:
             handleComponentDraw(entity, drawInfo, node);
@@ -332,6 +365,8 @@ void Batcher2d::generateBatch(RenderEntity* entity, RenderDrawInfo* drawInfo) {
         return;
     }
     gfx::InputAssembler* ia = nullptr;
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
     if (drawInfo->getIsMeshBuffer()) {
         // Todo MeshBuffer RenderData
         ia = drawInfo->requestIA(getDevice());
@@ -342,12 +377,13 @@ void Batcher2d::generateBatch(RenderEntity* entity, RenderDrawInfo* drawInfo) {
         currMeshBuffer->setDirty(true);
 
         ia = currMeshBuffer->requireFreeIA(getDevice());
-        uint32_t indexCount = currMeshBuffer->getIndexOffset() - _indexStart;
+        firstIndex = _indexStart;
+        indexCount = currMeshBuffer->getIndexOffset() - _indexStart;
         if (ia == nullptr) {
             return;
         }
 
-        ia->setFirstIndex(_indexStart);
+        ia->setFirstIndex(firstIndex);
         ia->setIndexCount(indexCount);
         _indexStart = currMeshBuffer->getIndexOffset();
     }
@@ -374,6 +410,12 @@ void Batcher2d::generateBatch(RenderEntity* entity, RenderDrawInfo* drawInfo) {
         curdrawBatch->setDescriptorSet(getDescriptorSet(_currTexture, _currSampler, pass->getLocalSetLayout()));
     }
     _batches.push_back(curdrawBatch);
+
+    if (_recordingRoot && !drawInfo->getIsMeshBuffer()) {
+        _recordingRoot->batches.emplace_back(RetainedBatch{
+            curdrawBatch, drawInfo->getMeshBuffer(), firstIndex, indexCount,
+            _currMaterial, _currTexture, _currSampler});
+    }
 }
 
 void Batcher2d::generateBatchForMiddleware(RenderEntity* entity, RenderDrawInfo* drawInfo) {
@@ -474,6 +516,10 @@ void Batcher2d::releaseDescriptorSetCache(gfx::Texture* texture, gfx::Sampler* s
         delete iter->second;
         _descriptorSetCache.erase(hash);
     }
+    // the texture may be gone, batch the retained roots again
+    for (auto& root : _retainedRoots) {
+        root.retainable = false;
+    }
 }
 
 bool Batcher2d::initialize() {
@@ -505,9 +551,18 @@ void Batcher2d::uploadBuffers() {
 }
 
 void Batcher2d::reset() {
-    for (auto& batch : _batches) {
-        batch->clear();
-        _drawBatchPool.free(batch);
+    if (_retainedMode) {
+        // batches of retained roots are kept for the next frame
+        for (auto& batch : _transientBatches) {
+            batch->clear();
+            _drawBatchPool.free(batch);
+        }
+        _transientBatches.clear();
+    } else {
+        for (auto& batch : _batches) {
+            batch->clear();
+            _drawBatchPool.free(batch);
+        }
     }
     _batches.clear();
 
@@ -534,9 +589,237 @@ void Batcher2d::reset() {
     _currTexture = nullptr;
     _currSampler = nullptr;
 
+    applyRetainedMode();
+
     // stencilManager
 }
 
+void Batcher2d::setRetainedMode(bool enabled) {
+    _pendingRetainedMode = enabled;
+    // batches of this frame may still be drawn, they are released in reset()
+    if (_batches.empty()) {
+        applyRetainedMode();
+    }
+}
+
+void Batcher2d::applyRetainedMode() {
+    if (_retainedMode == _pendingRetainedMode) {
+        return;
+    }
+    releaseRetainedRoots();
+    _retainedMode = _pendingRetainedMode;
+}
+
+void Batcher2d::fillRetainedBatches() {
+    const size_t rootCount = _rootNodeArr.size();
+    for (size_t i = rootCount; i < _retainedRoots.size(); ++i) {
+        releaseRetainedRoot(_retainedRoots[i]);
+    }
+    _retainedRoots.resize(rootCount);
+
+    for (size_t i = 0; i < rootCount; ++i) {
+        auto* rootNode = _rootNodeArr[i];
+        auto& root = _retainedRoots[i];
+        const size_t index = _batches.size();
+        if (root.node != rootNode || !root.retainable || !reuseRetainedRoot(root)) {
+            rebatchRetainedRoot(rootNode, root);
+        }
+
+        auto* scene = rootNode->getScene()->getRenderScene();
+        size_t const count = _batches.size();
+        for (size_t j = index; j < count; j++) {
+            scene->addBatch(_batches.at(j));
+        }
+    }
+    CC_PROFILE_OBJECT_UPDATE(RebatchedEntities, _rebatchedEntityCount);
+    CC_PROFILE_OBJECT_UPDATE(RetainedEntities, _retainedEntityCount);
+}
+
+void Batcher2d::rebatchRetainedRoot(Node* rootNode, RetainedRoot& root) {
+    releaseRetainedRoot(root);
+    root.node = rootNode;
+    root.retainable = true;
+
+    // batches never span root nodes, start from a clean state so the root can be reused on its own
+    resetRenderStates();
+    _currHash = 0;
+    const size_t index = _batches.size();
+    _recordingRoot = &root;
+    walk(rootNode, 1);
+    generateBatch(_currEntity, _currDrawInfo);
+    _recordingRoot = nullptr;
+    resetRenderStates();
+    _currHash = 0;
+
+    if (!root.retainable) {
+        _transientBatches.insert(_transientBatches.end(), _batches.begin() + static_cast<std::ptrdiff_t>(index), _batches.end());
+        root.draws.clear();
+        root.batches.clear();
+        root.indexRanges.clear();
+        return;
+    }
+    CC_ASSERT(root.batches.size() == _batches.size() - index);
+    for (auto& range : root.indexRanges) {
+        range.end = range.meshBuffer->getIndexOffset();
+    }
+}
+
+bool Batcher2d::reuseRetainedRoot(RetainedRoot& root) {
+    // index data is still in place only if the roots before filled the same amount
+    for (const auto& range : root.indexRanges) {
+        if (range.meshBuffer->getIndexOffset() != range.begin) {
+            return false;
+        }
+    }
+
+    size_t drawIndex = 0;
+    uint32_t entityCount = 0;
+    if (!refreshRetainedNode(root.node, 1, root, drawIndex, entityCount) || drawIndex != root.draws.size()) {
+        return false;
+    }
+
+    for (const auto& range : root.indexRanges) {
+        range.meshBuffer->setIndexOffset(range.end);
+    }
+    for (const auto& retained : root.batches) {
+        auto* ia = retained.meshBuffer->requireFreeIA(getDevice());
+        ia->setFirstIndex(retained.firstIndex);
+        ia->setIndexCount(retained.indexCount);
+        retained.batch->setInputAssembler(ia);
+
+        // what generateBatch refreshes every frame
+        for (const auto& pass : *retained.material->getPasses()) {
+            pass->update();
+        }
+        const auto& pass = retained.batch->getPasses().at(0);
+        retained.batch->setDescriptorSet(getDescriptorSet(retained.texture, retained.sampler, pass->getLocalSetLayout()));
+        _batches.push_back(retained.batch);
+    }
+    _retainedEntityCount += entityCount;
+    return true;
+}
+
+// Same traversal as walk(), refreshes vertex data and checks that every draw info batches as last frame.
+bool Batcher2d::refreshRetainedNode(Node* node, float parentOpacity, const RetainedRoot& root, size_t& drawIndex, uint32_t& entityCount) { // NOLINT(misc-no-recursion)
+    if (!node->isActiveInHierarchy()) {
+        return true;
+    }
+    bool breakWalk = false;
+    auto* entity = static_cast<RenderEntity*>(node->getUserData());
+    if (entity) {
+        if (entity->getColorDirty()) {
+            float localOpacity = entity->getLocalOpacity();
+            float localColorAlpha = entity->getColorAlpha();
+            entity->setOpacity(parentOpacity * localOpacity * localColorAlpha);
+            entity->setColorDirty(false);
+            entity->setVBColorDirty(true);
+        }
+        if (math::isEqualF(entity->getOpacity(), 0)) {
+            breakWalk = true;
+        } else if (entity->isEnabled()) {
+            if (entity->isBatchDirty() || entity->getIsMask() || entity->getUseLocal()) {
+                return false;
+            }
+            uint32_t size = entity->getRenderDrawInfosSize();
+            for (uint32_t i = 0; i < size; i++) {
+                auto* drawInfo = entity->getRenderDrawInfoAt(i);
+                if (drawIndex >= root.draws.size()) {
+                    return false;
+                }
+                const auto& draw = root.draws[drawIndex++];
+                if (draw.drawInfo != drawInfo ||
+                    drawInfo->getEnumDrawInfoType() != RenderDrawInfoType::COMP ||
+                    drawInfo->getIsMeshBuffer() ||
+                    drawInfo->getVertDirty() ||
+                    draw.dataHash != drawInfo->getDataHash() ||
+                    draw.material != drawInfo->getMaterial() ||
+                    (draw.material && draw.materialHash != draw.material->getHash()) ||
+                    draw.texture != drawInfo->getTexture() ||
+                    draw.sampler != drawInfo->getSampler() ||
+                    draw.meshBuffer != drawInfo->getMeshBuffer() ||
+                    draw.ibBuffer != drawInfo->getIbBuffer() ||
+                    draw.ibCount != drawInfo->getIbCount() ||
+                    draw.vertexOffset != drawInfo->getVertexOffset() ||
+                    draw.layer != node->getLayer()) {
+                    return false;
+                }
+            }
+            for (uint32_t i = 0; i < size; i++) {
+                auto* drawInfo = entity->getRenderDrawInfoAt(i);
+                if (node->getChangedFlags()) {
+                    fillVertexBuffers(entity, drawInfo);
+                    drawInfo->getMeshBuffer()->setDirty(true);
+                }
+                if (entity->getVBColorDirty()) {
+                    fillColors(entity, drawInfo);
+                    drawInfo->getMeshBuffer()->setDirty(true);
+                }
+            }
+            entity->setVBColorDirty(false);
+            ++entityCount;
+        }
+        if (entity->getRenderEntityType() == RenderEntityType::CROSSED) {
+            breakWalk = true;
+        }
+    }
+
+    if (!breakWalk) {
+        const auto& children = node->getChildren();
+        float thisOpacity = entity ? entity->getOpacity() : parentOpacity;
+        for (const auto& child : children) {
+            if (!refreshRetainedNode(child, thisOpacity, root, drawIndex, entityCount)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void Batcher2d::recordRetainedDraw(RenderEntity* entity, RenderDrawInfo* drawInfo) {
+    auto* meshBuffer = drawInfo->getMeshBuffer();
+    auto& ranges = _recordingRoot->indexRanges;
+    auto iter = std::find_if(ranges.begin(), ranges.end(), [meshBuffer](const RetainedIndexRange& range) {
+        return range.meshBuffer == meshBuffer;
+    });
+    if (iter == ranges.end()) {
+        ranges.emplace_back(RetainedIndexRange{meshBuffer, meshBuffer->getIndexOffset(), 0});
+    }
+
+    auto* material = drawInfo->getMaterial();
+    _recordingRoot->draws.emplace_back(RetainedDraw{
+        drawInfo,
+        drawInfo->getDataHash(),
+        material,
+        material ? material->getHash() : 0,
+        drawInfo->getTexture(),
+        drawInfo->getSampler(),
+        meshBuffer,
+        drawInfo->getIbBuffer(),
+        drawInfo->getIbCount(),
+        drawInfo->getVertexOffset(),
+        entity->getNode()->getLayer(),
+    });
+}
+
+void Batcher2d::releaseRetainedRoot(RetainedRoot& root) {
+    for (const auto& retained : root.batches) {
+        retained.batch->clear();
+        _drawBatchPool.free(retained.batch);
+    }
+    root.node = nullptr;
+    root.retainable = false;
+    root.draws.clear();
+    root.batches.clear();
+    root.indexRanges.clear();
+}
+
+void Batcher2d::releaseRetainedRoots() {
+    for (auto& root : _retainedRoots) {
+        releaseRetainedRoot(root);
+    }
+    _retainedRoots.clear();
+}
+
 void Batcher2d::insertMaskBatch(RenderEntity* entity) {
     generateBatch(_currEntity, _currDrawInfo);
     resetRenderStates();
@@ -31,6 +31,7 @@
 #include "base/TypeDef.h"
 #include "core/assets/Material.h"
 #include "core/memop/Pool.h"
+#include "math/MathUtil.h"
 #include "renderer/gfx-base/GFXTexture.h"
 #include "renderer/gfx-base/states/GFXSampler.h"
 #include "scene/DrawBatch2D.h"
@@ -62,6 +63,15 @@ public:
 
     void updateDescriptorSet();
 
+    // Retained mode reuses the batches and index data of root nodes whose subtree is unchanged since last frame.
+    // A switch takes effect once the batches of the current frame are reset.
+    void setRetainedMode(bool enabled);
+    inline bool isRetainedMode() const { return _pendingRetainedMode; }
+    // Entities walked into new batches during the last update.
+    inline uint32_t getRebatchedEntityCount() const { return _rebatchedEntityCount; }
+    // Entities whose batches were reused during the last update.
+    inline uint32_t getRetainedEntityCount() const { return _retainedEntityCount; }
+
     void fillBuffersAndMergeBatches();
     void walk(Node* node, float parentOpacity);
     void handlePostRender(RenderEntity* entity);
@@ -75,6 +85,55 @@ public:
     void resetRenderStates();
 
 private:
+    // Batching state of a draw info when its root was batched.
+    struct RetainedDraw {
+        RenderDrawInfo* drawInfo{nullptr};
+        ccstd::hash_t dataHash{0};
+        Material* material{nullptr};
+        ccstd::hash_t materialHash{0};
+        gfx::Texture* texture{nullptr};
+        gfx::Sampler* sampler{nullptr};
+        UIMeshBuffer* meshBuffer{nullptr};
+        uint16_t* ibBuffer{nullptr};
+        uint32_t ibCount{0};
+        uint32_t vertexOffset{0};
+        uint32_t layer{0};
+    };
+
+    struct RetainedBatch {
+        scene::DrawBatch2D* batch{nullptr};
+        UIMeshBuffer* meshBuffer{nullptr};
+        uint32_t firstIndex{0};
+        uint32_t indexCount{0};
+        Material* material{nullptr};
+        gfx::Texture* texture{nullptr};
+        gfx::Sampler* sampler{nullptr};
+    };
+
+    struct RetainedIndexRange {
+        UIMeshBuffer* meshBuffer{nullptr};
+        uint32_t begin{0};
+        uint32_t end{0};
+    };
+
+    // Batches owned by a root node, kept across frames while the subtree is unchanged.
+    struct RetainedRoot {
+        Node* node{nullptr};
+        bool retainable{false};
+        ccstd::vector<RetainedDraw> draws;
+        ccstd::vector<RetainedBatch> batches;
+        ccstd::vector<RetainedIndexRange> indexRanges;
+    };
+
+    void fillRetainedBatches();
+    void rebatchRetainedRoot(Node* rootNode, RetainedRoot& root);
+    bool reuseRetainedRoot(RetainedRoot& root);
+    bool refreshRetainedNode(Node* node, float parentOpacity, const RetainedRoot& root, size_t& drawIndex, uint32_t& entityCount);
+    void releaseRetainedRoot(RetainedRoot& root);
+    void releaseRetainedRoots();
+    void applyRetainedMode();
+    void recordRetainedDraw(RenderEntity* entity, RenderDrawInfo* drawInfo);
+
     bool _isInit = false;
 
     inline void fillIndexBuffers(RenderDrawInfo* drawInfo) { // NOLINT(readability-convert-member-functions-to-static)
@@ -96,15 +155,14 @@ private:
         Node* node = entity->getNode();
         const Mat4& matrix = node->getWorldMatrix();
         uint8_t stride = drawInfo->getStride();
-        uint32_t size = drawInfo->getVbCount() * stride;
-        float* vbBuffer = drawInfo->getVbBuffer();
-        for (int i = 0; i < size; i += stride) {
-            Render2dLayout* curLayout = drawInfo->getRender2dLayout(i);
-            // make sure that the layout of Vec3 is three consecutive floats
-            static_assert(sizeof(Vec3) == 3 * sizeof(float));
-            // cast to reduce value copy instructions
-            reinterpret_cast<Vec3*>(vbBuffer + i)->transformMat4(curLayout->position, matrix);
+        uint32_t count = drawInfo->getVbCount();
+        if (count == 0) {
+            return;
         }
+        // make sure that the layout of Vec3 is three consecutive floats
+        static_assert(sizeof(Vec3) == 3 * sizeof(float));
+        const float* positions = &drawInfo->getRender2dLayout(0)->position.x;
+        MathUtil::transformVec3Strided(matrix.m, positions, stride, drawInfo->getVbBuffer(), stride, count);
     }
 
     inline void setIndexRange(RenderDrawInfo* drawInfo) { // NOLINT(readability-convert-member-functions-to-static)
@@ -119,19 +177,15 @@ private:
 
     inline void fillColors(RenderEntity* entity, RenderDrawInfo* drawInfo) { // NOLINT(readability-convert-member-functions-to-static)
         Color temp = entity->getColor();
-
-        uint8_t stride = drawInfo->getStride();
-        uint32_t size = drawInfo->getVbCount() * stride;
-        float* vbBuffer = drawInfo->getVbBuffer();
-
-        uint32_t offset = 0;
-        for (int i = 0; i < size; i += stride) {
-            offset = i + 5;
-            vbBuffer[offset++] = static_cast<float>(temp.r) / 255.0F;
-            vbBuffer[offset++] = static_cast<float>(temp.g) / 255.0F;
-            vbBuffer[offset++] = static_cast<float>(temp.b) / 255.0F;
-            vbBuffer[offset++] = entity->getOpacity();
-        }
+        const float color[4] = {
+            static_cast<float>(temp.r) / 255.0F,
+            static_cast<float>(temp.g) / 255.0F,
+            static_cast<float>(temp.b) / 255.0F,
+            entity->getOpacity(),
+        };
+
+        // the color follows xyz and uv
+        MathUtil::fillVec4Strided(color, drawInfo->getVbBuffer() + 5, drawInfo->getStride(), drawInfo->getVbCount());
     }
 
     void insertMaskBatch(RenderEntity* entity);
@@ -197,6 +251,17 @@ private:
     };
     gfx::PrimitiveMode _primitiveMode{gfx::PrimitiveMode::TRIANGLE_LIST};
 
+    // Retained mode
+    bool _retainedMode{false};
+    bool _pendingRetainedMode{false};
+    // weak reference
+    RetainedRoot* _recordingRoot{nullptr};
+    ccstd::vector<RetainedRoot> _retainedRoots;
+    // batches of roots that cannot be retained, freed in reset()
+    ccstd::vector<scene::DrawBatch2D*> _transientBatches;
+    uint32_t _rebatchedEntityCount{0};
+    uint32_t _retainedEntityCount{0};
+
     CC_DISALLOW_COPY_MOVE_ASSIGN(Batcher2d);
 };
 } // namespace cc
@@ -47,22 +47,26 @@ RenderEntity::~RenderEntity() {
 void RenderEntity::addDynamicRenderDrawInfo(RenderDrawInfo* drawInfo) {
     CC_ASSERT_NE(_renderEntityType, RenderEntityType::STATIC);
     _dynamicDrawInfos.push_back(drawInfo);
+    _batchDirty = true;
 }
 void RenderEntity::setDynamicRenderDrawInfo(RenderDrawInfo* drawInfo, uint32_t index) {
     CC_ASSERT_NE(_renderEntityType, RenderEntityType::STATIC);
     if (index < _dynamicDrawInfos.size()) {
         _dynamicDrawInfos[index] = drawInfo;
+        _batchDirty = true;
     }
 }
 void RenderEntity::removeDynamicRenderDrawInfo() {
     CC_ASSERT_NE(_renderEntityType, RenderEntityType::STATIC);
     if (_dynamicDrawInfos.empty()) return;
     _dynamicDrawInfos.pop_back(); // warning: memory leaking & crash
+    _batchDirty = true;
 }
 
 void RenderEntity::clearDynamicRenderDrawInfos() {
     CC_ASSERT_NE(_renderEntityType, RenderEntityType::STATIC);
     _dynamicDrawInfos.clear();
+    _batchDirty = true;
 }
 
 void RenderEntity::clearStaticRenderDrawInfos() {
@@ -73,6 +77,7 @@ void RenderEntity::clearStaticRenderDrawInfos() {
         drawInfo.resetDrawInfo();
     }
     _staticDrawInfoSize = 0;
+    _batchDirty = true;
 }
 
 void RenderEntity::setNode(Node* node) {
@@ -83,10 +88,12 @@ void RenderEntity::setNode(Node* node) {
     if (_node) {
         _node->setUserData(this);
     }
+    _batchDirty = true;
 }
 
 void RenderEntity::setRenderTransform(Node* renderTransform) {
     _renderTransform = renderTransform;
+    _batchDirty = true;
 }
 
 RenderDrawInfo* RenderEntity::getDynamicRenderDrawInfo(uint32_t index) {
@@ -103,6 +110,7 @@ ccstd::vector<RenderDrawInfo*>& RenderEntity::getDynamicRenderDrawInfos() {
 void RenderEntity::setStaticDrawInfoSize(uint32_t size) {
     CC_ASSERT(_renderEntityType == RenderEntityType::STATIC && size <= RenderEntity::STATIC_DRAW_INFO_CAPACITY);
     _staticDrawInfoSize = size;
+    _batchDirty = true;
 }
 RenderDrawInfo* RenderEntity::getStaticRenderDrawInfo(uint32_t index) {
     CC_ASSERT(_renderEntityType == RenderEntityType::STATIC && index < _staticDrawInfoSize);
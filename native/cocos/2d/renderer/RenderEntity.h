@@ -89,6 +89,7 @@ public:
     inline bool getUseLocal() const { return _entityAttrLayout.useLocal; }
     inline void setUseLocal(bool useLocal) {
         _entityAttrLayout.useLocal = useLocal;
+        _batchDirty = true;
     }
 
     inline Node* getNode() const { return _node; }
@@ -100,6 +101,7 @@ public:
     inline uint32_t getStencilStage() const { return static_cast<uint32_t>(_stencilStage); }
     inline void setStencilStage(uint32_t stage) {
         _stencilStage = static_cast<StencilStage>(stage);
+        _batchDirty = true;
     }
     inline StencilStage getEnumStencilStage() const { return _stencilStage; }
     inline void setEnumStencilStage(StencilStage stage) {
@@ -121,6 +123,10 @@ public:
     inline void setColorDirty(bool dirty) { _entityAttrLayout.colorDirtyBit = dirty ? 1 : 0; }
     inline bool getVBColorDirty() const { return _vbColorDirty; }
     inline void setVBColorDirty(bool vbColorDirty) { _vbColorDirty = vbColorDirty; }
+
+    // Set when draw infos or batching state change on the native side, retained batches of the entity are invalid.
+    inline bool isBatchDirty() const { return _batchDirty; }
+    inline void setBatchDirty(bool batchDirty) { _batchDirty = batchDirty; }
     inline Color getColor() const { return Color(_entityAttrLayout.colorR, _entityAttrLayout.colorG, _entityAttrLayout.colorB, _entityAttrLayout.colorA); }
     inline float getColorAlpha() const { return static_cast<float>(_entityAttrLayout.colorA) / 255.F; }
     inline float getLocalOpacity() const { return _entityAttrLayout.localOpacity; }
@@ -154,5 +160,6 @@ private:
     RenderEntityType _renderEntityType{RenderEntityType::STATIC};
     uint8_t _staticDrawInfoSize{0};
     bool _vbColorDirty{true};
+    bool _batchDirty{true};
 };
 } // namespace cc
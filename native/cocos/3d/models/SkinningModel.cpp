@@ -29,6 +29,7 @@
 #include "3d/assets/Skeleton.h"
 #include "core/platform/Debug.h"
 #include "core/scene-graph/Node.h"
+#include "math/MathUtil.h"
 #include "renderer/gfx-base/GFXBuffer.h"
 #include "scene/Pass.h"
 #include "scene/RenderScene.h"
@@ -36,6 +37,8 @@
 const uint32_t REALTIME_JOINT_TEXTURE_WIDTH = 256;
 const uint32_t REALTIME_JOINT_TEXTURE_HEIGHT = 3;
 
+static_assert(sizeof(cc::Mat4) == sizeof(float) * 16, "joint matrices are passed to MathUtil as tightly packed floats");
+
 namespace {
 void getRelevantBuffers(ccstd::vector<index_t> &outIndices, ccstd::vector<int32_t> &outBuffers, const ccstd::vector<ccstd::vector<int32_t>> &jointMaps, int32_t targetJoint) {
     for (int32_t i = 0; i < jointMaps.size(); i++) {
@@ -78,6 +81,11 @@ void SkinningModel::bindSkeleton(Skeleton *skeleton, Node *skinningRoot, Mesh *m
     }
     _bufferIndices.clear();
     _joints.clear();
+    _jointWorlds.clear();
+    _jointBindposes.clear();
+    _jointBoundCenters.clear();
+    _jointBoundHalfExtents.clear();
+    _jointPalette.clear();
 
     if (!skeleton || !skinningRoot || !mesh) return;
     auto jointCount = static_cast<uint32_t>(skeleton->getJoints().size());
@@ -112,7 +120,15 @@ void SkinningModel::bindSkeleton(Skeleton *skeleton, Node *skinningRoot, Mesh *m
         jointInfo.buffers = std::move(buffers);
         jointInfo.indices = std::move(indices);
         _joints.emplace_back(std::move(jointInfo));
+
+        _jointBindposes.emplace_back(bindPose);
+        const Vec3 &center = bound->getCenter();
+        const Vec3 &halfExtents = bound->getHalfExtents();
+        _jointBoundCenters.insert(_jointBoundCenters.end(), {center.x, center.y, center.z});
+        _jointBoundHalfExtents.insert(_jointBoundHalfExtents.end(), {halfExtents.x, halfExtents.y, halfExtents.z});
     }
+    _jointWorlds.resize(_joints.size());
+    _jointPalette.resize(_joints.size() * 12);
 }
 
 void SkinningModel::updateTransform(uint32_t stamp) {
@@ -121,18 +137,20 @@ void SkinningModel::updateTransform(uint32_t stamp) {
         root->updateWorldTransform();
         _localDataUpdated = true;
     }
+    // Joint transforms share ancestors through the stamp cache and are resolved one by one,
+    // the bound of all joints is then merged in one batched pass over contiguous arrays.
+    const auto jointCount = static_cast<uint32_t>(_joints.size());
+    for (uint32_t i = 0; i < jointCount; ++i) {
+        _jointWorlds[i] = cc::getWorldMatrix(_joints[i].transform, static_cast<int32_t>(stamp));
+    }
     Vec3 v3Min{INFINITY, INFINITY, INFINITY};
     Vec3 v3Max{-INFINITY, -INFINITY, -INFINITY};
-    geometry::AABB ab1;
-    Vec3 v31;
-    Vec3 v32;
-    for (JointInfo &jointInfo : _joints) {
-        auto &transform = jointInfo.transform;
-        Mat4 worldMatrix = cc::getWorldMatrix(transform, static_cast<int32_t>(stamp));
-        jointInfo.bound->transform(worldMatrix, &ab1);
-        ab1.getBoundary(&v31, &v32);
-        Vec3::min(v3Min, v31, &v3Min);
-        Vec3::max(v3Max, v32, &v3Max);
+    if (jointCount > 0) {
+        float boundMin[3] = {v3Min.x, v3Min.y, v3Min.z};
+        float boundMax[3] = {v3Max.x, v3Max.y, v3Max.z};
+        MathUtil::mergeTransformedAABBs(_jointWorlds[0].m, _jointBoundCenters.data(), _jointBoundHalfExtents.data(), jointCount, boundMin, boundMax);
+        v3Min.set(boundMin[0], boundMin[1], boundMin[2]);
+        v3Max.set(boundMax[0], boundMax[1], boundMax[2]);
     }
     if (_modelBounds && _modelBounds->isValid() && _worldBounds) {
         geometry::AABB::fromPoints(v3Min, v3Max, _modelBounds);
@@ -144,11 +162,15 @@ void SkinningModel::updateTransform(uint32_t stamp) {
 void SkinningModel::updateUBOs(uint32_t stamp) {
     Super::updateUBOs(stamp);
     uint32_t bIdx = 0;
-    Mat4 mat4;
-    for (const JointInfo &jointInfo : _joints) {
-        Mat4::multiply(jointInfo.transform->world, jointInfo.bindpose, &mat4);
+    const auto jointCount = static_cast<uint32_t>(_joints.size());
+    if (jointCount > 0) {
+        MathUtil::multiplyJointMatrices(_jointWorlds[0].m, _jointBindposes[0].m, jointCount, _jointPalette.data());
+    }
+    for (uint32_t i = 0; i < jointCount; ++i) {
+        const JointInfo &jointInfo = _joints[i];
+        const float *palette = _jointPalette.data() + i * 12;
         for (uint32_t buffer : jointInfo.buffers) {
-            uploadJointData(jointInfo.indices[bIdx] * 12, mat4, _dataArray[buffer]);
+            memcpy(_dataArray[buffer] + jointInfo.indices[bIdx] * 12, palette, sizeof(float) * 12);
             bIdx++;
         }
         bIdx = 0;
@@ -187,13 +209,6 @@ ccstd::vector<scene::IMacroPatch> SkinningModel::getMacroPatches(index_t subMode
     return myPatches;
 }
 
-void SkinningModel::uploadJointData(uint32_t base, const Mat4 &mat, float *dst) {
-    memcpy(reinterpret_cast<void *>(dst + base), mat.m, sizeof(float) * 12);
-    dst[base + 3] = mat.m[12];
-    dst[base + 7] = mat.m[13];
-    dst[base + 11] = mat.m[14];
-}
-
 void SkinningModel::updateLocalDescriptors(index_t submodelIdx, gfx::DescriptorSet *descriptorset) {
     Super::updateLocalDescriptors(submodelIdx, descriptorset);
     uint32_t idx = _bufferIndices[submodelIdx];
@@ -65,7 +65,6 @@ public:
     void bindSkeleton(Skeleton *skeleton, Node *skinningRoot, Mesh *mesh);
 
 private:
-    static void uploadJointData(uint32_t base, const Mat4 &mat, float *dst);
     void ensureEnoughBuffers(uint32_t count);
     void updateRealTimeJointTextureBuffer();
     void initRealTimeJointTexture();
@@ -75,6 +74,12 @@ private:
     ccstd::vector<index_t> _bufferIndices;
     ccstd::vector<IntrusivePtr<gfx::Buffer>> _buffers;
     ccstd::vector<JointInfo> _joints;
+    // Contiguous per-joint data, indexed like _joints, consumed by the batched MathUtil kernels.
+    ccstd::vector<Mat4> _jointWorlds;
+    ccstd::vector<Mat4> _jointBindposes;
+    ccstd::vector<float> _jointBoundCenters;
+    ccstd::vector<float> _jointBoundHalfExtents;
+    ccstd::vector<float> _jointPalette;
     ccstd::vector<float *> _dataArray;
     bool _realTimeTextureMode = false;
     RealTimeJointTexture *_realTimeJointTexture = nullptr;
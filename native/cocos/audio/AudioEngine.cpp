@@ -48,6 +48,12 @@
     #include "audio/tizen/AudioEngine-tizen.h"
 #endif
 
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS || CC_PLATFORM == CC_PLATFORM_OHOS || CC_PLATFORM == CC_PLATFORM_LINUX || CC_PLATFORM == CC_PLATFORM_QNX
+    #define CC_AUDIO_PCM_CACHE 1
+#else
+    #define CC_AUDIO_PCM_CACHE 0
+#endif
+
 #define TIME_DELAY_PRECISION 0.0001
 
 #ifdef ERROR
@@ -64,6 +70,11 @@ ccstd::unordered_map<ccstd::string, ccstd::list<int>> AudioEngine::sAudioPathIDM
 //profileName,ProfileHelper
 ccstd::unordered_map<ccstd::string, AudioEngine::ProfileHelper> AudioEngine::sAudioPathProfileHelperMap;
 unsigned int AudioEngine::sMaxInstances = MAX_AUDIOINSTANCES;
+#if CC_AUDIO_PCM_CACHE
+uint32_t AudioEngine::sPCMCacheBudget = PCMDATA_CACHE_BUDGET;
+#else
+uint32_t AudioEngine::sPCMCacheBudget = 0;
+#endif
 AudioEngine::ProfileHelper *AudioEngine::sDefaultProfileHelper = nullptr;
 ccstd::unordered_map<int, AudioEngine::AudioInfo> AudioEngine::sAudioIDInfoMap;
 AudioEngineImpl *AudioEngine::sAudioEngineImpl = nullptr;
@@ -170,6 +181,9 @@ bool AudioEngine::lazyInit() {
             sAudioEngineImpl = nullptr;
             return false;
         }
+#if CC_AUDIO_PCM_CACHE
+        sAudioEngineImpl->setPCMCacheBudget(sPCMCacheBudget);
+#endif
         sOnPauseListenerID.bind(&onEnterBackground);
         sOnResumeListenerID.bind(&onEnterForeground);
     }
@@ -486,6 +500,15 @@ bool AudioEngine::setMaxAudioInstance(int maxInstances) {
     return false;
 }
 
+void AudioEngine::setPCMCacheBudget(uint32_t bytes) {
+    sPCMCacheBudget = bytes;
+#if CC_AUDIO_PCM_CACHE
+    if (sAudioEngineImpl) {
+        sAudioEngineImpl->setPCMCacheBudget(bytes);
+    }
+#endif
+}
+
 bool AudioEngine::isLoop(int audioID) {
     auto tmpIterator = sAudioIDInfoMap.find(audioID);
     if (tmpIterator != sAudioIDInfoMap.end()) {
@@ -0,0 +1,305 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#include "audio/common/mixer/AudioMixerKernels.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define USE_MIXER_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define USE_MIXER_NEON
+#endif
+
+namespace cc {
+
+namespace {
+
+constexpr float PHASE_FRACTION_SCALE = 1.0F / 4294967296.0F;
+
+inline uint32_t phaseIndex(uint64_t phase) {
+    return static_cast<uint32_t>(phase >> AudioMixerKernels::PHASE_BITS);
+}
+
+inline float phaseFraction(uint64_t phase) {
+    return static_cast<float>(phase & 0xFFFFFFFFULL) * PHASE_FRACTION_SCALE;
+}
+
+inline float lerp(int16_t a, int16_t b, float t) {
+    return static_cast<float>(a) + static_cast<float>(b - a) * t;
+}
+
+void mixMonoI16C(float *out, const int16_t *in, uint32_t frames, float gainL, float gainR) {
+    for (uint32_t i = 0; i < frames; ++i) {
+        const auto s = static_cast<float>(in[i]);
+        out[i * 2] += s * gainL;
+        out[i * 2 + 1] += s * gainR;
+    }
+}
+
+void mixStereoI16C(float *out, const int16_t *in, uint32_t frames, float gainL, float gainR) {
+    for (uint32_t i = 0; i < frames; ++i) {
+        out[i * 2] += static_cast<float>(in[i * 2]) * gainL;
+        out[i * 2 + 1] += static_cast<float>(in[i * 2 + 1]) * gainR;
+    }
+}
+
+uint64_t resampleMixMonoI16C(float *out, const int16_t *in, uint32_t frames, uint64_t phase, uint64_t step, float gainL, float gainR) {
+    for (uint32_t i = 0; i < frames; ++i, phase += step) {
+        const uint32_t index = phaseIndex(phase);
+        const float s = lerp(in[index], in[index + 1], phaseFraction(phase));
+        out[i * 2] += s * gainL;
+        out[i * 2 + 1] += s * gainR;
+    }
+    return phase;
+}
+
+uint64_t resampleMixStereoI16C(float *out, const int16_t *in, uint32_t frames, uint64_t phase, uint64_t step, float gainL, float gainR) {
+    for (uint32_t i = 0; i < frames; ++i, phase += step) {
+        const uint32_t index = phaseIndex(phase) * 2;
+        const float t = phaseFraction(phase);
+        out[i * 2] += lerp(in[index], in[index + 2], t) * gainL;
+        out[i * 2 + 1] += lerp(in[index + 1], in[index + 3], t) * gainR;
+    }
+    return phase;
+}
+
+void floatToI16C(int16_t *out, const float *in, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        const float s = std::min(std::max(in[i] * 32768.0F, -32768.0F), 32767.0F);
+        out[i] = static_cast<int16_t>(std::lrint(s));
+    }
+}
+
+} // namespace
+
+#if defined(USE_MIXER_SSE2)
+
+void AudioMixerKernels::mixMonoI16(float *out, const int16_t *in, uint32_t frames, float gainL, float gainR) {
+    const __m128 gain = _mm_setr_ps(gainL, gainR, gainL, gainR);
+    uint32_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        const __m128i s16 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(in + i));
+        const __m128 s = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s16, s16), 16));
+        float *dst = out + i * 2;
+        _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(_mm_unpacklo_ps(s, s), gain)));
+        _mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_mul_ps(_mm_unpackhi_ps(s, s), gain)));
+    }
+    mixMonoI16C(out + i * 2, in + i, frames - i, gainL, gainR);
+}
+
+void AudioMixerKernels::mixStereoI16(float *out, const int16_t *in, uint32_t frames, float gainL, float gainR) {
+    const __m128 gain = _mm_setr_ps(gainL, gainR, gainL, gainR);
+    uint32_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        const __m128i s16 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i * 2));
+        const __m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s16, s16), 16));
+        const __m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s16, s16), 16));
+        float *dst = out + i * 2;
+        _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(lo, gain)));
+        _mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_mul_ps(hi, gain)));
+    }
+    mixStereoI16C(out + i * 2, in + i * 2, frames - i, gainL, gainR);
+}
+
+uint64_t AudioMixerKernels::resampleMixMonoI16(float *out, const int16_t *in, uint32_t frames, uint64_t phase, uint64_t step, float gainL, float gainR) {
+    const __m128 gain = _mm_setr_ps(gainL, gainR, gainL, gainR);
+    uint32_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        const uint64_t p0 = phase;
+        const uint64_t p1 = p0 + step;
+        const uint64_t p2 = p1 + step;
+        const uint64_t p3 = p2 + step;
+        phase = p3 + step;
+        const uint32_t i0 = phaseIndex(p0);
+        const uint32_t i1 = phaseIndex(p1);
+        const uint32_t i2 = phaseIndex(p2);
+        const uint32_t i3 = phaseIndex(p3);
+        const __m128 a = _mm_setr_ps(in[i0], in[i1], in[i2], in[i3]);
+        const __m128 b = _mm_setr_ps(in[i0 + 1], in[i1 + 1], in[i2 + 1], in[i3 + 1]);
+        const __m128 t = _mm_setr_ps(phaseFraction(p0), phaseFraction(p1), phaseFraction(p2), phaseFraction(p3));
+        const __m128 s = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+        float *dst = out + i * 2;
+        _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(_mm_unpacklo_ps(s, s), gain)));
+        _mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_mul_ps(_mm_unpackhi_ps(s, s), gain)));
+    }
+    return resampleMixMonoI16C(out + i * 2, in, frames - i, phase, step, gainL, gainR);
+}
+
+uint64_t AudioMixerKernels::resampleMixStereoI16(float *out, const int16_t *in, uint32_t frames, uint64_t phase, uint64_t step, float gainL, float gainR) {
+    const __m128 gain = _mm_setr_ps(gainL, gainR, gainL, gainR);
+    uint32_t i = 0;
+    for (; i + 2 <= frames; i += 2) {
+        const uint64_t p0 = phase;
+        const uint64_t p1 = p0 + step;
+        phase = p1 + step;
+        const int16_t *s0 = in + phaseIndex(p0) * 2;
+        const int16_t *s1 = in + phaseIndex(p1) * 2;
+        const float t0 = phaseFraction(p0);
+        const float t1 = phaseFraction(p1);
+        const __m128 a = _mm_setr_ps(s0[0], s0[1], s1[0], s1[1]);
+        const __m128 b = _mm_setr_ps(s0[2], s0[3], s1[2], s1[3]);
+        const __m128 t = _mm_setr_ps(t0, t0, t1, t1);
+        const __m128 s = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+        float *dst = out + i * 2;
+        _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(s, gain)));
+    }
+    return resampleMixStereoI16C(out + i * 2, in, frames - i, phase, step, gainL, gainR);
+}
+
+void AudioMixerKernels::floatToI16(int16_t *out, const float *in, uint32_t count) {
+    const __m128 scale = _mm_set1_ps(32768.0F);
+    const __m128 minValue = _mm_set1_ps(-32768.0F);
+    const __m128 maxValue = _mm_set1_ps(32767.0F);
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128 lo = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i), scale), minValue), maxValue);
+        const __m128 hi = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i + 4), scale), minValue), maxValue);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packs_epi32(_mm_cvtps_epi32(lo), _mm_cvtps_epi32(hi)));
+    }
+    floatToI16C(out + i, in + i, count - i);
+}
+
+#elif defined(USE_MIXER_NEON)
+
+void AudioMixerKernels::mixMonoI16(float *out, const int16_t *in, uint32_t frames, float gainL, float gainR) {
+    const float gains[4] = {gainL, gainR, gainL, gainR};
+    const float32x4_t gain = vld1q_f32(gains);
+    uint32_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        const float32x4_t s = vcvtq_f32_s32(vmovl_s16(vld1_s16(in + i)));
+        const float32x4x2_t z = vzipq_f32(s, s);
+        float *dst = out + i * 2;
+        vst1q_f32(dst, vmlaq_f32(vld1q_f32(dst), z.val[0], gain));
+        vst1q_f32(dst + 4, vmlaq_f32(vld1q_f32(dst + 4), z.val[1], gain));
+    }
+    mixMonoI16C(out + i * 2, in + i, frames - i, gainL, gainR);
+}
+
+void AudioMixerKernels::mixStereoI16(float *out, const int16_t *in, uint32_t frames, float gainL, float gainR) {
+    const float gains[4] = {gainL, gainR, gainL, gainR};
+    const float32x4_t gain = vld1q_f32(gains);
+    uint32_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        const int16x8_t s16 = vld1q_s16(in + i * 2);
+        const float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s16)));
+        const float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s16)));
+        float *dst = out + i * 2;
+        vst1q_f32(dst, vmlaq_f32(vld1q_f32(dst), lo, gain));
+        vst1q_f32(dst + 4, vmlaq_f32(vld1q_f32(dst + 4), hi, gain));
+    }
+    mixStereoI16C(out + i * 2, in + i * 2, frames - i, gainL, gainR);
+}
+
+uint64_t AudioMixerKernels::resampleMixMonoI16(float *out, const int16_t *in, uint32_t frames, uint64_t phase, uint64_t step, float gainL, float gainR) {
+    const float gains[4] = {gainL, gainR, gainL, gainR};
+    const float32x4_t gain = vld1q_f32(gains);
+    uint32_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        float a[4];
+        float b[4];
+        float t[4];
+        for (uint32_t j = 0; j < 4; ++j, phase += step) {
+            const uint32_t index = phaseIndex(phase);
+            a[j] = in[index];
+            b[j] = in[index + 1];
+            t[j] = phaseFraction(phase);
+        }
+        const float32x4_t va = vld1q_f32(a);
+        const float32x4_t s = vmlaq_f32(va, vsubq_f32(vld1q_f32(b), va), vld1q_f32(t));
+        const float32x4x2_t z = vzipq_f32(s, s);
+        float *dst = out + i * 2;
+        vst1q_f32(dst, vmlaq_f32(vld1q_f32(dst), z.val[0], gain));
+        vst1q_f32(dst + 4, vmlaq_f32(vld1q_f32(dst + 4), z.val[1], gain));
+    }
+    return resampleMixMonoI16C(out + i * 2, in, frames - i, phase, step, gainL, gainR);
+}
+
+uint64_t AudioMixerKernels::resampleMixStereoI16(float *out, const int16_t *in, uint32_t frames, uint64_t phase, uint64_t step, float gainL, float gainR) {
+    const float gains[4] = {gainL, gainR, gainL, gainR};
+    const float32x4_t gain = vld1q_f32(gains);
+    uint32_t i = 0;
+    for (; i + 2 <= frames; i += 2) {
+        float a[4];
+        float b[4];
+        float t[4];
+        for (uint32_t j = 0; j < 2; ++j, phase += step) {
+            const int16_t *s = in + phaseIndex(phase) * 2;
+            a[j * 2] = s[0];
+            a[j * 2 + 1] = s[1];
+            b[j * 2] = s[2];
+            b[j * 2 + 1] = s[3];
+            t[j * 2] = t[j * 2 + 1] = phaseFraction(phase);
+        }
+        const float32x4_t va = vld1q_f32(a);
+        const float32x4_t s = vmlaq_f32(va, vsubq_f32(vld1q_f32(b), va), vld1q_f32(t));
+        float *dst = out + i * 2;
+        vst1q_f32(dst, vmlaq_f32(vld1q_f32(dst), s, gain));
+    }
+    return resampleMixStereoI16C(out + i * 2, in, frames - i, phase, step, gainL, gainR);
+}
+
+void AudioMixerKernels::floatToI16(int16_t *out, const float *in, uint32_t count) {
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const float32x4_t s = vmulq_n_f32(vld1q_f32(in + i), 32768.0F);
+    #if defined(__aarch64__)
+        const int32x4_t s32 = vcvtnq_s32_f32(s);
+    #else
+        // Round half away from zero, vcvtq_s32_f32 truncates.
+        const float32x4_t half = vbslq_f32(vcltq_f32(s, vdupq_n_f32(0.0F)), vdupq_n_f32(-0.5F), vdupq_n_f32(0.5F));
+        const int32x4_t s32 = vcvtq_s32_f32(vaddq_f32(s, half));
+    #endif
+        vst1_s16(out + i, vqmovn_s32(s32));
+    }
+    floatToI16C(out + i, in + i, count - i);
+}
+
+#else
+
+void AudioMixerKernels::mixMonoI16(float *out, const int16_t *in, uint32_t frames, float gainL, float gainR) {
+    mixMonoI16C(out, in, frames, gainL, gainR);
+}
+
+void AudioMixerKernels::mixStereoI16(float *out, const int16_t *in, uint32_t frames, float gainL, float gainR) {
+    mixStereoI16C(out, in, frames, gainL, gainR);
+}
+
+uint64_t AudioMixerKernels::resampleMixMonoI16(float *out, const int16_t *in, uint32_t frames, uint64_t phase, uint64_t step, float gainL, float gainR) {
+    return resampleMixMonoI16C(out, in, frames, phase, step, gainL, gainR);
+}
+
+uint64_t AudioMixerKernels::resampleMixStereoI16(float *out, const int16_t *in, uint32_t frames, uint64_t phase, uint64_t step, float gainL, float gainR) {
+    return resampleMixStereoI16C(out, in, frames, phase, step, gainL, gainR);
+}
+
+void AudioMixerKernels::floatToI16(int16_t *out, const float *in, uint32_t count) {
+    floatToI16C(out, in, count);
+}
+
+#endif
+
+} // namespace cc
@@ -0,0 +1,63 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include "base/Macros.h"
+
+namespace cc {
+
+/**
+ * Mixing and resampling kernels of SoftwareMixer, with SSE2 and NEON implementations.
+ *
+ * The mix buffer is interleaved stereo float, sources are interleaved 16-bit pcm. Gains are applied
+ * to the raw 16-bit values, so pass |volume / 32768| to get normalized [-1, 1] output.
+ * Resampling positions are unsigned 32.32 fixed point frame offsets into the source.
+ */
+class CC_DLL AudioMixerKernels {
+public:
+    static constexpr uint32_t PHASE_BITS = 32;
+
+    /** Adds |frames| mono frames of |in| to |out|, scaled by |gainL|/|gainR|. */
+    static void mixMonoI16(float *out, const int16_t *in, uint32_t frames, float gainL, float gainR);
+
+    /** Adds |frames| stereo frames of |in| to |out|, scaled by |gainL|/|gainR|. */
+    static void mixStereoI16(float *out, const int16_t *in, uint32_t frames, float gainL, float gainR);
+
+    /**
+     * Linearly resamples mono |in| starting at |phase| with |step| per output frame and adds |frames| results to |out|.
+     * The caller guarantees that every source frame touched, including the next one interpolated against, is in range.
+     * @return The phase after the last output frame.
+     */
+    static uint64_t resampleMixMonoI16(float *out, const int16_t *in, uint32_t frames, uint64_t phase, uint64_t step, float gainL, float gainR);
+
+    /** Stereo version of resampleMixMonoI16. */
+    static uint64_t resampleMixStereoI16(float *out, const int16_t *in, uint32_t frames, uint64_t phase, uint64_t step, float gainL, float gainR);
+
+    /** Converts normalized float samples to 16-bit pcm, rounding and clamping to [-32768, 32767]. */
+    static void floatToI16(int16_t *out, const float *in, uint32_t count);
+};
+
+} // namespace cc
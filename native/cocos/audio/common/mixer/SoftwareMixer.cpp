@@ -0,0 +1,195 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#include "audio/common/mixer/SoftwareMixer.h"
+#include <algorithm>
+#include <cstring>
+#include "audio/common/mixer/AudioMixerKernels.h"
+
+namespace cc {
+
+namespace {
+
+constexpr uint64_t PHASE_ONE = 1ULL << AudioMixerKernels::PHASE_BITS;
+constexpr uint64_t PHASE_FRACTION_MASK = PHASE_ONE - 1;
+constexpr float PCM16_SCALE = 1.0F / 32768.0F;
+
+} // namespace
+
+SoftwareMixer::SoftwareMixer(uint32_t sampleRate, uint32_t framesPerBlock)
+: _sampleRate(sampleRate),
+  _framesPerBlock(std::max(framesPerBlock, 1U)) {
+}
+
+int SoftwareMixer::addVoice(const int16_t *pcm, uint32_t frameCount, uint32_t channelCount, uint32_t sampleRate, bool loop) {
+    if (pcm == nullptr || frameCount == 0 || sampleRate == 0 || (channelCount != 1 && channelCount != 2)) {
+        return INVALID_VOICE_ID;
+    }
+
+    auto iter = std::find_if(_voices.begin(), _voices.end(), [](const Voice &voice) { return !voice.active; });
+    if (iter == _voices.end()) {
+        iter = _voices.emplace(_voices.end());
+    }
+
+    Voice &voice = *iter;
+    voice = Voice{};
+    voice.pcm = pcm;
+    voice.frameCount = frameCount;
+    voice.channelCount = channelCount;
+    voice.sampleRate = sampleRate;
+    voice.loop = loop;
+    voice.active = true;
+    updateStep(voice);
+    ++_activeVoiceCount;
+    return static_cast<int>(iter - _voices.begin());
+}
+
+void SoftwareMixer::removeVoice(int voiceId) {
+    if (auto *voice = findVoice(voiceId)) {
+        voice->active = false;
+        --_activeVoiceCount;
+    }
+}
+
+void SoftwareMixer::removeAllVoices() {
+    _voices.clear();
+    _activeVoiceCount = 0;
+}
+
+void SoftwareMixer::setVolume(int voiceId, float left, float right) {
+    if (auto *voice = findVoice(voiceId)) {
+        voice->volumeL = left;
+        voice->volumeR = right;
+    }
+}
+
+void SoftwareMixer::setPlaybackRate(int voiceId, float rate) {
+    if (auto *voice = findVoice(voiceId)) {
+        voice->rate = std::max(rate, 0.0F);
+        updateStep(*voice);
+    }
+}
+
+void SoftwareMixer::setLoop(int voiceId, bool loop) {
+    if (auto *voice = findVoice(voiceId)) {
+        voice->loop = loop;
+    }
+}
+
+bool SoftwareMixer::isVoiceActive(int voiceId) const {
+    return voiceId >= 0 && static_cast<size_t>(voiceId) < _voices.size() && _voices[voiceId].active;
+}
+
+SoftwareMixer::Voice *SoftwareMixer::findVoice(int voiceId) {
+    return isVoiceActive(voiceId) ? &_voices[voiceId] : nullptr;
+}
+
+void SoftwareMixer::updateStep(Voice &voice) const {
+    const double step = static_cast<double>(voice.sampleRate) / _sampleRate * voice.rate * static_cast<double>(PHASE_ONE);
+    voice.step = static_cast<uint64_t>(step + 0.5);
+}
+
+void SoftwareMixer::mix(float *out, uint32_t frames) {
+    memset(out, 0, sizeof(float) * frames * OUTPUT_CHANNEL_COUNT);
+    for (auto &voice : _voices) {
+        if (voice.active) {
+            mixVoice(voice, out, frames);
+            if (!voice.active) {
+                --_activeVoiceCount;
+            }
+        }
+    }
+}
+
+void SoftwareMixer::renderToBuffer(int16_t *out, uint32_t frames) {
+    _mixBuffer.resize(static_cast<size_t>(_framesPerBlock) * OUTPUT_CHANNEL_COUNT);
+    while (frames > 0) {
+        const uint32_t blockFrames = std::min(frames, _framesPerBlock);
+        mix(_mixBuffer.data(), blockFrames);
+        AudioMixerKernels::floatToI16(out, _mixBuffer.data(), blockFrames * OUTPUT_CHANNEL_COUNT);
+        out += blockFrames * OUTPUT_CHANNEL_COUNT;
+        frames -= blockFrames;
+    }
+}
+
+void SoftwareMixer::mixVoice(Voice &voice, float *out, uint32_t frames) {
+    const float gainL = voice.volumeL * PCM16_SCALE;
+    const float gainR = voice.volumeR * PCM16_SCALE;
+    const uint32_t channels = voice.channelCount;
+    const bool isMono = channels == 1;
+
+    uint32_t done = 0;
+    while (done < frames && voice.active) {
+        float *dst = out + done * OUTPUT_CHANNEL_COUNT;
+        const uint32_t remaining = frames - done;
+        const auto index = static_cast<uint32_t>(voice.phase >> AudioMixerKernels::PHASE_BITS);
+
+        if (index >= voice.frameCount) {
+            if (voice.loop && voice.step != 0) {
+                voice.phase -= static_cast<uint64_t>(voice.frameCount) << AudioMixerKernels::PHASE_BITS;
+                continue;
+            }
+            voice.active = false;
+            break;
+        }
+
+        if (voice.step == PHASE_ONE && (voice.phase & PHASE_FRACTION_MASK) == 0) {
+            // Same rate as the output, no interpolation needed.
+            const uint32_t count = std::min(remaining, voice.frameCount - index);
+            const int16_t *src = voice.pcm + static_cast<size_t>(index) * channels;
+            if (isMono) {
+                AudioMixerKernels::mixMonoI16(dst, src, count, gainL, gainR);
+            } else {
+                AudioMixerKernels::mixStereoI16(dst, src, count, gainL, gainR);
+            }
+            voice.phase += static_cast<uint64_t>(count) << AudioMixerKernels::PHASE_BITS;
+            done += count;
+        } else if (index + 1 < voice.frameCount) {
+            // Frames whose interpolation partner is still inside the data.
+            const uint64_t lastPhase = (static_cast<uint64_t>(voice.frameCount - 1) << AudioMixerKernels::PHASE_BITS) - 1;
+            const uint64_t available = voice.step == 0 ? remaining : (lastPhase - voice.phase) / voice.step + 1;
+            const auto count = static_cast<uint32_t>(std::min<uint64_t>(remaining, available));
+            if (isMono) {
+                voice.phase = AudioMixerKernels::resampleMixMonoI16(dst, voice.pcm, count, voice.phase, voice.step, gainL, gainR);
+            } else {
+                voice.phase = AudioMixerKernels::resampleMixStereoI16(dst, voice.pcm, count, voice.phase, voice.step, gainL, gainR);
+            }
+            done += count;
+        } else {
+            // The last source frame interpolates against the first one when looping, silence otherwise.
+            const float t = static_cast<float>(voice.phase & PHASE_FRACTION_MASK) / static_cast<float>(PHASE_ONE);
+            const int16_t *a = voice.pcm + static_cast<size_t>(index) * channels;
+            for (uint32_t c = 0; c < OUTPUT_CHANNEL_COUNT; ++c) {
+                const uint32_t channel = isMono ? 0 : c;
+                const float from = a[channel];
+                const float to = voice.loop ? voice.pcm[channel] : 0.0F;
+                dst[c] += (from + (to - from) * t) * (c == 0 ? gainL : gainR);
+            }
+            voice.phase += voice.step;
+            ++done;
+        }
+    }
+}
+
+} // namespace cc
@@ -0,0 +1,104 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include "base/Macros.h"
+#include "base/std/container/vector.h"
+
+namespace cc {
+
+/**
+ * Platform-neutral software mixer modeled after the track model of the Android AudioMixer: every voice
+ * references 16-bit mono or stereo pcm data with its own sample rate, volume, playback rate and loop flag,
+ * and all voices are resampled and accumulated into one interleaved stereo float buffer with the SIMD
+ * kernels in AudioMixerKernels.
+ *
+ * The mixer doesn't own any device, so it can also render offline into a buffer (see renderToBuffer).
+ * It isn't thread safe, the pcm data referenced by voices must outlive them.
+ */
+class CC_DLL SoftwareMixer final {
+public:
+    static constexpr uint32_t OUTPUT_CHANNEL_COUNT = 2;
+    static constexpr int INVALID_VOICE_ID = -1;
+
+    explicit SoftwareMixer(uint32_t sampleRate, uint32_t framesPerBlock = 1024);
+
+    /**
+     * @brief Adds a playing voice.
+     * @param pcm Interleaved 16-bit pcm data, referenced until the voice finishes or is removed.
+     * @return The voice id, or INVALID_VOICE_ID if the format isn't supported.
+     */
+    int addVoice(const int16_t *pcm, uint32_t frameCount, uint32_t channelCount, uint32_t sampleRate, bool loop = false);
+    void removeVoice(int voiceId);
+    void removeAllVoices();
+
+    void setVolume(int voiceId, float left, float right);
+    void setPlaybackRate(int voiceId, float rate);
+    void setLoop(int voiceId, bool loop);
+
+    /** Whether the voice is still playing, non-looping voices stop by themselves at the end of their data. */
+    bool isVoiceActive(int voiceId) const;
+    uint32_t getActiveVoiceCount() const { return _activeVoiceCount; }
+
+    uint32_t getSampleRate() const { return _sampleRate; }
+
+    /** Mixes |frames| frames of all active voices into |out|, which holds |frames| * OUTPUT_CHANNEL_COUNT floats. */
+    void mix(float *out, uint32_t frames);
+
+    /**
+     * Offline mode: mixes |frames| frames block by block and converts them to interleaved 16-bit stereo pcm,
+     * e.g. to benchmark mixing throughput without an audio device.
+     */
+    void renderToBuffer(int16_t *out, uint32_t frames);
+
+private:
+    struct Voice {
+        const int16_t *pcm{nullptr};
+        uint32_t frameCount{0};
+        uint32_t channelCount{0};
+        uint32_t sampleRate{0};
+        // 32.32 fixed point source position and increment per output frame.
+        uint64_t phase{0};
+        uint64_t step{0};
+        float rate{1.0F};
+        float volumeL{1.0F};
+        float volumeR{1.0F};
+        bool loop{false};
+        bool active{false};
+    };
+
+    Voice *findVoice(int voiceId);
+    void updateStep(Voice &voice) const;
+    void mixVoice(Voice &voice, float *out, uint32_t frames);
+
+    uint32_t _sampleRate{0};
+    uint32_t _framesPerBlock{0};
+    uint32_t _activeVoiceCount{0};
+    ccstd::vector<Voice> _voices;
+    ccstd::vector<float> _mixBuffer;
+};
+
+} // namespace cc
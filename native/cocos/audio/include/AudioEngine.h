@@ -255,6 +255,20 @@ public:
      */
     static bool setMaxAudioInstance(int maxInstances);
 
+    /**
+     * Gets the budget in bytes of decoded PCM data kept in the audio cache.
+     */
+    static uint32_t getPCMCacheBudget() { return sPCMCacheBudget; }
+
+    /**
+     * Sets the budget in bytes of decoded PCM data kept in the audio cache.
+     * Least recently used caches which are not playing are released once the budget is exceeded.
+     * Only the OpenAL Soft backend keeps a PCM cache, other platforms ignore the budget.
+     *
+     * @param bytes The maximum size of cached PCM data.
+     */
+    static void setPCMCacheBudget(uint32_t bytes);
+
     /** 
      * Uncache the audio data from internal buffer.
      * AudioEngine cache audio data on ios,mac, and oalsoft platform.
@@ -379,6 +393,8 @@ protected:
 
     static unsigned int sMaxInstances;
 
+    static uint32_t sPCMCacheBudget;
+
     static ProfileHelper *sDefaultProfileHelper;
 
     static AudioEngineImpl *sAudioEngineImpl;
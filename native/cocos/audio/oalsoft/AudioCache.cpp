@@ -215,6 +215,7 @@ void AudioCache::readDataTask(unsigned int selfId) {
 
             alBufferData(_alBufferId, _format, _pcmData, static_cast<ALsizei>(dataSize), static_cast<ALsizei>(sampleRate));
 
+            _pcmDataSize = dataSize;
             _state = State::READY;
         } else {
             _isStreaming = true;
@@ -230,6 +231,7 @@ void AudioCache::readDataTask(unsigned int selfId) {
                 decoder->readFixedFrames(_queBufferFrames, _queBuffers[index]);
             }
 
+            _pcmDataSize = queBufferBytes * QUEUEBUFFER_NUM;
             _state = State::READY;
         }
 
@@ -91,6 +91,11 @@ protected:
     ALuint _alBufferId{INVALID_AL_BUFFER_ID};
     char *_pcmData{nullptr};
 
+    // Bytes of decoded pcm data held by this cache, accounted against the budget of AudioEngineImpl.
+    uint32_t _pcmDataSize{0};
+    // Engine tick of the last preload or play, the least recently used caches are evicted first.
+    uint64_t _lastUsedTick{0};
+
     /*Queue buffer related stuff
      *  Streaming in OpenAL when sizeInBytes greater then PCMDATA_CACHEMAXSIZE
      */
@@ -55,6 +55,7 @@
 #include "base/Scheduler.h"
 #include "base/memory/Memory.h"
 #include "platform/FileUtils.h"
+#include "profiler/Profiler.h"
 
 #if CC_PLATFORM == CC_PLATFORM_WINDOWS
     #include <windows.h>
@@ -127,7 +128,9 @@ static ALCcontext *sALContext = nullptr;
 
 AudioEngineImpl::AudioEngineImpl()
 : _lazyInitLoop(true),
-  _currentAudioID(0) {
+  _currentAudioID(0),
+  _pcmCacheBudget(PCMDATA_CACHE_BUDGET),
+  _cacheTick(0) {
 }
 
 AudioEngineImpl::~AudioEngineImpl() {
@@ -200,9 +203,12 @@ AudioCache *AudioEngineImpl::preload(const ccstd::string &filePath, const std::f
             }
             audioCache->readDataTask(cacheId);
         });
+        // Make room for the new cache by releasing idle ones, the new cache itself isn't loaded yet.
+        trimPCMCache();
     } else {
         audioCache = &it->second;
     }
+    audioCache->_lastUsedTick = ++_cacheTick;
 
     if (audioCache && callback) {
         audioCache->addLoadCallback(callback);
@@ -245,6 +251,7 @@ int AudioEngineImpl::play2d(const ccstd::string &filePath, bool loop, float volu
     }
 
     player->setCache(audioCache);
+    player->_streamer = &_streamer;
     _threadMutex.lock();
     _audioPlayers[_currentAudioID] = player;
     _threadMutex.unlock();
@@ -501,7 +508,9 @@ void AudioEngineImpl::update(float /*dt*/) {
             _threadMutex.unlock();
             delete player;
             _alSourceUsed[alSource] = false;
-        } else if (player->_ready && sourceState == AL_STOPPED) {
+        } else if (player->_ready && sourceState == AL_STOPPED && (!player->_streamingSource || player->_isRotateThreadExited)) {
+            // A streaming source also stops when it runs out of decoded buffers, it only finishes once
+            // the rotate buffer thread has reached the end of the stream.
             ccstd::string filePath;
             if (player->_finishCallbak) {
                 auto &audioInfo = AudioEngine::sAudioIDInfoMap[audioID];
@@ -524,6 +533,8 @@ void AudioEngineImpl::update(float /*dt*/) {
         }
     }
 
+    trimPCMCache();
+
     if (_audioPlayers.empty()) {
         _lazyInitLoop = true;
         if (auto sche = _scheduler.lock()) {
@@ -540,6 +551,46 @@ void AudioEngineImpl::uncacheAll() {
     _audioCaches.clear();
 }
 
+void AudioEngineImpl::setPCMCacheBudget(uint32_t bytes) {
+    _pcmCacheBudget = bytes;
+    trimPCMCache();
+}
+
+bool AudioEngineImpl::isCacheInUse(const AudioCache *cache) const {
+    return std::any_of(_audioPlayers.begin(), _audioPlayers.end(), [cache](const auto &it) {
+        return it.second->_audioCache == cache;
+    });
+}
+
+void AudioEngineImpl::trimPCMCache() {
+    size_t totalSize = 0;
+    for (const auto &it : _audioCaches) {
+        totalSize += it.second._pcmDataSize;
+    }
+
+    while (totalSize > _pcmCacheBudget) {
+        auto victim = _audioCaches.end();
+        for (auto it = _audioCaches.begin(); it != _audioCaches.end(); ++it) {
+            const AudioCache &cache = it->second;
+            if (!cache._isLoadingFinished || cache._pcmDataSize == 0 || isCacheInUse(&cache)) {
+                continue;
+            }
+            if (victim == _audioCaches.end() || cache._lastUsedTick < victim->second._lastUsedTick) {
+                victim = it;
+            }
+        }
+        if (victim == _audioCaches.end()) {
+            break;
+        }
+
+        ALOGV("Release pcm cache of %s, %u bytes", victim->first.c_str(), victim->second._pcmDataSize);
+        totalSize -= victim->second._pcmDataSize;
+        _audioCaches.erase(victim);
+    }
+
+    CC_PROFILE_MEMORY_UPDATE(AudioPCMCache, totalSize);
+}
+
 bool AudioEngineImpl::checkAudioIdValid(int audioID) {
     return _audioPlayers.find(audioID) != _audioPlayers.end();
 }
@@ -29,6 +29,7 @@
 #include "audio/include/AudioDef.h"
 #include "audio/oalsoft/AudioCache.h"
 #include "audio/oalsoft/AudioPlayer.h"
+#include "audio/oalsoft/AudioStreamer.h"
 #include "base/std/container/unordered_map.h"
 #include "cocos/base/RefCounted.h"
 #include "cocos/base/std/any.h"
@@ -38,6 +39,8 @@ namespace cc {
 class Scheduler;
 
 #define MAX_AUDIOINSTANCES 32
+// Default bytes of decoded pcm data kept by idle audio caches before the least recently used ones are released.
+#define PCMDATA_CACHE_BUDGET (32 * 1024 * 1024)
 
 class CC_DLL AudioEngineImpl : public RefCounted {
 public:
@@ -63,11 +66,20 @@ public:
     AudioCache *preload(const ccstd::string &filePath, const std::function<void(bool)> &callback);
     void update(float dt);
     PCMHeader getPCMHeader(const char *url);
+
+    /**
+     * Sets the upper bound of decoded pcm data held by audio caches, idle caches beyond it are released
+     * in least recently used order. Caches referenced by players or still loading are never released.
+     */
+    void setPCMCacheBudget(uint32_t bytes);
+    uint32_t getPCMCacheBudget() const { return _pcmCacheBudget; }
     ccstd::vector<uint8_t> getOriginalPCMBuffer(const char *url, uint32_t channelID);
 
 private:
     bool checkAudioIdValid(int audioID);
     void play2dImpl(AudioCache *cache, int audioID);
+    bool isCacheInUse(const AudioCache *cache) const;
+    void trimPCMCache();
 
     ALuint _alSources[MAX_AUDIOINSTANCES];
 
@@ -85,5 +97,11 @@ private:
 
     int _currentAudioID;
     std::weak_ptr<Scheduler> _scheduler;
+
+    uint32_t _pcmCacheBudget;
+    uint64_t _cacheTick;
+
+    // Decodes streaming sources ahead of their players, destroyed after the players are gone.
+    AudioStreamer _streamer;
 };
 } // namespace cc
@@ -28,9 +28,8 @@
 #include "audio/oalsoft/AudioPlayer.h"
 #include <cstdlib>
 #include <cstring>
-#include "audio/common/decoder/AudioDecoder.h"
-#include "audio/common/decoder/AudioDecoderManager.h"
 #include "audio/oalsoft/AudioCache.h"
+#include "audio/oalsoft/AudioStreamer.h"
 #include "base/Log.h"
 #include "base/memory/Memory.h"
 
@@ -48,6 +47,7 @@ AudioPlayer::AudioPlayer()
   _ready(false),
   _currTime(0.0F),
   _streamingSource(false),
+  _streamer(nullptr),
   _rotateBufferThread(nullptr),
   _timeDirty(false),
   _isRotateThreadExited(false),
@@ -102,6 +102,7 @@ void AudioPlayer::destroy() {
 
                 delete _rotateBufferThread;
                 _rotateBufferThread = nullptr;
+                _stream.reset();
                 CC_LOG_DEBUG("rotateBufferThread exited!");
             }
         }
@@ -181,8 +182,10 @@ bool AudioPlayer::play2d() {
             if (_streamingSource) {
                 alSourceQueueBuffers(_alSource, QUEUEBUFFER_NUM, _bufferIds);
                 CHECK_AL_ERROR_DEBUG();
-                _rotateBufferThread = ccnew std::thread(&AudioPlayer::rotateBufferThread, this,
-                                                        _audioCache->_queBufferFrames * QUEUEBUFFER_NUM + 1);
+                // The first QUEUEBUFFER_NUM buffers were decoded by AudioCache, the decode thread continues after them.
+                _stream = _streamer->open(_audioCache->_fileFullPath, _audioCache->_bytesPerFrame, _audioCache->_queBufferFrames,
+                                          _audioCache->_queBufferFrames * QUEUEBUFFER_NUM, _loop);
+                _rotateBufferThread = ccnew std::thread(&AudioPlayer::rotateBufferThread, this);
             } else {
                 alSourcei(_alSource, AL_BUFFER, _audioCache->_alBufferId);
                 CHECK_AL_ERROR_DEBUG();
@@ -217,82 +220,79 @@ bool AudioPlayer::play2d() {
     return ret;
 }
 
-void AudioPlayer::rotateBufferThread(int offsetFrame) {
-    char *tmpBuffer = nullptr;
-    AudioDecoder *decoder = AudioDecoderManager::createDecoder(_audioCache->_fileFullPath.c_str());
-    do {
-        BREAK_IF(decoder == nullptr || !decoder->open(_audioCache->_fileFullPath.c_str()));
-
-        uint32_t framesRead = 0;
-        const uint32_t framesToRead = _audioCache->_queBufferFrames;
-        const uint32_t bufferSize = framesToRead * decoder->getBytesPerFrame();
-        tmpBuffer = static_cast<char *>(malloc(bufferSize));
-        memset(tmpBuffer, 0, bufferSize);
-
-        if (offsetFrame != 0) {
-            decoder->seek(offsetFrame);
+void AudioPlayer::rotateBufferThread() {
+    const uint32_t framesToRead = _stream->getChunkFrames();
+    const uint32_t bytesPerFrame = _audioCache->_bytesPerFrame;
+    auto *tmpBuffer = static_cast<char *>(malloc(framesToRead * bytesPerFrame));
+
+    ALint sourceState;
+    ALint bufferProcessed = 0;
+    bool needToExitThread = false;
+    bool skipTimeStep = false;
+
+    while (!_isDestroyed) {
+        if (_timeDirty) {
+            _timeDirty = false;
+            skipTimeStep = true;
+            _stream->seek(static_cast<uint32_t>(_currTime * _audioCache->_sampleRate));
+            _streamer->notify();
         }
 
-        ALint sourceState;
-        ALint bufferProcessed = 0;
-        bool needToExitThread = false;
-
-        while (!_isDestroyed) {
-            alGetSourcei(_alSource, AL_SOURCE_STATE, &sourceState);
-            if (sourceState == AL_PLAYING) {
-                alGetSourcei(_alSource, AL_BUFFERS_PROCESSED, &bufferProcessed);
-                while (bufferProcessed > 0) {
-                    bufferProcessed--;
-                    if (_timeDirty) {
-                        _timeDirty = false;
-                        offsetFrame = static_cast<int>(_currTime * decoder->getSampleRate());
-                        decoder->seek(offsetFrame);
-                    } else {
-                        _currTime += QUEUEBUFFER_TIME_STEP;
-                        if (_currTime > _audioCache->_duration) {
-                            if (_loop) {
-                                _currTime = 0.0F;
-                            } else {
-                                _currTime = _audioCache->_duration;
-                            }
-                        }
-                    }
-
-                    framesRead = decoder->readFixedFrames(framesToRead, tmpBuffer);
+        alGetSourcei(_alSource, AL_SOURCE_STATE, &sourceState);
+        // A source that drained every queued buffer while the decode thread lagged behind stops by itself,
+        // its buffers are refilled the same way and the source is restarted below.
+        if (sourceState == AL_PLAYING || sourceState == AL_STOPPED) {
+            bool requeued = false;
+            alGetSourcei(_alSource, AL_BUFFERS_PROCESSED, &bufferProcessed);
+            while (bufferProcessed > 0) {
+                // Pcm data is decoded ahead by the decode thread, only copy ready frames here.
+                uint32_t framesRead = _stream->read(tmpBuffer, framesToRead);
+                _streamer->notify();
+                if (framesRead == 0) {
+                    // Either the stream ended or the decode thread is still catching up after a seek,
+                    // keep the processed buffer and retry in the next round.
+                    needToExitThread = _stream->isFinished();
+                    break;
+                }
+                bufferProcessed--;
 
-                    if (framesRead == 0) {
+                if (skipTimeStep) {
+                    skipTimeStep = false;
+                } else {
+                    _currTime += QUEUEBUFFER_TIME_STEP;
+                    if (_currTime > _audioCache->_duration) {
                         if (_loop) {
-                            decoder->seek(0);
-                            framesRead = decoder->readFixedFrames(framesToRead, tmpBuffer);
+                            _currTime = 0.0F;
                         } else {
-                            needToExitThread = true;
-                            break;
+                            _currTime = _audioCache->_duration;
                         }
                     }
-
-                    ALuint bid;
-                    alSourceUnqueueBuffers(_alSource, 1, &bid);
-                    alBufferData(bid, _audioCache->_format, tmpBuffer, framesRead * decoder->getBytesPerFrame(),
-                                 decoder->getSampleRate());
-                    alSourceQueueBuffers(_alSource, 1, &bid);
                 }
+
+                ALuint bid;
+                alSourceUnqueueBuffers(_alSource, 1, &bid);
+                alBufferData(bid, _audioCache->_format, tmpBuffer, static_cast<ALsizei>(framesRead * bytesPerFrame),
+                             _audioCache->_sampleRate);
+                alSourceQueueBuffers(_alSource, 1, &bid);
+                requeued = true;
             }
 
-            std::unique_lock<std::mutex> lk(_sleepMutex);
-            if (_isDestroyed || needToExitThread) {
-                break;
+            if (sourceState == AL_STOPPED && requeued) {
+                alSourcePlay(_alSource);
+                CHECK_AL_ERROR_DEBUG();
             }
+        }
 
-            _sleepCondition.wait_for(lk, std::chrono::milliseconds(75));
+        std::unique_lock<std::mutex> lk(_sleepMutex);
+        if (_isDestroyed || needToExitThread) {
+            break;
         }
 
-    } while (false);
+        _sleepCondition.wait_for(lk, std::chrono::milliseconds(75));
+    }
 
     CC_LOG_INFO("Exit rotate buffer thread ...");
-    if (decoder != nullptr) {
-        decoder->close();
-    }
-    AudioDecoderManager::destroyDecoder(decoder);
+    _streamer->close(_stream);
     free(tmpBuffer);
     _isRotateThreadExited = true;
     CC_LOG_INFO("%s exited.\n", __FUNCTION__);
@@ -301,6 +301,9 @@ void AudioPlayer::rotateBufferThread(int offsetFrame) {
 bool AudioPlayer::setLoop(bool loop) {
     if (!_isDestroyed) {
         _loop = loop;
+        if (_stream) {
+            _stream->setLoop(loop);
+        }
         return true;
     }
 
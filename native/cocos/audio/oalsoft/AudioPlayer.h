@@ -27,6 +27,7 @@
 
 #include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include "base/std/container/string.h"
@@ -45,6 +46,8 @@ namespace cc {
 
 class AudioCache;
 class AudioEngineImpl;
+class AudioStream;
+class AudioStreamer;
 
 class CC_DLL AudioPlayer {
 public:
@@ -60,7 +63,7 @@ public:
 
 protected:
     void setCache(AudioCache *cache);
-    void rotateBufferThread(int offsetFrame);
+    void rotateBufferThread();
     bool play2d();
 
     AudioCache *_audioCache;
@@ -78,6 +81,8 @@ protected:
     float _currTime;
     bool _streamingSource;
     ALuint _bufferIds[3];
+    AudioStreamer *_streamer;
+    std::shared_ptr<AudioStream> _stream;
     std::thread *_rotateBufferThread;
     std::condition_variable _sleepCondition;
     std::mutex _sleepMutex;
@@ -0,0 +1,222 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#define LOG_TAG "AudioStreamer"
+
+#include "audio/oalsoft/AudioStreamer.h"
+#include <algorithm>
+#include <cstring>
+#include "audio/common/decoder/AudioDecoder.h"
+#include "audio/common/decoder/AudioDecoderManager.h"
+#include "audio/include/AudioMacros.h"
+
+namespace cc {
+
+namespace {
+// The decode thread sleeps this long when every ring buffer is full, consumers wake it up earlier.
+constexpr auto DECODE_IDLE_INTERVAL = std::chrono::milliseconds(20);
+} // namespace
+
+AudioStream::AudioStream(const ccstd::string &fileFullPath, uint32_t bytesPerFrame, uint32_t chunkFrames, uint32_t startFrame, bool loop, AudioDecoder *decoder)
+: _fileFullPath(fileFullPath),
+  _decoder(decoder),
+  _bytesPerFrame(bytesPerFrame),
+  _chunkFrames(chunkFrames),
+  _capacityFrames(chunkFrames * STREAM_RING_BUFFER_NUM),
+  _startFrame(startFrame),
+  _loop(loop) {
+    _ring.resize(static_cast<size_t>(_capacityFrames) * _bytesPerFrame);
+    _chunk.resize(static_cast<size_t>(_chunkFrames) * _bytesPerFrame);
+    if (_decoder != nullptr && _startFrame != 0) {
+        _decoder->seek(_startFrame);
+    }
+}
+
+AudioStream::~AudioStream() {
+    if (_decoder != nullptr) {
+        _decoder->close();
+    }
+    AudioDecoderManager::destroyDecoder(_decoder);
+}
+
+uint32_t AudioStream::writableFrames() const {
+    const uint64_t used = _writeIndex.load(std::memory_order_relaxed) - _readIndex.load(std::memory_order_acquire);
+    return _capacityFrames - static_cast<uint32_t>(used);
+}
+
+uint32_t AudioStream::decode() {
+    if (_closed.load(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    if (_decoder == nullptr) {
+        _decoder = AudioDecoderManager::createDecoder(_fileFullPath.c_str());
+        if (_decoder == nullptr || !_decoder->open(_fileFullPath.c_str())) {
+            ALOGE("Failed to open stream: %s", _fileFullPath.c_str());
+            _eof.store(true, std::memory_order_release);
+            return 0;
+        }
+        if (_startFrame != 0) {
+            _decoder->seek(_startFrame);
+        }
+    }
+
+    int64_t seekFrame = _seekFrame.load(std::memory_order_acquire);
+    if (seekFrame != NO_SEEK) {
+        _decoder->seek(static_cast<uint32_t>(seekFrame));
+        _eof.store(false, std::memory_order_relaxed);
+        _discardIndex.store(_writeIndex.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        _seekEpoch.fetch_add(1, std::memory_order_release);
+        // A newer seek request posted meanwhile stays pending and is handled in the next round.
+        _seekFrame.compare_exchange_strong(seekFrame, NO_SEEK, std::memory_order_acq_rel);
+    }
+
+    uint32_t decoded = 0;
+    while (!_eof.load(std::memory_order_relaxed) && writableFrames() >= _chunkFrames) {
+        uint32_t frames = _decoder->readFixedFrames(_chunkFrames, _chunk.data());
+        if (frames == 0 && _loop.load(std::memory_order_relaxed) && _decoder->seek(0)) {
+            frames = _decoder->readFixedFrames(_chunkFrames, _chunk.data());
+        }
+        if (frames == 0) {
+            _eof.store(true, std::memory_order_release);
+            break;
+        }
+
+        const uint64_t writeIndex = _writeIndex.load(std::memory_order_relaxed);
+        const uint32_t offset = static_cast<uint32_t>(writeIndex % _capacityFrames);
+        const uint32_t head = std::min(frames, _capacityFrames - offset);
+        memcpy(_ring.data() + static_cast<size_t>(offset) * _bytesPerFrame, _chunk.data(), static_cast<size_t>(head) * _bytesPerFrame);
+        memcpy(_ring.data(), _chunk.data() + static_cast<size_t>(head) * _bytesPerFrame, static_cast<size_t>(frames - head) * _bytesPerFrame);
+        _writeIndex.store(writeIndex + frames, std::memory_order_release);
+        decoded += frames;
+
+        if (_seekFrame.load(std::memory_order_relaxed) != NO_SEEK || _closed.load(std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    return decoded;
+}
+
+uint32_t AudioStream::read(char *dst, uint32_t frames) {
+    if (_seekFrame.load(std::memory_order_acquire) != NO_SEEK) {
+        return 0;
+    }
+
+    uint64_t readIndex = _readIndex.load(std::memory_order_relaxed);
+    const uint32_t epoch = _seekEpoch.load(std::memory_order_acquire);
+    if (epoch != _consumedEpoch) {
+        _consumedEpoch = epoch;
+        readIndex = std::max(readIndex, _discardIndex.load(std::memory_order_relaxed));
+    }
+
+    const uint64_t writeIndex = _writeIndex.load(std::memory_order_acquire);
+    frames = static_cast<uint32_t>(std::min(static_cast<uint64_t>(frames), writeIndex - readIndex));
+
+    const uint32_t offset = static_cast<uint32_t>(readIndex % _capacityFrames);
+    const uint32_t head = std::min(frames, _capacityFrames - offset);
+    memcpy(dst, _ring.data() + static_cast<size_t>(offset) * _bytesPerFrame, static_cast<size_t>(head) * _bytesPerFrame);
+    memcpy(dst + static_cast<size_t>(head) * _bytesPerFrame, _ring.data(), static_cast<size_t>(frames - head) * _bytesPerFrame);
+    _readIndex.store(readIndex + frames, std::memory_order_release);
+    return frames;
+}
+
+void AudioStream::seek(uint32_t frame) {
+    _seekFrame.store(static_cast<int64_t>(frame), std::memory_order_release);
+}
+
+bool AudioStream::isFinished() const {
+    return _seekFrame.load(std::memory_order_acquire) == NO_SEEK &&
+           _eof.load(std::memory_order_acquire) &&
+           _readIndex.load(std::memory_order_relaxed) == _writeIndex.load(std::memory_order_acquire);
+}
+
+AudioStreamer::AudioStreamer() = default;
+
+AudioStreamer::~AudioStreamer() {
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _exit = true;
+    }
+    _condition.notify_one();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+std::shared_ptr<AudioStream> AudioStreamer::open(const ccstd::string &fileFullPath, uint32_t bytesPerFrame, uint32_t chunkFrames, uint32_t startFrame, bool loop) {
+    return add(std::make_shared<AudioStream>(fileFullPath, bytesPerFrame, chunkFrames, startFrame, loop));
+}
+
+std::shared_ptr<AudioStream> AudioStreamer::open(AudioDecoder *decoder, uint32_t chunkFrames, uint32_t startFrame, bool loop) {
+    return add(std::make_shared<AudioStream>("", decoder->getBytesPerFrame(), chunkFrames, startFrame, loop, decoder));
+}
+
+std::shared_ptr<AudioStream> AudioStreamer::add(std::shared_ptr<AudioStream> stream) {
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _streams.push_back(stream);
+        if (!_thread.joinable()) {
+            _thread = std::thread(&AudioStreamer::decodeThread, this);
+        }
+    }
+    _condition.notify_one();
+    return stream;
+}
+
+void AudioStreamer::close(const std::shared_ptr<AudioStream> &stream) {
+    stream->close();
+    std::lock_guard<std::mutex> lk(_mutex);
+    _streams.erase(std::remove(_streams.begin(), _streams.end(), stream), _streams.end());
+}
+
+void AudioStreamer::decodeThread() {
+    ccstd::vector<std::shared_ptr<AudioStream>> streams;
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lk(_mutex);
+            if (_exit) {
+                break;
+            }
+            streams.assign(_streams.begin(), _streams.end());
+        }
+
+        uint32_t decoded = 0;
+        for (const auto &stream : streams) {
+            decoded += stream->decode();
+        }
+        // Don't keep closed streams alive while sleeping, their decoders are released with the last reference.
+        streams.clear();
+
+        if (decoded == 0) {
+            std::unique_lock<std::mutex> lk(_mutex);
+            if (_exit) {
+                break;
+            }
+            _condition.wait_for(lk, DECODE_IDLE_INTERVAL);
+        }
+    }
+    ALOGV("Exit decode thread ...");
+}
+
+} // namespace cc
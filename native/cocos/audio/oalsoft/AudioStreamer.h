@@ -0,0 +1,137 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "base/Macros.h"
+#include "base/std/container/string.h"
+#include "base/std/container/vector.h"
+
+// How many QUEUEBUFFER_TIME_STEP chunks of decoded pcm data a stream keeps ahead of OpenAL.
+#define STREAM_RING_BUFFER_NUM (8)
+
+namespace cc {
+
+class AudioDecoder;
+
+/**
+ * Decoded pcm data of one playing stream. The decode thread of AudioStreamer is the only producer,
+ * the rotate buffer thread of the owning AudioPlayer is the only consumer, so the ring buffer is
+ * lock-free and indices are monotonic frame counters.
+ */
+class CC_DLL AudioStream {
+public:
+    /**
+     * @param decoder An opened decoder which the stream takes ownership of,
+     * nullptr to create one for |fileFullPath| in the decode thread.
+     */
+    AudioStream(const ccstd::string &fileFullPath, uint32_t bytesPerFrame, uint32_t chunkFrames, uint32_t startFrame, bool loop, AudioDecoder *decoder = nullptr);
+    ~AudioStream();
+
+    /**
+     * Consumer side: copies at most |frames| decoded frames into |dst|.
+     * @return The number of frames copied, 0 if no data is available yet or a seek is in flight.
+     */
+    uint32_t read(char *dst, uint32_t frames);
+
+    /** Consumer side: restarts decoding from |frame|, frames queued before the seek are discarded. */
+    void seek(uint32_t frame);
+
+    void setLoop(bool loop) { _loop.store(loop, std::memory_order_relaxed); }
+
+    /** Whether the decoder reached the end of a non-looping file and every decoded frame was read. */
+    bool isFinished() const;
+
+    uint32_t getChunkFrames() const { return _chunkFrames; }
+
+private:
+    static constexpr int64_t NO_SEEK = -1;
+
+    // Producer side, invoked in the decode thread only. Returns the number of frames decoded.
+    uint32_t decode();
+    void close() { _closed.store(true, std::memory_order_release); }
+
+    uint32_t writableFrames() const;
+
+    ccstd::string _fileFullPath;
+    AudioDecoder *_decoder{nullptr};
+    ccstd::vector<char> _ring;
+    ccstd::vector<char> _chunk;
+    uint32_t _bytesPerFrame{0};
+    uint32_t _chunkFrames{0};
+    uint32_t _capacityFrames{0};
+    uint32_t _startFrame{0};
+
+    std::atomic<uint64_t> _writeIndex{0};
+    std::atomic<uint64_t> _readIndex{0};
+
+    // Seek handshake: the consumer posts a frame, the producer seeks the decoder and publishes the
+    // write index at which the new data starts, then bumps the epoch.
+    std::atomic<int64_t> _seekFrame{NO_SEEK};
+    std::atomic<uint64_t> _discardIndex{0};
+    std::atomic<uint32_t> _seekEpoch{0};
+    uint32_t _consumedEpoch{0};
+
+    std::atomic<bool> _loop{false};
+    std::atomic<bool> _eof{false};
+    std::atomic<bool> _closed{false};
+
+    friend class AudioStreamer;
+};
+
+/**
+ * Owns the single decode thread which keeps the ring buffers of all streaming players filled,
+ * so AudioPlayer threads only copy ready pcm data into OpenAL buffers.
+ */
+class CC_DLL AudioStreamer {
+public:
+    AudioStreamer();
+    ~AudioStreamer();
+
+    std::shared_ptr<AudioStream> open(const ccstd::string &fileFullPath, uint32_t bytesPerFrame, uint32_t chunkFrames, uint32_t startFrame, bool loop);
+    /** Streams from an opened |decoder|, the returned stream takes ownership of it. */
+    std::shared_ptr<AudioStream> open(AudioDecoder *decoder, uint32_t chunkFrames, uint32_t startFrame, bool loop);
+    void close(const std::shared_ptr<AudioStream> &stream);
+
+    /** Wakes up the decode thread, e.g. after a consumer freed ring space or requested a seek. */
+    void notify() { _condition.notify_one(); }
+
+private:
+    std::shared_ptr<AudioStream> add(std::shared_ptr<AudioStream> stream);
+    void decodeThread();
+
+    std::thread _thread;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    ccstd::vector<std::shared_ptr<AudioStream>> _streams;
+    bool _exit{false};
+};
+
+} // namespace cc
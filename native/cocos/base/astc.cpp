@@ -25,8 +25,18 @@
 ****************************************************************************/
 
 #include "base/astc.h"
+#include <algorithm>
+#include <cstring>
 #include "platform/Image.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define CC_ASTC_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define CC_ASTC_NEON
+#endif
+
 static const unsigned int MAGIC = 0x5CA1AB13;
 static const astc_byte ASTC_HEADER_SIZE_X_BEGIN = 7;
 static const astc_byte ASTC_HEADER_SIZE_Y_BEGIN = 10;
@@ -58,3 +68,741 @@ int astcGetHeight(const astc_byte *pHeader) {
     int ysize = pHeader[ASTC_HEADER_SIZE_Y_BEGIN] + (pHeader[ASTC_HEADER_SIZE_Y_BEGIN + 1] * 256) + (pHeader[ASTC_HEADER_SIZE_Y_BEGIN + 2] * 65536);
     return ysize;
 }
+
+// Block decoding, following the "ASTC Compressed Texture Image Formats" chapter of the Khronos
+// Data Format Specification. Only the LDR profile is decoded.
+
+namespace {
+
+constexpr int MAX_TEXELS = 144;
+constexpr int MAX_WEIGHTS = 64;
+constexpr int MAX_COLOR_VALUES = 18;
+constexpr int QUANT_6 = 4;
+constexpr astc_byte ERROR_COLOR[4] = {0xFF, 0x00, 0xFF, 0xFF};
+
+// Quantization ranges of the integer sequence encoding, in increasing order.
+struct ISERange {
+    uint8_t bits;
+    uint8_t trits;
+    uint8_t quints;
+};
+
+constexpr ISERange ISE_RANGES[] = {
+    {1, 0, 0}, {0, 1, 0}, {2, 0, 0}, {0, 0, 1}, {1, 1, 0}, {3, 0, 0}, {1, 0, 1}, //   2,   3,   4,   5,   6,   8,  10
+    {2, 1, 0}, {4, 0, 0}, {2, 0, 1}, {3, 1, 0}, {5, 0, 0}, {3, 0, 1}, {4, 1, 0}, //  12,  16,  20,  24,  32,  40,  48
+    {6, 0, 0}, {4, 0, 1}, {5, 1, 0}, {7, 0, 0}, {5, 0, 1}, {6, 1, 0}, {8, 0, 0}, //  64,  80,  96, 128, 160, 192, 256
+};
+constexpr int ISE_RANGE_COUNT = static_cast<int>(sizeof(ISE_RANGES) / sizeof(ISE_RANGES[0]));
+constexpr int WEIGHT_RANGE_COUNT = 12;
+
+int iseBitCount(int count, int range) {
+    const ISERange &r = ISE_RANGES[range];
+    return r.bits * count + (r.trits ? (8 * count + 4) / 5 : 0) + (r.quints ? (7 * count + 2) / 3 : 0);
+}
+
+// 128 bit block, bit 0 is the least significant bit of the first byte.
+struct BlockBits {
+    uint64_t lo{0};
+    uint64_t hi{0};
+
+    uint32_t read(int pos, int count) const {
+        if (count == 0 || pos >= 128) {
+            return 0;
+        }
+        uint64_t value = 0;
+        if (pos >= 64) {
+            value = hi >> (pos - 64);
+        } else if (pos == 0) {
+            value = lo;
+        } else {
+            value = (lo >> pos) | (hi << (64 - pos));
+        }
+        return static_cast<uint32_t>(value & ((1ULL << count) - 1));
+    }
+
+    // Bits at or after `end` read as zero, integer sequences are padded that way.
+    uint32_t read(int pos, int count, int end) const {
+        if (pos >= end) {
+            return 0;
+        }
+        return read(pos, std::min(count, end - pos));
+    }
+
+    BlockBits reversed() const {
+        BlockBits result;
+        result.lo = reverse(hi);
+        result.hi = reverse(lo);
+        return result;
+    }
+
+    static uint64_t reverse(uint64_t v) {
+        v = ((v >> 1) & 0x5555555555555555ULL) | ((v & 0x5555555555555555ULL) << 1);
+        v = ((v >> 2) & 0x3333333333333333ULL) | ((v & 0x3333333333333333ULL) << 2);
+        v = ((v >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((v & 0x0F0F0F0F0F0F0F0FULL) << 4);
+        v = ((v >> 8) & 0x00FF00FF00FF00FFULL) | ((v & 0x00FF00FF00FF00FFULL) << 8);
+        v = ((v >> 16) & 0x0000FFFF0000FFFFULL) | ((v & 0x0000FFFF0000FFFFULL) << 16);
+        return (v >> 32) | (v << 32);
+    }
+};
+
+struct Tables {
+    uint8_t trits[256][5];
+    uint8_t quints[128][3];
+    uint8_t color[ISE_RANGE_COUNT][256]{};
+    uint8_t weight[WEIGHT_RANGE_COUNT][32];
+
+    Tables() {
+        for (uint32_t t = 0; t < 256; ++t) {
+            decodeTrits(t, trits[t]);
+        }
+        for (uint32_t q = 0; q < 128; ++q) {
+            decodeQuints(q, quints[q]);
+        }
+        // endpoints are never quantized below QUANT_6
+        for (int range = QUANT_6; range < ISE_RANGE_COUNT; ++range) {
+            const uint32_t levels = levelCount(range);
+            for (uint32_t v = 0; v < levels; ++v) {
+                color[range][v] = unquantizeColor(range, v);
+            }
+        }
+        for (int range = 0; range < WEIGHT_RANGE_COUNT; ++range) {
+            const uint32_t levels = levelCount(range);
+            for (uint32_t v = 0; v < levels; ++v) {
+                weight[range][v] = unquantizeWeight(range, v);
+            }
+        }
+    }
+
+    static uint32_t levelCount(int range) {
+        const ISERange &r = ISE_RANGES[range];
+        return (r.trits ? 3U : (r.quints ? 5U : 1U)) << r.bits;
+    }
+
+    static uint32_t bit(uint32_t v, int i) { return (v >> i) & 1; }
+
+    static void decodeTrits(uint32_t t, uint8_t *out) {
+        uint32_t c = 0;
+        if (((t >> 2) & 7) == 7) {
+            c = (((t >> 5) & 7) << 2) | (t & 3);
+            out[4] = 2;
+            out[3] = 2;
+        } else {
+            c = t & 0x1F;
+            if (((t >> 5) & 3) == 3) {
+                out[4] = 2;
+                out[3] = static_cast<uint8_t>(bit(t, 7));
+            } else {
+                out[4] = static_cast<uint8_t>(bit(t, 7));
+                out[3] = static_cast<uint8_t>((t >> 5) & 3);
+            }
+        }
+        if ((c & 3) == 3) {
+            out[2] = 2;
+            out[1] = static_cast<uint8_t>(bit(c, 4));
+            out[0] = static_cast<uint8_t>((bit(c, 3) << 1) | (bit(c, 2) & ~bit(c, 3) & 1));
+        } else if (((c >> 2) & 3) == 3) {
+            out[2] = 2;
+            out[1] = 2;
+            out[0] = static_cast<uint8_t>(c & 3);
+        } else {
+            out[2] = static_cast<uint8_t>(bit(c, 4));
+            out[1] = static_cast<uint8_t>((c >> 2) & 3);
+            out[0] = static_cast<uint8_t>((bit(c, 1) << 1) | (bit(c, 0) & ~bit(c, 1) & 1));
+        }
+    }
+
+    static void decodeQuints(uint32_t q, uint8_t *out) {
+        if (((q >> 1) & 3) == 3 && ((q >> 5) & 3) == 0) {
+            out[2] = static_cast<uint8_t>((bit(q, 0) << 2) | ((bit(q, 4) & ~bit(q, 0) & 1) << 1) | (bit(q, 3) & ~bit(q, 0) & 1));
+            out[1] = 4;
+            out[0] = 4;
+            return;
+        }
+        uint32_t c = 0;
+        if (((q >> 1) & 3) == 3) {
+            out[2] = 4;
+            c = (((q >> 3) & 3) << 3) | ((~(q >> 5) & 3) << 1) | bit(q, 0);
+        } else {
+            out[2] = static_cast<uint8_t>((q >> 5) & 3);
+            c = q & 0x1F;
+        }
+        if ((c & 7) == 5) {
+            out[1] = 4;
+            out[0] = static_cast<uint8_t>((c >> 3) & 3);
+        } else {
+            out[1] = static_cast<uint8_t>((c >> 3) & 3);
+            out[0] = static_cast<uint8_t>(c & 7);
+        }
+    }
+
+    static uint8_t unquantizeColor(int range, uint32_t value) {
+        const ISERange &r = ISE_RANGES[range];
+        if (!r.trits && !r.quints) {
+            uint32_t result = 0;
+            int filled = 0;
+            while (filled < 8) {
+                result = (result << r.bits) | value;
+                filled += r.bits;
+            }
+            return static_cast<uint8_t>(result >> (filled - 8));
+        }
+        const uint32_t m = value & ((1U << r.bits) - 1);
+        const uint32_t d = value >> r.bits;
+        const uint32_t a = bit(m, 0) ? 0x1FF : 0;
+        const uint32_t b = bit(m, 1);
+        const uint32_t c = bit(m, 2);
+        const uint32_t e = bit(m, 3);
+        const uint32_t f = bit(m, 4);
+        const uint32_t g = bit(m, 5);
+        uint32_t bb = 0;
+        uint32_t cc = 0;
+        if (r.trits) {
+            switch (r.bits) {
+                case 1: cc = 204; break;
+                case 2: bb = (b << 8) | (b << 4) | (b << 2) | (b << 1); cc = 93; break;
+                case 3: bb = (c << 8) | (b << 7) | (c << 3) | (b << 2) | (c << 1) | b; cc = 44; break;
+                case 4: bb = (e << 8) | (c << 7) | (b << 6) | (e << 2) | (c << 1) | b; cc = 22; break;
+                case 5: bb = (f << 8) | (e << 7) | (c << 6) | (b << 5) | (f << 1) | e; cc = 11; break;
+                default: bb = (g << 8) | (f << 7) | (e << 6) | (c << 5) | (b << 4) | g; cc = 5; break;
+            }
+        } else {
+            switch (r.bits) {
+                case 1: cc = 113; break;
+                case 2: bb = (b << 8) | (b << 3) | (b << 2); cc = 54; break;
+                case 3: bb = (c << 8) | (b << 7) | (c << 2) | (b << 1) | c; cc = 26; break;
+                case 4: bb = (e << 8) | (c << 7) | (b << 6) | (e << 1) | c; cc = 13; break;
+                default: bb = (f << 8) | (e << 7) | (c << 6) | (b << 5) | f; cc = 6; break;
+            }
+        }
+        uint32_t t = (d * cc + bb) ^ a;
+        return static_cast<uint8_t>((a & 0x80) | (t >> 2));
+    }
+
+    static uint8_t unquantizeWeight(int range, uint32_t value) {
+        const ISERange &r = ISE_RANGES[range];
+        uint32_t t = 0;
+        if (!r.trits && !r.quints) {
+            int filled = 0;
+            while (filled < 6) {
+                t = (t << r.bits) | value;
+                filled += r.bits;
+            }
+            t >>= filled - 6;
+        } else if (r.bits == 0) {
+            static const uint8_t TRIT_WEIGHTS[] = {0, 32, 63};
+            static const uint8_t QUINT_WEIGHTS[] = {0, 16, 32, 47, 63};
+            t = r.trits ? TRIT_WEIGHTS[value] : QUINT_WEIGHTS[value];
+        } else {
+            const uint32_t m = value & ((1U << r.bits) - 1);
+            const uint32_t d = value >> r.bits;
+            const uint32_t a = bit(m, 0) ? 0x7F : 0;
+            const uint32_t b = bit(m, 1);
+            const uint32_t c = bit(m, 2);
+            uint32_t bb = 0;
+            uint32_t cc = 0;
+            if (r.trits) {
+                switch (r.bits) {
+                    case 1: cc = 50; break;
+                    case 2: bb = (b << 6) | (b << 2) | b; cc = 23; break;
+                    default: bb = (c << 6) | (b << 5) | (c << 1) | b; cc = 11; break;
+                }
+            } else {
+                switch (r.bits) {
+                    case 1: cc = 28; break;
+                    default: bb = (b << 6) | (b << 1); cc = 13; break;
+                }
+            }
+            t = (d * cc + bb) ^ a;
+            t = (a & 0x20) | (t >> 2);
+        }
+        return static_cast<uint8_t>(t > 32 ? t + 1 : t);
+    }
+};
+
+const Tables &tables() {
+    static const Tables TABLES;
+    return TABLES;
+}
+
+// Decodes `count` values of an integer sequence starting at bit `start`.
+void decodeISE(const BlockBits &block, int start, int count, int range, uint8_t *out) {
+    const Tables &t = tables();
+    const ISERange &r = ISE_RANGES[range];
+    const int n = r.bits;
+    const int end = start + iseBitCount(count, range);
+    int pos = start;
+    auto next = [&](int bits) {
+        const uint32_t value = block.read(pos, bits, end);
+        pos += bits;
+        return value;
+    };
+    if (r.trits) {
+        static const int TRIT_BITS[5] = {2, 2, 1, 2, 1};
+        for (int i = 0; i < count; i += 5) {
+            uint32_t m[5];
+            uint32_t packed = 0;
+            int shift = 0;
+            for (int j = 0; j < 5; ++j) {
+                m[j] = next(n);
+                packed |= next(TRIT_BITS[j]) << shift;
+                shift += TRIT_BITS[j];
+            }
+            for (int j = 0; j < 5 && i + j < count; ++j) {
+                out[i + j] = static_cast<uint8_t>((t.trits[packed][j] << n) | m[j]);
+            }
+        }
+    } else if (r.quints) {
+        static const int QUINT_BITS[3] = {3, 2, 2};
+        for (int i = 0; i < count; i += 3) {
+            uint32_t m[3];
+            uint32_t packed = 0;
+            int shift = 0;
+            for (int j = 0; j < 3; ++j) {
+                m[j] = next(n);
+                packed |= next(QUINT_BITS[j]) << shift;
+                shift += QUINT_BITS[j];
+            }
+            for (int j = 0; j < 3 && i + j < count; ++j) {
+                out[i + j] = static_cast<uint8_t>((t.quints[packed][j] << n) | m[j]);
+            }
+        }
+    } else {
+        for (int i = 0; i < count; ++i) {
+            out[i] = static_cast<uint8_t>(next(n));
+        }
+    }
+}
+
+struct BlockMode {
+    int gridWidth{0};
+    int gridHeight{0};
+    int weightRange{0};
+    bool dualPlane{false};
+};
+
+bool decodeBlockMode(uint32_t mode, BlockMode *out) {
+    uint32_t range = (mode >> 4) & 1;
+    uint32_t highPrecision = (mode >> 9) & 1;
+    uint32_t dualPlane = (mode >> 10) & 1;
+    const int a = static_cast<int>((mode >> 5) & 3);
+    if ((mode & 3) != 0) {
+        range |= (mode & 3) << 1;
+        int b = static_cast<int>((mode >> 7) & 3);
+        switch ((mode >> 2) & 3) {
+            case 0: out->gridWidth = b + 4; out->gridHeight = a + 2; break;
+            case 1: out->gridWidth = b + 8; out->gridHeight = a + 2; break;
+            case 2: out->gridWidth = a + 2; out->gridHeight = b + 8; break;
+            default:
+                b &= 1;
+                if (mode & 0x100) {
+                    out->gridWidth = b + 2;
+                    out->gridHeight = a + 2;
+                } else {
+                    out->gridWidth = a + 2;
+                    out->gridHeight = b + 6;
+                }
+                break;
+        }
+    } else {
+        range |= ((mode >> 2) & 3) << 1;
+        if (((mode >> 2) & 3) == 0) {
+            return false;
+        }
+        const int b = static_cast<int>((mode >> 9) & 3);
+        switch ((mode >> 7) & 3) {
+            case 0: out->gridWidth = 12; out->gridHeight = a + 2; break;
+            case 1: out->gridWidth = a + 2; out->gridHeight = 12; break;
+            case 2:
+                out->gridWidth = a + 6;
+                out->gridHeight = b + 6;
+                dualPlane = 0;
+                highPrecision = 0;
+                break;
+            default:
+                if (a == 0) {
+                    out->gridWidth = 6;
+                    out->gridHeight = 10;
+                } else if (a == 1) {
+                    out->gridWidth = 10;
+                    out->gridHeight = 6;
+                } else {
+                    return false;
+                }
+                break;
+        }
+    }
+    out->weightRange = static_cast<int>(range) - 2 + 6 * static_cast<int>(highPrecision);
+    out->dualPlane = dualPlane != 0;
+    return true;
+}
+
+inline int clamp255(int v) { return v < 0 ? 0 : (v > 255 ? 255 : v); }
+
+inline void bitTransferSigned(int &a, int &b) {
+    b = (b >> 1) | (a & 0x80);
+    a = (a >> 1) & 0x3F;
+    if (a & 0x20) {
+        a -= 0x40;
+    }
+}
+
+inline void setColor(astc_byte *out, int r, int g, int b, int a) {
+    out[0] = static_cast<astc_byte>(clamp255(r));
+    out[1] = static_cast<astc_byte>(clamp255(g));
+    out[2] = static_cast<astc_byte>(clamp255(b));
+    out[3] = static_cast<astc_byte>(clamp255(a));
+}
+
+// Blue contraction, the inverse of the encoder moving red and green towards blue.
+inline void setContracted(astc_byte *out, int r, int g, int b, int a) {
+    setColor(out, (r + b) >> 1, (g + b) >> 1, b, a);
+}
+
+// Returns false for the HDR endpoint modes.
+bool decodeEndpoints(int cem, const uint8_t *values, astc_byte *e0, astc_byte *e1) {
+    int v[8];
+    for (int i = 0; i < ((cem >> 2) + 1) * 2; ++i) {
+        v[i] = values[i];
+    }
+    switch (cem) {
+        case 0:
+            setColor(e0, v[0], v[0], v[0], 0xFF);
+            setColor(e1, v[1], v[1], v[1], 0xFF);
+            return true;
+        case 1: {
+            const int l0 = (v[0] >> 2) | (v[1] & 0xC0);
+            const int l1 = std::min(l0 + (v[1] & 0x3F), 0xFF);
+            setColor(e0, l0, l0, l0, 0xFF);
+            setColor(e1, l1, l1, l1, 0xFF);
+            return true;
+        }
+        case 4:
+            setColor(e0, v[0], v[0], v[0], v[2]);
+            setColor(e1, v[1], v[1], v[1], v[3]);
+            return true;
+        case 5:
+            bitTransferSigned(v[1], v[0]);
+            bitTransferSigned(v[3], v[2]);
+            setColor(e0, v[0], v[0], v[0], v[2]);
+            setColor(e1, v[0] + v[1], v[0] + v[1], v[0] + v[1], v[2] + v[3]);
+            return true;
+        case 6:
+            setColor(e0, (v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, 0xFF);
+            setColor(e1, v[0], v[1], v[2], 0xFF);
+            return true;
+        case 8:
+        case 12: {
+            const int a0 = cem == 12 ? v[6] : 0xFF;
+            const int a1 = cem == 12 ? v[7] : 0xFF;
+            if (v[1] + v[3] + v[5] >= v[0] + v[2] + v[4]) {
+                setColor(e0, v[0], v[2], v[4], a0);
+                setColor(e1, v[1], v[3], v[5], a1);
+            } else {
+                setContracted(e0, v[1], v[3], v[5], a1);
+                setContracted(e1, v[0], v[2], v[4], a0);
+            }
+            return true;
+        }
+        case 9:
+        case 13: {
+            bitTransferSigned(v[1], v[0]);
+            bitTransferSigned(v[3], v[2]);
+            bitTransferSigned(v[5], v[4]);
+            int a0 = 0xFF;
+            int a1 = 0xFF;
+            if (cem == 13) {
+                bitTransferSigned(v[7], v[6]);
+                a0 = v[6];
+                a1 = v[6] + v[7];
+            }
+            if (v[1] + v[3] + v[5] >= 0) {
+                setColor(e0, v[0], v[2], v[4], a0);
+                setColor(e1, v[0] + v[1], v[2] + v[3], v[4] + v[5], a1);
+            } else {
+                setContracted(e0, v[0] + v[1], v[2] + v[3], v[4] + v[5], a1);
+                setContracted(e1, v[0], v[2], v[4], a0);
+            }
+            return true;
+        }
+        case 10:
+            setColor(e0, (v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, v[4]);
+            setColor(e1, v[0], v[1], v[2], v[5]);
+            return true;
+        default:
+            return false;
+    }
+}
+
+uint32_t hash52(uint32_t p) {
+    p ^= p >> 15;
+    p -= p << 17;
+    p += p << 7;
+    p += p << 4;
+    p ^= p >> 5;
+    p += p << 16;
+    p ^= p >> 7;
+    p ^= p >> 3;
+    p ^= p << 6;
+    p ^= p >> 17;
+    return p;
+}
+
+// The partition pattern generator, the per block part is evaluated once in the constructor.
+class PartitionSelector {
+public:
+    PartitionSelector(uint32_t seed, int partitionCount, bool smallBlock)
+    : _partitionCount(partitionCount), _smallBlock(smallBlock) {
+        seed += static_cast<uint32_t>(partitionCount - 1) * 1024;
+        _rnum = hash52(seed);
+        int seeds[8];
+        for (int i = 0; i < 8; ++i) {
+            const int s = static_cast<int>((_rnum >> (i * 4)) & 0xF);
+            seeds[i] = s * s;
+        }
+        int sh1 = 0;
+        int sh2 = 0;
+        if (seed & 1) {
+            sh1 = (seed & 2) ? 4 : 5;
+            sh2 = partitionCount == 3 ? 6 : 5;
+        } else {
+            sh1 = partitionCount == 3 ? 6 : 5;
+            sh2 = (seed & 2) ? 4 : 5;
+        }
+        for (int i = 0; i < 8; ++i) {
+            _seeds[i] = seeds[i] >> ((i & 1) ? sh2 : sh1);
+        }
+    }
+
+    int select(int x, int y) const {
+        if (_smallBlock) {
+            x <<= 1;
+            y <<= 1;
+        }
+        const int a = (_seeds[0] * x + _seeds[1] * y + static_cast<int>(_rnum >> 14)) & 0x3F;
+        const int b = (_seeds[2] * x + _seeds[3] * y + static_cast<int>(_rnum >> 10)) & 0x3F;
+        const int c = _partitionCount < 3 ? 0 : (_seeds[4] * x + _seeds[5] * y + static_cast<int>(_rnum >> 6)) & 0x3F;
+        const int d = _partitionCount < 4 ? 0 : (_seeds[6] * x + _seeds[7] * y + static_cast<int>(_rnum >> 2)) & 0x3F;
+        if (a >= b && a >= c && a >= d) return 0;
+        if (b >= c && b >= d) return 1;
+        if (c >= d) return 2;
+        return 3;
+    }
+
+private:
+    int _partitionCount{1};
+    bool _smallBlock{false};
+    uint32_t _rnum{0};
+    int _seeds[8]{};
+};
+
+// Bilinear infill of the weight grid to one weight (0..64) per texel, `stride` skips the other plane.
+void infillWeights(const uint8_t *grid, int stride, int gridWidth, int gridHeight, int blockWidth, int blockHeight, uint8_t *out) {
+    const int ds = (1024 + blockWidth / 2) / (blockWidth - 1);
+    const int dt = (1024 + blockHeight / 2) / (blockHeight - 1);
+    auto at = [&](int x, int y) -> int {
+        return x < gridWidth && y < gridHeight ? grid[(y * gridWidth + x) * stride] : 0;
+    };
+    for (int t = 0; t < blockHeight; ++t) {
+        const int gt = ((dt * t) * (gridHeight - 1) + 32) >> 6;
+        const int jt = gt >> 4;
+        const int ft = gt & 0xF;
+        for (int s = 0; s < blockWidth; ++s) {
+            const int gs = ((ds * s) * (gridWidth - 1) + 32) >> 6;
+            const int js = gs >> 4;
+            const int fs = gs & 0xF;
+            const int w11 = (fs * ft + 8) >> 4;
+            const int w10 = ft - w11;
+            const int w01 = fs - w11;
+            const int w00 = 16 - fs - ft + w11;
+            const int p = at(js, jt) * w00 + at(js + 1, jt) * w01 + at(js, jt + 1) * w10 + at(js + 1, jt + 1) * w11;
+            out[t * blockWidth + s] = static_cast<uint8_t>((p + 8) >> 4);
+        }
+    }
+}
+
+// out = top byte of the UNORM16 interpolation of the endpoints, (e * mul + add) >> 14 with
+// e = e0 * (64 - w) + e1 * w folds the 8 to 16 bit expansion and the final shifts together.
+void interpolate(const astc_byte *e0, const astc_byte *e1, const uint8_t *w, int count, uint32_t mul, uint32_t add, astc_byte *out) {
+    int i = 0;
+#if defined(CC_ASTC_SSE)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i sixtyFour = _mm_set1_epi16(64);
+    const __m128i vmul = _mm_set1_epi32(static_cast<int>(mul));
+    const __m128i vadd = _mm_set1_epi32(static_cast<int>(add));
+    for (; i + 8 <= count; i += 8) {
+        const __m128i a = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(e0 + i));
+        const __m128i b = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(e1 + i));
+        const __m128i ws = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(w + i)), zero);
+        const __m128i pairs = _mm_unpacklo_epi8(a, b);
+        const __m128i inv = _mm_sub_epi16(sixtyFour, ws);
+        const __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(pairs, zero), _mm_unpacklo_epi16(inv, ws));
+        const __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(pairs, zero), _mm_unpackhi_epi16(inv, ws));
+        // e <= 255 * 64 fits the low half of each lane, SSE2 has no 32 bit multiply
+        const __m128i rlo = _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(lo, vmul), vadd), 14);
+        const __m128i rhi = _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(hi, vmul), vadd), 14);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + i), _mm_packus_epi16(_mm_packs_epi32(rlo, rhi), zero));
+    }
+#elif defined(CC_ASTC_NEON)
+    const uint8x8_t sixtyFour = vdup_n_u8(64);
+    for (; i + 8 <= count; i += 8) {
+        const uint8x8_t ws = vld1_u8(w + i);
+        const uint16x8_t e = vmlal_u8(vmull_u8(vld1_u8(e0 + i), vsub_u8(sixtyFour, ws)), vld1_u8(e1 + i), ws);
+        const uint32x4_t lo = vshrq_n_u32(vmlaq_n_u32(vdupq_n_u32(add), vmovl_u16(vget_low_u16(e)), mul), 14);
+        const uint32x4_t hi = vshrq_n_u32(vmlaq_n_u32(vdupq_n_u32(add), vmovl_u16(vget_high_u16(e)), mul), 14);
+        vst1_u8(out + i, vqmovn_u16(vcombine_u16(vmovn_u32(lo), vmovn_u32(hi))));
+    }
+#endif
+    for (; i < count; ++i) {
+        const uint32_t e = e0[i] * (64U - w[i]) + e1[i] * w[i];
+        out[i] = static_cast<astc_byte>((e * mul + add) >> 14);
+    }
+}
+
+bool fillError(int blockWidth, int blockHeight, astc_byte *out, int stride) {
+    for (int y = 0; y < blockHeight; ++y) {
+        for (int x = 0; x < blockWidth; ++x) {
+            memcpy(out + y * stride + x * 4, ERROR_COLOR, 4);
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+bool astcDecodeBlock(const astc_byte *pBlock, int blockWidth, int blockHeight, bool srgb, astc_byte *pOut, int stride) {
+    BlockBits block;
+    for (int i = 7; i >= 0; --i) {
+        block.lo = (block.lo << 8) | pBlock[i];
+        block.hi = (block.hi << 8) | pBlock[i + 8];
+    }
+
+    const uint32_t blockModeBits = block.read(0, 11);
+    if ((blockModeBits & 0x1FF) == 0x1FC) {
+        // void extent, a constant color block; the extent itself is only an optimization hint
+        if ((blockModeBits & 0x200) || block.read(10, 2) != 3) {
+            return fillError(blockWidth, blockHeight, pOut, stride);
+        }
+        astc_byte color[4];
+        for (int c = 0; c < 4; ++c) {
+            color[c] = static_cast<astc_byte>(block.read(64 + c * 16, 16) >> 8);
+        }
+        for (int y = 0; y < blockHeight; ++y) {
+            for (int x = 0; x < blockWidth; ++x) {
+                memcpy(pOut + y * stride + x * 4, color, 4);
+            }
+        }
+        return true;
+    }
+
+    BlockMode mode;
+    if (!decodeBlockMode(blockModeBits, &mode) || mode.gridWidth > blockWidth || mode.gridHeight > blockHeight) {
+        return fillError(blockWidth, blockHeight, pOut, stride);
+    }
+    const int planeCount = mode.dualPlane ? 2 : 1;
+    const int weightCount = mode.gridWidth * mode.gridHeight * planeCount;
+    const int weightBits = iseBitCount(weightCount, mode.weightRange);
+    const int partitionCount = static_cast<int>(block.read(11, 2)) + 1;
+    if (weightCount > MAX_WEIGHTS || weightBits < 24 || weightBits > 96 || (mode.dualPlane && partitionCount == 4)) {
+        return fillError(blockWidth, blockHeight, pOut, stride);
+    }
+
+    int belowWeights = 128 - weightBits;
+    int cems[4] = {0, 0, 0, 0};
+    int configStart = 17;
+    if (partitionCount == 1) {
+        cems[0] = static_cast<int>(block.read(13, 4));
+    } else {
+        configStart = 29;
+        uint32_t encoded = block.read(23, 6);
+        if ((encoded & 3) == 0) {
+            std::fill(cems, cems + partitionCount, static_cast<int>(encoded >> 2));
+        } else {
+            const int extraBits = 3 * partitionCount - 4;
+            belowWeights -= extraBits;
+            encoded |= block.read(belowWeights, extraBits) << 6;
+            const int baseClass = static_cast<int>(encoded & 3) - 1;
+            for (int i = 0; i < partitionCount; ++i) {
+                const int cemClass = baseClass + static_cast<int>((encoded >> (2 + i)) & 1);
+                cems[i] = (cemClass << 2) | static_cast<int>((encoded >> (2 + partitionCount + 2 * i)) & 3);
+            }
+        }
+    }
+    int plane2Component = -1;
+    if (mode.dualPlane) {
+        belowWeights -= 2;
+        plane2Component = static_cast<int>(block.read(belowWeights, 2));
+    }
+
+    int colorValueCount = 0;
+    for (int i = 0; i < partitionCount; ++i) {
+        colorValueCount += ((cems[i] >> 2) + 1) * 2;
+    }
+    const int colorBits = belowWeights - configStart;
+    int colorRange = ISE_RANGE_COUNT - 1;
+    while (colorRange >= 0 && iseBitCount(colorValueCount, colorRange) > colorBits) {
+        --colorRange;
+    }
+    if (colorValueCount > MAX_COLOR_VALUES || colorRange < QUANT_6) {
+        return fillError(blockWidth, blockHeight, pOut, stride);
+    }
+
+    const Tables &t = tables();
+    uint8_t colorValues[MAX_COLOR_VALUES];
+    decodeISE(block, configStart, colorValueCount, colorRange, colorValues);
+    for (int i = 0; i < colorValueCount; ++i) {
+        colorValues[i] = t.color[colorRange][colorValues[i]];
+    }
+
+    astc_byte endpoints[4][2][4];
+    bool partitionValid[4] = {true, true, true, true};
+    const uint8_t *values = colorValues;
+    for (int i = 0; i < partitionCount; ++i) {
+        partitionValid[i] = decodeEndpoints(cems[i], values, endpoints[i][0], endpoints[i][1]);
+        if (!partitionValid[i]) {
+            memcpy(endpoints[i][0], ERROR_COLOR, 4);
+            memcpy(endpoints[i][1], ERROR_COLOR, 4);
+        }
+        values += ((cems[i] >> 2) + 1) * 2;
+    }
+
+    // weights are stored bit reversed from the top of the block
+    uint8_t gridWeights[MAX_WEIGHTS];
+    decodeISE(block.reversed(), 0, weightCount, mode.weightRange, gridWeights);
+    for (int i = 0; i < weightCount; ++i) {
+        gridWeights[i] = t.weight[mode.weightRange][gridWeights[i]];
+    }
+    const int texelCount = blockWidth * blockHeight;
+    uint8_t planeWeights[2][MAX_TEXELS];
+    for (int plane = 0; plane < planeCount; ++plane) {
+        infillWeights(gridWeights + plane, planeCount, mode.gridWidth, mode.gridHeight, blockWidth, blockHeight, planeWeights[plane]);
+    }
+
+    // gather per texel endpoints and weights, then interpolate a row at a time
+    astc_byte e0[MAX_TEXELS * 4];
+    astc_byte e1[MAX_TEXELS * 4];
+    uint8_t weights[MAX_TEXELS * 4];
+    const PartitionSelector selector(block.read(13, 10), partitionCount, texelCount < 31);
+    for (int y = 0; y < blockHeight; ++y) {
+        for (int x = 0; x < blockWidth; ++x) {
+            const int texel = y * blockWidth + x;
+            const int partition = partitionCount > 1 ? selector.select(x, y) : 0;
+            memcpy(e0 + texel * 4, endpoints[partition][0], 4);
+            memcpy(e1 + texel * 4, endpoints[partition][1], 4);
+            for (int c = 0; c < 4; ++c) {
+                weights[texel * 4 + c] = partitionValid[partition] ? planeWeights[c == plane2Component ? 1 : 0][texel] : 0;
+            }
+        }
+    }
+    const uint32_t mul = srgb ? 256 : 257;
+    const uint32_t add = srgb ? 8224 : 32;
+    for (int y = 0; y < blockHeight; ++y) {
+        const int offset = y * blockWidth * 4;
+        interpolate(e0 + offset, e1 + offset, weights + offset, blockWidth * 4, mul, add, pOut + y * stride);
+    }
+
+    bool valid = true;
+    for (int i = 0; i < partitionCount; ++i) {
+        valid = valid && partitionValid[i];
+    }
+    return valid;
+}
@@ -48,3 +48,13 @@ int astcGetWidth(const astc_byte *pHeader);
 // Read the image height from a ASTC header
 
 int astcGetHeight(const astc_byte *pHeader);
+
+// Size of an ASTC block, in bytes
+
+#define ASTC_BLOCK_SIZE 16
+
+// Decode one 2D LDR block of blockWidth x blockHeight texels into RGBA8 pixels, `stride` is the
+// distance between pixel rows in bytes. Reserved, malformed and HDR blocks decode to the error
+// color (magenta) and return false.
+
+bool astcDecodeBlock(const astc_byte *pBlock, int blockWidth, int blockHeight, bool srgb, astc_byte *pOut, int stride);
@@ -71,3 +71,189 @@ etc2_uint32 etc2_pkm_get_height(const etc2_byte *pHeader) {
 etc2_uint32 etc2_pkm_get_format(const uint8_t *pHeader) {
     return readBEUint16(pHeader + ETC2_PKM_FORMAT_OFFSET);
 }
+
+// Block decoding, see the "ETC Compressed Texture Image Formats" appendix of the OpenGL ES 3.0 spec.
+
+static const int kModifierTable[8][4] = {
+    {2, 8, -2, -8},
+    {5, 17, -5, -17},
+    {9, 29, -9, -29},
+    {13, 42, -13, -42},
+    {18, 60, -18, -60},
+    {24, 80, -24, -80},
+    {33, 106, -33, -106},
+    {47, 183, -47, -183},
+};
+
+static const int kDistanceTable[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+static const int kAlphaModifierTable[16][8] = {
+    {-3, -6, -9, -15, 2, 5, 8, 14},
+    {-3, -7, -10, -13, 2, 6, 9, 12},
+    {-2, -5, -8, -13, 1, 4, 7, 12},
+    {-2, -4, -6, -13, 1, 3, 5, 12},
+    {-3, -6, -8, -12, 2, 5, 7, 11},
+    {-3, -7, -9, -11, 2, 6, 8, 10},
+    {-4, -7, -8, -11, 3, 6, 7, 10},
+    {-3, -5, -8, -11, 2, 4, 7, 10},
+    {-2, -6, -8, -10, 1, 5, 7, 9},
+    {-2, -5, -8, -10, 1, 4, 7, 9},
+    {-2, -4, -8, -10, 1, 3, 7, 9},
+    {-2, -5, -7, -10, 1, 4, 6, 9},
+    {-3, -4, -7, -10, 2, 3, 6, 9},
+    {-1, -2, -3, -10, 0, 1, 2, 9},
+    {-4, -6, -8, -9, 3, 5, 7, 8},
+    {-3, -5, -7, -9, 2, 4, 6, 8},
+};
+
+static uint64_t readBEUint64(const etc2_byte *pIn) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value = (value << 8) | pIn[i];
+    }
+    return value;
+}
+
+static inline etc2_uint32 bits(uint64_t value, int lo, int count) {
+    return static_cast<etc2_uint32>((value >> lo) & ((1ULL << count) - 1));
+}
+
+static inline etc2_byte clamp255(int value) {
+    return static_cast<etc2_byte>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+static inline int extend4(etc2_uint32 value) { return static_cast<int>((value << 4) | value); }
+static inline int extend5(etc2_uint32 value) { return static_cast<int>((value << 3) | (value >> 2)); }
+static inline int extend6(etc2_uint32 value) { return static_cast<int>((value << 2) | (value >> 4)); }
+static inline int extend7(etc2_uint32 value) { return static_cast<int>((value << 1) | (value >> 6)); }
+
+// Pixel indices are stored column major, most significant bits in the upper half.
+static inline etc2_uint32 pixelIndex(uint64_t block, int x, int y) {
+    const int i = x * 4 + y;
+    return (bits(block, i + 16, 1) << 1) | bits(block, i, 1);
+}
+
+static inline void writePixel(etc2_byte *pOut, etc2_uint32 stride, int x, int y, int r, int g, int b) {
+    etc2_byte *pixel = pOut + y * stride + x * 4;
+    pixel[0] = clamp255(r);
+    pixel[1] = clamp255(g);
+    pixel[2] = clamp255(b);
+    pixel[3] = 255;
+}
+
+static void decodePaintColors(uint64_t block, const int paint[4][3], etc2_byte *pOut, etc2_uint32 stride) {
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            const int *color = paint[pixelIndex(block, x, y)];
+            writePixel(pOut, stride, x, y, color[0], color[1], color[2]);
+        }
+    }
+}
+
+static void decodeTMode(uint64_t block, etc2_byte *pOut, etc2_uint32 stride) {
+    const int r1 = extend4((bits(block, 59, 2) << 2) | bits(block, 56, 2));
+    const int g1 = extend4(bits(block, 52, 4));
+    const int b1 = extend4(bits(block, 48, 4));
+    const int r2 = extend4(bits(block, 44, 4));
+    const int g2 = extend4(bits(block, 40, 4));
+    const int b2 = extend4(bits(block, 36, 4));
+    const int d = kDistanceTable[(bits(block, 34, 2) << 1) | bits(block, 32, 1)];
+    const int paint[4][3] = {
+        {r1, g1, b1},
+        {r2 + d, g2 + d, b2 + d},
+        {r2, g2, b2},
+        {r2 - d, g2 - d, b2 - d},
+    };
+    decodePaintColors(block, paint, pOut, stride);
+}
+
+static void decodeHMode(uint64_t block, etc2_byte *pOut, etc2_uint32 stride) {
+    const etc2_uint32 r1 = bits(block, 59, 4);
+    const etc2_uint32 g1 = (bits(block, 56, 3) << 1) | bits(block, 52, 1);
+    const etc2_uint32 b1 = (bits(block, 51, 1) << 3) | bits(block, 47, 3);
+    const etc2_uint32 r2 = bits(block, 43, 4);
+    const etc2_uint32 g2 = bits(block, 39, 4);
+    const etc2_uint32 b2 = bits(block, 35, 4);
+    const etc2_uint32 order = ((r1 << 8) | (g1 << 4) | b1) >= ((r2 << 8) | (g2 << 4) | b2) ? 1 : 0;
+    const int d = kDistanceTable[(bits(block, 34, 1) << 2) | (bits(block, 32, 1) << 1) | order];
+    const int paint[4][3] = {
+        {extend4(r1) + d, extend4(g1) + d, extend4(b1) + d},
+        {extend4(r1) - d, extend4(g1) - d, extend4(b1) - d},
+        {extend4(r2) + d, extend4(g2) + d, extend4(b2) + d},
+        {extend4(r2) - d, extend4(g2) - d, extend4(b2) - d},
+    };
+    decodePaintColors(block, paint, pOut, stride);
+}
+
+static void decodePlanarMode(uint64_t block, etc2_byte *pOut, etc2_uint32 stride) {
+    const int ro = extend6(bits(block, 57, 6));
+    const int go = extend7((bits(block, 56, 1) << 6) | bits(block, 49, 6));
+    const int bo = extend6((bits(block, 48, 1) << 5) | (bits(block, 43, 2) << 3) | bits(block, 39, 3));
+    const int rh = extend6((bits(block, 34, 5) << 1) | bits(block, 32, 1));
+    const int gh = extend7(bits(block, 25, 7));
+    const int bh = extend6(bits(block, 19, 6));
+    const int rv = extend6(bits(block, 13, 6));
+    const int gv = extend7(bits(block, 6, 7));
+    const int bv = extend6(bits(block, 0, 6));
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            writePixel(pOut, stride, x, y,
+                       (x * (rh - ro) + y * (rv - ro) + 4 * ro + 2) >> 2,
+                       (x * (gh - go) + y * (gv - go) + 4 * go + 2) >> 2,
+                       (x * (bh - bo) + y * (bv - bo) + 4 * bo + 2) >> 2);
+        }
+    }
+}
+
+void etc2_decode_block_rgb(const etc2_byte *pBlock, etc2_byte *pOut, etc2_uint32 stride) {
+    const uint64_t block = readBEUint64(pBlock);
+    int base[2][3];
+    if (bits(block, 33, 1) == 0) {
+        // individual mode
+        for (int c = 0; c < 3; ++c) {
+            base[0][c] = extend4(bits(block, 60 - c * 8, 4));
+            base[1][c] = extend4(bits(block, 56 - c * 8, 4));
+        }
+    } else {
+        // differential mode, an overflowing second color selects one of the ETC2 modes
+        for (int c = 0; c < 3; ++c) {
+            const int color = static_cast<int>(bits(block, 59 - c * 8, 5));
+            const int delta = static_cast<int>(bits(block, 56 - c * 8, 3) ^ 4) - 4;
+            if (color + delta < 0 || color + delta > 31) {
+                if (c == 0) {
+                    decodeTMode(block, pOut, stride);
+                } else if (c == 1) {
+                    decodeHMode(block, pOut, stride);
+                } else {
+                    decodePlanarMode(block, pOut, stride);
+                }
+                return;
+            }
+            base[0][c] = extend5(static_cast<etc2_uint32>(color));
+            base[1][c] = extend5(static_cast<etc2_uint32>(color + delta));
+        }
+    }
+
+    const int *modifiers[2] = {kModifierTable[bits(block, 37, 3)], kModifierTable[bits(block, 34, 3)]};
+    const bool flip = bits(block, 32, 1) != 0;
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            const int sub = flip ? (y >> 1) : (x >> 1);
+            const int modifier = modifiers[sub][pixelIndex(block, x, y)];
+            writePixel(pOut, stride, x, y, base[sub][0] + modifier, base[sub][1] + modifier, base[sub][2] + modifier);
+        }
+    }
+}
+
+void etc2_decode_block_alpha(const etc2_byte *pBlock, etc2_byte *pOut, etc2_uint32 stride) {
+    const uint64_t block = readBEUint64(pBlock);
+    const int base = static_cast<int>(bits(block, 56, 8));
+    const int multiplier = static_cast<int>(bits(block, 52, 4));
+    const int *modifiers = kAlphaModifierTable[bits(block, 48, 4)];
+    for (int x = 0; x < 4; ++x) {
+        for (int y = 0; y < 4; ++y) {
+            const etc2_uint32 index = bits(block, 45 - (x * 4 + y) * 3, 3);
+            pOut[y * stride + x * 4 + 3] = clamp255(base + modifiers[index] * multiplier);
+        }
+    }
+}
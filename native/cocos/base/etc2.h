@@ -67,6 +67,20 @@ etc2_uint32 etc2_pkm_get_height(const etc2_byte *pHeader);
 
 etc2_uint32 etc2_pkm_get_format(const etc2_byte *pHeader);
 
+// Size of an ETC2 RGB8 block and of an ETC2 RGBA8 (EAC alpha + color) block, in bytes.
+
+#define ETC2_RGB8_BLOCK_SIZE  8
+#define ETC2_RGBA8_BLOCK_SIZE 16
+
+// Decode a 4x4 ETC2 RGB8 block into RGBA8 pixels, alpha is set to 255. ETC1 blocks are
+// valid ETC2 blocks and decode the same. `stride` is the distance between pixel rows in bytes.
+
+void etc2_decode_block_rgb(const etc2_byte *pBlock, etc2_byte *pOut, etc2_uint32 stride);
+
+// Decode a 4x4 EAC alpha block into the alpha channel of RGBA8 pixels.
+
+void etc2_decode_block_alpha(const etc2_byte *pBlock, etc2_byte *pOut, etc2_uint32 stride);
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,6 +23,8 @@
 ****************************************************************************/
 
 #include "MessageQueue.h"
+#include <algorithm>
+#include <chrono>
 #include "AutoReleasePool.h"
 #include "base/Utils.h"
 
@@ -31,6 +33,9 @@ namespace cc {
 namespace {
 uint32_t constexpr MEMORY_CHUNK_POOL_CAPACITY = 64;
 uint32_t constexpr SWITCH_CHUNK_MEMORY_REQUIREMENT = sizeof(MemoryChunkSwitchMessage) + utils::ALIGN_TO<sizeof(DummyMessage), 16>;
+
+std::atomic<uint64_t> enqueuedBytes{0};
+std::atomic<uint64_t> consumerStallNanoseconds{0};
 } // namespace
 
 MessageQueue::MemoryAllocator &MessageQueue::MemoryAllocator::getInstance() noexcept {
@@ -38,37 +43,64 @@ MessageQueue::MemoryAllocator &MessageQueue::MemoryAllocator::getInstance() noex
     return instance;
 }
 
+MessageQueue::MemoryAllocator::ThreadCache &MessageQueue::MemoryAllocator::getThreadCache() noexcept {
+    static thread_local ThreadCache cache;
+    return cache;
+}
+
+MessageQueue::MemoryAllocator::ThreadCache::~ThreadCache() {
+    auto &allocator = MessageQueue::MemoryAllocator::getInstance();
+    allocator.free(requested, requestedCount);
+    allocator.flushRecycled(*this);
+}
+
 uint8_t *MessageQueue::MemoryAllocator::request() noexcept {
-    uint8_t *newChunk = nullptr;
+    ThreadCache &cache = getThreadCache();
 
-    if (_chunkPool.try_dequeue(newChunk)) {
-        _chunkCount.fetch_sub(1, std::memory_order_acq_rel);
-    } else {
-        newChunk = memoryAllocateForMultiThread<uint8_t>(MEMORY_CHUNK_SIZE);
+    if (!cache.requestedCount) {
+        cache.requestedCount = static_cast<uint32_t>(_chunkPool.try_dequeue_bulk(cache.requested, THREAD_CACHE_SIZE));
+        _chunkCount.fetch_sub(cache.requestedCount, std::memory_order_acq_rel);
     }
-
-    return newChunk;
+    if (cache.requestedCount) {
+        return cache.requested[--cache.requestedCount];
+    }
+    return memoryAllocateForMultiThread<uint8_t>(MEMORY_CHUNK_SIZE);
 }
 
 void MessageQueue::MemoryAllocator::recycle(uint8_t *const chunk, bool const freeByUser) noexcept {
-    if (freeByUser) {
-        _chunkFreeQueue.enqueue(chunk);
-    } else {
-        free(chunk);
+    if (!freeByUser) {
+        memoryFreeForMultiThread(chunk);
+        return;
+    }
+
+    ThreadCache &cache = getThreadCache();
+    cache.recycled[cache.recycledCount++] = chunk;
+    if (cache.recycledCount == THREAD_CACHE_SIZE) {
+        flushRecycled(cache);
+    }
+}
+
+void MessageQueue::MemoryAllocator::flushRecycled(ThreadCache &cache) noexcept {
+    if (cache.recycledCount) {
+        _chunkFreeQueue.enqueue_bulk(cache.recycled, cache.recycledCount);
+        cache.recycledCount = 0;
     }
 }
 
 void MessageQueue::MemoryAllocator::freeByUser(MessageQueue *const mainMessageQueue) noexcept {
-    auto *queue = &_chunkFreeQueue;
+    auto *allocator = this;
 
     ENQUEUE_MESSAGE_1(
         mainMessageQueue, FreeChunksInFreeQueue,
-        queue, queue,
+        allocator, allocator,
         {
-            uint8_t *chunk = nullptr;
+            // chunks of the main queue are recycled on this thread, don't leave them behind
+            allocator->flushRecycled(MessageQueue::MemoryAllocator::getThreadCache());
 
-            while (queue->try_dequeue(chunk)) {
-                MessageQueue::MemoryAllocator::getInstance().free(chunk);
+            uint8_t *chunks[MEMORY_CHUNK_POOL_CAPACITY];
+            size_t count = 0;
+            while ((count = allocator->_chunkFreeQueue.try_dequeue_bulk(chunks, MEMORY_CHUNK_POOL_CAPACITY)) != 0) {
+                allocator->free(chunks, static_cast<uint32_t>(count));
             }
         });
 
@@ -81,18 +113,28 @@ MessageQueue::MemoryAllocator::~MemoryAllocator() noexcept {
 
 void MessageQueue::MemoryAllocator::destroy() noexcept {
     uint8_t *chunk = nullptr;
-    if (_chunkPool.try_dequeue(chunk)) {
-        ::free(chunk);
+    while (_chunkPool.try_dequeue(chunk)) {
+        memoryFreeForMultiThread(chunk);
         _chunkCount.fetch_sub(1, std::memory_order_acq_rel);
     }
+    // chunks flushed by exiting threads after the last free instruction
+    while (_chunkFreeQueue.try_dequeue(chunk)) {
+        memoryFreeForMultiThread(chunk);
+    }
 }
 
-void MessageQueue::MemoryAllocator::free(uint8_t *const chunk) noexcept {
-    if (_chunkCount.load(std::memory_order_acquire) >= MEMORY_CHUNK_POOL_CAPACITY) {
-        memoryFreeForMultiThread(chunk);
-    } else {
-        _chunkPool.enqueue(chunk);
-        _chunkCount.fetch_add(1, std::memory_order_acq_rel);
+void MessageQueue::MemoryAllocator::free(uint8_t *const *chunks, uint32_t count) noexcept {
+    if (!count) {
+        return;
+    }
+    const uint32_t pooled = _chunkCount.load(std::memory_order_acquire);
+    const uint32_t pooling = pooled < MEMORY_CHUNK_POOL_CAPACITY ? std::min(count, MEMORY_CHUNK_POOL_CAPACITY - pooled) : 0;
+    if (pooling) {
+        _chunkPool.enqueue_bulk(chunks, pooling);
+        _chunkCount.fetch_add(pooling, std::memory_order_acq_rel);
+    }
+    for (uint32_t i = pooling; i < count; ++i) {
+        memoryFreeForMultiThread(chunks[i]);
     }
 }
 
@@ -184,6 +226,13 @@ void MessageQueue::freeChunksInFreeQueue(MessageQueue *const mainMessageQueue) n
     MessageQueue::MemoryAllocator::getInstance().freeByUser(mainMessageQueue);
 }
 
+MessageQueueStats MessageQueue::fetchAndResetStats() noexcept {
+    MessageQueueStats stats;
+    stats.enqueuedBytes = enqueuedBytes.exchange(0, std::memory_order_relaxed);
+    stats.consumerStallNanoseconds = consumerStallNanoseconds.exchange(0, std::memory_order_relaxed);
+    return stats;
+}
+
 // NOLINTNEXTLINE(misc-no-recursion)
 uint8_t *MessageQueue::allocateImpl(uint32_t allocatedSize, uint32_t const requestSize) noexcept {
     uint32_t const alignedSize = align(requestSize, 16);
@@ -195,6 +244,7 @@ uint8_t *MessageQueue::allocateImpl(uint32_t allocatedSize, uint32_t const reque
     if (newOffset + sizeof(MemoryChunkSwitchMessage) <= MEMORY_CHUNK_SIZE) {
         uint8_t *const allocatedMemory = _writer.currentMemoryChunk + _writer.offset;
         _writer.offset = newOffset;
+        _writer.pendingBytes += alignedSize;
         return allocatedMemory;
     }
     uint8_t *const newChunk = MessageQueue::MemoryAllocator::getInstance().request();
@@ -213,8 +263,7 @@ uint8_t *MessageQueue::allocateImpl(uint32_t allocatedSize, uint32_t const reque
         pushMessages();
         pullMessages();
         CC_ASSERT_EQ(_reader.newMessageCount, 2);
-        executeMessages();
-        executeMessages();
+        executeMessages(); // skips the head DummyMessage as well
     }
 
     return allocateImpl(allocatedSize, requestSize);
@@ -223,6 +272,10 @@ uint8_t *MessageQueue::allocateImpl(uint32_t allocatedSize, uint32_t const reque
 void MessageQueue::pushMessages() noexcept {
     _writer.writtenMessageCount.fetch_add(_writer.pendingMessageCount, std::memory_order_acq_rel);
     _writer.pendingMessageCount = 0;
+    if (!_immediateMode && _writer.pendingBytes) {
+        enqueuedBytes.fetch_add(_writer.pendingBytes, std::memory_order_relaxed);
+    }
+    _writer.pendingBytes = 0;
 }
 
 void MessageQueue::pullMessages() noexcept {
@@ -255,7 +308,9 @@ Message *MessageQueue::readMessage() noexcept {
         std::unique_lock<std::mutex> lock(_mutex);
         pullMessages();          // try pulling data from consumer
         if (!hasNewMessage()) {  // still empty
+            const auto stallBegin = std::chrono::steady_clock::now();
             _condVar.wait(lock); // wait for the producer to wake me up
+            consumerStallNanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - stallBegin).count(), std::memory_order_relaxed);
             pullMessages();      // pulling again
         }
     }
@@ -295,7 +350,12 @@ MemoryChunkSwitchMessage::~MemoryChunkSwitchMessage() {
 }
 
 void MemoryChunkSwitchMessage::execute() noexcept {
-    _messageQueue->_reader.currentMemoryChunk = _newChunk;
+    // continue reading from the head of the new chunk: this message lives in the old one,
+    // which is recycled (and may be reused by another thread) as soon as it's destroyed
+    ReaderContext &reader = _messageQueue->_reader;
+    reader.currentMemoryChunk = _newChunk;
+    reader.lastMessage = getNext();
+    --reader.newMessageCount; // the head DummyMessage is pushed together with this message
     _messageQueue->pullMessages();
 }
 
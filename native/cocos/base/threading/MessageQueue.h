@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include "../memory/Memory.h"
 #include "Event.h"
@@ -31,7 +32,7 @@
 
 namespace cc {
 
-// TODO(YunHsiao): thread-specific allocators
+// message queues draw their memory chunks through per-thread caches on top of this, see MemoryAllocator
 template <typename T>
 inline T *memoryAllocateForMultiThread(uint32_t const count) noexcept {
     return static_cast<T *>(malloc(sizeof(T) * count));
@@ -75,6 +76,7 @@ struct ALIGNAS(64) WriterContext final {
     Message *lastMessage{nullptr};
     uint32_t offset{0};
     uint32_t pendingMessageCount{0};
+    uint32_t pendingBytes{0};
     std::atomic<uint32_t> writtenMessageCount{0};
 };
 
@@ -88,6 +90,11 @@ struct ALIGNAS(64) ReaderContext final {
     bool flushingFinished{false};
 };
 
+struct MessageQueueStats final {
+    uint64_t enqueuedBytes{0};            // bytes of messages and payloads pushed by producers
+    uint64_t consumerStallNanoseconds{0}; // time consumers spent blocked waiting for messages
+};
+
 // A single-producer single-consumer circular buffer queue.
 // Both the messages and their submitting data should be allocated from here.
 class ALIGNAS(64) MessageQueue final {
@@ -131,6 +138,9 @@ public:
     void recycleMemoryChunk(uint8_t *chunk) const noexcept;
     static void freeChunksInFreeQueue(MessageQueue *mainMessageQueue) noexcept;
 
+    // counters accumulated by all queues since the last call, usually fetched once per frame
+    static MessageQueueStats fetchAndResetStats() noexcept;
+
     inline void setImmediateMode(bool immediateMode) noexcept { _immediateMode = immediateMode; }
 
 private:
@@ -152,7 +162,20 @@ private:
     private:
         using ChunkQueue = moodycamel::ConcurrentQueue<uint8_t *>;
 
-        void free(uint8_t *chunk) noexcept;
+        // chunks are requested and recycled through small per-thread caches,
+        // and exchanged with the shared queues in batches
+        static constexpr uint32_t THREAD_CACHE_SIZE = 4;
+        struct ThreadCache final {
+            ~ThreadCache();
+            uint8_t *requested[THREAD_CACHE_SIZE]{};
+            uint8_t *recycled[THREAD_CACHE_SIZE]{};
+            uint32_t requestedCount{0};
+            uint32_t recycledCount{0};
+        };
+        static ThreadCache &getThreadCache() noexcept;
+
+        void flushRecycled(ThreadCache &cache) noexcept;
+        void free(uint8_t *const *chunks, uint32_t count) noexcept;
         std::atomic<uint32_t> _chunkCount{0};
         ChunkQueue _chunkPool{};
         ChunkQueue _chunkFreeQueue{};
@@ -22,12 +22,89 @@
  THE SOFTWARE.
 ****************************************************************************/
 
+
 #include "ThreadPool.h"
+#include <algorithm>
+#include "base/memory/Memory.h"
 
 namespace cc {
 
+namespace {
+constexpr uint32_t INVALID_WORKER = 0xFFFFFFFF;
+thread_local ThreadPool *tCurrentPool{nullptr};
+thread_local uint32_t tWorkerIndex{INVALID_WORKER};
+} // namespace
+
 uint8_t const ThreadPool::CPU_CORE_COUNT = std::thread::hardware_concurrency();
-uint8_t const ThreadPool::MAX_THREAD_COUNT = CPU_CORE_COUNT - 1;
+uint8_t const ThreadPool::MAX_THREAD_COUNT = std::max(CPU_CORE_COUNT - 1, 1);
+
+ThreadPool *ThreadPool::instance = nullptr;
+
+ThreadPool *ThreadPool::getInstance() {
+    if (!instance) {
+        instance = ccnew ThreadPool;
+        instance->start();
+    }
+    return instance;
+}
+
+void ThreadPool::destroyInstance() {
+    CC_SAFE_DELETE(instance);
+}
+
+// Chase-Lev deque, see "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al. 2013)
+bool WorkStealingDeque::push(ThreadPoolTask *task) noexcept {
+    const int64_t b = _bottom.load(std::memory_order_relaxed);
+    const int64_t t = _top.load(std::memory_order_acquire);
+    if (b - t >= CAPACITY) {
+        return false;
+    }
+    _buffer[b & MASK].store(task, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _bottom.store(b + 1, std::memory_order_relaxed);
+    return true;
+}
+
+ThreadPoolTask *WorkStealingDeque::pop() noexcept {
+    const int64_t b = _bottom.load(std::memory_order_relaxed) - 1;
+    _bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = _top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        _bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    ThreadPoolTask *task = _buffer[b & MASK].load(std::memory_order_relaxed);
+    if (t == b) {
+        // the last one, race against thieves
+        if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            task = nullptr;
+        }
+        _bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+ThreadPoolTask *WorkStealingDeque::steal() noexcept {
+    int64_t t = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = _bottom.load(std::memory_order_acquire);
+
+    if (t >= b) {
+        return nullptr;
+    }
+    ThreadPoolTask *task = _buffer[t & MASK].load(std::memory_order_relaxed);
+    if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return task;
+}
+
+ThreadPool::~ThreadPool() {
+    stop();
+}
 
 void ThreadPool::start() {
     if (_running) {
@@ -36,8 +113,13 @@ void ThreadPool::start() {
 
     _running = true;
 
+    _workers.reserve(MAX_THREAD_COUNT);
     for (uint8_t i = 0; i < MAX_THREAD_COUNT; ++i) {
-        addThread();
+        _workers.emplace_back(std::make_unique<Worker>());
+    }
+    // deques must all exist before any worker starts stealing
+    for (uint32_t i = 0; i < _workers.size(); ++i) {
+        _workers[i]->thread = std::thread(&ThreadPool::workerLoop, this, i);
     }
 }
 
@@ -50,33 +132,118 @@ void ThreadPool::stop() {
     _event.signalAll();
 
     for (auto &worker : _workers) {
-        if (worker.joinable()) {
-            worker.join();
+        if (worker->thread.joinable()) {
+            worker->thread.join();
         }
     }
 
+    // Run what was dispatched but never picked up, so that futures are fulfilled and owners waiting for
+    // their tasks are released. Tasks dispatched meanwhile go to the global lanes and are run as well.
+    _draining = true;
+    Task *task = nullptr;
+    bool ranAny = true;
+    while (ranAny) {
+        ranAny = false;
+        for (auto &worker : _workers) {
+            while ((task = worker->deque.pop()) != nullptr) {
+                (*task)();
+                delete task;
+                ranAny = true;
+            }
+        }
+        for (auto &lane : _lanes) {
+            while (lane.try_dequeue(task)) {
+                (*task)();
+                delete task;
+                ranAny = true;
+            }
+        }
+    }
+    _draining = false;
+    while (_freeTasks.try_dequeue(task)) {
+        delete task;
+    }
     _workers.clear();
+    _pendingCount = 0;
+}
+
+ThreadPool::Task *ThreadPool::allocTask() {
+    Task *task = nullptr;
+    if (!_freeTasks.try_dequeue(task)) {
+        task = ccnew Task;
+    }
+    return task;
 }
 
-void ThreadPool::addThread() {
-    CC_ASSERT(_workers.size() < MAX_THREAD_COUNT);
+void ThreadPool::recycleTask(Task *task) {
+    task->reset();
+    _freeTasks.enqueue(task);
+}
 
-    auto workerLoop = [this]() {
-        while (_running) {
-            Task task = nullptr;
+void ThreadPool::submit(Task *task, TaskPriority priority) {
+    bool queued = false;
+    if (priority == TaskPriority::NORMAL && tCurrentPool == this) {
+        queued = _workers[tWorkerIndex]->deque.push(task);
+    }
+    if (!queued) {
+        queued = _lanes[static_cast<size_t>(priority)].enqueue(task);
+    }
+    CC_ASSERT(queued);
 
-            if (_tasks.try_dequeue(task)) {
-                task();
-            } else {
-                // Double Check
-                _event.wait([this]() {
-                    return _tasks.size_approx() != 0;
-                });
-            }
+    _pendingCount.fetch_add(1, std::memory_order_seq_cst);
+    if (_sleepingCount.load(std::memory_order_seq_cst) > 0) {
+        _event.signal();
+    }
+}
+
+ThreadPool::Task *ThreadPool::acquireTask(uint32_t workerIndex) {
+    Task *task = nullptr;
+    if (_lanes[static_cast<size_t>(TaskPriority::HIGH)].try_dequeue(task)) {
+        return task;
+    }
+    if ((task = _workers[workerIndex]->deque.pop()) != nullptr) {
+        return task;
+    }
+    if (_lanes[static_cast<size_t>(TaskPriority::NORMAL)].try_dequeue(task)) {
+        return task;
+    }
+
+    const auto workerCount = static_cast<uint32_t>(_workers.size());
+    for (uint32_t i = 1; i < workerCount; ++i) {
+        if ((task = _workers[(workerIndex + i) % workerCount]->deque.steal()) != nullptr) {
+            return task;
         }
-    };
+    }
+
+    if (_lanes[static_cast<size_t>(TaskPriority::LOW)].try_dequeue(task)) {
+        return task;
+    }
+    return nullptr;
+}
+
+void ThreadPool::workerLoop(uint32_t workerIndex) {
+    tCurrentPool = this;
+    tWorkerIndex = workerIndex;
+
+    while (_running) {
+        Task *task = acquireTask(workerIndex);
+        if (task) {
+            _pendingCount.fetch_sub(1, std::memory_order_relaxed);
+            (*task)();
+            recycleTask(task);
+            continue;
+        }
+
+        // a steal may fail spuriously under contention, so only sleep when nothing is pending at all
+        _sleepingCount.fetch_add(1, std::memory_order_seq_cst);
+        _event.wait([this]() {
+            return _pendingCount.load(std::memory_order_seq_cst) != 0 || !_running;
+        });
+        _sleepingCount.fetch_sub(1, std::memory_order_relaxed);
+    }
 
-    _workers.emplace_back(workerLoop);
+    tCurrentPool = nullptr;
+    tWorkerIndex = INVALID_WORKER;
 }
 
 } // namespace cc
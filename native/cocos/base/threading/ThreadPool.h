@@ -22,64 +22,202 @@
  THE SOFTWARE.
 ****************************************************************************/
 
+
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <future>
+#include <new>
 #include <thread>
-#include "Event.h"
+#include <type_traits>
+#include <utility>
+#include "ConditionVariable.h"
 #include "base/Macros.h"
-#include "base/std/container/list.h"
+#include "base/std/container/vector.h"
 #include "concurrentqueue/concurrentqueue.h"
 
 namespace cc {
 
+enum class TaskPriority : uint8_t {
+    HIGH,
+    NORMAL,
+    LOW,
+    COUNT,
+};
+
+/**
+ * Type-erased, move-only callable with inline storage.
+ * Callables larger than INLINE_SIZE fall back to the heap.
+ */
+class ThreadPoolTask final {
+public:
+    static constexpr size_t INLINE_SIZE = 64;
+
+    ThreadPoolTask() = default;
+    ~ThreadPoolTask() { reset(); }
+    ThreadPoolTask(ThreadPoolTask const &) = delete;
+    ThreadPoolTask(ThreadPoolTask &&) noexcept = delete;
+    ThreadPoolTask &operator=(ThreadPoolTask const &) = delete;
+    ThreadPoolTask &operator=(ThreadPoolTask &&) noexcept = delete;
+
+    template <typename Function>
+    void emplace(Function &&func);
+    void reset();
+    inline void operator()() { _invoke(_target); }
+
+private:
+    using Invoke = void (*)(void *);
+    using Destroy = void (*)(void *, bool);
+
+    template <typename Function>
+    static void invokeImpl(void *target) { (*static_cast<Function *>(target))(); }
+    template <typename Function>
+    static void destroyImpl(void *target, bool heap);
+
+    alignas(std::max_align_t) unsigned char _storage[INLINE_SIZE];
+    void *_target{nullptr};
+    Invoke _invoke{nullptr};
+    Destroy _destroy{nullptr};
+    bool _heap{false};
+};
+
+/**
+ * Chase-Lev work-stealing deque of fixed capacity.
+ * The owner thread pushes and pops at the bottom, other threads steal from the top.
+ */
+class WorkStealingDeque final {
+public:
+    static constexpr int64_t CAPACITY = 1024;
+
+    bool push(ThreadPoolTask *task) noexcept; // owner only, returns false when full
+    ThreadPoolTask *pop() noexcept;           // owner only
+    ThreadPoolTask *steal() noexcept;         // any thread
+
+private:
+    static constexpr int64_t MASK = CAPACITY - 1;
+    static_assert((CAPACITY & MASK) == 0, "capacity should be a power of two");
+
+    alignas(64) std::atomic<int64_t> _top{0};
+    alignas(64) std::atomic<int64_t> _bottom{0};
+    std::array<std::atomic<ThreadPoolTask *>, CAPACITY> _buffer{};
+};
+
 class ThreadPool final {
 public:
-    using Task = std::function<void()>;
-    using TaskQueue = moodycamel::ConcurrentQueue<Task>;
+    using Task = ThreadPoolTask;
+    using TaskQueue = moodycamel::ConcurrentQueue<Task *>;
 
     static uint8_t const CPU_CORE_COUNT;
     static uint8_t const MAX_THREAD_COUNT;
 
+    static ThreadPool *getInstance();
+    static void destroyInstance();
+
     ThreadPool() = default;
-    ~ThreadPool() = default;
+    ~ThreadPool();
     ThreadPool(ThreadPool const &) = delete;
     ThreadPool(ThreadPool &&) noexcept = delete;
     ThreadPool &operator=(ThreadPool const &) = delete;
     ThreadPool &operator=(ThreadPool &&) noexcept = delete;
 
+    /**
+     * Fire-and-forget dispatch. Normal priority tasks dispatched from a worker
+     * go to its own deque and may be stolen by idle workers, everything else
+     * goes to the global lane of its priority.
+     */
+    template <typename Function>
+    void dispatch(Function &&func, TaskPriority priority = TaskPriority::NORMAL);
+
     template <typename Function, typename... Args>
     auto dispatchTask(Function &&func, Args &&...args) -> std::future<decltype(func(std::forward<Args>(args)...))>;
+
     void start();
+    /**
+     * Joins the workers, then runs the tasks still queued on the calling thread,
+     * so no dispatched task is dropped and every future is fulfilled.
+     */
     void stop();
 
-private:
-    using Event = ConditionVariable;
-
-    void addThread();
+    inline uint32_t getWorkerCount() const { return static_cast<uint32_t>(_workers.size()); }
 
-    TaskQueue _tasks{};
-    ccstd::list<std::thread> _workers{};
-    Event _event{};
+private:
+    struct Worker {
+        std::thread thread;
+        WorkStealingDeque deque;
+    };
+
+    Task *allocTask();
+    void recycleTask(Task *task);
+    void submit(Task *task, TaskPriority priority);
+    Task *acquireTask(uint32_t workerIndex);
+    void workerLoop(uint32_t workerIndex);
+
+    ccstd::vector<std::unique_ptr<Worker>> _workers;
+    std::array<TaskQueue, static_cast<size_t>(TaskPriority::COUNT)> _lanes{};
+    TaskQueue _freeTasks{};
+    ConditionVariable _event{};
+    std::atomic<uint32_t> _pendingCount{0};
+    std::atomic<uint32_t> _sleepingCount{0};
     std::atomic<bool> _running{false};
-    uint8_t _workerCount{MAX_THREAD_COUNT};
+    bool _draining{false};
+
+    static ThreadPool *instance;
 };
 
+template <typename Function>
+void ThreadPoolTask::emplace(Function &&func) {
+    using Callable = std::decay_t<Function>;
+    CC_ASSERT(!_target);
+    if constexpr (sizeof(Callable) <= INLINE_SIZE && alignof(Callable) <= alignof(std::max_align_t)) {
+        _target = new (_storage) Callable(std::forward<Function>(func));
+        _heap = false;
+    } else {
+        _target = new Callable(std::forward<Function>(func));
+        _heap = true;
+    }
+    _invoke = &invokeImpl<Callable>;
+    _destroy = &destroyImpl<Callable>;
+}
+
+template <typename Function>
+void ThreadPoolTask::destroyImpl(void *target, bool heap) {
+    auto *callable = static_cast<Function *>(target);
+    if (heap) {
+        delete callable;
+    } else {
+        callable->~Function();
+    }
+}
+
+inline void ThreadPoolTask::reset() {
+    if (_target) {
+        _destroy(_target, _heap);
+        _target = nullptr;
+    }
+}
+
+template <typename Function>
+void ThreadPool::dispatch(Function &&func, TaskPriority priority) {
+    CC_ASSERT(_running || _draining);
+
+    Task *task = allocTask();
+    task->emplace(std::forward<Function>(func));
+    submit(task, priority);
+}
+
 template <typename Function, typename... Args>
 auto ThreadPool::dispatchTask(Function &&func, Args &&...args) -> std::future<decltype(func(std::forward<Args>(args)...))> {
-    CC_ASSERT(_running);
-
     using ReturnType = decltype(func(std::forward<Args>(args)...));
-    auto task = std::make_shared<std::packaged_task<ReturnType()>>(std::bind(std::forward<Function>(func), std::forward<Args>(args)...));
-    bool const succeed = _tasks.enqueue([task]() {
-        (*task)();
+    std::packaged_task<ReturnType()> task(std::bind(std::forward<Function>(func), std::forward<Args>(args)...));
+    auto future = task.get_future();
+    dispatch([task = std::move(task)]() mutable {
+        task();
     });
-    CC_ASSERT(succeed);
-    _event.signal();
-    return task->get_future();
+    return future;
 }
 
 } // namespace cc
@@ -165,6 +165,10 @@
 #define cc_RenderEntity_stencilStage_set(self_, val_) self_->setStencilStage(val_)
   
 
+#define cc_Batcher2d_retainedMode_get(self_) self_->isRetainedMode()
+#define cc_Batcher2d_retainedMode_set(self_, val_) self_->setRetainedMode(val_)
+  
+
 
 se::Class* __jsb_cc_MeshBufferLayout_class = nullptr;
 se::Object* __jsb_cc_MeshBufferLayout_proto = nullptr;
@@ -3825,10 +3829,49 @@ static bool js_cc_Batcher2d_handlePostRender(se::State& s)
 }
 SE_BIND_FUNC(js_cc_Batcher2d_handlePostRender) 
 
+static bool js_cc_Batcher2d_retainedMode_set(se::State& s)
+{
+    CC_UNUSED bool ok = true;
+    const auto& args = s.args();
+    size_t argc = args.size();
+    cc::Batcher2d *arg1 = (cc::Batcher2d *) NULL ;
+    bool arg2 ;
+    
+    arg1 = SE_THIS_OBJECT<cc::Batcher2d>(s);
+    if (nullptr == arg1) return true;
+    
+    ok &= sevalue_to_native(args[0], &arg2);
+    SE_PRECONDITION2(ok, false, "Error processing arguments");
+    
+    cc_Batcher2d_retainedMode_set(arg1,arg2);
+    
+    
+    return true;
+}
+SE_BIND_PROP_SET(js_cc_Batcher2d_retainedMode_set) 
+
+static bool js_cc_Batcher2d_retainedMode_get(se::State& s)
+{
+    CC_UNUSED bool ok = true;
+    cc::Batcher2d *arg1 = (cc::Batcher2d *) NULL ;
+    bool result;
+    
+    arg1 = SE_THIS_OBJECT<cc::Batcher2d>(s);
+    if (nullptr == arg1) return true;
+    result = (bool)cc_Batcher2d_retainedMode_get(arg1);
+    
+    ok &= nativevalue_to_se(result, s.rval(), s.thisObject()); 
+    
+    
+    return true;
+}
+SE_BIND_PROP_GET(js_cc_Batcher2d_retainedMode_get) 
+
 bool js_register_cc_Batcher2d(se::Object* obj) {
     auto* cls = se::Class::create("Batcher2d", obj, nullptr, _SE(js_new_Batcher2d)); 
     
     cls->defineStaticProperty("__isJSB", se::Value(true), se::PropertyAttribute::READ_ONLY | se::PropertyAttribute::DONT_ENUM | se::PropertyAttribute::DONT_DELETE);
+    cls->defineProperty("retainedMode", _SE(js_cc_Batcher2d_retainedMode_get), _SE(js_cc_Batcher2d_retainedMode_set)); 
     
     cls->defineFunction("syncMeshBuffersToNative", _SE(js_cc_Batcher2d_syncMeshBuffersToNative)); 
     cls->defineFunction("initialize", _SE(js_cc_Batcher2d_initialize)); 
@@ -884,6 +884,47 @@ static bool js_cc_AudioEngine_setMaxAudioInstance_static(se::State& s)
 }
 SE_BIND_FUNC(js_cc_AudioEngine_setMaxAudioInstance_static) 
 
+static bool js_cc_AudioEngine_getPCMCacheBudget_static(se::State& s)
+{
+    CC_UNUSED bool ok = true;
+    const auto& args = s.args();
+    size_t argc = args.size();
+    uint32_t result;
+    
+    if(argc != 0) {
+        SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+        return false;
+    }
+    result = (uint32_t)cc::AudioEngine::getPCMCacheBudget();
+    
+    ok &= nativevalue_to_se(result, s.rval(), s.thisObject());
+    
+    
+    return true;
+}
+SE_BIND_FUNC(js_cc_AudioEngine_getPCMCacheBudget_static) 
+
+static bool js_cc_AudioEngine_setPCMCacheBudget_static(se::State& s)
+{
+    CC_UNUSED bool ok = true;
+    const auto& args = s.args();
+    size_t argc = args.size();
+    uint32_t arg1 ;
+    
+    if(argc != 1) {
+        SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+        return false;
+    }
+    
+    ok &= sevalue_to_native(args[0], &arg1, s.thisObject());
+    SE_PRECONDITION2(ok, false, "Error processing arguments"); 
+    cc::AudioEngine::setPCMCacheBudget(arg1);
+    
+    
+    return true;
+}
+SE_BIND_FUNC(js_cc_AudioEngine_setPCMCacheBudget_static) 
+
 static bool js_cc_AudioEngine_uncache_static(se::State& s)
 {
     CC_UNUSED bool ok = true;
@@ -1174,6 +1215,8 @@ bool js_register_cc_AudioEngine(se::Object* obj) {
     cls->defineStaticFunction("setFinishCallback", _SE(js_cc_AudioEngine_setFinishCallback_static)); 
     cls->defineStaticFunction("getMaxAudioInstance", _SE(js_cc_AudioEngine_getMaxAudioInstance_static)); 
     cls->defineStaticFunction("setMaxAudioInstance", _SE(js_cc_AudioEngine_setMaxAudioInstance_static)); 
+    cls->defineStaticFunction("getPCMCacheBudget", _SE(js_cc_AudioEngine_getPCMCacheBudget_static)); 
+    cls->defineStaticFunction("setPCMCacheBudget", _SE(js_cc_AudioEngine_setPCMCacheBudget_static)); 
     cls->defineStaticFunction("uncache", _SE(js_cc_AudioEngine_uncache_static)); 
     cls->defineStaticFunction("uncacheAll", _SE(js_cc_AudioEngine_uncacheAll_static)); 
     cls->defineStaticFunction("getProfile", _SE(js_cc_AudioEngine_getProfile_static)); 
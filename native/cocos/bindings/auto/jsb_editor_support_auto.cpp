@@ -57,6 +57,11 @@
 
 #include "bindings/auto/jsb_editor_support_auto.h"
 
+  
+
+#define cc_middleware_MiddlewareManager_parallelUpdateEnabled_get(self_) self_->isParallelUpdateEnabled()
+#define cc_middleware_MiddlewareManager_parallelUpdateEnabled_set(self_, val_) self_->setParallelUpdateEnabled(val_)
+  
 
 
 se::Class* __jsb_cc_middleware_Color4B_class = nullptr;
@@ -3105,12 +3110,51 @@ static bool js_cc_middleware_MiddlewareManager_isUpdating_get(se::State& s)
 }
 SE_BIND_PROP_GET(js_cc_middleware_MiddlewareManager_isUpdating_get) 
 
+static bool js_cc_middleware_MiddlewareManager_parallelUpdateEnabled_set(se::State& s)
+{
+    CC_UNUSED bool ok = true;
+    const auto& args = s.args();
+    size_t argc = args.size();
+    cc::middleware::MiddlewareManager *arg1 = (cc::middleware::MiddlewareManager *) NULL ;
+    bool arg2 ;
+    
+    arg1 = SE_THIS_OBJECT<cc::middleware::MiddlewareManager>(s);
+    if (nullptr == arg1) return true;
+    
+    ok &= sevalue_to_native(args[0], &arg2);
+    SE_PRECONDITION2(ok, false, "Error processing arguments");
+    
+    cc_middleware_MiddlewareManager_parallelUpdateEnabled_set(arg1,arg2);
+    
+    
+    return true;
+}
+SE_BIND_PROP_SET(js_cc_middleware_MiddlewareManager_parallelUpdateEnabled_set) 
+
+static bool js_cc_middleware_MiddlewareManager_parallelUpdateEnabled_get(se::State& s)
+{
+    CC_UNUSED bool ok = true;
+    cc::middleware::MiddlewareManager *arg1 = (cc::middleware::MiddlewareManager *) NULL ;
+    bool result;
+    
+    arg1 = SE_THIS_OBJECT<cc::middleware::MiddlewareManager>(s);
+    if (nullptr == arg1) return true;
+    result = (bool)cc_middleware_MiddlewareManager_parallelUpdateEnabled_get(arg1);
+    
+    ok &= nativevalue_to_se(result, s.rval(), s.thisObject()); 
+    
+    
+    return true;
+}
+SE_BIND_PROP_GET(js_cc_middleware_MiddlewareManager_parallelUpdateEnabled_get) 
+
 bool js_register_cc_middleware_MiddlewareManager(se::Object* obj) {
     auto* cls = se::Class::create("MiddlewareManager", obj, nullptr, _SE(js_new_cc_middleware_MiddlewareManager)); 
     
     cls->defineStaticProperty("__isJSB", se::Value(true), se::PropertyAttribute::READ_ONLY | se::PropertyAttribute::DONT_ENUM | se::PropertyAttribute::DONT_DELETE);
     cls->defineProperty("isRendering", _SE(js_cc_middleware_MiddlewareManager_isRendering_get), _SE(js_cc_middleware_MiddlewareManager_isRendering_set)); 
     cls->defineProperty("isUpdating", _SE(js_cc_middleware_MiddlewareManager_isUpdating_get), _SE(js_cc_middleware_MiddlewareManager_isUpdating_set)); 
+    cls->defineProperty("parallelUpdateEnabled", _SE(js_cc_middleware_MiddlewareManager_parallelUpdateEnabled_get), _SE(js_cc_middleware_MiddlewareManager_parallelUpdateEnabled_set)); 
     
     cls->defineFunction("update", _SE(js_cc_middleware_MiddlewareManager_update)); 
     cls->defineFunction("render", _SE(js_cc_middleware_MiddlewareManager_render)); 
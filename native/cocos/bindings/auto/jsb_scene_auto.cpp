@@ -695,6 +695,10 @@ using namespace cc;
 #define cc_scene_RenderScene_lodGroups_get(self_) self_->getLODGroups()
   
 
+#define cc_scene_RenderScene_parallelUpdateEnabled_get(self_) self_->isParallelUpdateEnabled()
+#define cc_scene_RenderScene_parallelUpdateEnabled_set(self_, val_) self_->setParallelUpdateEnabled(val_)
+  
+
 #define cc_scene_Skybox_model_get(self_) self_->getModel()
   
 
@@ -1123,10 +1127,18 @@ using namespace cc;
 #define cc_scene_OctreeInfo_depth_set(self_, val_) self_->setDepth(val_)
   
 
+#define cc_scene_OctreeInfo_spatialIndex_get(self_) self_->getSpatialIndex()
+#define cc_scene_OctreeInfo_spatialIndex_set(self_, val_) self_->setSpatialIndex(val_)
+  
+
 #define cc_Scene_autoReleaseAssets_get(self_) self_->isAutoReleaseAssets()
 #define cc_Scene_autoReleaseAssets_set(self_, val_) self_->setAutoReleaseAssets(val_)
   
 
+#define cc_Scene_transformStoreEnabled_get(self_) self_->isTransformStoreEnabled()
+#define cc_Scene_transformStoreEnabled_set(self_, val_) self_->setTransformStoreEnabled(val_)
+  
+
 #define cc_scene_ReflectionProbe_probeType_get(self_) self_->getProbeType()
 #define cc_scene_ReflectionProbe_probeType_set(self_, val_) self_->setProbeType(val_)
   
@@ -4264,11 +4276,49 @@ static bool js_cc_Scene_autoReleaseAssets_get(se::State& s)
 }
 SE_BIND_PROP_GET(js_cc_Scene_autoReleaseAssets_get) 
 
+static bool js_cc_Scene_transformStoreEnabled_set(se::State& s)
+{
+    CC_UNUSED bool ok = true;
+    const auto& args = s.args();
+    size_t argc = args.size();
+    cc::Scene *arg1 = (cc::Scene *) NULL ;
+    bool arg2 ;
+    
+    arg1 = SE_THIS_OBJECT<cc::Scene>(s);
+    if (nullptr == arg1) return true;
+    
+    ok &= sevalue_to_native(args[0], &arg2);
+    SE_PRECONDITION2(ok, false, "Error processing arguments"); 
+    cc_Scene_transformStoreEnabled_set(arg1,arg2);
+    
+    
+    return true;
+}
+SE_BIND_PROP_SET(js_cc_Scene_transformStoreEnabled_set) 
+
+static bool js_cc_Scene_transformStoreEnabled_get(se::State& s)
+{
+    CC_UNUSED bool ok = true;
+    cc::Scene *arg1 = (cc::Scene *) NULL ;
+    bool result;
+    
+    arg1 = SE_THIS_OBJECT<cc::Scene>(s);
+    if (nullptr == arg1) return true;
+    result = (bool)cc_Scene_transformStoreEnabled_get(arg1);
+    
+    ok &= nativevalue_to_se(result, s.rval(), s.thisObject());
+    
+    
+    return true;
+}
+SE_BIND_PROP_GET(js_cc_Scene_transformStoreEnabled_get) 
+
 bool js_register_cc_Scene(se::Object* obj) {
     auto* cls = se::Class::create("Scene", obj, __jsb_cc_Node_proto, _SE(js_new_Scene)); 
     
     cls->defineStaticProperty("__isJSB", se::Value(true), se::PropertyAttribute::READ_ONLY | se::PropertyAttribute::DONT_ENUM | se::PropertyAttribute::DONT_DELETE);
     cls->defineProperty("autoReleaseAssets", _SE(js_cc_Scene_autoReleaseAssets_get), _SE(js_cc_Scene_autoReleaseAssets_set)); 
+    cls->defineProperty("transformStoreEnabled", _SE(js_cc_Scene_transformStoreEnabled_get), _SE(js_cc_Scene_transformStoreEnabled_set)); 
     
     cls->defineFunction("getRenderScene", _SE(js_cc_Scene_getRenderScene)); 
     cls->defineFunction("getSceneGlobals", _SE(js_cc_Scene_getSceneGlobals)); 
@@ -20501,6 +20551,43 @@ static bool js_cc_scene_RenderScene_lodGroups_get(se::State& s)
 }
 SE_BIND_PROP_GET(js_cc_scene_RenderScene_lodGroups_get) 
 
+static bool js_cc_scene_RenderScene_parallelUpdateEnabled_set(se::State& s)
+{
+    CC_UNUSED bool ok = true;
+    const auto& args = s.args();
+    size_t argc = args.size();
+    cc::scene::RenderScene *arg1 = (cc::scene::RenderScene *) NULL ;
+    bool arg2 ;
+    
+    arg1 = SE_THIS_OBJECT<cc::scene::RenderScene>(s);
+    if (nullptr == arg1) return true;
+    
+    ok &= sevalue_to_native(args[0], &arg2);
+    SE_PRECONDITION2(ok, false, "Error processing arguments"); 
+    cc_scene_RenderScene_parallelUpdateEnabled_set(arg1,arg2);
+    
+    
+    return true;
+}
+SE_BIND_PROP_SET(js_cc_scene_RenderScene_parallelUpdateEnabled_set) 
+
+static bool js_cc_scene_RenderScene_parallelUpdateEnabled_get(se::State& s)
+{
+    CC_UNUSED bool ok = true;
+    cc::scene::RenderScene *arg1 = (cc::scene::RenderScene *) NULL ;
+    bool result;
+    
+    arg1 = SE_THIS_OBJECT<cc::scene::RenderScene>(s);
+    if (nullptr == arg1) return true;
+    result = (bool)cc_scene_RenderScene_parallelUpdateEnabled_get(arg1);
+    
+    ok &= nativevalue_to_se(result, s.rval(), s.thisObject());
+    
+    
+    return true;
+}
+SE_BIND_PROP_GET(js_cc_scene_RenderScene_parallelUpdateEnabled_get) 
+
 bool js_register_cc_scene_RenderScene(se::Object* obj) {
     auto* cls = se::Class::create("RenderScene", obj, nullptr, _SE(js_new_cc_scene_RenderScene)); 
     
@@ -20513,6 +20600,7 @@ bool js_register_cc_scene_RenderScene(se::Object* obj) {
     cls->defineProperty("rangedDirLights", _SE(js_cc_scene_RenderScene_rangedDirLights_get), nullptr); 
     cls->defineProperty("models", _SE(js_cc_scene_RenderScene_models_get), nullptr); 
     cls->defineProperty("lodGroups", _SE(js_cc_scene_RenderScene_lodGroups_get), nullptr); 
+    cls->defineProperty("parallelUpdateEnabled", _SE(js_cc_scene_RenderScene_parallelUpdateEnabled_get), _SE(js_cc_scene_RenderScene_parallelUpdateEnabled_set)); 
     
     cls->defineFunction("initialize", _SE(js_cc_scene_RenderScene_initialize)); 
     cls->defineFunction("update", _SE(js_cc_scene_RenderScene_update)); 
@@ -27863,6 +27951,43 @@ static bool js_cc_scene_OctreeInfo__depth_get(se::State& s)
 }
 SE_BIND_PROP_GET(js_cc_scene_OctreeInfo__depth_get) 
 
+static bool js_cc_scene_OctreeInfo__spatialIndex_set(se::State& s)
+{
+    CC_UNUSED bool ok = true;
+    const auto& args = s.args();
+    size_t argc = args.size();
+    cc::scene::OctreeInfo *arg1 = (cc::scene::OctreeInfo *) NULL ;
+    
+    arg1 = SE_THIS_OBJECT<cc::scene::OctreeInfo>(s);
+    if (nullptr == arg1) return true;
+    
+    ok &= sevalue_to_native(args[0], &arg1->_spatialIndex, s.thisObject());
+    SE_PRECONDITION2(ok, false, "Error processing arguments"); 
+    
+    
+    
+    return true;
+}
+SE_BIND_PROP_SET(js_cc_scene_OctreeInfo__spatialIndex_set) 
+
+static bool js_cc_scene_OctreeInfo__spatialIndex_get(se::State& s)
+{
+    CC_UNUSED bool ok = true;
+    cc::scene::OctreeInfo *arg1 = (cc::scene::OctreeInfo *) NULL ;
+    
+    arg1 = SE_THIS_OBJECT<cc::scene::OctreeInfo>(s);
+    if (nullptr == arg1) return true;
+    
+    ok &= nativevalue_to_se(arg1->_spatialIndex, s.rval(), s.thisObject() /*ctx*/);
+    SE_PRECONDITION2(ok, false, "Error processing arguments");
+    SE_HOLD_RETURN_VALUE(arg1->_spatialIndex, s.thisObject(), s.rval());
+    
+    
+    
+    return true;
+}
+SE_BIND_PROP_GET(js_cc_scene_OctreeInfo__spatialIndex_get) 
+
 static bool js_cc_scene_OctreeInfo_enabled_set(se::State& s)
 {
     CC_UNUSED bool ok = true;
@@ -28022,6 +28147,47 @@ static bool js_cc_scene_OctreeInfo_depth_get(se::State& s)
 }
 SE_BIND_PROP_GET(js_cc_scene_OctreeInfo_depth_get) 
 
+static bool js_cc_scene_OctreeInfo_spatialIndex_set(se::State& s)
+{
+    CC_UNUSED bool ok = true;
+    const auto& args = s.args();
+    size_t argc = args.size();
+    cc::scene::OctreeInfo *arg1 = (cc::scene::OctreeInfo *) NULL ;
+    cc::scene::SpatialIndexType arg2 ;
+    
+    arg1 = SE_THIS_OBJECT<cc::scene::OctreeInfo>(s);
+    if (nullptr == arg1) return true;
+    
+    ok &= sevalue_to_native(args[0], &arg2, s.thisObject());
+    SE_PRECONDITION2(ok, false, "Error processing arguments"); 
+    
+    cc_scene_OctreeInfo_spatialIndex_set(arg1,arg2);
+    
+    
+    return true;
+}
+SE_BIND_PROP_SET(js_cc_scene_OctreeInfo_spatialIndex_set) 
+
+static bool js_cc_scene_OctreeInfo_spatialIndex_get(se::State& s)
+{
+    CC_UNUSED bool ok = true;
+    cc::scene::OctreeInfo *arg1 = (cc::scene::OctreeInfo *) NULL ;
+    cc::scene::SpatialIndexType result;
+    
+    arg1 = SE_THIS_OBJECT<cc::scene::OctreeInfo>(s);
+    if (nullptr == arg1) return true;
+    result = (cc::scene::SpatialIndexType)cc_scene_OctreeInfo_spatialIndex_get(arg1);
+    
+    ok &= nativevalue_to_se(result, s.rval(), s.thisObject() /*ctx*/);
+    SE_PRECONDITION2(ok, false, "Error processing arguments");
+    SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+    
+    
+    
+    return true;
+}
+SE_BIND_PROP_GET(js_cc_scene_OctreeInfo_spatialIndex_get) 
+
 bool js_register_cc_scene_OctreeInfo(se::Object* obj) {
     auto* cls = se::Class::create("OctreeInfo", obj, nullptr, _SE(js_new_cc_scene_OctreeInfo)); 
     
@@ -28030,10 +28196,12 @@ bool js_register_cc_scene_OctreeInfo(se::Object* obj) {
     cls->defineProperty("_minPos", _SE(js_cc_scene_OctreeInfo__minPos_get), _SE(js_cc_scene_OctreeInfo__minPos_set)); 
     cls->defineProperty("_maxPos", _SE(js_cc_scene_OctreeInfo__maxPos_get), _SE(js_cc_scene_OctreeInfo__maxPos_set)); 
     cls->defineProperty("_depth", _SE(js_cc_scene_OctreeInfo__depth_get), _SE(js_cc_scene_OctreeInfo__depth_set)); 
+    cls->defineProperty("_spatialIndex", _SE(js_cc_scene_OctreeInfo__spatialIndex_get), _SE(js_cc_scene_OctreeInfo__spatialIndex_set)); 
     cls->defineProperty("enabled", _SE(js_cc_scene_OctreeInfo_enabled_get), _SE(js_cc_scene_OctreeInfo_enabled_set)); 
     cls->defineProperty("minPos", _SE(js_cc_scene_OctreeInfo_minPos_get), _SE(js_cc_scene_OctreeInfo_minPos_set)); 
     cls->defineProperty("maxPos", _SE(js_cc_scene_OctreeInfo_maxPos_get), _SE(js_cc_scene_OctreeInfo_maxPos_set)); 
     cls->defineProperty("depth", _SE(js_cc_scene_OctreeInfo_depth_get), _SE(js_cc_scene_OctreeInfo_depth_set)); 
+    cls->defineProperty("spatialIndex", _SE(js_cc_scene_OctreeInfo_spatialIndex_get), _SE(js_cc_scene_OctreeInfo_spatialIndex_set)); 
     
     cls->defineFunction("activate", _SE(js_cc_scene_OctreeInfo_activate)); 
     
@@ -28803,6 +28971,55 @@ static bool js_cc_scene_Octree_getMaxDepth(se::State& s)
 }
 SE_BIND_FUNC(js_cc_scene_Octree_getMaxDepth) 
 
+static bool js_cc_scene_Octree_setSpatialIndex(se::State& s)
+{
+    CC_UNUSED bool ok = true;
+    const auto& args = s.args();
+    size_t argc = args.size();
+    cc::scene::Octree *arg1 = (cc::scene::Octree *) NULL ;
+    cc::scene::SpatialIndexType arg2 ;
+    
+    if(argc != 1) {
+        SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+        return false;
+    }
+    arg1 = SE_THIS_OBJECT<cc::scene::Octree>(s);
+    if (nullptr == arg1) return true;
+    
+    ok &= sevalue_to_native(args[0], &arg2, s.thisObject());
+    SE_PRECONDITION2(ok, false, "Error processing arguments"); 
+    (arg1)->setSpatialIndex(arg2);
+    
+    
+    return true;
+}
+SE_BIND_FUNC(js_cc_scene_Octree_setSpatialIndex) 
+
+static bool js_cc_scene_Octree_getSpatialIndex(se::State& s)
+{
+    CC_UNUSED bool ok = true;
+    const auto& args = s.args();
+    size_t argc = args.size();
+    cc::scene::Octree *arg1 = (cc::scene::Octree *) NULL ;
+    cc::scene::SpatialIndexType result;
+    
+    if(argc != 0) {
+        SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+        return false;
+    }
+    arg1 = SE_THIS_OBJECT<cc::scene::Octree>(s);
+    if (nullptr == arg1) return true;
+    result = (cc::scene::SpatialIndexType)((cc::scene::Octree const *)arg1)->getSpatialIndex();
+    
+    ok &= nativevalue_to_se(result, s.rval(), s.thisObject() /*ctx*/);
+    SE_PRECONDITION2(ok, false, "Error processing arguments");
+    SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+    
+    
+    return true;
+}
+SE_BIND_FUNC(js_cc_scene_Octree_getSpatialIndex) 
+
 static bool js_cc_scene_Octree_queryVisibility(se::State& s)
 {
     CC_UNUSED bool ok = true;
@@ -28863,6 +29080,8 @@ bool js_register_cc_scene_Octree(se::Object* obj) {
     cls->defineFunction("update", _SE(js_cc_scene_Octree_update)); 
     cls->defineFunction("setMaxDepth", _SE(js_cc_scene_Octree_setMaxDepth)); 
     cls->defineFunction("getMaxDepth", _SE(js_cc_scene_Octree_getMaxDepth)); 
+    cls->defineFunction("setSpatialIndex", _SE(js_cc_scene_Octree_setSpatialIndex)); 
+    cls->defineFunction("getSpatialIndex", _SE(js_cc_scene_Octree_getSpatialIndex)); 
     cls->defineFunction("queryVisibility", _SE(js_cc_scene_Octree_queryVisibility)); 
     
     
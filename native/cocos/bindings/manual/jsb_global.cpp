@@ -27,7 +27,7 @@
 #include "base/Data.h"
 #include "base/DeferredReleasePool.h"
 #include "base/Scheduler.h"
-#include "base/ThreadPool.h"
+#include "base/threading/ThreadPool.h"
 #include "base/ZipUtils.h"
 #include "base/base64.h"
 #include "bindings/auto/jsb_cocos_auto.h"
@@ -37,8 +37,11 @@
 #include "network/Downloader.h"
 #include "network/HttpClient.h"
 #include "platform/Image.h"
+#include "platform/ImageDecoder.h"
+#include "platform/TextureTranscoder.h"
 #include "platform/interfaces/modules/ISystem.h"
 #include "platform/interfaces/modules/ISystemWindow.h"
+#include "profiler/Profiler.h"
 #include "ui/edit-box/EditBox.h"
 #include "xxtea/xxtea.h"
 
@@ -51,7 +54,6 @@
 
 using namespace cc; // NOLINT
 
-static LegacyThreadPool *gThreadPool = nullptr;
 
 static std::shared_ptr<cc::network::Downloader> gLocalDownloader = nullptr;
 static ccstd::unordered_map<ccstd::string, std::function<void(const ccstd::string &, unsigned char *, uint)>> gLocalDownloaderHandlers;
@@ -463,99 +465,7 @@ static bool js_performance_now(se::State &s) { // NOLINT
 }
 SE_BIND_FUNC(js_performance_now)
 
-namespace {
-struct ImageInfo {
-    uint32_t length = 0;
-    uint32_t width = 0;
-    uint32_t height = 0;
-    uint8_t *data = nullptr;
-    cc::gfx::Format format = cc::gfx::Format::UNKNOWN;
-    bool hasAlpha = false;
-    bool compressed = false;
-    ccstd::vector<uint32_t> mipmapLevelDataSize;
-};
-
-uint8_t *convertRGB2RGBA(uint32_t length, uint8_t *src) {
-    auto *dst = reinterpret_cast<uint8_t *>(malloc(length));
-    for (uint32_t i = 0; i < length; i += 4) {
-        dst[i] = *src++;
-        dst[i + 1] = *src++;
-        dst[i + 2] = *src++;
-        dst[i + 3] = 255;
-    }
-    return dst;
-}
-
-uint8_t *convertIA2RGBA(uint32_t length, uint8_t *src) {
-    auto *dst = reinterpret_cast<uint8_t *>(malloc(length));
-    for (uint32_t i = 0; i < length; i += 4) {
-        dst[i] = *src;
-        dst[i + 1] = *src;
-        dst[i + 2] = *src++;
-        dst[i + 3] = *src++;
-    }
-    return dst;
-}
-
-uint8_t *convertI2RGBA(uint32_t length, uint8_t *src) {
-    auto *dst = reinterpret_cast<uint8_t *>(malloc(length));
-    for (uint32_t i = 0; i < length; i += 4) {
-        dst[i] = *src;
-        dst[i + 1] = *src;
-        dst[i + 2] = *src++;
-        dst[i + 3] = 255;
-    }
-    return dst;
-}
-
-struct ImageInfo *createImageInfo(Image *img) {
-    auto *imgInfo = ccnew struct ImageInfo();
-    imgInfo->length = static_cast<uint32_t>(img->getDataLen());
-    imgInfo->width = img->getWidth();
-    imgInfo->height = img->getHeight();
-    img->takeData(&imgInfo->data);
-    imgInfo->format = img->getRenderFormat();
-    imgInfo->compressed = img->isCompressed();
-    imgInfo->mipmapLevelDataSize = img->getMipmapLevelDataSize();
-
-    // Convert to RGBA888 because standard web api will return only RGBA888.
-    // If not, then it may have issue in glTexSubImage. For example, engine
-    // will create a big texture, and update its content with small pictures.
-    // The big texture is RGBA888, then the small picture should be the same
-    // format, or it will cause 0x502 error on OpenGL ES 2.
-    if (!imgInfo->compressed && imgInfo->format != cc::gfx::Format::RGBA8) {
-        imgInfo->length = img->getWidth() * img->getHeight() * 4;
-        uint8_t *dst = nullptr;
-        uint32_t length = imgInfo->length;
-        uint8_t *src = imgInfo->data;
-        switch (imgInfo->format) {
-            case cc::gfx::Format::A8:
-            case cc::gfx::Format::LA8:
-                dst = convertIA2RGBA(length, src);
-                break;
-            case cc::gfx::Format::L8:
-            case cc::gfx::Format::R8:
-            case cc::gfx::Format::R8I:
-                dst = convertI2RGBA(length, src);
-                break;
-            case cc::gfx::Format::RGB8:
-                dst = convertRGB2RGBA(length, src);
-                break;
-            default:
-                SE_LOGE("unknown image format");
-                break;
-        }
-
-        if (dst != imgInfo->data) free(imgInfo->data);
-        imgInfo->data = dst;
-        imgInfo->hasAlpha = true;
-    }
-
-    return imgInfo;
-}
-} // namespace
-
-bool jsb_global_load_image(const ccstd::string &path, const se::Value &callbackVal) { // NOLINT(readability-identifier-naming)
+bool jsb_global_load_image(const ccstd::string &path, const se::Value &callbackVal, const ImageDecoder::Options &options) { // NOLINT(readability-identifier-naming)
     if (path.empty()) {
         se::ValueArray seArgs;
         callbackVal.toObject()->call(seArgs, nullptr);
@@ -564,63 +474,55 @@ bool jsb_global_load_image(const ccstd::string &path, const se::Value &callbackV
 
     std::shared_ptr<se::Value> callbackPtr = std::make_shared<se::Value>(callbackVal);
 
-    auto initImageFunc = [path, callbackPtr](const ccstd::string &fullPath, unsigned char *imageData, int imageBytes) {
-        auto *img = ccnew Image();
-
-        gThreadPool->pushTask([=](int /*tid*/) {
-            // NOTE: FileUtils::getInstance()->fullPathForFilename isn't a threadsafe method,
-            // Image::initWithImageFile will call fullPathForFilename internally which may
-            // cause thread race issues. Therefore, we get the full path of file before
-            // going into task callback.
-            // Be careful of invoking any Cocos2d-x interface in a sub-thread.
-            bool loadSucceed = false;
-            if (fullPath.empty()) {
-                loadSucceed = img->initWithImageData(imageData, imageBytes);
-                free(imageData);
+    auto onDecoded = [path, callbackPtr](ImageDecoder::Result &result) {
+        auto app = CC_CURRENT_APPLICATION();
+        if (!app) {
+            free(result.data);
+            return;
+        }
+        auto engine = app->getEngine();
+        CC_ASSERT_NOT_NULL(engine);
+        engine->getScheduler()->performFunctionInCocosThread([path, callbackPtr, result = std::move(result)]() {
+            const auto begin = std::chrono::steady_clock::now();
+            se::AutoHandleScope hs;
+            se::ValueArray seArgs;
+
+            if (result.succeed) {
+                // Standard web api returns RGBA8 only, the decoder already wrote the pixels in that layout
+                // so the buffer is handed over to the data holder as is.
+                se::HandleObject retObj(se::Object::createPlainObject());
+                auto *obj = se::Object::createObjectWithClass(__jsb_cc_JSBNativeDataHolder_class);
+                auto *nativeObj = JSB_MAKE_PRIVATE_OBJECT(cc::JSBNativeDataHolder, result.data);
+                obj->setPrivateObject(nativeObj);
+                retObj->setProperty("data", se::Value(obj));
+                retObj->setProperty("width", se::Value(result.width));
+                retObj->setProperty("height", se::Value(result.height));
+                retObj->setProperty("premultiplyAlpha", se::Value(result.premultiplied));
+                // differs from the file's format when a compressed texture was transcoded for this device
+                retObj->setProperty("format", se::Value(static_cast<uint32_t>(result.format)));
+
+                se::Value mipmapLevelDataSizeArr;
+                nativevalue_to_se(result.mipmapLevelDataSize, mipmapLevelDataSizeArr, nullptr);
+                retObj->setProperty("mipmapLevelDataSize", mipmapLevelDataSizeArr);
+
+                seArgs.push_back(se::Value(retObj));
             } else {
-                loadSucceed = img->initWithImageFile(fullPath);
+                SE_REPORT_ERROR("initWithImageFile: %s failed!", path.c_str());
             }
-
-            ImageInfo *imgInfo = nullptr;
-            if (loadSucceed) {
-                imgInfo = createImageInfo(img);
-            }
-            auto app = CC_CURRENT_APPLICATION();
-            if (!app) {
-                delete imgInfo;
-                delete img;
-                return;
-            }
-            auto engine = app->getEngine();
-            CC_ASSERT_NOT_NULL(engine);
-            engine->getScheduler()->performFunctionInCocosThread([=]() {
-                se::AutoHandleScope hs;
-                se::ValueArray seArgs;
-
-                if (loadSucceed) {
-                    se::HandleObject retObj(se::Object::createPlainObject());
-                    auto *obj = se::Object::createObjectWithClass(__jsb_cc_JSBNativeDataHolder_class);
-                    auto *nativeObj = JSB_MAKE_PRIVATE_OBJECT(cc::JSBNativeDataHolder, imgInfo->data);
-                    obj->setPrivateObject(nativeObj);
-                    retObj->setProperty("data", se::Value(obj));
-                    retObj->setProperty("width", se::Value(imgInfo->width));
-                    retObj->setProperty("height", se::Value(imgInfo->height));
-
-                    se::Value mipmapLevelDataSizeArr;
-                    nativevalue_to_se(imgInfo->mipmapLevelDataSize, mipmapLevelDataSizeArr, nullptr);
-                    retObj->setProperty("mipmapLevelDataSize", mipmapLevelDataSizeArr);
-
-                    seArgs.push_back(se::Value(retObj));
-
-                    delete imgInfo;
-                } else {
-                    SE_REPORT_ERROR("initWithImageFile: %s failed!", path.c_str());
-                }
-                callbackPtr->toObject()->call(seArgs, nullptr);
-                delete img;
-            });
+            ImageDecoder::getInstance()->addMainThreadTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count());
+            callbackPtr->toObject()->call(seArgs, nullptr);
         });
     };
+
+    // NOTE: FileUtils::getInstance()->fullPathForFilename isn't a threadsafe method,
+    // so the full path is resolved here before the request goes to the decoder.
+    auto initImageFunc = [options, onDecoded](const ccstd::string &fullPath, unsigned char *imageData, int imageBytes) {
+        if (fullPath.empty()) {
+            ImageDecoder::getInstance()->decodeData(imageData, static_cast<uint32_t>(imageBytes), options, onDecoded);
+        } else {
+            ImageDecoder::getInstance()->decodeFile(fullPath, options, onDecoded);
+        }
+    };
     size_t pos = ccstd::string::npos;
     if (path.find("http://") == 0 || path.find("https://") == 0) {
         localDownloaderCreateTask(path, initImageFunc);
@@ -656,7 +558,7 @@ static bool js_loadImage(se::State &s) { // NOLINT
     const auto &args = s.args();
     size_t argc = args.size();
     CC_UNUSED bool ok = true;
-    if (argc == 2) {
+    if (argc == 2 || argc == 3) {
         ccstd::string path;
         ok &= sevalue_to_native(args[0], &path);
         SE_PRECONDITION2(ok, false, "Error processing arguments");
@@ -665,9 +567,24 @@ static bool js_loadImage(se::State &s) { // NOLINT
         CC_ASSERT(callbackVal.isObject());
         CC_ASSERT(callbackVal.toObject()->isFunction());
 
-        return jsb_global_load_image(path, callbackVal);
+        // optional { priority, premultiplyAlpha, generateMipmaps }
+        ImageDecoder::Options options;
+        if (argc == 3 && args[2].isObject()) {
+            se::Object *optionsObj = args[2].toObject();
+            se::Value tmp;
+            if (optionsObj->getProperty("priority", &tmp) && tmp.isNumber()) {
+                options.priority = static_cast<TaskPriority>(std::min(tmp.toUint32(), static_cast<uint32_t>(TaskPriority::LOW)));
+            }
+            if (optionsObj->getProperty("premultiplyAlpha", &tmp) && tmp.isBoolean()) {
+                options.premultiplyAlpha = tmp.toBoolean();
+            }
+            if (optionsObj->getProperty("generateMipmaps", &tmp) && tmp.isBoolean()) {
+                options.generateMipmaps = tmp.toBoolean();
+            }
+        }
+        return jsb_global_load_image(path, callbackVal, options);
     }
-    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d or %d", (int)argc, 2, 3);
     return false;
 }
 SE_BIND_FUNC(js_loadImage)
@@ -702,7 +619,7 @@ static bool js_saveImageData(se::State &s) { // NOLINT
             callbackObj->incRef();
         }
 
-        gThreadPool->pushTask([=](int /*tid*/) {
+        auto saveTask = [=]() {
             // isToRGB = false, to keep alpha channel
             auto *img = ccnew Image();
             // A conversion from size_t to uint32_t might lose integer precision
@@ -725,7 +642,8 @@ static bool js_saveImageData(se::State &s) { // NOLINT
                 uint8ArrayObj->decRef();
                 delete img;
             });
-        });
+        };
+        ThreadPool::getInstance()->dispatch(std::move(saveTask), TaskPriority::LOW);
         return true;
     }
     SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d or %d", (int)argc, 4, 5);
@@ -804,6 +722,51 @@ static bool JSB_setPreferredFramesPerSecond(se::State &s) { // NOLINT
 }
 SE_BIND_FUNC(JSB_setPreferredFramesPerSecond)
 
+// dir: where textures transcoded for this device are kept, an empty string disables the cache
+static bool JSB_setTextureTranscodeCacheDirectory(se::State &s) { // NOLINT
+    const auto &args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        ccstd::string dir;
+        ok = sevalue_to_native(args[0], &dir);
+        SE_PRECONDITION2(ok, false, "dir is invalid!");
+        TextureTranscoder::setCacheDirectory(dir);
+        return true;
+    }
+
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_setTextureTranscodeCacheDirectory)
+
+static bool JSB_profiler_startTrace(se::State &s) { // NOLINT
+    const auto &args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1 || argc == 2) {
+        ccstd::string path;
+        ok &= sevalue_to_native(args[0], &path);
+        uint32_t frameCount = 0;
+        if (argc == 2) {
+            ok &= sevalue_to_native(args[1], &frameCount);
+        }
+        SE_PRECONDITION2(ok, false, "Error processing arguments");
+        CC_PROFILER_START_TRACE(path, frameCount);
+        return true;
+    }
+
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d or %d", (int)argc, 1, 2);
+    return false;
+}
+SE_BIND_FUNC(JSB_profiler_startTrace)
+
+static bool JSB_profiler_stopTrace(se::State &s) { // NOLINT
+    CC_PROFILER_STOP_TRACE;
+    return true;
+}
+SE_BIND_FUNC(JSB_profiler_stopTrace)
+
 #if CC_USE_EDITBOX
 static bool JSB_showInputBox(se::State &s) { // NOLINT
     const auto &args = s.args();
@@ -1382,7 +1345,6 @@ static bool JSB_process_get_argv(se::State &s) // NOLINT(readability-identifier-
 SE_BIND_PROP_GET(JSB_process_get_argv)
 
 bool jsb_register_global_variables(se::Object *global) { // NOLINT
-    gThreadPool = LegacyThreadPool::newFixedThreadPool(3);
 
 #if CC_EDITOR
     global->defineFunction("__require", _SE(require));
@@ -1401,6 +1363,7 @@ bool jsb_register_global_variables(se::Object *global) { // NOLINT
     __jsbObj->defineFunction("openURL", _SE(JSB_openURL));
     __jsbObj->defineFunction("copyTextToClipboard", _SE(JSB_copyTextToClipboard));
     __jsbObj->defineFunction("setPreferredFramesPerSecond", _SE(JSB_setPreferredFramesPerSecond));
+    __jsbObj->defineFunction("setTextureTranscodeCacheDirectory", _SE(JSB_setTextureTranscodeCacheDirectory));
     __jsbObj->defineFunction("destroyImage", _SE(js_destroyImage));
 #if CC_USE_EDITBOX
     __jsbObj->defineFunction("showInputBox", _SE(JSB_showInputBox));
@@ -1429,6 +1392,11 @@ bool jsb_register_global_variables(se::Object *global) { // NOLINT
 
     __jsbObj->setProperty("zipUtils", se::Value(zipUtils));
 
+    se::HandleObject profiler(se::Object::createPlainObject());
+    profiler->defineFunction("startTrace", _SE(JSB_profiler_startTrace));
+    profiler->defineFunction("stopTrace", _SE(JSB_profiler_stopTrace));
+    __jsbObj->setProperty("profiler", se::Value(profiler));
+
     global->defineFunction("__getPlatform", _SE(JSBCore_platform));
     global->defineFunction("__getOS", _SE(JSBCore_os));
     global->defineFunction("__getOSVersion", _SE(JSB_getOSVersion));
@@ -1449,8 +1417,7 @@ bool jsb_register_global_variables(se::Object *global) { // NOLINT
     se::ScriptEngine::getInstance()->clearException();
 
     se::ScriptEngine::getInstance()->addBeforeCleanupHook([]() {
-        delete gThreadPool;
-        gThreadPool = nullptr;
+        ImageDecoder::destroyInstance();
 
         DeferredReleasePool::clear();
     });
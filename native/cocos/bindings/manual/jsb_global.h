@@ -26,6 +26,7 @@
 
 #include "bindings/jswrapper/PrivateObject.h"
 #include "jsb_global_init.h"
+#include "platform/ImageDecoder.h"
 
 template <typename T, class... Args>
 T *jsb_override_new(Args &&...args) { // NOLINT(readability-identifier-naming)
@@ -75,4 +76,4 @@ bool jsb_set_extend_property(const char *ns, const char *clsName);
 bool jsb_run_script(const ccstd::string &filePath, se::Value *rval = nullptr);        // NOLINT(readability-identifier-naming)
 bool jsb_run_script_module(const ccstd::string &filePath, se::Value *rval = nullptr); // NOLINT(readability-identifier-naming)
 
-bool jsb_global_load_image(const ccstd::string &path, const se::Value &callbackVal); // NOLINT(readability-identifier-naming)
+bool jsb_global_load_image(const ccstd::string &path, const se::Value &callbackVal, const cc::ImageDecoder::Options &options = {}); // NOLINT(readability-identifier-naming)
@@ -148,8 +148,12 @@ void jsb_init_file_operation_delegate() { //NOLINT
                 return;
             }
 
-            fileData = FileUtils::getInstance()->getDataFromFile(path);
-            readCallback(fileData.getBytes(), fileData.getSize());
+            const IntrusivePtr<FileView> view = FileUtils::getInstance()->getFileView(path);
+            if (view) {
+                readCallback(view->getBytes(), view->getSize());
+            } else {
+                readCallback(nullptr, 0);
+            }
         };
 
         delegate.onGetStringFromFile = [](const ccstd::string &path) -> ccstd::string {
@@ -23,6 +23,7 @@
 ****************************************************************************/
 
 #include "jsb_spine_manual.h"
+#include <algorithm>
 #include "base/Data.h"
 #include "base/memory/Memory.h"
 #include "bindings/auto/jsb_spine_auto.h"
@@ -34,6 +35,8 @@
 #include "editor-support/spine/spine.h"
 #include "middleware-adapter.h"
 #include "platform/FileUtils.h"
+#include "spine-creator-support/SkeletonBinaryConverter.h"
+#include "spine-creator-support/SkeletonDataArena.h"
 #include "spine-creator-support/SkeletonDataMgr.h"
 #include "spine-creator-support/SkeletonRenderer.h"
 #include "spine-creator-support/spine-cocos2dx.h"
@@ -48,6 +51,63 @@ static middleware::Texture2D *_getPreloadedAtlasTexture(const char *path) {
     return it != _preloadedAtlasTextures->end() ? it->second : nullptr;
 }
 
+// Binary skeleton data is loaded into an arena that lives as long as the data.
+static spine::SkeletonData *readSkeletonBinary(spine::AttachmentLoader *attachmentLoader, float scale, const unsigned char *bytes, int length, spine::SkeletonDataArena **arena) {
+    auto *dataArena = ccnew spine::SkeletonDataArena();
+    spine::SkeletonData *skeletonData = nullptr;
+    {
+        spine::SkeletonDataArena::Scope scope(dataArena);
+        spine::SkeletonBinary binary(attachmentLoader);
+        binary.setScale(scale);
+        skeletonData = binary.readSkeletonData(bytes, length);
+    }
+    if (!skeletonData) {
+        delete dataArena;
+        dataArena = nullptr;
+    }
+    *arena = dataArena;
+    return skeletonData;
+}
+
+// Json skeleton data goes through the precompiled cache when one is set, the
+// first load stores a binary copy and later loads skip json parsing.
+static spine::SkeletonData *readPrecompiledSkeletonData(const ccstd::string &uuid, const ccstd::string &json, spine::AttachmentLoader *attachmentLoader, float scale, spine::SkeletonDataArena **arena) {
+    const auto &cachePath = spine::SkeletonDataMgr::getInstance()->getPrecompiledCachePath();
+    if (cachePath.empty()) return nullptr;
+
+    // Keyed on content as well, an edited asset keeps its uuid.
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : json) {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), "-%016llx.skel", static_cast<unsigned long long>(hash));
+    ccstd::string fileName = uuid + suffix;
+    std::replace(fileName.begin(), fileName.end(), '/', '_');
+    ccstd::string fullPath = cachePath;
+    if (fullPath.back() != '/') fullPath += '/';
+    fullPath += fileName;
+
+    auto *fileUtils = cc::FileUtils::getInstance();
+    cc::Data cached;
+    if (fileUtils->isFileExist(fullPath) && fileUtils->getContents(fullPath, &cached) == cc::FileUtils::Status::OK) {
+        auto *skeletonData = readSkeletonBinary(attachmentLoader, scale, cached.getBytes(), static_cast<int>(cached.getSize()), arena);
+        if (skeletonData) return skeletonData;
+    }
+
+    spine::SkeletonBinaryConverter converter;
+    ccstd::vector<uint8_t> binary;
+    if (!converter.convert(json.c_str(), binary)) {
+        CC_LOG_WARNING("Can not precompile skeleton data %s: %s", uuid.c_str(), converter.getError().c_str());
+        return nullptr;
+    }
+    cc::Data data;
+    data.copy(binary.data(), static_cast<uint32_t>(binary.size()));
+    if (!fileUtils->isDirectoryExist(cachePath)) fileUtils->createDirectory(cachePath);
+    fileUtils->writeDataToFile(data, fullPath);
+    return readSkeletonBinary(attachmentLoader, scale, binary.data(), static_cast<int>(binary.size()), arena);
+}
+
 static bool js_register_spine_initSkeletonData(se::State &s) {
     const auto &args = s.args();
     int argc = (int)args.size();
@@ -97,6 +157,7 @@ static bool js_register_spine_initSkeletonData(se::State &s) {
 
     spine::AttachmentLoader *attachmentLoader = ccnew_placement(__FILE__, __LINE__) spine::Cocos2dAtlasAttachmentLoader(atlas);
     spine::SkeletonData *skeletonData = nullptr;
+    spine::SkeletonDataArena *arena = nullptr;
 
     std::size_t length = skeletonDataFile.length();
     auto binPos = skeletonDataFile.find(".skel", length - 5);
@@ -109,16 +170,17 @@ static bool js_register_spine_initSkeletonData(se::State &s) {
             const auto fullpath = fileUtils->fullPathForFilename(skeletonDataFile);
             fileUtils->getContents(fullpath, &cocos2dData);
 
-            spine::SkeletonBinary binary(attachmentLoader);
-            binary.setScale(scale);
-            skeletonData = binary.readSkeletonData(cocos2dData.getBytes(), (int)cocos2dData.getSize());
+            skeletonData = readSkeletonBinary(attachmentLoader, scale, cocos2dData.getBytes(), (int)cocos2dData.getSize(), &arena);
             CC_ASSERT(skeletonData); // Can use binary.getError() to get error message.
         }
     } else {
-        spine::SkeletonJson json(attachmentLoader);
-        json.setScale(scale);
-        skeletonData = json.readSkeletonData(skeletonDataFile.c_str());
-        CC_ASSERT(skeletonData); // Can use json.getError() to get error message.
+        skeletonData = readPrecompiledSkeletonData(uuid, skeletonDataFile, attachmentLoader, scale, &arena);
+        if (!skeletonData) {
+            spine::SkeletonJson json(attachmentLoader);
+            json.setScale(scale);
+            skeletonData = json.readSkeletonData(skeletonDataFile.c_str());
+            CC_ASSERT(skeletonData); // Can use json.getError() to get error message.
+        }
     }
 
     if (skeletonData) {
@@ -126,7 +188,7 @@ static bool js_register_spine_initSkeletonData(se::State &s) {
         for (auto it = textures.begin(); it != textures.end(); it++) {
             texturesIndex.push_back(it->second->getRealTextureIndex());
         }
-        mgr->setSkeletonData(uuid, skeletonData, atlas, attachmentLoader, texturesIndex);
+        mgr->setSkeletonData(uuid, skeletonData, atlas, attachmentLoader, texturesIndex, arena);
         native_ptr_to_seval<spine::SkeletonData>(skeletonData, &s.rval());
     } else {
         if (atlas) {
@@ -213,6 +275,31 @@ static bool js_register_spine_retainSkeletonData(se::State &s) {
 }
 SE_BIND_FUNC(js_register_spine_retainSkeletonData)
 
+static bool js_register_spine_setPrecompiledCachePath(se::State &s) {
+    const auto &args = s.args();
+    int argc = (int)args.size();
+    if (argc != 1) {
+        SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", argc, 1);
+        return false;
+    }
+    bool ok = false;
+
+    ccstd::string path;
+    ok = sevalue_to_native(args[0], &path);
+    SE_PRECONDITION2(ok, false, "Invalid cache path!");
+
+    spine::SkeletonDataMgr::getInstance()->setPrecompiledCachePath(path);
+    return true;
+}
+SE_BIND_FUNC(js_register_spine_setPrecompiledCachePath)
+
+static bool js_register_spine_getPrecompiledCachePath(se::State &s) {
+    const auto &path = spine::SkeletonDataMgr::getInstance()->getPrecompiledCachePath();
+    nativevalue_to_se(path, s.rval());
+    return true;
+}
+SE_BIND_FUNC(js_register_spine_getPrecompiledCachePath)
+
 bool register_all_spine_manual(se::Object *obj) {
     // Get the ns
     se::Value nsVal;
@@ -227,6 +314,8 @@ bool register_all_spine_manual(se::Object *obj) {
     ns->defineFunction("initSkeletonData", _SE(js_register_spine_initSkeletonData));
     ns->defineFunction("retainSkeletonData", _SE(js_register_spine_retainSkeletonData));
     ns->defineFunction("disposeSkeletonData", _SE(js_register_spine_disposeSkeletonData));
+    ns->defineFunction("setPrecompiledCachePath", _SE(js_register_spine_setPrecompiledCachePath));
+    ns->defineFunction("getPrecompiledCachePath", _SE(js_register_spine_getPrecompiledCachePath));
 
     spine::setSpineObjectDisposeCallback([](void *spineObj) {
         if (!se::NativePtrToObjectMap::isValid()) {
@@ -41,6 +41,7 @@
 #include "renderer/pipeline/Define.h"
 #include "renderer/pipeline/GeometryRenderer.h"
 #include "renderer/pipeline/PipelineSceneData.h"
+#include "renderer/pipeline/PipelineStateManager.h"
 #include "renderer/pipeline/custom/NativePipelineTypes.h"
 #include "renderer/pipeline/custom/RenderInterfaceTypes.h"
 #include "renderer/pipeline/deferred/DeferredPipeline.h"
@@ -95,6 +96,9 @@ void Root::initialize(gfx::Swapchain * /*swapchain*/) {
     pipeline::localDescriptorSetLayoutResizeMaxJoints(maxJoints);
 
     _debugView = std::make_unique<pipeline::DebugView>();
+
+    // read the pipeline states of earlier launches while the scene loads
+    pipeline::PipelineStateManager::loadCacheAsync();
 }
 
 render::Pipeline *Root::getCustomPipeline() const {
@@ -432,6 +436,9 @@ void Root::frameMoveEnd() {
         CC_DEBUG_RENDERER->update();
     #endif
 
+        // a few pipeline states of earlier launches per frame, before the frame that may need them
+        pipeline::PipelineStateManager::update();
+
         emit<BeforeRender>();
         _pipelineRuntime->render(_cameraList);
         emit<AfterRender>();
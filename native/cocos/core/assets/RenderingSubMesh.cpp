@@ -146,6 +146,25 @@ const IGeometricInfo &RenderingSubMesh::getGeometricInfo() {
     return EMPTY_GEOMETRIC_INFO;
 }
 
+const geometry::TriangleBVH &RenderingSubMesh::getTriangleBVH() {
+    if (_triangleBVH.has_value()) {
+        return _triangleBVH.value();
+    }
+
+    const auto &info = getGeometricInfo();
+    if (!_geometricInfo.has_value()) {
+        // NOLINTNEXTLINE
+        static const geometry::TriangleBVH EMPTY_TRIANGLE_BVH;
+        return EMPTY_TRIANGLE_BVH;
+    }
+
+    _triangleBVH.emplace();
+    if (info.indices.has_value()) {
+        _triangleBVH->build(info.positions, info.indices.value(), _primitiveMode);
+    }
+    return _triangleBVH.value();
+}
+
 void RenderingSubMesh::genFlatBuffers() {
     if (!_flatBuffers.empty() || _mesh == nullptr || !_subMeshIdx.has_value()) {
         return;
@@ -30,6 +30,7 @@
 #include "base/std/variant.h"
 #include "core/TypedArray.h"
 #include "core/Types.h"
+#include "core/geometry/TriangleBVH.h"
 #include "renderer/gfx-base/GFXDef.h"
 
 namespace cc {
@@ -143,7 +144,16 @@ public:
      * @en Invalidate the geometric info of the sub mesh after geometry changed.
      * @zh 网格更新后，设置（用于射线检测的）几何信息为无效，需要重新计算。
      */
-    inline void invalidateGeometricInfo() { _geometricInfo.reset(); }
+    inline void invalidateGeometricInfo() {
+        _geometricInfo.reset();
+        _triangleBVH.reset();
+    }
+
+    /**
+     * @en The triangle BVH of the geometric info, built on first use and dropped with the geometric info.
+     * @zh （用于射线检测的）三角形包围体层次结构，首次使用时构建，随几何信息一起失效。
+     */
+    const geometry::TriangleBVH &getTriangleBVH();
 
     /**
      * @en Primitive mode used by the sub mesh
@@ -209,6 +219,8 @@ private:
 
     ccstd::optional<IGeometricInfo> _geometricInfo;
 
+    ccstd::optional<geometry::TriangleBVH> _triangleBVH;
+
     // As gfx::InputAssemblerInfo needs the data structure, so not use IntrusivePtr.
     RefVector<gfx::Buffer *> _vertexBuffers;
 
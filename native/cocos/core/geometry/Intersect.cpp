@@ -24,8 +24,10 @@
 
 #include "core/geometry/Intersect.h"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
+#include <numeric>
 #include "3d/assets/Mesh.h"
 #include "base/TemplateUtils.h"
 #include "base/std/container/array.h"
@@ -39,6 +41,7 @@
 #include "core/geometry/Spec.h"
 #include "core/geometry/Sphere.h"
 #include "core/geometry/Triangle.h"
+#include "core/geometry/TriangleBVH.h"
 #include "math/Mat3.h"
 #include "math/Math.h"
 #include "math/Vec3.h"
@@ -236,93 +239,77 @@ float rayCapsule(const Ray &ray, const Capsule &capsule) {
 }
 
 namespace {
-void fillResult(float *minDis, ERaycastMode m, float d, float i0, float i1, float i2, ccstd::optional<ccstd::vector<IRaySubMeshResult>> &r) {
+void fillResult(float *minDis, ERaycastMode m, float d, const ccstd::array<uint32_t, 3> &vertexIndices, ccstd::optional<ccstd::vector<IRaySubMeshResult>> &r) {
     if (m == ERaycastMode::CLOSEST) {
         if (*minDis > d || *minDis == 0.0F) {
             *minDis = d;
             if (r) {
                 if (r->empty()) {
-                    r->emplace_back(IRaySubMeshResult{d, static_cast<uint32_t>(i0 / 3), static_cast<uint32_t>(i1 / 3), static_cast<uint32_t>(i2 / 3)});
+                    r->emplace_back(IRaySubMeshResult{d, vertexIndices[0], vertexIndices[1], vertexIndices[2]});
                 } else {
                     (*r)[0].distance = d;
-                    (*r)[0].vertexIndex0 = static_cast<uint32_t>(i0 / 3);
-                    (*r)[0].vertexIndex1 = static_cast<uint32_t>(i1 / 3);
-                    (*r)[0].vertexIndex2 = static_cast<uint32_t>(i2 / 3);
+                    (*r)[0].vertexIndex0 = vertexIndices[0];
+                    (*r)[0].vertexIndex1 = vertexIndices[1];
+                    (*r)[0].vertexIndex2 = vertexIndices[2];
                 }
             }
         }
     } else {
         *minDis = d;
-        if (r) r->emplace_back(IRaySubMeshResult{d, static_cast<uint32_t>(i0 / 3), static_cast<uint32_t>(i1 / 3), static_cast<uint32_t>(i2 / 3)});
+        if (r) r->emplace_back(IRaySubMeshResult{d, vertexIndices[0], vertexIndices[1], vertexIndices[2]});
     }
 }
 
-float narrowphase(float *minDis, const Float32Array &vb, const IBArray &ib, gfx::PrimitiveMode pm, const Ray &ray, IRaySubMeshOptions *opt) {
-    Triangle tri;
-    auto ibSize = ccstd::visit(overloaded{
-                                   [](const auto &arr) {
-                                       return arr.length();
-                                   },
-                                   [](const ccstd::monostate & /*unused*/) {
-                                       return static_cast<uint32_t>(0);
-                                   }},
-                               ib);
-
-    return ccstd::visit(overloaded{[&](const auto &ib) {
-                                       if (pm == gfx::PrimitiveMode::TRIANGLE_LIST) {
-                                           auto cnt = ibSize;
-                                           for (auto j = 0; j < cnt; j += 3) {
-                                               auto i0 = ib[j] * 3;
-                                               auto i1 = ib[j + 1] * 3;
-                                               auto i2 = ib[j + 2] * 3;
-                                               tri.a = {vb[i0], vb[i0 + 1], vb[i0 + 2]};
-                                               tri.b = {vb[i1], vb[i1 + 1], vb[i1 + 2]};
-                                               tri.c = {vb[i2], vb[i2 + 1], vb[i2 + 2]};
-                                               auto dist = rayTriangle(ray, tri, opt->doubleSided);
-                                               if (dist == 0.0F || dist > opt->distance) continue;
-                                               fillResult(minDis, opt->mode, dist, static_cast<float>(i0), static_cast<float>(i1), static_cast<float>(i2), opt->result);
-                                               if (opt->mode == ERaycastMode::ANY) return dist;
-                                           }
-                                       } else if (pm == gfx::PrimitiveMode::TRIANGLE_STRIP) {
-                                           auto cnt = ibSize - 2;
-                                           int32_t rev = 0;
-                                           for (auto j = 0; j < cnt; j += 1) {
-                                               auto i0 = ib[j - rev] * 3;
-                                               auto i1 = ib[j + rev + 1] * 3;
-                                               auto i2 = ib[j + 2] * 3;
-                                               tri.a = {vb[i0], vb[i0 + 1], vb[i0 + 2]};
-                                               tri.b = {vb[i1], vb[i1 + 1], vb[i1 + 2]};
-                                               tri.c = {vb[i2], vb[i2 + 1], vb[i2 + 2]};
-                                               rev = ~rev;
-                                               auto dist = rayTriangle(ray, tri, opt->doubleSided);
-                                               if (dist == 0.0F || dist > opt->distance) continue;
-                                               fillResult(minDis, opt->mode, dist, static_cast<float>(i0), static_cast<float>(i1), static_cast<float>(i2), opt->result);
-                                               if (opt->mode == ERaycastMode::ANY) return dist;
-                                           }
-                                       } else if (pm == gfx::PrimitiveMode::TRIANGLE_FAN) {
-                                           auto cnt = ibSize - 1;
-                                           auto i0 = ib[0] * 3;
-                                           tri.a = {vb[i0], vb[i0 + 1], vb[i0 + 2]};
-                                           for (auto j = 1; j < cnt; j += 1) {
-                                               auto i1 = ib[j] * 3;
-                                               auto i2 = ib[j + 1] * 3;
-                                               tri.b = {vb[i1], vb[i1 + 1], vb[i1 + 2]};
-                                               tri.c = {vb[i2], vb[i2 + 1], vb[i2 + 2]};
-                                               auto dist = rayTriangle(ray, tri, opt->doubleSided);
-                                               if (dist == 0.0 || dist > opt->distance) continue;
-                                               fillResult(minDis, opt->mode, dist, static_cast<float>(i0), static_cast<float>(i1), static_cast<float>(i2), opt->result);
-                                               if (opt->mode == ERaycastMode::ANY) return dist;
-                                           }
-                                       }
-                                       return *minDis;
-                                   },
-                                   [](const ccstd::monostate & /*unused*/) { return 0.F; }},
-                        ib);
+// Same results as testing every triangle in primitive order, except that ANY may report another triangle.
+float narrowphase(float *minDis, const TriangleBVH &bvh, const Ray &ray, IRaySubMeshOptions *opt) {
+    TriangleBVH::Hit hit;
+    if (opt->mode == ERaycastMode::ALL) {
+        ccstd::vector<TriangleBVH::Hit> hits;
+        bvh.raycastAll(ray, opt->distance, opt->doubleSided, hits);
+        for (const auto &h : hits) {
+            fillResult(minDis, opt->mode, h.distance, bvh.getVertexIndices(h.triangle), opt->result);
+        }
+    } else if (opt->mode == ERaycastMode::CLOSEST ? bvh.raycastClosest(ray, opt->distance, opt->doubleSided, &hit)
+                                                   : bvh.raycastAny(ray, opt->distance, opt->doubleSided, &hit)) {
+        fillResult(minDis, opt->mode, hit.distance, bvh.getVertexIndices(hit.triangle), opt->result);
+    }
+    return *minDis;
+}
+
+// Traces the rays listed in candidates, distances of the others are left untouched.
+void narrowphaseBatch(const ccstd::vector<Ray> &rays, const ccstd::vector<uint32_t> &candidates, RenderingSubMesh &mesh, const IRaySubMeshOptions &opt, float *distances) {
+    const auto &info = mesh.getGeometricInfo();
+    if (info.positions.empty()) {
+        for (auto index : candidates) distances[index] = 0.0F;
+        return;
+    }
+    const auto &bvh = mesh.getTriangleBVH();
+    const auto &min = info.boundingBox.min;
+    const auto &max = info.boundingBox.max;
+
+    const Ray *packet[TriangleBVH::PACKET_SIZE];
+    uint32_t packetIndices[TriangleBVH::PACKET_SIZE];
+    TriangleBVH::Hit hits[TriangleBVH::PACKET_SIZE];
+    uint32_t packetSize = 0;
+    auto flush = [&]() {
+        bvh.raycastPacket(packet, packetSize, opt.distance, opt.doubleSided, opt.mode == ERaycastMode::ANY, hits);
+        for (uint32_t i = 0; i < packetSize; ++i) {
+            distances[packetIndices[i]] = hits[i].distance;
+        }
+        packetSize = 0;
+    };
+    for (auto index : candidates) {
+        distances[index] = 0.0F;
+        if (rayAABB2(rays[index], min, max) == 0.0F) continue;
+        packet[packetSize] = &rays[index];
+        packetIndices[packetSize] = index;
+        if (++packetSize == TriangleBVH::PACKET_SIZE) flush();
+    }
+    if (packetSize > 0) flush();
 }
 } // namespace
 
 float raySubMesh(const Ray &ray, const RenderingSubMesh &submesh, IRaySubMeshOptions *options) {
-    Triangle tri;
     IRaySubMeshOptions deOpt;
     deOpt.mode = ERaycastMode::ANY;
     deOpt.distance = FLT_MAX;
@@ -334,13 +321,23 @@ float raySubMesh(const Ray &ray, const RenderingSubMesh &submesh, IRaySubMeshOpt
     auto min = mesh.getGeometricInfo().boundingBox.min;
     auto max = mesh.getGeometricInfo().boundingBox.max;
     if (rayAABB2(ray, min, max) != 0.0F) {
-        const auto &pm = mesh.getPrimitiveMode();
-        const auto &info = mesh.getGeometricInfo();
-        narrowphase(&minDis, info.positions, info.indices.value(), pm, ray, opt);
+        narrowphase(&minDis, mesh.getTriangleBVH(), ray, opt);
     }
     return minDis;
 }
 
+void raySubMeshBatch(const ccstd::vector<Ray> &rays, const RenderingSubMesh &submesh, ccstd::vector<float> &distances, const IRaySubMeshOptions *options) {
+    IRaySubMeshOptions deOpt;
+    deOpt.mode = ERaycastMode::ANY;
+    deOpt.distance = FLT_MAX;
+    deOpt.doubleSided = false;
+    const IRaySubMeshOptions *opt = options ? options : &deOpt;
+    distances.assign(rays.size(), 0.0F);
+    ccstd::vector<uint32_t> candidates(rays.size());
+    std::iota(candidates.begin(), candidates.end(), 0);
+    narrowphaseBatch(rays, candidates, const_cast<RenderingSubMesh &>(submesh), *opt, distances.data());
+}
+
 float rayMesh(const Ray &ray, const Mesh &mesh, IRayMeshOptions *option) {
     float minDis = 0.0F;
     IRayMeshOptions deOpt;
@@ -437,6 +434,44 @@ float rayModel(const Ray &ray, const scene::Model &model, IRayModelOptions *opti
     return minDis;
 }
 
+void rayModelBatch(const ccstd::vector<Ray> &rays, const scene::Model &model, ccstd::vector<float> &distances, const IRayModelOptions *options) {
+    IRayModelOptions deOpt;
+    deOpt.distance = std::numeric_limits<float>::max();
+    deOpt.doubleSided = false;
+    deOpt.mode = ERaycastMode::ANY;
+    const IRayModelOptions *opt = options ? options : &deOpt;
+    distances.assign(rays.size(), 0.0F);
+
+    const auto *wb = model.getWorldBounds();
+    ccstd::vector<uint32_t> candidates;
+    candidates.reserve(rays.size());
+    for (uint32_t i = 0; i < rays.size(); ++i) {
+        if (!wb || rayAABB(rays[i], *wb) != 0.0F) candidates.emplace_back(i);
+    }
+    ccstd::vector<Ray> modelRays{rays};
+    if (model.getNode()) {
+        Mat4 m4 = model.getNode()->getWorldMatrix().getInversed();
+        for (auto index : candidates) {
+            Vec3::transformMat4(rays[index].o, m4, &modelRays[index].o);
+            Vec3::transformMat4Normal(rays[index].d, m4, &modelRays[index].d);
+        }
+    }
+
+    ccstd::vector<float> subMeshDistances(rays.size(), 0.0F);
+    for (const auto &subModel : model.getSubModels()) {
+        if (candidates.empty()) break;
+        narrowphaseBatch(modelRays, candidates, *subModel->getSubMesh(), *opt, subMeshDistances.data());
+        for (auto index : candidates) {
+            const float dis = subMeshDistances[index];
+            if (dis != 0.0F && (distances[index] == 0.0F || distances[index] > dis)) distances[index] = dis;
+        }
+        // like rayModel, ANY keeps the hit of the first sub mesh. ALL keeps the closest hit, unlike rayModel
+        if (opt->mode == ERaycastMode::ANY) {
+            candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](uint32_t index) { return distances[index] != 0.0F; }), candidates.end());
+        }
+    }
+}
+
 float linePlane(const Line &line, const Plane &plane) {
     auto ab = line.e - line.s;
     auto t = (plane.d - Vec3::dot(line.s, plane.n)) / Vec3::dot(ab, plane.n);
@@ -160,6 +160,28 @@ float rayMesh(const Ray &ray, const Mesh &mesh, IRayMeshOptions *option);
  */
 float rayModel(const Ray &ray, const scene::Model &model, IRayModelOptions *option);
 
+/**
+ * @en
+ * Batched ray-subMesh intersect detect, in model space. Rays are traced four at a time through the cached triangle BVH
+ * of the sub mesh. distances receives one value per ray, 0 for a miss. ANY stops every ray at its first hit,
+ * CLOSEST and ALL both report the closest hit, result of the options is not filled.
+ * @zh
+ * 在模型空间中，批量检测射线和子三角网格的相交性。每次四条射线一起遍历子网格缓存的三角形 BVH。
+ * distances 按射线顺序保存结果，未命中为 0。ANY 模式取第一个命中，CLOSEST 与 ALL 模式取最近的命中，不填写 result。
+ */
+void raySubMeshBatch(const ccstd::vector<Ray> &rays, const RenderingSubMesh &submesh, ccstd::vector<float> &distances, const IRaySubMeshOptions *options = nullptr);
+
+/**
+ * @en
+ * Batched ray-model intersect detect, in world space. CLOSEST gives the same per ray distances as rayModel, ANY hits
+ * the same rays but may report another triangle. ALL reports the closest hit over all sub meshes while rayModel
+ * returns the last hit it found. See raySubMeshBatch for how the options are used.
+ * @zh
+ * 在世界空间中，批量检测射线和渲染模型的相交性。CLOSEST 模式下每条射线的距离与 rayModel 相同，ANY 模式命中的射线相同，
+ * 但可能报告另一个三角形。ALL 模式取所有子网格中最近的命中，而 rayModel 返回最后找到的命中。选项的用法见 raySubMeshBatch。
+ */
+void rayModelBatch(const ccstd::vector<Ray> &rays, const scene::Model &model, ccstd::vector<float> &distances, const IRayModelOptions *options = nullptr);
+
 /**
  * @en
  * line-plane intersect detect.
@@ -0,0 +1,392 @@
+/****************************************************************************
+ Copyright (c) 2022-2023 Xiamen Yaji Software Co., Ltd.
+
+ https://www.cocos.com/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#include "core/geometry/IntersectBatch.h"
+
+#include <cmath>
+#include "core/geometry/AABB.h"
+#include "core/geometry/Frustum.h"
+#include "core/geometry/Intersect.h"
+#include "core/geometry/Obb.h"
+#include "core/geometry/Sphere.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <xmmintrin.h>
+    #define CC_INTERSECT_BATCH_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define CC_INTERSECT_BATCH_NEON
+#endif
+
+namespace cc {
+namespace geometry {
+
+namespace {
+
+constexpr uint32_t LANES = 4;
+constexpr uint32_t PLANE_COUNT = 6;
+
+// Four lanes of floats. The operations keep the order of the scalar expressions, so the
+// comparisons come out the same as in Intersect.cpp.
+#if defined(CC_INTERSECT_BATCH_SSE)
+using Float4 = __m128;
+
+inline Float4 load4(const float *p) { return _mm_loadu_ps(p); }
+inline Float4 splat4(float v) { return _mm_set1_ps(v); }
+inline Float4 add4(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 sub4(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+inline Float4 mul4(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+inline Float4 abs4(Float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0F), a); }
+inline uint32_t lessMask4(Float4 a, Float4 b) { return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmplt_ps(a, b))); }
+inline uint32_t lessEqualMask4(Float4 a, Float4 b) { return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(a, b))); }
+#elif defined(CC_INTERSECT_BATCH_NEON)
+using Float4 = float32x4_t;
+
+inline uint32_t movemask4(uint32x4_t v) {
+    static const uint32_t BITS[LANES] = {1, 2, 4, 8};
+    const uint32x4_t m = vandq_u32(v, vld1q_u32(BITS));
+    const uint32x2_t s = vorr_u32(vget_low_u32(m), vget_high_u32(m));
+    return vget_lane_u32(s, 0) | vget_lane_u32(s, 1);
+}
+
+inline Float4 load4(const float *p) { return vld1q_f32(p); }
+inline Float4 splat4(float v) { return vdupq_n_f32(v); }
+inline Float4 add4(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+inline Float4 sub4(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+// vmulq + vaddq instead of vmlaq, a fused multiply-add would round differently from the scalar code
+inline Float4 mul4(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+inline Float4 abs4(Float4 a) { return vabsq_f32(a); }
+inline uint32_t lessMask4(Float4 a, Float4 b) { return movemask4(vcltq_f32(a, b)); }
+inline uint32_t lessEqualMask4(Float4 a, Float4 b) { return movemask4(vcleq_f32(a, b)); }
+#else
+struct Float4 {
+    float v[LANES];
+};
+
+inline Float4 load4(const float *p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline Float4 splat4(float v) { return {{v, v, v, v}}; }
+inline Float4 add4(Float4 a, Float4 b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+inline Float4 sub4(Float4 a, Float4 b) { return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}}; }
+inline Float4 mul4(Float4 a, Float4 b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+inline Float4 abs4(Float4 a) { return {{std::abs(a.v[0]), std::abs(a.v[1]), std::abs(a.v[2]), std::abs(a.v[3])}}; }
+inline uint32_t lessMask4(Float4 a, Float4 b) {
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < LANES; ++i) {
+        mask |= static_cast<uint32_t>(a.v[i] < b.v[i]) << i;
+    }
+    return mask;
+}
+inline uint32_t lessEqualMask4(Float4 a, Float4 b) {
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < LANES; ++i) {
+        mask |= static_cast<uint32_t>(a.v[i] <= b.v[i]) << i;
+    }
+    return mask;
+}
+#endif
+
+// n.x * x + n.y * y + n.z * z
+inline Float4 dot4(Float4 nx, Float4 ny, Float4 nz, Float4 x, Float4 y, Float4 z) {
+    return add4(add4(mul4(nx, x), mul4(ny, y)), mul4(nz, z));
+}
+
+struct FrustumPlanes {
+    Float4 nx[PLANE_COUNT];
+    Float4 ny[PLANE_COUNT];
+    Float4 nz[PLANE_COUNT];
+    Float4 absX[PLANE_COUNT];
+    Float4 absY[PLANE_COUNT];
+    Float4 absZ[PLANE_COUNT];
+    Float4 length[PLANE_COUNT];
+    Float4 d[PLANE_COUNT];
+
+    explicit FrustumPlanes(const Frustum &frustum) {
+        for (uint32_t p = 0; p < PLANE_COUNT; ++p) {
+            const auto &plane = *frustum.planes[p];
+            nx[p] = splat4(plane.n.x);
+            ny[p] = splat4(plane.n.y);
+            nz[p] = splat4(plane.n.z);
+            absX[p] = splat4(std::abs(plane.n.x));
+            absY[p] = splat4(std::abs(plane.n.y));
+            absZ[p] = splat4(std::abs(plane.n.z));
+            length[p] = splat4(plane.n.length());
+            d[p] = splat4(plane.d);
+        }
+    }
+};
+
+inline uint32_t getGroupCount(uint32_t count) {
+    return (count + LANES - 1) / LANES;
+}
+
+// the bits of the group starting at first that hold shapes
+inline uint32_t getValidLanes(uint32_t first, uint32_t count) {
+    return count - first >= LANES ? 0xF : (1U << (count - first)) - 1;
+}
+
+inline void resetMask(BatchMask &mask, uint32_t count) {
+    mask.assign((count + 31) / 32, 0);
+}
+
+inline void setGroup(BatchMask &mask, uint32_t first, uint32_t bits) {
+    mask[first >> 5] |= bits << (first & 31);
+}
+
+template <typename T>
+inline void growPadded(T &array, uint32_t count) {
+    if (count % LANES == 0) {
+        array.resize(count + LANES, 0.F);
+    }
+}
+
+} // namespace
+
+void AABBBatch::reserve(uint32_t capacity) {
+    const uint32_t padded = getGroupCount(capacity) * LANES;
+    for (auto *array : {&centerX, &centerY, &centerZ, &halfExtentX, &halfExtentY, &halfExtentZ}) {
+        array->reserve(padded);
+    }
+}
+
+void AABBBatch::clear() {
+    for (auto *array : {&centerX, &centerY, &centerZ, &halfExtentX, &halfExtentY, &halfExtentZ}) {
+        array->clear();
+    }
+    _count = 0;
+}
+
+void AABBBatch::push(const AABB &aabb) {
+    push(aabb.getCenter(), aabb.getHalfExtents());
+}
+
+void AABBBatch::push(const Vec3 &center, const Vec3 &halfExtents) {
+    for (auto *array : {&centerX, &centerY, &centerZ, &halfExtentX, &halfExtentY, &halfExtentZ}) {
+        growPadded(*array, _count);
+    }
+    centerX[_count] = center.x;
+    centerY[_count] = center.y;
+    centerZ[_count] = center.z;
+    halfExtentX[_count] = halfExtents.x;
+    halfExtentY[_count] = halfExtents.y;
+    halfExtentZ[_count] = halfExtents.z;
+    ++_count;
+}
+
+void SphereBatch::reserve(uint32_t capacity) {
+    const uint32_t padded = getGroupCount(capacity) * LANES;
+    for (auto *array : {&centerX, &centerY, &centerZ, &radius}) {
+        array->reserve(padded);
+    }
+}
+
+void SphereBatch::clear() {
+    for (auto *array : {&centerX, &centerY, &centerZ, &radius}) {
+        array->clear();
+    }
+    _count = 0;
+}
+
+void SphereBatch::push(const Sphere &sphere) {
+    push(sphere.getCenter(), sphere.getRadius());
+}
+
+void SphereBatch::push(const Vec3 &center, float r) {
+    for (auto *array : {&centerX, &centerY, &centerZ, &radius}) {
+        growPadded(*array, _count);
+    }
+    centerX[_count] = center.x;
+    centerY[_count] = center.y;
+    centerZ[_count] = center.z;
+    radius[_count] = r;
+    ++_count;
+}
+
+void OBBBatch::reserve(uint32_t capacity) {
+    const uint32_t padded = getGroupCount(capacity) * LANES;
+    for (auto *array : {&centerX, &centerY, &centerZ, &halfExtentX, &halfExtentY, &halfExtentZ}) {
+        array->reserve(padded);
+    }
+    for (auto &array : orientation) {
+        array.reserve(padded);
+    }
+}
+
+void OBBBatch::clear() {
+    for (auto *array : {&centerX, &centerY, &centerZ, &halfExtentX, &halfExtentY, &halfExtentZ}) {
+        array->clear();
+    }
+    for (auto &array : orientation) {
+        array.clear();
+    }
+    _count = 0;
+}
+
+void OBBBatch::push(const OBB &obb) {
+    for (auto *array : {&centerX, &centerY, &centerZ, &halfExtentX, &halfExtentY, &halfExtentZ}) {
+        growPadded(*array, _count);
+    }
+    for (auto &array : orientation) {
+        growPadded(array, _count);
+    }
+    centerX[_count] = obb.center.x;
+    centerY[_count] = obb.center.y;
+    centerZ[_count] = obb.center.z;
+    halfExtentX[_count] = obb.halfExtents.x;
+    halfExtentY[_count] = obb.halfExtents.y;
+    halfExtentZ[_count] = obb.halfExtents.z;
+    for (uint32_t i = 0; i < 9; ++i) {
+        orientation[i][_count] = obb.orientation.m[i];
+    }
+    ++_count;
+}
+
+void aabbFrustumBatch(const AABBBatch &aabbs, const Frustum &frustum, BatchMask &intersects, BatchMask *inside) {
+    const uint32_t count = aabbs.size();
+    resetMask(intersects, count);
+    if (inside) {
+        resetMask(*inside, count);
+    }
+    const FrustumPlanes planes(frustum);
+    for (uint32_t i = 0; i < count; i += LANES) {
+        const Float4 cx = load4(aabbs.centerX.data() + i);
+        const Float4 cy = load4(aabbs.centerY.data() + i);
+        const Float4 cz = load4(aabbs.centerZ.data() + i);
+        const Float4 hx = load4(aabbs.halfExtentX.data() + i);
+        const Float4 hy = load4(aabbs.halfExtentY.data() + i);
+        const Float4 hz = load4(aabbs.halfExtentZ.data() + i);
+        uint32_t outsideBits = 0;
+        uint32_t intersectBits = 0;
+        for (uint32_t p = 0; p < PLANE_COUNT; ++p) {
+            // same as aabbPlane
+            const Float4 r = add4(add4(mul4(hx, planes.absX[p]), mul4(hy, planes.absY[p])), mul4(hz, planes.absZ[p]));
+            const Float4 dot = dot4(planes.nx[p], planes.ny[p], planes.nz[p], cx, cy, cz);
+            outsideBits |= lessMask4(add4(dot, r), planes.d[p]);
+            // not (dot - r > d)
+            intersectBits |= lessEqualMask4(sub4(dot, r), planes.d[p]);
+        }
+        const uint32_t valid = getValidLanes(i, count);
+        setGroup(intersects, i, ~outsideBits & valid);
+        if (inside) {
+            setGroup(*inside, i, ~(outsideBits | intersectBits) & valid);
+        }
+    }
+}
+
+void dynAabbFrustumBatch(const AABBBatch &aabbs, const Frustum &frustum, BatchMask &intersects) {
+    aabbFrustumBatch(aabbs, frustum, intersects);
+    if (frustum.getType() != ShapeEnum::SHAPE_FRUSTUM_ACCURATE) {
+        return;
+    }
+    AABB aabb;
+    for (uint32_t i = 0; i < aabbs.size(); ++i) {
+        if (!testBatchMask(intersects, i)) {
+            continue;
+        }
+        aabb.setCenter(aabbs.centerX[i], aabbs.centerY[i], aabbs.centerZ[i]);
+        aabb.setHalfExtents(aabbs.halfExtentX[i], aabbs.halfExtentY[i], aabbs.halfExtentZ[i]);
+        if (!aabbFrustumAccurate(aabb, frustum)) {
+            intersects[i >> 5] &= ~(1U << (i & 31));
+        }
+    }
+}
+
+void sphereFrustumBatch(const SphereBatch &spheres, const Frustum &frustum, BatchMask &intersects) {
+    const uint32_t count = spheres.size();
+    resetMask(intersects, count);
+    const FrustumPlanes planes(frustum);
+    for (uint32_t i = 0; i < count; i += LANES) {
+        const Float4 cx = load4(spheres.centerX.data() + i);
+        const Float4 cy = load4(spheres.centerY.data() + i);
+        const Float4 cz = load4(spheres.centerZ.data() + i);
+        const Float4 radius = load4(spheres.radius.data() + i);
+        uint32_t outsideBits = 0;
+        for (uint32_t p = 0; p < PLANE_COUNT; ++p) {
+            // same as spherePlane
+            const Float4 dot = dot4(planes.nx[p], planes.ny[p], planes.nz[p], cx, cy, cz);
+            const Float4 r = mul4(radius, planes.length[p]);
+            outsideBits |= lessMask4(add4(dot, r), planes.d[p]);
+        }
+        setGroup(intersects, i, ~outsideBits & getValidLanes(i, count));
+    }
+}
+
+void obbFrustumBatch(const OBBBatch &obbs, const Frustum &frustum, BatchMask &intersects) {
+    const uint32_t count = obbs.size();
+    resetMask(intersects, count);
+    const FrustumPlanes planes(frustum);
+    for (uint32_t i = 0; i < count; i += LANES) {
+        const Float4 cx = load4(obbs.centerX.data() + i);
+        const Float4 cy = load4(obbs.centerY.data() + i);
+        const Float4 cz = load4(obbs.centerZ.data() + i);
+        const Float4 hx = load4(obbs.halfExtentX.data() + i);
+        const Float4 hy = load4(obbs.halfExtentY.data() + i);
+        const Float4 hz = load4(obbs.halfExtentZ.data() + i);
+        Float4 m[9];
+        for (uint32_t j = 0; j < 9; ++j) {
+            m[j] = load4(obbs.orientation[j].data() + i);
+        }
+        uint32_t outsideBits = 0;
+        for (uint32_t p = 0; p < PLANE_COUNT; ++p) {
+            // same as obbPlane
+            const Float4 &nx = planes.nx[p];
+            const Float4 &ny = planes.ny[p];
+            const Float4 &nz = planes.nz[p];
+            const Float4 r = add4(add4(mul4(hx, abs4(dot4(nx, ny, nz, m[0], m[1], m[2]))),
+                                       mul4(hy, abs4(dot4(nx, ny, nz, m[3], m[4], m[5])))),
+                                  mul4(hz, abs4(dot4(nx, ny, nz, m[6], m[7], m[8]))));
+            const Float4 dot = dot4(nx, ny, nz, cx, cy, cz);
+            outsideBits |= lessMask4(add4(dot, r), planes.d[p]);
+        }
+        setGroup(intersects, i, ~outsideBits & getValidLanes(i, count));
+    }
+}
+
+void aabbWithAABBBatch(const AABBBatch &aabbs, const AABB &aabb, BatchMask &intersects) {
+    const uint32_t count = aabbs.size();
+    resetMask(intersects, count);
+    const Vec3 bMin = aabb.getCenter() - aabb.getHalfExtents();
+    const Vec3 bMax = aabb.getCenter() + aabb.getHalfExtents();
+    const Float4 minX = splat4(bMin.x);
+    const Float4 minY = splat4(bMin.y);
+    const Float4 minZ = splat4(bMin.z);
+    const Float4 maxX = splat4(bMax.x);
+    const Float4 maxY = splat4(bMax.y);
+    const Float4 maxZ = splat4(bMax.z);
+    for (uint32_t i = 0; i < count; i += LANES) {
+        const Float4 cx = load4(aabbs.centerX.data() + i);
+        const Float4 cy = load4(aabbs.centerY.data() + i);
+        const Float4 cz = load4(aabbs.centerZ.data() + i);
+        const Float4 hx = load4(aabbs.halfExtentX.data() + i);
+        const Float4 hy = load4(aabbs.halfExtentY.data() + i);
+        const Float4 hz = load4(aabbs.halfExtentZ.data() + i);
+        // aMin <= bMax && aMax >= bMin on every axis
+        const uint32_t bits = lessEqualMask4(sub4(cx, hx), maxX) & lessEqualMask4(minX, add4(cx, hx)) &
+                              lessEqualMask4(sub4(cy, hy), maxY) & lessEqualMask4(minY, add4(cy, hy)) &
+                              lessEqualMask4(sub4(cz, hz), maxZ) & lessEqualMask4(minZ, add4(cz, hz));
+        setGroup(intersects, i, bits & getValidLanes(i, count));
+    }
+}
+
+} // namespace geometry
+} // namespace cc
@@ -0,0 +1,169 @@
+/****************************************************************************
+ Copyright (c) 2022-2023 Xiamen Yaji Software Co., Ltd.
+
+ https://www.cocos.com/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include "base/Macros.h"
+#include "base/std/container/vector.h"
+
+namespace cc {
+
+class Vec3;
+class Mat3;
+
+namespace geometry {
+
+class AABB;
+class OBB;
+class Sphere;
+class Frustum;
+
+/**
+ * Batched versions of the frustum and box tests in Intersect.h. Shapes are stored as structure of arrays and
+ * tested four at a time with SSE or NEON, with a scalar fallback. Every kernel gives the same answer as the
+ * scalar function it is named after.
+ *
+ * Results are bit masks with one bit per shape, 32 shapes per word: shape i is bit (i % 32) of word i / 32.
+ */
+using BatchMask = ccstd::vector<uint32_t>;
+
+inline bool testBatchMask(const BatchMask &mask, uint32_t index) {
+    return (mask[index >> 5] >> (index & 31)) & 1;
+}
+
+/**
+ * Axis aligned boxes as structure of arrays. The arrays are padded with empty boxes to a multiple of four.
+ */
+class CC_DLL AABBBatch final {
+public:
+    ccstd::vector<float> centerX;
+    ccstd::vector<float> centerY;
+    ccstd::vector<float> centerZ;
+    ccstd::vector<float> halfExtentX;
+    ccstd::vector<float> halfExtentY;
+    ccstd::vector<float> halfExtentZ;
+
+    void reserve(uint32_t capacity);
+    void clear();
+    void push(const AABB &aabb);
+    void push(const Vec3 &center, const Vec3 &halfExtents);
+    inline uint32_t size() const { return _count; }
+    inline bool empty() const { return _count == 0; }
+
+private:
+    uint32_t _count{0};
+};
+
+/**
+ * Spheres as structure of arrays, padded like AABBBatch.
+ */
+class CC_DLL SphereBatch final {
+public:
+    ccstd::vector<float> centerX;
+    ccstd::vector<float> centerY;
+    ccstd::vector<float> centerZ;
+    ccstd::vector<float> radius;
+
+    void reserve(uint32_t capacity);
+    void clear();
+    void push(const Sphere &sphere);
+    void push(const Vec3 &center, float radius);
+    inline uint32_t size() const { return _count; }
+    inline bool empty() const { return _count == 0; }
+
+private:
+    uint32_t _count{0};
+};
+
+/**
+ * Oriented boxes as structure of arrays, padded like AABBBatch. orientation[i] holds element i of the
+ * orientation matrix of every box.
+ */
+class CC_DLL OBBBatch final {
+public:
+    ccstd::vector<float> centerX;
+    ccstd::vector<float> centerY;
+    ccstd::vector<float> centerZ;
+    ccstd::vector<float> halfExtentX;
+    ccstd::vector<float> halfExtentY;
+    ccstd::vector<float> halfExtentZ;
+    ccstd::vector<float> orientation[9];
+
+    void reserve(uint32_t capacity);
+    void clear();
+    void push(const OBB &obb);
+    inline uint32_t size() const { return _count; }
+    inline bool empty() const { return _count == 0; }
+
+private:
+    uint32_t _count{0};
+};
+
+/**
+ * @en
+ * Batched aabbFrustum, optionally also computing aabbFrustumCompletelyInside.
+ * @zh
+ * 批量的轴对齐包围盒和锥台相交性检测，可同时计算 aabbFrustumCompletelyInside。
+ * @param aabbs 轴对齐包围盒
+ * @param frustum 锥台
+ * @param intersects 与锥台相交的包围盒
+ * @param inside 完全在锥台内的包围盒，可为空
+ */
+void aabbFrustumBatch(const AABBBatch &aabbs, const Frustum &frustum, BatchMask &intersects, BatchMask *inside = nullptr);
+
+/**
+ * @en
+ * Batched dynAabbFrustum, refining the boxes kept by aabbFrustumBatch with aabbFrustumAccurate when the frustum
+ * asks for it.
+ * @zh
+ * 批量的 dynAabbFrustum，锥台要求精确检测时对 aabbFrustumBatch 保留的包围盒再用 aabbFrustumAccurate 检测。
+ */
+void dynAabbFrustumBatch(const AABBBatch &aabbs, const Frustum &frustum, BatchMask &intersects);
+
+/**
+ * @en
+ * Batched sphereFrustum.
+ * @zh
+ * 批量的球和锥台相交性检测。
+ */
+void sphereFrustumBatch(const SphereBatch &spheres, const Frustum &frustum, BatchMask &intersects);
+
+/**
+ * @en
+ * Batched obbFrustum.
+ * @zh
+ * 批量的方向包围盒和锥台相交性检测。
+ */
+void obbFrustumBatch(const OBBBatch &obbs, const Frustum &frustum, BatchMask &intersects);
+
+/**
+ * @en
+ * Batched aabbWithAABB, every box of the batch against one box.
+ * @zh
+ * 批量的轴对齐包围盒相交性检测，批中的每个包围盒与同一个包围盒检测。
+ */
+void aabbWithAABBBatch(const AABBBatch &aabbs, const AABB &aabb, BatchMask &intersects);
+
+} // namespace geometry
+} // namespace cc
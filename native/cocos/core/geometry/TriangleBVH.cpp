@@ -0,0 +1,656 @@
+/****************************************************************************
+ Copyright (c) 2022-2023 Xiamen Yaji Software Co., Ltd.
+
+ https://www.cocos.com/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#include "core/geometry/TriangleBVH.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include "base/TemplateUtils.h"
+#include "core/geometry/Intersect.h"
+#include "core/geometry/Ray.h"
+#include "core/geometry/Triangle.h"
+#include "math/Math.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <xmmintrin.h>
+    #define CC_TRIANGLE_BVH_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define CC_TRIANGLE_BVH_NEON
+#endif
+
+namespace cc {
+namespace geometry {
+
+namespace {
+
+constexpr uint32_t BIN_COUNT = 12;
+// Deeper subtrees fall back to median splits, which keeps the traversal stack bounded.
+constexpr uint32_t MAX_SAH_DEPTH = 48;
+constexpr uint32_t STACK_SIZE = 96;
+constexpr float MISS = std::numeric_limits<float>::infinity();
+// relative slack of the SIMD triangle filter
+constexpr float FILTER_TOLERANCE = 1e-4F;
+
+// Build data is kept in plain floats, the axis loops below index it directly.
+struct Bounds {
+    float min[3]{FLT_MAX, FLT_MAX, FLT_MAX};
+    float max[3]{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+    inline void grow(const float *p) {
+        for (uint32_t i = 0; i < 3; ++i) {
+            min[i] = std::min(min[i], p[i]);
+            max[i] = std::max(max[i], p[i]);
+        }
+    }
+
+    inline void grow(const Bounds &b) {
+        for (uint32_t i = 0; i < 3; ++i) {
+            min[i] = std::min(min[i], b.min[i]);
+            max[i] = std::max(max[i], b.max[i]);
+        }
+    }
+
+    inline float getSurfaceArea() const {
+        if (min[0] > max[0]) return 0.F;
+        const float x = max[0] - min[0];
+        const float y = max[1] - min[1];
+        const float z = max[2] - min[2];
+        return 2.0F * (x * y + y * z + z * x);
+    }
+};
+
+struct BuildItem {
+    Bounds bounds;
+    float centroid[3];
+    uint32_t triangle;
+};
+
+struct BuildTask {
+    uint32_t node;
+    uint32_t begin;
+    uint32_t end;
+    uint32_t depth;
+};
+
+// Zero or tiny direction components are clamped so the slab products never hit 0 * inf.
+inline float safeInverse(float d) {
+    const float inv = 1.0F / d;
+    if (std::abs(inv) <= FLT_MAX) return inv;
+    return std::signbit(d) ? -FLT_MAX : FLT_MAX;
+}
+
+struct RayData {
+    Vec3 o;
+    Vec3 inv;
+    bool negative[3];
+
+    explicit RayData(const Ray &ray) : o(ray.o), inv(safeInverse(ray.d.x), safeInverse(ray.d.y), safeInverse(ray.d.z)) {
+        negative[0] = inv.x < 0;
+        negative[1] = inv.y < 0;
+        negative[2] = inv.z < 0;
+    }
+};
+
+// Entry distance of the ray into the box, MISS if it passes by or enters beyond limit.
+template <typename N>
+inline float slabEnter(const N &node, const RayData &r, float limit) {
+    const float tx1 = (node.min.x - r.o.x) * r.inv.x;
+    const float tx2 = (node.max.x - r.o.x) * r.inv.x;
+    const float ty1 = (node.min.y - r.o.y) * r.inv.y;
+    const float ty2 = (node.max.y - r.o.y) * r.inv.y;
+    const float tz1 = (node.min.z - r.o.z) * r.inv.z;
+    const float tz2 = (node.max.z - r.o.z) * r.inv.z;
+    const float tEnter = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)), std::min(tz1, tz2));
+    const float tExit = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)), std::max(tz1, tz2));
+    return tExit >= std::max(tEnter, 0.F) && tEnter <= limit ? tEnter : MISS;
+}
+
+// Rays of a packet in SoA layout.
+struct RayPacket {
+    alignas(16) float ox[TriangleBVH::PACKET_SIZE]{};
+    alignas(16) float oy[TriangleBVH::PACKET_SIZE]{};
+    alignas(16) float oz[TriangleBVH::PACKET_SIZE]{};
+    alignas(16) float dx[TriangleBVH::PACKET_SIZE]{};
+    alignas(16) float dy[TriangleBVH::PACKET_SIZE]{};
+    alignas(16) float dz[TriangleBVH::PACKET_SIZE]{};
+    alignas(16) float ix[TriangleBVH::PACKET_SIZE]{};
+    alignas(16) float iy[TriangleBVH::PACKET_SIZE]{};
+    alignas(16) float iz[TriangleBVH::PACKET_SIZE]{};
+    alignas(16) float limit[TriangleBVH::PACKET_SIZE]{};
+};
+
+/**
+ * Slab test of every ray of the packet against one box, same rules as slabEnter.
+ * Bit i of the result is set if ray i enters the box within its limit.
+ */
+template <typename N>
+inline uint32_t testPacket(const N &node, const RayPacket &p) {
+#if defined(CC_TRIANGLE_BVH_SSE)
+    const __m128 ox = _mm_load_ps(p.ox);
+    const __m128 oy = _mm_load_ps(p.oy);
+    const __m128 oz = _mm_load_ps(p.oz);
+    const __m128 ix = _mm_load_ps(p.ix);
+    const __m128 iy = _mm_load_ps(p.iy);
+    const __m128 iz = _mm_load_ps(p.iz);
+    const __m128 tx1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.min.x), ox), ix);
+    const __m128 tx2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.max.x), ox), ix);
+    const __m128 ty1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.min.y), oy), iy);
+    const __m128 ty2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.max.y), oy), iy);
+    const __m128 tz1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.min.z), oz), iz);
+    const __m128 tz2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.max.z), oz), iz);
+    const __m128 tEnter = _mm_max_ps(_mm_max_ps(_mm_min_ps(tx1, tx2), _mm_min_ps(ty1, ty2)), _mm_min_ps(tz1, tz2));
+    const __m128 tExit = _mm_min_ps(_mm_min_ps(_mm_max_ps(tx1, tx2), _mm_max_ps(ty1, ty2)), _mm_max_ps(tz1, tz2));
+    const __m128 hit = _mm_and_ps(_mm_cmpge_ps(tExit, _mm_max_ps(tEnter, _mm_setzero_ps())),
+                                  _mm_cmple_ps(tEnter, _mm_load_ps(p.limit)));
+    return static_cast<uint32_t>(_mm_movemask_ps(hit));
+#elif defined(CC_TRIANGLE_BVH_NEON)
+    const float32x4_t ox = vld1q_f32(p.ox);
+    const float32x4_t oy = vld1q_f32(p.oy);
+    const float32x4_t oz = vld1q_f32(p.oz);
+    const float32x4_t ix = vld1q_f32(p.ix);
+    const float32x4_t iy = vld1q_f32(p.iy);
+    const float32x4_t iz = vld1q_f32(p.iz);
+    const float32x4_t tx1 = vmulq_f32(vsubq_f32(vdupq_n_f32(node.min.x), ox), ix);
+    const float32x4_t tx2 = vmulq_f32(vsubq_f32(vdupq_n_f32(node.max.x), ox), ix);
+    const float32x4_t ty1 = vmulq_f32(vsubq_f32(vdupq_n_f32(node.min.y), oy), iy);
+    const float32x4_t ty2 = vmulq_f32(vsubq_f32(vdupq_n_f32(node.max.y), oy), iy);
+    const float32x4_t tz1 = vmulq_f32(vsubq_f32(vdupq_n_f32(node.min.z), oz), iz);
+    const float32x4_t tz2 = vmulq_f32(vsubq_f32(vdupq_n_f32(node.max.z), oz), iz);
+    const float32x4_t tEnter = vmaxq_f32(vmaxq_f32(vminq_f32(tx1, tx2), vminq_f32(ty1, ty2)), vminq_f32(tz1, tz2));
+    const float32x4_t tExit = vminq_f32(vminq_f32(vmaxq_f32(tx1, tx2), vmaxq_f32(ty1, ty2)), vmaxq_f32(tz1, tz2));
+    const uint32x4_t hit = vandq_u32(vcgeq_f32(tExit, vmaxq_f32(tEnter, vdupq_n_f32(0.F))),
+                                     vcleq_f32(tEnter, vld1q_f32(p.limit)));
+    alignas(16) uint32_t lanes[TriangleBVH::PACKET_SIZE];
+    vst1q_u32(lanes, hit);
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < TriangleBVH::PACKET_SIZE; ++i) {
+        mask |= (lanes[i] & 1U) << i;
+    }
+    return mask;
+#else
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < TriangleBVH::PACKET_SIZE; ++i) {
+        const float tx1 = (node.min.x - p.ox[i]) * p.ix[i];
+        const float tx2 = (node.max.x - p.ox[i]) * p.ix[i];
+        const float ty1 = (node.min.y - p.oy[i]) * p.iy[i];
+        const float ty2 = (node.max.y - p.oy[i]) * p.iy[i];
+        const float tz1 = (node.min.z - p.oz[i]) * p.iz[i];
+        const float tz2 = (node.max.z - p.oz[i]) * p.iz[i];
+        const float tEnter = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)), std::min(tz1, tz2));
+        const float tExit = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)), std::max(tz1, tz2));
+        if (tExit >= std::max(tEnter, 0.F) && tEnter <= p.limit[i]) mask |= 1U << i;
+    }
+    return mask;
+#endif
+}
+
+/**
+ * Möller-Trumbore test of a triangle against every ray of the packet, with some slack on every bound.
+ * It only rules lanes out, the lanes it keeps are tested again with rayTriangle so results stay exact.
+ */
+template <typename T>
+inline uint32_t filterPacket(const T &tri, const RayPacket &p, bool doubleSided) {
+#if defined(CC_TRIANGLE_BVH_SSE) || defined(CC_TRIANGLE_BVH_NEON)
+    const Vec3 e1 = tri.b - tri.a;
+    const Vec3 e2 = tri.c - tri.a;
+#endif
+#if defined(CC_TRIANGLE_BVH_SSE)
+    const __m128 dx = _mm_load_ps(p.dx);
+    const __m128 dy = _mm_load_ps(p.dy);
+    const __m128 dz = _mm_load_ps(p.dz);
+    const __m128 tx = _mm_sub_ps(_mm_load_ps(p.ox), _mm_set1_ps(tri.a.x));
+    const __m128 ty = _mm_sub_ps(_mm_load_ps(p.oy), _mm_set1_ps(tri.a.y));
+    const __m128 tz = _mm_sub_ps(_mm_load_ps(p.oz), _mm_set1_ps(tri.a.z));
+    const __m128 e1x = _mm_set1_ps(e1.x);
+    const __m128 e1y = _mm_set1_ps(e1.y);
+    const __m128 e1z = _mm_set1_ps(e1.z);
+    const __m128 e2x = _mm_set1_ps(e2.x);
+    const __m128 e2y = _mm_set1_ps(e2.y);
+    const __m128 e2z = _mm_set1_ps(e2.z);
+    // p = d x e2, q = (o - a) x e1
+    const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+    const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+    const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+    const __m128 qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+    const __m128 qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+    const __m128 qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+    const __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+    const __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0F), det);
+    const __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px), _mm_mul_ps(ty, py)), _mm_mul_ps(tz, pz)), invDet);
+    const __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), invDet);
+    const __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), invDet);
+    const __m128 signMask = _mm_set1_ps(-0.0F);
+    const __m128 limit = _mm_load_ps(p.limit);
+    const __m128 tol = _mm_set1_ps(FILTER_TOLERANCE);
+    const __m128 one = _mm_set1_ps(1.0F + FILTER_TOLERANCE);
+    const __m128 minDet = _mm_set1_ps(math::EPSILON * 0.5F);
+    __m128 hit = _mm_cmpge_ps(doubleSided ? _mm_andnot_ps(signMask, det) : det, minDet);
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(u, _mm_sub_ps(_mm_setzero_ps(), tol)));
+    hit = _mm_and_ps(hit, _mm_cmple_ps(u, one));
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(v, _mm_sub_ps(_mm_setzero_ps(), tol)));
+    hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), one));
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(t, _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(tol, _mm_add_ps(_mm_set1_ps(1.0F), _mm_andnot_ps(signMask, t))))));
+    hit = _mm_and_ps(hit, _mm_cmple_ps(t, _mm_add_ps(limit, _mm_mul_ps(tol, _mm_add_ps(_mm_set1_ps(1.0F), _mm_andnot_ps(signMask, limit))))));
+    return static_cast<uint32_t>(_mm_movemask_ps(hit));
+#elif defined(CC_TRIANGLE_BVH_NEON)
+    const float32x4_t dx = vld1q_f32(p.dx);
+    const float32x4_t dy = vld1q_f32(p.dy);
+    const float32x4_t dz = vld1q_f32(p.dz);
+    const float32x4_t tx = vsubq_f32(vld1q_f32(p.ox), vdupq_n_f32(tri.a.x));
+    const float32x4_t ty = vsubq_f32(vld1q_f32(p.oy), vdupq_n_f32(tri.a.y));
+    const float32x4_t tz = vsubq_f32(vld1q_f32(p.oz), vdupq_n_f32(tri.a.z));
+    // p = d x e2, q = (o - a) x e1
+    const float32x4_t px = vsubq_f32(vmulq_n_f32(dy, e2.z), vmulq_n_f32(dz, e2.y));
+    const float32x4_t py = vsubq_f32(vmulq_n_f32(dz, e2.x), vmulq_n_f32(dx, e2.z));
+    const float32x4_t pz = vsubq_f32(vmulq_n_f32(dx, e2.y), vmulq_n_f32(dy, e2.x));
+    const float32x4_t qx = vsubq_f32(vmulq_n_f32(ty, e1.z), vmulq_n_f32(tz, e1.y));
+    const float32x4_t qy = vsubq_f32(vmulq_n_f32(tz, e1.x), vmulq_n_f32(tx, e1.z));
+    const float32x4_t qz = vsubq_f32(vmulq_n_f32(tx, e1.y), vmulq_n_f32(ty, e1.x));
+    const float32x4_t det = vaddq_f32(vaddq_f32(vmulq_n_f32(px, e1.x), vmulq_n_f32(py, e1.y)), vmulq_n_f32(pz, e1.z));
+    // two Newton steps on the estimate are well inside the tolerance
+    float32x4_t invDet = vrecpeq_f32(det);
+    invDet = vmulq_f32(vrecpsq_f32(det, invDet), invDet);
+    invDet = vmulq_f32(vrecpsq_f32(det, invDet), invDet);
+    const float32x4_t u = vmulq_f32(vaddq_f32(vaddq_f32(vmulq_f32(tx, px), vmulq_f32(ty, py)), vmulq_f32(tz, pz)), invDet);
+    const float32x4_t v = vmulq_f32(vaddq_f32(vaddq_f32(vmulq_f32(dx, qx), vmulq_f32(dy, qy)), vmulq_f32(dz, qz)), invDet);
+    const float32x4_t t = vmulq_f32(vaddq_f32(vaddq_f32(vmulq_n_f32(qx, e2.x), vmulq_n_f32(qy, e2.y)), vmulq_n_f32(qz, e2.z)), invDet);
+    const float32x4_t limit = vld1q_f32(p.limit);
+    const float32x4_t one = vdupq_n_f32(1.0F);
+    const float32x4_t minDet = vdupq_n_f32(math::EPSILON * 0.5F);
+    uint32x4_t hit = vcgeq_f32(doubleSided ? vabsq_f32(det) : det, minDet);
+    hit = vandq_u32(hit, vcgeq_f32(u, vdupq_n_f32(-FILTER_TOLERANCE)));
+    hit = vandq_u32(hit, vcleq_f32(u, vdupq_n_f32(1.0F + FILTER_TOLERANCE)));
+    hit = vandq_u32(hit, vcgeq_f32(v, vdupq_n_f32(-FILTER_TOLERANCE)));
+    hit = vandq_u32(hit, vcleq_f32(vaddq_f32(u, v), vdupq_n_f32(1.0F + FILTER_TOLERANCE)));
+    hit = vandq_u32(hit, vcgeq_f32(t, vnegq_f32(vmulq_n_f32(vaddq_f32(one, vabsq_f32(t)), FILTER_TOLERANCE))));
+    hit = vandq_u32(hit, vcleq_f32(t, vaddq_f32(limit, vmulq_n_f32(vaddq_f32(one, vabsq_f32(limit)), FILTER_TOLERANCE))));
+    alignas(16) uint32_t lanes[TriangleBVH::PACKET_SIZE];
+    vst1q_u32(lanes, hit);
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < TriangleBVH::PACKET_SIZE; ++i) {
+        mask |= (lanes[i] & 1U) << i;
+    }
+    return mask;
+#else
+    // every lane goes straight to rayTriangle
+    return (1U << TriangleBVH::PACKET_SIZE) - 1;
+#endif
+}
+
+inline bool isCloser(float distance, uint32_t triangle, float bestDistance, uint32_t bestTriangle) {
+    return distance < bestDistance || (distance == bestDistance && triangle < bestTriangle);
+}
+
+} // namespace
+
+void TriangleBVH::build(const Float32Array &positions, const IBArray &indices, gfx::PrimitiveMode primitiveMode) {
+    clear();
+
+    ccstd::vector<uint32_t> ib;
+    ccstd::visit(overloaded{
+                     [&](const auto &arr) {
+                         ib.resize(arr.length());
+                         for (uint32_t i = 0; i < arr.length(); ++i) {
+                             ib[i] = arr[i];
+                         }
+                     },
+                     [](const ccstd::monostate & /*unused*/) {}},
+                 indices);
+
+    // Same enumeration as a linear scan, positions are read as three floats per vertex.
+    const uint64_t vertexCount = positions.length() / 3;
+    auto addTriangle = [&](uint32_t i0, uint32_t i1, uint32_t i2) {
+        if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount) return;
+        _vertexIndices.push_back({i0, i1, i2});
+    };
+    const auto ibSize = static_cast<uint32_t>(ib.size());
+    if (primitiveMode == gfx::PrimitiveMode::TRIANGLE_LIST) {
+        for (uint32_t j = 0; j + 2 < ibSize; j += 3) {
+            addTriangle(ib[j], ib[j + 1], ib[j + 2]);
+        }
+    } else if (primitiveMode == gfx::PrimitiveMode::TRIANGLE_STRIP) {
+        for (uint32_t j = 0; j + 2 < ibSize; ++j) {
+            // odd triangles swap their first two vertices to keep the winding
+            if (j % 2 == 0) {
+                addTriangle(ib[j], ib[j + 1], ib[j + 2]);
+            } else {
+                addTriangle(ib[j + 1], ib[j], ib[j + 2]);
+            }
+        }
+    } else if (primitiveMode == gfx::PrimitiveMode::TRIANGLE_FAN) {
+        for (uint32_t j = 1; j + 1 < ibSize; ++j) {
+            addTriangle(ib[0], ib[j], ib[j + 1]);
+        }
+    }
+    if (_vertexIndices.empty()) return;
+
+    const auto triangleCount = static_cast<uint32_t>(_vertexIndices.size());
+    ccstd::vector<TriangleData> triangles(triangleCount);
+    ccstd::vector<BuildItem> items(triangleCount);
+    Bounds rootBounds;
+    for (uint32_t i = 0; i < triangleCount; ++i) {
+        const auto &v = _vertexIndices[i];
+        auto &tri = triangles[i];
+        tri.a.set(positions[v[0] * 3], positions[v[0] * 3 + 1], positions[v[0] * 3 + 2]);
+        tri.b.set(positions[v[1] * 3], positions[v[1] * 3 + 1], positions[v[1] * 3 + 2]);
+        tri.c.set(positions[v[2] * 3], positions[v[2] * 3 + 1], positions[v[2] * 3 + 2]);
+        tri.triangle = i;
+        auto &item = items[i];
+        const float a[3]{tri.a.x, tri.a.y, tri.a.z};
+        const float b[3]{tri.b.x, tri.b.y, tri.b.z};
+        const float c[3]{tri.c.x, tri.c.y, tri.c.z};
+        item.bounds.grow(a);
+        item.bounds.grow(b);
+        item.bounds.grow(c);
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+            item.centroid[axis] = (item.bounds.min[axis] + item.bounds.max[axis]) * 0.5F;
+        }
+        item.triangle = i;
+        rootBounds.grow(item.bounds);
+    }
+    // Boxes are padded a little so rounding in the slab test never culls a triangle the exact test would hit.
+    float magnitude = 0.F;
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+        magnitude = std::max({magnitude, rootBounds.max[axis] - rootBounds.min[axis], std::abs(rootBounds.min[axis]), std::abs(rootBounds.max[axis])});
+    }
+    const float padding = magnitude * 1e-6F + FLT_MIN;
+
+    _nodes.reserve(triangleCount * 2 - 1);
+    _nodes.emplace_back();
+
+    ccstd::vector<BuildTask> tasks;
+    tasks.push_back({0, 0, triangleCount, 0});
+    while (!tasks.empty()) {
+        const BuildTask task = tasks.back();
+        tasks.pop_back();
+
+        Bounds bounds;
+        Bounds centroidBounds;
+        for (uint32_t i = task.begin; i < task.end; ++i) {
+            bounds.grow(items[i].bounds);
+            centroidBounds.grow(items[i].centroid);
+        }
+        Node &node = _nodes[task.node];
+        node.min.set(bounds.min[0] - padding, bounds.min[1] - padding, bounds.min[2] - padding);
+        node.max.set(bounds.max[0] + padding, bounds.max[1] + padding, bounds.max[2] + padding);
+
+        const uint32_t count = task.end - task.begin;
+        if (count <= MAX_LEAF_SIZE) {
+            node.first = task.begin;
+            node.count = static_cast<uint16_t>(count);
+            continue;
+        }
+
+        // Binned SAH over the axes the centroids spread along.
+        uint32_t bestAxis = 0;
+        uint32_t bestSplit = 0;
+        float bestCost = FLT_MAX;
+        if (task.depth < MAX_SAH_DEPTH) {
+            for (uint32_t axis = 0; axis < 3; ++axis) {
+                const float cmin = centroidBounds.min[axis];
+                const float extent = centroidBounds.max[axis] - cmin;
+                if (extent <= 0.F) continue;
+                const float scale = static_cast<float>(BIN_COUNT) / extent;
+                Bounds binBounds[BIN_COUNT];
+                uint32_t binCounts[BIN_COUNT]{};
+                for (uint32_t i = task.begin; i < task.end; ++i) {
+                    const auto &item = items[i];
+                    const auto bin = std::min(BIN_COUNT - 1, static_cast<uint32_t>((item.centroid[axis] - cmin) * scale));
+                    binBounds[bin].grow(item.bounds);
+                    ++binCounts[bin];
+                }
+                float rightAreas[BIN_COUNT];
+                uint32_t rightCounts[BIN_COUNT];
+                Bounds right;
+                uint32_t rightCount = 0;
+                for (uint32_t bin = BIN_COUNT - 1; bin > 0; --bin) {
+                    right.grow(binBounds[bin]);
+                    rightCount += binCounts[bin];
+                    rightAreas[bin] = right.getSurfaceArea();
+                    rightCounts[bin] = rightCount;
+                }
+                Bounds left;
+                uint32_t leftCount = 0;
+                for (uint32_t split = 1; split < BIN_COUNT; ++split) {
+                    left.grow(binBounds[split - 1]);
+                    leftCount += binCounts[split - 1];
+                    if (leftCount == 0 || rightCounts[split] == 0) continue;
+                    const float cost = static_cast<float>(leftCount) * left.getSurfaceArea() + static_cast<float>(rightCounts[split]) * rightAreas[split];
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestSplit = split;
+                    }
+                }
+            }
+        }
+
+        auto *begin = items.data() + task.begin;
+        auto *end = items.data() + task.end;
+        auto *mid = begin;
+        if (bestSplit != 0) {
+            const float cmin = centroidBounds.min[bestAxis];
+            const float scale = static_cast<float>(BIN_COUNT) / (centroidBounds.max[bestAxis] - cmin);
+            mid = std::partition(begin, end, [&](const BuildItem &item) {
+                return std::min(BIN_COUNT - 1, static_cast<uint32_t>((item.centroid[bestAxis] - cmin) * scale)) < bestSplit;
+            });
+        }
+        if (mid == begin || mid == end) {
+            bestAxis = 0;
+            for (uint32_t axis = 1; axis < 3; ++axis) {
+                if (centroidBounds.max[axis] - centroidBounds.min[axis] > centroidBounds.max[bestAxis] - centroidBounds.min[bestAxis]) bestAxis = axis;
+            }
+            mid = begin + count / 2;
+            std::nth_element(begin, mid, end, [&](const BuildItem &a, const BuildItem &b) {
+                return a.centroid[bestAxis] < b.centroid[bestAxis];
+            });
+        }
+
+        const auto first = static_cast<uint32_t>(_nodes.size());
+        node.first = first;
+        node.axis = static_cast<uint16_t>(bestAxis);
+        _nodes.emplace_back();
+        _nodes.emplace_back();
+        const auto split = static_cast<uint32_t>(mid - items.data());
+        tasks.push_back({first + 1, split, task.end, task.depth + 1});
+        tasks.push_back({first, task.begin, split, task.depth + 1});
+    }
+
+    _triangles.resize(triangleCount);
+    for (uint32_t i = 0; i < triangleCount; ++i) {
+        _triangles[i] = triangles[items[i].triangle];
+    }
+}
+
+void TriangleBVH::clear() {
+    _nodes.clear();
+    _triangles.clear();
+    _vertexIndices.clear();
+}
+
+template <bool ANY>
+bool TriangleBVH::traverse(const Ray &ray, float maxDistance, bool doubleSided, Hit *hit) const {
+    if (_nodes.empty()) return false;
+
+    const RayData r(ray);
+    Triangle tri;
+    float bestDistance = maxDistance;
+    uint32_t bestTriangle = std::numeric_limits<uint32_t>::max();
+    bool found = false;
+
+    uint32_t stack[STACK_SIZE];
+    uint32_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node &node = _nodes[stack[--top]];
+        if (slabEnter(node, r, bestDistance) == MISS) continue;
+
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                const auto &data = _triangles[i];
+                tri.a = data.a;
+                tri.b = data.b;
+                tri.c = data.c;
+                const float dist = rayTriangle(ray, tri, doubleSided);
+                if (dist == 0.0F || dist > maxDistance) continue;
+                if (ANY) {
+                    *hit = {dist, data.triangle};
+                    return true;
+                }
+                if (isCloser(dist, data.triangle, bestDistance, bestTriangle)) {
+                    bestDistance = dist;
+                    bestTriangle = data.triangle;
+                    found = true;
+                }
+            }
+        } else {
+            // visit the near child first so farther subtrees get culled by the closest hit so far
+            const uint32_t nearChild = r.negative[node.axis] ? node.first + 1 : node.first;
+            stack[top++] = nearChild == node.first ? node.first + 1 : node.first;
+            stack[top++] = nearChild;
+        }
+    }
+
+    if (found) *hit = {bestDistance, bestTriangle};
+    return found;
+}
+
+bool TriangleBVH::raycastAny(const Ray &ray, float maxDistance, bool doubleSided, Hit *hit) const {
+    return traverse<true>(ray, maxDistance, doubleSided, hit);
+}
+
+bool TriangleBVH::raycastClosest(const Ray &ray, float maxDistance, bool doubleSided, Hit *hit) const {
+    return traverse<false>(ray, maxDistance, doubleSided, hit);
+}
+
+void TriangleBVH::raycastAll(const Ray &ray, float maxDistance, bool doubleSided, ccstd::vector<Hit> &hits) const {
+    hits.clear();
+    if (_nodes.empty()) return;
+
+    const RayData r(ray);
+    Triangle tri;
+    uint32_t stack[STACK_SIZE];
+    uint32_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node &node = _nodes[stack[--top]];
+        if (slabEnter(node, r, maxDistance) == MISS) continue;
+
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                const auto &data = _triangles[i];
+                tri.a = data.a;
+                tri.b = data.b;
+                tri.c = data.c;
+                const float dist = rayTriangle(ray, tri, doubleSided);
+                if (dist == 0.0F || dist > maxDistance) continue;
+                hits.push_back({dist, data.triangle});
+            }
+        } else {
+            stack[top++] = node.first + 1;
+            stack[top++] = node.first;
+        }
+    }
+    std::sort(hits.begin(), hits.end(), [](const Hit &a, const Hit &b) { return a.triangle < b.triangle; });
+}
+
+void TriangleBVH::raycastPacket(const Ray *const *rays, uint32_t count, float maxDistance, bool doubleSided, bool anyHit, Hit *hits) const {
+    count = std::min(count, PACKET_SIZE);
+    for (uint32_t i = 0; i < count; ++i) {
+        hits[i] = {};
+    }
+    if (_nodes.empty() || count == 0) return;
+
+    RayPacket packet;
+    bool negative[PACKET_SIZE][3];
+    uint32_t bestTriangles[PACKET_SIZE];
+    for (uint32_t i = 0; i < count; ++i) {
+        const RayData r(*rays[i]);
+        packet.ox[i] = r.o.x;
+        packet.oy[i] = r.o.y;
+        packet.oz[i] = r.o.z;
+        packet.dx[i] = rays[i]->d.x;
+        packet.dy[i] = rays[i]->d.y;
+        packet.dz[i] = rays[i]->d.z;
+        packet.ix[i] = r.inv.x;
+        packet.iy[i] = r.inv.y;
+        packet.iz[i] = r.inv.z;
+        packet.limit[i] = maxDistance;
+        negative[i][0] = r.negative[0];
+        negative[i][1] = r.negative[1];
+        negative[i][2] = r.negative[2];
+        bestTriangles[i] = std::numeric_limits<uint32_t>::max();
+    }
+    uint32_t active = (1U << count) - 1;
+
+    Triangle tri;
+    uint32_t stack[STACK_SIZE];
+    uint32_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node &node = _nodes[stack[--top]];
+        const uint32_t mask = testPacket(node, packet) & active;
+        if (mask == 0) continue;
+
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                const auto &data = _triangles[i];
+                uint32_t lanes = filterPacket(data, packet, doubleSided) & mask & active;
+                if (lanes == 0) continue;
+                tri.a = data.a;
+                tri.b = data.b;
+                tri.c = data.c;
+                for (uint32_t lane = 0; lanes != 0; ++lane, lanes >>= 1) {
+                    if ((lanes & 1U) == 0) continue;
+                    const float dist = rayTriangle(*rays[lane], tri, doubleSided);
+                    if (dist == 0.0F || dist > maxDistance) continue;
+                    if (anyHit) {
+                        hits[lane] = {dist, data.triangle};
+                        active &= ~(1U << lane);
+                    } else if (isCloser(dist, data.triangle, packet.limit[lane], bestTriangles[lane])) {
+                        hits[lane] = {dist, data.triangle};
+                        packet.limit[lane] = dist;
+                        bestTriangles[lane] = data.triangle;
+                    }
+                }
+            }
+            if (active == 0) return;
+        } else {
+            // the first ray that enters the node decides the visiting order
+            uint32_t lane = 0;
+            while ((mask & (1U << lane)) == 0) {
+                ++lane;
+            }
+            const uint32_t nearChild = negative[lane][node.axis] ? node.first + 1 : node.first;
+            stack[top++] = nearChild == node.first ? node.first + 1 : node.first;
+            stack[top++] = nearChild;
+        }
+    }
+}
+
+} // namespace geometry
+} // namespace cc
@@ -0,0 +1,107 @@
+/****************************************************************************
+ Copyright (c) 2022-2023 Xiamen Yaji Software Co., Ltd.
+
+ https://www.cocos.com/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include "3d/assets/Types.h"
+#include "base/Macros.h"
+#include "base/std/container/array.h"
+#include "base/std/container/vector.h"
+#include "math/Vec3.h"
+#include "renderer/gfx-base/GFXDef-common.h"
+
+namespace cc {
+namespace geometry {
+
+class Ray;
+
+/**
+ * Bounding volume hierarchy over the triangles of a sub mesh, built with binned SAH.
+ * Triangles are numbered in primitive order, the order in which a linear scan over the index buffer visits them,
+ * and every query reports the same hits and distances as that scan. Ties between equally distant triangles are
+ * resolved to the lower number, like the scan does.
+ * Packets of up to four rays are traversed together, testing the node boxes with SSE or NEON slab tests.
+ */
+class CC_DLL TriangleBVH final {
+public:
+    static constexpr uint32_t PACKET_SIZE = 4;
+    static constexpr uint32_t MAX_LEAF_SIZE = 4;
+
+    struct Hit {
+        float distance{0.F};
+        // triangle number in primitive order
+        uint32_t triangle{0};
+    };
+
+    void build(const Float32Array &positions, const IBArray &indices, gfx::PrimitiveMode primitiveMode);
+    void clear();
+
+    inline bool empty() const { return _triangles.empty(); }
+    inline uint32_t getTriangleCount() const { return static_cast<uint32_t>(_triangles.size()); }
+    inline uint32_t getNodeCount() const { return static_cast<uint32_t>(_nodes.size()); }
+    inline const ccstd::array<uint32_t, 3> &getVertexIndices(uint32_t triangle) const { return _vertexIndices[triangle]; }
+
+    // Hits farther than maxDistance are ignored, the return value tells whether anything was hit.
+    bool raycastAny(const Ray &ray, float maxDistance, bool doubleSided, Hit *hit) const;
+    bool raycastClosest(const Ray &ray, float maxDistance, bool doubleSided, Hit *hit) const;
+    // Collects every hit, sorted by triangle number.
+    void raycastAll(const Ray &ray, float maxDistance, bool doubleSided, ccstd::vector<Hit> &hits) const;
+
+    /**
+     * Traces up to PACKET_SIZE rays in one traversal. hits[i] receives the closest hit of rays[i], or any hit if
+     * anyHit is set, with a distance of 0 if the ray missed.
+     */
+    void raycastPacket(const Ray *const *rays, uint32_t count, float maxDistance, bool doubleSided, bool anyHit, Hit *hits) const;
+
+private:
+    struct Node {
+        Vec3 min;
+        // first child for inner nodes, the second child follows it, first triangle for leaves
+        uint32_t first{0};
+        Vec3 max;
+        // 0 for inner nodes
+        uint16_t count{0};
+        // split axis of inner nodes, used to visit the near child first
+        uint16_t axis{0};
+    };
+
+    struct TriangleData {
+        Vec3 a;
+        Vec3 b;
+        Vec3 c;
+        uint32_t triangle{0};
+    };
+
+    template <bool ANY>
+    bool traverse(const Ray &ray, float maxDistance, bool doubleSided, Hit *hit) const;
+
+    ccstd::vector<Node> _nodes;
+    // in leaf order
+    ccstd::vector<TriangleData> _triangles;
+    // in primitive order
+    ccstd::vector<ccstd::array<uint32_t, 3>> _vertexIndices;
+};
+
+} // namespace geometry
+} // namespace cc
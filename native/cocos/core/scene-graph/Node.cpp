@@ -29,6 +29,7 @@
 #include "core/platform/Debug.h"
 #include "core/scene-graph/NodeEnum.h"
 #include "core/scene-graph/Scene.h"
+#include "core/scene-graph/TransformStore.h"
 #include "core/utils/IDGenerator.h"
 #include "math/Utils.h"
 
@@ -65,6 +66,9 @@ Node::Node(const ccstd::string &name) {
 }
 
 Node::~Node() {
+    if (_transformStore) {
+        _transformStore->detach(this);
+    }
     if (!_children.empty()) {
         // Reset children's _parent to nullptr to avoid dangerous pointer
         for (const auto &child : _children) {
@@ -198,6 +202,12 @@ void Node::setParent(Node *parent, bool isKeepWorld /* = false */) {
         _siblingIndex = static_cast<index_t>(newParent->_children.size() - 1);
         newParent->emit<ChildAdded>(this);
     }
+    if (_transformStore) {
+        _transformStore->markHierarchyDirty();
+    }
+    if (newParent && newParent->_transformStore) {
+        newParent->_transformStore->markHierarchyDirty();
+    }
     onHierarchyChanged(oldParent);
 }
 
@@ -261,6 +271,9 @@ bool Node::onPreDestroyBase() {
             _siblingIndex = 0;
             _parent->updateSiblingIndex();
             _parent->emit<ChildRemoved>(this);
+            if (_transformStore) {
+                _transformStore->markHierarchyDirty();
+            }
         }
     }
 
@@ -520,6 +533,10 @@ void Node::invalidateChildren(TransformBit dirtyBit) { // NOLINT(misc-no-recursi
     const uint32_t hasChangedFlags = getChangedFlags();
     const uint32_t transformFlags = _transformFlags;
     if (isValid() && (transformFlags & hasChangedFlags & curDirtyBit) != curDirtyBit) {
+        // Only the topmost invalidated node is queued, its subtree is swept as a whole.
+        if (_transformStore && (!_parent || !_parent->_transformFlags)) {
+            _transformStore->markDirty(_transformStoreIndex);
+        }
         _transformFlags = (transformFlags | curDirtyBit);
         setChangedFlags(hasChangedFlags | curDirtyBit);
 
@@ -867,6 +884,9 @@ void Node::onHierarchyChanged(Node *oldParent) {
 //
 void Node::_setChildren(ccstd::vector<IntrusivePtr<Node>> &&children) {
     _children = std::move(children);
+    if (_transformStore) {
+        _transformStore->markHierarchyDirty();
+    }
 }
 
 void Node::destruct() {
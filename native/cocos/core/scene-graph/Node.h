@@ -42,6 +42,7 @@
 namespace cc {
 
 class Scene;
+class TransformStore;
 /**
  * Event types emitted by Node
  */
@@ -668,8 +669,13 @@ private:
 
     bool _eulerDirty{false};
 
+    // The store which resolves the world transform of this node, if any, and the index of this node in it.
+    TransformStore *_transformStore{nullptr};
+    uint32_t _transformStoreIndex{0};
+
     friend class NodeActivator;
     friend class Scene;
+    friend class TransformStore;
 
     CC_DISALLOW_COPY_MOVE_ASSIGN(Node);
 };
@@ -47,6 +47,21 @@ Scene::~Scene() = default;
 
 void Scene::setSceneGlobals(SceneGlobals *globals) { _globals = globals; }
 
+void Scene::setTransformStoreEnabled(bool val) {
+    if (val == isTransformStoreEnabled()) {
+        return;
+    }
+    if (val) {
+        _ownedTransformStore = std::make_unique<TransformStore>();
+        _ownedTransformStore->rebuild(this);
+    } else {
+        _ownedTransformStore.reset();
+    }
+    if (_renderScene) {
+        _renderScene->setTransformStore(_ownedTransformStore.get());
+    }
+}
+
 void Scene::load() {
     events::SceneLoad::broadcast();
     if (!_inited) {
@@ -104,6 +119,7 @@ bool Scene::destroy() {
         }
     }
 
+    setTransformStoreEnabled(false);
     if (_renderScene != nullptr) {
         Root::getInstance()->destroyScene(_renderScene);
     }
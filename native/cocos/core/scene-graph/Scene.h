@@ -24,7 +24,9 @@
 
 #pragma once
 
+#include <memory>
 #include "core/scene-graph/Node.h"
+#include "core/scene-graph/TransformStore.h"
 
 namespace cc {
 class SceneGlobals;
@@ -45,6 +47,14 @@ public:
     inline bool isAutoReleaseAssets() const { return _autoReleaseAssets; }
     inline void setAutoReleaseAssets(bool val) { _autoReleaseAssets = val; }
 
+    /**
+     * @en Whether world transforms of this scene are resolved through a depth-sorted TransformStore once per frame.
+     * @zh 是否每帧通过按深度排序的 TransformStore 统一计算该场景的世界变换。
+     */
+    void setTransformStoreEnabled(bool val);
+    inline bool isTransformStoreEnabled() const { return _ownedTransformStore != nullptr; }
+    inline TransformStore *getTransformStore() const { return _ownedTransformStore.get(); }
+
     void load();
     void activate(bool active = true);
 
@@ -61,6 +71,7 @@ protected:
      */
     //    @serializable
     IntrusivePtr<SceneGlobals> _globals;
+    std::unique_ptr<TransformStore> _ownedTransformStore;
     bool _inited{false};
 
     /**
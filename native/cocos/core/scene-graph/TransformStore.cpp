@@ -0,0 +1,204 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos.com
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "core/scene-graph/TransformStore.h"
+#include "core/scene-graph/Node.h"
+
+#include <algorithm>
+
+namespace cc {
+
+TransformStore::~TransformStore() {
+    clear();
+}
+
+void TransformStore::rebuild(Node *root) {
+    clear();
+    if (!root) {
+        return;
+    }
+
+    // Depth-first pre-order: parents precede their children and each subtree is contiguous.
+    _root = root;
+    ccstd::vector<Node *> stack{root};
+    ccstd::vector<int32_t> parentStack{-1};
+    while (!stack.empty()) {
+        Node *node = stack.back();
+        const int32_t parent = parentStack.back();
+        stack.pop_back();
+        parentStack.pop_back();
+
+        const auto index = static_cast<uint32_t>(_nodes.size());
+        node->_transformStore = this;
+        node->_transformStoreIndex = index;
+        _nodes.emplace_back(node);
+        _parents.emplace_back(parent);
+
+        const auto &children = node->getChildren();
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            if (*it) {
+                stack.emplace_back(it->get());
+                parentStack.emplace_back(static_cast<int32_t>(index));
+            }
+        }
+    }
+
+    const auto count = static_cast<uint32_t>(_nodes.size());
+    _subtreeEnds.resize(count);
+    for (uint32_t i = count; i-- > 0;) {
+        _subtreeEnds[i] = std::max(_subtreeEnds[i], i + 1);
+        const int32_t parent = _parents[i];
+        if (parent >= 0) {
+            _subtreeEnds[parent] = std::max(_subtreeEnds[parent], _subtreeEnds[i]);
+        }
+    }
+    _dirtyBits.resize(count, 0);
+    _worldMatrices.resize(count);
+    _worldRotations.resize(count);
+    _worldScales.resize(count);
+
+    // Nodes may have been invalidated before they joined the store, sweep everything once.
+    _dirtyRoots.emplace_back(0);
+}
+
+void TransformStore::clear() {
+    for (Node *node : _nodes) {
+        // A node moved to another store may already belong to it.
+        if (node && node->_transformStore == this) {
+            node->_transformStore = nullptr;
+        }
+    }
+    _root = nullptr;
+    _nodes.clear();
+    _parents.clear();
+    _subtreeEnds.clear();
+    _dirtyBits.clear();
+    _worldMatrices.clear();
+    _worldRotations.clear();
+    _worldScales.clear();
+    _dirtyRoots.clear();
+    _hierarchyDirty = false;
+}
+
+void TransformStore::detach(Node *node) {
+    _nodes[node->_transformStoreIndex] = nullptr;
+    node->_transformStore = nullptr;
+    if (node == _root) {
+        _root = nullptr;
+    }
+    _hierarchyDirty = true;
+}
+
+void TransformStore::update() {
+    if (_hierarchyDirty) {
+        rebuild(_root);
+    }
+    _lastSweepSize = 0;
+    if (_dirtyRoots.empty()) {
+        return;
+    }
+
+    // Indices are depth-first, so a dirty root inside an earlier dirty subtree is already covered by its sweep.
+    std::sort(_dirtyRoots.begin(), _dirtyRoots.end());
+    uint32_t end = 0;
+    for (const uint32_t begin : _dirtyRoots) {
+        if (begin < end) {
+            continue;
+        }
+        end = _subtreeEnds[begin];
+        sweep(begin, end);
+        _lastSweepSize += end - begin;
+    }
+    _dirtyRoots.clear();
+}
+
+void TransformStore::sweep(uint32_t begin, uint32_t end) {
+    for (uint32_t i = begin; i < end; ++i) {
+        Node *node = _nodes[i];
+        if (!node) {
+            _dirtyBits[i] = 0;
+            continue;
+        }
+
+        // The parent of the first node lies outside the range and was resolved by an earlier update.
+        const int32_t parent = _parents[i];
+        const bool parentInRange = parent >= static_cast<int32_t>(begin);
+        uint32_t dirtyBits = node->_transformFlags;
+        if (parentInRange) {
+            dirtyBits |= _dirtyBits[parent];
+        }
+        _dirtyBits[i] = dirtyBits;
+
+        Mat4 &worldMatrix = _worldMatrices[i];
+        if (!dirtyBits) {
+            // Clean, or resolved on demand through Node::updateWorldTransform since it was invalidated.
+            worldMatrix.set(node->_worldMatrix);
+            _worldRotations[i] = node->_worldRotation;
+            _worldScales[i] = node->_worldScale;
+            continue;
+        }
+
+        const Vec3 &localPosition = node->_localPosition;
+        if (parent >= 0) {
+            const Mat4 &parentMatrix = _worldMatrices[parent];
+            if (dirtyBits & static_cast<uint32_t>(TransformBit::POSITION)) {
+                Vec3 worldPosition;
+                worldPosition.transformMat4(localPosition, parentMatrix);
+                worldMatrix.m[12] = worldPosition.x;
+                worldMatrix.m[13] = worldPosition.y;
+                worldMatrix.m[14] = worldPosition.z;
+            }
+            if (dirtyBits & static_cast<uint32_t>(TransformBit::RS)) {
+                Mat4::fromRTS(node->_localRotation, localPosition, node->_localScale, &worldMatrix);
+                Mat4::multiply(parentMatrix, worldMatrix, &worldMatrix);
+                const bool rotChanged = dirtyBits & static_cast<uint32_t>(TransformBit::ROTATION);
+                Mat4::toRTS(worldMatrix, rotChanged ? &_worldRotations[i] : nullptr, nullptr, &_worldScales[i]);
+            }
+        } else {
+            if (dirtyBits & static_cast<uint32_t>(TransformBit::POSITION)) {
+                worldMatrix.m[12] = localPosition.x;
+                worldMatrix.m[13] = localPosition.y;
+                worldMatrix.m[14] = localPosition.z;
+            }
+            if (dirtyBits & static_cast<uint32_t>(TransformBit::RS)) {
+                if (dirtyBits & static_cast<uint32_t>(TransformBit::ROTATION)) {
+                    _worldRotations[i] = node->_localRotation;
+                }
+                if (dirtyBits & static_cast<uint32_t>(TransformBit::SCALE)) {
+                    _worldScales[i] = node->_localScale;
+                    Mat4::fromRTS(_worldRotations[i], localPosition, _worldScales[i], &worldMatrix);
+                }
+            }
+        }
+
+        node->_worldMatrix.set(worldMatrix);
+        node->_worldPosition.set(worldMatrix.m[12], worldMatrix.m[13], worldMatrix.m[14]);
+        node->_worldRotation = _worldRotations[i];
+        node->_worldScale = _worldScales[i];
+        node->_transformFlags = static_cast<uint32_t>(TransformBit::NONE);
+    }
+}
+
+} // namespace cc
@@ -0,0 +1,103 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos.com
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#include "base/Macros.h"
+#include "base/std/container/vector.h"
+#include "math/Mat4.h"
+#include "math/Quaternion.h"
+#include "math/Vec3.h"
+
+namespace cc {
+
+class Node;
+
+/**
+ * @en Structure-of-arrays store of the world transforms of a node hierarchy, laid out depth-first so that every
+ * parent precedes its children and every subtree is a contiguous range. Nodes of the hierarchy report their
+ * invalidation and reparenting to the store, so an update only sweeps the ranges of the subtrees that changed,
+ * and a hierarchy change only relayouts this store. After update() the store holds the world transform of every
+ * node and the nodes have been brought up to date from it.
+ * @zh 节点层级世界变换的 SoA 存储，按深度优先排列：父节点总在子节点之前，每棵子树是一段连续区间。层级中的节点会把失效和
+ * 父子关系变化通知给存储，因此每次更新只遍历发生变化的子树区间，层级变化也只会让本存储重新布局。update() 之后存储持有所有
+ * 节点的世界变换，节点也已从中同步。
+ */
+class TransformStore final {
+public:
+    TransformStore() = default;
+    ~TransformStore();
+
+    /**
+     * @en Lay out the hierarchy under root, root included.
+     * @zh 布局 root（包含 root）下的节点层级。
+     */
+    void rebuild(Node *root);
+    void clear();
+
+    /**
+     * @en Resolve the world transforms of the subtrees invalidated since the last update. Relayouts first if the
+     * hierarchy changed.
+     * @zh 计算自上次更新以来失效的子树的世界变换。若层级发生变化，会先重新布局。
+     */
+    void update();
+
+    inline uint32_t size() const { return static_cast<uint32_t>(_nodes.size()); }
+    inline Node *getRoot() const { return _root; }
+    inline const ccstd::vector<Mat4> &getWorldMatrices() const { return _worldMatrices; }
+
+    /**
+     * @en Number of nodes visited by the last update, the size of the invalidated subtrees.
+     * @zh 上一次更新遍历的节点数，即失效子树的大小。
+     */
+    inline uint32_t getLastSweepSize() const { return _lastSweepSize; }
+
+private:
+    // Called by the nodes of the hierarchy.
+    inline void markDirty(uint32_t index) { _dirtyRoots.emplace_back(index); }
+    inline void markHierarchyDirty() { _hierarchyDirty = true; }
+    void detach(Node *node);
+
+    void sweep(uint32_t begin, uint32_t end);
+
+    // Nodes are not retained, destroyed nodes detach themselves.
+    Node *_root{nullptr};
+    ccstd::vector<Node *> _nodes;
+    ccstd::vector<int32_t> _parents;
+    ccstd::vector<uint32_t> _subtreeEnds;
+    ccstd::vector<uint32_t> _dirtyBits;
+    ccstd::vector<Mat4> _worldMatrices;
+    ccstd::vector<Quaternion> _worldRotations;
+    ccstd::vector<Vec3> _worldScales;
+    ccstd::vector<uint32_t> _dirtyRoots;
+    uint32_t _lastSweepSize{0};
+    bool _hierarchyDirty{false};
+
+    friend class Node;
+
+    CC_DISALLOW_COPY_MOVE_ASSIGN(TransformStore);
+};
+
+} // namespace cc
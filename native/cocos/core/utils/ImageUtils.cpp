@@ -23,8 +23,18 @@
 ****************************************************************************/
 
 #include "core/utils/ImageUtils.h"
+#include <algorithm>
 #include "base/Log.h"
 #include "renderer/gfx-base/GFXDef-common.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define CC_IMAGE_UTILS_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define CC_IMAGE_UTILS_NEON
+#endif
+
 namespace {
 uint8_t *convertRGB2RGBA(uint32_t length, uint8_t *src) {
     auto *dst = reinterpret_cast<uint8_t *>(malloc(length));
@@ -58,6 +68,71 @@ uint8_t *convertI2RGBA(uint32_t length, uint8_t *src) {
     }
     return dst;
 }
+// round(c * a / 255) without a division
+inline uint8_t premultiply(uint32_t c, uint32_t a) {
+    const uint32_t t = c * a + 128;
+    return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+}
+
+// average of four samples, rounded to nearest
+inline uint8_t average(uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+    return static_cast<uint8_t>((a + b + c + d + 2) >> 2);
+}
+
+void downsampleRow(const uint8_t *row0, const uint8_t *row1, uint8_t *dst, uint32_t first, uint32_t dstWidth, uint32_t srcWidth) {
+    for (uint32_t x = first; x < dstWidth; ++x) {
+        const uint32_t x0 = x * 2;
+        const uint32_t x1 = std::min(x0 + 1, srcWidth - 1);
+        for (uint32_t c = 0; c < 4; ++c) {
+            dst[x * 4 + c] = average(row0[x0 * 4 + c], row0[x1 * 4 + c], row1[x0 * 4 + c], row1[x1 * 4 + c]);
+        }
+    }
+}
+
+// Four destination pixels from eight pixels of two source rows, returns how many pixels were done.
+uint32_t downsampleRowSIMD(const uint8_t *row0, const uint8_t *row1, uint8_t *dst, uint32_t dstWidth) {
+    uint32_t x = 0;
+#if defined(CC_IMAGE_UTILS_SSE)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two = _mm_set1_epi16(2);
+    for (; x + 4 <= dstWidth; x += 4) {
+        __m128i sums[2];
+        for (uint32_t half = 0; half < 2; ++half) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0 + x * 8 + half * 16));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + x * 8 + half * 16));
+            // vertical pairs, two pixels per register
+            const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+            // horizontal pairs
+            const __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+            sums[half] = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4), _mm_packus_epi16(sums[0], sums[1]));
+    }
+#elif defined(CC_IMAGE_UTILS_NEON)
+    for (; x + 4 <= dstWidth; x += 4) {
+        uint8x8_t halves[2];
+        for (uint32_t half = 0; half < 2; ++half) {
+            const uint8x16_t a = vld1q_u8(row0 + x * 8 + half * 16);
+            const uint8x16_t b = vld1q_u8(row1 + x * 8 + half * 16);
+            const uint16x8_t lo = vaddl_u8(vget_low_u8(a), vget_low_u8(b));
+            const uint16x8_t hi = vaddl_u8(vget_high_u8(a), vget_high_u8(b));
+            const uint16x8_t sum = vaddq_u16(vcombine_u16(vget_low_u16(lo), vget_low_u16(hi)),
+                                             vcombine_u16(vget_high_u16(lo), vget_high_u16(hi)));
+            // (sum + 2) >> 2
+            halves[half] = vrshrn_n_u16(sum, 2);
+        }
+        vst1q_u8(dst + x * 4, vcombine_u8(halves[0], halves[1]));
+    }
+#else
+    CC_UNUSED_PARAM(row0);
+    CC_UNUSED_PARAM(row1);
+    CC_UNUSED_PARAM(dst);
+    CC_UNUSED_PARAM(dstWidth);
+#endif
+    return x;
+}
+
 } // namespace
 
 namespace cc {
@@ -90,4 +165,77 @@ void ImageUtils::convert2RGBA(Image *image) {
     }
 }
 
+void ImageUtils::premultiplyAlpha(uint8_t *rgba, uint32_t pixelCount) {
+    uint32_t i = 0;
+#if defined(CC_IMAGE_UTILS_SSE)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i half = _mm_set1_epi16(128);
+    const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+    for (; i + 4 <= pixelCount; i += 4) {
+        auto *p = reinterpret_cast<__m128i *>(rgba + i * 4);
+        const __m128i pixels = _mm_loadu_si128(p);
+        __m128i channels[2] = {_mm_unpacklo_epi8(pixels, zero), _mm_unpackhi_epi8(pixels, zero)};
+        for (auto &c : channels) {
+            // alpha of each pixel in all of its lanes
+            const __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+            const __m128i t = _mm_add_epi16(_mm_mullo_epi16(c, alpha), half);
+            c = _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+        }
+        const __m128i colors = _mm_packus_epi16(channels[0], channels[1]);
+        _mm_storeu_si128(p, _mm_or_si128(_mm_andnot_si128(alphaMask, colors), _mm_and_si128(alphaMask, pixels)));
+    }
+#elif defined(CC_IMAGE_UTILS_NEON)
+    const uint16x8_t half = vdupq_n_u16(128);
+    for (; i + 8 <= pixelCount; i += 8) {
+        uint8x8x4_t pixels = vld4_u8(rgba + i * 4);
+        for (uint32_t c = 0; c < 3; ++c) {
+            const uint16x8_t t = vaddq_u16(vmull_u8(pixels.val[c], pixels.val[3]), half);
+            pixels.val[c] = vshrn_n_u16(vaddq_u16(t, vshrq_n_u16(t, 8)), 8);
+        }
+        vst4_u8(rgba + i * 4, pixels);
+    }
+#endif
+    for (; i < pixelCount; ++i) {
+        uint8_t *p = rgba + i * 4;
+        p[0] = premultiply(p[0], p[3]);
+        p[1] = premultiply(p[1], p[3]);
+        p[2] = premultiply(p[2], p[3]);
+    }
+}
+
+uint32_t ImageUtils::getMipmapChainSize(uint32_t width, uint32_t height) {
+    uint32_t size = 0;
+    while (true) {
+        size += width * height * 4;
+        if (width == 1 && height == 1) {
+            break;
+        }
+        width = std::max(width / 2, 1U);
+        height = std::max(height / 2, 1U);
+    }
+    return size;
+}
+
+void ImageUtils::generateMipmaps(uint8_t *rgba, uint32_t width, uint32_t height, ccstd::vector<uint32_t> *levelDataSize) {
+    uint8_t *src = rgba;
+    levelDataSize->push_back(width * height * 4);
+    while (width > 1 || height > 1) {
+        const uint32_t dstWidth = std::max(width / 2, 1U);
+        const uint32_t dstHeight = std::max(height / 2, 1U);
+        uint8_t *dst = src + width * height * 4;
+        for (uint32_t y = 0; y < dstHeight; ++y) {
+            const uint8_t *row0 = src + y * 2 * width * 4;
+            const uint8_t *row1 = src + std::min(y * 2 + 1, height - 1) * width * 4;
+            uint8_t *dstRow = dst + y * dstWidth * 4;
+            // the vector path needs both source columns of every pixel
+            const uint32_t done = width > 1 ? downsampleRowSIMD(row0, row1, dstRow, dstWidth) : 0;
+            downsampleRow(row0, row1, dstRow, done, dstWidth, width);
+        }
+        levelDataSize->push_back(dstWidth * dstHeight * 4);
+        src = dst;
+        width = dstWidth;
+        height = dstHeight;
+    }
+}
+
 } // namespace cc
\ No newline at end of file
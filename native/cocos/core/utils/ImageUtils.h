@@ -24,12 +24,27 @@
 
 #pragma once
 
+#include <cstdint>
+#include "base/std/container/vector.h"
 #include "cocos/platform/Image.h"
 
 namespace cc {
 class ImageUtils {
 public:
     static void convert2RGBA(Image *image);
+
+    // Multiplies the color channels of RGBA8 pixels by their alpha, rounding to nearest.
+    static void premultiplyAlpha(uint8_t *rgba, uint32_t pixelCount);
+
+    // Bytes taken by an RGBA8 image and all its mipmap levels down to 1x1.
+    static uint32_t getMipmapChainSize(uint32_t width, uint32_t height);
+
+    /**
+     * Writes the mipmap chain of the RGBA8 image at the start of rgba right after it, each level a 2x2 box
+     * filter of the previous one. rgba must hold getMipmapChainSize bytes. The byte size of every level,
+     * the base level included, is appended to levelDataSize.
+     */
+    static void generateMipmaps(uint8_t *rgba, uint32_t width, uint32_t height, ccstd::vector<uint32_t> *levelDataSize);
 };
 
 } // namespace cc
\ No newline at end of file
@@ -0,0 +1,261 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#include "FrameCacheBudget.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "profiler/Profiler.h"
+
+MIDDLEWARE_BEGIN
+
+namespace {
+constexpr float QUANTIZE_MAX = 65535.0F;
+} // namespace
+
+void PackedFrameBuffers::pack(IOBuffer &vb, IOBuffer &ib, uint32_t colorCount) {
+    clear();
+
+    // stride in 32 bits words
+    const uint32_t stride = ATTRIBUTE_COUNT + colorCount;
+    const auto *src = reinterpret_cast<const float *>(vb.getBuffer());
+    const auto *srcWords = reinterpret_cast<const uint32_t *>(vb.getBuffer());
+    _colorCount = colorCount;
+    _vertexCount = static_cast<uint32_t>(vb.getCurPos() / (stride * sizeof(uint32_t)));
+
+    float maxValue[ATTRIBUTE_COUNT];
+    for (uint32_t a = 0; a < ATTRIBUTE_COUNT; ++a) {
+        _min[a] = _vertexCount > 0 ? std::numeric_limits<float>::max() : 0.0F;
+        maxValue[a] = _vertexCount > 0 ? std::numeric_limits<float>::lowest() : 0.0F;
+    }
+    for (uint32_t v = 0; v < _vertexCount; ++v) {
+        const float *vertex = src + v * stride;
+        for (uint32_t a = 0; a < ATTRIBUTE_COUNT; ++a) {
+            _min[a] = std::min(_min[a], vertex[a]);
+            maxValue[a] = std::max(maxValue[a], vertex[a]);
+        }
+    }
+
+    float scale[ATTRIBUTE_COUNT];
+    for (uint32_t a = 0; a < ATTRIBUTE_COUNT; ++a) {
+        float range = maxValue[a] - _min[a];
+        _step[a] = range > 0.0F ? range / QUANTIZE_MAX : 0.0F;
+        scale[a] = range > 0.0F ? QUANTIZE_MAX / range : 0.0F;
+    }
+
+    _attributes.resize(static_cast<std::size_t>(_vertexCount) * ATTRIBUTE_COUNT);
+    uint16_t *dst = _attributes.data();
+    std::size_t runPos = 0;
+    for (uint32_t v = 0; v < _vertexCount; ++v) {
+        const float *vertex = src + v * stride;
+        for (uint32_t a = 0; a < ATTRIBUTE_COUNT; ++a) {
+            float quantized = std::round((vertex[a] - _min[a]) * scale[a]);
+            *dst++ = static_cast<uint16_t>(std::min(std::max(quantized, 0.0F), QUANTIZE_MAX));
+        }
+
+        const uint32_t *colors = srcWords + v * stride + ATTRIBUTE_COUNT;
+        if (v == 0 || memcmp(colors, colors - stride, colorCount * sizeof(uint32_t)) != 0) {
+            runPos = _colorRuns.size();
+            _colorRuns.push_back(0);
+            _colorRuns.insert(_colorRuns.end(), colors, colors + colorCount);
+        }
+        _colorRuns[runPos]++;
+    }
+    _colorRuns.shrink_to_fit();
+
+    const auto *indices = reinterpret_cast<const uint16_t *>(ib.getBuffer());
+    _indices.assign(indices, indices + ib.getCurPos() / sizeof(uint16_t));
+
+    vb.release();
+    ib.release();
+}
+
+void PackedFrameBuffers::unpack(IOBuffer &vb, IOBuffer &ib) {
+    const uint32_t stride = ATTRIBUTE_COUNT + _colorCount;
+    const std::size_t vertexBytes = static_cast<std::size_t>(_vertexCount) * stride * sizeof(uint32_t);
+    const std::size_t indexBytes = _indices.size() * sizeof(uint16_t);
+
+    vb.reset();
+    vb.resize(vertexBytes, false);
+    auto *dst = reinterpret_cast<float *>(vb.getBuffer());
+    auto *dstWords = reinterpret_cast<uint32_t *>(vb.getBuffer());
+    const uint16_t *src = _attributes.data();
+    for (uint32_t v = 0; v < _vertexCount; ++v) {
+        float *vertex = dst + v * stride;
+        for (uint32_t a = 0; a < ATTRIBUTE_COUNT; ++a) {
+            vertex[a] = _min[a] + static_cast<float>(*src++) * _step[a];
+        }
+    }
+
+    uint32_t v = 0;
+    for (std::size_t pos = 0, n = _colorRuns.size(); pos < n; pos += 1 + _colorCount) {
+        const uint32_t *colors = _colorRuns.data() + pos + 1;
+        for (uint32_t end = v + _colorRuns[pos]; v < end; ++v) {
+            memcpy(dstWords + v * stride + ATTRIBUTE_COUNT, colors, _colorCount * sizeof(uint32_t));
+        }
+    }
+    vb.move(static_cast<int>(vertexBytes));
+
+    ib.reset();
+    ib.resize(indexBytes, false);
+    ib.writeBytes(reinterpret_cast<const char *>(_indices.data()), indexBytes);
+
+    clear();
+}
+
+void PackedFrameBuffers::clear() {
+    _colorCount = 0;
+    _vertexCount = 0;
+    ccstd::vector<uint16_t>().swap(_attributes);
+    ccstd::vector<uint32_t>().swap(_colorRuns);
+    ccstd::vector<uint16_t>().swap(_indices);
+}
+
+std::size_t PackedFrameBuffers::getByteSize() const {
+    return _attributes.capacity() * sizeof(uint16_t) + _colorRuns.capacity() * sizeof(uint32_t) + _indices.capacity() * sizeof(uint16_t);
+}
+
+FrameCacheEntry::FrameCacheEntry() {
+    FrameCacheBudget::getInstance()->addEntry(this);
+}
+
+FrameCacheEntry::~FrameCacheEntry() {
+    if (auto *budget = FrameCacheBudget::instance) {
+        budget->onEntryBytesChanged(_cacheBytes, 0);
+        budget->removeEntry(this);
+    }
+}
+
+void FrameCacheEntry::setStatName(const ccstd::string &name) {
+    _statName = name;
+    if (auto *budget = FrameCacheBudget::instance) {
+        budget->_statsDirty = true;
+    }
+}
+
+void FrameCacheEntry::touch() {
+    if (auto *budget = FrameCacheBudget::instance) {
+        _lastUsedFrame = budget->_frame;
+    }
+    if (_packed) {
+        _packed = false;
+        setCacheBytes(unpackFrames());
+    }
+}
+
+void FrameCacheEntry::setCacheBytes(std::size_t bytes) {
+    if (auto *budget = FrameCacheBudget::instance) {
+        budget->onEntryBytesChanged(_cacheBytes, bytes);
+    }
+    _cacheBytes = bytes;
+}
+
+void FrameCacheEntry::clearCache() {
+    _packed = false;
+    setCacheBytes(0);
+}
+
+FrameCacheBudget *FrameCacheBudget::instance = nullptr;
+
+void FrameCacheBudget::addEntry(FrameCacheEntry *entry) {
+    entry->_lastUsedFrame = _frame;
+    _entries.push_back(entry);
+}
+
+void FrameCacheBudget::removeEntry(FrameCacheEntry *entry) {
+    auto it = std::find(_entries.begin(), _entries.end(), entry);
+    if (it != _entries.end()) {
+        *it = _entries.back();
+        _entries.pop_back();
+    }
+    _statsDirty = true;
+}
+
+void FrameCacheBudget::onEntryBytesChanged(std::size_t oldBytes, std::size_t newBytes) {
+    _usedBytes = _usedBytes - oldBytes + newBytes;
+    _statsDirty |= oldBytes != newBytes;
+}
+
+void FrameCacheBudget::update() {
+    // entries used in this frame may still be referenced by the renderer
+    _candidates.clear();
+    for (auto *entry : _entries) {
+        if (entry->_lastUsedFrame != _frame && entry->_cacheBytes > 0 && entry->isEvictable()) {
+            _candidates.push_back(entry);
+        }
+    }
+    std::sort(_candidates.begin(), _candidates.end(), [this](const FrameCacheEntry *lhs, const FrameCacheEntry *rhs) {
+        return _frame - lhs->_lastUsedFrame > _frame - rhs->_lastUsedFrame;
+    });
+
+    for (auto *entry : _candidates) {
+        if (entry->_packed || !entry->isPackable()) {
+            continue;
+        }
+        if (_usedBytes > _budget || _frame - entry->_lastUsedFrame >= PACK_AFTER_FRAMES) {
+            entry->_packed = true;
+            entry->setCacheBytes(entry->packFrames());
+        }
+    }
+
+    for (auto *entry : _candidates) {
+        if (_usedBytes <= _budget) {
+            break;
+        }
+        entry->_packed = false;
+        entry->setCacheBytes(entry->releaseFrames());
+    }
+
+    reportStats();
+    ++_frame;
+}
+
+void FrameCacheBudget::reportStats() {
+#if CC_USE_PROFILER
+    CC_PROFILE_MEMORY_UPDATE(MiddlewareFrameCache, _usedBytes);
+    if (!_statsDirty || !CC_PROFILER) {
+        return;
+    }
+
+    for (auto &stat : _stats) {
+        stat.second = 0;
+    }
+    for (auto *entry : _entries) {
+        if (!entry->_statName.empty()) {
+            _stats[entry->_statName] += entry->_cacheBytes;
+        }
+    }
+
+    auto &memoryStats = CC_PROFILER->getMemoryStats();
+    for (auto it = _stats.begin(); it != _stats.end();) {
+        memoryStats.update(it->first, it->second);
+        // reported as empty once, skeletons without frames are not listed afterwards
+        it = it->second == 0 ? _stats.erase(it) : std::next(it);
+    }
+#endif
+    _statsDirty = false;
+}
+
+MIDDLEWARE_END
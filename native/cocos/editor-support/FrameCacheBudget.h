@@ -0,0 +1,168 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include "IOBuffer.h"
+#include "MiddlewareMacro.h"
+#include "base/std/container/string.h"
+#include "base/std/container/unordered_map.h"
+#include "base/std/container/vector.h"
+
+MIDDLEWARE_BEGIN
+
+/**
+ * Compact storage of a baked frame's vertex and index buffers.
+ * Vertices are laid out as xyz, uv and then colorCount 32 bits colors (V3F_T2F_C4B or V3F_T2F_C4B_C4B).
+ * Positions and texture coordinates are quantized to 16 bits over the frame bounds,
+ * colors are delta coded: a color tuple is only stored where it differs from the previous vertex.
+ */
+class PackedFrameBuffers {
+public:
+    /**
+     * @brief Pack the written part of vb and ib, and release both buffers.
+     */
+    void pack(IOBuffer &vb, IOBuffer &ib, uint32_t colorCount);
+    /**
+     * @brief Restore vb and ib, and release the packed storage.
+     */
+    void unpack(IOBuffer &vb, IOBuffer &ib);
+    void clear();
+
+    bool empty() const { return _vertexCount == 0 && _indices.empty(); }
+    std::size_t getByteSize() const;
+
+    static constexpr uint32_t ATTRIBUTE_COUNT = 5;
+
+private:
+    uint32_t _colorCount = 0;
+    uint32_t _vertexCount = 0;
+    float _min[ATTRIBUTE_COUNT]{};
+    float _step[ATTRIBUTE_COUNT]{};
+    ccstd::vector<uint16_t> _attributes;
+    // run length followed by colorCount colors, for each run of identical colors
+    ccstd::vector<uint32_t> _colorRuns;
+    ccstd::vector<uint16_t> _indices;
+};
+
+/**
+ * Baked animation frames which take part in the shared frame cache budget.
+ * Derived classes hold the frames and know how to pack, unpack and release them.
+ */
+class FrameCacheEntry {
+public:
+    FrameCacheEntry();
+    virtual ~FrameCacheEntry();
+
+    std::size_t getCacheBytes() const { return _cacheBytes; }
+    bool isPacked() const { return _packed; }
+
+    /**
+     * @brief Name of the memory stat the entry is reported under, usually one per skeleton.
+     */
+    void setStatName(const ccstd::string &name);
+    const ccstd::string &getStatName() const { return _statName; }
+
+protected:
+    /**
+     * @brief Mark the entry as used in this frame, unpack it first if it was packed.
+     */
+    void touch();
+    void setCacheBytes(std::size_t bytes);
+    // Called when the frames were dropped by the owner.
+    void clearCache();
+
+    // Whether the budget may pack the frames now, usually once the animation is fully baked.
+    virtual bool isPackable() const = 0;
+    // Whether the budget may touch the frames at all, false while they are being baked.
+    virtual bool isEvictable() const = 0;
+    // Following return the new byte size of the frames.
+    virtual std::size_t packFrames() = 0;
+    virtual std::size_t unpackFrames() = 0;
+    virtual std::size_t releaseFrames() = 0;
+
+private:
+    friend class FrameCacheBudget;
+
+    ccstd::string _statName;
+    std::size_t _cacheBytes = 0;
+    uint32_t _lastUsedFrame = 0;
+    bool _packed = false;
+};
+
+/**
+ * Global byte budget shared by all baked skeleton and armature frames.
+ * Entries left unused are packed first, then released in least recently used order
+ * until the cache fits in the budget again.
+ */
+class FrameCacheBudget {
+public:
+    static FrameCacheBudget *getInstance() {
+        if (instance == nullptr) {
+            instance = new FrameCacheBudget();
+        }
+        return instance;
+    }
+
+    static void destroyInstance() {
+        if (instance) {
+            delete instance;
+            instance = nullptr;
+        }
+    }
+
+    static constexpr std::size_t DEFAULT_BUDGET = 64 * 1024 * 1024;
+    // Entries unused for this many frames are packed even below the budget.
+    static constexpr uint32_t PACK_AFTER_FRAMES = 300;
+
+    void setBudget(std::size_t bytes) { _budget = bytes; }
+    std::size_t getBudget() const { return _budget; }
+    std::size_t getUsedBytes() const { return _usedBytes; }
+
+    /**
+     * @brief Pack and evict cold entries, called once per frame after all frames were rendered.
+     */
+    void update();
+
+private:
+    friend class FrameCacheEntry;
+
+    void addEntry(FrameCacheEntry *entry);
+    void removeEntry(FrameCacheEntry *entry);
+    void onEntryBytesChanged(std::size_t oldBytes, std::size_t newBytes);
+    void reportStats();
+
+    static FrameCacheBudget *instance;
+
+    ccstd::vector<FrameCacheEntry *> _entries;
+    ccstd::vector<FrameCacheEntry *> _candidates;
+    ccstd::unordered_map<ccstd::string, std::size_t> _stats;
+    std::size_t _budget = DEFAULT_BUDGET;
+    std::size_t _usedBytes = 0;
+    uint32_t _frame = 0;
+    bool _statsDirty = false;
+};
+
+MIDDLEWARE_END
@@ -146,6 +146,18 @@ public:
         memset(_buffer, 0, _bufferSize);
     }
 
+    /**
+     * @brief Free the storage, it grows again on the next checkSpace.
+     */
+    inline void release() {
+        delete[] _buffer;
+        _buffer = nullptr;
+        _bufferSize = 0;
+        _curPos = 0;
+        _readPos = 0;
+        _outRange = false;
+    }
+
     inline void move(int pos) {
         if (_bufferSize < _curPos + pos) {
             _outRange = true;
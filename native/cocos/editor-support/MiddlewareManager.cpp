@@ -25,11 +25,36 @@
 #include "MiddlewareManager.h"
 #include <algorithm>
 #include "2d/renderer/Batcher2d.h"
+#include "FrameCacheBudget.h"
 #include "SeApi.h"
+#include "base/job-system/JobSystem.h"
 #include "core/Root.h"
 
 MIDDLEWARE_BEGIN
 
+namespace {
+// Below this count the job dispatch costs more than evaluating the poses or emitting the vertices on this thread.
+constexpr size_t PARALLEL_UPDATE_MIN_COUNT = 16;
+
+template <typename F>
+void forEachParallelly(const ccstd::vector<IMiddleware *> &editors, F &&func) {
+    auto *jobSystem = JobSystem::getInstance();
+    if (editors.size() >= PARALLEL_UPDATE_MIN_COUNT && jobSystem->threadCount() > 1) {
+        JobGraph g(jobSystem);
+        g.createForEachIndexJob(0U, static_cast<uint32_t>(editors.size()), 1U, [&](uint32_t i) {
+            func(editors[i]);
+        });
+        g.run();
+        g.waitForAll();
+    } else {
+        for (auto *editor : editors) {
+            func(editor);
+        }
+    }
+}
+
+} // namespace
+
 MiddlewareManager *MiddlewareManager::instance = nullptr;
 
 MiddlewareManager::MiddlewareManager() : _renderInfo(se::Object::TypedArrayType::UINT32),
@@ -54,18 +79,24 @@ MeshBuffer *MiddlewareManager::getMeshBuffer(int format) {
     return mb;
 }
 
-void MiddlewareManager::clearRemoveList() {
-    for (auto *editor : _removeList) {
-        auto it = std::find(_updateList.begin(), _updateList.end(), editor);
-        if (it != _updateList.end()) {
-            _updateList.erase(it);
-        }
+void MiddlewareManager::compactUpdateList() {
+    if (_tombstoneCount == 0) {
+        return;
     }
 
-    _removeList.clear();
+    uint32_t count = 0;
+    for (auto *editor : _updateList) {
+        if (editor) {
+            _updateIndices[editor] = count;
+            _updateList[count++] = editor;
+        }
+    }
+    _updateList.resize(count);
+    _tombstoneCount = 0;
 }
 
 void MiddlewareManager::update(float dt) {
+    compactUpdateList();
     isUpdating = true;
 
     _attachInfo.reset();
@@ -74,20 +105,57 @@ void MiddlewareManager::update(float dt) {
         attachBuffer->writeUint32(0);
     }
 
-    for (auto *editor : _updateList) {
-        if (!_removeList.empty()) {
-            auto removeIt = std::find(_removeList.begin(), _removeList.end(), editor);
-            if (removeIt == _removeList.end()) {
+    if (_parallelUpdateEnabled) {
+        updateParallelly(dt);
+    } else {
+        // Editors added during the traversal start updating in the next frame.
+        for (size_t i = 0, n = _updateList.size(); i < n; ++i) {
+            if (auto *editor = _updateList[i]) {
                 editor->update(dt);
             }
-        } else {
-            editor->update(dt);
         }
     }
 
     isUpdating = false;
 
-    clearRemoveList();
+    compactUpdateList();
+}
+
+void MiddlewareManager::updateParallelly(float dt) {
+    _poseList.clear();
+    for (size_t i = 0, n = _updateList.size(); i < n; ++i) {
+        auto *editor = _updateList[i];
+        if (editor && editor->preUpdate(dt)) {
+            _poseList.push_back(editor);
+        }
+    }
+
+    // Callbacks raised by preUpdate may have removed editors which were collected already.
+    _poseList.erase(std::remove_if(_poseList.begin(), _poseList.end(), [this](IMiddleware *editor) { return !isRegistered(editor); }), _poseList.end());
+
+    forEachParallelly(_poseList, [](IMiddleware *editor) { editor->updatePose(); });
+
+    for (auto *editor : _poseList) {
+        if (isRegistered(editor)) {
+            editor->postUpdate();
+        }
+    }
+}
+
+void MiddlewareManager::emitVerticesParallelly() {
+    // Too few instances to amortize the dispatch, render emits their vertices directly.
+    if (_updateList.size() - _tombstoneCount < PARALLEL_UPDATE_MIN_COUNT) {
+        return;
+    }
+
+    _emitList.clear();
+    for (auto *editor : _updateList) {
+        if (editor && editor->prepareVertices()) {
+            _emitList.push_back(editor);
+        }
+    }
+
+    forEachParallelly(_emitList, [](IMiddleware *editor) { editor->emitVertices(); });
 }
 
 void MiddlewareManager::render(float dt) {
@@ -100,13 +168,12 @@ void MiddlewareManager::render(float dt) {
 
     isRendering = true;
 
-    for (auto *editor : _updateList) {
-        if (!_removeList.empty()) {
-            auto removeIt = std::find(_removeList.begin(), _removeList.end(), editor);
-            if (removeIt == _removeList.end()) {
-                editor->render(dt);
-            }
-        } else {
+    if (_parallelUpdateEnabled) {
+        emitVerticesParallelly();
+    }
+
+    for (size_t i = 0, n = _updateList.size(); i < n; ++i) {
+        if (auto *editor = _updateList[i]) {
             editor->render(dt);
         }
     }
@@ -133,31 +200,31 @@ void MiddlewareManager::render(float dt) {
         batch2d->syncMeshBuffersToNative(accID, std::move(uiMeshArray));
     }
 
-    clearRemoveList();
+    // baked frames used in this frame have been copied, cold ones may be packed or evicted now
+    FrameCacheBudget::getInstance()->update();
+
+    compactUpdateList();
 }
 
 void MiddlewareManager::addTimer(IMiddleware *editor) {
-    auto it0 = std::find(_updateList.begin(), _updateList.end(), editor);
-    if (it0 != _updateList.end()) {
+    if (isRegistered(editor)) {
         return;
     }
 
-    auto it1 = std::find(_removeList.begin(), _removeList.end(), editor);
-    if (it1 != _removeList.end()) {
-        _removeList.erase(it1);
-    }
+    _updateIndices[editor] = static_cast<uint32_t>(_updateList.size());
     _updateList.push_back(editor);
 }
 
 void MiddlewareManager::removeTimer(IMiddleware *editor) {
-    if (isUpdating || isRendering) {
-        _removeList.push_back(editor);
-    } else {
-        auto it = std::find(_updateList.begin(), _updateList.end(), editor);
-        if (it != _updateList.end()) {
-            _updateList.erase(it);
-        }
+    auto it = _updateIndices.find(editor);
+    if (it == _updateIndices.end()) {
+        return;
     }
+
+    // Compacted at the beginning of the next update, traversals skip tombstones.
+    _updateList[it->second] = nullptr;
+    _updateIndices.erase(it);
+    ++_tombstoneCount;
 }
 
 se_object_ptr MiddlewareManager::getVBTypedArray(int format, int bufferPos) {
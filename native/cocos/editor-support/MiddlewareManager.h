@@ -30,6 +30,7 @@
 #include "MiddlewareMacro.h"
 #include "SharedBufferManager.h"
 #include "base/RefCounted.h"
+#include "base/std/container/unordered_map.h"
 
 MIDDLEWARE_BEGIN
 
@@ -42,6 +43,30 @@ public:
     virtual ~IMiddleware() = default;
     virtual void update(float dt) = 0;
     virtual void render(float dt) = 0;
+
+    /**
+     * Two-phase update used by MiddlewareManager when parallel update is enabled.
+     * preUpdate and postUpdate are invoked serially in registration order, updatePose may run
+     * on a JobSystem worker concurrently with other instances, so it must only touch state owned
+     * by this instance and must not call into script.
+     * @return Whether updatePose and postUpdate should be invoked, the default does the whole update here.
+     */
+    virtual bool preUpdate(float dt) {
+        update(dt);
+        return false;
+    }
+    virtual void updatePose() {}
+    virtual void postUpdate() {}
+
+    /**
+     * Two-phase render used by MiddlewareManager when parallel update is enabled.
+     * prepareVertices is invoked serially, emitVertices may run on a JobSystem worker and fills vertex
+     * segments owned by this instance, render then stitches them into the shared MeshBuffers in
+     * registration order.
+     * @return Whether emitVertices should be invoked, the default emits the vertices in render.
+     */
+    virtual bool prepareVertices() { return false; }
+    virtual void emitVertices() {}
 };
 
 /**
@@ -94,6 +119,13 @@ public:
      */
     void removeTimer(IMiddleware *editor);
 
+    /**
+     * @brief Evaluates skeleton poses and emits vertices of all middleware on the JobSystem,
+     * see IMiddleware::preUpdate and IMiddleware::prepareVertices.
+     */
+    void setParallelUpdateEnabled(bool val) { _parallelUpdateEnabled = val; }
+    bool isParallelUpdateEnabled() const { return _parallelUpdateEnabled; }
+
     MeshBuffer *getMeshBuffer(int format);
 
     se_object_ptr getVBTypedArray(int format, int bufferPos);
@@ -113,10 +145,18 @@ public:
     bool isUpdating = false;
 
 private:
-    void clearRemoveList();
+    void updateParallelly(float dt);
+    void emitVerticesParallelly();
+    void compactUpdateList();
+    bool isRegistered(IMiddleware *editor) const { return _updateIndices.count(editor) != 0; }
 
+    // Removed editors are tombstoned as nullptr and compacted once nothing traverses the list.
     ccstd::vector<IMiddleware *> _updateList;
-    ccstd::vector<IMiddleware *> _removeList;
+    ccstd::unordered_map<IMiddleware *, uint32_t> _updateIndices;
+    uint32_t _tombstoneCount{0};
+    ccstd::vector<IMiddleware *> _poseList;
+    ccstd::vector<IMiddleware *> _emitList;
+    bool _parallelUpdateEnabled{false};
     std::map<int, MeshBuffer *> _mbMap;
 
     SharedBufferManager _renderInfo;
@@ -25,6 +25,7 @@
 #include "CCFactory.h"
 #include "base/TypeDef.h"
 #include "base/memory/Memory.h"
+#include "math/MathUtil.h"
 
 USING_NS_MW; // NOLINT(google-build-using-namespace)
 
@@ -109,6 +110,19 @@ std::size_t ArmatureCache::FrameData::getSegmentCount() const {
     return _segments.size();
 }
 
+std::size_t ArmatureCache::FrameData::getCacheBytes() const {
+    return sizeof(FrameData) + vb.getCapacity() + ib.getCapacity() + _packedBuffers.getByteSize() +
+           _bones.size() * sizeof(BoneData) + _colors.size() * sizeof(ColorData) + _segments.size() * sizeof(SegmentData);
+}
+
+void ArmatureCache::FrameData::pack() {
+    _packedBuffers.pack(vb, ib, 1);
+}
+
+void ArmatureCache::FrameData::unpack() {
+    _packedBuffers.unpack(vb, ib);
+}
+
 ArmatureCache::AnimationData::AnimationData() = default;
 
 ArmatureCache::AnimationData::~AnimationData() {
@@ -122,6 +136,35 @@ void ArmatureCache::AnimationData::reset() {
     _frames.clear();
     _isComplete = false;
     _totalTime = 0.0F;
+    clearCache();
+}
+
+std::size_t ArmatureCache::AnimationData::packFrames() {
+    for (auto *frame : _frames) {
+        frame->pack();
+    }
+    return calcCacheBytes();
+}
+
+std::size_t ArmatureCache::AnimationData::unpackFrames() {
+    for (auto *frame : _frames) {
+        frame->unpack();
+    }
+    return calcCacheBytes();
+}
+
+std::size_t ArmatureCache::AnimationData::releaseFrames() {
+    // players of this animation bake it again from the first frame
+    reset();
+    return 0;
+}
+
+std::size_t ArmatureCache::AnimationData::calcCacheBytes() const {
+    std::size_t bytes = 0;
+    for (const auto *frame : _frames) {
+        bytes += frame->getCacheBytes();
+    }
+    return bytes;
 }
 
 bool ArmatureCache::AnimationData::needUpdate(int toFrameIdx) const {
@@ -139,10 +182,11 @@ ArmatureCache::FrameData *ArmatureCache::AnimationData::buildFrameData(std::size
     return _frames[frameIdx];
 }
 
-ArmatureCache::FrameData *ArmatureCache::AnimationData::getFrameData(std::size_t frameIdx) const {
+ArmatureCache::FrameData *ArmatureCache::AnimationData::getFrameData(std::size_t frameIdx) {
     if (frameIdx >= _frames.size()) {
         return nullptr;
     }
+    touch();
     return _frames[frameIdx];
 }
 
@@ -155,6 +199,7 @@ ArmatureCache::ArmatureCache(const std::string &armatureName, const std::string
     if (_armatureDisplay) {
         _armatureDisplay->addRef();
     }
+    _statName = "ArmatureCache " + armatureKey;
 }
 
 ArmatureCache::~ArmatureCache() {
@@ -182,6 +227,7 @@ ArmatureCache::AnimationData *ArmatureCache::buildAnimationData(const std::strin
 
         aniData = new AnimationData();
         aniData->_animationName = animationName;
+        aniData->setStatName(_statName);
         _animationCaches[animationName] = aniData;
     } else {
         aniData = it->second;
@@ -208,8 +254,14 @@ void ArmatureCache::updateToFrame(const std::string &animationName, int toFrameI
         return;
     }
 
+    animationData->touch();
+
     if (_curAnimationName != animationName) {
-        updateToFrame(_curAnimationName);
+        // an evicted animation restarts from its first frame, there is nothing to finish
+        AnimationData *curAnimationData = getAnimationData(_curAnimationName);
+        if (curAnimationData && curAnimationData->getFrameCount() > 0) {
+            updateToFrame(_curAnimationName);
+        }
         _curAnimationName = animationName;
     }
 
@@ -221,6 +273,7 @@ void ArmatureCache::updateToFrame(const std::string &animationName, int toFrameI
         animation->play(animationName, 1);
     }
 
+    std::size_t cacheBytes = animationData->getCacheBytes();
     do {
         armature->advanceTime(FrameTime);
         renderAnimationFrame(animationData);
@@ -228,7 +281,9 @@ void ArmatureCache::updateToFrame(const std::string &animationName, int toFrameI
         if (animation->isCompleted()) {
             animationData->_isComplete = true;
         }
+        cacheBytes += animationData->_frames.back()->getCacheBytes();
     } while (animationData->needUpdate(toFrameIdx));
+    animationData->setCacheBytes(cacheBytes);
 }
 
 void ArmatureCache::renderAnimationFrame(AnimationData *animationData) {
@@ -369,13 +424,10 @@ void ArmatureCache::traverseArmature(Armature *armature, float parentOpacity /*=
         middleware::Triangles &triangles = slot->triangles;
         middleware::V3F_T2F_C4B *worldTriangles = slot->worldVerts;
 
-        for (int v = 0, w = 0, vn = triangles.vertCount; v < vn; ++v, w += 2) {
-            middleware::V3F_T2F_C4B *vertex = triangles.verts + v;
+        // local z is ignored
+        cc::MathUtil::transformVec2Strided(worldMatrix->m, reinterpret_cast<const float *>(triangles.verts), VF_XYZUVC, reinterpret_cast<float *>(worldTriangles), VF_XYZUVC, triangles.vertCount);
+        for (int v = 0, vn = triangles.vertCount; v < vn; ++v) {
             middleware::V3F_T2F_C4B *worldVertex = worldTriangles + v;
-
-            vertex->vertex.z = 0; //reset for z value
-            worldVertex->vertex.transformMat4(vertex->vertex, *worldMatrix);
-
             worldVertex->color.r = color.r;
             worldVertex->color.g = color.g;
             worldVertex->color.b = color.b;
@@ -24,6 +24,7 @@
 #pragma once
 
 #include "CCArmatureDisplay.h"
+#include "FrameCacheBudget.h"
 #include "IOBuffer.h"
 #include "base/RefCounted.h"
 
@@ -79,7 +80,13 @@ public:
         }
         std::size_t getSegmentCount() const;
 
+        // bytes held by the frame, packed or not
+        std::size_t getCacheBytes() const;
+
     private:
+        void pack();
+        void unpack();
+
         // if segment data is empty, it will build new one.
         SegmentData *buildSegmentData(std::size_t index);
         // if color data is empty, it will build new one.
@@ -90,28 +97,37 @@ public:
         std::vector<BoneData *> _bones;
         std::vector<ColorData *> _colors;
         std::vector<SegmentData *> _segments;
+        cc::middleware::PackedFrameBuffers _packedBuffers;
 
     public:
         cc::middleware::IOBuffer ib;
         cc::middleware::IOBuffer vb;
     };
 
-    struct AnimationData {
+    struct AnimationData : public cc::middleware::FrameCacheEntry {
         friend class ArmatureCache;
 
         AnimationData();
-        ~AnimationData();
+        ~AnimationData() override;
         void reset();
 
-        FrameData *getFrameData(std::size_t frameIdx) const;
+        FrameData *getFrameData(std::size_t frameIdx);
         std::size_t getFrameCount() const;
 
         bool isComplete() const { return _isComplete; }
         bool needUpdate(int toFrameIdx) const;
 
+    protected:
+        bool isPackable() const override { return !needUpdate(-1); }
+        bool isEvictable() const override { return true; }
+        std::size_t packFrames() override;
+        std::size_t unpackFrames() override;
+        std::size_t releaseFrames() override;
+
     private:
         // if frame is empty, it will build new one.
         FrameData *buildFrameData(std::size_t frameIdx);
+        std::size_t calcCacheBytes() const;
 
         std::string _animationName;
         bool _isComplete = false;
@@ -152,6 +168,7 @@ private:
     int _curVSegLen = 0;
     int _materialLen = 0;
     std::string _curAnimationName;
+    std::string _statName;
     std::map<std::string, AnimationData *> _animationCaches;
 };
 
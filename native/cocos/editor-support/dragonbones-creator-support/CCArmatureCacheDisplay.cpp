@@ -34,6 +34,7 @@
 #include "base/memory/Memory.h"
 #include "gfx-base/GFXDef.h"
 #include "math/Math.h"
+#include "math/MathUtil.h"
 #include "renderer/core/MaterialInstance.h"
 
 using namespace cc;      // NOLINT(google-build-using-namespace)
@@ -258,13 +259,8 @@ void CCArmatureCacheDisplay::render(float /*dt*/) {
         dstColorBuffer = reinterpret_cast<unsigned int *>(vb.getCurBuffer());
         vb.writeBytes(reinterpret_cast<char *>(srcVB.getBuffer()) + srcVertexBytesOffset, vertexBytes);
         // batch handle
-        cc::Vec3 *point = nullptr;
-
-        for (auto posIndex = 0; posIndex < segment->vertexFloatCount; posIndex += VF_XYZUVC) {
-            point = reinterpret_cast<cc::Vec3 *>(dstVertexBuffer + posIndex);
-            point->z = 0;
-            point->transformMat4(*point, nodeWorldMat);
-        }
+        auto vertexCount = static_cast<uint32_t>((segment->vertexFloatCount + VF_XYZUVC - 1) / VF_XYZUVC);
+        cc::MathUtil::transformVec2Strided(nodeWorldMat.m, dstVertexBuffer, VF_XYZUVC, dstVertexBuffer, VF_XYZUVC, vertexCount);
         // handle vertex color
         if (needColor) {
             auto frameFloatOffset = srcVertexBytesOffset / sizeof(float);
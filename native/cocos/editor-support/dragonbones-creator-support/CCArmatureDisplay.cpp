@@ -34,6 +34,7 @@
 #include "dragonbones-creator-support/CCSlot.h"
 #include "gfx-base/GFXDef.h"
 #include "math/Math.h"
+#include "math/MathUtil.h"
 #include "math/Vec3.h"
 #include "renderer/core/MaterialInstance.h"
 
@@ -326,14 +327,10 @@ void CCArmatureDisplay::traverseArmature(Armature *armature, float parentOpacity
 
         middleware::V3F_T2F_C4B *worldTriangles = slot->worldVerts;
 
-        for (int v = 0, w = 0, vn = triangles.vertCount; v < vn; ++v, w += 2) {
-            middleware::V3F_T2F_C4B *vertex = triangles.verts + v;
-            middleware::V3F_T2F_C4B *worldVertex = worldTriangles + v;
-
-            vertex->vertex.z = 0; //reset for z value
-            worldVertex->vertex.transformMat4(vertex->vertex, *worldMatrix);
-
-            worldVertex->color = color;
+        // local z is ignored
+        cc::MathUtil::transformVec2Strided(worldMatrix->m, reinterpret_cast<const float *>(triangles.verts), VF_XYZUVC, reinterpret_cast<float *>(worldTriangles), VF_XYZUVC, triangles.vertCount);
+        for (int v = 0, vn = triangles.vertCount; v < vn; ++v) {
+            worldTriangles[v].color = color;
         }
 
         // Fill MiddlewareManager vertex buffer
@@ -131,6 +131,32 @@ void SkeletonAnimation::update(float deltaTime) {
     }
 }
 
+bool SkeletonAnimation::preUpdate(float deltaTime) {
+    // A skeleton which isn't owned may be posed by others, keep it on this thread.
+    if (!_skeleton || !_ownsSkeleton) {
+        update(deltaTime);
+        return false;
+    }
+    if (_paused) return false;
+    deltaTime *= _timeScale * GlobalTimeScale;
+    _skeleton->update(deltaTime);
+    // Listeners of track changes are invoked here, on the calling thread.
+    _state->update(deltaTime);
+    return true;
+}
+
+void SkeletonAnimation::updatePose() {
+    // Runs on a worker thread, events raised by the timelines are drained in postUpdate.
+    bool wasDeferred = _state->setEventDrainDeferred(true);
+    _state->apply(*_skeleton);
+    _state->setEventDrainDeferred(wasDeferred);
+    _skeleton->updateWorldTransform();
+}
+
+void SkeletonAnimation::postUpdate() {
+    _state->drainEvents();
+}
+
 void SkeletonAnimation::setAnimationStateData(AnimationStateData *stateData) {
     CC_ASSERT(stateData);
 
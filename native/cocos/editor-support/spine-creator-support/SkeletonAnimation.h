@@ -51,6 +51,9 @@ public:
     static void setGlobalTimeScale(float timeScale);
 
     virtual void update(float deltaTime) override;
+    bool preUpdate(float deltaTime) override;
+    void updatePose() override;
+    void postUpdate() override;
 
     void setAnimationStateData(AnimationStateData *stateData);
     void setMix(const std::string &fromAnimation, const std::string &toAnimation, float duration);
@@ -0,0 +1,837 @@
+/******************************************************************************
+ * Spine Runtimes License Agreement
+ * Last updated January 1, 2020. Replaces all prior versions.
+ *
+ * Copyright (c) 2013-2020, Esoteric Software LLC
+ *
+ * Integration of the Spine Runtimes into software or otherwise creating
+ * derivative works of the Spine Runtimes is permitted under the terms and
+ * conditions of Section 2 of the Spine Editor License Agreement:
+ * http://esotericsoftware.com/spine-editor-license
+ *
+ * Otherwise, it is permitted to integrate the Spine Runtimes into software
+ * or otherwise create derivative works of the Spine Runtimes (collectively,
+ * "Products"), provided that each user of the Products must obtain their own
+ * Spine Editor license and redistribution of the Products in any form must
+ * include this license and copyright notice.
+ *
+ * THE SPINE RUNTIMES ARE PROVIDED BY ESOTERIC SOFTWARE LLC "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES,
+ * BUSINESS INTERRUPTION, OR LOSS OF USE, DATA, OR PROFITS) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THE SPINE RUNTIMES, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "SkeletonBinaryConverter.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "spine/spine.h"
+
+namespace spine {
+
+namespace {
+
+// Same digit parsing as SkeletonJson::toColor, missing digits keep the fallback.
+uint8_t hexByte(const char *hex, std::size_t index, uint8_t defaultValue) {
+    if (!hex || index >= strlen(hex) / 2) return defaultValue;
+    char digits[3] = {hex[index * 2], hex[index * 2 + 1], '\0'};
+    char *error = nullptr;
+    auto value = strtoul(digits, &error, 16);
+    return *error != 0 ? defaultValue : static_cast<uint8_t>(value);
+}
+
+int blendModeOf(const char *blend) {
+    if (!blend) return BlendMode_Normal;
+    if (strcmp(blend, "additive") == 0) return BlendMode_Additive;
+    if (strcmp(blend, "multiply") == 0) return BlendMode_Multiply;
+    if (strcmp(blend, "screen") == 0) return BlendMode_Screen;
+    return BlendMode_Normal;
+}
+
+int transformModeOf(const char *mode) {
+    if (strcmp(mode, "onlyTranslation") == 0) return TransformMode_OnlyTranslation;
+    if (strcmp(mode, "noRotationOrReflection") == 0) return TransformMode_NoRotationOrReflection;
+    if (strcmp(mode, "noScale") == 0) return TransformMode_NoScale;
+    if (strcmp(mode, "noScaleOrReflection") == 0) return TransformMode_NoScaleOrReflection;
+    return TransformMode_Normal;
+}
+
+int positionModeOf(const char *mode) {
+    return strcmp(mode, "fixed") == 0 ? PositionMode_Fixed : PositionMode_Percent;
+}
+
+int spacingModeOf(const char *mode) {
+    if (strcmp(mode, "fixed") == 0) return SpacingMode_Fixed;
+    if (strcmp(mode, "percent") == 0) return SpacingMode_Percent;
+    return SpacingMode_Length;
+}
+
+int rotateModeOf(const char *mode) {
+    if (strcmp(mode, "chain") == 0) return RotateMode_Chain;
+    if (strcmp(mode, "chainScale") == 0) return RotateMode_ChainScale;
+    return RotateMode_Tangent;
+}
+
+} // namespace
+
+bool SkeletonBinaryConverter::convert(const char *json, std::vector<uint8_t> &out) {
+    _body.clear();
+    _headerSize = 0;
+    _strings.clear();
+    _stringRefs.clear();
+    _bones.clear();
+    _slots.clear();
+    _ikConstraints.clear();
+    _transformConstraints.clear();
+    _pathConstraints.clear();
+    _events.clear();
+    _skinIndices.clear();
+    _skinAttachments.clear();
+    _eventMaps.clear();
+    _error.clear();
+    out.clear();
+
+    if (!json) return fail("Invalid skeleton JSON", nullptr);
+    Json *root = new Json(json);
+    if (root->_type != Json::JSON_OBJECT) {
+        delete root;
+        return fail("Invalid skeleton JSON: ", Json::getError());
+    }
+    bool ok = writeSkeleton(root);
+    delete root;
+    if (!ok) return false;
+
+    // The string table sits between the header and the bones but is complete
+    // only once everything else is written, so it is spliced in last.
+    std::vector<uint8_t> body;
+    body.swap(_body);
+    writeVarint(static_cast<int32_t>(_strings.size()), true);
+    for (const auto &str : _strings) {
+        writeString(str.c_str());
+    }
+    auto headerEnd = body.begin() + static_cast<std::ptrdiff_t>(_headerSize);
+    out.reserve(body.size() + _body.size());
+    out.insert(out.end(), body.begin(), headerEnd);
+    out.insert(out.end(), _body.begin(), _body.end());
+    out.insert(out.end(), headerEnd, body.end());
+    _body.clear();
+    return true;
+}
+
+bool SkeletonBinaryConverter::writeSkeleton(Json *root) {
+    Json *skeleton = Json::getItem(root, "skeleton");
+    const char *version = skeleton ? Json::getString(skeleton, "spine", nullptr) : nullptr;
+    // SkeletonBinary refuses this version, see SkeletonBinary::readSkeletonData.
+    if (version && strcmp(version, "3.8.75") == 0) return fail("Unsupported skeleton data version: ", version);
+    writeString(skeleton ? Json::getString(skeleton, "hash", nullptr) : nullptr);
+    writeString(version);
+    writeFloat(skeleton ? Json::getFloat(skeleton, "x", 0) : 0);
+    writeFloat(skeleton ? Json::getFloat(skeleton, "y", 0) : 0);
+    writeFloat(skeleton ? Json::getFloat(skeleton, "width", 0) : 0);
+    writeFloat(skeleton ? Json::getFloat(skeleton, "height", 0) : 0);
+    // Nonessential data keeps fps, paths, mesh edges and sizes the JSON loader exposes.
+    writeBoolean(true);
+    writeFloat(skeleton ? Json::getFloat(skeleton, "fps", 30) : 30);
+    writeString(skeleton ? Json::getString(skeleton, "images", nullptr) : nullptr);
+    writeString(skeleton ? Json::getString(skeleton, "audio", nullptr) : nullptr);
+    _headerSize = _body.size();
+
+    /* Bones. */
+    Json *bones = Json::getItem(root, "bones");
+    if (!bones) return fail("Skeleton has no bones", nullptr);
+    writeVarint(bones->_size, true);
+    int index = 0;
+    for (Json *boneMap = bones->_child; boneMap; boneMap = boneMap->_next, ++index) {
+        const char *name = Json::getString(boneMap, "name", nullptr);
+        writeString(name);
+        if (index > 0) {
+            const char *parentName = Json::getString(boneMap, "parent", nullptr);
+            int parent = indexOf(_bones, parentName);
+            if (parent < 0) return fail("Parent bone not found: ", parentName);
+            writeVarint(parent, true);
+        }
+        writeFloat(Json::getFloat(boneMap, "rotation", 0));
+        writeFloat(Json::getFloat(boneMap, "x", 0));
+        writeFloat(Json::getFloat(boneMap, "y", 0));
+        writeFloat(Json::getFloat(boneMap, "scaleX", 1));
+        writeFloat(Json::getFloat(boneMap, "scaleY", 1));
+        writeFloat(Json::getFloat(boneMap, "shearX", 0));
+        writeFloat(Json::getFloat(boneMap, "shearY", 0));
+        writeFloat(Json::getFloat(boneMap, "length", 0));
+        writeVarint(transformModeOf(Json::getString(boneMap, "transform", "normal")), true);
+        writeBoolean(Json::getBoolean(boneMap, "skin", false));
+        writeColor(Json::getString(boneMap, "color", nullptr), 0x989898ff);
+        if (name) _bones[name] = index;
+    }
+
+    /* Slots. */
+    Json *slots = Json::getItem(root, "slots");
+    writeVarint(slots ? slots->_size : 0, true);
+    index = 0;
+    for (Json *slotMap = slots ? slots->_child : nullptr; slotMap; slotMap = slotMap->_next, ++index) {
+        const char *name = Json::getString(slotMap, "name", nullptr);
+        const char *boneName = Json::getString(slotMap, "bone", nullptr);
+        int bone = indexOf(_bones, boneName);
+        if (bone < 0) return fail("Slot bone not found: ", boneName);
+        writeString(name);
+        writeVarint(bone, true);
+        writeColor(Json::getString(slotMap, "color", nullptr), 0xffffffff);
+        // The loader treats an opaque white dark color as "no dark color", a zero
+        // alpha keeps any dark color present in the JSON.
+        const char *dark = Json::getString(slotMap, "dark", nullptr);
+        writeByte(dark ? hexByte(dark, 0, 0xff) : 0xff);
+        writeByte(dark ? hexByte(dark, 1, 0xff) : 0xff);
+        writeByte(dark ? hexByte(dark, 2, 0xff) : 0xff);
+        writeByte(dark ? 0 : 0xff);
+        Json *attachment = Json::getItem(slotMap, "attachment");
+        writeStringRef(attachment ? attachment->_valueString : nullptr);
+        Json *blend = Json::getItem(slotMap, "blend");
+        writeVarint(blendModeOf(blend ? blend->_valueString : nullptr), true);
+        if (name) _slots[name] = index;
+    }
+
+    auto writeBones = [this](Json *constraintMap) {
+        Json *bonesMap = Json::getItem(constraintMap, "bones");
+        writeVarint(bonesMap ? bonesMap->_size : 0, true);
+        for (Json *boneMap = bonesMap ? bonesMap->_child : nullptr; boneMap; boneMap = boneMap->_next) {
+            int bone = indexOf(_bones, boneMap->_valueString);
+            if (bone < 0) return fail("Constraint bone not found: ", boneMap->_valueString);
+            writeVarint(bone, true);
+        }
+        return true;
+    };
+
+    /* IK constraints. */
+    Json *ik = Json::getItem(root, "ik");
+    writeVarint(ik ? ik->_size : 0, true);
+    index = 0;
+    for (Json *constraintMap = ik ? ik->_child : nullptr; constraintMap; constraintMap = constraintMap->_next, ++index) {
+        const char *name = Json::getString(constraintMap, "name", nullptr);
+        writeString(name);
+        writeVarint(Json::getInt(constraintMap, "order", 0), true);
+        writeBoolean(Json::getBoolean(constraintMap, "skin", false));
+        if (!writeBones(constraintMap)) return false;
+        const char *targetName = Json::getString(constraintMap, "target", nullptr);
+        int target = indexOf(_bones, targetName);
+        if (target < 0) return fail("Target bone not found: ", targetName);
+        writeVarint(target, true);
+        writeFloat(Json::getFloat(constraintMap, "mix", 1));
+        writeFloat(Json::getFloat(constraintMap, "softness", 0));
+        writeByte(static_cast<uint8_t>(Json::getInt(constraintMap, "bendPositive", 1) ? 1 : -1));
+        writeBoolean(Json::getInt(constraintMap, "compress", 0) != 0);
+        writeBoolean(Json::getInt(constraintMap, "stretch", 0) != 0);
+        writeBoolean(Json::getInt(constraintMap, "uniform", 0) != 0);
+        if (name) _ikConstraints[name] = index;
+    }
+
+    /* Transform constraints. */
+    Json *transform = Json::getItem(root, "transform");
+    writeVarint(transform ? transform->_size : 0, true);
+    index = 0;
+    for (Json *constraintMap = transform ? transform->_child : nullptr; constraintMap; constraintMap = constraintMap->_next, ++index) {
+        const char *name = Json::getString(constraintMap, "name", nullptr);
+        writeString(name);
+        writeVarint(Json::getInt(constraintMap, "order", 0), true);
+        writeBoolean(Json::getBoolean(constraintMap, "skin", false));
+        if (!writeBones(constraintMap)) return false;
+        const char *targetName = Json::getString(constraintMap, "target", nullptr);
+        int target = indexOf(_bones, targetName);
+        if (target < 0) return fail("Target bone not found: ", targetName);
+        writeVarint(target, true);
+        writeBoolean(Json::getInt(constraintMap, "local", 0) != 0);
+        writeBoolean(Json::getInt(constraintMap, "relative", 0) != 0);
+        writeFloat(Json::getFloat(constraintMap, "rotation", 0));
+        writeFloat(Json::getFloat(constraintMap, "x", 0));
+        writeFloat(Json::getFloat(constraintMap, "y", 0));
+        writeFloat(Json::getFloat(constraintMap, "scaleX", 0));
+        writeFloat(Json::getFloat(constraintMap, "scaleY", 0));
+        writeFloat(Json::getFloat(constraintMap, "shearY", 0));
+        writeFloat(Json::getFloat(constraintMap, "rotateMix", 1));
+        writeFloat(Json::getFloat(constraintMap, "translateMix", 1));
+        writeFloat(Json::getFloat(constraintMap, "scaleMix", 1));
+        writeFloat(Json::getFloat(constraintMap, "shearMix", 1));
+        if (name) _transformConstraints[name] = index;
+    }
+
+    /* Path constraints. */
+    Json *path = Json::getItem(root, "path");
+    writeVarint(path ? path->_size : 0, true);
+    index = 0;
+    for (Json *constraintMap = path ? path->_child : nullptr; constraintMap; constraintMap = constraintMap->_next, ++index) {
+        const char *name = Json::getString(constraintMap, "name", nullptr);
+        writeString(name);
+        writeVarint(Json::getInt(constraintMap, "order", 0), true);
+        writeBoolean(Json::getBoolean(constraintMap, "skin", false));
+        if (!writeBones(constraintMap)) return false;
+        const char *targetName = Json::getString(constraintMap, "target", nullptr);
+        int target = indexOf(_slots, targetName);
+        if (target < 0) return fail("Target slot not found: ", targetName);
+        writeVarint(target, true);
+        writeVarint(positionModeOf(Json::getString(constraintMap, "positionMode", "percent")), true);
+        writeVarint(spacingModeOf(Json::getString(constraintMap, "spacingMode", "length")), true);
+        writeVarint(rotateModeOf(Json::getString(constraintMap, "rotateMode", "tangent")), true);
+        writeFloat(Json::getFloat(constraintMap, "rotation", 0));
+        writeFloat(Json::getFloat(constraintMap, "position", 0));
+        writeFloat(Json::getFloat(constraintMap, "spacing", 0));
+        writeFloat(Json::getFloat(constraintMap, "rotateMix", 1));
+        writeFloat(Json::getFloat(constraintMap, "translateMix", 1));
+        if (name) _pathConstraints[name] = index;
+    }
+
+    /* Skins, the binary layout stores the default skin first. */
+    std::vector<SkinInfo> skins;
+    const SkinInfo *defaultSkin = nullptr;
+    Json *skinsMap = Json::getItem(root, "skins");
+    for (Json *skinMap = skinsMap ? skinsMap->_child : nullptr; skinMap; skinMap = skinMap->_next) {
+        SkinInfo skin;
+        skin.map = skinMap;
+        skin.name = Json::getString(skinMap, "name", "");
+        if (strlen(skin.name) == 0) skin.name = skinMap->_name;
+        skin.attachments = Json::getItem(skinMap, "attachments");
+        if (!skin.attachments) skin.attachments = skinMap;
+        skins.push_back(skin);
+    }
+    for (const auto &skin : skins) {
+        if (skin.name && strcmp(skin.name, "default") == 0) defaultSkin = &skin;
+    }
+    int skinIndex = 0;
+    if (defaultSkin) {
+        if (!writeSkin(*defaultSkin, true)) return false;
+        // An empty default skin is not created by the loader.
+        if (defaultSkin->attachments->_child) _skinIndices[defaultSkin->name] = skinIndex++;
+    } else {
+        writeVarint(0, true);
+    }
+    writeVarint(static_cast<int32_t>(skins.size() - (defaultSkin ? 1 : 0)), true);
+    for (const auto &skin : skins) {
+        if (&skin == defaultSkin) continue;
+        if (!writeSkin(skin, false)) return false;
+        if (skin.name) _skinIndices[skin.name] = skinIndex;
+        ++skinIndex;
+    }
+
+    /* Events. */
+    Json *events = Json::getItem(root, "events");
+    writeVarint(events ? events->_size : 0, true);
+    index = 0;
+    for (Json *eventMap = events ? events->_child : nullptr; eventMap; eventMap = eventMap->_next, ++index) {
+        writeStringRef(eventMap->_name);
+        writeVarint(Json::getInt(eventMap, "int", 0), false);
+        writeFloat(Json::getFloat(eventMap, "float", 0));
+        writeString(Json::getString(eventMap, "string", nullptr));
+        const char *audio = Json::getString(eventMap, "audio", nullptr);
+        writeString(audio);
+        if (audio && audio[0] != '\0') {
+            writeFloat(Json::getFloat(eventMap, "volume", 1));
+            writeFloat(Json::getFloat(eventMap, "balance", 0));
+        }
+        if (eventMap->_name) _events[eventMap->_name] = index;
+        _eventMaps.push_back(eventMap);
+    }
+
+    /* Animations. */
+    Json *animations = Json::getItem(root, "animations");
+    writeVarint(animations ? animations->_size : 0, true);
+    for (Json *animationMap = animations ? animations->_child : nullptr; animationMap; animationMap = animationMap->_next) {
+        writeString(animationMap->_name);
+        if (!writeAnimation(animationMap)) return false;
+    }
+    return true;
+}
+
+bool SkeletonBinaryConverter::writeSkin(const SkinInfo &skin, bool defaultSkin) {
+    if (!defaultSkin) {
+        writeStringRef(skin.name);
+        // Skins in the pre 3.8 layout map slots directly and have no bone or constraint lists.
+        bool hasLists = skin.attachments != skin.map;
+        const std::pair<const char *, const std::unordered_map<std::string, int> *> lists[] = {
+            {"bones", &_bones},
+            {"ik", &_ikConstraints},
+            {"transform", &_transformConstraints},
+            {"path", &_pathConstraints},
+        };
+        for (const auto &list : lists) {
+            Json *items = hasLists ? Json::getItem(skin.map, list.first) : nullptr;
+            writeVarint(items ? items->_size : 0, true);
+            for (Json *item = items ? items->_child : nullptr; item; item = item->_next) {
+                int found = indexOf(*list.second, item->_valueString);
+                if (found < 0) return fail("Skin item not found: ", item->_valueString);
+                writeVarint(found, true);
+            }
+        }
+    }
+
+    auto &attachments = _skinAttachments[skin.name ? skin.name : ""];
+    writeVarint(skin.attachments->_size, true);
+    for (Json *slotMap = skin.attachments->_child; slotMap; slotMap = slotMap->_next) {
+        int slotIndex = indexOf(_slots, slotMap->_name);
+        if (slotIndex < 0) return fail("Skin slot not found: ", slotMap->_name);
+        writeVarint(slotIndex, true);
+        writeVarint(slotMap->_size, true);
+        for (Json *attachmentMap = slotMap->_child; attachmentMap; attachmentMap = attachmentMap->_next) {
+            writeStringRef(attachmentMap->_name);
+            if (!writeAttachment(attachmentMap)) return false;
+            attachments[slotIndex].emplace_back(attachmentMap->_name);
+        }
+    }
+    return true;
+}
+
+bool SkeletonBinaryConverter::writeAttachment(Json *attachmentMap) {
+    writeStringRef(Json::getString(attachmentMap, "name", nullptr));
+
+    const char *typeString = Json::getString(attachmentMap, "type", "region");
+    const char *color = Json::getString(attachmentMap, "color", nullptr);
+    if (strcmp(typeString, "region") == 0) {
+        writeByte(AttachmentType_Region);
+        writeStringRef(Json::getString(attachmentMap, "path", nullptr));
+        writeFloat(Json::getFloat(attachmentMap, "rotation", 0));
+        writeFloat(Json::getFloat(attachmentMap, "x", 0));
+        writeFloat(Json::getFloat(attachmentMap, "y", 0));
+        writeFloat(Json::getFloat(attachmentMap, "scaleX", 1));
+        writeFloat(Json::getFloat(attachmentMap, "scaleY", 1));
+        writeFloat(Json::getFloat(attachmentMap, "width", 32));
+        writeFloat(Json::getFloat(attachmentMap, "height", 32));
+        writeColor(color, 0xffffffff);
+    } else if (strcmp(typeString, "mesh") == 0 || strcmp(typeString, "linkedmesh") == 0) {
+        Json *parent = Json::getItem(attachmentMap, "parent");
+        if (parent) {
+            writeByte(AttachmentType_Linkedmesh);
+            writeStringRef(Json::getString(attachmentMap, "path", nullptr));
+            writeColor(color, 0xffffffff);
+            writeStringRef(Json::getString(attachmentMap, "skin", nullptr));
+            writeStringRef(parent->_valueString);
+            writeBoolean(Json::getInt(attachmentMap, "deform", 1) != 0);
+            writeFloat(Json::getFloat(attachmentMap, "width", 32));
+            writeFloat(Json::getFloat(attachmentMap, "height", 32));
+            return true;
+        }
+        Json *uvs = Json::getItem(attachmentMap, "uvs");
+        Json *triangles = Json::getItem(attachmentMap, "triangles");
+        if (!uvs || !triangles) return fail("Mesh without uvs or triangles: ", attachmentMap->_name);
+        writeByte(AttachmentType_Mesh);
+        writeStringRef(Json::getString(attachmentMap, "path", nullptr));
+        writeColor(color, 0xffffffff);
+        writeVarint(uvs->_size >> 1, true);
+        for (Json *uv = uvs->_child; uv; uv = uv->_next) {
+            writeFloat(uv->_valueFloat);
+        }
+        writeShortArray(triangles);
+        writeVertices(attachmentMap, uvs->_size);
+        writeVarint(Json::getInt(attachmentMap, "hull", 0), true);
+        writeShortArray(Json::getItem(attachmentMap, "edges"));
+        writeFloat(Json::getFloat(attachmentMap, "width", 32));
+        writeFloat(Json::getFloat(attachmentMap, "height", 32));
+    } else if (strcmp(typeString, "boundingbox") == 0) {
+        int vertexCount = Json::getInt(attachmentMap, "vertexCount", 0);
+        writeByte(AttachmentType_Boundingbox);
+        writeVarint(vertexCount, true);
+        writeVertices(attachmentMap, vertexCount << 1);
+        writeColor(color, 0x60f000ff);
+    } else if (strcmp(typeString, "path") == 0) {
+        int vertexCount = Json::getInt(attachmentMap, "vertexCount", 0);
+        writeByte(AttachmentType_Path);
+        writeBoolean(Json::getInt(attachmentMap, "closed", 0) != 0);
+        writeBoolean(Json::getInt(attachmentMap, "constantSpeed", 1) != 0);
+        writeVarint(vertexCount, true);
+        writeVertices(attachmentMap, vertexCount << 1);
+        Json *lengths = Json::getItem(attachmentMap, "lengths");
+        Json *length = lengths ? lengths->_child : nullptr;
+        for (int i = 0; i < vertexCount / 3; ++i) {
+            writeFloat(length ? length->_valueFloat : 0);
+            if (length) length = length->_next;
+        }
+        writeColor(color, 0xff7f00ff);
+    } else if (strcmp(typeString, "point") == 0) {
+        writeByte(AttachmentType_Point);
+        writeFloat(Json::getFloat(attachmentMap, "rotation", 0));
+        writeFloat(Json::getFloat(attachmentMap, "x", 0));
+        writeFloat(Json::getFloat(attachmentMap, "y", 0));
+        writeColor(color, 0xf1f100ff);
+    } else if (strcmp(typeString, "clipping") == 0) {
+        const char *end = Json::getString(attachmentMap, "end", nullptr);
+        // Without an end slot clipping runs to the end of the draw order.
+        int endSlot = end ? indexOf(_slots, end) : static_cast<int>(_slots.size()) - 1;
+        if (endSlot < 0) return fail("Clipping end slot not found: ", end);
+        int vertexCount = Json::getInt(attachmentMap, "vertexCount", 0);
+        writeByte(AttachmentType_Clipping);
+        writeVarint(endSlot, true);
+        writeVarint(vertexCount, true);
+        writeVertices(attachmentMap, vertexCount << 1);
+        writeColor(color, 0xce3a3aff);
+    } else {
+        return fail("Unknown attachment type: ", typeString);
+    }
+    return true;
+}
+
+void SkeletonBinaryConverter::writeVertices(Json *attachmentMap, int verticesLength) {
+    Json *entries = Json::getItem(attachmentMap, "vertices");
+    std::vector<float> vertices;
+    for (Json *entry = entries ? entries->_child : nullptr; entry; entry = entry->_next) {
+        vertices.push_back(entry->_valueFloat);
+    }
+    if (vertices.size() == static_cast<std::size_t>(verticesLength)) {
+        writeBoolean(false);
+        for (float value : vertices) writeFloat(value);
+        return;
+    }
+    // Weighted vertices are [boneCount, (bone, x, y, weight) * boneCount] per vertex.
+    writeBoolean(true);
+    for (std::size_t i = 0, n = vertices.size(); i < n;) {
+        auto boneCount = static_cast<int>(vertices[i++]);
+        writeVarint(boneCount, true);
+        for (std::size_t end = i + boneCount * 4; i < end && i + 3 < n; i += 4) {
+            writeVarint(static_cast<int>(vertices[i]), true);
+            writeFloat(vertices[i + 1]);
+            writeFloat(vertices[i + 2]);
+            writeFloat(vertices[i + 3]);
+        }
+    }
+}
+
+bool SkeletonBinaryConverter::writeAnimation(Json *animationMap) {
+    Json *bones = Json::getItem(animationMap, "bones");
+    Json *slots = Json::getItem(animationMap, "slots");
+    Json *ik = Json::getItem(animationMap, "ik");
+    Json *transform = Json::getItem(animationMap, "transform");
+    Json *paths = Json::getItem(animationMap, "path");
+    if (!paths) paths = Json::getItem(animationMap, "paths");
+    Json *deform = Json::getItem(animationMap, "deform");
+    Json *drawOrder = Json::getItem(animationMap, "drawOrder");
+    if (!drawOrder) drawOrder = Json::getItem(animationMap, "draworder");
+    Json *events = Json::getItem(animationMap, "events");
+
+    /* Slot timelines. */
+    writeVarint(slots ? slots->_size : 0, true);
+    for (Json *slotMap = slots ? slots->_child : nullptr; slotMap; slotMap = slotMap->_next) {
+        int slotIndex = indexOf(_slots, slotMap->_name);
+        if (slotIndex < 0) return fail("Slot not found: ", slotMap->_name);
+        writeVarint(slotIndex, true);
+        writeVarint(slotMap->_size, true);
+        for (Json *timelineMap = slotMap->_child; timelineMap; timelineMap = timelineMap->_next) {
+            if (strcmp(timelineMap->_name, "attachment") == 0) {
+                writeByte(SkeletonBinary::SLOT_ATTACHMENT);
+                writeVarint(timelineMap->_size, true);
+                for (Json *valueMap = timelineMap->_child; valueMap; valueMap = valueMap->_next) {
+                    Json *name = Json::getItem(valueMap, "name");
+                    writeFloat(Json::getFloat(valueMap, "time", 0));
+                    writeStringRef(name ? name->_valueString : nullptr);
+                }
+            } else if (strcmp(timelineMap->_name, "color") == 0) {
+                writeByte(SkeletonBinary::SLOT_COLOR);
+                writeVarint(timelineMap->_size, true);
+                for (Json *valueMap = timelineMap->_child; valueMap; valueMap = valueMap->_next) {
+                    writeFloat(Json::getFloat(valueMap, "time", 0));
+                    writeColor(Json::getString(valueMap, "color", nullptr), 0xffffffff);
+                    if (valueMap->_next) writeCurve(valueMap);
+                }
+            } else if (strcmp(timelineMap->_name, "twoColor") == 0) {
+                writeByte(SkeletonBinary::SLOT_TWO_COLOR);
+                writeVarint(timelineMap->_size, true);
+                for (Json *valueMap = timelineMap->_child; valueMap; valueMap = valueMap->_next) {
+                    const char *dark = Json::getString(valueMap, "dark", nullptr);
+                    writeFloat(Json::getFloat(valueMap, "time", 0));
+                    writeColor(Json::getString(valueMap, "light", nullptr), 0xffffffff);
+                    writeInt(static_cast<int32_t>(hexByte(dark, 0, 0xff) << 16 | hexByte(dark, 1, 0xff) << 8 | hexByte(dark, 2, 0xff)));
+                    if (valueMap->_next) writeCurve(valueMap);
+                }
+            } else {
+                return fail("Invalid timeline type for a slot: ", timelineMap->_name);
+            }
+        }
+    }
+
+    /* Bone timelines. */
+    writeVarint(bones ? bones->_size : 0, true);
+    for (Json *boneMap = bones ? bones->_child : nullptr; boneMap; boneMap = boneMap->_next) {
+        int boneIndex = indexOf(_bones, boneMap->_name);
+        if (boneIndex < 0) return fail("Bone not found: ", boneMap->_name);
+        writeVarint(boneIndex, true);
+        writeVarint(boneMap->_size, true);
+        for (Json *timelineMap = boneMap->_child; timelineMap; timelineMap = timelineMap->_next) {
+            bool isRotate = strcmp(timelineMap->_name, "rotate") == 0;
+            float defaultValue = 0;
+            if (isRotate) {
+                writeByte(SkeletonBinary::BONE_ROTATE);
+            } else if (strcmp(timelineMap->_name, "translate") == 0) {
+                writeByte(SkeletonBinary::BONE_TRANSLATE);
+            } else if (strcmp(timelineMap->_name, "scale") == 0) {
+                writeByte(SkeletonBinary::BONE_SCALE);
+                defaultValue = 1;
+            } else if (strcmp(timelineMap->_name, "shear") == 0) {
+                writeByte(SkeletonBinary::BONE_SHEAR);
+            } else {
+                return fail("Invalid timeline type for a bone: ", timelineMap->_name);
+            }
+            writeVarint(timelineMap->_size, true);
+            for (Json *valueMap = timelineMap->_child; valueMap; valueMap = valueMap->_next) {
+                writeFloat(Json::getFloat(valueMap, "time", 0));
+                if (isRotate) {
+                    writeFloat(Json::getFloat(valueMap, "angle", 0));
+                } else {
+                    writeFloat(Json::getFloat(valueMap, "x", defaultValue));
+                    writeFloat(Json::getFloat(valueMap, "y", defaultValue));
+                }
+                if (valueMap->_next) writeCurve(valueMap);
+            }
+        }
+    }
+
+    /* IK constraint timelines. */
+    writeVarint(ik ? ik->_size : 0, true);
+    for (Json *constraintMap = ik ? ik->_child : nullptr; constraintMap; constraintMap = constraintMap->_next) {
+        int index = indexOf(_ikConstraints, constraintMap->_name);
+        if (index < 0) return fail("IK constraint not found: ", constraintMap->_name);
+        writeVarint(index, true);
+        writeVarint(constraintMap->_size, true);
+        for (Json *valueMap = constraintMap->_child; valueMap; valueMap = valueMap->_next) {
+            writeFloat(Json::getFloat(valueMap, "time", 0));
+            writeFloat(Json::getFloat(valueMap, "mix", 1));
+            writeFloat(Json::getFloat(valueMap, "softness", 0));
+            writeByte(static_cast<uint8_t>(Json::getInt(valueMap, "bendPositive", 1) ? 1 : -1));
+            writeBoolean(Json::getInt(valueMap, "compress", 0) != 0);
+            writeBoolean(Json::getInt(valueMap, "stretch", 0) != 0);
+            if (valueMap->_next) writeCurve(valueMap);
+        }
+    }
+
+    /* Transform constraint timelines. */
+    writeVarint(transform ? transform->_size : 0, true);
+    for (Json *constraintMap = transform ? transform->_child : nullptr; constraintMap; constraintMap = constraintMap->_next) {
+        int index = indexOf(_transformConstraints, constraintMap->_name);
+        if (index < 0) return fail("Transform constraint not found: ", constraintMap->_name);
+        writeVarint(index, true);
+        writeVarint(constraintMap->_size, true);
+        for (Json *valueMap = constraintMap->_child; valueMap; valueMap = valueMap->_next) {
+            writeFloat(Json::getFloat(valueMap, "time", 0));
+            writeFloat(Json::getFloat(valueMap, "rotateMix", 1));
+            writeFloat(Json::getFloat(valueMap, "translateMix", 1));
+            writeFloat(Json::getFloat(valueMap, "scaleMix", 1));
+            writeFloat(Json::getFloat(valueMap, "shearMix", 1));
+            if (valueMap->_next) writeCurve(valueMap);
+        }
+    }
+
+    /* Path constraint timelines, unknown ones are skipped like SkeletonJson does. */
+    writeVarint(paths ? paths->_size : 0, true);
+    for (Json *constraintMap = paths ? paths->_child : nullptr; constraintMap; constraintMap = constraintMap->_next) {
+        int index = indexOf(_pathConstraints, constraintMap->_name);
+        if (index < 0) return fail("Path constraint not found: ", constraintMap->_name);
+        std::vector<std::pair<Json *, int>> timelines;
+        for (Json *timelineMap = constraintMap->_child; timelineMap; timelineMap = timelineMap->_next) {
+            if (strcmp(timelineMap->_name, "position") == 0) {
+                timelines.emplace_back(timelineMap, SkeletonBinary::PATH_POSITION);
+            } else if (strcmp(timelineMap->_name, "spacing") == 0) {
+                timelines.emplace_back(timelineMap, SkeletonBinary::PATH_SPACING);
+            } else if (strcmp(timelineMap->_name, "mix") == 0) {
+                timelines.emplace_back(timelineMap, SkeletonBinary::PATH_MIX);
+            }
+        }
+        writeVarint(index, true);
+        writeVarint(static_cast<int32_t>(timelines.size()), true);
+        for (const auto &timeline : timelines) {
+            Json *timelineMap = timeline.first;
+            writeByte(static_cast<uint8_t>(timeline.second));
+            writeVarint(timelineMap->_size, true);
+            for (Json *valueMap = timelineMap->_child; valueMap; valueMap = valueMap->_next) {
+                writeFloat(Json::getFloat(valueMap, "time", 0));
+                if (timeline.second == SkeletonBinary::PATH_MIX) {
+                    writeFloat(Json::getFloat(valueMap, "rotateMix", 1));
+                    writeFloat(Json::getFloat(valueMap, "translateMix", 1));
+                } else {
+                    writeFloat(Json::getFloat(valueMap, timelineMap->_name, 0));
+                }
+                if (valueMap->_next) writeCurve(valueMap);
+            }
+        }
+    }
+
+    /* Deform timelines, attachments missing from the skin are skipped like SkeletonJson does. */
+    std::vector<std::pair<int, std::vector<DeformInfo>>> deforms;
+    for (Json *skinMap = deform ? deform->_child : nullptr; skinMap; skinMap = skinMap->_next) {
+        int skinIndex = indexOf(_skinIndices, skinMap->_name);
+        if (skinIndex < 0) return fail("Deform skin not found: ", skinMap->_name);
+        const auto &skinAttachments = _skinAttachments[skinMap->_name];
+        std::vector<DeformInfo> slotDeforms;
+        for (Json *slotMap = skinMap->_child; slotMap; slotMap = slotMap->_next) {
+            DeformInfo info;
+            info.slotIndex = indexOf(_slots, slotMap->_name);
+            if (info.slotIndex < 0) return fail("Deform slot not found: ", slotMap->_name);
+            auto found = skinAttachments.find(info.slotIndex);
+            for (Json *timelineMap = slotMap->_child; timelineMap; timelineMap = timelineMap->_next) {
+                if (found != skinAttachments.end() &&
+                    std::find(found->second.begin(), found->second.end(), timelineMap->_name) != found->second.end()) {
+                    info.timelines.push_back(timelineMap);
+                }
+            }
+            slotDeforms.push_back(std::move(info));
+        }
+        deforms.emplace_back(skinIndex, std::move(slotDeforms));
+    }
+    writeVarint(static_cast<int32_t>(deforms.size()), true);
+    for (const auto &skinDeform : deforms) {
+        writeVarint(skinDeform.first, true);
+        writeVarint(static_cast<int32_t>(skinDeform.second.size()), true);
+        for (const auto &slotDeform : skinDeform.second) {
+            writeVarint(slotDeform.slotIndex, true);
+            writeVarint(static_cast<int32_t>(slotDeform.timelines.size()), true);
+            for (Json *timelineMap : slotDeform.timelines) {
+                writeStringRef(timelineMap->_name);
+                writeVarint(timelineMap->_size, true);
+                for (Json *valueMap = timelineMap->_child; valueMap; valueMap = valueMap->_next) {
+                    Json *vertices = Json::getItem(valueMap, "vertices");
+                    writeFloat(Json::getFloat(valueMap, "time", 0));
+                    if (!vertices || vertices->_size == 0) {
+                        writeVarint(0, true);
+                    } else {
+                        writeVarint(vertices->_size, true);
+                        writeVarint(Json::getInt(valueMap, "offset", 0), true);
+                        for (Json *vertex = vertices->_child; vertex; vertex = vertex->_next) {
+                            writeFloat(vertex->_valueFloat);
+                        }
+                    }
+                    if (valueMap->_next) writeCurve(valueMap);
+                }
+            }
+        }
+    }
+
+    /* Draw order timeline. */
+    writeVarint(drawOrder ? drawOrder->_size : 0, true);
+    for (Json *valueMap = drawOrder ? drawOrder->_child : nullptr; valueMap; valueMap = valueMap->_next) {
+        Json *offsets = Json::getItem(valueMap, "offsets");
+        writeFloat(Json::getFloat(valueMap, "time", 0));
+        writeVarint(offsets ? offsets->_size : 0, true);
+        for (Json *offsetMap = offsets ? offsets->_child : nullptr; offsetMap; offsetMap = offsetMap->_next) {
+            const char *slotName = Json::getString(offsetMap, "slot", nullptr);
+            int slotIndex = indexOf(_slots, slotName);
+            if (slotIndex < 0) return fail("Slot not found: ", slotName);
+            writeVarint(slotIndex, true);
+            // Negative offsets wrap around, the loader adds them with size_t arithmetic.
+            writeVarint(Json::getInt(offsetMap, "offset", 0), true);
+        }
+    }
+
+    /* Event timeline. */
+    writeVarint(events ? events->_size : 0, true);
+    for (Json *valueMap = events ? events->_child : nullptr; valueMap; valueMap = valueMap->_next) {
+        const char *name = Json::getString(valueMap, "name", nullptr);
+        int eventIndex = indexOf(_events, name);
+        if (eventIndex < 0) return fail("Event not found: ", name);
+        Json *eventMap = _eventMaps[eventIndex];
+        writeFloat(Json::getFloat(valueMap, "time", 0));
+        writeVarint(eventIndex, true);
+        writeVarint(Json::getInt(valueMap, "int", Json::getInt(eventMap, "int", 0)), false);
+        writeFloat(Json::getFloat(valueMap, "float", Json::getFloat(eventMap, "float", 0)));
+        Json *stringValue = Json::getItem(valueMap, "string");
+        writeBoolean(stringValue != nullptr);
+        if (stringValue) writeString(stringValue->_valueString);
+        const char *audio = Json::getString(eventMap, "audio", nullptr);
+        if (audio && audio[0] != '\0') {
+            writeFloat(Json::getFloat(valueMap, "volume", 1));
+            writeFloat(Json::getFloat(valueMap, "balance", 0));
+        }
+    }
+    return true;
+}
+
+void SkeletonBinaryConverter::writeCurve(Json *frame) {
+    Json *curve = Json::getItem(frame, "curve");
+    if (!curve) {
+        writeByte(SkeletonBinary::CURVE_LINEAR);
+    } else if (curve->_type == Json::JSON_STRING && strcmp(curve->_valueString, "stepped") == 0) {
+        writeByte(SkeletonBinary::CURVE_STEPPED);
+    } else {
+        writeByte(SkeletonBinary::CURVE_BEZIER);
+        writeFloat(Json::getFloat(frame, "curve", 0));
+        writeFloat(Json::getFloat(frame, "c2", 0));
+        writeFloat(Json::getFloat(frame, "c3", 1));
+        writeFloat(Json::getFloat(frame, "c4", 1));
+    }
+}
+
+void SkeletonBinaryConverter::writeInt(int32_t value) {
+    auto bits = static_cast<uint32_t>(value);
+    writeByte(static_cast<uint8_t>(bits >> 24));
+    writeByte(static_cast<uint8_t>(bits >> 16));
+    writeByte(static_cast<uint8_t>(bits >> 8));
+    writeByte(static_cast<uint8_t>(bits));
+}
+
+void SkeletonBinaryConverter::writeFloat(float value) {
+    int32_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+    writeInt(bits);
+}
+
+void SkeletonBinaryConverter::writeVarint(int32_t value, bool optimizePositive) {
+    auto bits = static_cast<uint32_t>(value);
+    if (!optimizePositive) bits = (bits << 1) ^ static_cast<uint32_t>(value >> 31);
+    while (bits > 0x7F) {
+        writeByte(static_cast<uint8_t>((bits & 0x7F) | 0x80));
+        bits >>= 7;
+    }
+    writeByte(static_cast<uint8_t>(bits));
+}
+
+void SkeletonBinaryConverter::writeString(const char *value) {
+    if (!value) {
+        writeVarint(0, true);
+        return;
+    }
+    auto length = static_cast<int32_t>(strlen(value));
+    writeVarint(length + 1, true);
+    _body.insert(_body.end(), value, value + length);
+}
+
+void SkeletonBinaryConverter::writeStringRef(const char *value) {
+    if (!value) {
+        writeVarint(0, true);
+        return;
+    }
+    auto it = _stringRefs.find(value);
+    if (it == _stringRefs.end()) {
+        it = _stringRefs.emplace(value, static_cast<int>(_strings.size())).first;
+        _strings.emplace_back(value);
+    }
+    writeVarint(it->second + 1, true);
+}
+
+void SkeletonBinaryConverter::writeColor(const char *hex, uint32_t defaultValue) {
+    uint32_t color = 0;
+    for (std::size_t i = 0; i < 4; ++i) {
+        auto fallback = static_cast<uint8_t>(defaultValue >> (24 - i * 8));
+        color = (color << 8) | hexByte(hex, i, fallback);
+    }
+    writeInt(static_cast<int32_t>(color));
+}
+
+void SkeletonBinaryConverter::writeShortArray(Json *array) {
+    writeVarint(array ? array->_size : 0, true);
+    for (Json *entry = array ? array->_child : nullptr; entry; entry = entry->_next) {
+        auto value = static_cast<uint16_t>(entry->_valueInt);
+        writeByte(static_cast<uint8_t>(value >> 8));
+        writeByte(static_cast<uint8_t>(value));
+    }
+}
+
+int SkeletonBinaryConverter::indexOf(const std::unordered_map<std::string, int> &names, const char *name) const {
+    if (!name) return -1;
+    auto it = names.find(name);
+    return it == names.end() ? -1 : it->second;
+}
+
+bool SkeletonBinaryConverter::fail(const std::string &message, const char *detail) {
+    _error = message;
+    if (detail) _error += detail;
+    return false;
+}
+
+} // namespace spine
@@ -0,0 +1,107 @@
+/******************************************************************************
+ * Spine Runtimes License Agreement
+ * Last updated January 1, 2020. Replaces all prior versions.
+ *
+ * Copyright (c) 2013-2020, Esoteric Software LLC
+ *
+ * Integration of the Spine Runtimes into software or otherwise creating
+ * derivative works of the Spine Runtimes is permitted under the terms and
+ * conditions of Section 2 of the Spine Editor License Agreement:
+ * http://esotericsoftware.com/spine-editor-license
+ *
+ * Otherwise, it is permitted to integrate the Spine Runtimes into software
+ * or otherwise create derivative works of the Spine Runtimes (collectively,
+ * "Products"), provided that each user of the Products must obtain their own
+ * Spine Editor license and redistribution of the Products in any form must
+ * include this license and copyright notice.
+ *
+ * THE SPINE RUNTIMES ARE PROVIDED BY ESOTERIC SOFTWARE LLC "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES,
+ * BUSINESS INTERRUPTION, OR LOSS OF USE, DATA, OR PROFITS) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THE SPINE RUNTIMES, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace spine {
+
+class Json;
+
+/**
+ * Transcodes Spine JSON skeleton data into the binary layout read by
+ * SkeletonBinary. The binary form has no pointers or names to resolve, so it
+ * loads straight from a file buffer or mapping without building a JSON tree.
+ * Values are written unscaled, the loader still applies its own scale.
+ */
+class SkeletonBinaryConverter final {
+public:
+    SkeletonBinaryConverter() = default;
+    ~SkeletonBinaryConverter() = default;
+
+    /**
+     * @brief Converts json text to binary skeleton data.
+     * @return false on malformed input, getError() tells why.
+     */
+    bool convert(const char *json, std::vector<uint8_t> &out);
+    const std::string &getError() const { return _error; }
+
+private:
+    struct SkinInfo {
+        Json *map = nullptr;
+        Json *attachments = nullptr;
+        const char *name = nullptr;
+    };
+
+    struct DeformInfo {
+        int slotIndex = 0;
+        std::vector<Json *> timelines;
+    };
+
+    bool writeSkeleton(Json *root);
+    bool writeSkin(const SkinInfo &skin, bool defaultSkin);
+    bool writeAttachment(Json *attachmentMap);
+    void writeVertices(Json *attachmentMap, int verticesLength);
+    bool writeAnimation(Json *animationMap);
+    void writeCurve(Json *frame);
+
+    void writeByte(uint8_t value) { _body.push_back(value); }
+    void writeBoolean(bool value) { writeByte(value ? 1 : 0); }
+    void writeInt(int32_t value);
+    void writeFloat(float value);
+    void writeVarint(int32_t value, bool optimizePositive);
+    void writeString(const char *value);
+    void writeStringRef(const char *value);
+    void writeColor(const char *hex, uint32_t defaultValue);
+    void writeShortArray(Json *array);
+
+    int indexOf(const std::unordered_map<std::string, int> &names, const char *name) const;
+    bool fail(const std::string &message, const char *detail);
+
+    std::vector<uint8_t> _body;
+    std::size_t _headerSize = 0;
+    std::vector<std::string> _strings;
+    std::unordered_map<std::string, int> _stringRefs;
+    std::unordered_map<std::string, int> _bones;
+    std::unordered_map<std::string, int> _slots;
+    std::unordered_map<std::string, int> _ikConstraints;
+    std::unordered_map<std::string, int> _transformConstraints;
+    std::unordered_map<std::string, int> _pathConstraints;
+    std::unordered_map<std::string, int> _events;
+    std::unordered_map<std::string, int> _skinIndices;
+    std::unordered_map<std::string, std::unordered_map<int, std::vector<std::string>>> _skinAttachments;
+    std::vector<Json *> _eventMaps;
+    std::string _error;
+};
+
+} // namespace spine
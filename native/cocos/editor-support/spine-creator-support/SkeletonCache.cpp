@@ -28,7 +28,9 @@
  *****************************************************************************/
 
 #include "SkeletonCache.h"
+#include <chrono>
 #include "base/memory/Memory.h"
+#include "base/threading/ThreadPool.h"
 #include "spine-creator-support/AttachmentVertices.h"
 
 USING_NS_MW;        // NOLINT(google-build-using-namespace)
@@ -113,6 +115,20 @@ std::size_t SkeletonCache::FrameData::getSegmentCount() const {
     return _segments.size();
 }
 
+std::size_t SkeletonCache::FrameData::getCacheBytes() const {
+    return sizeof(FrameData) + vb.getCapacity() + ib.getCapacity() + _packedBuffers.getByteSize() +
+           _bones.size() * sizeof(BoneData) + _colors.size() * sizeof(ColorData) + _segments.size() * sizeof(SegmentData);
+}
+
+void SkeletonCache::FrameData::pack() {
+    // vertices carry both the tint and the dark color
+    _packedBuffers.pack(vb, ib, 2);
+}
+
+void SkeletonCache::FrameData::unpack() {
+    _packedBuffers.unpack(vb, ib);
+}
+
 SkeletonCache::AnimationData::AnimationData() = default;
 
 SkeletonCache::AnimationData::~AnimationData() {
@@ -126,6 +142,35 @@ void SkeletonCache::AnimationData::reset() {
     _frames.clear();
     _isComplete = false;
     _totalTime = 0.0F;
+    clearCache();
+}
+
+std::size_t SkeletonCache::AnimationData::packFrames() {
+    for (auto *frame : _frames) {
+        frame->pack();
+    }
+    return calcCacheBytes();
+}
+
+std::size_t SkeletonCache::AnimationData::unpackFrames() {
+    for (auto *frame : _frames) {
+        frame->unpack();
+    }
+    return calcCacheBytes();
+}
+
+std::size_t SkeletonCache::AnimationData::releaseFrames() {
+    // players of this animation bake it again from the first frame
+    reset();
+    return 0;
+}
+
+std::size_t SkeletonCache::AnimationData::calcCacheBytes() const {
+    std::size_t bytes = 0;
+    for (const auto *frame : _frames) {
+        bytes += frame->getCacheBytes();
+    }
+    return bytes;
 }
 
 bool SkeletonCache::AnimationData::needUpdate(int toFrameIdx) const {
@@ -143,20 +188,22 @@ SkeletonCache::FrameData *SkeletonCache::AnimationData::buildFrameData(std::size
     return _frames[frameIdx];
 }
 
-SkeletonCache::FrameData *SkeletonCache::AnimationData::getFrameData(std::size_t frameIdx) const {
-    if (frameIdx >= _frames.size()) {
+SkeletonCache::FrameData *SkeletonCache::AnimationData::getFrameData(std::size_t frameIdx) {
+    if (_baking || frameIdx >= _frames.size()) {
         return nullptr;
     }
+    touch();
     return _frames[frameIdx];
 }
 
 std::size_t SkeletonCache::AnimationData::getFrameCount() const {
-    return _frames.size();
+    return _baking ? 0 : _frames.size();
 }
 
 SkeletonCache::SkeletonCache() = default;
 
 SkeletonCache::~SkeletonCache() {
+    waitForBaking();
     for (auto &animationCache : _animationCaches) {
         delete animationCache.second;
     }
@@ -172,6 +219,7 @@ SkeletonCache::AnimationData *SkeletonCache::buildAnimationData(const std::strin
 
         aniData = new AnimationData();
         aniData->_animationName = animationName;
+        aniData->setStatName(_statName);
         _animationCaches[animationName] = aniData;
     } else {
         aniData = it->second;
@@ -196,6 +244,11 @@ void SkeletonCache::update(float deltaTime) {
 }
 
 void SkeletonCache::updateToFrame(const std::string &animationName, int toFrameIdx /*= -1*/) {
+    // the skeleton belongs to the worker until the background bake is published
+    if (!pollBaking()) {
+        return;
+    }
+
     auto it = _animationCaches.find(animationName);
     if (it == _animationCaches.end()) {
         return;
@@ -206,8 +259,26 @@ void SkeletonCache::updateToFrame(const std::string &animationName, int toFrameI
         return;
     }
 
+    animationData->touch();
+    beginBake(animationName, animationData);
+
+    std::size_t frameIndex = animationData->_frames.size();
+    bakeFrames(animationData, toFrameIdx);
+
+    std::size_t cacheBytes = animationData->getCacheBytes();
+    for (std::size_t n = animationData->_frames.size(); frameIndex < n; ++frameIndex) {
+        cacheBytes += animationData->_frames[frameIndex]->getCacheBytes();
+    }
+    animationData->setCacheBytes(cacheBytes);
+}
+
+void SkeletonCache::beginBake(const std::string &animationName, AnimationData *animationData) {
     if (_curAnimationName != animationName) {
-        updateToFrame(_curAnimationName);
+        // an evicted animation restarts from its first frame, there is nothing to finish
+        AnimationData *curAnimationData = getAnimationData(_curAnimationName);
+        if (curAnimationData && curAnimationData->getFrameCount() > 0) {
+            updateToFrame(_curAnimationName);
+        }
         _curAnimationName = animationName;
     }
 
@@ -215,7 +286,9 @@ void SkeletonCache::updateToFrame(const std::string &animationName, int toFrameI
     if (animationData->getFrameCount() == 0) {
         setAnimation(0, animationName, false);
     }
+}
 
+void SkeletonCache::bakeFrames(AnimationData *animationData, int toFrameIdx) {
     do {
         update(FrameTime);
         renderAnimationFrame(animationData);
@@ -223,8 +296,74 @@ void SkeletonCache::updateToFrame(const std::string &animationName, int toFrameI
     } while (animationData->needUpdate(toFrameIdx));
 }
 
+void SkeletonCache::bakeAnimationAsync(const std::string &animationName) {
+    if (_bakingData) {
+        return;
+    }
+
+    AnimationData *animationData = getAnimationData(animationName);
+    if (!animationData || animationData->getFrameCount() > 0 || !animationData->needUpdate(-1)) {
+        return;
+    }
+
+    beginBake(animationName, animationData);
+    _bakingData = animationData;
+    animationData->_baking = true;
+
+    auto task = std::make_shared<std::packaged_task<void()>>([this, animationData]() {
+        bakeFrames(animationData, -1);
+    });
+    // a task dropped by a stopping pool still makes the future ready
+    _bakeFuture = task->get_future();
+    cc::ThreadPool::getInstance()->dispatch([task]() { (*task)(); }, cc::TaskPriority::LOW);
+}
+
+bool SkeletonCache::pollBaking() {
+    if (!_bakingData) {
+        return true;
+    }
+    if (_bakeFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return false;
+    }
+    publishBaking();
+    return true;
+}
+
+void SkeletonCache::waitForBaking() {
+    if (!_bakingData) {
+        return;
+    }
+    _bakeFuture.wait();
+    publishBaking();
+}
+
+void SkeletonCache::publishBaking() {
+    AnimationData *animationData = _bakingData;
+    _bakingData = nullptr;
+    _bakeFuture = std::future<void>();
+
+    // textures are only referenced on this thread, the worker stored them unreferenced
+    for (auto *frame : animationData->_frames) {
+        for (auto *segment : frame->_segments) {
+            CC_SAFE_ADD_REF(segment->_texture);
+        }
+    }
+
+    animationData->_baking = false;
+    animationData->touch();
+    animationData->setCacheBytes(animationData->calcCacheBytes());
+}
+
+void SkeletonCache::setStatName(const std::string &name) {
+    _statName = name;
+    for (auto &animationCache : _animationCaches) {
+        animationCache.second->setStatName(name);
+    }
+}
+
 void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
-    std::size_t frameIndex = animationData->getFrameCount();
+    // getFrameCount hides the frames of a background bake, the worker appends after all of them
+    std::size_t frameIndex = animationData->_frames.size();
     FrameData *frameData = animationData->buildFrameData(frameIndex);
 
     if (!_skeleton) return;
@@ -276,7 +415,12 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
         }
 
         SegmentData *segmentData = frameData->buildSegmentData(materialLen);
-        segmentData->setTexture(texture);
+        if (_bakingData) {
+            // referenced once the frames are published on the main thread
+            segmentData->_texture = texture;
+        } else {
+            segmentData->setTexture(texture);
+        }
         segmentData->blendMode = slot->getData().getBlendMode();
 
         // save new segment count pos field
@@ -527,7 +671,8 @@ void SkeletonCache::onAnimationStateEvent(TrackEntry *entry, EventType type, Eve
         if (!ani) return;
         std::string aniName = ani->getName().buffer();
         if (aniName == _curAnimationName) {
-            AnimationData *aniData = getAnimationData(_curAnimationName);
+            // the animation map may change on the main thread during a background bake
+            AnimationData *aniData = _bakingData ? _bakingData : getAnimationData(_curAnimationName);
             if (!aniData) return;
             aniData->_isComplete = true;
         }
@@ -535,12 +680,14 @@ void SkeletonCache::onAnimationStateEvent(TrackEntry *entry, EventType type, Eve
 }
 
 void SkeletonCache::resetAllAnimationData() {
+    waitForBaking();
     for (auto &animationCache : _animationCaches) {
         animationCache.second->reset();
     }
 }
 
 void SkeletonCache::resetAnimationData(const std::string &animationName) {
+    waitForBaking();
     for (auto &animationCache : _animationCaches) {
         if (animationCache.second->_animationName == animationName) {
             animationCache.second->reset();
@@ -29,7 +29,9 @@
 
 #pragma once
 
+#include <future>
 #include <vector>
+#include "FrameCacheBudget.h"
 #include "IOBuffer.h"
 #include "SkeletonAnimation.h"
 #include "middleware-adapter.h"
@@ -86,7 +88,13 @@ public:
         }
         std::size_t getSegmentCount() const;
 
+        // bytes held by the frame, packed or not
+        std::size_t getCacheBytes() const;
+
     private:
+        void pack();
+        void unpack();
+
         // if segment data is empty, it will build new one.
         SegmentData *buildSegmentData(std::size_t index);
         // if color data is empty, it will build new one.
@@ -97,32 +105,43 @@ public:
         std::vector<BoneData *> _bones;
         std::vector<ColorData *> _colors;
         std::vector<SegmentData *> _segments;
+        cc::middleware::PackedFrameBuffers _packedBuffers;
 
     public:
         cc::middleware::IOBuffer ib;
         cc::middleware::IOBuffer vb;
     };
 
-    struct AnimationData {
+    struct AnimationData : public cc::middleware::FrameCacheEntry {
         friend class SkeletonCache;
 
         AnimationData();
-        ~AnimationData();
+        ~AnimationData() override;
         void reset();
 
-        FrameData *getFrameData(std::size_t frameIdx) const;
+        // Frames of an animation which is being baked in background are not visible yet.
+        FrameData *getFrameData(std::size_t frameIdx);
         std::size_t getFrameCount() const;
 
-        bool isComplete() const { return _isComplete; }
+        bool isComplete() const { return !_baking && _isComplete; }
         bool needUpdate(int toFrameIdx) const;
 
+    protected:
+        bool isPackable() const override { return !needUpdate(-1); }
+        bool isEvictable() const override { return !_baking; }
+        std::size_t packFrames() override;
+        std::size_t unpackFrames() override;
+        std::size_t releaseFrames() override;
+
     private:
         // if frame is empty, it will build new one.
         FrameData *buildFrameData(std::size_t frameIdx);
+        std::size_t calcCacheBytes() const;
 
     private:
         std::string _animationName = "";
         bool _isComplete = false;
+        bool _baking = false;
         float _totalTime = 0.0f;
         std::vector<FrameData *> _frames;
     };
@@ -143,7 +162,24 @@ public:
     void resetAllAnimationData();
     void resetAnimationData(const std::string &animationName);
 
+    /**
+     * @brief Bake all frames of an animation on a worker thread.
+     * The skeleton belongs to the worker meanwhile, so other animations of this cache
+     * are not baked until the frames are published by updateToFrame or waitForBaking.
+     */
+    void bakeAnimationAsync(const std::string &animationName);
+    // Block until the background bake is done and publish its frames.
+    void waitForBaking();
+    bool isBaking() const { return _bakingData != nullptr; }
+
+    // Memory stat name of all animations of this skeleton.
+    void setStatName(const std::string &name);
+
 private:
+    void beginBake(const std::string &animationName, AnimationData *animationData);
+    void bakeFrames(AnimationData *animationData, int toFrameIdx);
+    bool pollBaking();
+    void publishBaking();
     void renderAnimationFrame(AnimationData *animationData);
 
 public:
@@ -152,6 +188,9 @@ public:
 
 private:
     std::string _curAnimationName = "";
+    std::string _statName;
     std::map<std::string, AnimationData *> _animationCaches;
+    AnimationData *_bakingData = nullptr;
+    std::future<void> _bakeFuture;
 };
 } // namespace spine
@@ -37,6 +37,7 @@
 #include "base/memory/Memory.h"
 #include "gfx-base/GFXDef.h"
 #include "math/Math.h"
+#include "math/MathUtil.h"
 #include "renderer/core/MaterialInstance.h"
 
 USING_NS_MW; // NOLINT(google-build-using-namespace)
@@ -313,12 +314,8 @@ void SkeletonCacheAnimation::render(float /*dt*/) {
         }
         // batch handle
         if (_enableBatch) {
-            cc::Vec3 *point = nullptr;
-            for (auto posIndex = 0; posIndex < vertexFloats; posIndex += vs) {
-                point = reinterpret_cast<cc::Vec3 *>(dstVertexBuffer + posIndex);
-                point->z = 0;
-                point->transformMat4(*point, nodeWorldMat);
-            }
+            auto vertexCount = static_cast<uint32_t>((vertexFloats + vs - 1) / vs);
+            cc::MathUtil::transformVec2Strided(nodeWorldMat.m, dstVertexBuffer, vs, dstVertexBuffer, vs, vertexCount);
         }
         // handle vertex color
         if (needColor) {
@@ -398,34 +395,41 @@ void SkeletonCacheAnimation::paused(bool value) {
 }
 
 Bone *SkeletonCacheAnimation::findBone(const std::string &boneName) const {
+    _skeletonCache->waitForBaking();
     return _skeletonCache->findBone(boneName);
 }
 
 Slot *SkeletonCacheAnimation::findSlot(const std::string &slotName) const {
+    _skeletonCache->waitForBaking();
     return _skeletonCache->findSlot(slotName);
 }
 
 void SkeletonCacheAnimation::setSkin(const std::string &skinName) {
+    _skeletonCache->waitForBaking();
     _skeletonCache->setSkin(skinName);
     _skeletonCache->resetAllAnimationData();
 }
 
 void SkeletonCacheAnimation::setSkin(const char *skinName) {
+    _skeletonCache->waitForBaking();
     _skeletonCache->setSkin(skinName);
     _skeletonCache->resetAllAnimationData();
 }
 
 Attachment *SkeletonCacheAnimation::getAttachment(const std::string &slotName, const std::string &attachmentName) const {
+    _skeletonCache->waitForBaking();
     return _skeletonCache->getAttachment(slotName, attachmentName);
 }
 
 bool SkeletonCacheAnimation::setAttachment(const std::string &slotName, const std::string &attachmentName) {
+    _skeletonCache->waitForBaking();
     auto ret = _skeletonCache->setAttachment(slotName, attachmentName);
     _skeletonCache->resetAllAnimationData();
     return ret;
 }
 
 bool SkeletonCacheAnimation::setAttachment(const std::string &slotName, const char *attachmentName) {
+    _skeletonCache->waitForBaking();
     auto ret = _skeletonCache->setAttachment(slotName, attachmentName);
     _skeletonCache->resetAllAnimationData();
     return ret;
@@ -494,6 +498,10 @@ void SkeletonCacheAnimation::setAnimation(const std::string &name, bool loop) {
     _accTime = 0.0F;
     _playCount = 0;
     _curFrameIndex = 0;
+
+    if (_animationData && SkeletonCacheMgr::getInstance()->isBackgroundBakeEnabled()) {
+        _skeletonCache->bakeAnimationAsync(_animationName);
+    }
 }
 
 void SkeletonCacheAnimation::addAnimation(const std::string &name, bool loop, float delay) {
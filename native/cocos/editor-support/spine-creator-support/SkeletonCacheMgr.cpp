@@ -38,6 +38,7 @@ SkeletonCache *SkeletonCacheMgr::buildSkeletonCache(const std::string &uuid) {
         animation = new SkeletonCache();
         animation->addRef();
         animation->initWithUUID(uuid);
+        animation->setStatName("SkeletonCache " + uuid);
         _caches.insert(uuid, animation);
         cc::DeferredReleasePool::add(animation);
     }
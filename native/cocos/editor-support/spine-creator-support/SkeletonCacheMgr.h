@@ -52,9 +52,17 @@ public:
     void removeSkeletonCache(const std::string &uuid);
     SkeletonCache *buildSkeletonCache(const std::string &uuid);
 
+    /**
+     * @brief Bake animations on a worker thread when they start playing,
+     * an animation is not drawn until all of its frames are baked.
+     */
+    void setBackgroundBakeEnabled(bool enabled) { _backgroundBakeEnabled = enabled; }
+    bool isBackgroundBakeEnabled() const { return _backgroundBakeEnabled; }
+
 private:
     static SkeletonCacheMgr *instance;
     cc::RefMap<std::string, SkeletonCache *> _caches;
+    bool _backgroundBakeEnabled = false;
 };
 
 } // namespace spine
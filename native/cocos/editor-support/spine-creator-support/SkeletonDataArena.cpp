@@ -0,0 +1,175 @@
+/******************************************************************************
+ * Spine Runtimes License Agreement
+ * Last updated January 1, 2020. Replaces all prior versions.
+ *
+ * Copyright (c) 2013-2020, Esoteric Software LLC
+ *
+ * Integration of the Spine Runtimes into software or otherwise creating
+ * derivative works of the Spine Runtimes is permitted under the terms and
+ * conditions of Section 2 of the Spine Editor License Agreement:
+ * http://esotericsoftware.com/spine-editor-license
+ *
+ * Otherwise, it is permitted to integrate the Spine Runtimes into software
+ * or otherwise create derivative works of the Spine Runtimes (collectively,
+ * "Products"), provided that each user of the Products must obtain their own
+ * Spine Editor license and redistribution of the Products in any form must
+ * include this license and copyright notice.
+ *
+ * THE SPINE RUNTIMES ARE PROVIDED BY ESOTERIC SOFTWARE LLC "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES,
+ * BUSINESS INTERRUPTION, OR LOSS OF USE, DATA, OR PROFITS) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THE SPINE RUNTIMES, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "SkeletonDataArena.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace spine {
+
+namespace {
+
+constexpr std::size_t ALIGNMENT = alignof(std::max_align_t);
+
+inline std::size_t alignUp(std::size_t size) {
+    return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+// Every block is preceded by its size, so reallocate knows how much to copy,
+// and by where it lives, so frees coming from any thread need no lookup.
+struct BlockHeader {
+    std::size_t size;
+    uint32_t tag;
+};
+
+constexpr uint32_t ARENA_TAG = 0x414E5241; // "ARNA"
+constexpr uint32_t HEAP_TAG = 0x50414548;  // "HEAP"
+constexpr std::size_t HEADER_SIZE = (sizeof(BlockHeader) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+inline BlockHeader &header(const void *ptr) {
+    return *reinterpret_cast<BlockHeader *>(const_cast<uint8_t *>(static_cast<const uint8_t *>(ptr) - sizeof(BlockHeader)));
+}
+
+inline void *tagBlock(uint8_t *block, std::size_t size, uint32_t tag) {
+    void *ptr = block + HEADER_SIZE;
+    header(ptr) = {size, tag};
+    return ptr;
+}
+
+inline uint8_t *blockStart(void *ptr) {
+    return static_cast<uint8_t *>(ptr) - HEADER_SIZE;
+}
+
+void *allocateHeap(std::size_t size, bool zeroed) {
+    auto *block = static_cast<uint8_t *>(zeroed ? std::calloc(1, HEADER_SIZE + size) : std::malloc(HEADER_SIZE + size));
+    return block ? tagBlock(block, size, HEAP_TAG) : nullptr;
+}
+
+thread_local SkeletonDataArena *currentArena = nullptr;
+
+} // namespace
+
+SkeletonDataArena::Scope::Scope(SkeletonDataArena *arena) : _previous(currentArena) {
+    currentArena = arena;
+}
+
+SkeletonDataArena::Scope::~Scope() {
+    currentArena = _previous;
+}
+
+SkeletonDataArena::~SkeletonDataArena() {
+    for (auto &chunk : _chunks) {
+        std::free(chunk.data);
+    }
+    _chunks.clear();
+}
+
+void *SkeletonDataArena::allocate(std::size_t size, bool zeroed) {
+    if (size == 0) return nullptr;
+    if (currentArena) return currentArena->allocateBlock(size);
+    return allocateHeap(size, zeroed);
+}
+
+bool SkeletonDataArena::owns(const void *ptr) {
+    return ptr && header(ptr).tag == ARENA_TAG;
+}
+
+void *SkeletonDataArena::reallocate(void *ptr, std::size_t size) {
+    if (!ptr) return allocate(size);
+    if (header(ptr).tag == HEAP_TAG) {
+        auto *block = static_cast<uint8_t *>(std::realloc(blockStart(ptr), HEADER_SIZE + size));
+        return block ? tagBlock(block, size, HEAP_TAG) : nullptr;
+    }
+    if (currentArena) {
+        if (void *grown = currentArena->growLastBlock(ptr, size)) {
+            return grown;
+        }
+    }
+    void *mem = allocate(size);
+    if (mem) {
+        memcpy(mem, ptr, std::min(size, header(ptr).size));
+    }
+    return mem;
+}
+
+void SkeletonDataArena::release(void *ptr) {
+    if (ptr && header(ptr).tag == HEAP_TAG) {
+        std::free(blockStart(ptr));
+    }
+}
+
+void *SkeletonDataArena::allocateBlock(std::size_t size) {
+    std::size_t needed = HEADER_SIZE + alignUp(size);
+    uint8_t *block = nullptr;
+    if (needed > CHUNK_SIZE / 4) {
+        // Large arrays get a chunk of their own so the shared one is not wasted.
+        block = addChunk(needed).data;
+    } else {
+        if (_cursor == nullptr || static_cast<std::size_t>(_end - _cursor) < needed) {
+            Chunk &chunk = addChunk(CHUNK_SIZE);
+            _cursor = chunk.data;
+            _end = chunk.data + chunk.size;
+        }
+        block = _cursor;
+        _cursor += needed;
+    }
+    _usedBytes += needed;
+    _lastBlock = tagBlock(block, size, ARENA_TAG);
+    return _lastBlock;
+}
+
+void *SkeletonDataArena::growLastBlock(void *ptr, std::size_t size) {
+    // Vectors filled while loading mostly grow their newest buffer, extend it in
+    // place instead of leaving the old copy behind.
+    if (ptr != _lastBlock || _cursor == nullptr) return nullptr;
+    auto *block = static_cast<uint8_t *>(ptr);
+    std::size_t oldEnd = alignUp(header(ptr).size);
+    if (block + oldEnd != _cursor) return nullptr;
+    std::size_t newEnd = alignUp(size);
+    if (newEnd > oldEnd) {
+        if (static_cast<std::size_t>(_end - block) < newEnd) return nullptr;
+        _cursor = block + newEnd;
+        _usedBytes += newEnd - oldEnd;
+    }
+    header(ptr).size = std::max(size, header(ptr).size);
+    return ptr;
+}
+
+SkeletonDataArena::Chunk &SkeletonDataArena::addChunk(std::size_t size) {
+    Chunk chunk;
+    // Chunk memory is never reused, zeroing it once serves calloc requests.
+    chunk.data = static_cast<uint8_t *>(std::calloc(1, size));
+    chunk.size = size;
+    _reservedBytes += size;
+    _chunks.push_back(chunk);
+    return _chunks.back();
+}
+
+} // namespace spine
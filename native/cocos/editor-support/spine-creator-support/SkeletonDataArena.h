@@ -0,0 +1,110 @@
+/******************************************************************************
+ * Spine Runtimes License Agreement
+ * Last updated January 1, 2020. Replaces all prior versions.
+ *
+ * Copyright (c) 2013-2020, Esoteric Software LLC
+ *
+ * Integration of the Spine Runtimes into software or otherwise creating
+ * derivative works of the Spine Runtimes is permitted under the terms and
+ * conditions of Section 2 of the Spine Editor License Agreement:
+ * http://esotericsoftware.com/spine-editor-license
+ *
+ * Otherwise, it is permitted to integrate the Spine Runtimes into software
+ * or otherwise create derivative works of the Spine Runtimes (collectively,
+ * "Products"), provided that each user of the Products must obtain their own
+ * Spine Editor license and redistribution of the Products in any form must
+ * include this license and copyright notice.
+ *
+ * THE SPINE RUNTIMES ARE PROVIDED BY ESOTERIC SOFTWARE LLC "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES,
+ * BUSINESS INTERRUPTION, OR LOSS OF USE, DATA, OR PROFITS) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THE SPINE RUNTIMES, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace spine {
+
+/**
+ * Bump allocator that backs every spine allocation made while a Scope is
+ * active on the calling thread. A skeleton data loaded inside a scope lives in
+ * a few large chunks instead of thousands of small heap blocks, and the whole
+ * arena is dropped at once after the skeleton data is deleted.
+ *
+ * Allocations made without a scope come from the heap. Every block carries a
+ * header telling where it lives, so frees from any thread need no lookup: frees
+ * of arena memory are no-ops and reallocations copy out of the arena, so data
+ * objects may still be edited at runtime after loading.
+ */
+class SkeletonDataArena final {
+public:
+    class Scope final {
+    public:
+        explicit Scope(SkeletonDataArena *arena);
+        ~Scope();
+
+    private:
+        SkeletonDataArena *_previous = nullptr;
+    };
+
+    static constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+
+    SkeletonDataArena() = default;
+    ~SkeletonDataArena();
+
+    SkeletonDataArena(const SkeletonDataArena &) = delete;
+    SkeletonDataArena &operator=(const SkeletonDataArena &) = delete;
+
+    std::size_t getReservedBytes() const { return _reservedBytes; }
+    std::size_t getUsedBytes() const { return _usedBytes; }
+
+    /**
+     * @brief Allocates from the arena bound to the calling thread, from the heap
+     * if no scope is active. Arena memory is always zeroed.
+     */
+    static void *allocate(std::size_t size, bool zeroed = false);
+    /**
+     * @brief Whether ptr, returned by allocate or reallocate, lives in an arena.
+     */
+    static bool owns(const void *ptr);
+    /**
+     * @brief Resizes a block returned by allocate. Arena blocks are moved to a
+     * new block, from the active arena if any, from the heap otherwise, and the
+     * old block is left in place.
+     */
+    static void *reallocate(void *ptr, std::size_t size);
+    /**
+     * @brief Frees a heap block returned by allocate, arena blocks are released
+     * with their arena.
+     */
+    static void release(void *ptr);
+
+private:
+    struct Chunk {
+        uint8_t *data = nullptr;
+        std::size_t size = 0;
+    };
+
+    void *allocateBlock(std::size_t size);
+    void *growLastBlock(void *ptr, std::size_t size);
+    Chunk &addChunk(std::size_t size);
+
+    std::vector<Chunk> _chunks;
+    uint8_t *_cursor = nullptr;
+    uint8_t *_end = nullptr;
+    void *_lastBlock = nullptr;
+    std::size_t _reservedBytes = 0;
+    std::size_t _usedBytes = 0;
+};
+
+} // namespace spine
@@ -30,6 +30,7 @@
 #include "SkeletonDataMgr.h"
 #include <algorithm>
 #include <vector>
+#include "SkeletonDataArena.h"
 
 using namespace spine; //NOLINT
 
@@ -54,11 +55,17 @@ public:
             delete attachmentLoader;
             attachmentLoader = nullptr;
         }
+
+        if (arena) {
+            delete arena;
+            arena = nullptr;
+        }
     }
 
     SkeletonData *data = nullptr;
     Atlas *atlas = nullptr;
     AttachmentLoader *attachmentLoader = nullptr;
+    SkeletonDataArena *arena = nullptr;
     std::vector<int> texturesIndex;
 };
 
@@ -79,7 +86,7 @@ bool SkeletonDataMgr::hasSkeletonData(const std::string &uuid) {
     return it != _dataMap.end();
 }
 
-void SkeletonDataMgr::setSkeletonData(const std::string &uuid, SkeletonData *data, Atlas *atlas, AttachmentLoader *attachmentLoader, const std::vector<int> &texturesIndex) {
+void SkeletonDataMgr::setSkeletonData(const std::string &uuid, SkeletonData *data, Atlas *atlas, AttachmentLoader *attachmentLoader, const std::vector<int> &texturesIndex, SkeletonDataArena *arena) {
     auto it = _dataMap.find(uuid);
     if (it != _dataMap.end()) {
         releaseByUUID(uuid);
@@ -88,6 +95,7 @@ void SkeletonDataMgr::setSkeletonData(const std::string &uuid, SkeletonData *dat
     info->data = data;
     info->atlas = atlas;
     info->attachmentLoader = attachmentLoader;
+    info->arena = arena;
     info->texturesIndex = texturesIndex;
     _dataMap[uuid] = info;
 }
@@ -39,6 +39,7 @@
 
 namespace spine {
 
+class SkeletonDataArena;
 class SkeletonDataInfo;
 
 /**
@@ -64,12 +65,20 @@ public:
     ~SkeletonDataMgr();
 
     bool hasSkeletonData(const std::string &uuid);
-    void setSkeletonData(const std::string &uuid, SkeletonData *data, Atlas *atlas, AttachmentLoader *attachmentLoader, const std::vector<int> &texturesIndex);
+    // arena, if any, backs the data objects and is released after them
+    void setSkeletonData(const std::string &uuid, SkeletonData *data, Atlas *atlas, AttachmentLoader *attachmentLoader, const std::vector<int> &texturesIndex, SkeletonDataArena *arena = nullptr);
     // equal to 'findByUUID'
     SkeletonData *retainByUUID(const std::string &uuid);
     // equal to 'deleteByUUID'
     void releaseByUUID(const std::string &uuid);
 
+    /**
+     * @brief Directory where json skeleton data is cached in binary form after
+     * its first load, empty disables the cache.
+     */
+    void setPrecompiledCachePath(const std::string &path) { _precompiledCachePath = path; }
+    const std::string &getPrecompiledCachePath() const { return _precompiledCachePath; }
+
     using destroyCallback = std::function<void(int)>;
     void setDestroyCallback(destroyCallback callback) {
         _destroyCallback = std::move(callback);
@@ -79,6 +88,7 @@ private:
     static SkeletonDataMgr *instance;
     destroyCallback _destroyCallback = nullptr;
     std::map<std::string, SkeletonDataInfo *> _dataMap;
+    std::string _precompiledCachePath;
 };
 
 } // namespace spine
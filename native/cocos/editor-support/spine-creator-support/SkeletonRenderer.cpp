@@ -39,6 +39,7 @@
 #include "base/memory/Memory.h"
 #include "gfx-base/GFXDef.h"
 #include "math/Math.h"
+#include "math/MathUtil.h"
 #include "math/Vec3.h"
 #include "renderer/core/MaterialInstance.h"
 #include "spine-creator-support/AttachmentVertices.h"
@@ -256,37 +257,13 @@ void SkeletonRenderer::initWithBinaryFile(const std::string &skeletonDataFile, c
     initialize();
 }
 
-void SkeletonRenderer::render(float /*deltaTime*/) {
-    if (!_skeleton) return;
-    auto *entity = _entity;
-    entity->clearDynamicRenderDrawInfos();
-    _sharedBufferOffset->reset();
-    _sharedBufferOffset->clear();
-
-    // avoid other place call update.
-    auto *mgr = MiddlewareManager::getInstance();
-    if (!mgr->isRendering) return;
-
-    auto *attachMgr = mgr->getAttachInfoMgr();
-    auto *attachInfo = attachMgr->getBuffer();
-    if (!attachInfo) return;
-    // store attach info offset
-    _sharedBufferOffset->writeUint32(static_cast<uint32_t>(attachInfo->getCurPos()) / sizeof(uint32_t));
-
-    // If opacity is 0,then return.
-    if (_skeleton->getColor().a == 0) {
-        return;
-    }
-    auto &nodeWorldMat = entity->getNode()->getWorldMatrix();
+template <typename Commit>
+void SkeletonRenderer::emitSlots(cc::middleware::IOBuffer &vb, cc::middleware::IOBuffer &ib, const cc::Mat4 &nodeWorldMat, Commit &&commit) {
     // color range is [0.0, 1.0]
     cc::middleware::Color4F color;
     cc::middleware::Color4F darkColor;
     AttachmentVertices *attachmentVertices = nullptr;
     bool inRange = !(_startSlotIndex != -1 || _endSlotIndex != -1);
-    auto vertexFormat = _useTint ? VF_XYZUVCC : VF_XYZUVC;
-    cc::middleware::MeshBuffer *mb = mgr->getMeshBuffer(vertexFormat);
-    cc::middleware::IOBuffer &vb = mb->getVB();
-    cc::middleware::IOBuffer &ib = mb->getIB();
 
     // vertex size int bytes with one color
     unsigned int vbs1 = sizeof(V3F_T2F_C4B);
@@ -305,16 +282,6 @@ void SkeletonRenderer::render(float /*deltaTime*/) {
     unsigned int vbSize = 0;
     unsigned int ibSize = 0;
 
-    int curBlendSrc = -1;
-    int curBlendDst = -1;
-    int curBlendMode = -1;
-    int preBlendMode = -1;
-    uint32_t curISegLen = 0;
-    cc::Texture2D *preTexture = nullptr;
-    cc::Texture2D *curTexture = nullptr;
-    RenderDrawInfo *curDrawInfo = nullptr;
-
-    int materialLen = 0;
     Slot *slot = nullptr;
     int isFull = 0;
 
@@ -326,51 +293,6 @@ void SkeletonRenderer::render(float /*deltaTime*/) {
         _debugBuffer->reset();
     }
 
-    auto flush = [&]() {
-        // fill pre segment indices count field
-        if (curDrawInfo) {
-            curDrawInfo->setIbCount(curISegLen);
-        }
-        curDrawInfo = requestDrawInfo(materialLen);
-        entity->addDynamicRenderDrawInfo(curDrawInfo);
-        // prepare to fill new segment field
-        curBlendMode = slot->getData().getBlendMode();
-        switch (curBlendMode) {
-            case BlendMode_Additive:
-                curBlendSrc = static_cast<int>(_premultipliedAlpha ? BlendFactor::ONE : BlendFactor::SRC_ALPHA);
-                curBlendDst = static_cast<int>(BlendFactor::ONE);
-                break;
-            case BlendMode_Multiply:
-                curBlendSrc = static_cast<int>(BlendFactor::DST_COLOR);
-                curBlendDst = static_cast<int>(BlendFactor::ONE_MINUS_SRC_ALPHA);
-                break;
-            case BlendMode_Screen:
-                curBlendSrc = static_cast<int>(BlendFactor::ONE);
-                curBlendDst = static_cast<int>(BlendFactor::ONE_MINUS_SRC_COLOR);
-                break;
-            default:
-                curBlendSrc = static_cast<int>(_premultipliedAlpha ? BlendFactor::ONE : BlendFactor::SRC_ALPHA);
-                curBlendDst = static_cast<int>(BlendFactor::ONE_MINUS_SRC_ALPHA);
-        }
-        auto *material = requestMaterial(curBlendSrc, curBlendDst);
-        curDrawInfo->setMaterial(material);
-        gfx::Texture *texture = curTexture->getGFXTexture();
-        gfx::Sampler *sampler = curTexture->getGFXSampler();
-        curDrawInfo->setTexture(texture);
-        curDrawInfo->setSampler(sampler);
-        auto *uiMeshBuffer = mb->getUIMeshBuffer();
-        curDrawInfo->setMeshBuffer(uiMeshBuffer);
-        curDrawInfo->setIndexOffset(static_cast<uint32_t>(ib.getCurPos()) / sizeof(uint16_t));
-        // reset pre blend mode to current
-        preBlendMode = static_cast<int>(slot->getData().getBlendMode());
-        // reset pre texture index to current
-        preTexture = curTexture;
-        // reset index segmentation count
-        curISegLen = 0;
-        // material length increased
-        materialLen++;
-    };
-
     VertexEffect *effect = nullptr;
     if (_effectDelegate) {
         effect = _effectDelegate->getVertexEffect();
@@ -714,19 +636,114 @@ void SkeletonRenderer::render(float /*deltaTime*/) {
             }
         }
 
-        curTexture = (cc::Texture2D *)attachmentVertices->_texture->getRealTexture();
-        // If texture or blendMode change,will change material.
-        if (preTexture != curTexture || preBlendMode != slot->getData().getBlendMode() || isFull) {
-            flush();
-        }
         if (_enableBatch) {
-            uint8_t *vbBuffer = vb.getCurBuffer();
-            cc::Vec3 *point = nullptr;
-            for (unsigned int ii = 0, nn = vbSize; ii < nn; ii += vbs) {
-                point = reinterpret_cast<cc::Vec3 *>(vbBuffer + ii);
-                point->z = 0;
-                point->transformMat4(*point, nodeWorldMat);
-            }
+            auto *vbBuffer = reinterpret_cast<float *>(vb.getCurBuffer());
+            unsigned int vs = _useTint ? vs2 : vs1;
+            unsigned int vertexCount = (vbSize + vbs - 1) / vbs;
+            cc::MathUtil::transformVec2Strided(nodeWorldMat.m, vbBuffer, vs, vbBuffer, vs, vertexCount);
+        }
+        commit(attachmentVertices->_texture, static_cast<int>(slot->getData().getBlendMode()), vbSize, ibSize, isFull != 0);
+
+        _clipper->clipEnd(*slot);
+    } // End slot traverse
+
+    _clipper->clipEnd();
+
+    if (effect) effect->end();
+}
+
+void SkeletonRenderer::render(float /*deltaTime*/) {
+    // Segments emitted by emitVertices are only valid for the current frame.
+    bool segmentsEmitted = _segmentsEmitted;
+    _segmentsEmitted = false;
+
+    if (!_skeleton) return;
+    auto *entity = _entity;
+    entity->clearDynamicRenderDrawInfos();
+    _sharedBufferOffset->reset();
+    _sharedBufferOffset->clear();
+
+    // avoid other place call update.
+    auto *mgr = MiddlewareManager::getInstance();
+    if (!mgr->isRendering) return;
+
+    auto *attachMgr = mgr->getAttachInfoMgr();
+    auto *attachInfo = attachMgr->getBuffer();
+    if (!attachInfo) return;
+    // store attach info offset
+    _sharedBufferOffset->writeUint32(static_cast<uint32_t>(attachInfo->getCurPos()) / sizeof(uint32_t));
+
+    // If opacity is 0,then return.
+    if (_skeleton->getColor().a == 0) {
+        return;
+    }
+    auto vertexFormat = _useTint ? VF_XYZUVCC : VF_XYZUVC;
+    cc::middleware::MeshBuffer *mb = mgr->getMeshBuffer(vertexFormat);
+    cc::middleware::IOBuffer &vb = mb->getVB();
+    cc::middleware::IOBuffer &ib = mb->getIB();
+
+    // vertex size in bytes
+    unsigned int vbs = _useTint ? sizeof(V3F_T2F_C4B_C4B) : sizeof(V3F_T2F_C4B);
+
+    int curBlendSrc = -1;
+    int curBlendDst = -1;
+    int preBlendMode = -1;
+    uint32_t curISegLen = 0;
+    cc::Texture2D *preTexture = nullptr;
+    RenderDrawInfo *curDrawInfo = nullptr;
+
+    int materialLen = 0;
+
+    auto flush = [&](cc::Texture2D *curTexture, int curBlendMode) {
+        // fill pre segment indices count field
+        if (curDrawInfo) {
+            curDrawInfo->setIbCount(curISegLen);
+        }
+        curDrawInfo = requestDrawInfo(materialLen);
+        entity->addDynamicRenderDrawInfo(curDrawInfo);
+        // prepare to fill new segment field
+        switch (curBlendMode) {
+            case BlendMode_Additive:
+                curBlendSrc = static_cast<int>(_premultipliedAlpha ? BlendFactor::ONE : BlendFactor::SRC_ALPHA);
+                curBlendDst = static_cast<int>(BlendFactor::ONE);
+                break;
+            case BlendMode_Multiply:
+                curBlendSrc = static_cast<int>(BlendFactor::DST_COLOR);
+                curBlendDst = static_cast<int>(BlendFactor::ONE_MINUS_SRC_ALPHA);
+                break;
+            case BlendMode_Screen:
+                curBlendSrc = static_cast<int>(BlendFactor::ONE);
+                curBlendDst = static_cast<int>(BlendFactor::ONE_MINUS_SRC_COLOR);
+                break;
+            default:
+                curBlendSrc = static_cast<int>(_premultipliedAlpha ? BlendFactor::ONE : BlendFactor::SRC_ALPHA);
+                curBlendDst = static_cast<int>(BlendFactor::ONE_MINUS_SRC_ALPHA);
+        }
+        auto *material = requestMaterial(curBlendSrc, curBlendDst);
+        curDrawInfo->setMaterial(material);
+        gfx::Texture *texture = curTexture->getGFXTexture();
+        gfx::Sampler *sampler = curTexture->getGFXSampler();
+        curDrawInfo->setTexture(texture);
+        curDrawInfo->setSampler(sampler);
+        auto *uiMeshBuffer = mb->getUIMeshBuffer();
+        curDrawInfo->setMeshBuffer(uiMeshBuffer);
+        curDrawInfo->setIndexOffset(static_cast<uint32_t>(ib.getCurPos()) / sizeof(uint16_t));
+        // reset pre blend mode to current
+        preBlendMode = curBlendMode;
+        // reset pre texture index to current
+        preTexture = curTexture;
+        // reset index segmentation count
+        curISegLen = 0;
+        // material length increased
+        materialLen++;
+    };
+
+    // Appends the vertices and indices of one slot, which are placed at the current position of vb and ib.
+    auto commit = [&](middleware::Texture2D *attachmentTexture, int curBlendMode, unsigned int vbSize, unsigned int ibSize, bool isFull) {
+        auto *curTexture = (cc::Texture2D *)attachmentTexture->getRealTexture();
+        // If texture or blendMode change,will change material.
+        if (preTexture != curTexture || preBlendMode != curBlendMode || isFull) {
+            flush(curTexture, curBlendMode);
         }
         auto vertexOffset = vb.getCurPos() / vbs;
         if (vbSize > 0 && ibSize > 0) {
@@ -742,13 +759,26 @@ void SkeletonRenderer::render(float /*deltaTime*/) {
             // Record this turn index segmentation count,it will store in material buffer in the end.
             curISegLen += ibSize / sizeof(uint16_t);
         }
+    };
 
-        _clipper->clipEnd(*slot);
-    } // End slot traverse
-
-    _clipper->clipEnd();
-
-    if (effect) effect->end();
+    if (segmentsEmitted) {
+        // Stitch the vertices emitted on a worker thread into the shared buffers, the same way they are emitted below.
+        const uint8_t *segmentVerts = _segmentVB.getBuffer();
+        const uint8_t *segmentIndices = _segmentIB.getBuffer();
+        for (const auto &segment : _segments) {
+            int isFull = vb.checkSpace(segment.vbSize, true);
+            ib.checkSpace(segment.ibSize, true);
+            if (segment.vbSize > 0 && segment.ibSize > 0) {
+                memcpy(vb.getCurBuffer(), segmentVerts, segment.vbSize);
+                memcpy(ib.getCurBuffer(), segmentIndices, segment.ibSize);
+                segmentVerts += segment.vbSize;
+                segmentIndices += segment.ibSize;
+            }
+            commit(segment.texture, segment.blendMode, segment.vbSize, segment.ibSize, isFull != 0);
+        }
+    } else {
+        emitSlots(vb, ib, entity->getNode()->getWorldMatrix(), commit);
+    }
 
     if (curDrawInfo) curDrawInfo->setIbCount(curISegLen);
 
@@ -798,6 +828,35 @@ void SkeletonRenderer::render(float /*deltaTime*/) {
     }
 }
 
+bool SkeletonRenderer::prepareVertices() {
+    // A vertex effect delegate may be shared by several skeletons and the debug buffer is a script
+    // object, keep those on this thread.
+    if (!_skeleton || !_entity || _effectDelegate || _debugSlots || _debugBones || _debugMesh) {
+        return false;
+    }
+    // Updating the world matrix touches the parent nodes, do it before going wide.
+    _nodeWorldMat.set(_entity->getNode()->getWorldMatrix());
+    return true;
+}
+
+void SkeletonRenderer::emitVertices() {
+    _segmentVB.reset();
+    _segmentIB.reset();
+    _segments.clear();
+
+    if (_skeleton->getColor().a != 0) {
+        emitSlots(_segmentVB, _segmentIB, _nodeWorldMat, [this](middleware::Texture2D *texture, int blendMode, unsigned int vbSize, unsigned int ibSize, bool /*isFull*/) {
+            // Indices stay relative to the slot, they are offset when stitched in render.
+            _segments.push_back({texture, blendMode, vbSize, ibSize});
+            if (vbSize > 0 && ibSize > 0) {
+                _segmentVB.move(static_cast<int>(vbSize));
+                _segmentIB.move(static_cast<int>(ibSize));
+            }
+        });
+    }
+    _segmentsEmitted = true;
+}
+
 cc::Rect SkeletonRenderer::getBoundingBox() const {
     static cc::middleware::IOBuffer buffer(1024);
     float *worldVertices = nullptr;
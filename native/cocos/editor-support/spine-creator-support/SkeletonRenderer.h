@@ -61,6 +61,8 @@ public:
 
     void update(float deltaTime) override {}
     void render(float deltaTime) override;
+    bool prepareVertices() override;
+    void emitVertices() override;
     virtual cc::Rect getBoundingBox() const;
 
     Skeleton *getSkeleton() const;
@@ -154,6 +156,21 @@ public:
 protected:
     void setSkeletonData(SkeletonData *skeletonData, bool ownsSkeletonData);
 
+    /**
+     * Writes the vertices and indices of every visible slot at the current position of vb and ib,
+     * then hands them to commit, which advances the buffers.
+     */
+    template <typename Commit>
+    void emitSlots(cc::middleware::IOBuffer &vb, cc::middleware::IOBuffer &ib, const cc::Mat4 &nodeWorldMat, Commit &&commit);
+
+    // Vertices of one slot emitted by emitVertices, indices are relative to the first vertex of the slot.
+    struct VertexSegment {
+        cc::middleware::Texture2D *texture;
+        int blendMode;
+        unsigned int vbSize;
+        unsigned int ibSize;
+    };
+
     bool _ownsSkeletonData = false;
     bool _ownsSkeleton = false;
     bool _ownsAtlas = false;
@@ -185,6 +202,12 @@ protected:
     cc::Material *_material = nullptr;
     ccstd::vector<cc::RenderDrawInfo *> _drawInfoArray;
     ccstd::unordered_map<uint32_t, cc::Material*> _materialCaches;
+
+    cc::Mat4 _nodeWorldMat;
+    cc::middleware::IOBuffer _segmentVB;
+    cc::middleware::IOBuffer _segmentIB;
+    ccstd::vector<VertexSegment> _segments;
+    bool _segmentsEmitted = false;
 };
 
 } // namespace spine
@@ -32,6 +32,7 @@
 #include "middleware-adapter.h"
 #include "platform/FileUtils.h"
 #include "spine-creator-support/AttachmentVertices.h"
+#include "spine-creator-support/SkeletonDataArena.h"
 
 namespace spine {
 static CustomTextureLoader customTextureLoader = nullptr;
@@ -136,7 +137,8 @@ char *Cocos2dExtension::_readFile(const spine::String &path, int *length) {
     Data data = FileUtils::getInstance()->getDataFromFile(FileUtils::getInstance()->fullPathForFilename(path.buffer()));
     if (data.isNull()) return nullptr;
 
-    char *ret = static_cast<char *>(malloc(sizeof(unsigned char) * data.getSize()));
+    // Freed through the extension, which expects its own block header.
+    char *ret = SpineExtension::alloc<char>(data.getSize(), __FILE__, __LINE__);
     memcpy(ret, reinterpret_cast<char *>(data.getBytes()), data.getSize());
     *length = static_cast<int>(data.getSize());
     return ret;
@@ -146,7 +148,26 @@ SpineExtension *spine::getDefaultExtension() {
     return new Cocos2dExtension();
 }
 
-void Cocos2dExtension::_free(void *mem, const char *file, int line) {
+// Every block comes from SkeletonDataArena, which tags it with where it lives.
+void *Cocos2dExtension::_alloc(size_t size, const char * /*file*/, int /*line*/) {
+    return SkeletonDataArena::allocate(size);
+}
+
+void *Cocos2dExtension::_calloc(size_t size, const char * /*file*/, int /*line*/) {
+    return SkeletonDataArena::allocate(size, true);
+}
+
+void *Cocos2dExtension::_realloc(void *ptr, size_t size, const char * /*file*/, int /*line*/) {
+    // same as realloc, shrinking to nothing frees the block
+    if (size == 0) {
+        SkeletonDataArena::release(ptr);
+        return nullptr;
+    }
+    return SkeletonDataArena::reallocate(ptr, size);
+}
+
+void Cocos2dExtension::_free(void *mem, const char * /*file*/, int /*line*/) {
     spineObjectDisposeCallback(mem);
-    DefaultSpineExtension::_free(mem, file, line);
+    // Arena memory is released with the skeleton data that owns it.
+    SkeletonDataArena::release(mem);
 }
@@ -66,6 +66,12 @@ public:
 
     virtual ~Cocos2dExtension();
 
+    virtual void *_alloc(size_t size, const char *file, int line);
+
+    virtual void *_calloc(size_t size, const char *file, int line);
+
+    virtual void *_realloc(void *ptr, size_t size, const char *file, int line);
+
     virtual void _free(void *mem, const char *file, int line);
 
 protected:
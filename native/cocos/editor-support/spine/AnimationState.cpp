@@ -462,6 +462,16 @@ bool AnimationState::apply(Skeleton &skeleton) {
     return applied;
 }
 
+bool AnimationState::setEventDrainDeferred(bool deferred) {
+    bool oldDrainDisabled = _queue->_drainDisabled;
+    _queue->_drainDisabled = deferred;
+    return oldDrainDisabled;
+}
+
+void AnimationState::drainEvents() {
+    _queue->drain();
+}
+
 void AnimationState::clearTracks() {
     bool oldDrainDisabled = _queue->_drainDisabled;
     _queue->_drainDisabled = true;
@@ -315,6 +315,14 @@ public:
     /// animation state can be applied to multiple skeletons to pose them identically.
     bool apply(Skeleton& skeleton);
 
+    /// While deferred, events queued by update and apply are kept until drainEvents is called, so the pose can be
+    /// applied on another thread and listeners are still invoked on the calling one.
+    /// @return The previous state, to be restored once the pose is applied.
+    bool setEventDrainDeferred(bool deferred);
+
+    /// Invokes the listeners of all queued events.
+    void drainEvents();
+
     /// Removes all animations from all tracks, leaving skeletons in their previous pose.
     /// It may be desired to use AnimationState.setEmptyAnimations(float) to mix the skeletons back to the setup pose,
     /// rather than leaving them in their previous pose.
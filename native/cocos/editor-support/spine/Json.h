@@ -40,6 +40,7 @@
 namespace spine {
 class SP_API Json {
     friend class SkeletonJson;
+    friend class SkeletonBinaryConverter;
 
 public:
     /* Json Types: */
@@ -29,11 +29,13 @@
 #include <sstream>
 #include "base/DeferredReleasePool.h"
 #include "base/Macros.h"
+#include "base/threading/ThreadPool.h"
 #include "bindings/jswrapper/SeApi.h"
 #include "core/builtin/BuiltinResMgr.h"
 #include "engine/EngineEvents.h"
 #include "platform/BasePlatform.h"
 #include "platform/FileUtils.h"
+#include "platform/ImageDecoder.h"
 #include "renderer/GFXDeviceManager.h"
 #include "renderer/core/ProgramLib.h"
 #include "renderer/pipeline/RenderPipeline.h"
@@ -55,6 +57,10 @@
     #include "editor-support/spine-creator-support/SkeletonCacheMgr.h"
 #endif
 
+#if CC_USE_MIDDLEWARE
+    #include "editor-support/FrameCacheBudget.h"
+#endif
+
 #include "application/ApplicationManager.h"
 #include "application/BaseApplication.h"
 #include "base/Scheduler.h"
@@ -145,6 +151,10 @@ int32_t Engine::init() {
 void Engine::destroy() {
     cc::DeferredReleasePool::clear();
     cc::network::HttpClient::destroyInstance();
+    // The decoder runs on the pool. Stopping the pool runs the tasks still queued on this thread,
+    // so the decoder is cancelled first to keep them from decoding the remaining requests.
+    cc::ImageDecoder::destroyInstance();
+    cc::ThreadPool::destroyInstance();
     _scheduler->removeAllFunctionsToBePerformedInCocosThread();
     _scheduler->unscheduleAll();
     CCObject::deferredDestroy();
@@ -186,6 +196,7 @@ void Engine::destroy() {
 
 #if CC_USE_MIDDLEWARE
     cc::middleware::MiddlewareManager::destroyInstance();
+    cc::middleware::FrameCacheBudget::destroyInstance();
 #endif
 
     CCObject::deferredDestroy();
@@ -64,6 +64,8 @@ This file was modified to fit the cocos2d-x project
 #ifdef INCLUDE_SSE
     #include "math/MathUtilSSE.inl"
 #endif
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include "math/MathUtil.inl"
 
@@ -279,6 +281,96 @@ void MathUtil::crossVec3(const float *v1, const float *v2, float *dst) {
 #endif
 }
 
+void MathUtil::multiplyJointMatrices(const float *m1, const float *m2, uint32_t count, float *dst) {
+#ifdef USE_NEON32
+    MathUtilNeon::multiplyJointMatrices(m1, m2, count, dst);
+#elif defined(USE_NEON64)
+    MathUtilNeon64::multiplyJointMatrices(m1, m2, count, dst);
+#elif defined(INCLUDE_NEON32)
+    if (isNeon32Enabled()) {
+        MathUtilNeon::multiplyJointMatrices(m1, m2, count, dst);
+    } else {
+        MathUtilC::multiplyJointMatrices(m1, m2, count, dst);
+    }
+#elif defined(USE_SSE)
+    MathUtilSSE::multiplyJointMatrices(m1, m2, count, dst);
+#else
+    MathUtilC::multiplyJointMatrices(m1, m2, count, dst);
+#endif
+}
+
+void MathUtil::mergeTransformedAABBs(const float *m, const float *centers, const float *halfExtents, uint32_t count, float *outMin, float *outMax) {
+#ifdef USE_NEON32
+    MathUtilNeon::mergeTransformedAABBs(m, centers, halfExtents, count, outMin, outMax);
+#elif defined(USE_NEON64)
+    MathUtilNeon64::mergeTransformedAABBs(m, centers, halfExtents, count, outMin, outMax);
+#elif defined(INCLUDE_NEON32)
+    if (isNeon32Enabled()) {
+        MathUtilNeon::mergeTransformedAABBs(m, centers, halfExtents, count, outMin, outMax);
+    } else {
+        MathUtilC::mergeTransformedAABBs(m, centers, halfExtents, count, outMin, outMax);
+    }
+#elif defined(USE_SSE)
+    MathUtilSSE::mergeTransformedAABBs(m, centers, halfExtents, count, outMin, outMax);
+#else
+    MathUtilC::mergeTransformedAABBs(m, centers, halfExtents, count, outMin, outMax);
+#endif
+}
+
+void MathUtil::transformVec3Strided(const float *m, const float *src, uint32_t srcStride, float *dst, uint32_t dstStride, uint32_t count) {
+#ifdef USE_NEON32
+    MathUtilNeon::transformVec3Strided(m, src, srcStride, dst, dstStride, count);
+#elif defined(USE_NEON64)
+    MathUtilNeon64::transformVec3Strided(m, src, srcStride, dst, dstStride, count);
+#elif defined(INCLUDE_NEON32)
+    if (isNeon32Enabled()) {
+        MathUtilNeon::transformVec3Strided(m, src, srcStride, dst, dstStride, count);
+    } else {
+        MathUtilC::transformVec3Strided(m, src, srcStride, dst, dstStride, count);
+    }
+#elif defined(USE_SSE)
+    MathUtilSSE::transformVec3Strided(m, src, srcStride, dst, dstStride, count);
+#else
+    MathUtilC::transformVec3Strided(m, src, srcStride, dst, dstStride, count);
+#endif
+}
+
+void MathUtil::transformVec2Strided(const float *m, const float *src, uint32_t srcStride, float *dst, uint32_t dstStride, uint32_t count) {
+#ifdef USE_NEON32
+    MathUtilNeon::transformVec2Strided(m, src, srcStride, dst, dstStride, count);
+#elif defined(USE_NEON64)
+    MathUtilNeon64::transformVec2Strided(m, src, srcStride, dst, dstStride, count);
+#elif defined(INCLUDE_NEON32)
+    if (isNeon32Enabled()) {
+        MathUtilNeon::transformVec2Strided(m, src, srcStride, dst, dstStride, count);
+    } else {
+        MathUtilC::transformVec2Strided(m, src, srcStride, dst, dstStride, count);
+    }
+#elif defined(USE_SSE)
+    MathUtilSSE::transformVec2Strided(m, src, srcStride, dst, dstStride, count);
+#else
+    MathUtilC::transformVec2Strided(m, src, srcStride, dst, dstStride, count);
+#endif
+}
+
+void MathUtil::fillVec4Strided(const float *v, float *dst, uint32_t dstStride, uint32_t count) {
+#ifdef USE_NEON32
+    MathUtilNeon::fillVec4Strided(v, dst, dstStride, count);
+#elif defined(USE_NEON64)
+    MathUtilNeon64::fillVec4Strided(v, dst, dstStride, count);
+#elif defined(INCLUDE_NEON32)
+    if (isNeon32Enabled()) {
+        MathUtilNeon::fillVec4Strided(v, dst, dstStride, count);
+    } else {
+        MathUtilC::fillVec4Strided(v, dst, dstStride, count);
+    }
+#elif defined(USE_SSE)
+    MathUtilSSE::fillVec4Strided(v, dst, dstStride, count);
+#else
+    MathUtilC::fillVec4Strided(v, dst, dstStride, count);
+#endif
+}
+
 void MathUtil::combineHash(size_t &seed, const size_t &v) {
     seed ^= v + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 }
@@ -95,6 +95,60 @@ public:
      */
     static void combineHash(size_t &seed, const size_t &v);
 
+    /**
+     * Multiplies count pairs of column-major 4x4 matrices, m1[i] * m2[i], and stores each
+     * product as a 3x4 joint matrix: the first three columns of the product with its
+     * translation packed into their w component. This is the layout of the skinning joint
+     * uniforms and textures.
+     *
+     * @param m1 count tightly packed matrices.
+     * @param m2 count tightly packed matrices.
+     * @param count the number of matrix pairs.
+     * @param dst receives 12 * count floats.
+     */
+    static void multiplyJointMatrices(const float *m1, const float *m2, uint32_t count, float *dst);
+
+    /**
+     * Transforms count axis-aligned boxes by the matching affine matrices and merges the
+     * transformed boxes into one.
+     *
+     * @param m count tightly packed column-major 4x4 affine matrices.
+     * @param centers count tightly packed xyz box centers.
+     * @param halfExtents count tightly packed xyz box half extents.
+     * @param count the number of boxes.
+     * @param outMin the xyz minimum of the merged box, it is merged with the incoming value.
+     * @param outMax the xyz maximum of the merged box, it is merged with the incoming value.
+     */
+    static void mergeTransformedAABBs(const float *m, const float *centers, const float *halfExtents, uint32_t count, float *outMin, float *outMax);
+
+    /**
+     * Transforms count xyz positions interleaved in a vertex buffer by an affine matrix.
+     * Only the three position floats of each destination vertex are written, src may equal dst.
+     *
+     * @param m a column-major 4x4 affine matrix.
+     * @param src the first source position.
+     * @param srcStride the distance in floats between two source positions.
+     * @param dst the first destination position.
+     * @param dstStride the distance in floats between two destination positions.
+     * @param count the number of positions.
+     */
+    static void transformVec3Strided(const float *m, const float *src, uint32_t srcStride, float *dst, uint32_t dstStride, uint32_t count);
+
+    /**
+     * Same as transformVec3Strided, but the source z is taken as 0. 2D vertices often leave it unset.
+     */
+    static void transformVec2Strided(const float *m, const float *src, uint32_t srcStride, float *dst, uint32_t dstStride, uint32_t count);
+
+    /**
+     * Writes the same four floats, usually a color, into count vertices.
+     *
+     * @param v the four floats to write.
+     * @param dst the first destination, dstStride must be at least 4.
+     * @param dstStride the distance in floats between two destinations.
+     * @param count the number of vertices.
+     */
+    static void fillVec4Strided(const float *v, float *dst, uint32_t dstStride, uint32_t count);
+
 private:
     //Indicates that if neon is enabled
     static bool isNeon32Enabled();
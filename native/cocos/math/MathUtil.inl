@@ -44,6 +44,16 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+
+    inline static void multiplyJointMatrices(const float* m1, const float* m2, uint32_t count, float* dst);
+
+    inline static void mergeTransformedAABBs(const float* m, const float* centers, const float* halfExtents, uint32_t count, float* outMin, float* outMax);
+
+    inline static void transformVec3Strided(const float* m, const float* src, uint32_t srcStride, float* dst, uint32_t dstStride, uint32_t count);
+
+    inline static void transformVec2Strided(const float* m, const float* src, uint32_t srcStride, float* dst, uint32_t dstStride, uint32_t count);
+
+    inline static void fillVec4Strided(const float* v, float* dst, uint32_t dstStride, uint32_t count);
 };
 
 inline void MathUtilC::addMatrix(const float* m, float scalar, float* dst)
@@ -217,4 +227,72 @@ inline void MathUtilC::crossVec3(const float* v1, const float* v2, float* dst)
     dst[2] = z;
 }
 
+inline void MathUtilC::multiplyJointMatrices(const float* m1, const float* m2, uint32_t count, float* dst)
+{
+    for (uint32_t i = 0; i < count; ++i, m1 += 16, m2 += 16, dst += 12)
+    {
+        for (uint32_t col = 0; col < 3; ++col)
+        {
+            const float* c = m2 + col * 4;
+            dst[col * 4 + 0] = m1[0] * c[0] + m1[4] * c[1] + m1[8]  * c[2] + m1[12] * c[3];
+            dst[col * 4 + 1] = m1[1] * c[0] + m1[5] * c[1] + m1[9]  * c[2] + m1[13] * c[3];
+            dst[col * 4 + 2] = m1[2] * c[0] + m1[6] * c[1] + m1[10] * c[2] + m1[14] * c[3];
+        }
+        const float* t = m2 + 12;
+        dst[3]  = m1[0] * t[0] + m1[4] * t[1] + m1[8]  * t[2] + m1[12] * t[3];
+        dst[7]  = m1[1] * t[0] + m1[5] * t[1] + m1[9]  * t[2] + m1[13] * t[3];
+        dst[11] = m1[2] * t[0] + m1[6] * t[1] + m1[10] * t[2] + m1[14] * t[3];
+    }
+}
+
+inline void MathUtilC::mergeTransformedAABBs(const float* m, const float* centers, const float* halfExtents, uint32_t count, float* outMin, float* outMax)
+{
+    for (uint32_t i = 0; i < count; ++i, m += 16, centers += 3, halfExtents += 3)
+    {
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            const float c = m[k] * centers[0] + m[4 + k] * centers[1] + m[8 + k] * centers[2] + m[12 + k];
+            const float e = std::abs(m[k]) * halfExtents[0] + std::abs(m[4 + k]) * halfExtents[1] + std::abs(m[8 + k]) * halfExtents[2];
+            outMin[k] = std::min(outMin[k], c - e);
+            outMax[k] = std::max(outMax[k], c + e);
+        }
+    }
+}
+
+inline void MathUtilC::transformVec3Strided(const float* m, const float* src, uint32_t srcStride, float* dst, uint32_t dstStride, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i, src += srcStride, dst += dstStride)
+    {
+        const float x = src[0];
+        const float y = src[1];
+        const float z = src[2];
+        dst[0] = m[0] * x + m[4] * y + m[8]  * z + m[12];
+        dst[1] = m[1] * x + m[5] * y + m[9]  * z + m[13];
+        dst[2] = m[2] * x + m[6] * y + m[10] * z + m[14];
+    }
+}
+
+inline void MathUtilC::transformVec2Strided(const float* m, const float* src, uint32_t srcStride, float* dst, uint32_t dstStride, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i, src += srcStride, dst += dstStride)
+    {
+        const float x = src[0];
+        const float y = src[1];
+        dst[0] = m[0] * x + m[4] * y + m[12];
+        dst[1] = m[1] * x + m[5] * y + m[13];
+        dst[2] = m[2] * x + m[6] * y + m[14];
+    }
+}
+
+inline void MathUtilC::fillVec4Strided(const float* v, float* dst, uint32_t dstStride, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i, dst += dstStride)
+    {
+        dst[0] = v[0];
+        dst[1] = v[1];
+        dst[2] = v[2];
+        dst[3] = v[3];
+    }
+}
+
 NS_CC_MATH_END
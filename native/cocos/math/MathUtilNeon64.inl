@@ -20,6 +20,8 @@
  This file was modified to fit the cocos2d-x project
  */
 
+#include <arm_neon.h>
+
 NS_CC_MATH_BEGIN
 
 class MathUtilNeon64
@@ -44,6 +46,16 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+
+    inline static void multiplyJointMatrices(const float* m1, const float* m2, uint32_t count, float* dst);
+
+    inline static void mergeTransformedAABBs(const float* m, const float* centers, const float* halfExtents, uint32_t count, float* outMin, float* outMax);
+
+    inline static void transformVec3Strided(const float* m, const float* src, uint32_t srcStride, float* dst, uint32_t dstStride, uint32_t count);
+
+    inline static void transformVec2Strided(const float* m, const float* src, uint32_t srcStride, float* dst, uint32_t dstStride, uint32_t count);
+
+    inline static void fillVec4Strided(const float* v, float* dst, uint32_t dstStride, uint32_t count);
 };
 
 inline void MathUtilNeon64::addMatrix(const float* m, float scalar, float* dst)
@@ -262,4 +274,104 @@ inline void MathUtilNeon64::crossVec3(const float* v1, const float* v2, float* d
     );
 }
 
+inline void MathUtilNeon64::multiplyJointMatrices(const float* m1, const float* m2, uint32_t count, float* dst)
+{
+    for (uint32_t i = 0; i < count; ++i, m1 += 16, m2 += 16, dst += 12)
+    {
+        const float32x4_t a0 = vld1q_f32(m1);
+        const float32x4_t a1 = vld1q_f32(m1 + 4);
+        const float32x4_t a2 = vld1q_f32(m1 + 8);
+        const float32x4_t a3 = vld1q_f32(m1 + 12);
+
+        float32x4_t c[4];
+        for (uint32_t col = 0; col < 4; ++col)
+        {
+            const float* b = m2 + col * 4;
+            c[col] = vmulq_n_f32(a0, b[0]);
+            c[col] = vmlaq_n_f32(c[col], a1, b[1]);
+            c[col] = vmlaq_n_f32(c[col], a2, b[2]);
+            c[col] = vmlaq_n_f32(c[col], a3, b[3]);
+        }
+
+        // pack the translation into the w lanes
+        vst1q_f32(dst,     vsetq_lane_f32(vgetq_lane_f32(c[3], 0), c[0], 3));
+        vst1q_f32(dst + 4, vsetq_lane_f32(vgetq_lane_f32(c[3], 1), c[1], 3));
+        vst1q_f32(dst + 8, vsetq_lane_f32(vgetq_lane_f32(c[3], 2), c[2], 3));
+    }
+}
+
+inline void MathUtilNeon64::mergeTransformedAABBs(const float* m, const float* centers, const float* halfExtents, uint32_t count, float* outMin, float* outMax)
+{
+    float tmp[4] = {outMin[0], outMin[1], outMin[2], 0.F};
+    float32x4_t boundMin = vld1q_f32(tmp);
+    tmp[0] = outMax[0]; tmp[1] = outMax[1]; tmp[2] = outMax[2];
+    float32x4_t boundMax = vld1q_f32(tmp);
+
+    for (uint32_t i = 0; i < count; ++i, m += 16, centers += 3, halfExtents += 3)
+    {
+        const float32x4_t col0 = vld1q_f32(m);
+        const float32x4_t col1 = vld1q_f32(m + 4);
+        const float32x4_t col2 = vld1q_f32(m + 8);
+        const float32x4_t col3 = vld1q_f32(m + 12);
+
+        float32x4_t c = vmlaq_n_f32(col3, col0, centers[0]);
+        c = vmlaq_n_f32(c, col1, centers[1]);
+        c = vmlaq_n_f32(c, col2, centers[2]);
+
+        float32x4_t e = vmulq_n_f32(vabsq_f32(col0), halfExtents[0]);
+        e = vmlaq_n_f32(e, vabsq_f32(col1), halfExtents[1]);
+        e = vmlaq_n_f32(e, vabsq_f32(col2), halfExtents[2]);
+
+        boundMin = vminq_f32(boundMin, vsubq_f32(c, e));
+        boundMax = vmaxq_f32(boundMax, vaddq_f32(c, e));
+    }
+
+    vst1q_f32(tmp, boundMin);
+    outMin[0] = tmp[0]; outMin[1] = tmp[1]; outMin[2] = tmp[2];
+    vst1q_f32(tmp, boundMax);
+    outMax[0] = tmp[0]; outMax[1] = tmp[1]; outMax[2] = tmp[2];
+}
+
+// writes xyz only, the float after a position usually belongs to the next attribute
+inline void MathUtilNeon64::transformVec3Strided(const float* m, const float* src, uint32_t srcStride, float* dst, uint32_t dstStride, uint32_t count)
+{
+    const float32x4_t col0 = vld1q_f32(m);
+    const float32x4_t col1 = vld1q_f32(m + 4);
+    const float32x4_t col2 = vld1q_f32(m + 8);
+    const float32x4_t col3 = vld1q_f32(m + 12);
+
+    for (uint32_t i = 0; i < count; ++i, src += srcStride, dst += dstStride)
+    {
+        float32x4_t p = vmlaq_n_f32(col3, col0, src[0]);
+        p = vmlaq_n_f32(p, col1, src[1]);
+        p = vmlaq_n_f32(p, col2, src[2]);
+        vst1_f32(dst, vget_low_f32(p));
+        vst1q_lane_f32(dst + 2, p, 2);
+    }
+}
+
+inline void MathUtilNeon64::transformVec2Strided(const float* m, const float* src, uint32_t srcStride, float* dst, uint32_t dstStride, uint32_t count)
+{
+    const float32x4_t col0 = vld1q_f32(m);
+    const float32x4_t col1 = vld1q_f32(m + 4);
+    const float32x4_t col3 = vld1q_f32(m + 12);
+
+    for (uint32_t i = 0; i < count; ++i, src += srcStride, dst += dstStride)
+    {
+        float32x4_t p = vmlaq_n_f32(col3, col0, src[0]);
+        p = vmlaq_n_f32(p, col1, src[1]);
+        vst1_f32(dst, vget_low_f32(p));
+        vst1q_lane_f32(dst + 2, p, 2);
+    }
+}
+
+inline void MathUtilNeon64::fillVec4Strided(const float* v, float* dst, uint32_t dstStride, uint32_t count)
+{
+    const float32x4_t value = vld1q_f32(v);
+    for (uint32_t i = 0; i < count; ++i, dst += dstStride)
+    {
+        vst1q_f32(dst, value);
+    }
+}
+
 NS_CC_MATH_END
@@ -175,5 +175,125 @@ void MathUtil::transformVec4(const __m128 m[4], const __m128& v, __m128& dst)
 
 #endif
 
+#ifdef __SSE__
+
+class MathUtilSSE
+{
+public:
+    inline static void multiplyJointMatrices(const float* m1, const float* m2, uint32_t count, float* dst);
+
+    inline static void mergeTransformedAABBs(const float* m, const float* centers, const float* halfExtents, uint32_t count, float* outMin, float* outMax);
+
+    inline static void transformVec3Strided(const float* m, const float* src, uint32_t srcStride, float* dst, uint32_t dstStride, uint32_t count);
+
+    inline static void transformVec2Strided(const float* m, const float* src, uint32_t srcStride, float* dst, uint32_t dstStride, uint32_t count);
+
+    inline static void fillVec4Strided(const float* v, float* dst, uint32_t dstStride, uint32_t count);
+};
+
+inline void MathUtilSSE::multiplyJointMatrices(const float* m1, const float* m2, uint32_t count, float* dst)
+{
+    for (uint32_t i = 0; i < count; ++i, m1 += 16, m2 += 16, dst += 12)
+    {
+        const __m128 a0 = _mm_loadu_ps(m1);
+        const __m128 a1 = _mm_loadu_ps(m1 + 4);
+        const __m128 a2 = _mm_loadu_ps(m1 + 8);
+        const __m128 a3 = _mm_loadu_ps(m1 + 12);
+
+        __m128 c[4];
+        for (uint32_t col = 0; col < 4; ++col)
+        {
+            const float* b = m2 + col * 4;
+            c[col] = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(a0, _mm_set1_ps(b[0])), _mm_mul_ps(a1, _mm_set1_ps(b[1]))),
+                _mm_add_ps(_mm_mul_ps(a2, _mm_set1_ps(b[2])), _mm_mul_ps(a3, _mm_set1_ps(b[3]))));
+        }
+
+        // (c.x, c.y, c.z, t.k): the translation of column 3 is packed into the w lanes
+        __m128 tmp = _mm_shuffle_ps(c[0], c[3], _MM_SHUFFLE(0, 0, 2, 2));
+        _mm_storeu_ps(dst, _mm_shuffle_ps(c[0], tmp, _MM_SHUFFLE(2, 0, 1, 0)));
+        tmp = _mm_shuffle_ps(c[1], c[3], _MM_SHUFFLE(1, 1, 2, 2));
+        _mm_storeu_ps(dst + 4, _mm_shuffle_ps(c[1], tmp, _MM_SHUFFLE(2, 0, 1, 0)));
+        tmp = _mm_shuffle_ps(c[2], c[3], _MM_SHUFFLE(2, 2, 2, 2));
+        _mm_storeu_ps(dst + 8, _mm_shuffle_ps(c[2], tmp, _MM_SHUFFLE(2, 0, 1, 0)));
+    }
+}
+
+inline void MathUtilSSE::mergeTransformedAABBs(const float* m, const float* centers, const float* halfExtents, uint32_t count, float* outMin, float* outMax)
+{
+    const __m128 signMask = _mm_set1_ps(-0.F);
+    __m128 boundMin = _mm_setr_ps(outMin[0], outMin[1], outMin[2], 0.F);
+    __m128 boundMax = _mm_setr_ps(outMax[0], outMax[1], outMax[2], 0.F);
+
+    for (uint32_t i = 0; i < count; ++i, m += 16, centers += 3, halfExtents += 3)
+    {
+        const __m128 col0 = _mm_loadu_ps(m);
+        const __m128 col1 = _mm_loadu_ps(m + 4);
+        const __m128 col2 = _mm_loadu_ps(m + 8);
+        const __m128 col3 = _mm_loadu_ps(m + 12);
+
+        const __m128 c = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(centers[0])), _mm_mul_ps(col1, _mm_set1_ps(centers[1]))),
+            _mm_add_ps(_mm_mul_ps(col2, _mm_set1_ps(centers[2])), col3));
+        const __m128 e = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, col0), _mm_set1_ps(halfExtents[0])),
+                       _mm_mul_ps(_mm_andnot_ps(signMask, col1), _mm_set1_ps(halfExtents[1]))),
+            _mm_mul_ps(_mm_andnot_ps(signMask, col2), _mm_set1_ps(halfExtents[2])));
+
+        boundMin = _mm_min_ps(boundMin, _mm_sub_ps(c, e));
+        boundMax = _mm_max_ps(boundMax, _mm_add_ps(c, e));
+    }
+
+    float tmp[4];
+    _mm_storeu_ps(tmp, boundMin);
+    outMin[0] = tmp[0]; outMin[1] = tmp[1]; outMin[2] = tmp[2];
+    _mm_storeu_ps(tmp, boundMax);
+    outMax[0] = tmp[0]; outMax[1] = tmp[1]; outMax[2] = tmp[2];
+}
+
+// writes xyz only, the float after a position usually belongs to the next attribute
+inline void MathUtilSSE::transformVec3Strided(const float* m, const float* src, uint32_t srcStride, float* dst, uint32_t dstStride, uint32_t count)
+{
+    const __m128 col0 = _mm_loadu_ps(m);
+    const __m128 col1 = _mm_loadu_ps(m + 4);
+    const __m128 col2 = _mm_loadu_ps(m + 8);
+    const __m128 col3 = _mm_loadu_ps(m + 12);
+
+    for (uint32_t i = 0; i < count; ++i, src += srcStride, dst += dstStride)
+    {
+        const __m128 p = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(src[0])), _mm_mul_ps(col1, _mm_set1_ps(src[1]))),
+            _mm_add_ps(_mm_mul_ps(col2, _mm_set1_ps(src[2])), col3));
+        _mm_storel_pi(reinterpret_cast<__m64*>(dst), p);
+        _mm_store_ss(dst + 2, _mm_movehl_ps(p, p));
+    }
+}
+
+inline void MathUtilSSE::transformVec2Strided(const float* m, const float* src, uint32_t srcStride, float* dst, uint32_t dstStride, uint32_t count)
+{
+    const __m128 col0 = _mm_loadu_ps(m);
+    const __m128 col1 = _mm_loadu_ps(m + 4);
+    const __m128 col3 = _mm_loadu_ps(m + 12);
+
+    for (uint32_t i = 0; i < count; ++i, src += srcStride, dst += dstStride)
+    {
+        const __m128 p = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(src[0])), _mm_mul_ps(col1, _mm_set1_ps(src[1]))),
+            col3);
+        _mm_storel_pi(reinterpret_cast<__m64*>(dst), p);
+        _mm_store_ss(dst + 2, _mm_movehl_ps(p, p));
+    }
+}
+
+inline void MathUtilSSE::fillVec4Strided(const float* v, float* dst, uint32_t dstStride, uint32_t count)
+{
+    const __m128 value = _mm_loadu_ps(v);
+    for (uint32_t i = 0; i < count; ++i, dst += dstStride)
+    {
+        _mm_storeu_ps(dst, value);
+    }
+}
+
+#endif
 
 NS_CC_MATH_END
@@ -474,6 +474,12 @@ bool FileUtils::writeToFile(const ValueMap &dict, const ccstd::string &fullPath)
 
 #endif /* (CC_PLATFORM != CC_PLATFORM_IOS) && (CC_PLATFORM != CC_PLATFORM_MACOS) */
 
+// Implement FileView
+FileView::FileView(Data &&data) : _data(std::move(data)) {
+    _bytes = _data.getBytes();
+    _size = _data.getSize();
+}
+
 // Implement FileUtils
 FileUtils *FileUtils::sharedFileUtils = nullptr;
 
@@ -596,6 +602,14 @@ FileUtils::Status FileUtils::getContents(const ccstd::string &filename, Resizabl
     return Status::OK;
 }
 
+IntrusivePtr<FileView> FileUtils::getFileView(const ccstd::string &filename) {
+    Data data;
+    if (getContents(filename, &data) != Status::OK) {
+        return nullptr;
+    }
+    return ccnew FileView(std::move(data));
+}
+
 unsigned char *FileUtils::getFileDataFromZip(const ccstd::string &zipFilePath, const ccstd::string &filename, uint32_t *size) {
     unsigned char *buffer = nullptr;
     unzFile file = nullptr;
@@ -27,6 +27,8 @@
 #include <type_traits>
 #include "base/Data.h"
 #include "base/Macros.h"
+#include "base/Ptr.h"
+#include "base/RefCounted.h"
 #include "base/Value.h"
 #include "base/std/container/string.h"
 #include "base/std/container/unordered_map.h"
@@ -99,6 +101,35 @@ public:
     }
 };
 
+/**
+ *  A read-only, reference counted view of a whole file, returned by FileUtils::getFileView.
+ *  Platforms that can map files keep the file mapped for the lifetime of the view, so pages are
+ *  only read when touched and several owners can share the bytes without copying them.
+ *  Elsewhere the view owns a heap copy of the file.
+ */
+class CC_DLL FileView : public RefCounted {
+public:
+    explicit FileView(Data &&data);
+    ~FileView() override = default;
+
+    const uint8_t *getBytes() const { return _bytes; }
+    uint32_t getSize() const { return _size; }
+
+    /**
+     *  Whether the bytes are backed by a file mapping rather than a heap copy.
+     */
+    virtual bool isMapped() const { return false; }
+
+protected:
+    FileView(const uint8_t *bytes, uint32_t size) : _bytes(bytes), _size(size) {}
+
+    const uint8_t *_bytes{nullptr};
+    uint32_t _size{0};
+
+private:
+    Data _data;
+};
+
 /** Helper class to handle file operations. */
 class CC_DLL FileUtils {
 public:
@@ -228,6 +259,18 @@ public:
     }
     virtual Status getContents(const ccstd::string &filename, ResizableBuffer *buffer);
 
+    /**
+     *  Gets whole file contents as a read-only view which can be shared without copying.
+     *
+     *  Prefer it over getDataFromFile for large binaries (meshes, packs, bytecode, compressed textures)
+     *  which are only read: on Linux the file is mapped and paged in lazily instead of being read
+     *  into a fresh buffer. Other platforms fall back to getContents.
+     *
+     *  @param[in]  filename The resource file name which contains the path.
+     *  @return The view of the file, or nullptr if it can't be read.
+     */
+    virtual IntrusivePtr<FileView> getFileView(const ccstd::string &filename);
+
     /**
      *  Gets resource file data from a zip file.
      *
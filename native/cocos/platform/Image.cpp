@@ -61,6 +61,7 @@ extern "C" {
 #endif // CC_USE_WEBP
 
 #include "base/ZipUtils.h"
+#include "core/utils/ImageUtils.h"
 #include "platform/FileUtils.h"
 #if (CC_PLATFORM == CC_PLATFORM_ANDROID)
     #include "platform/android/FileUtils-android.h"
@@ -278,10 +279,12 @@ bool Image::initWithImageFile(const ccstd::string &path) {
     //    _filePath = FileUtils::getInstance()->fullPathForFilename(path);
     _filePath = path;
 
-    const Data data = FileUtils::getInstance()->getDataFromFile(_filePath);
+    // Compressed textures are copied out of the file once by initWithImageData, so read through a view
+    // instead of into an intermediate buffer.
+    const IntrusivePtr<FileView> view = FileUtils::getInstance()->getFileView(_filePath);
 
-    if (!data.isNull()) {
-        ret = initWithImageData(data.getBytes(), data.getSize());
+    if (view) {
+        ret = initWithImageData(view->getBytes(), view->getSize());
     }
 
     return ret;
@@ -512,6 +515,30 @@ void myErrorExit(j_common_ptr cinfo) {
     /* Return control to the setjmp point */
     longjmp(myerr->setjmp_buffer, 1);
 }
+
+// Expands a row of gray or RGB pixels to RGBA8. src lies in the tail of the same row as dst, so walking
+// forward never overwrites a pixel before it is read.
+void expandRowToRGBA(unsigned char *dst, const unsigned char *src, uint32_t width, uint32_t components) {
+    if (components == 1) {
+        for (uint32_t i = 0; i < width; ++i, dst += 4) {
+            const unsigned char gray = src[i];
+            dst[0] = gray;
+            dst[1] = gray;
+            dst[2] = gray;
+            dst[3] = 255;
+        }
+    } else {
+        for (uint32_t i = 0; i < width; ++i, dst += 4, src += 3) {
+            const unsigned char r = src[0];
+            const unsigned char g = src[1];
+            const unsigned char b = src[2];
+            dst[0] = r;
+            dst[1] = g;
+            dst[2] = b;
+            dst[3] = 255;
+        }
+    }
+}
 #endif // CC_USE_JPEG
 } // namespace
 
@@ -570,16 +597,31 @@ bool Image::initWithJpgData(const unsigned char *data, uint32_t dataLen) {
         _isCompressed = false;
         _width = cinfo.output_width;
         _height = cinfo.output_height;
-        _dataLen = cinfo.output_width * cinfo.output_height * cinfo.output_components;
-        _data = static_cast<unsigned char *>(malloc(_dataLen * sizeof(unsigned char)));
-        CC_BREAK_IF(!_data);
+        const uint32_t components = cinfo.output_components;
+        const uint32_t rowBytes = cinfo.output_width * components;
+        if (_decodeOptions.toRGBA) {
+            _renderFormat = gfx::Format::RGBA8;
+            _dataLen = cinfo.output_width * cinfo.output_height * 4;
+        } else {
+            _dataLen = rowBytes * cinfo.output_height;
+        }
+        CC_BREAK_IF(!allocateDecodeBuffer());
 
         /* now actually read the jpeg into the raw buffer */
         /* read one scan line at a time */
         while (cinfo.output_scanline < cinfo.output_height) {
-            rowPointer[0] = _data + location;
-            location += cinfo.output_width * cinfo.output_components;
-            jpeg_read_scanlines(&cinfo, rowPointer, 1);
+            if (_decodeOptions.toRGBA) {
+                // decode into the tail of the RGBA row and expand it in place
+                unsigned char *row = _data + location;
+                location += cinfo.output_width * 4;
+                rowPointer[0] = _data + location - rowBytes;
+                jpeg_read_scanlines(&cinfo, rowPointer, 1);
+                expandRowToRGBA(row, rowPointer[0], cinfo.output_width, components);
+            } else {
+                rowPointer[0] = _data + location;
+                location += rowBytes;
+                jpeg_read_scanlines(&cinfo, rowPointer, 1);
+            }
         }
 
         /* When read image file with broken data, jpeg_finish_decompress() may cause error.
@@ -667,6 +709,13 @@ bool Image::initWithPngData(const unsigned char *data, uint32_t dataLen) {
         if (bitDepth < 8) {
             png_set_packing(pngPtr);
         }
+        if (_decodeOptions.toRGBA) {
+            // let libpng expand gray and add opaque alpha, the rows come out as RGBA8
+            if (colorType == PNG_COLOR_TYPE_GRAY || colorType == PNG_COLOR_TYPE_GRAY_ALPHA) {
+                png_set_gray_to_rgb(pngPtr);
+            }
+            png_set_add_alpha(pngPtr, 0xff, PNG_FILLER_AFTER);
+        }
         // update info
         png_read_update_info(pngPtr, infoPtr);
         colorType = png_get_color_type(pngPtr, infoPtr);
@@ -693,8 +742,7 @@ bool Image::initWithPngData(const unsigned char *data, uint32_t dataLen) {
         const png_size_t rowBytes = png_get_rowbytes(pngPtr, infoPtr);
 
         _dataLen = static_cast<uint32_t>(rowBytes * _height);
-        _data = static_cast<unsigned char *>(malloc(_dataLen * sizeof(unsigned char)));
-        if (!_data) {
+        if (!allocateDecodeBuffer()) {
             if (rowPointers != nullptr) {
                 free(rowPointers);
             }
@@ -934,6 +982,16 @@ bool Image::initWithCompressedMipsData(const unsigned char *data, uint32_t /*dat
     return ret;
 }
 
+bool Image::allocateDecodeBuffer() {
+    uint32_t capacity = _dataLen;
+    _mipmapChainReserved = _decodeOptions.reserveMipmaps && _renderFormat == gfx::Format::RGBA8;
+    if (_mipmapChainReserved) {
+        capacity = ImageUtils::getMipmapChainSize(_width, _height);
+    }
+    _data = static_cast<unsigned char *>(malloc(capacity * sizeof(unsigned char)));
+    return _data != nullptr;
+}
+
 bool Image::initWithPVRData(const unsigned char *data, uint32_t dataLen) {
     return initWithPVRv2Data(data, dataLen) || initWithPVRv3Data(data, dataLen);
 }
@@ -947,17 +1005,23 @@ bool Image::initWithWebpData(const unsigned char *data, uint32_t dataLen) {
         if (WebPGetFeatures(static_cast<const uint8_t *>(data), dataLen, &config.input) != VP8_STATUS_OK) break;
         if (config.input.width == 0 || config.input.height == 0) break;
 
-        config.output.colorspace = config.input.has_alpha ? MODE_rgbA : MODE_RGB;
-        _renderFormat = config.input.has_alpha ? gfx::Format::RGBA8 : gfx::Format::RGB8;
+        const bool rgba = config.input.has_alpha || _decodeOptions.toRGBA;
+        if (config.input.has_alpha) {
+            config.output.colorspace = MODE_rgbA;
+        } else {
+            config.output.colorspace = rgba ? MODE_RGBA : MODE_RGB;
+        }
+        _renderFormat = rgba ? gfx::Format::RGBA8 : gfx::Format::RGB8;
+        _hasPremultipliedAlpha = config.input.has_alpha;
         _width = config.input.width;
         _height = config.input.height;
         _isCompressed = false;
 
-        _dataLen = _width * _height * (config.input.has_alpha ? 4 : 3);
-        _data = static_cast<unsigned char *>(malloc(_dataLen * sizeof(unsigned char)));
+        _dataLen = _width * _height * (rgba ? 4 : 3);
+        if (!allocateDecodeBuffer()) break;
 
         config.output.u.RGBA.rgba = static_cast<uint8_t *>(_data);
-        config.output.u.RGBA.stride = _width * (config.input.has_alpha ? 4 : 3);
+        config.output.u.RGBA.stride = _width * (rgba ? 4 : 3);
         config.output.u.RGBA.size = _dataLen;
         config.output.is_external_memory = 1;
 
@@ -61,6 +61,16 @@ public:
         UNKNOWN
     };
 
+    struct DecodeOptions {
+        // decode PNG, JPG and WebP straight to RGBA8 instead of their own channel layout
+        bool toRGBA{false};
+        // leave room for the RGBA8 mipmap chain after the decoded pixels, see ImageUtils::generateMipmaps
+        bool reserveMipmaps{false};
+    };
+
+    // Takes effect on the next init call.
+    inline void setDecodeOptions(const DecodeOptions &options) { _decodeOptions = options; }
+
     bool initWithImageFile(const ccstd::string &path);
     bool initWithImageData(const unsigned char *data, uint32_t dataLen);
 
@@ -82,6 +92,10 @@ public:
     inline int getHeight() const { return _height; }
     inline ccstd::string getFilePath() const { return _filePath; }
     inline bool isCompressed() const { return _isCompressed; }
+    // whether the buffer has room for the mipmap chain, see DecodeOptions::reserveMipmaps
+    inline bool isMipmapChainReserved() const { return _mipmapChainReserved; }
+    // WebP images with alpha are decoded premultiplied
+    inline bool hasPremultipliedAlpha() const { return _hasPremultipliedAlpha; }
     inline const ccstd::vector<uint32_t> &getMipmapLevelDataSize() const { return _mipmapLevelDataSize; }
 
     /**
@@ -105,6 +119,8 @@ protected:
     bool initWithASTCData(const unsigned char *data, uint32_t dataLen);
     bool initWithCompressedMipsData(const unsigned char *data, uint32_t dataLen);
 
+    bool allocateDecodeBuffer();
+
     bool saveImageToPNG(const std::string &filePath, bool isToRGB = true);
     bool saveImageToJPG(const std::string &filePath);
 
@@ -116,6 +132,9 @@ protected:
     gfx::Format _renderFormat;
     ccstd::string _filePath;
     bool _isCompressed = false;
+    bool _hasPremultipliedAlpha = false;
+    bool _mipmapChainReserved = false;
+    DecodeOptions _decodeOptions;
     ccstd::vector<uint32_t> _mipmapLevelDataSize;
 
     static Format detectFormat(const unsigned char *data, uint32_t dataLen);
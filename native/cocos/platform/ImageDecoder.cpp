@@ -0,0 +1,228 @@
+/****************************************************************************
+ Copyright (c) 2022-2023 Xiamen Yaji Software Co., Ltd.
+
+ https://www.cocos.com/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#include "platform/ImageDecoder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include "base/Log.h"
+#include "base/job-system/JobSystem.h"
+#include "core/utils/ImageUtils.h"
+#include "platform/Image.h"
+#include "platform/TextureTranscoder.h"
+
+namespace cc {
+
+ImageDecoder *ImageDecoder::instance = nullptr;
+
+ImageDecoder *ImageDecoder::getInstance() {
+    if (!instance) {
+        // leave most of the pool to the engine, decoding is not latency critical
+        const uint32_t concurrency = std::clamp<uint32_t>(ThreadPool::CPU_CORE_COUNT / 2, 1, 4);
+        instance = ccnew ImageDecoder(concurrency);
+        // transcoding runs jobs from the workers, make sure the job system isn't created there
+        JobSystem::getInstance();
+    }
+    return instance;
+}
+
+void ImageDecoder::destroyInstance() {
+    if (instance) {
+        const Stats stats = instance->getStats();
+        if (stats.imageCount > 0) {
+            CC_LOG_DEBUG("ImageDecoder: %u images, %.2f MB/s, %.3f ms on the main thread per image",
+                         stats.imageCount, stats.getThroughput(), stats.getMainThreadTimePerImage());
+        }
+    }
+    CC_SAFE_DELETE(instance);
+}
+
+ImageDecoder::ImageDecoder(uint32_t maxConcurrency) : _maxConcurrency(std::max(maxConcurrency, 1U)), _state(std::make_shared<State>()) {
+}
+
+ImageDecoder::~ImageDecoder() {
+    std::unique_lock<std::mutex> lock(_state->mutex);
+    _state->cancelled = true;
+    for (auto &queue : _state->queues) {
+        for (auto &request : queue) {
+            free(request.data);
+        }
+        queue.clear();
+    }
+    _state->queued = 0;
+    _state->idle.wait(lock, [this]() { return _state->running == 0; });
+}
+
+void ImageDecoder::decodeFile(const ccstd::string &fullPath, const Options &options, Callback callback) {
+    Request request;
+    request.fullPath = fullPath;
+    request.options = options;
+    request.callback = std::move(callback);
+    submit(std::move(request));
+}
+
+void ImageDecoder::decodeData(unsigned char *data, uint32_t dataLen, const Options &options, Callback callback) {
+    Request request;
+    request.data = data;
+    request.dataLen = dataLen;
+    request.options = options;
+    request.callback = std::move(callback);
+    submit(std::move(request));
+}
+
+void ImageDecoder::waitForAll() {
+    std::unique_lock<std::mutex> lock(_state->mutex);
+    _state->idle.wait(lock, [this]() { return _state->pending == 0 && _state->running == 0 && _state->queued == 0; });
+}
+
+void ImageDecoder::addMainThreadTime(double seconds) {
+    std::lock_guard<std::mutex> lock(_state->mutex);
+    ++_state->stats.mainThreadCount;
+    _state->stats.mainThreadSeconds += seconds;
+}
+
+ImageDecoder::Stats ImageDecoder::getStats() const {
+    std::lock_guard<std::mutex> lock(_state->mutex);
+    return _state->stats;
+}
+
+void ImageDecoder::submit(Request &&request) {
+    const TaskPriority priority = request.options.priority;
+    bool dispatch = false;
+    {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        _state->queues[static_cast<size_t>(priority)].push_back(std::move(request));
+        ++_state->queued;
+        if (_state->pending + _state->running < _maxConcurrency) {
+            ++_state->pending;
+            dispatch = true;
+        }
+    }
+    // a running worker picks the request up otherwise
+    if (dispatch) {
+        ThreadPool::getInstance()->dispatch([state = _state]() { run(state); }, priority);
+    }
+}
+
+// Keeps decoding until the queues are empty, so at most _maxConcurrency workers are busy with images.
+void ImageDecoder::run(const std::shared_ptr<State> &state) {
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        --state->pending;
+        if (state->cancelled) {
+            state->idle.notify_all();
+            return;
+        }
+        ++state->running;
+    }
+    while (true) {
+        Request request;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            auto queue = std::find_if(state->queues.begin(), state->queues.end(), [](const auto &q) { return !q.empty(); });
+            if (state->cancelled || queue == state->queues.end()) {
+                --state->running;
+                state->idle.notify_all();
+                return;
+            }
+            request = std::move(queue->front());
+            queue->pop_front();
+            --state->queued;
+        }
+
+        const auto begin = std::chrono::steady_clock::now();
+        Result result = decode(request.fullPath, request.data, request.dataLen, request.options);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        free(request.data);
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            ++state->stats.imageCount;
+            state->stats.decodedBytes += result.length;
+            state->stats.decodeSeconds += seconds;
+        }
+        request.callback(result);
+    }
+}
+
+ImageDecoder::Result ImageDecoder::decode(const ccstd::string &fullPath, const unsigned char *data, uint32_t dataLen, const Options &options) {
+    Result result;
+    Image image;
+    Image::DecodeOptions decodeOptions;
+    decodeOptions.toRGBA = true;
+    decodeOptions.reserveMipmaps = options.generateMipmaps;
+    image.setDecodeOptions(decodeOptions);
+    const bool loaded = fullPath.empty() ? image.initWithImageData(data, dataLen) : image.initWithImageFile(fullPath);
+    if (!loaded) {
+        return result;
+    }
+
+    // decoders without a direct RGBA path (e.g. uncompressed PVR) still need the copy
+    ImageUtils::convert2RGBA(&image);
+
+    result.succeed = true;
+    result.width = image.getWidth();
+    result.height = image.getHeight();
+    result.length = image.getDataLen();
+    result.format = image.getRenderFormat();
+    result.compressed = image.isCompressed();
+    result.premultiplied = image.hasPremultipliedAlpha();
+    result.mipmapLevelDataSize = image.getMipmapLevelDataSize();
+    const bool mipmapChainReserved = image.isMipmapChainReserved();
+    image.takeData(&result.data);
+
+    if (result.compressed && options.transcodeUnsupported && TextureTranscoder::isTranscodable(result.format) &&
+        !TextureTranscoder::isFormatSupported(result.format)) {
+        ccstd::vector<uint32_t> levelDataSize;
+        uint8_t *rgba = TextureTranscoder::transcode(result.data, result.length, result.width, result.height, result.format,
+                                                     result.mipmapLevelDataSize, &levelDataSize);
+        if (rgba) {
+            free(result.data);
+            result.data = rgba;
+            result.format = TextureTranscoder::getTranscodedFormat(result.format);
+            result.compressed = false;
+            result.length = 0;
+            for (uint32_t size : levelDataSize) {
+                result.length += size;
+            }
+            result.mipmapLevelDataSize = std::move(levelDataSize);
+        }
+    }
+
+    if (result.compressed || result.format != gfx::Format::RGBA8) {
+        return result;
+    }
+    if (options.premultiplyAlpha && !result.premultiplied) {
+        ImageUtils::premultiplyAlpha(result.data, result.length / 4);
+        result.premultiplied = true;
+    }
+    if (options.generateMipmaps && mipmapChainReserved) {
+        result.mipmapLevelDataSize.clear();
+        ImageUtils::generateMipmaps(result.data, result.width, result.height, &result.mipmapLevelDataSize);
+        result.length = ImageUtils::getMipmapChainSize(result.width, result.height);
+    }
+    return result;
+}
+
+} // namespace cc
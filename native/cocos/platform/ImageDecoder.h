@@ -0,0 +1,153 @@
+/****************************************************************************
+ Copyright (c) 2022-2023 Xiamen Yaji Software Co., Ltd.
+
+ https://www.cocos.com/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include "base/Macros.h"
+#include "base/std/container/deque.h"
+#include "base/std/container/string.h"
+#include "base/std/container/vector.h"
+#include "base/threading/ThreadPool.h"
+#include "gfx-base/GFXDef-common.h"
+
+namespace cc {
+
+/**
+ * Decodes images on cc::ThreadPool workers, with at most a fixed number of decodes in flight so loading
+ * never takes over the pool. Queued requests are served highest priority first.
+ *
+ * PNG, JPG and WebP images are decoded straight into RGBA8 buffers that can be uploaded as they are,
+ * optionally premultiplied and with their mipmap chain appended to the same allocation. The receiver of
+ * a result has nothing left to convert or copy.
+ */
+class CC_DLL ImageDecoder final {
+public:
+    struct Options {
+        TaskPriority priority{TaskPriority::NORMAL};
+        bool premultiplyAlpha{false};
+        bool generateMipmaps{false};
+        // decode ETC / ASTC data the device can't sample to RGBA8, see TextureTranscoder
+        bool transcodeUnsupported{true};
+    };
+
+    struct Result {
+        bool succeed{false};
+        // allocated with malloc, owned by whoever receives the result
+        uint8_t *data{nullptr};
+        // bytes of all levels
+        uint32_t length{0};
+        uint32_t width{0};
+        uint32_t height{0};
+        gfx::Format format{gfx::Format::UNKNOWN};
+        bool compressed{false};
+        bool premultiplied{false};
+        ccstd::vector<uint32_t> mipmapLevelDataSize;
+    };
+
+    // Invoked on a worker thread.
+    using Callback = std::function<void(Result &result)>;
+
+    struct Stats {
+        uint32_t imageCount{0};
+        uint64_t decodedBytes{0};
+        // summed over all workers
+        double decodeSeconds{0.0};
+        uint32_t mainThreadCount{0};
+        double mainThreadSeconds{0.0};
+
+        // decoded output per second of decode time, in MB/s
+        inline double getThroughput() const { return decodeSeconds > 0.0 ? static_cast<double>(decodedBytes) / decodeSeconds / (1024.0 * 1024.0) : 0.0; }
+        // milliseconds spent on the main thread per delivered image
+        inline double getMainThreadTimePerImage() const { return mainThreadCount > 0 ? mainThreadSeconds * 1000.0 / mainThreadCount : 0.0; }
+    };
+
+    static ImageDecoder *getInstance();
+    static void destroyInstance();
+
+    explicit ImageDecoder(uint32_t maxConcurrency);
+    // Drops the queued requests without calling them back and waits for the decodes already started.
+    // Workers dispatched but not started yet find the decoder cancelled and return, so the pool
+    // doesn't have to be running.
+    ~ImageDecoder();
+    ImageDecoder(const ImageDecoder &) = delete;
+    ImageDecoder(ImageDecoder &&) = delete;
+    ImageDecoder &operator=(const ImageDecoder &) = delete;
+    ImageDecoder &operator=(ImageDecoder &&) = delete;
+
+    // fullPath has to be resolved already, FileUtils::fullPathForFilename isn't thread safe.
+    void decodeFile(const ccstd::string &fullPath, const Options &options, Callback callback);
+    // Takes ownership of data, which is released with free.
+    void decodeData(unsigned char *data, uint32_t dataLen, const Options &options, Callback callback);
+
+    // Blocks until every queued and running request has been called back.
+    void waitForAll();
+
+    // Lets the receiver account the time it spent on the main thread for one image.
+    void addMainThreadTime(double seconds);
+    Stats getStats() const;
+
+    inline uint32_t getMaxConcurrency() const { return _maxConcurrency; }
+
+    // Decodes on the calling thread. data is used when fullPath is empty.
+    static Result decode(const ccstd::string &fullPath, const unsigned char *data, uint32_t dataLen, const Options &options);
+
+private:
+    struct Request {
+        ccstd::string fullPath;
+        unsigned char *data{nullptr};
+        uint32_t dataLen{0};
+        Options options;
+        Callback callback;
+    };
+
+    // Shared with the dispatched workers, which may start after the decoder is gone.
+    struct State {
+        // dispatched to the pool, not started yet
+        uint32_t pending{0};
+        // started and decoding
+        uint32_t running{0};
+        uint32_t queued{0};
+        bool cancelled{false};
+        std::array<ccstd::deque<Request>, static_cast<size_t>(TaskPriority::COUNT)> queues;
+        std::mutex mutex;
+        std::condition_variable idle;
+        Stats stats;
+    };
+
+    void submit(Request &&request);
+    static void run(const std::shared_ptr<State> &state);
+
+    uint32_t _maxConcurrency{1};
+    std::shared_ptr<State> _state;
+
+    static ImageDecoder *instance;
+};
+
+} // namespace cc
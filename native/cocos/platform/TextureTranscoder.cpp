@@ -0,0 +1,326 @@
+/****************************************************************************
+ Copyright (c) 2022-2023 Xiamen Yaji Software Co., Ltd.
+
+ https://www.cocos.com/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#include "platform/TextureTranscoder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include "base/Data.h"
+#include "base/Log.h"
+#include "base/astc.h"
+#include "base/etc2.h"
+#include "base/job-system/JobSystem.h"
+#include "base/std/hash/hash.h"
+#include "gfx-base/GFXDef.h"
+#include "gfx-base/GFXDevice.h"
+#include "platform/FileUtils.h"
+
+namespace cc {
+
+namespace {
+
+// Bands smaller than this are not worth a job.
+constexpr uint32_t MIN_BAND_ROWS = 4;
+constexpr uint32_t MAX_BLOCK_DIM = 12;
+
+constexpr uint32_t CACHE_MAGIC = 0x43435458; // "CCTX"
+constexpr uint32_t CACHE_VERSION = 1;
+
+struct CacheHeader {
+    uint32_t magic{CACHE_MAGIC};
+    uint32_t version{CACHE_VERSION};
+    uint32_t width{0};
+    uint32_t height{0};
+    uint32_t format{0};
+    uint32_t levelCount{0};
+};
+
+std::mutex cacheMutex;
+ccstd::string cacheDirectory;
+
+struct BlockInfo {
+    uint32_t width{0};
+    uint32_t height{0};
+    uint32_t bytes{0};
+    bool srgb{false};
+};
+
+BlockInfo getBlockInfo(gfx::Format format) {
+    using gfx::Format;
+    static const uint8_t ASTC_DIMS[][2] = {{4, 4}, {5, 4}, {5, 5}, {6, 5}, {6, 6}, {8, 5}, {8, 6}, {8, 8}, {10, 5}, {10, 6}, {10, 8}, {10, 10}, {12, 10}, {12, 12}};
+    switch (format) {
+        case Format::ETC_RGB8:
+        case Format::ETC2_RGB8:
+            return {4, 4, ETC2_RGB8_BLOCK_SIZE, false};
+        case Format::ETC2_SRGB8:
+            return {4, 4, ETC2_RGB8_BLOCK_SIZE, true};
+        case Format::ETC2_RGBA8:
+            return {4, 4, ETC2_RGBA8_BLOCK_SIZE, false};
+        case Format::ETC2_SRGB8_A8:
+            return {4, 4, ETC2_RGBA8_BLOCK_SIZE, true};
+        default:
+            break;
+    }
+    if (format >= Format::ASTC_RGBA_4X4 && format <= Format::ASTC_RGBA_12X12) {
+        const auto *dims = ASTC_DIMS[toNumber(format) - toNumber(Format::ASTC_RGBA_4X4)];
+        return {dims[0], dims[1], ASTC_BLOCK_SIZE, false};
+    }
+    if (format >= Format::ASTC_SRGBA_4X4 && format <= Format::ASTC_SRGBA_12X12) {
+        const auto *dims = ASTC_DIMS[toNumber(format) - toNumber(Format::ASTC_SRGBA_4X4)];
+        return {dims[0], dims[1], ASTC_BLOCK_SIZE, true};
+    }
+    return {};
+}
+
+void decodeBlock(gfx::Format format, const BlockInfo &info, const uint8_t *block, uint8_t *out, uint32_t stride) {
+    switch (format) {
+        case gfx::Format::ETC2_RGBA8:
+        case gfx::Format::ETC2_SRGB8_A8:
+            etc2_decode_block_rgb(block + ETC2_RGB8_BLOCK_SIZE, out, stride);
+            etc2_decode_block_alpha(block, out, stride);
+            break;
+        case gfx::Format::ETC_RGB8:
+        case gfx::Format::ETC2_RGB8:
+        case gfx::Format::ETC2_SRGB8:
+            etc2_decode_block_rgb(block, out, stride);
+            break;
+        default:
+            astcDecodeBlock(block, static_cast<int>(info.width), static_cast<int>(info.height), info.srgb, out, static_cast<int>(stride));
+            break;
+    }
+}
+
+ccstd::string getCachePath(const ccstd::string &dir, const uint8_t *data, uint32_t dataLen, uint32_t width, uint32_t height, gfx::Format format) {
+    // two differently seeded hashes, like the SPIR-V cache keys
+    ccstd::hash_t lo = dataLen;
+    ccstd::hash_t hi = (static_cast<ccstd::hash_t>(width) << 16) ^ height;
+    ccstd::hash_combine(hi, toNumber(format));
+    const uint32_t wordCount = dataLen / sizeof(uint64_t);
+    for (uint32_t i = 0; i < wordCount; ++i) {
+        uint64_t word = 0;
+        memcpy(&word, data + i * sizeof(uint64_t), sizeof(word));
+        ccstd::hash_combine(lo, word);
+        memcpy(&word, data + (wordCount - 1 - i) * sizeof(uint64_t), sizeof(word));
+        ccstd::hash_combine(hi, word);
+    }
+    ccstd::hash_range(lo, data + wordCount * sizeof(uint64_t), data + dataLen);
+
+    char name[64];
+    snprintf(name, sizeof(name), "%016llx%016llx.rgba", static_cast<unsigned long long>(lo), static_cast<unsigned long long>(hi));
+    return dir + name;
+}
+
+uint8_t *readCache(const ccstd::string &path, uint32_t width, uint32_t height, gfx::Format format, ccstd::vector<uint32_t> *levelDataSize) {
+    auto *fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isFileExist(path)) {
+        return nullptr;
+    }
+    Data data = fileUtils->getDataFromFile(path);
+    CacheHeader header;
+    if (data.getSize() < sizeof(header)) {
+        return nullptr;
+    }
+    memcpy(&header, data.getBytes(), sizeof(header));
+    const uint32_t headerSize = sizeof(header) + header.levelCount * sizeof(uint32_t);
+    if (header.magic != CACHE_MAGIC || header.version != CACHE_VERSION || header.width != width || header.height != height ||
+        header.format != toNumber(format) || header.levelCount == 0 || data.getSize() < headerSize) {
+        return nullptr;
+    }
+    levelDataSize->resize(header.levelCount);
+    memcpy(levelDataSize->data(), data.getBytes() + sizeof(header), header.levelCount * sizeof(uint32_t));
+    uint64_t total = 0;
+    for (uint32_t size : *levelDataSize) {
+        total += size;
+    }
+    if (total != data.getSize() - headerSize) {
+        return nullptr;
+    }
+    // reuse the file buffer, the pixels only move to the front
+    uint32_t size = 0;
+    uint8_t *bytes = data.takeBuffer(&size);
+    memmove(bytes, bytes + headerSize, size - headerSize);
+    return bytes;
+}
+
+void writeCache(const ccstd::string &path, uint32_t width, uint32_t height, gfx::Format format, const uint8_t *rgba, const ccstd::vector<uint32_t> &levelDataSize) {
+    CacheHeader header;
+    header.width = width;
+    header.height = height;
+    header.format = toNumber(format);
+    header.levelCount = static_cast<uint32_t>(levelDataSize.size());
+    const uint32_t headerSize = sizeof(header) + header.levelCount * sizeof(uint32_t);
+    uint32_t size = headerSize;
+    for (uint32_t levelSize : levelDataSize) {
+        size += levelSize;
+    }
+    auto *bytes = static_cast<uint8_t *>(malloc(size));
+    memcpy(bytes, &header, sizeof(header));
+    memcpy(bytes + sizeof(header), levelDataSize.data(), header.levelCount * sizeof(uint32_t));
+    memcpy(bytes + headerSize, rgba, size - headerSize);
+    Data data;
+    data.fastSet(bytes, size);
+    if (!FileUtils::getInstance()->writeDataToFile(data, path)) {
+        CC_LOG_WARNING("TextureTranscoder: failed to write cache file %s", path.c_str());
+    }
+}
+
+} // namespace
+
+bool TextureTranscoder::isFormatSupported(gfx::Format format) {
+    auto *device = gfx::Device::getInstance();
+    return !device || hasFlag(device->getFormatFeatures(format), gfx::FormatFeature::SAMPLED_TEXTURE);
+}
+
+bool TextureTranscoder::isTranscodable(gfx::Format format) {
+    return getBlockInfo(format).bytes != 0;
+}
+
+gfx::Format TextureTranscoder::getTranscodedFormat(gfx::Format format) {
+    const BlockInfo info = getBlockInfo(format);
+    if (!info.bytes) {
+        return gfx::Format::UNKNOWN;
+    }
+    return info.srgb ? gfx::Format::SRGB8_A8 : gfx::Format::RGBA8;
+}
+
+bool TextureTranscoder::decodeLevel(const uint8_t *data, uint32_t dataLen, uint32_t width, uint32_t height, gfx::Format format, uint8_t *rgba) {
+    const BlockInfo info = getBlockInfo(format);
+    if (!info.bytes || width == 0 || height == 0) {
+        return false;
+    }
+    const uint32_t blocksX = (width + info.width - 1) / info.width;
+    const uint32_t blocksY = (height + info.height - 1) / info.height;
+    if (static_cast<uint64_t>(blocksX) * blocksY * info.bytes > dataLen) {
+        return false;
+    }
+
+    const uint32_t stride = width * 4;
+    auto decodeRows = [&](uint32_t beginRow, uint32_t endRow) {
+        uint8_t tile[MAX_BLOCK_DIM * MAX_BLOCK_DIM * 4];
+        for (uint32_t by = beginRow; by < endRow; ++by) {
+            const uint8_t *block = data + static_cast<size_t>(by) * blocksX * info.bytes;
+            const uint32_t y = by * info.height;
+            const uint32_t rows = std::min(info.height, height - y);
+            for (uint32_t bx = 0; bx < blocksX; ++bx, block += info.bytes) {
+                const uint32_t x = bx * info.width;
+                uint8_t *out = rgba + static_cast<size_t>(y) * stride + x * 4;
+                const uint32_t columns = std::min(info.width, width - x);
+                if (rows == info.height && columns == info.width) {
+                    decodeBlock(format, info, block, out, stride);
+                    continue;
+                }
+                // edge blocks cover texels past the level, clip them
+                decodeBlock(format, info, block, tile, info.width * 4);
+                for (uint32_t row = 0; row < rows; ++row) {
+                    memcpy(out + row * stride, tile + row * info.width * 4, columns * 4);
+                }
+            }
+        }
+    };
+
+    auto *jobSystem = JobSystem::getInstance();
+    const uint32_t bandRows = std::max((blocksY - 1) / jobSystem->threadCount() + 1, MIN_BAND_ROWS);
+    const uint32_t bandCount = (blocksY - 1) / bandRows + 1;
+    if (bandCount > 1) {
+        JobGraph g(jobSystem);
+        g.createForEachIndexJob(1U, bandCount, 1U, [&](uint32_t band) {
+            decodeRows(band * bandRows, std::min(blocksY, (band + 1) * bandRows));
+        });
+        g.run();
+        decodeRows(0, bandRows);
+        g.waitForAll();
+    } else {
+        decodeRows(0, blocksY);
+    }
+    return true;
+}
+
+uint8_t *TextureTranscoder::transcode(const uint8_t *data, uint32_t dataLen, uint32_t width, uint32_t height, gfx::Format format,
+                                      const ccstd::vector<uint32_t> &levelDataSize, ccstd::vector<uint32_t> *rgbaLevelDataSize) {
+    if (!isTranscodable(format)) {
+        return nullptr;
+    }
+    const gfx::Format rgbaFormat = getTranscodedFormat(format);
+    const ccstd::string dir = getCacheDirectory();
+    ccstd::string cachePath;
+    if (!dir.empty()) {
+        cachePath = getCachePath(dir, data, dataLen, width, height, format);
+        if (uint8_t *cached = readCache(cachePath, width, height, rgbaFormat, rgbaLevelDataSize)) {
+            return cached;
+        }
+    }
+
+    const ccstd::vector<uint32_t> levels = levelDataSize.empty() ? ccstd::vector<uint32_t>{dataLen} : levelDataSize;
+    rgbaLevelDataSize->resize(levels.size());
+    uint64_t total = 0;
+    for (size_t i = 0; i < levels.size(); ++i) {
+        const uint32_t levelWidth = std::max(width >> i, 1U);
+        const uint32_t levelHeight = std::max(height >> i, 1U);
+        (*rgbaLevelDataSize)[i] = levelWidth * levelHeight * 4;
+        total += (*rgbaLevelDataSize)[i];
+    }
+
+    auto *rgba = static_cast<uint8_t *>(malloc(total));
+    const uint8_t *src = data;
+    const uint8_t *srcEnd = data + dataLen;
+    uint8_t *dst = rgba;
+    for (size_t i = 0; i < levels.size(); ++i) {
+        const uint32_t levelWidth = std::max(width >> i, 1U);
+        const uint32_t levelHeight = std::max(height >> i, 1U);
+        if (levels[i] > static_cast<size_t>(srcEnd - src) || !decodeLevel(src, levels[i], levelWidth, levelHeight, format, dst)) {
+            free(rgba);
+            rgbaLevelDataSize->clear();
+            return nullptr;
+        }
+        src += levels[i];
+        dst += (*rgbaLevelDataSize)[i];
+    }
+
+    if (!cachePath.empty()) {
+        writeCache(cachePath, width, height, rgbaFormat, rgba, *rgbaLevelDataSize);
+    }
+    return rgba;
+}
+
+void TextureTranscoder::setCacheDirectory(const ccstd::string &dir) {
+    ccstd::string path = dir;
+    if (!path.empty() && path.back() != '/') {
+        path += '/';
+    }
+    if (!path.empty() && !FileUtils::getInstance()->isDirectoryExist(path)) {
+        FileUtils::getInstance()->createDirectory(path);
+    }
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cacheDirectory = path;
+}
+
+ccstd::string TextureTranscoder::getCacheDirectory() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return cacheDirectory;
+}
+
+} // namespace cc
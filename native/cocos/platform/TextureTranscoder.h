@@ -0,0 +1,66 @@
+/****************************************************************************
+ Copyright (c) 2022-2023 Xiamen Yaji Software Co., Ltd.
+
+ https://www.cocos.com/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include "base/Macros.h"
+#include "base/std/container/string.h"
+#include "base/std/container/vector.h"
+#include "gfx-base/GFXDef-common.h"
+
+namespace cc {
+
+/**
+ * CPU fallback for ETC1 / ETC2 and LDR ASTC textures on devices that cannot sample them.
+ *
+ * A level is split into bands of block rows that are decoded on the job system. The RGBA8 result of a
+ * whole texture can be kept in an on-disk cache keyed by a hash of the compressed data, so a device
+ * without support pays for the decode once.
+ */
+class CC_DLL TextureTranscoder final {
+public:
+    // Whether the device samples the format; true when there is no device to ask.
+    static bool isFormatSupported(gfx::Format format);
+    static bool isTranscodable(gfx::Format format);
+    // RGBA8 or SRGB8_A8, UNKNOWN for formats that can't be transcoded.
+    static gfx::Format getTranscodedFormat(gfx::Format format);
+
+    // Decodes one level into width * height * 4 bytes at rgba. Fails if dataLen is too short for the level.
+    static bool decodeLevel(const uint8_t *data, uint32_t dataLen, uint32_t width, uint32_t height, gfx::Format format, uint8_t *rgba);
+
+    /**
+     * Decodes every level of a texture, levels follow each other in data as described by levelDataSize
+     * (a single level when it is empty). Consults the cache first when a cache directory is set.
+     * Returns a malloc'ed buffer of all RGBA8 levels and their sizes, nullptr on failure.
+     */
+    static uint8_t *transcode(const uint8_t *data, uint32_t dataLen, uint32_t width, uint32_t height, gfx::Format format,
+                              const ccstd::vector<uint32_t> &levelDataSize, ccstd::vector<uint32_t> *rgbaLevelDataSize);
+
+    // An empty directory disables the cache, which is the default. The directory is created if needed.
+    static void setCacheDirectory(const ccstd::string &dir);
+    static ccstd::string getCacheDirectory();
+};
+
+} // namespace cc
@@ -454,14 +454,11 @@ void XRInterface::initialize(void *javaVM, void *activity) {
                 this->endRenderEyeFrame(key == xr::XRConfigKey::RENDER_EYE_FRAME_LEFT ? 0 : 1);
             }
         } else if (key == xr::XRConfigKey::IMAGE_TRACKING_CANDIDATEIMAGE && value.isString()) {
-            if (!_gThreadPool) {
-                _gThreadPool = LegacyThreadPool::newSingleThreadPool();
-            }
-
             std::string imageInfo = value.getString();
-            _gThreadPool->pushTask([imageInfo, this](int /*tid*/) {
+            auto loadTask = [imageInfo, this]() {
                 this->loadAssetsImage(imageInfo);
-            });
+            };
+            ThreadPool::getInstance()->dispatch(std::move(loadTask), TaskPriority::LOW);
         }
     });
     #if XR_OEM_PICO
@@ -25,7 +25,7 @@
 #pragma once
 
 #include "base/Ptr.h"
-#include "base/ThreadPool.h"
+#include "base/threading/ThreadPool.h"
 #include "platform/interfaces/modules/IXRInterface.h"
 #if CC_USE_XR_REMOTE_PREVIEW
     #include "xr/XRRemotePreviewManager.h"
@@ -130,7 +130,6 @@ private:
 #if CC_USE_XR_REMOTE_PREVIEW
     cc::IntrusivePtr<XRRemotePreviewManager> _xrRemotePreviewManager{nullptr};
 #endif
-    LegacyThreadPool *_gThreadPool{nullptr};
 };
 
 } // namespace cc
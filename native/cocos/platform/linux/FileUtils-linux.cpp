@@ -24,9 +24,12 @@
 
 #include "FileUtils-linux.h"
 #include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <limits>
 #include "base/Log.h"
 #include "base/memory/Memory.h"
 
@@ -37,6 +40,21 @@
 
 namespace cc {
 
+namespace {
+// Files smaller than this are cheaper to read than to map: a mapping costs a VMA and a page fault per page.
+constexpr off_t MMAP_MIN_FILE_SIZE = 64 * 1024;
+
+class MappedFileView final : public FileView {
+public:
+    MappedFileView(void *addr, uint32_t size) : FileView(static_cast<const uint8_t *>(addr), size) {}
+    ~MappedFileView() override {
+        munmap(const_cast<uint8_t *>(_bytes), _size);
+    }
+
+    bool isMapped() const override { return true; }
+};
+} // namespace
+
 FileUtils *createFileUtils() {
     return ccnew FileUtilsLinux();
 }
@@ -89,6 +107,40 @@ bool FileUtilsLinux::isFileExistInternal(const ccstd::string &filename) const {
     return (stat(strPath.c_str(), &sts) == 0) && S_ISREG(sts.st_mode);
 }
 
+IntrusivePtr<FileView> FileUtilsLinux::getFileView(const ccstd::string &filename) {
+    if (filename.empty()) {
+        return nullptr;
+    }
+
+    ccstd::string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty()) {
+        return nullptr;
+    }
+
+    int fd = open(fullPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size > std::numeric_limits<uint32_t>::max()) {
+        close(fd);
+        return nullptr;
+    }
+
+    void *addr = MAP_FAILED;
+    if (st.st_size >= MMAP_MIN_FILE_SIZE) {
+        addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+
+    if (addr == MAP_FAILED) {
+        return FileUtils::getFileView(fullPath);
+    }
+    return ccnew MappedFileView(addr, static_cast<uint32_t>(st.st_size));
+}
+
 ccstd::string FileUtilsLinux::getWritablePath() const {
     struct stat st;
     stat(_writablePath.c_str(), &st);
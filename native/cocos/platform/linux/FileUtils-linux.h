@@ -32,6 +32,7 @@ public:
     ~FileUtilsLinux() override = default;
 
     bool isFileExistInternal(const ccstd::string &filename) const override;
+    IntrusivePtr<FileView> getFileView(const ccstd::string &filename) override;
     ccstd::string getWritablePath() const override;
     bool init() override;
 
@@ -30,6 +30,7 @@
 #include "base/Log.h"
 #include "base/Macros.h"
 #include "base/memory/MemoryHook.h"
+#include "base/threading/MessageQueue.h"
 #include "core/Root.h"
 #include "core/assets/Font.h"
 #include "gfx-base/GFXDevice.h"
@@ -131,11 +132,14 @@ Profiler::Profiler() {
     _mainThreadId = std::this_thread::get_id();
     _root = ccnew ProfilerBlock(nullptr, "MainThread");
     _current = _root;
+    ProfilerTrace::setThreadName("MainThread");
 
     Profiler::instance = this;
 }
 
 Profiler::~Profiler() {
+    // an unfinished trace is dropped, shutdown is no time to write files
+    _trace.cancel();
     CC_SAFE_DELETE(_root);
     _current = nullptr;
     Profiler::instance = nullptr;
@@ -170,6 +174,18 @@ void Profiler::endFrame() {
     _root->onFrameEnd();
 
     _objectStats.onFrameEnd();
+
+    if (_trace.collect()) {
+        _trace.stop();
+    }
+}
+
+void Profiler::startTrace(const ccstd::string &path, uint32_t frameCount) {
+    _trace.start(path, frameCount);
+}
+
+bool Profiler::stopTrace() {
+    return _trace.stop();
 }
 
 void Profiler::update() {
@@ -214,6 +230,11 @@ void Profiler::doFrameUpdate() {
     CC_PROFILE_RENDER_UPDATE(Instances, device->getNumInstances());
     CC_PROFILE_RENDER_UPDATE(Triangles, device->getNumTris());
 
+    // render thread traffic: bytes recorded into message queues and time the consumers sat idle
+    const auto queueStats = MessageQueue::fetchAndResetStats();
+    CC_PROFILE_RENDER_UPDATE(MessageQueueBytes, static_cast<uint32_t>(queueStats.enqueuedBytes));
+    CC_PROFILE_RENDER_UPDATE(MessageQueueStallUs, static_cast<uint32_t>(queueStats.consumerStallNanoseconds / 1000U));
+
 #if USE_MEMORY_LEAK_DETECTOR
     CC_PROFILE_MEMORY_UPDATE(HeapMemory, GMemoryHook.getTotalSize());
 #endif
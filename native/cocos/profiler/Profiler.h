@@ -26,6 +26,7 @@
 #include <string_view>
 #include <thread>
 #include "GameStats.h"
+#include "ProfilerTrace.h"
 #include "base/Config.h"
 #include "base/Timer.h"
 #include "gfx-base/GFXDef-common.h"
@@ -64,6 +65,14 @@ public:
     void endFrame();
     void update();
 
+    /**
+     * Trace profiled blocks of all threads into a Chrome trace file at 'path'.
+     * If frameCount is 0 the trace goes on until stopTrace, otherwise it stops and saves by itself.
+     */
+    void startTrace(const ccstd::string &path, uint32_t frameCount = 0);
+    bool stopTrace();
+    inline bool isTracing() const { return _trace.isActive(); }
+
     inline bool isMainThread() const { return _mainThreadId == std::this_thread::get_id(); }
     inline MemoryStats &getMemoryStats() { return _memoryStats; }
     inline ObjectStats &getObjectStats() { return _objectStats; }
@@ -86,6 +95,7 @@ private:
     ObjectStats _objectStats;
     ProfilerBlock *_root{nullptr};
     ProfilerBlock *_current{nullptr};
+    ProfilerTrace _trace;
     std::thread::id _mainThreadId;
 
     friend class AutoProfiler;
@@ -97,16 +107,29 @@ private:
 class AutoProfiler {
 public:
     AutoProfiler(Profiler *profiler, const std::string_view &name)
-    : _profiler(profiler) {
-        _profiler->beginBlock(name);
+    : _profiler(profiler), _name(name) {
+        // may run on other threads before the profiler is created or after it is destroyed
+        if (_profiler) {
+            _profiler->beginBlock(name);
+        }
+        if (ProfilerTrace::isRecording()) {
+            _traceBegin = ProfilerTrace::now();
+        }
     }
 
     ~AutoProfiler() {
-        _profiler->endBlock();
+        if (_traceBegin) {
+            ProfilerTrace::record(_name, _traceBegin, ProfilerTrace::now());
+        }
+        if (_profiler) {
+            _profiler->endBlock();
+        }
     }
 
 private:
     Profiler *_profiler{nullptr};
+    std::string_view _name;
+    int64_t _traceBegin{0};
 };
 
 } // namespace cc
@@ -136,6 +159,15 @@ private:
         if (CC_PROFILER) {           \
             CC_PROFILER->endFrame(); \
         }
+    #define CC_PROFILER_START_TRACE(path, frameCount)      \
+        if (CC_PROFILER) {                                 \
+            CC_PROFILER->startTrace((path), (frameCount)); \
+        }
+    #define CC_PROFILER_STOP_TRACE    \
+        if (CC_PROFILER) {            \
+            CC_PROFILER->stopTrace(); \
+        }
+    #define CC_PROFILER_SET_THREAD_NAME(name) cc::ProfilerTrace::setThreadName(#name)
     #define CC_PROFILE(name) cc::AutoProfiler auto_profiler_##name(CC_PROFILER, #name)
     #define CC_PROFILE_MEMORY_UPDATE(name, count)                 \
         if (CC_PROFILER) {                                        \
@@ -180,6 +212,9 @@ private:
     #define CC_PROFILER_UPDATE
     #define CC_PROFILER_BEGIN_FRAME
     #define CC_PROFILER_END_FRAME
+    #define CC_PROFILER_START_TRACE(path, frameCount)
+    #define CC_PROFILER_STOP_TRACE
+    #define CC_PROFILER_SET_THREAD_NAME(name)
     #define CC_PROFILE(name)
     #define CC_PROFILE_MEMORY_UPDATE(name, count)
     #define CC_PROFILE_MEMORY_INC(name, count)
@@ -0,0 +1,221 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos.com
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "ProfilerTrace.h"
+#include <mutex>
+#include "base/Log.h"
+#include "base/StringUtil.h"
+#include "platform/FileUtils.h"
+
+namespace cc {
+
+namespace {
+struct TraceRegistry {
+    std::mutex mutex;
+    ccstd::vector<std::shared_ptr<TraceEventRing>> rings;
+    uint32_t nextThreadId{0U};
+};
+
+TraceRegistry &getRegistry() {
+    static TraceRegistry registry;
+    return registry;
+}
+
+// the registry keeps the ring alive after its thread exits, until it is drained
+thread_local std::shared_ptr<TraceEventRing> localRing;
+
+TraceEventRing &getLocalRing() {
+    if (!localRing) {
+        auto &registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        localRing = std::make_shared<TraceEventRing>(registry.nextThreadId++);
+        localRing->threadName = StringUtil::format("Thread %u", localRing->getThreadId());
+        registry.rings.push_back(localRing);
+    }
+    return *localRing;
+}
+
+void appendEscaped(ccstd::string &out, const char *str, uint32_t length) {
+    for (uint32_t i = 0; i < length; ++i) {
+        if (str[i] == '"' || str[i] == '\\') {
+            out += '\\';
+        }
+        out += str[i];
+    }
+}
+} // namespace
+
+bool TraceEventRing::push(const Event &event) {
+    if (!_events) {
+        // published to the profiler by the release store of _head below
+        _events = std::make_unique<Event[]>(CAPACITY);
+    }
+    const uint32_t head = _head.load(std::memory_order_relaxed);
+    if (head - _tail.load(std::memory_order_acquire) >= CAPACITY) {
+        _dropped.fetch_add(1U, std::memory_order_relaxed);
+        return false;
+    }
+    _events[head & MASK] = event;
+    _head.store(head + 1U, std::memory_order_release);
+    return true;
+}
+
+std::atomic<bool> ProfilerTrace::recording{false};
+
+void ProfilerTrace::record(const std::string_view &name, int64_t begin, int64_t end) {
+    getLocalRing().push({name.data(), static_cast<uint32_t>(name.size()), begin, end});
+}
+
+void ProfilerTrace::setThreadName(const std::string_view &name) {
+    auto &ring = getLocalRing();
+    auto &registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    ring.threadName = name;
+}
+
+void ProfilerTrace::start(const ccstd::string &path, uint32_t frameCount) {
+    if (_active) {
+        stop();
+    }
+
+    // discard whatever was recorded before the trace started
+    {
+        auto &registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (auto &ring : registry.rings) {
+            ring->drain([](const TraceEventRing::Event & /*event*/) {});
+            ring->fetchAndResetDropped();
+        }
+    }
+
+    _events.clear();
+    _threadNames.clear();
+    _path = path;
+    _startTime = now();
+    _frameCount = frameCount;
+    _collectedFrames = 0U;
+    _dropped = 0U;
+    _active = true;
+    recording.store(true, std::memory_order_relaxed);
+}
+
+bool ProfilerTrace::collect() {
+    if (!_active) {
+        return false;
+    }
+
+    auto &registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (auto it = registry.rings.begin(); it != registry.rings.end();) {
+        auto &ring = *it;
+        const uint32_t threadId = ring->getThreadId();
+        ring->drain([&](const TraceEventRing::Event &event) {
+            _events.push_back({event, threadId});
+        });
+        _dropped += ring->fetchAndResetDropped();
+        _threadNames[threadId] = ring->threadName;
+
+        // the thread has exited and everything it recorded is collected
+        if (ring.use_count() == 1) {
+            it = registry.rings.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    ++_collectedFrames;
+    return _frameCount && _collectedFrames >= _frameCount;
+}
+
+bool ProfilerTrace::stop() {
+    if (!_active) {
+        return false;
+    }
+
+    recording.store(false, std::memory_order_relaxed);
+    collect();
+    _active = false;
+
+    ccstd::string json;
+    json.reserve(_events.size() * 96 + _threadNames.size() * 80 + 64);
+    json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    for (const auto &iter : _threadNames) {
+        json += first ? "" : ",";
+        json += StringUtil::format(R"({"name":"thread_name","ph":"M","pid":0,"tid":%u,"args":{"name":")", iter.first);
+        appendEscaped(json, iter.second.c_str(), static_cast<uint32_t>(iter.second.size()));
+        json += "\"}}";
+        first = false;
+    }
+
+    for (const auto &item : _events) {
+        const auto &event = item.event;
+        if (event.begin < _startTime) {
+            continue; // block began before the trace started
+        }
+        json += first ? "" : ",";
+        json += "{\"name\":\"";
+        appendEscaped(json, event.name, event.nameLength);
+        json += StringUtil::format(R"(","ph":"X","pid":0,"tid":%u,"ts":%.3f,"dur":%.3f})",
+                                   item.threadId,
+                                   static_cast<double>(event.begin - _startTime) / 1000.0,
+                                   static_cast<double>(event.end - event.begin) / 1000.0);
+        first = false;
+    }
+    json += "]}";
+
+    if (_dropped) {
+        CC_LOG_WARNING("Profiler trace: %u events dropped, thread rings overflowed between frames.", _dropped);
+    }
+
+    const bool saved = FileUtils::getInstance()->writeStringToFile(json, _path);
+    if (saved) {
+        CC_LOG_INFO("Profiler trace saved to %s, %u events.", _path.c_str(), static_cast<uint32_t>(_events.size()));
+    } else {
+        CC_LOG_ERROR("Profiler trace failed to save to %s.", _path.c_str());
+    }
+
+    _events.clear();
+    _events.shrink_to_fit();
+    _threadNames.clear();
+    return saved;
+}
+
+void ProfilerTrace::cancel() {
+    if (!_active) {
+        return;
+    }
+
+    recording.store(false, std::memory_order_relaxed);
+    collect();
+    _active = false;
+
+    _events.clear();
+    _events.shrink_to_fit();
+    _threadNames.clear();
+}
+
+} // namespace cc
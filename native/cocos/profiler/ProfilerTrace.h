@@ -0,0 +1,132 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos.com
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include "base/std/container/string.h"
+#include "base/std/container/unordered_map.h"
+#include "base/std/container/vector.h"
+
+namespace cc {
+
+/**
+ * TraceEventRing: complete events of one thread, written by that thread only
+ * and drained by the profiler on the main thread, without any locking.
+ */
+class TraceEventRing final {
+public:
+    static constexpr uint32_t CAPACITY = 1U << 14;
+
+    struct Event {
+        const char *name{nullptr};
+        uint32_t nameLength{0U};
+        int64_t begin{0}; // nanoseconds
+        int64_t end{0};   // nanoseconds
+    };
+
+    explicit TraceEventRing(uint32_t threadId) : _threadId(threadId) {}
+
+    bool push(const Event &event);
+
+    template <typename Fn>
+    void drain(Fn &&fn);
+
+    inline uint32_t getThreadId() const { return _threadId; }
+    inline bool isAllocated() const { return _events != nullptr; }
+    inline uint32_t fetchAndResetDropped() { return _dropped.exchange(0U, std::memory_order_relaxed); }
+
+    ccstd::string threadName;
+
+private:
+    static constexpr uint32_t MASK = CAPACITY - 1U;
+
+    // allocated by the recording thread on its first event, so only threads that record during a trace pay for it
+    std::unique_ptr<Event[]> _events;
+    std::atomic<uint32_t> _head{0U}; // next slot to write, owned by the recording thread
+    std::atomic<uint32_t> _tail{0U}; // next slot to read, owned by the profiler
+    std::atomic<uint32_t> _dropped{0U};
+    uint32_t _threadId{0U};
+};
+
+template <typename Fn>
+void TraceEventRing::drain(Fn &&fn) {
+    uint32_t tail = _tail.load(std::memory_order_relaxed);
+    const uint32_t head = _head.load(std::memory_order_acquire);
+    if (tail == head) {
+        return;
+    }
+    for (; tail != head; ++tail) {
+        fn(_events[tail & MASK]);
+    }
+    _tail.store(tail, std::memory_order_release);
+}
+
+/**
+ * ProfilerTrace: records profiled blocks of all threads while active,
+ * and saves them in the Chrome trace event format (chrome://tracing, ui.perfetto.dev).
+ * Block names are kept by pointer, they must outlive the trace (string literals).
+ */
+class ProfilerTrace final {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static inline bool isRecording() { return recording.load(std::memory_order_relaxed); }
+    static inline int64_t now() { return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count(); }
+    static void record(const std::string_view &name, int64_t begin, int64_t end);
+    static void setThreadName(const std::string_view &name);
+
+    void start(const ccstd::string &path, uint32_t frameCount);
+    // move the recorded events out of the thread rings, returns true when the requested frames are done
+    bool collect();
+    // save the recorded events to the trace file
+    bool stop();
+    // drop the recorded events without saving
+    void cancel();
+    inline bool isActive() const { return _active; }
+
+private:
+    struct CollectedEvent {
+        TraceEventRing::Event event;
+        uint32_t threadId{0U};
+    };
+
+    static std::atomic<bool> recording;
+
+    ccstd::vector<CollectedEvent> _events;
+    ccstd::unordered_map<uint32_t, ccstd::string> _threadNames;
+    ccstd::string _path;
+    int64_t _startTime{0};
+    uint32_t _frameCount{0U};
+    uint32_t _collectedFrames{0U};
+    uint32_t _dropped{0U};
+    bool _active{false};
+};
+
+} // namespace cc
@@ -120,6 +120,18 @@ public:
         return nullptr;
     }
 
+    // An empty device behind the agent layer, for running headless like on servers or in tests.
+    // Commands take the full multithreaded path but are neither validated nor drawn.
+    static Device *createHeadless(const DeviceInfo &info) {
+        if (Device::instance) return Device::instance;
+
+        Device *device = ccnew gfx::DeviceAgent(ccnew EmptyDevice);
+        if (!device->initialize(info)) {
+            CC_SAFE_DELETE(device);
+        }
+        return device;
+    }
+
     static bool isDetachDeviceThread() {
         return DETACH_DEVICE_THREAD && Device::isSupportDetachDeviceThread;
     }
@@ -91,7 +91,7 @@ void CommandBufferAgent::initMessageQueue() {
     device->_cmdBuffRefs.insert(this);
 
     _messageQueue = ccnew MessageQueue;
-    if (device->_multithreaded) _messageQueue->setImmediateMode(false);
+    if (device->_multithreaded || isDeferred()) _messageQueue->setImmediateMode(false);
 }
 
 void CommandBufferAgent::destroyMessageQueue() {
@@ -202,17 +202,26 @@ void CommandBufferAgent::endRenderPass() {
 void CommandBufferAgent::execute(CommandBuffer *const *cmdBuffs, uint32_t count) {
     if (!count) return;
 
+    auto **agentCmdBuffs = _messageQueue->allocate<CommandBufferAgent *>(count);
     auto **actorCmdBuffs = _messageQueue->allocate<CommandBuffer *>(count);
     for (uint32_t i = 0; i < count; ++i) {
-        actorCmdBuffs[i] = static_cast<CommandBufferAgent *>(cmdBuffs[i])->getActor();
+        agentCmdBuffs[i] = static_cast<CommandBufferAgent *>(cmdBuffs[i]);
+        actorCmdBuffs[i] = agentCmdBuffs[i]->getActor();
+        // the recording threads are done with it by now, close the queue
+        agentCmdBuffs[i]->_messageQueue->finishWriting();
     }
 
-    ENQUEUE_MESSAGE_3(
+    ENQUEUE_MESSAGE_4(
         _messageQueue, CommandBufferExecute,
         actor, getActor(),
+        agentCmdBuffs, agentCmdBuffs,
         cmdBuffs, actorCmdBuffs,
         count, count,
         {
+            // replay the secondary command buffers into their actors first, in submission order
+            for (uint32_t i = 0; i < count; ++i) {
+                agentCmdBuffs[i]->getMessageQueue()->flushMessages();
+            }
             actor->execute(cmdBuffs, count);
         });
 }
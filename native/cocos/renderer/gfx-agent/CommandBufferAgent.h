@@ -33,6 +33,11 @@ class MessageQueue;
 
 namespace gfx {
 
+// Secondary command buffers are always recorded into their own deferred message queue,
+// so each of them can be recorded on a different worker thread at the same time.
+// Recording ends when they are passed to 'execute' of a primary command buffer, which
+// must happen after the recording threads are synchronized with the submitting thread.
+// Their commands are then replayed and merged right before the primary executes them.
 class CC_DLL CommandBufferAgent final : public Agent<CommandBuffer> {
 public:
     explicit CommandBufferAgent(CommandBuffer *actor);
@@ -73,6 +78,7 @@ public:
     uint32_t getNumTris() const override { return _actor->getNumTris(); }
 
     inline MessageQueue *getMessageQueue() { return _messageQueue; }
+    inline bool isDeferred() const { return _type == CommandBufferType::SECONDARY; }
 
 protected:
     friend class DeviceAgent;
@@ -29,6 +29,7 @@
 #include "base/threading/MessageQueue.h"
 #include "base/threading/ThreadSafeLinearAllocator.h"
 #include "platform/interfaces/modules/IXRInterface.h"
+#include "profiler/Profiler.h"
 
 #include "BufferAgent.h"
 #include "CommandBufferAgent.h"
@@ -182,6 +183,7 @@ void DeviceAgent::setMultithreaded(bool multithreaded) {
             _mainMessageQueue, DeviceMakeCurrentTrue,
             actor, _actor,
             {
+                CC_PROFILER_SET_THREAD_NAME(RenderThread);
                 actor->bindContext(true);
                 CC_LOG_INFO("Device thread detached.");
             });
@@ -199,7 +201,7 @@ void DeviceAgent::setMultithreaded(bool multithreaded) {
         _mainMessageQueue->setImmediateMode(true);
         _actor->bindContext(true);
         for (CommandBufferAgent *cmdBuff : _cmdBuffRefs) {
-            cmdBuff->_messageQueue->setImmediateMode(true);
+            if (!cmdBuff->isDeferred()) cmdBuff->_messageQueue->setImmediateMode(true);
         }
         CC_LOG_INFO("Device thread joined.");
     }
@@ -400,6 +402,7 @@ void DeviceAgent::flushCommands(CommandBuffer *const *cmdBuffs, uint32_t count)
         cmdBuffs, agentCmdBuffs,
         multiThreaded, _actor->_multithreadedCommandRecording,
         {
+            CC_PROFILE(DeviceAgentFlushCommands);
             CommandBufferAgent::flushCommands(count, cmdBuffs, multiThreaded);
         });
 }
@@ -24,11 +24,16 @@
 
 #include "SPIRVUtils.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include "base/Data.h"
 #include "base/Log.h"
 #include "base/Utils.h"
 #include "glslang/Public/ShaderLang.h"
 #include "glslang/SPIRV/GlslangToSpv.h"
 #include "glslang/StandAlone/ResourceLimits.h"
+#include "platform/FileUtils.h"
 #include "spirv/spirv.h"
 
 namespace cc {
@@ -92,6 +97,25 @@ glslang::EShTargetLanguageVersion getTargetVersion(int vulkanMinorVersion) {
     }
 }
 
+constexpr uint32_t SPIRV_CACHE_MAGIC = 0x56525053; // "SPRV"
+constexpr uint32_t SPIRV_CACHE_VERSION = 2;
+constexpr uint32_t SPIRV_CACHE_HEADER_WORDS = 5;
+constexpr uint32_t SPIRV_CACHE_ENTRY_WORDS = 8; // followed by the active input locations and the module
+
+uint32_t getGlslangVersion() {
+    return (GLSLANG_VERSION_MAJOR << 20) | (GLSLANG_VERSION_MINOR << 10) | GLSLANG_VERSION_PATCH;
+}
+
+// Two independently seeded hashes of the whole source, so distinct variants
+// of the same effect never share an entry in practice.
+uint64_t getSourceKey(ShaderStageFlagBit type, const ccstd::string &source) {
+    ccstd::hash_t lo = static_cast<uint32_t>(type);
+    ccstd::hash_t hi = static_cast<uint32_t>(source.size());
+    ccstd::hash_range(lo, source.begin(), source.end());
+    ccstd::hash_range(hi, source.rbegin(), source.rend());
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+}
+
 // https://www.khronos.org/registry/spir-v/specs/1.0/SPIRV.pdf
 struct Id {
     uint32_t opcode{0};
@@ -103,20 +127,129 @@ struct Id {
 
 SPIRVUtils SPIRVUtils::instance;
 
+ccstd::string SPIRVUtils::getCachePath() {
+    return FileUtils::getInstance()->getWritablePath() + "spirv-cache.bin";
+}
+
 void SPIRVUtils::initialize(int vulkanMinorVersion) {
     glslang::InitializeProcess();
 
     _clientInputSemanticsVersion = 100 + vulkanMinorVersion * 10;
     _clientVersion = getClientVersion(vulkanMinorVersion);
     _targetVersion = getTargetVersion(vulkanMinorVersion);
+
+    _cachePath = getCachePath();
+    loadCache();
 }
 
 void SPIRVUtils::destroy() {
+    saveCache();
+    _cachePath.clear();
+    if (_cacheHits || _cacheMisses) {
+        CC_LOG_INFO("SPIR-V cache: %u hits saved %.1f ms of GLSL compilation, %u misses took %.1f ms.",
+                    _cacheHits, static_cast<double>(_savedMicros) / 1000.0, _cacheMisses, static_cast<double>(_compileMicros) / 1000.0);
+    }
+    _cache.clear();
+    _cacheData.clear();
+    _cacheHits = _cacheMisses = 0;
+    _savedMicros = _compileMicros = 0;
+
     glslang::FinalizeProcess();
     _output.clear();
+    _activeInputLocations.clear();
+}
+
+void SPIRVUtils::flushCache() {
+    saveCache();
+}
+
+void SPIRVUtils::loadCache() {
+    auto *fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isFileExist(_cachePath)) return;
+
+    const Data data = fileUtils->getDataFromFile(_cachePath);
+    const auto wordCount = static_cast<uint32_t>(data.getSize() / sizeof(uint32_t));
+    if (wordCount < SPIRV_CACHE_HEADER_WORDS) return;
+    _cacheData.resize(wordCount);
+    memcpy(_cacheData.data(), data.getBytes(), wordCount * sizeof(uint32_t));
+
+    const uint32_t *header = _cacheData.data();
+    if (header[0] != SPIRV_CACHE_MAGIC || header[1] != SPIRV_CACHE_VERSION || header[2] != getGlslangVersion() ||
+        header[3] != static_cast<uint32_t>(_clientVersion) || header[4] != static_cast<uint32_t>(_targetVersion)) {
+        _cacheData.clear();
+        return;
+    }
+
+    uint32_t offset = SPIRV_CACHE_HEADER_WORDS;
+    while (offset + SPIRV_CACHE_ENTRY_WORDS <= wordCount) {
+        const uint32_t *words = _cacheData.data() + offset;
+        CacheEntry entry;
+        const uint64_t key = (static_cast<uint64_t>(words[0]) << 32) | words[1];
+        entry.stage = words[2];
+        entry.sourceLength = words[3];
+        entry.compileMicros = words[4];
+        const uint32_t inputCount = words[5];
+        entry.wordCount = words[6];
+        const uint32_t inputOffset = offset + SPIRV_CACHE_ENTRY_WORDS;
+        if (words[7] != SpvMagicNumber || inputCount > wordCount - inputOffset || entry.wordCount > wordCount - inputOffset - inputCount) break;
+        entry.inputLocations.assign(words + SPIRV_CACHE_ENTRY_WORDS, words + SPIRV_CACHE_ENTRY_WORDS + inputCount);
+        entry.offset = inputOffset + inputCount;
+        offset = entry.offset + entry.wordCount;
+        _cache.emplace(key, std::move(entry));
+    }
+}
+
+void SPIRVUtils::saveCache() {
+    if (!_cacheDirty || _cachePath.empty()) return;
+
+    ccstd::vector<const std::pair<const uint64_t, CacheEntry> *> order;
+    order.reserve(_cache.size());
+    for (const auto &pair : _cache) {
+        order.push_back(&pair);
+    }
+    std::sort(order.begin(), order.end(), [](const auto *lhs, const auto *rhs) {
+        if (lhs->second.used != rhs->second.used) return lhs->second.used;
+        return lhs->second.compileMicros > rhs->second.compileMicros;
+    });
+
+    ccstd::vector<uint32_t> words{SPIRV_CACHE_MAGIC, SPIRV_CACHE_VERSION, getGlslangVersion(),
+                                  static_cast<uint32_t>(_clientVersion), static_cast<uint32_t>(_targetVersion)};
+    for (const auto *pair : order) {
+        const auto &entry = pair->second;
+        const auto inputCount = static_cast<uint32_t>(entry.inputLocations.size());
+        if ((words.size() + SPIRV_CACHE_ENTRY_WORDS + inputCount + entry.wordCount) * sizeof(uint32_t) > _cacheLimit) continue;
+        const uint32_t *code = entry.code.empty() ? _cacheData.data() + entry.offset : entry.code.data();
+        words.insert(words.end(), {static_cast<uint32_t>(pair->first >> 32), static_cast<uint32_t>(pair->first),
+                                   entry.stage, entry.sourceLength, entry.compileMicros, inputCount, entry.wordCount, SpvMagicNumber});
+        words.insert(words.end(), entry.inputLocations.begin(), entry.inputLocations.end());
+        words.insert(words.end(), code, code + entry.wordCount);
+    }
+
+    Data data;
+    data.copy(reinterpret_cast<const unsigned char *>(words.data()), static_cast<uint32_t>(words.size() * sizeof(uint32_t)));
+    if (FileUtils::getInstance()->writeDataToFile(data, _cachePath)) {
+        _cacheDirty = false;
+    } else {
+        CC_LOG_WARNING("Failed to write SPIR-V cache %s", _cachePath.c_str());
+    }
 }
 
 void SPIRVUtils::compileGLSL(ShaderStageFlagBit type, const ccstd::string &source) {
+    const uint64_t key = getSourceKey(type, source);
+    auto iter = _cache.find(key);
+    if (iter != _cache.end() && iter->second.stage == static_cast<uint32_t>(type) && iter->second.sourceLength == source.size()) {
+        auto &entry = iter->second;
+        entry.used = true;
+        const uint32_t *code = entry.code.empty() ? _cacheData.data() + entry.offset : entry.code.data();
+        _output.assign(code, code + entry.wordCount);
+        _activeInputLocations = entry.inputLocations;
+        _savedMicros += entry.compileMicros;
+        ++_cacheHits;
+        return;
+    }
+
+    const auto compileBegin = std::chrono::steady_clock::now();
+    bool succeeded = true;
     EShLanguage stage = getShaderStage(type);
     const char *string = source.c_str();
 
@@ -131,6 +264,7 @@ void SPIRVUtils::compileGLSL(ShaderStageFlagBit type, const ccstd::string &sourc
 
     if (!_shader->parse(&glslang::DefaultTBuiltInResource, _clientInputSemanticsVersion, false, messages)) {
         CC_LOG_ERROR("GLSL Parsing Failed:\n%s\n%s", _shader->getInfoLog(), _shader->getInfoDebugLog());
+        succeeded = false;
     }
 
     _program = std::make_unique<glslang::TProgram>();
@@ -138,6 +272,7 @@ void SPIRVUtils::compileGLSL(ShaderStageFlagBit type, const ccstd::string &sourc
 
     if (!_program->link(messages)) {
         CC_LOG_ERROR("GLSL Linking Failed:\n%s\n%s", _program->getInfoLog(), _program->getInfoDebugLog());
+        succeeded = false;
     }
 
     _output.clear();
@@ -151,11 +286,35 @@ void SPIRVUtils::compileGLSL(ShaderStageFlagBit type, const ccstd::string &sourc
     spvOptions.stripDebugInfo = true;
 #endif
     glslang::GlslangToSpv(*_program->getIntermediate(stage), _output, &logger, &spvOptions);
+
+    _activeInputLocations.clear();
+    if (succeeded && _program->buildReflection()) {
+        const int activeCount = _program->getNumPipeInputs();
+        for (int i = 0; i < activeCount; ++i) {
+            _activeInputLocations.push_back(_program->getPipeInput(i).getType()->getQualifier().layoutLocation);
+        }
+    }
+
+    const auto compileMicros = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                                         std::chrono::steady_clock::now() - compileBegin)
+                                                         .count());
+    _compileMicros += compileMicros;
+    ++_cacheMisses;
+    if (succeeded && !_output.empty()) {
+        CacheEntry &entry = _cache[key];
+        entry.stage = static_cast<uint32_t>(type);
+        entry.sourceLength = static_cast<uint32_t>(source.size());
+        entry.compileMicros = compileMicros;
+        entry.wordCount = static_cast<uint32_t>(_output.size());
+        entry.used = true;
+        entry.inputLocations = _activeInputLocations;
+        entry.code = _output;
+        _cacheDirty = true;
+    }
 }
 
 void SPIRVUtils::compressInputLocations(gfx::AttributeList &attributes) {
     static ccstd::vector<Id> ids;
-    static ccstd::vector<uint32_t> activeLocations;
     static ccstd::vector<uint32_t> newLocations;
 
     uint32_t *code = _output.data();
@@ -202,15 +361,9 @@ void SPIRVUtils::compressInputLocations(gfx::AttributeList &attributes) {
         insn += wordCount;
     }
 
-    _program->buildReflection();
-    activeLocations.clear();
-    int activeCount = _program->getNumPipeInputs();
-    for (int i = 0; i < activeCount; ++i) {
-        activeLocations.push_back(_program->getPipeInput(i).getType()->getQualifier().layoutLocation);
-    }
-
+    const auto &activeLocations = _activeInputLocations;
     uint32_t location = 0;
-    uint32_t unusedLocation = activeCount;
+    auto unusedLocation = static_cast<uint32_t>(activeLocations.size());
     newLocations.assign(attributes.size(), UINT_MAX);
 
     for (auto &id : ids) {
@@ -25,19 +25,39 @@
 #pragma once
 
 #include <memory>
+#include "base/std/container/string.h"
+#include "base/std/container/unordered_map.h"
 #include "gfx-base/GFXDef.h"
 #include "glslang/Public/ShaderLang.h"
 
 namespace cc {
 namespace gfx {
 
+/**
+ * Compiles GLSL into SPIR-V with glslang.
+ * Compiled modules are cached on disk under the writable path, keyed by the content hash of the
+ * processed source, so shader variants seen in earlier launches skip glslang entirely.
+ * The file is bounded by the cache limit: modules used in this session are kept first, then the
+ * ones that took longest to compile.
+ */
 class SPIRVUtils {
 public:
     static SPIRVUtils *getInstance() { return &instance; }
+    static ccstd::string getCachePath();
+
+    static constexpr uint32_t DEFAULT_CACHE_LIMIT = 16 * 1024 * 1024;
 
     void initialize(int vulkanMinorVersion);
     void destroy();
 
+    // Writes modules compiled since the last save, for backends that are rarely destroyed.
+    void flushCache();
+
+    inline void setCacheLimit(uint32_t bytes) { _cacheLimit = bytes; }
+    inline uint32_t getCacheLimit() const { return _cacheLimit; }
+    inline uint32_t getCacheHits() const { return _cacheHits; }
+    inline uint32_t getCacheMisses() const { return _cacheMisses; }
+
     void compileGLSL(ShaderStageFlagBit type, const ccstd::string &source);
     void compressInputLocations(gfx::AttributeList &attributes);
 
@@ -52,6 +72,20 @@ public:
     }
 
 private:
+    struct CacheEntry {
+        uint32_t stage{0};
+        uint32_t sourceLength{0};
+        uint32_t compileMicros{0};
+        uint32_t offset{0}; // word offset into the loaded cache data
+        uint32_t wordCount{0};
+        bool used{false};                       // hit or compiled in this session
+        ccstd::vector<uint32_t> inputLocations; // active pipe inputs, reflected when compiled
+        ccstd::vector<uint32_t> code;           // modules compiled in this session
+    };
+
+    void loadCache();
+    void saveCache();
+
     int _clientInputSemanticsVersion{0};
     glslang::EShTargetClientVersion _clientVersion{glslang::EShTargetClientVersion::EShTargetVulkan_1_0};
     glslang::EShTargetLanguageVersion _targetVersion{glslang::EShTargetLanguageVersion::EShTargetSpv_1_0};
@@ -59,6 +93,18 @@ private:
     std::unique_ptr<glslang::TShader> _shader{nullptr};
     std::unique_ptr<glslang::TProgram> _program{nullptr};
     ccstd::vector<uint32_t> _output;
+    // locations of the inputs the last module reads, cached along with it so hits can be compressed too
+    ccstd::vector<uint32_t> _activeInputLocations;
+
+    ccstd::string _cachePath;
+    ccstd::vector<uint32_t> _cacheData;
+    ccstd::unordered_map<uint64_t, CacheEntry> _cache;
+    bool _cacheDirty{false};
+    uint32_t _cacheLimit{DEFAULT_CACHE_LIMIT};
+    uint32_t _cacheHits{0};
+    uint32_t _cacheMisses{0};
+    uint64_t _savedMicros{0};
+    uint64_t _compileMicros{0};
 
     static SPIRVUtils instance;
 };
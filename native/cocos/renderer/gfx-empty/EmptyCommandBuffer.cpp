@@ -34,6 +34,9 @@ void EmptyCommandBuffer::doDestroy() {
 }
 
 void EmptyCommandBuffer::begin(RenderPass *renderPass, uint32_t subpass, Framebuffer *frameBuffer) {
+    _numDrawCalls = 0;
+    _numInstances = 0;
+    _numTriangles = 0;
 }
 
 void EmptyCommandBuffer::end() {
@@ -46,6 +49,11 @@ void EmptyCommandBuffer::endRenderPass() {
 }
 
 void EmptyCommandBuffer::execute(CommandBuffer *const *cmdBuffs, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        _numDrawCalls += cmdBuffs[i]->getNumDrawCalls();
+        _numInstances += cmdBuffs[i]->getNumInstances();
+        _numTriangles += cmdBuffs[i]->getNumTris();
+    }
 }
 
 void EmptyCommandBuffer::bindPipelineState(PipelineState *pso) {
@@ -85,6 +93,8 @@ void EmptyCommandBuffer::nextSubpass() {
 }
 
 void EmptyCommandBuffer::draw(const DrawInfo &info) {
+    ++_numDrawCalls;
+    _numInstances += info.instanceCount;
 }
 
 void EmptyCommandBuffer::updateBuffer(Buffer *buff, const void *data, uint32_t size) {
@@ -171,6 +171,8 @@ bool CCWGPUDevice::doInit(const DeviceInfo &info) {
 }
 
 void CCWGPUDevice::doDestroy() {
+    CCWGPUShader::destroySPIRV();
+
     if (_gpuDeviceObj) {
         if (_gpuDeviceObj->defaultResources.uniformBuffer) {
             delete _gpuDeviceObj->defaultResources.uniformBuffer;
@@ -471,6 +473,7 @@ void CCWGPUDevice::present() {
     queue->resetStatus();
 
     CCWGPUDescriptorSet::clearCache();
+    CCWGPUShader::flushSPIRVCache();
 
     _currentFrameIndex = (++_currentFrameIndex) % CC_WGPU_MAX_FRAME_COUNT;
 }
@@ -41,6 +41,10 @@ namespace gfx {
 using namespace emscripten;
 SPIRVUtils *CCWGPUShader::spirv = nullptr;
 
+namespace {
+constexpr uint32_t SPIRV_CACHE_FLUSH_INTERVAL = 300;
+} // namespace
+
 CCWGPUShader::CCWGPUShader() : Shader() {
 }
 
@@ -193,5 +197,25 @@ void CCWGPUShader::doDestroy() {
     }
 }
 
+void CCWGPUShader::flushSPIRVCache() {
+#if USE_NATIVE_SPIRV
+    // shaders compile in bursts while loading, one write per interval covers a burst
+    static uint32_t framesSinceFlush = 0;
+    if (spirv && ++framesSinceFlush >= SPIRV_CACHE_FLUSH_INTERVAL) {
+        framesSinceFlush = 0;
+        spirv->flushCache();
+    }
+#endif
+}
+
+void CCWGPUShader::destroySPIRV() {
+#if USE_NATIVE_SPIRV
+    if (spirv) {
+        spirv->destroy();
+        spirv = nullptr;
+    }
+#endif
+}
+
 } // namespace gfx
 } // namespace cc
\ No newline at end of file
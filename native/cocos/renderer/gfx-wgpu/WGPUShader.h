@@ -48,6 +48,10 @@ public:
         void initialize(const ShaderInfo &info, emscripten::val &spirvs);)
     void initialize(const ShaderInfo &info, const std::vector<std::vector<uint32_t>> &spirvs);
 
+    // save points of the SPIR-V cache, a page is usually closed without destroying the device
+    static void flushSPIRVCache();
+    static void destroySPIRV();
+
 protected:
     void doInit(const ShaderInfo &info) override;
     void doDestroy() override;
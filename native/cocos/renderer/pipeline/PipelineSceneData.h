@@ -27,6 +27,7 @@
 #include "Define.h"
 #include "base/RefCounted.h"
 #include "core/assets/Material.h"
+#include "core/geometry/IntersectBatch.h"
 #include "renderer/gfx-base/GFXFramebuffer.h"
 #include "renderer/pipeline/shadow/CSMLayers.h"
 
@@ -91,6 +92,16 @@ public:
     inline bool getCSMSupported() const { return _csmSupported; }
     inline void setCSMSupported(bool val) { _csmSupported = val; }
 
+    // Scratch storage of sceneCulling and validPunctualLightsCulling, kept across frames so culling does not allocate.
+    struct CullingBuffers {
+        ccstd::vector<const scene::Model *> models;
+        ccstd::vector<scene::Light *> lights;
+        geometry::AABBBatch bounds;
+        geometry::SphereBatch spheres;
+        geometry::BatchMask mask;
+    };
+    inline CullingBuffers &getCullingBuffers() { return _cullingBuffers; }
+
 protected:
     void initOcclusionQuery();
     void initGeometryRenderer();
@@ -131,6 +142,7 @@ protected:
     float _shadingScale{1.0F};
 
     RenderObjectList _renderObjects;
+    CullingBuffers _cullingBuffers;
 
     ccstd::vector<IntrusivePtr<Material>> _geometryRendererMaterials;
     // `scene::Light *`: weak reference
@@ -22,15 +22,162 @@
  THE SOFTWARE.
 ****************************************************************************/
 
+
 #include "PipelineStateManager.h"
+#include <algorithm>
+#include <cstring>
+#include "base/Data.h"
+#include "base/Log.h"
+#include "base/threading/ThreadPool.h"
 #include "gfx-base/GFXDef-common.h"
 #include "gfx-base/GFXDevice.h"
+#include "platform/FileUtils.h"
+#include "profiler/Profiler.h"
 #include "scene/Pass.h"
 
 namespace cc {
 namespace pipeline {
 
+namespace {
+
+constexpr uint32_t PSO_CACHE_MAGIC = 0x4F535043; // "CPSO"
+constexpr uint32_t PSO_CACHE_VERSION = 2;
+
+class CacheWriter final {
+public:
+    void write(uint32_t value) {
+        const auto offset = _buffer.size();
+        _buffer.resize(offset + sizeof(value));
+        memcpy(_buffer.data() + offset, &value, sizeof(value));
+    }
+
+    template <typename T>
+    void writeEnum(T value) { write(static_cast<uint32_t>(value)); }
+
+    void write(const gfx::IndexList &list) {
+        write(static_cast<uint32_t>(list.size()));
+        for (const auto index : list) write(index);
+    }
+
+    const ccstd::vector<uint8_t> &getBuffer() const { return _buffer; }
+
+private:
+    ccstd::vector<uint8_t> _buffer;
+};
+
+class CacheReader final {
+public:
+    CacheReader(const uint8_t *data, size_t size) : _data(data), _size(size) {}
+
+    bool read(uint32_t &value) {
+        if (_offset + sizeof(value) > _size) return false;
+        memcpy(&value, _data + _offset, sizeof(value));
+        _offset += sizeof(value);
+        return true;
+    }
+
+    template <typename T>
+    bool readEnum(T &value) {
+        uint32_t raw{0};
+        if (!read(raw)) return false;
+        value = static_cast<T>(raw);
+        return true;
+    }
+
+    bool read(gfx::IndexList &list) {
+        uint32_t count{0};
+        if (!read(count) || count > (_size - _offset) / sizeof(uint32_t)) return false;
+        list.resize(count);
+        for (auto &index : list) {
+            if (!read(index)) return false;
+        }
+        return true;
+    }
+
+private:
+    const uint8_t *_data{nullptr};
+    size_t _size{0};
+    size_t _offset{0};
+};
+
+// Only the parts of a render pass that decide pipeline compatibility: attachment formats,
+// sample counts and the subpass layout. Barriers are device objects and are left out.
+gfx::RenderPassInfo getCompatibleRenderPassInfo(const gfx::RenderPass *renderPass) {
+    gfx::RenderPassInfo info;
+    info.colorAttachments = renderPass->getColorAttachments();
+    for (auto &attachment : info.colorAttachments) {
+        attachment.barrier = nullptr;
+    }
+    info.depthStencilAttachment = renderPass->getDepthStencilAttachment();
+    info.depthStencilAttachment.barrier = nullptr;
+    info.subpasses = renderPass->getSubpasses();
+    return info;
+}
+
+ccstd::hash_t computeRenderPassLayoutHash(const gfx::RenderPassInfo &info) {
+    ccstd::hash_t seed = static_cast<uint32_t>(info.colorAttachments.size()) * 2 + 3;
+    for (const auto &attachment : info.colorAttachments) {
+        ccstd::hash_combine(seed, attachment.format);
+        ccstd::hash_combine(seed, attachment.sampleCount);
+    }
+    ccstd::hash_combine(seed, info.depthStencilAttachment.format);
+    ccstd::hash_combine(seed, info.depthStencilAttachment.sampleCount);
+    ccstd::hash_combine(seed, info.subpasses);
+    return seed;
+}
+
+ccstd::hash_t computeShaderHash(const gfx::Shader *shader) {
+    const auto &name = shader->getName();
+    ccstd::hash_t seed = 666;
+    ccstd::hash_range(seed, name.begin(), name.end());
+    return seed;
+}
+
+ccstd::hash_t computeSourceKey(ccstd::hash_t passHash, ccstd::hash_t shaderHash, ccstd::hash_t iaHash) {
+    ccstd::hash_t seed = 0;
+    ccstd::hash_combine(seed, passHash);
+    ccstd::hash_combine(seed, shaderHash);
+    ccstd::hash_combine(seed, iaHash);
+    return seed;
+}
+
+ccstd::hash_t computeStableKey(ccstd::hash_t sourceKey, ccstd::hash_t renderPassHash, uint32_t subpass) {
+    ccstd::hash_t seed = sourceKey;
+    ccstd::hash_combine(seed, renderPassHash);
+    ccstd::hash_combine(seed, subpass);
+    return seed;
+}
+
+gfx::PipelineState *createPipelineState(const scene::Pass *pass, gfx::Shader *shader, gfx::InputAssembler *inputAssembler,
+                                        gfx::RenderPass *renderPass, uint32_t subpass) {
+    return gfx::Device::getInstance()->createPipelineState({shader,
+                                                            pass->getPipelineLayout(),
+                                                            renderPass,
+                                                            {inputAssembler->getAttributes()},
+                                                            *(pass->getRasterizerState()),
+                                                            *(pass->getDepthStencilState()),
+                                                            *(pass->getBlendState()),
+                                                            pass->getPrimitive(),
+                                                            pass->getDynamicStates(),
+                                                            gfx::PipelineBindPoint::GRAPHICS,
+                                                            subpass});
+}
+
+} // namespace
+
 ccstd::unordered_map<ccstd::hash_t, IntrusivePtr<gfx::PipelineState>> PipelineStateManager::psoHashMap;
+ccstd::unordered_map<ccstd::hash_t, PipelineStateManager::PipelineStateRecord> PipelineStateManager::records;
+ccstd::unordered_map<ccstd::hash_t, gfx::RenderPassInfo> PipelineStateManager::renderPassInfos;
+ccstd::unordered_map<ccstd::hash_t, ccstd::vector<ccstd::hash_t>> PipelineStateManager::recordsBySource;
+ccstd::unordered_map<ccstd::hash_t, IntrusivePtr<gfx::RenderPass>> PipelineStateManager::warmRenderPasses;
+ccstd::unordered_map<ccstd::hash_t, IntrusivePtr<gfx::PipelineState>> PipelineStateManager::warmHashMap;
+ccstd::unordered_set<ccstd::hash_t> PipelineStateManager::liveKeys;
+ccstd::vector<PipelineStateManager::PrewarmRequest> PipelineStateManager::prewarmRequests;
+std::future<PipelineStateManager::LoadedCache> PipelineStateManager::pendingLoad;
+PipelineStateCacheStats PipelineStateManager::cacheStats;
+uint32_t PipelineStateManager::generation{0};
+bool PipelineStateManager::cacheLoaded{false};
+bool PipelineStateManager::cacheDirty{false};
 
 gfx::PipelineState *PipelineStateManager::getOrCreatePipelineState(const scene::Pass *pass,
                                                                    gfx::Shader *shader,
@@ -48,19 +195,30 @@ gfx::PipelineState *PipelineStateManager::getOrCreatePipelineState(const scene::
 
     auto *pso = psoHashMap[static_cast<ccstd::hash_t>(hash)].get();
     if (!pso) {
-        auto *pipelineLayout = pass->getPipelineLayout();
-
-        pso = gfx::Device::getInstance()->createPipelineState({shader,
-                                                               pipelineLayout,
-                                                               renderPass,
-                                                               {inputAssembler->getAttributes()},
-                                                               *(pass->getRasterizerState()),
-                                                               *(pass->getDepthStencilState()),
-                                                               *(pass->getBlendState()),
-                                                               pass->getPrimitive(),
-                                                               pass->getDynamicStates(),
-                                                               gfx::PipelineBindPoint::GRAPHICS,
-                                                               subpass});
+        PipelineStateRecord record;
+        record.passHash = passHash;
+        record.shaderHash = computeShaderHash(shader);
+        record.iaHash = iaHash;
+        record.renderPassHash = computeRenderPassLayoutHash(getCompatibleRenderPassInfo(renderPass));
+        record.subpass = subpass;
+        const auto stableKey = computeStableKey(computeSourceKey(record.passHash, record.shaderHash, record.iaHash),
+                                                record.renderPassHash, subpass);
+
+        auto iter = warmHashMap.find(stableKey);
+        if (iter != warmHashMap.end()) {
+            // take the reference before erasing, the warm map may hold the only one
+            psoHashMap[static_cast<ccstd::hash_t>(hash)] = std::move(iter->second);
+            pso = psoHashMap[static_cast<ccstd::hash_t>(hash)].get();
+            warmHashMap.erase(iter);
+            ++cacheStats.hits;
+            CC_PROFILE_RENDER_INC(PSOCacheHit, 1);
+        } else {
+            pso = createPipelineState(pass, shader, inputAssembler, renderPass, subpass);
+            ++cacheStats.misses;
+            CC_PROFILE_RENDER_INC(PSOCacheMiss, 1);
+            recordPipelineState(stableKey, record, renderPass);
+        }
+        liveKeys.insert(stableKey);
 
         psoHashMap[static_cast<ccstd::hash_t>(hash)] = pso;
     }
@@ -68,11 +226,334 @@ gfx::PipelineState *PipelineStateManager::getOrCreatePipelineState(const scene::
     return pso;
 }
 
+void PipelineStateManager::prewarm(scene::Pass *pass, gfx::Shader *shader, gfx::InputAssembler *inputAssembler) {
+    if (!pass || !shader || !inputAssembler) return;
+    if (!cacheLoaded && !pendingLoad.valid()) {
+        loadCacheAsync();
+    }
+    if (cacheLoaded && recordsBySource.empty()) return;
+
+    prewarmRequests.push_back({pass, shader, inputAssembler});
+}
+
+void PipelineStateManager::update() {
+    if (prewarmRequests.empty()) return;
+    mergePendingLoad(false);
+    if (!cacheLoaded) return; // still reading
+    if (recordsBySource.empty()) {
+        prewarmRequests.clear();
+        return;
+    }
+
+    uint32_t budget = MAX_PREWARM_PER_FRAME;
+    size_t processed = 0;
+    for (; processed < prewarmRequests.size() && budget; ++processed) {
+        prewarmRequest(prewarmRequests[processed], budget);
+    }
+    // a request stopped by the budget is visited again, the states it already created are skipped
+    if (!budget && processed) {
+        --processed;
+    }
+    prewarmRequests.erase(prewarmRequests.begin(), prewarmRequests.begin() + static_cast<std::ptrdiff_t>(processed));
+}
+
+void PipelineStateManager::prewarmRequest(const PrewarmRequest &request, uint32_t &budget) {
+    const auto sourceKey = computeSourceKey(request.pass->getHash(), computeShaderHash(request.shader), request.inputAssembler->getAttributesHash());
+    auto iter = recordsBySource.find(sourceKey);
+    if (iter == recordsBySource.end()) return;
+
+    for (const auto stableKey : iter->second) {
+        if (!budget) return;
+        if (warmHashMap.count(stableKey) || liveKeys.count(stableKey)) continue;
+
+        const auto &record = records[stableKey];
+        auto &renderPass = warmRenderPasses[record.renderPassHash];
+        if (!renderPass) {
+            renderPass = gfx::Device::getInstance()->createRenderPass(renderPassInfos[record.renderPassHash]);
+        }
+        // Creation goes through the device agent when multithreaded, so the
+        // backend pipeline is compiled on the render thread ahead of its first use.
+        warmHashMap[stableKey] = createPipelineState(request.pass, request.shader, request.inputAssembler, renderPass, record.subpass);
+        ++cacheStats.prewarmed;
+        --budget;
+    }
+}
+
+void PipelineStateManager::recordPipelineState(ccstd::hash_t key, const PipelineStateRecord &record, const gfx::RenderPass *renderPass) {
+    if (records.count(key)) return;
+
+    auto &stored = records[key];
+    stored = record;
+    stored.lastUsed = generation;
+    if (!renderPassInfos.count(record.renderPassHash)) {
+        renderPassInfos[record.renderPassHash] = getCompatibleRenderPassInfo(renderPass);
+    }
+    recordsBySource[computeSourceKey(record.passHash, record.shaderHash, record.iaHash)].push_back(key);
+    cacheDirty = true;
+}
+
+ccstd::string PipelineStateManager::getCachePath() {
+    return FileUtils::getInstance()->getWritablePath() + "pso-cache.bin";
+}
+
+void PipelineStateManager::loadCacheAsync() {
+    if (cacheLoaded || pendingLoad.valid()) return;
+
+    auto path = getCachePath();
+    const auto api = static_cast<uint32_t>(gfx::Device::getInstance()->getGfxAPI());
+    pendingLoad = ThreadPool::getInstance()->dispatchTask([path = std::move(path), api]() {
+        auto *fileUtils = FileUtils::getInstance();
+        if (!fileUtils->isFileExist(path)) return LoadedCache{};
+
+        auto cache = parseCache(fileUtils->getDataFromFile(path), api);
+        if (!cache.valid) {
+            CC_LOG_WARNING("PipelineStateManager: discard invalid pipeline state cache %s", path.c_str());
+        }
+        return cache;
+    });
+}
+
+bool PipelineStateManager::loadCache() {
+    if (pendingLoad.valid()) {
+        return mergePendingLoad(true);
+    }
+
+    const auto path = getCachePath();
+    auto *fileUtils = FileUtils::getInstance();
+    LoadedCache cache;
+    if (fileUtils->isFileExist(path)) {
+        cache = parseCache(fileUtils->getDataFromFile(path), static_cast<uint32_t>(gfx::Device::getInstance()->getGfxAPI()));
+        if (!cache.valid) {
+            CC_LOG_WARNING("PipelineStateManager: discard invalid pipeline state cache %s", path.c_str());
+        }
+    }
+    const bool valid = cache.valid;
+    mergeCache(std::move(cache));
+    return valid;
+}
+
+bool PipelineStateManager::mergePendingLoad(bool wait) {
+    if (cacheLoaded) return true;
+    if (!pendingLoad.valid()) return false;
+    if (!wait && pendingLoad.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+
+    auto cache = pendingLoad.get();
+    const bool valid = cache.valid;
+    mergeCache(std::move(cache));
+    return valid;
+}
+
+void PipelineStateManager::mergeCache(LoadedCache &&cache) {
+    cacheLoaded = true;
+    // every launch is a new generation, records are stamped with the last one that used them.
+    // pipelines may be rebuilt and the cache reloaded within a launch, those keep its generation
+    if (generation == 0) {
+        generation = cache.generation + 1;
+    }
+    if (!cache.valid) return;
+
+    for (auto &pair : cache.renderPassInfos) {
+        renderPassInfos.emplace(pair.first, std::move(pair.second));
+    }
+    for (const auto &pair : cache.records) {
+        if (records.emplace(pair.first, pair.second).second) {
+            const auto &record = pair.second;
+            recordsBySource[computeSourceKey(record.passHash, record.shaderHash, record.iaHash)].push_back(pair.first);
+        }
+    }
+    // records age by one launch even if nothing new is recorded
+    cacheDirty = cacheDirty || !cache.records.empty();
+}
+
+PipelineStateManager::LoadedCache PipelineStateManager::parseCache(const Data &data, uint32_t api) {
+    LoadedCache cache;
+    CacheReader reader(data.getBytes(), data.getSize());
+
+    uint32_t magic{0};
+    uint32_t version{0};
+    uint32_t cacheApi{0};
+    if (!reader.read(magic) || magic != PSO_CACHE_MAGIC ||
+        !reader.read(version) || version != PSO_CACHE_VERSION ||
+        !reader.read(cacheApi) || cacheApi != api ||
+        !reader.read(cache.generation)) {
+        cache.generation = 0;
+        return cache;
+    }
+
+    bool valid = true;
+    uint32_t renderPassCount{0};
+    valid = valid && reader.read(renderPassCount);
+    for (uint32_t i = 0; valid && i < renderPassCount; ++i) {
+        gfx::RenderPassInfo info;
+        uint32_t colorCount{0};
+        valid = reader.read(colorCount) && colorCount <= data.getSize();
+        info.colorAttachments.resize(valid ? colorCount : 0);
+        for (auto &attachment : info.colorAttachments) {
+            valid = valid && reader.readEnum(attachment.format) && reader.readEnum(attachment.sampleCount) &&
+                    reader.readEnum(attachment.loadOp) && reader.readEnum(attachment.storeOp) &&
+                    reader.read(attachment.isGeneralLayout);
+        }
+        auto &ds = info.depthStencilAttachment;
+        valid = valid && reader.readEnum(ds.format) && reader.readEnum(ds.sampleCount) &&
+                reader.readEnum(ds.depthLoadOp) && reader.readEnum(ds.depthStoreOp) &&
+                reader.readEnum(ds.stencilLoadOp) && reader.readEnum(ds.stencilStoreOp) &&
+                reader.read(ds.isGeneralLayout);
+        uint32_t subpassCount{0};
+        valid = valid && reader.read(subpassCount) && subpassCount <= data.getSize();
+        info.subpasses.resize(valid ? subpassCount : 0);
+        for (auto &subpass : info.subpasses) {
+            valid = valid && reader.read(subpass.inputs) && reader.read(subpass.colors) &&
+                    reader.read(subpass.resolves) && reader.read(subpass.preserves) &&
+                    reader.read(subpass.depthStencil) && reader.read(subpass.depthStencilResolve) &&
+                    reader.readEnum(subpass.depthResolveMode) && reader.readEnum(subpass.stencilResolveMode);
+        }
+        if (valid) {
+            cache.renderPassInfos[computeRenderPassLayoutHash(info)] = std::move(info);
+        }
+    }
+
+    uint32_t recordCount{0};
+    valid = valid && reader.read(recordCount);
+    for (uint32_t i = 0; valid && i < recordCount; ++i) {
+        PipelineStateRecord record;
+        valid = reader.read(record.passHash) && reader.read(record.shaderHash) && reader.read(record.iaHash) &&
+                reader.read(record.renderPassHash) && reader.read(record.subpass) && reader.read(record.lastUsed);
+        if (valid && cache.renderPassInfos.count(record.renderPassHash)) {
+            const auto key = computeStableKey(computeSourceKey(record.passHash, record.shaderHash, record.iaHash),
+                                              record.renderPassHash, record.subpass);
+            cache.records[key] = record;
+        }
+    }
+
+    if (!valid) {
+        return LoadedCache{};
+    }
+    cache.valid = true;
+    return cache;
+}
+
+bool PipelineStateManager::saveCache() {
+    if (!cacheDirty) return true;
+    if (!cacheLoaded) {
+        // keep the records of earlier launches, and continue their generations
+        loadCache();
+    }
+
+    // stamp the records used by this launch, then drop the ones unused for too long and cap the rest
+    ccstd::vector<std::pair<ccstd::hash_t, PipelineStateRecord>> kept;
+    kept.reserve(records.size());
+    for (const auto &pair : records) {
+        auto record = pair.second;
+        if (liveKeys.count(pair.first)) {
+            record.lastUsed = generation;
+        }
+        if (generation - record.lastUsed < MAX_RECORD_AGE) {
+            kept.emplace_back(pair.first, record);
+        }
+    }
+    if (kept.size() > MAX_RECORD_COUNT) {
+        std::nth_element(kept.begin(), kept.begin() + MAX_RECORD_COUNT, kept.end(), [](const auto &lhs, const auto &rhs) {
+            return lhs.second.lastUsed > rhs.second.lastUsed;
+        });
+        kept.resize(MAX_RECORD_COUNT);
+    }
+    ccstd::unordered_set<ccstd::hash_t> keptRenderPasses;
+    for (const auto &pair : kept) {
+        keptRenderPasses.insert(pair.second.renderPassHash);
+    }
+
+    CacheWriter writer;
+    writer.write(PSO_CACHE_MAGIC);
+    writer.write(PSO_CACHE_VERSION);
+    writer.writeEnum(gfx::Device::getInstance()->getGfxAPI());
+    writer.write(generation);
+
+    writer.write(static_cast<uint32_t>(keptRenderPasses.size()));
+    for (const auto &pair : renderPassInfos) {
+        if (!keptRenderPasses.count(pair.first)) continue;
+
+        const auto &info = pair.second;
+        writer.write(static_cast<uint32_t>(info.colorAttachments.size()));
+        for (const auto &attachment : info.colorAttachments) {
+            writer.writeEnum(attachment.format);
+            writer.writeEnum(attachment.sampleCount);
+            writer.writeEnum(attachment.loadOp);
+            writer.writeEnum(attachment.storeOp);
+            writer.write(attachment.isGeneralLayout);
+        }
+        const auto &ds = info.depthStencilAttachment;
+        writer.writeEnum(ds.format);
+        writer.writeEnum(ds.sampleCount);
+        writer.writeEnum(ds.depthLoadOp);
+        writer.writeEnum(ds.depthStoreOp);
+        writer.writeEnum(ds.stencilLoadOp);
+        writer.writeEnum(ds.stencilStoreOp);
+        writer.write(ds.isGeneralLayout);
+        writer.write(static_cast<uint32_t>(info.subpasses.size()));
+        for (const auto &subpass : info.subpasses) {
+            writer.write(subpass.inputs);
+            writer.write(subpass.colors);
+            writer.write(subpass.resolves);
+            writer.write(subpass.preserves);
+            writer.write(subpass.depthStencil);
+            writer.write(subpass.depthStencilResolve);
+            writer.writeEnum(subpass.depthResolveMode);
+            writer.writeEnum(subpass.stencilResolveMode);
+        }
+    }
+
+    writer.write(static_cast<uint32_t>(kept.size()));
+    for (const auto &pair : kept) {
+        const auto &record = pair.second;
+        writer.write(record.passHash);
+        writer.write(record.shaderHash);
+        writer.write(record.iaHash);
+        writer.write(record.renderPassHash);
+        writer.write(record.subpass);
+        writer.write(record.lastUsed);
+    }
+
+    const auto &buffer = writer.getBuffer();
+    Data data;
+    data.copy(buffer.data(), static_cast<uint32_t>(buffer.size()));
+    if (!FileUtils::getInstance()->writeDataToFile(data, getCachePath())) {
+        CC_LOG_WARNING("PipelineStateManager: failed to write pipeline state cache %s", getCachePath().c_str());
+        return false;
+    }
+    cacheDirty = false;
+    return true;
+}
+
 void PipelineStateManager::destroyAll() {
+    prewarmRequests.clear();
+    // a load still in flight must not outlive the device it validated against
+    mergePendingLoad(true);
+    saveCache();
+
     for (auto &pair : psoHashMap) {
         CC_SAFE_DESTROY_NULL(pair.second);
     }
     psoHashMap.clear();
+    liveKeys.clear();
+    for (auto &pair : warmHashMap) {
+        CC_SAFE_DESTROY_NULL(pair.second);
+    }
+    warmHashMap.clear();
+    for (auto &pair : warmRenderPasses) {
+        CC_SAFE_DESTROY_NULL(pair.second);
+    }
+    warmRenderPasses.clear();
+
+    // everything is persisted, the next pipeline of this launch reloads it from the file
+    records.clear();
+    renderPassInfos.clear();
+    recordsBySource.clear();
+    cacheLoaded = false;
+    cacheDirty = false;
+}
+
+void PipelineStateManager::beginLaunch() {
+    generation = 0;
 }
 
 } // namespace pipeline
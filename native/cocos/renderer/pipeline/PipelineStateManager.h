@@ -24,15 +24,34 @@
 
 #pragma once
 
+#include <future>
 #include "cocos/base/Ptr.h"
+#include "base/std/container/string.h"
+#include "base/std/container/unordered_set.h"
+#include "base/std/container/vector.h"
 #include "gfx-base/GFXDef.h"
 
 namespace cc {
 namespace scene {
 class Pass;
 }
+class Data;
 namespace pipeline {
 
+struct PipelineStateCacheStats {
+    uint32_t hits{0};      // runtime misses served by a prewarmed pipeline state
+    uint32_t misses{0};    // pipeline states created lazily during rendering
+    uint32_t prewarmed{0}; // pipeline states created ahead of time from the disk cache
+};
+
+/**
+ * Pipeline states are cached per frame by a runtime key, which embeds render pass hashes and shader ids
+ * that change across launches. Alongside it, every pipeline state created during play is recorded with a
+ * launch-stable descriptor (pass hash, shader name, vertex layout and render pass layout) and written to
+ * the writable path. On the next launch the records are read on a worker thread; sub-models queue their
+ * passes with `prewarm` as they are initialized, and `update` recreates the recorded pipeline states a few
+ * per frame, ahead of the first frame that draws them. Records unused for a few launches are dropped.
+ */
 class CC_DLL PipelineStateManager {
 public:
     static gfx::PipelineState *getOrCreatePipelineState(const scene::Pass *pass,
@@ -40,10 +59,69 @@ public:
                                                         gfx::InputAssembler *inputAssembler,
                                                         gfx::RenderPass *renderPass,
                                                         uint32_t subpass = 0);
+    // queue the pipeline states recorded for this pass in earlier launches, they are created by update()
+    static void prewarm(scene::Pass *pass, gfx::Shader *shader, gfx::InputAssembler *inputAssembler);
+    // create queued pipeline states, at most MAX_PREWARM_PER_FRAME per call
+    static void update();
     static void destroyAll();
 
+    // start reading the cache of the previous launches on a worker thread
+    static void loadCacheAsync();
+    static bool loadCache();
+    static bool saveCache();
+    static ccstd::string getCachePath();
+    // the next cache load starts a new generation, as a relaunch of the process does
+    static void beginLaunch();
+    static inline const PipelineStateCacheStats &getCacheStats() { return cacheStats; }
+    static inline uint32_t getRecordCount() { return static_cast<uint32_t>(records.size()); }
+
+    static constexpr uint32_t MAX_PREWARM_PER_FRAME = 16;
+    static constexpr uint32_t MAX_RECORD_AGE = 8; // launches a record is kept without being used
+    static constexpr uint32_t MAX_RECORD_COUNT = 4096;
+
 private:
+    struct PipelineStateRecord {
+        ccstd::hash_t passHash{0};
+        ccstd::hash_t shaderHash{0};
+        ccstd::hash_t iaHash{0};
+        ccstd::hash_t renderPassHash{0};
+        uint32_t subpass{0};
+        uint32_t lastUsed{0}; // generation of the launch that last used it
+    };
+
+    struct LoadedCache {
+        ccstd::unordered_map<ccstd::hash_t, gfx::RenderPassInfo> renderPassInfos;
+        ccstd::unordered_map<ccstd::hash_t, PipelineStateRecord> records;
+        uint32_t generation{0};
+        bool valid{false};
+    };
+
+    struct PrewarmRequest {
+        IntrusivePtr<scene::Pass> pass;
+        IntrusivePtr<gfx::Shader> shader;
+        IntrusivePtr<gfx::InputAssembler> inputAssembler;
+    };
+
+    static LoadedCache parseCache(const Data &data, uint32_t api);
+    static void mergeCache(LoadedCache &&cache);
+    static bool mergePendingLoad(bool wait);
+    static void prewarmRequest(const PrewarmRequest &request, uint32_t &budget);
+    static void recordPipelineState(ccstd::hash_t key, const PipelineStateRecord &record, const gfx::RenderPass *renderPass);
+
     static ccstd::unordered_map<ccstd::hash_t, IntrusivePtr<gfx::PipelineState>> psoHashMap;
+
+    static ccstd::unordered_map<ccstd::hash_t, PipelineStateRecord> records;
+    static ccstd::unordered_map<ccstd::hash_t, gfx::RenderPassInfo> renderPassInfos;
+    static ccstd::unordered_map<ccstd::hash_t, ccstd::vector<ccstd::hash_t>> recordsBySource;
+    static ccstd::unordered_map<ccstd::hash_t, IntrusivePtr<gfx::RenderPass>> warmRenderPasses;
+    static ccstd::unordered_map<ccstd::hash_t, IntrusivePtr<gfx::PipelineState>> warmHashMap;
+    static ccstd::unordered_set<ccstd::hash_t> liveKeys;
+    static ccstd::vector<PrewarmRequest> prewarmRequests;
+    static std::future<LoadedCache> pendingLoad;
+    static PipelineStateCacheStats cacheStats;
+    static uint32_t generation;
+    static bool cacheLoaded;
+    static bool cacheDirty;
 };
 
 } // namespace pipeline
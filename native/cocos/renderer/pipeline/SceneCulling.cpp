@@ -22,6 +22,7 @@
  THE SOFTWARE.
 ****************************************************************************/
 
+#include <algorithm>
 #include "base/std/container/array.h"
 
 #include "Define.h"
@@ -32,6 +33,7 @@
 #include "core/geometry/AABB.h"
 #include "core/geometry/Frustum.h"
 #include "core/geometry/Intersect.h"
+#include "core/geometry/IntersectBatch.h"
 #include "core/geometry/Sphere.h"
 #include "core/platform/Debug.h"
 #include "core/scene-graph/Node.h"
@@ -69,102 +71,146 @@ void validPunctualLightsCulling(const RenderPipeline *pipeline, const scene::Cam
     PipelineSceneData *sceneData = pipeline->getPipelineSceneData();
     sceneData->clearValidPunctualLights();
 
-    geometry::Sphere sphere;
-    for (const auto &light : scene->getSpotLights()) {
-        if (light->isBaked()) {
-            continue;
+    // spot, sphere and point lights are tested against the frustum in one batch, in that order
+    auto &buffers = sceneData->getCullingBuffers();
+    auto &lights = buffers.lights;
+    auto &spheres = buffers.spheres;
+    lights.clear();
+    spheres.clear();
+    auto collect = [&](const auto &sceneLights) {
+        for (const auto &light : sceneLights) {
+            if (light->isBaked()) {
+                continue;
+            }
+            lights.push_back(static_cast<scene::Light *>(light.get()));
+            spheres.push(light->getPosition(), light->getRange());
         }
-
-        sphere.setCenter(light->getPosition());
-        sphere.setRadius(light->getRange());
-
-        if (sphere.sphereFrustum(camera->getFrustum())) {
-            sceneData->addValidPunctualLight(static_cast<scene::Light *>(light));
+    };
+    collect(scene->getSpotLights());
+    collect(scene->getSphereLights());
+    collect(scene->getPointLights());
+
+    auto &visible = buffers.mask;
+    geometry::sphereFrustumBatch(spheres, camera->getFrustum(), visible);
+    for (uint32_t i = 0; i < lights.size(); ++i) {
+        if (geometry::testBatchMask(visible, i)) {
+            sceneData->addValidPunctualLight(lights[i]);
         }
     }
 
-    for (const auto &light : scene->getSphereLights()) {
+    for (const auto &light : scene->getRangedDirLights()) {
         if (light->isBaked()) {
             continue;
         }
 
-        sphere.setCenter(light->getPosition());
-        sphere.setRadius(light->getRange());
-        if (sphere.sphereFrustum(camera->getFrustum())) {
+        geometry::AABB rangedDirLightBoundingBox(0.0F, 0.0F, 0.0F, 0.5F, 0.5F, 0.5F);
+        light->getNode()->updateWorldTransform();
+        rangedDirLightBoundingBox.transform(light->getNode()->getWorldMatrix(), &rangedDirLightBoundingBox);
+        if (rangedDirLightBoundingBox.aabbFrustum(camera->getFrustum())) {
             sceneData->addValidPunctualLight(static_cast<scene::Light *>(light));
         }
     }
+}
 
-    for (const auto &light : scene->getPointLights()) {
-        if (light->isBaked()) {
-            continue;
-        }
+// Todo If you want to optimize the cutting efficiency, you can get it from the octree
+namespace {
+constexpr uint32_t MAX_CSM_LEVEL = UBOCSM::CSM_LEVEL_COUNT;
 
-        sphere.setCenter(light->getPosition());
-        sphere.setRadius(light->getRange());
-        if (sphere.sphereFrustum(camera->getFrustum())) {
-            sceneData->addValidPunctualLight(static_cast<scene::Light *>(light));
-        }
+bool isShadowCasterValid(const scene::Model *model, uint32_t visibility) {
+    if (!model || !model->isEnabled() || !model->getNode()) {
+        return false;
+    }
+    const auto *node = model->getNode();
+    if (((visibility & node->getLayer()) != node->getLayer()) && !(visibility & static_cast<uint32_t>(model->getVisFlags()))) {
+        return false;
     }
+    return model->getWorldBounds() && model->isCastShadow();
+}
+} // namespace
 
-    for (const auto &light : scene->getRangedDirLights()) {
-        if (light->isBaked()) {
-            continue;
+void cullCSMLayerObjects(CSMLayers *csmLayers, const scene::Camera *camera, const scene::DirectionalLight *mainLight) {
+    const auto &objects = csmLayers->getLayerObjects();
+    auto &masks = csmLayers->getLayerObjectMasks();
+    masks.assign(objects.size(), 0);
+
+    const uint32_t levelCount = std::min(static_cast<uint32_t>(mainLight->getCSMLevel()), MAX_CSM_LEVEL);
+    const bool removeDuplicates = mainLight->getCSMOptimizationMode() == scene::CSMOptimizationMode::REMOVE_DUPLICATES;
+    const uint32_t visibility = camera->getVisibility();
+
+    // the world bounds of the valid casters, tested against each cascade in one batch
+    auto &buffers = csmLayers->getCullingBuffers();
+    auto &casters = buffers.casters;
+    auto &bounds = buffers.bounds;
+    casters.clear();
+    bounds.clear();
+    casters.reserve(objects.size());
+    bounds.reserve(static_cast<uint32_t>(objects.size()));
+    for (uint32_t i = 0; i < objects.size(); ++i) {
+        const auto *model = objects[i].model;
+        if (isShadowCasterValid(model, visibility)) {
+            casters.push_back(i);
+            bounds.push(*model->getWorldBounds());
         }
+    }
 
-        geometry::AABB rangedDirLightBoundingBox(0.0F, 0.0F, 0.0F, 0.5F, 0.5F, 0.5F);
-        light->getNode()->updateWorldTransform();
-        rangedDirLightBoundingBox.transform(light->getNode()->getWorldMatrix(), &rangedDirLightBoundingBox);
-        if (rangedDirLightBoundingBox.aabbFrustum(camera->getFrustum())) {
-            sceneData->addValidPunctualLight(static_cast<scene::Light *>(light));
+    auto &intersects = buffers.intersects;
+    auto &inside = buffers.inside;
+    const auto &layers = csmLayers->getLayers();
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        geometry::aabbFrustumBatch(bounds, layers[level]->getValidFrustum(), intersects[level], &inside[level]);
+    }
+
+    for (uint32_t i = 0; i < casters.size(); ++i) {
+        uint32_t intersectMask = 0;
+        uint32_t insideMask = 0;
+        for (uint32_t level = 0; level < levelCount; ++level) {
+            intersectMask |= static_cast<uint32_t>(geometry::testBatchMask(intersects[level], i)) << level;
+            insideMask |= static_cast<uint32_t>(geometry::testBatchMask(inside[level], i)) << level;
         }
+        if (removeDuplicates) {
+            insideMask &= intersectMask;
+            if (insideMask) {
+                // keep the cascades up to the first one containing the whole object
+                const uint32_t firstInside = insideMask & (~insideMask + 1);
+                intersectMask &= (firstInside << 1) - 1;
+            }
+        }
+        masks[casters[i]] = static_cast<uint8_t>(intersectMask);
     }
 }
 
-// Todo If you want to optimize the cutting efficiency, you can get it from the octree
 void shadowCulling(const RenderPipeline *pipeline, const scene::Camera *camera, ShadowTransformInfo *layer) {
     const auto *sceneData = pipeline->getPipelineSceneData();
     auto *csmLayers = sceneData->getCSMLayers();
     const auto *const scene = camera->getScene();
     const auto *mainLight = scene->getMainLight();
-    const uint32_t visibility = camera->getVisibility();
 
     layer->clearShadowObjects();
 
-    if (csmLayers->getLayerObjects().empty()) return;
-
-    for (auto it = csmLayers->getLayerObjects().begin(); it != csmLayers->getLayerObjects().end();) {
-        const auto *model = it->model;
-        if (!model || !model->isEnabled() || !model->getNode()) {
-            it = csmLayers->getLayerObjects().erase(it);
-            continue;
-        }
-        const auto *node = model->getNode();
-        if (((visibility & node->getLayer()) != node->getLayer()) && !(visibility & static_cast<uint32_t>(model->getVisFlags()))) {
-            it = csmLayers->getLayerObjects().erase(it);
-            continue;
-        }
-        if (!model->getWorldBounds() || !model->isCastShadow()) {
-            it = csmLayers->getLayerObjects().erase(it);
-            continue;
+    const auto &objects = csmLayers->getLayerObjects();
+    if (objects.empty()) return;
+
+    const uint32_t level = layer->getLevel();
+    if (level >= MAX_CSM_LEVEL || csmLayers->getLayers()[level] != layer) {
+        // the fixed area layer is culled on its own
+        const uint32_t visibility = camera->getVisibility();
+        for (const auto &object : objects) {
+            const auto *model = object.model;
+            if (isShadowCasterValid(model, visibility) && model->getWorldBounds()->aabbFrustum(layer->getValidFrustum())) {
+                layer->addShadowObject(genRenderObject(model, camera));
+            }
         }
+        return;
+    }
 
-        // frustum culling
-        const bool accurate = model->getWorldBounds()->aabbFrustum(layer->getValidFrustum());
-        if (!accurate) {
-            ++it;
-            continue;
-        }
-        layer->addShadowObject(genRenderObject(model, camera));
-        if (layer->getLevel() < static_cast<uint32_t>(mainLight->getCSMLevel())) {
-            if (mainLight->getCSMOptimizationMode() == scene::CSMOptimizationMode::REMOVE_DUPLICATES &&
-                aabbFrustumCompletelyInside(*model->getWorldBounds(), layer->getValidFrustum())) {
-                it = csmLayers->getLayerObjects().erase(it);
-            } else {
-                ++it;
-            }
-        } else {
-            ++it;
+    auto &masks = csmLayers->getLayerObjectMasks();
+    if (masks.size() != objects.size()) {
+        cullCSMLayerObjects(csmLayers, camera, mainLight);
+    }
+    const uint8_t bit = 1U << level;
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (masks[i] & bit) {
+            layer->addShadowObject(genRenderObject(objects[i].model, camera));
         }
     }
 }
@@ -236,13 +282,19 @@ void sceneCulling(const RenderPipeline *pipeline, scene::Camera *camera) {
             sceneData->addRenderObject(genRenderObject(model, camera));
         }
     } else {
+        // visible models are collected first, the ones with bounds are frustum culled in one batch
+        const auto visibility = camera->getVisibility();
+        auto &buffers = sceneData->getCullingBuffers();
+        auto &visibleModels = buffers.models;
+        auto &bounds = buffers.bounds;
+        visibleModels.clear();
+        bounds.clear();
         for (const auto &model : scene->getModels()) {
             // filter model by view visibility
             if (model->isEnabled()) {
                 if (scene->isCulledByLod(camera, model)) {
                     continue;
                 }
-                const auto visibility = camera->getVisibility();
                 const auto *const node = model->getNode();
 
                 // cast shadow render Object
@@ -253,19 +305,23 @@ void sceneCulling(const RenderPipeline *pipeline, scene::Camera *camera) {
 
                 if ((model->getNode() && ((visibility & node->getLayer()) == node->getLayer())) ||
                     (visibility & static_cast<uint32_t>(model->getVisFlags()))) {
-                    const auto *modelWorldBounds = model->getWorldBounds();
-                    if (!modelWorldBounds) {
-                        sceneData->addRenderObject(genRenderObject(model, camera));
-                        continue;
-                    }
-
-                    // frustum culling
-                    if (modelWorldBounds->aabbFrustum(camera->getFrustum())) {
-                        sceneData->addRenderObject(genRenderObject(model, camera));
+                    visibleModels.push_back(model);
+                    if (const auto *modelWorldBounds = model->getWorldBounds()) {
+                        bounds.push(*modelWorldBounds);
                     }
                 }
             }
         }
+
+        // frustum culling
+        auto &inFrustum = buffers.mask;
+        geometry::aabbFrustumBatch(bounds, camera->getFrustum(), inFrustum);
+        uint32_t boundsIndex = 0;
+        for (const auto *model : visibleModels) {
+            if (!model->getWorldBounds() || geometry::testBatchMask(inFrustum, boundsIndex++)) {
+                sceneData->addRenderObject(genRenderObject(model, camera));
+            }
+        }
     }
 
     csmLayers = nullptr;
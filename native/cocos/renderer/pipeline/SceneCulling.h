@@ -35,18 +35,23 @@ class Vec4;
 class Vec3;
 namespace scene {
 class Camera;
+class DirectionalLight;
 class Shadows;
 class Light;
 } // namespace scene
 namespace pipeline {
 
 struct RenderObject;
+class CSMLayers;
 class RenderPipeline;
 class ShadowTransformInfo;
 
 RenderObject genRenderObject(const scene::Model *, const scene::Camera *);
 void validPunctualLightsCulling(const RenderPipeline *pipeline, const scene::Camera *camera);
 void shadowCulling(const RenderPipeline *, const scene::Camera *, ShadowTransformInfo *);
+// Classifies every layer object against all cascades in one pass into CSMLayers::getLayerObjectMasks().
+// With REMOVE_DUPLICATES an object completely inside a cascade is masked out of the cascades after it.
+void cullCSMLayerObjects(CSMLayers *csmLayers, const scene::Camera *camera, const scene::DirectionalLight *mainLight);
 void sceneCulling(const RenderPipeline *, scene::Camera *);
 } // namespace pipeline
 } // namespace cc
@@ -23,16 +23,130 @@
 ****************************************************************************/
 
 #include <algorithm>
+#include <array>
+#include <cstring>
 #include <iterator>
 #include "NativePipelineTypes.h"
+#include "NativeRenderQueue.h"
+#include "cocos/base/std/container/vector.h"
 #include "cocos/renderer/pipeline/Define.h"
 #include "cocos/renderer/pipeline/PipelineStateManager.h"
+#include "cocos/scene/Model.h"
+#include "cocos/scene/SubModel.h"
 #include "details/GslUtils.h"
 
 namespace cc {
 
 namespace render {
 
+namespace {
+
+constexpr size_t RADIX_SORT_MIN_COUNT = 64;
+constexpr uint32_t RADIX_BITS = 8;
+constexpr uint32_t RADIX_SIZE = 1U << RADIX_BITS;
+constexpr uint32_t RADIX_PASS_COUNT = 64 / RADIX_BITS;
+
+// Maps a float onto an unsigned integer of the same order.
+uint32_t getSortableDepth(float depth) {
+    uint32_t bits = 0;
+    std::memcpy(&bits, &depth, sizeof(bits));
+    return (bits & 0x80000000U) ? ~bits : (bits | 0x80000000U);
+}
+
+uint32_t getShaderID(const gfx::Shader* shader) {
+    const auto address = reinterpret_cast<uintptr_t>(shader);
+    return static_cast<uint32_t>((address >> 4) ^ (address >> 20));
+}
+
+struct SortEntry {
+    uint64_t key{0};
+    uint32_t index{0};
+};
+
+// LSD radix sort over the keys, stable.
+void radixSort(ccstd::vector<SortEntry>& entries, ccstd::vector<SortEntry>& scratch) {
+    const auto count = entries.size();
+    // build the histograms of all digits in one pass
+    std::array<std::array<uint32_t, RADIX_SIZE>, RADIX_PASS_COUNT> histograms{};
+    for (const auto& entry : entries) {
+        auto key = entry.key;
+        for (auto& histogram : histograms) {
+            ++histogram[key & (RADIX_SIZE - 1)];
+            key >>= RADIX_BITS;
+        }
+    }
+
+    scratch.resize(count);
+    auto* src = entries.data();
+    auto* dst = scratch.data();
+    for (uint32_t pass = 0; pass != RADIX_PASS_COUNT; ++pass) {
+        const uint32_t shift = pass * RADIX_BITS;
+        auto& offsets = histograms[pass];
+        // skip digits shared by every key, usually the priorities
+        if (offsets[(src->key >> shift) & (RADIX_SIZE - 1)] == count) {
+            continue;
+        }
+        uint32_t offset = 0;
+        for (auto& bucket : offsets) {
+            const auto size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+        for (size_t i = 0; i != count; ++i) {
+            const auto& entry = src[i];
+            dst[offsets[(entry.key >> shift) & (RADIX_SIZE - 1)]++] = entry;
+        }
+        std::swap(src, dst);
+    }
+    if (src != entries.data()) {
+        entries.swap(scratch);
+    }
+}
+
+// Sorts the instances by the keys of a side array, so DrawInstance keeps its generated layout.
+// Queues are sorted by culling jobs, the side arrays are kept per thread and reused across frames.
+template <class MakeKey>
+void sortInstances(ccstd::pmr::vector<DrawInstance>& instances, MakeKey makeKey) {
+    thread_local ccstd::vector<SortEntry> entries;
+    thread_local ccstd::vector<SortEntry> scratch;
+    thread_local ccstd::vector<DrawInstance> sorted;
+
+    const auto count = instances.size();
+    entries.resize(count);
+    for (size_t i = 0; i != count; ++i) {
+        entries[i] = SortEntry{makeKey(instances[i]), static_cast<uint32_t>(i)};
+    }
+    if (count < RADIX_SORT_MIN_COUNT) {
+        std::stable_sort(entries.begin(), entries.end(), [](const SortEntry& lhs, const SortEntry& rhs) {
+            return lhs.key < rhs.key;
+        });
+    } else {
+        radixSort(entries, scratch);
+    }
+
+    sorted.clear();
+    for (const auto& entry : entries) {
+        sorted.emplace_back(instances[entry.index]);
+    }
+    std::copy(sorted.begin(), sorted.end(), instances.begin());
+}
+
+} // namespace
+
+// Opaque key: [63:40] pass hash, [39:16] depth, [15:0] shader.
+uint64_t makeOpaqueOrCutoutSortKey(uint32_t hash, float depth, uint32_t shaderID) {
+    return (static_cast<uint64_t>(hash & 0xFFFFFFU) << 40) |
+           (static_cast<uint64_t>(getSortableDepth(depth) >> 8) << 16) |
+           static_cast<uint64_t>(shaderID & 0xFFFFU);
+}
+
+// Transparent key: [63:48] model priority, [47:24] pass hash, [23:0] depth, back to front.
+uint64_t makeTransparentSortKey(uint32_t priority, uint32_t hash, float depth) {
+    return (static_cast<uint64_t>(std::min(priority, 0xFFFFU)) << 48) |
+           (static_cast<uint64_t>(hash & 0xFFFFFFU) << 24) |
+           static_cast<uint64_t>(~getSortableDepth(depth) >> 8);
+}
+
 // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
 void RenderDrawQueue::add(const scene::Model &model, float depth, uint32_t subModelIdx, uint32_t passIdx) {
     const auto *subModel = model.getSubModels()[subModelIdx].get();
@@ -40,7 +154,7 @@ void RenderDrawQueue::add(const scene::Model &model, float depth, uint32_t subMo
 
     auto passPriority = static_cast<uint32_t>(pass->getPriority());
     auto modelPriority = static_cast<uint32_t>(subModel->getPriority());
-    auto shaderId = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(subModel->getShader(passIdx)));
+    auto shaderId = getShaderID(subModel->getShader(passIdx));
     const auto hash = (0 << 30) | (passPriority << 16) | (modelPriority << 8) | passIdx;
     const auto priority = model.getPriority();
 
@@ -48,16 +162,14 @@ void RenderDrawQueue::add(const scene::Model &model, float depth, uint32_t subMo
 }
 
 void RenderDrawQueue::sortOpaqueOrCutout() {
-    std::sort(instances.begin(), instances.end(), [](const DrawInstance &lhs, const DrawInstance &rhs) {
-        return std::forward_as_tuple(lhs.hash, lhs.depth, lhs.shaderID) <
-               std::forward_as_tuple(rhs.hash, rhs.depth, rhs.shaderID);
+    sortInstances(instances, [](const DrawInstance& instance) {
+        return makeOpaqueOrCutoutSortKey(instance.hash, instance.depth, instance.shaderID);
     });
 }
 
 void RenderDrawQueue::sortTransparent() {
-    std::sort(instances.begin(), instances.end(), [](const DrawInstance &lhs, const DrawInstance &rhs) {
-        return std::forward_as_tuple(lhs.priority, lhs.hash, -lhs.depth, lhs.shaderID) <
-               std::forward_as_tuple(rhs.priority, rhs.hash, -rhs.depth, rhs.shaderID);
+    sortInstances(instances, [](const DrawInstance& instance) {
+        return makeTransparentSortKey(instance.priority, instance.hash, instance.depth);
     });
 }
 
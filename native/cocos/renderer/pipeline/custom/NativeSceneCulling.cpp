@@ -0,0 +1,395 @@
+/****************************************************************************
+ Copyright (c) 2022-2023 Xiamen Yaji Software Co., Ltd.
+
+ https://www.cocos.com/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "NativeSceneCulling.h"
+#include "cocos/base/job-system/JobSystem.h"
+#include "cocos/base/std/container/deque.h"
+#include "cocos/base/std/container/unordered_map.h"
+#include "cocos/base/std/container/vector.h"
+#include "cocos/core/geometry/IntersectBatch.h"
+#include "cocos/renderer/pipeline/InstancedBuffer.h"
+#include "cocos/scene/Model.h"
+#include "cocos/scene/Octree.h"
+#include "cocos/scene/Pass.h"
+#include "cocos/scene/RenderScene.h"
+#include "cocos/scene/Skybox.h"
+#include "details/GslUtils.h"
+
+namespace cc {
+
+namespace render {
+
+namespace {
+
+// Pass::getInstancedBuffer creates buffers on first use and InstancedBuffer is shared by all cameras,
+// so instanced passes are only recorded in the jobs, then resolved and merged once every job is done.
+struct InstancedMerge {
+    scene::Pass* pass{nullptr};
+    scene::SubModel* subModel{nullptr};
+    uint32_t passIndex{0};
+    bool transparent{false};
+};
+
+// Node::getWorldPosition updates dirty transforms, so the jobs never call it.
+// Models with bounds are sorted by the centre of their world bounds, which Model::updateTransform
+// keeps current, the positions of the others are resolved on the main thread before dispatch.
+using PointModelPositions = ccstd::unordered_map<const scene::Model*, Vec3>;
+
+struct CameraCullingJob {
+    CameraCullingJob(const scene::RenderScene* sceneIn, scene::Camera* cameraIn, NativeRenderQueue& targetIn,
+                     const PointModelPositions& pointPositionsIn)
+    : scene(sceneIn),
+      camera(cameraIn),
+      target(targetIn),
+      pointPositions(pointPositionsIn),
+      queue(targetIn.sceneFlags, targetIn.layoutPassID, &resource),
+      instancedMerges(&resource) {}
+    CameraCullingJob(CameraCullingJob&&) = delete;
+    CameraCullingJob(CameraCullingJob const&) = delete;
+    CameraCullingJob& operator=(CameraCullingJob&&) = delete;
+    CameraCullingJob& operator=(CameraCullingJob const&) = delete;
+
+    const scene::RenderScene* scene{nullptr};
+    scene::Camera* camera{nullptr};
+    NativeRenderQueue& target;
+    const PointModelPositions& pointPositions;
+    boost::container::pmr::unsynchronized_pool_resource resource;
+    NativeRenderQueue queue;
+    ccstd::pmr::vector<InstancedMerge> instancedMerges;
+    ccstd::vector<scene::Model*> octreeModels;
+    ccstd::vector<const scene::Model*> visibleModels;
+    geometry::AABBBatch visibleBounds;
+    geometry::BatchMask inFrustum;
+    bool useOctree{false};
+};
+
+bool isNodeVisible(const scene::Model& model, const uint32_t visibility) {
+    const auto* const node = model.getNode();
+    CC_EXPECTS(node);
+    return model.getNode() && ((visibility & node->getLayer()) == node->getLayer());
+}
+
+bool isInstanceVisible(const scene::Model& model, const uint32_t visibility) {
+    return isNodeVisible(model, visibility) ||
+           (visibility & static_cast<uint32_t>(model.getVisFlags()));
+}
+
+bool isPointInstanceAndNotSkybox(const scene::Model& model, const scene::Skybox* skyBox) {
+    const auto* modelWorldBounds = model.getWorldBounds();
+    return !modelWorldBounds && (skyBox == nullptr || skyBox->getModel() != &model);
+}
+
+bool isPointInstance(const scene::Model& model) {
+    return !model.getWorldBounds();
+}
+
+void addShadowCastObject() {
+    // csmLayers->addCastShadowObject(genRenderObject(model, camera));
+    // csmLayers->addLayerObject(genRenderObject(model, camera));
+}
+
+bool isTransparent(const scene::Pass& pass) {
+    bool bBlend = false;
+    for (const auto& target : pass.getBlendState()->targets) {
+        if (target.blend) {
+            bBlend = true;
+        }
+    }
+    return bBlend;
+}
+
+float computeSortingDepth(const scene::Camera& camera, const scene::Model& model, const PointModelPositions& pointPositions) {
+    float depth = 0;
+    if (model.getNode()) {
+        const Vec3* worldPosition = nullptr;
+        if (const auto* worldBounds = model.getWorldBounds()) {
+            worldPosition = &worldBounds->getCenter();
+        } else {
+            auto iter = pointPositions.find(&model);
+            CC_EXPECTS(iter != pointPositions.end());
+            worldPosition = &iter->second;
+        }
+        Vec3 position;
+        Vec3::subtract(*worldPosition, camera.getPosition(), &position);
+        depth = position.dot(camera.getForward());
+    }
+    return depth;
+}
+
+void resolvePointModelPositions(const scene::RenderScene& scene, PointModelPositions& pointPositions) {
+    for (const auto& pModel : scene.getModels()) {
+        if (pModel->getNode() && !pModel->getWorldBounds()) {
+            pointPositions.emplace(pModel.get(), pModel->getTransform()->getWorldPosition());
+        }
+    }
+}
+
+void addRenderObject(
+    LayoutGraphData::vertex_descriptor shadowCasterlayoutID,
+    const scene::Camera& camera, const scene::Model& model, CameraCullingJob& job) {
+    auto& queue = job.queue;
+    const bool bDrawTransparent = any(queue.sceneFlags & SceneFlags::TRANSPARENT_OBJECT);
+    bool bDrawOpaqueOrCutout = any(queue.sceneFlags & (SceneFlags::OPAQUE_OBJECT | SceneFlags::CUTOUT_OBJECT));
+    if (!bDrawTransparent && !bDrawOpaqueOrCutout) {
+        bDrawOpaqueOrCutout = true;
+    }
+    const bool bDrawShadowCaster = any(queue.sceneFlags & SceneFlags::SHADOW_CASTER);
+
+    const auto& subModels = model.getSubModels();
+    const auto subModelCount = subModels.size();
+    for (uint32_t subModelIdx = 0; subModelIdx < subModelCount; ++subModelIdx) {
+        const auto& subModel = subModels[subModelIdx];
+        const auto& passes = subModel->getPasses();
+        const auto passCount = passes.size();
+        for (uint32_t passIdx = 0; passIdx < passCount; ++passIdx) {
+            auto& pass = *passes[passIdx];
+            const bool bTransparent = isTransparent(pass);
+            const bool bOpaqueOrCutout = !bTransparent;
+            const bool bShadowCaster = pass.getPhaseID() == shadowCasterlayoutID;
+
+            if (!bDrawTransparent && bTransparent) {
+                // skip transparent object
+                continue;
+            }
+
+            if (!bDrawOpaqueOrCutout && bOpaqueOrCutout) {
+                // skip opaque object
+                continue;
+            }
+
+            // skip irrelavent passes
+            if (queue.layoutPassID != pass.getPassID()) {
+                continue;
+            }
+
+            // skip shadow caster
+            if (!bDrawShadowCaster && bShadowCaster) {
+                continue;
+            }
+
+            // add object to queue
+            if (pass.getBatchingScheme() == scene::BatchingSchemes::INSTANCING) {
+                job.instancedMerges.emplace_back(InstancedMerge{&pass, subModel.get(), passIdx, bTransparent});
+            } else {
+                const float depth = computeSortingDepth(camera, model, job.pointPositions);
+                if (bTransparent) {
+                    queue.transparentQueue.add(model, depth, subModelIdx, passIdx);
+                } else {
+                    queue.opaqueQueue.add(model, depth, subModelIdx, passIdx);
+                }
+            }
+        }
+    }
+}
+
+void octreeCulling(
+    LayoutGraphData::vertex_descriptor shadowCasterlayoutID,
+    const scene::Skybox* skyBox,
+    CameraCullingJob& job) {
+    const auto* scene = job.scene;
+    const auto& camera = *job.camera;
+    // add special instances
+    for (const auto& pModel : scene->getModels()) {
+        CC_EXPECTS(pModel);
+        const auto& model = *pModel;
+        // filter model by view visibility
+        if (!model.isEnabled()) {
+            continue;
+        }
+        if (scene->isCulledByLod(&camera, &model)) {
+            continue;
+        }
+        if (any(job.queue.sceneFlags & SceneFlags::SHADOW_CASTER) && model.isCastShadow()) {
+            addShadowCastObject();
+        }
+        const auto visibility = camera.getVisibility();
+        if (isInstanceVisible(model, visibility) && isPointInstanceAndNotSkybox(model, skyBox)) {
+            addRenderObject(shadowCasterlayoutID, camera, model, job);
+        }
+    }
+
+    // add plain instances, queried before the job started
+    for (const auto& pModel : job.octreeModels) {
+        const auto& model = *pModel;
+        CC_EXPECTS(!isPointInstance(model));
+        if (scene->isCulledByLod(&camera, &model)) {
+            continue;
+        }
+        addRenderObject(shadowCasterlayoutID, camera, model, job);
+    }
+}
+
+void frustumCulling(
+    LayoutGraphData::vertex_descriptor shadowCasterlayoutID,
+    CameraCullingJob& job) {
+    const auto* scene = job.scene;
+    const auto& camera = *job.camera;
+    const auto& models = scene->getModels();
+    const auto visibility = camera.getVisibility();
+    // visible models are collected first, the ones with bounds are frustum culled in one batch
+    auto& visibleModels = job.visibleModels;
+    auto& bounds = job.visibleBounds;
+    visibleModels.clear();
+    bounds.clear();
+    for (const auto& pModel : models) {
+        CC_EXPECTS(pModel);
+        const auto& model = *pModel;
+        if (!model.isEnabled()) {
+            continue;
+        }
+        // filter model by view visibility
+        if (scene->isCulledByLod(&camera, &model)) {
+            continue;
+        }
+
+        // cast shadow render Object
+        if (any(job.queue.sceneFlags & SceneFlags::SHADOW_CASTER) && model.isCastShadow()) {
+            addShadowCastObject();
+        }
+
+        // add render objects
+        if (isInstanceVisible(model, visibility)) {
+            visibleModels.emplace_back(&model);
+            if (const auto* modelWorldBounds = model.getWorldBounds()) {
+                bounds.push(*modelWorldBounds);
+            }
+        }
+    }
+
+    // frustum culling, objects without volume are always added
+    geometry::aabbFrustumBatch(bounds, camera.getFrustum(), job.inFrustum);
+    uint32_t boundsIndex = 0;
+    for (const auto* model : visibleModels) {
+        if (!model->getWorldBounds() || geometry::testBatchMask(job.inFrustum, boundsIndex++)) {
+            addRenderObject(shadowCasterlayoutID, camera, *model, job);
+        }
+    }
+}
+
+void cullAndSort(
+    LayoutGraphData::vertex_descriptor shadowCasterlayoutID,
+    const scene::Skybox* skybox,
+    const Vec3* skyboxPosition,
+    CameraCullingJob& job) {
+    const auto& camera = *job.camera;
+
+    // skybox
+    if (skybox && skybox->isEnabled() &&
+        (static_cast<int32_t>(camera.getClearFlag()) & scene::Camera::SKYBOX_FLAG)) {
+        CC_EXPECTS(skybox->getModel());
+        const auto& model = *skybox->getModel();
+        float depth = 0;
+        if (skyboxPosition) {
+            Vec3 tempVec3{};
+            tempVec3 = *skyboxPosition - camera.getPosition();
+            depth = tempVec3.dot(camera.getForward());
+        }
+        job.queue.opaqueQueue.add(model, depth, 0, 0);
+    }
+
+    // culling
+    if (job.useOctree) {
+        octreeCulling(shadowCasterlayoutID, skybox, job);
+    } else {
+        frustumCulling(shadowCasterlayoutID, job);
+    }
+
+    // instancing queues are filled and sorted by the merge
+    job.queue.opaqueQueue.sortOpaqueOrCutout();
+    job.queue.transparentQueue.sortTransparent();
+}
+
+} // namespace
+
+void buildCameraRenderQueues(
+    LayoutGraphData::vertex_descriptor shadowCasterLayoutID,
+    const scene::Skybox* skybox,
+    SceneRenderQueues& sceneQueues,
+    bool parallel) {
+    // world positions read by the jobs, resolved here since resolving may update the transforms
+    Vec3 skyboxPosition;
+    const Vec3* pSkyboxPosition = nullptr;
+    if (skybox && skybox->getModel() && skybox->getModel()->getNode()) {
+        skyboxPosition = skybox->getModel()->getNode()->getWorldPosition();
+        pSkyboxPosition = &skyboxPosition;
+    }
+    ccstd::deque<PointModelPositions> pointPositions;
+
+    ccstd::deque<CameraCullingJob> jobs;
+    for (auto&& [scene, queues] : sceneQueues) {
+        auto& scenePointPositions = pointPositions.emplace_back();
+        resolvePointModelPositions(*scene, scenePointPositions);
+        const scene::Octree* octree = scene->getOctree();
+        for (auto&& [camera, queue] : queues) {
+            CC_EXPECTS(camera);
+            if (!camera->isCullingEnabled()) {
+                continue;
+            }
+            auto& job = jobs.emplace_back(scene, camera, queue, scenePointPositions);
+            // Octree queries are parallel on their own, they must not be nested in a job.
+            if (octree && octree->isEnabled()) {
+                job.useOctree = true;
+                job.octreeModels.reserve(scene->getModels().size() / 4);
+                octree->queryVisibility(camera, camera->getFrustum(), false, job.octreeModels);
+            }
+        }
+    }
+
+    const auto jobCount = static_cast<uint32_t>(jobs.size());
+    auto* jobSystem = JobSystem::getInstance();
+    if (parallel && jobCount > 1 && jobSystem->threadCount() > 1) {
+        JobGraph g(jobSystem);
+        g.createForEachIndexJob(0U, jobCount, 1U, [&](uint32_t i) {
+            cullAndSort(shadowCasterLayoutID, skybox, pSkyboxPosition, jobs[i]);
+        });
+        g.run();
+        g.waitForAll();
+    } else {
+        for (auto& job : jobs) {
+            cullAndSort(shadowCasterLayoutID, skybox, pSkyboxPosition, job);
+        }
+    }
+
+    // merge in camera order, same as culling the cameras one by one
+    for (auto& job : jobs) {
+        auto& queue = job.queue;
+        for (const auto& merge : job.instancedMerges) {
+            auto& instancedBuffer = *merge.pass->getInstancedBuffer();
+            instancedBuffer.merge(merge.subModel, merge.passIndex);
+            if (merge.transparent) {
+                queue.transparentInstancingQueue.add(instancedBuffer);
+            } else {
+                queue.opaqueInstancingQueue.add(instancedBuffer);
+            }
+        }
+        queue.opaqueInstancingQueue.sort();
+        queue.transparentInstancingQueue.sort();
+        job.target = std::move(queue);
+    }
+}
+
+} // namespace render
+
+} // namespace cc
@@ -0,0 +1,57 @@
+/****************************************************************************
+ Copyright (c) 2022-2023 Xiamen Yaji Software Co., Ltd.
+
+ https://www.cocos.com/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+#include "cocos/base/std/container/unordered_map.h"
+#include "cocos/renderer/pipeline/custom/LayoutGraphTypes.h"
+#include "cocos/renderer/pipeline/custom/NativePipelineTypes.h"
+
+namespace cc {
+
+namespace scene {
+class Camera;
+class RenderScene;
+class Skybox;
+} // namespace scene
+
+namespace render {
+
+using SceneRenderQueues = ccstd::pmr::unordered_map<
+    const scene::RenderScene*,
+    ccstd::pmr::unordered_map<scene::Camera*, NativeRenderQueue>>;
+
+// Culls and sorts the render queue of every culling camera.
+// Each camera is processed as an independent job that allocates from its own memory resource.
+// Results are merged back in the iteration order of sceneQueues, so the queues and
+// instanced buffers are identical to a serial run.
+void buildCameraRenderQueues(
+    LayoutGraphData::vertex_descriptor shadowCasterLayoutID,
+    const scene::Skybox* skybox,
+    SceneRenderQueues& sceneQueues,
+    bool parallel = true);
+
+} // namespace render
+
+} // namespace cc
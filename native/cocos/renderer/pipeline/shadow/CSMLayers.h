@@ -24,6 +24,7 @@
 
 #include "base/TypeDef.h"
 #include "core/geometry/Frustum.h"
+#include "core/geometry/IntersectBatch.h"
 #include "math/Mat4.h"
 #include "pipeline/Define.h"
 #include "scene/Camera.h"
@@ -132,9 +133,28 @@ public:
     inline void clearCastShadowObjects() { _castShadowObjects.clear(); }
 
     inline RenderObjectList &getLayerObjects() { return _layerObjects; }
-    inline void setLayerObjects(RenderObjectList &&ro) { _layerObjects = std::forward<RenderObjectList>(ro); }
+    inline void setLayerObjects(RenderObjectList &&ro) {
+        _layerObjects = std::forward<RenderObjectList>(ro);
+        _layerObjectMasks.clear();
+    }
     inline void addLayerObject(RenderObject &&obj) { _layerObjects.emplace_back(obj); }
-    inline void clearLayerObjects() { _layerObjects.clear(); }
+    inline void clearLayerObjects() {
+        _layerObjects.clear();
+        _layerObjectMasks.clear();
+    }
+
+    // One byte per layer object, bit i is set if the object casts shadow in _layers[i].
+    // Filled for all layers at once by the first shadowCulling of the frame.
+    inline ccstd::vector<uint8_t> &getLayerObjectMasks() { return _layerObjectMasks; }
+
+    // Scratch storage of cullCSMLayerObjects, kept across frames so culling does not allocate.
+    struct CullingBuffers {
+        ccstd::vector<uint32_t> casters;
+        geometry::AABBBatch bounds;
+        ccstd::array<geometry::BatchMask, UBOCSM::CSM_LEVEL_COUNT> intersects;
+        ccstd::array<geometry::BatchMask, UBOCSM::CSM_LEVEL_COUNT> inside;
+    };
+    inline CullingBuffers &getCullingBuffers() { return _cullingBuffers; }
 
     inline const ccstd::array<CSMLayerInfo *, 4> &getLayers() const { return _layers; }
 
@@ -159,6 +179,8 @@ private:
 
     RenderObjectList _castShadowObjects;
     RenderObjectList _layerObjects;
+    ccstd::vector<uint8_t> _layerObjectMasks;
+    CullingBuffers _cullingBuffers;
 };
 } // namespace pipeline
 } // namespace cc
@@ -0,0 +1,554 @@
+/****************************************************************************
+ Copyright (c) 2020-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "scene/AABBTree.h"
+#include <algorithm>
+#include <cmath>
+#include "core/geometry/Frustum.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <xmmintrin.h>
+    #define CC_AABB_TREE_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define CC_AABB_TREE_NEON
+#endif
+
+namespace cc {
+namespace scene {
+
+namespace {
+
+constexpr float FAT_BOX_RATIO = 0.1F;
+constexpr float FAT_BOX_MIN_MARGIN = 0.1F;
+constexpr float DISPLACEMENT_MULTIPLIER = 4.0F;
+constexpr uint32_t FRUSTUM_PLANE_COUNT = 6;
+constexpr uint32_t NODE_BATCH_SIZE = 4;
+
+inline Vec3 getFatMargin(const BBox &box) {
+    const Vec3 margin = (box.max - box.min) * FAT_BOX_RATIO;
+    return {std::max(margin.x, FAT_BOX_MIN_MARGIN), std::max(margin.y, FAT_BOX_MIN_MARGIN), std::max(margin.z, FAT_BOX_MIN_MARGIN)};
+}
+
+inline BBox merge(const BBox &a, const BBox &b) {
+    return {{std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z)},
+            {std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z)}};
+}
+
+inline float getSurfaceArea(const BBox &box) {
+    const Vec3 size = box.max - box.min;
+    return 2.0F * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+// Frustum planes in SoA layout, |n| is precomputed for the extent projection.
+struct FrustumPlanes {
+    float nx[FRUSTUM_PLANE_COUNT];
+    float ny[FRUSTUM_PLANE_COUNT];
+    float nz[FRUSTUM_PLANE_COUNT];
+    float ax[FRUSTUM_PLANE_COUNT];
+    float ay[FRUSTUM_PLANE_COUNT];
+    float az[FRUSTUM_PLANE_COUNT];
+    float d[FRUSTUM_PLANE_COUNT];
+
+    explicit FrustumPlanes(const geometry::Frustum &frustum) {
+        for (uint32_t i = 0; i < FRUSTUM_PLANE_COUNT; ++i) {
+            const auto &plane = *frustum.planes[i];
+            nx[i] = plane.n.x;
+            ny[i] = plane.n.y;
+            nz[i] = plane.n.z;
+            ax[i] = std::abs(plane.n.x);
+            ay[i] = std::abs(plane.n.y);
+            az[i] = std::abs(plane.n.z);
+            d[i] = plane.d;
+        }
+    }
+};
+
+/**
+ * Tests up to four boxes against all frustum planes, same rules as AABB::aabbPlane.
+ * Bit i of outsideMask is set if box i is behind any plane,
+ * bit i of insideMask is set if box i is in front of every plane.
+ */
+void testBoxes(const BBox *const *boxes, uint32_t count, const FrustumPlanes &planes, uint32_t &outsideMask, uint32_t &insideMask) {
+    alignas(16) float cx[NODE_BATCH_SIZE]{};
+    alignas(16) float cy[NODE_BATCH_SIZE]{};
+    alignas(16) float cz[NODE_BATCH_SIZE]{};
+    alignas(16) float ex[NODE_BATCH_SIZE]{};
+    alignas(16) float ey[NODE_BATCH_SIZE]{};
+    alignas(16) float ez[NODE_BATCH_SIZE]{};
+    for (uint32_t i = 0; i < count; ++i) {
+        const BBox &box = *boxes[i];
+        cx[i] = (box.min.x + box.max.x) * 0.5F;
+        cy[i] = (box.min.y + box.max.y) * 0.5F;
+        cz[i] = (box.min.z + box.max.z) * 0.5F;
+        ex[i] = (box.max.x - box.min.x) * 0.5F;
+        ey[i] = (box.max.y - box.min.y) * 0.5F;
+        ez[i] = (box.max.z - box.min.z) * 0.5F;
+    }
+
+#if defined(CC_AABB_TREE_SSE)
+    const __m128 vcx = _mm_load_ps(cx);
+    const __m128 vcy = _mm_load_ps(cy);
+    const __m128 vcz = _mm_load_ps(cz);
+    const __m128 vex = _mm_load_ps(ex);
+    const __m128 vey = _mm_load_ps(ey);
+    const __m128 vez = _mm_load_ps(ez);
+    __m128 outside = _mm_setzero_ps();
+    __m128 inside = _mm_cmpeq_ps(outside, outside);
+    for (uint32_t p = 0; p < FRUSTUM_PLANE_COUNT; ++p) {
+        const __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.nx[p]), vcx),
+                                                  _mm_mul_ps(_mm_set1_ps(planes.ny[p]), vcy)),
+                                       _mm_mul_ps(_mm_set1_ps(planes.nz[p]), vcz));
+        const __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.ax[p]), vex),
+                                                    _mm_mul_ps(_mm_set1_ps(planes.ay[p]), vey)),
+                                         _mm_mul_ps(_mm_set1_ps(planes.az[p]), vez));
+        const __m128 d = _mm_set1_ps(planes.d[p]);
+        outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dist, radius), d));
+        inside = _mm_and_ps(inside, _mm_cmpgt_ps(_mm_sub_ps(dist, radius), d));
+    }
+    outsideMask = static_cast<uint32_t>(_mm_movemask_ps(outside));
+    insideMask = static_cast<uint32_t>(_mm_movemask_ps(inside));
+#elif defined(CC_AABB_TREE_NEON)
+    const float32x4_t vcx = vld1q_f32(cx);
+    const float32x4_t vcy = vld1q_f32(cy);
+    const float32x4_t vcz = vld1q_f32(cz);
+    const float32x4_t vex = vld1q_f32(ex);
+    const float32x4_t vey = vld1q_f32(ey);
+    const float32x4_t vez = vld1q_f32(ez);
+    uint32x4_t outside = vdupq_n_u32(0);
+    uint32x4_t inside = vdupq_n_u32(~0U);
+    for (uint32_t p = 0; p < FRUSTUM_PLANE_COUNT; ++p) {
+        float32x4_t dist = vmulq_n_f32(vcx, planes.nx[p]);
+        dist = vmlaq_n_f32(dist, vcy, planes.ny[p]);
+        dist = vmlaq_n_f32(dist, vcz, planes.nz[p]);
+        float32x4_t radius = vmulq_n_f32(vex, planes.ax[p]);
+        radius = vmlaq_n_f32(radius, vey, planes.ay[p]);
+        radius = vmlaq_n_f32(radius, vez, planes.az[p]);
+        const float32x4_t d = vdupq_n_f32(planes.d[p]);
+        outside = vorrq_u32(outside, vcltq_f32(vaddq_f32(dist, radius), d));
+        inside = vandq_u32(inside, vcgtq_f32(vsubq_f32(dist, radius), d));
+    }
+    alignas(16) uint32_t outsideLanes[NODE_BATCH_SIZE];
+    alignas(16) uint32_t insideLanes[NODE_BATCH_SIZE];
+    vst1q_u32(outsideLanes, outside);
+    vst1q_u32(insideLanes, inside);
+    outsideMask = 0;
+    insideMask = 0;
+    for (uint32_t i = 0; i < NODE_BATCH_SIZE; ++i) {
+        outsideMask |= (outsideLanes[i] & 1U) << i;
+        insideMask |= (insideLanes[i] & 1U) << i;
+    }
+#else
+    outsideMask = 0;
+    insideMask = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        bool isOutside = false;
+        bool isInside = true;
+        for (uint32_t p = 0; p < FRUSTUM_PLANE_COUNT; ++p) {
+            const float dist = planes.nx[p] * cx[i] + planes.ny[p] * cy[i] + planes.nz[p] * cz[i];
+            const float radius = planes.ax[p] * ex[i] + planes.ay[p] * ey[i] + planes.az[p] * ez[i];
+            isOutside = isOutside || dist + radius < planes.d[p];
+            isInside = isInside && dist - radius > planes.d[p];
+        }
+        outsideMask |= static_cast<uint32_t>(isOutside) << i;
+        insideMask |= static_cast<uint32_t>(isInside) << i;
+    }
+#endif
+}
+
+} // namespace
+
+AABBTree::AABBTree() {
+    _nodes.reserve(64);
+}
+
+int32_t AABBTree::allocateNode() {
+    if (_freeList == AABB_TREE_NULL_NODE) {
+        _nodes.emplace_back();
+        _nodes.back().height = 0;
+        return static_cast<int32_t>(_nodes.size() - 1);
+    }
+
+    const int32_t nodeId = _freeList;
+    Node &node = _nodes[nodeId];
+    _freeList = node.parent;
+    node.parent = AABB_TREE_NULL_NODE;
+    node.child1 = AABB_TREE_NULL_NODE;
+    node.child2 = AABB_TREE_NULL_NODE;
+    node.model = nullptr;
+    node.height = 0;
+    return nodeId;
+}
+
+void AABBTree::freeNode(int32_t nodeId) {
+    Node &node = _nodes[nodeId];
+    node.parent = _freeList;
+    node.model = nullptr;
+    node.height = -1;
+    _freeList = nodeId;
+}
+
+int32_t AABBTree::createProxy(const BBox &box, Model *model) {
+    const int32_t proxyId = allocateNode();
+    Node &node = _nodes[proxyId];
+    const Vec3 margin = getFatMargin(box);
+    node.box = {box.min - margin, box.max + margin};
+    node.center = box.getCenter();
+    node.model = model;
+    node.height = 0;
+
+    insertLeaf(proxyId);
+    ++_proxyCount;
+    return proxyId;
+}
+
+void AABBTree::destroyProxy(int32_t proxyId) {
+    CC_ASSERT(proxyId >= 0 && proxyId < static_cast<int32_t>(_nodes.size()) && _nodes[proxyId].isLeaf());
+
+    removeLeaf(proxyId);
+    freeNode(proxyId);
+    --_proxyCount;
+}
+
+bool AABBTree::moveProxy(int32_t proxyId, const BBox &box) {
+    CC_ASSERT(proxyId >= 0 && proxyId < static_cast<int32_t>(_nodes.size()) && _nodes[proxyId].isLeaf());
+
+    Node &node = _nodes[proxyId];
+    const Vec3 margin = getFatMargin(box);
+    const Vec3 center = box.getCenter();
+    BBox fatBox{box.min - margin, box.max + margin};
+
+    // Predict the motion from the last displacement so steadily moving models are not reinserted every frame.
+    const Vec3 displacement = (center - node.center) * DISPLACEMENT_MULTIPLIER;
+    (displacement.x < 0.0F ? fatBox.min.x : fatBox.max.x) += displacement.x;
+    (displacement.y < 0.0F ? fatBox.min.y : fatBox.max.y) += displacement.y;
+    (displacement.z < 0.0F ? fatBox.min.z : fatBox.max.z) += displacement.z;
+    node.center = center;
+
+    if (node.box.contain(box)) {
+        // Keep the fat box unless it has become much larger than needed.
+        const Vec3 slack = margin * 4.0F + Vec3{std::abs(displacement.x), std::abs(displacement.y), std::abs(displacement.z)};
+        const BBox hugeBox{fatBox.min - slack, fatBox.max + slack};
+        if (hugeBox.contain(node.box)) {
+            return false;
+        }
+    }
+
+    removeLeaf(proxyId);
+    _nodes[proxyId].box = fatBox;
+    insertLeaf(proxyId);
+    return true;
+}
+
+void AABBTree::clear() {
+    _nodes.clear();
+    _root = AABB_TREE_NULL_NODE;
+    _freeList = AABB_TREE_NULL_NODE;
+    _proxyCount = 0;
+}
+
+void AABBTree::insertLeaf(int32_t leaf) {
+    if (_root == AABB_TREE_NULL_NODE) {
+        _root = leaf;
+        _nodes[leaf].parent = AABB_TREE_NULL_NODE;
+        return;
+    }
+
+    // Find the best sibling with the surface area heuristic.
+    const BBox leafBox = _nodes[leaf].box;
+    int32_t index = _root;
+    while (!_nodes[index].isLeaf()) {
+        const Node &node = _nodes[index];
+        const float area = getSurfaceArea(node.box);
+        const float combinedArea = getSurfaceArea(merge(node.box, leafBox));
+
+        // cost of creating a new parent for this node and the new leaf
+        const float cost = 2.0F * combinedArea;
+        // minimum cost of pushing the leaf further down the tree
+        const float inheritanceCost = 2.0F * (combinedArea - area);
+
+        auto descendCost = [&](int32_t childId) {
+            const Node &child = _nodes[childId];
+            const float mergedArea = getSurfaceArea(merge(leafBox, child.box));
+            return child.isLeaf() ? mergedArea + inheritanceCost
+                                  : mergedArea - getSurfaceArea(child.box) + inheritanceCost;
+        };
+        const float cost1 = descendCost(node.child1);
+        const float cost2 = descendCost(node.child2);
+
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    const int32_t sibling = index;
+    const int32_t oldParent = _nodes[sibling].parent;
+    const int32_t newParent = allocateNode();
+    Node &parentNode = _nodes[newParent];
+    parentNode.parent = oldParent;
+    parentNode.box = merge(leafBox, _nodes[sibling].box);
+    parentNode.height = _nodes[sibling].height + 1;
+    parentNode.child1 = sibling;
+    parentNode.child2 = leaf;
+    _nodes[sibling].parent = newParent;
+    _nodes[leaf].parent = newParent;
+
+    if (oldParent != AABB_TREE_NULL_NODE) {
+        if (_nodes[oldParent].child1 == sibling) {
+            _nodes[oldParent].child1 = newParent;
+        } else {
+            _nodes[oldParent].child2 = newParent;
+        }
+    } else {
+        _root = newParent;
+    }
+
+    refit(_nodes[leaf].parent);
+}
+
+void AABBTree::removeLeaf(int32_t leaf) {
+    if (leaf == _root) {
+        _root = AABB_TREE_NULL_NODE;
+        return;
+    }
+
+    const int32_t parent = _nodes[leaf].parent;
+    const int32_t grandParent = _nodes[parent].parent;
+    const int32_t sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+    if (grandParent != AABB_TREE_NULL_NODE) {
+        if (_nodes[grandParent].child1 == parent) {
+            _nodes[grandParent].child1 = sibling;
+        } else {
+            _nodes[grandParent].child2 = sibling;
+        }
+        _nodes[sibling].parent = grandParent;
+        freeNode(parent);
+        refit(grandParent);
+    } else {
+        _root = sibling;
+        _nodes[sibling].parent = AABB_TREE_NULL_NODE;
+        freeNode(parent);
+    }
+}
+
+void AABBTree::refit(int32_t nodeId) {
+    int32_t index = nodeId;
+    while (index != AABB_TREE_NULL_NODE) {
+        index = balance(index);
+
+        Node &node = _nodes[index];
+        const Node &child1 = _nodes[node.child1];
+        const Node &child2 = _nodes[node.child2];
+        node.height = 1 + std::max(child1.height, child2.height);
+        node.box = merge(child1.box, child2.box);
+
+        index = node.parent;
+    }
+}
+
+// Rotates the taller grandchild up if node A is imbalanced, returns the new subtree root.
+int32_t AABBTree::balance(int32_t iA) {
+    Node &a = _nodes[iA];
+    if (a.isLeaf() || a.height < 2) {
+        return iA;
+    }
+
+    const int32_t iB = a.child1;
+    const int32_t iC = a.child2;
+    Node &b = _nodes[iB];
+    Node &c = _nodes[iC];
+    const int32_t diff = c.height - b.height;
+
+    auto replaceInParent = [this](int32_t parent, int32_t oldChild, int32_t newChild) {
+        if (parent == AABB_TREE_NULL_NODE) {
+            _root = newChild;
+        } else if (_nodes[parent].child1 == oldChild) {
+            _nodes[parent].child1 = newChild;
+        } else {
+            _nodes[parent].child2 = newChild;
+        }
+    };
+
+    // rotate C up
+    if (diff > 1) {
+        const int32_t iF = c.child1;
+        const int32_t iG = c.child2;
+        Node &f = _nodes[iF];
+        Node &g = _nodes[iG];
+
+        c.child1 = iA;
+        c.parent = a.parent;
+        a.parent = iC;
+        replaceInParent(c.parent, iA, iC);
+
+        if (f.height > g.height) {
+            c.child2 = iF;
+            a.child2 = iG;
+            g.parent = iA;
+            a.box = merge(b.box, g.box);
+            c.box = merge(a.box, f.box);
+            a.height = 1 + std::max(b.height, g.height);
+            c.height = 1 + std::max(a.height, f.height);
+        } else {
+            c.child2 = iG;
+            a.child2 = iF;
+            f.parent = iA;
+            a.box = merge(b.box, f.box);
+            c.box = merge(a.box, g.box);
+            a.height = 1 + std::max(b.height, f.height);
+            c.height = 1 + std::max(a.height, g.height);
+        }
+        return iC;
+    }
+
+    // rotate B up
+    if (diff < -1) {
+        const int32_t iD = b.child1;
+        const int32_t iE = b.child2;
+        Node &d = _nodes[iD];
+        Node &e = _nodes[iE];
+
+        b.child1 = iA;
+        b.parent = a.parent;
+        a.parent = iB;
+        replaceInParent(b.parent, iA, iB);
+
+        if (d.height > e.height) {
+            b.child2 = iD;
+            a.child1 = iE;
+            e.parent = iA;
+            a.box = merge(c.box, e.box);
+            b.box = merge(a.box, d.box);
+            a.height = 1 + std::max(c.height, e.height);
+            b.height = 1 + std::max(a.height, d.height);
+        } else {
+            b.child2 = iE;
+            a.child1 = iD;
+            d.parent = iA;
+            a.box = merge(c.box, d.box);
+            b.box = merge(a.box, e.box);
+            a.height = 1 + std::max(c.height, d.height);
+            b.height = 1 + std::max(a.height, e.height);
+        }
+        return iB;
+    }
+
+    return iA;
+}
+
+void AABBTree::gatherModels(ccstd::vector<Model *> &results) const {
+    for (const auto &node : _nodes) {
+        if (node.height == 0) {
+            results.push_back(node.model);
+        }
+    }
+}
+
+void AABBTree::gatherLeaves(int32_t nodeId, ccstd::vector<int32_t> &stack, ccstd::vector<Model *> &results) const {
+    stack.push_back(nodeId);
+    while (!stack.empty()) {
+        const Node &node = _nodes[stack.back()];
+        stack.pop_back();
+        if (node.isLeaf()) {
+            results.push_back(node.model);
+        } else {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
+
+void AABBTree::gatherSubtrees(uint32_t minCount, ccstd::vector<int32_t> &results) const {
+    if (_root == AABB_TREE_NULL_NODE) {
+        return;
+    }
+
+    const auto begin = results.size();
+    results.push_back(_root);
+    while (results.size() - begin < minCount) {
+        // split the tallest subtree
+        auto tallest = results.end();
+        for (auto iter = results.begin() + static_cast<std::ptrdiff_t>(begin); iter != results.end(); ++iter) {
+            if (!_nodes[*iter].isLeaf() && (tallest == results.end() || _nodes[*iter].height > _nodes[*tallest].height)) {
+                tallest = iter;
+            }
+        }
+        if (tallest == results.end()) {
+            break;
+        }
+        const Node &node = _nodes[*tallest];
+        *tallest = node.child1;
+        results.push_back(node.child2);
+    }
+}
+
+void AABBTree::query(const geometry::Frustum &frustum, ccstd::vector<Model *> &contained, ccstd::vector<Model *> &intersected) const {
+    if (_root != AABB_TREE_NULL_NODE) {
+        querySubtree(_root, frustum, contained, intersected);
+    }
+}
+
+void AABBTree::querySubtree(int32_t nodeId, const geometry::Frustum &frustum, ccstd::vector<Model *> &contained, ccstd::vector<Model *> &intersected) const {
+    const FrustumPlanes planes(frustum);
+    ccstd::vector<int32_t> stack;
+    ccstd::vector<int32_t> leafStack;
+    stack.reserve(64);
+    stack.push_back(nodeId);
+
+    const BBox *boxes[NODE_BATCH_SIZE];
+    int32_t batch[NODE_BATCH_SIZE];
+    while (!stack.empty()) {
+        const auto count = static_cast<uint32_t>(std::min(stack.size(), static_cast<size_t>(NODE_BATCH_SIZE)));
+        for (uint32_t i = 0; i < count; ++i) {
+            batch[i] = stack.back();
+            boxes[i] = &_nodes[batch[i]].box;
+            stack.pop_back();
+        }
+
+        uint32_t outsideMask = 0;
+        uint32_t insideMask = 0;
+        testBoxes(boxes, count, planes, outsideMask, insideMask);
+
+        for (uint32_t i = 0; i < count; ++i) {
+            if (outsideMask & (1U << i)) {
+                continue;
+            }
+            const Node &node = _nodes[batch[i]];
+            if (insideMask & (1U << i)) {
+                gatherLeaves(batch[i], leafStack, contained);
+            } else if (node.isLeaf()) {
+                intersected.push_back(node.model);
+            } else {
+                stack.push_back(node.child1);
+                stack.push_back(node.child2);
+            }
+        }
+    }
+}
+
+} // namespace scene
+} // namespace cc
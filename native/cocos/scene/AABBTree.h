@@ -0,0 +1,104 @@
+/****************************************************************************
+ Copyright (c) 2020-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#include "base/Macros.h"
+#include "base/std/container/vector.h"
+#include "scene/Octree.h"
+
+namespace cc {
+namespace geometry {
+class Frustum;
+}
+namespace scene {
+
+class Model;
+
+constexpr int32_t AABB_TREE_NULL_NODE = -1;
+
+/**
+ * Dynamic AABB tree, a bounding volume hierarchy over fattened model bounds.
+ * Moving a model only touches the tree once its bounds leave the fattened box, the leaf is then
+ * reinserted and the ancestors are refitted and rebalanced with tree rotations on the way up.
+ * Frustum queries test four nodes against each plane at a time with SSE or NEON.
+ */
+class CC_DLL AABBTree final {
+public:
+    AABBTree();
+    ~AABBTree() = default;
+
+    int32_t createProxy(const BBox &box, Model *model);
+    void destroyProxy(int32_t proxyId);
+    // returns true if the proxy was reinserted
+    bool moveProxy(int32_t proxyId, const BBox &box);
+    void clear();
+
+    inline Model *getModel(int32_t proxyId) const { return _nodes[proxyId].model; }
+    inline const BBox &getFatBox(int32_t proxyId) const { return _nodes[proxyId].box; }
+    inline uint32_t getProxyCount() const { return _proxyCount; }
+    inline int32_t getHeight() const { return _root == AABB_TREE_NULL_NODE ? 0 : _nodes[_root].height; }
+
+    void gatherModels(ccstd::vector<Model *> &results) const;
+
+    // Collects disjoint subtrees covering the whole tree, at least minCount of them if the tree is large enough.
+    void gatherSubtrees(uint32_t minCount, ccstd::vector<int32_t> &results) const;
+
+    // Models whose fat box is entirely inside the frustum go to contained, the ones crossing a plane go to intersected.
+    void query(const geometry::Frustum &frustum, ccstd::vector<Model *> &contained, ccstd::vector<Model *> &intersected) const;
+    void querySubtree(int32_t nodeId, const geometry::Frustum &frustum, ccstd::vector<Model *> &contained, ccstd::vector<Model *> &intersected) const;
+
+private:
+    struct Node {
+        BBox box;
+        Model *model{nullptr};
+        // center of the model bounds at the last update, for leaves only
+        Vec3 center;
+        // parent for nodes in the tree, next free node for nodes in the free list
+        int32_t parent{AABB_TREE_NULL_NODE};
+        int32_t child1{AABB_TREE_NULL_NODE};
+        int32_t child2{AABB_TREE_NULL_NODE};
+        // leaf = 0, free node = -1
+        int32_t height{-1};
+
+        inline bool isLeaf() const { return child1 == AABB_TREE_NULL_NODE; }
+    };
+
+    int32_t allocateNode();
+    void freeNode(int32_t nodeId);
+    void insertLeaf(int32_t leaf);
+    void removeLeaf(int32_t leaf);
+    void refit(int32_t nodeId);
+    int32_t balance(int32_t nodeId);
+    void gatherLeaves(int32_t nodeId, ccstd::vector<int32_t> &stack, ccstd::vector<Model *> &results) const;
+
+    ccstd::vector<Node> _nodes;
+    int32_t _root{AABB_TREE_NULL_NODE};
+    int32_t _freeList{AABB_TREE_NULL_NODE};
+    uint32_t _proxyCount{0};
+};
+
+} // namespace scene
+} // namespace cc
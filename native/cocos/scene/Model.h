@@ -144,6 +144,7 @@ public:
         _worldBoundsDirty = true;
     }
     inline void setOctreeNode(OctreeNode *node) { _octreeNode = node; }
+    inline void setAABBTreeProxy(int32_t proxyId) { _aabbTreeProxy = proxyId; }
     inline void setScene(RenderScene *scene) {
         _scene = scene;
         if (scene) _localDataUpdated = true;
@@ -187,6 +188,7 @@ public:
     inline Type getType() const { return _type; };
     inline void setType(Type type) { _type = type; }
     inline OctreeNode *getOctreeNode() const { return _octreeNode; }
+    inline int32_t getAABBTreeProxy() const { return _aabbTreeProxy; }
     inline RenderScene *getScene() const { return _scene; }
     inline void setDynamicBatching(bool val) { _isDynamicBatching = val; }
     inline bool isDynamicBatching() const { return _isDynamicBatching; }
@@ -229,6 +231,7 @@ protected:
     int32_t _reflectionProbeId{-1};
 
     OctreeNode *_octreeNode{nullptr};
+    int32_t _aabbTreeProxy{-1};
     RenderScene *_scene{nullptr};
     gfx::Device *_device{nullptr};
 
@@ -25,12 +25,41 @@
 #include "Octree.h"
 #include <future>
 #include <utility>
+#include "base/job-system/JobSystem.h"
+#include "scene/AABBTree.h"
 #include "scene/Camera.h"
 #include "scene/Model.h"
 
 namespace cc {
 namespace scene {
 
+namespace {
+bool isModelCulled(uint32_t visibility, const Model *model, bool isShadow) {
+    if (!model->isEnabled() || !model->getWorldBounds() || (isShadow && !model->isCastShadow())) {
+        return true;
+    }
+    const Node *node = model->getNode();
+    return !((node && ((visibility & node->getLayer()) == node->getLayer())) ||
+             (visibility & static_cast<uint32_t>(model->getVisFlags())));
+}
+
+void filterTreeModels(const Camera *camera, const geometry::Frustum &frustum, bool isShadow,
+                      const ccstd::vector<Model *> &contained, const ccstd::vector<Model *> &intersected,
+                      ccstd::vector<Model *> &results) {
+    const auto visibility = camera->getVisibility();
+    for (auto *model : contained) {
+        if (!isModelCulled(visibility, model, isShadow)) {
+            results.push_back(model);
+        }
+    }
+    for (auto *model : intersected) {
+        if (!isModelCulled(visibility, model, isShadow) && model->getWorldBounds()->aabbFrustum(frustum)) {
+            results.push_back(model);
+        }
+    }
+}
+} // namespace
+
 void OctreeInfo::setEnabled(bool val) {
     if (_enabled == val) {
         return;
@@ -62,6 +91,13 @@ void OctreeInfo::setDepth(uint32_t val) {
     }
 }
 
+void OctreeInfo::setSpatialIndex(SpatialIndexType val) {
+    _spatialIndex = val;
+    if (_resource) {
+        _resource->setSpatialIndex(val);
+    }
+}
+
 void OctreeInfo::activate(Octree *resource) {
     _resource = resource;
     _resource->initialize(*this);
@@ -299,6 +335,7 @@ void OctreeNode::queryVisibilitySequentially(const Camera *camera, const geometr
  */
 Octree::Octree() {
     _root = ccnew OctreeNode(this, nullptr);
+    _aabbTree = std::make_unique<AABBTree>();
 }
 
 Octree::~Octree() {
@@ -314,6 +351,7 @@ void Octree::initialize(const OctreeInfo &info) {
     _root->setBox(BBox{_minPos - expand, _maxPos});
     _root->setDepth(0);
     _root->setIndex(0);
+    setSpatialIndex(info.getSpatialIndex());
 }
 
 void Octree::setEnabled(bool val) {
@@ -337,6 +375,13 @@ void Octree::setMaxDepth(uint32_t val) {
 
 void Octree::resize(const Vec3 &minPos, const Vec3 &maxPos, uint32_t maxDepth) {
     const Vec3 expand{OCTREE_BOX_EXPAND_SIZE, OCTREE_BOX_EXPAND_SIZE, OCTREE_BOX_EXPAND_SIZE};
+    if (_spatialIndex == SpatialIndexType::AABB_TREE) {
+        // the tree is unbounded, only keep the octree settings for switching back
+        _root->setBox(BBox{minPos - expand, maxPos});
+        _maxDepth = std::max(maxDepth, 1U);
+        return;
+    }
+
     BBox rootBox = _root->getBox();
     if ((minPos - expand) == rootBox.min && maxPos == rootBox.max && maxDepth == _maxDepth) {
         return;
@@ -359,6 +404,36 @@ void Octree::resize(const Vec3 &minPos, const Vec3 &maxPos, uint32_t maxDepth) {
     }
 }
 
+void Octree::setSpatialIndex(SpatialIndexType type) {
+    if (_spatialIndex == type) {
+        return;
+    }
+
+    ccstd::vector<Model *> models;
+    if (_spatialIndex == SpatialIndexType::AABB_TREE) {
+        _aabbTree->gatherModels(models);
+        _aabbTree->clear();
+        for (auto *model : models) {
+            model->setAABBTreeProxy(AABB_TREE_NULL_NODE);
+        }
+    } else {
+        _root->gatherModels(models);
+        delete _root;
+        _root = ccnew OctreeNode(this, nullptr);
+        const Vec3 expand{OCTREE_BOX_EXPAND_SIZE, OCTREE_BOX_EXPAND_SIZE, OCTREE_BOX_EXPAND_SIZE};
+        _root->setBox(BBox{_minPos - expand, _maxPos});
+        for (auto *model : models) {
+            model->setOctreeNode(nullptr);
+        }
+    }
+
+    _spatialIndex = type;
+    _totalCount = 0;
+    for (auto *model : models) {
+        insert(model);
+    }
+}
+
 void Octree::insert(Model *model) {
     CC_ASSERT(model);
 
@@ -366,6 +441,17 @@ void Octree::insert(Model *model) {
         return;
     }
 
+    if (_spatialIndex == SpatialIndexType::AABB_TREE) {
+        const int32_t proxyId = model->getAABBTreeProxy();
+        if (proxyId == AABB_TREE_NULL_NODE) {
+            model->setAABBTreeProxy(_aabbTree->createProxy(BBox(*model->getWorldBounds()), model));
+            _totalCount++;
+        } else {
+            _aabbTree->moveProxy(proxyId, BBox(*model->getWorldBounds()));
+        }
+        return;
+    }
+
     if (isOutside(model)) {
         CC_LOG_WARNING("Octree insert: model is outside of the scene bounding box, please modify DEFAULT_WORLD_MIN_POS and DEFAULT_WORLD_MAX_POS.");
         return;
@@ -381,6 +467,16 @@ void Octree::insert(Model *model) {
 void Octree::remove(Model *model) {
     CC_ASSERT(model);
 
+    if (_spatialIndex == SpatialIndexType::AABB_TREE) {
+        const int32_t proxyId = model->getAABBTreeProxy();
+        if (proxyId != AABB_TREE_NULL_NODE) {
+            _aabbTree->destroyProxy(proxyId);
+            model->setAABBTreeProxy(AABB_TREE_NULL_NODE);
+            _totalCount--;
+        }
+        return;
+    }
+
     OctreeNode *node = model->getOctreeNode();
     if (node) {
         node->remove(model);
@@ -394,6 +490,11 @@ void Octree::update(Model *model) {
 }
 
 void Octree::queryVisibility(const Camera *camera, const geometry::Frustum &frustum, bool isShadow, ccstd::vector<Model *> &results) const {
+    if (_spatialIndex == SpatialIndexType::AABB_TREE) {
+        queryTreeVisibility(camera, frustum, isShadow, results);
+        return;
+    }
+
     if (_totalCount > USE_MULTI_THRESHOLD) {
         _root->queryVisibilityParallelly(camera, frustum, isShadow, results);
     } else {
@@ -401,6 +502,37 @@ void Octree::queryVisibility(const Camera *camera, const geometry::Frustum &frus
     }
 }
 
+void Octree::queryTreeVisibility(const Camera *camera, const geometry::Frustum &frustum, bool isShadow, ccstd::vector<Model *> &results) const {
+    auto *jobSystem = JobSystem::getInstance();
+    if (_totalCount <= USE_MULTI_THRESHOLD || jobSystem->threadCount() <= 1) {
+        ccstd::vector<Model *> contained;
+        ccstd::vector<Model *> intersected;
+        _aabbTree->query(frustum, contained, intersected);
+        filterTreeModels(camera, frustum, isShadow, contained, intersected, results);
+        return;
+    }
+
+    // Unlike the octree, split deep enough to keep every worker busy.
+    ccstd::vector<int32_t> subtrees;
+    _aabbTree->gatherSubtrees(jobSystem->threadCount() * 2, subtrees);
+    const auto count = static_cast<uint32_t>(subtrees.size());
+    ccstd::vector<ccstd::vector<Model *>> subResults(count);
+
+    JobGraph g(jobSystem);
+    g.createForEachIndexJob(0U, count, 1U, [&](uint32_t i) {
+        ccstd::vector<Model *> contained;
+        ccstd::vector<Model *> intersected;
+        _aabbTree->querySubtree(subtrees[i], frustum, contained, intersected);
+        filterTreeModels(camera, frustum, isShadow, contained, intersected, subResults[i]);
+    });
+    g.run();
+    g.waitForAll();
+
+    for (const auto &models : subResults) {
+        results.insert(results.end(), models.begin(), models.end());
+    }
+}
+
 bool Octree::isInside(Model *model) const {
     const BBox &rootBox = _root->getBox();
     BBox modelBox = BBox(*model->getWorldBounds());
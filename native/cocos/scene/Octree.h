@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <memory>
 #include "base/Macros.h"
 #include "base/RefCounted.h"
 #include "base/std/container/array.h"
@@ -33,6 +34,7 @@
 namespace cc {
 namespace scene {
 
+class AABBTree;
 class Camera;
 class Model;
 class Octree;
@@ -44,6 +46,11 @@ const Vec3 DEFAULT_WORLD_MAX_POS = {1024.0F, 1024.0F, 1024.0F};
 const float OCTREE_BOX_EXPAND_SIZE = 10.0F;
 constexpr int USE_MULTI_THRESHOLD = 1024; // use parallel culling if greater than this value
 
+enum class SpatialIndexType : uint8_t {
+    OCTREE,
+    AABB_TREE, // dynamic AABB tree, suits scenes with many moving models and no fixed world bounds
+};
+
 class CC_DLL OctreeInfo final : public RefCounted {
 public:
     OctreeInfo() = default;
@@ -76,6 +83,13 @@ public:
     void setDepth(uint32_t val);
     inline uint32_t getDepth() const { return _depth; }
 
+    /**
+     * @en spatial index used for culling
+     * @zh 剔除使用的空间索引
+     */
+    void setSpatialIndex(SpatialIndexType val);
+    inline SpatialIndexType getSpatialIndex() const { return _spatialIndex; }
+
     void activate(Octree *resource);
 
     // JS deserialization require the properties to be public
@@ -84,6 +98,7 @@ public:
     Vec3 _minPos{DEFAULT_WORLD_MIN_POS};
     Vec3 _maxPos{DEFAULT_WORLD_MAX_POS};
     uint32_t _depth{DEFAULT_OCTREE_DEPTH};
+    SpatialIndexType _spatialIndex{SpatialIndexType::OCTREE};
 
 private:
     Octree *_resource{nullptr};
@@ -217,12 +232,20 @@ public:
     // return octree depth
     inline uint32_t getMaxDepth() const { return _maxDepth; }
 
+    /**
+     * @en Spatial index used to store the models, models are moved to the new index on change
+     * @zh 存储模型使用的空间索引，切换时会迁移已有模型
+     */
+    void setSpatialIndex(SpatialIndexType type);
+    inline SpatialIndexType getSpatialIndex() const { return _spatialIndex; }
+
     // view frustum culling
     void queryVisibility(const Camera *camera, const geometry::Frustum &frustum, bool isShadow, ccstd::vector<Model *> &results) const;
 
 private:
     bool isInside(Model *model) const;
     bool isOutside(Model *model) const;
+    void queryTreeVisibility(const Camera *camera, const geometry::Frustum &frustum, bool isShadow, ccstd::vector<Model *> &results) const;
 
     OctreeNode *_root{nullptr};
     uint32_t _maxDepth{DEFAULT_OCTREE_DEPTH};
@@ -231,6 +254,9 @@ private:
     bool _enabled{false};
     Vec3 _minPos;
     Vec3 _maxPos;
+
+    SpatialIndexType _spatialIndex{SpatialIndexType::OCTREE};
+    std::unique_ptr<AABBTree> _aabbTree;
 };
 
 } // namespace scene
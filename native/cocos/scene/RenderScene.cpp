@@ -25,12 +25,15 @@
 #include "scene/RenderScene.h"
 #include "scene/Camera.h"
 
+#include <algorithm>
 #include <utility>
 #include "3d/models/BakedSkinningModel.h"
 #include "3d/models/SkinningModel.h"
 #include "base/Log.h"
+#include "base/job-system/JobSystem.h"
 #include "core/Root.h"
 #include "core/scene-graph/Node.h"
+#include "core/scene-graph/TransformStore.h"
 #include "profiler/Profiler.h"
 #include "renderer/pipeline/PipelineSceneData.h"
 #include "renderer/pipeline/custom/RenderInterfaceTypes.h"
@@ -48,6 +51,19 @@
 namespace cc {
 namespace scene {
 
+namespace {
+// Below this many models the job dispatch overhead outweighs the gain.
+constexpr uint32_t PARALLEL_UPDATE_MIN_MODELS = 256;
+constexpr uint32_t PARALLEL_UPDATE_MIN_CHUNK = 64;
+
+// Skinning models share joint transforms between models through a global stamp cache,
+// and JS models dispatch events, so only models touching their own node are updated in jobs.
+bool isParallelUpdateSafe(const Model *model) {
+    const auto type = model->getType();
+    return type == Model::Type::DEFAULT || type == Model::Type::BAKED_SKINNING;
+}
+} // namespace
+
 /**
  * @zh 管理LODGroup的使用状态，包含使用层级及其上的model可见相机列表；便于判断当前model是否被LODGroup裁剪
  * @en Manage the usage status of LODGroup, including the usage level and the list of visible cameras on its models; easy to determine whether the current mod is cropped by LODGroup。
@@ -162,6 +178,10 @@ void RenderScene::setMainLight(DirectionalLight *dl) {
 void RenderScene::update(uint32_t stamp) {
     CC_PROFILE(RenderSceneUpdate);
 
+    if (_transformStore) {
+        _transformStore->update();
+    }
+
     if (_mainLight) {
         _mainLight->update();
     }
@@ -177,6 +197,20 @@ void RenderScene::update(uint32_t stamp) {
     for (const auto &light : _rangedDirLights) {
         light->update();
     }
+    if (_parallelUpdateEnabled && _models.size() >= PARALLEL_UPDATE_MIN_MODELS && JobSystem::getInstance()->threadCount() > 1) {
+        updateModelsParallelly(stamp);
+    } else {
+        updateModels(stamp);
+    }
+
+    CC_PROFILE_OBJECT_UPDATE(Models, _models.size());
+    CC_PROFILE_OBJECT_UPDATE(Cameras, _cameras.size());
+    CC_PROFILE_OBJECT_UPDATE(DrawBatch2D, _batches.size());
+
+    _lodStateCache->updateLodState();
+}
+
+void RenderScene::updateModels(uint32_t stamp) {
     for (const auto &model : _models) {
         if (model->isEnabled()) {
             model->updateTransform(stamp);
@@ -184,12 +218,59 @@ void RenderScene::update(uint32_t stamp) {
             model->updateOctree();
         }
     }
+}
 
-    CC_PROFILE_OBJECT_UPDATE(Models, _models.size());
-    CC_PROFILE_OBJECT_UPDATE(Cameras, _cameras.size());
-    CC_PROFILE_OBJECT_UPDATE(DrawBatch2D, _batches.size());
+void RenderScene::updateModelsParallelly(uint32_t stamp) {
+    CC_PROFILE(RenderSceneUpdateModelsParallelly);
 
-    _lodStateCache->updateLodState();
+    // 1. Resolve the node hierarchy on this thread, sibling models may share ancestors.
+    _parallelModels.clear();
+    for (const auto &model : _models) {
+        if (!model->isEnabled()) {
+            continue;
+        }
+        if (isParallelUpdateSafe(model)) {
+            Node *node = model->getTransform();
+            if (node->isTransformDirty()) {
+                node->updateWorldTransform();
+            }
+            _parallelModels.emplace_back(model);
+        } else {
+            model->updateTransform(stamp);
+        }
+    }
+
+    // 2. Compute world bounds in chunks, the nodes are read-only from here on.
+    const auto count = static_cast<uint32_t>(_parallelModels.size());
+    const uint32_t threadCount = JobSystem::getInstance()->threadCount();
+    const uint32_t chunkSize = std::max((count - 1) / threadCount + 1, PARALLEL_UPDATE_MIN_CHUNK);
+    const uint32_t chunkCount = count ? (count - 1) / chunkSize + 1 : 0;
+    if (chunkCount > 1) {
+        JobGraph g(JobSystem::getInstance());
+        g.createForEachIndexJob(1U, chunkCount, 1U, [this, stamp, chunkSize, count](uint32_t chunk) {
+            const uint32_t end = std::min(count, (chunk + 1) * chunkSize);
+            for (uint32_t i = chunk * chunkSize; i < end; ++i) {
+                _parallelModels[i]->updateTransform(stamp);
+            }
+        });
+        g.run();
+        for (uint32_t i = 0; i < std::min(count, chunkSize); ++i) {
+            _parallelModels[i]->updateTransform(stamp);
+        }
+        g.waitForAll();
+    } else {
+        for (auto *model : _parallelModels) {
+            model->updateTransform(stamp);
+        }
+    }
+
+    // 3. GFX uploads and octree reinsertion are not thread-safe, apply them in model order.
+    for (const auto &model : _models) {
+        if (model->isEnabled()) {
+            model->updateUBOs(stamp);
+            model->updateOctree();
+        }
+    }
 }
 
 void RenderScene::destroy() {
@@ -33,6 +33,7 @@
 namespace cc {
 
 class Node;
+class TransformStore;
 class SkinningModel;
 class BakedSkinningModel;
 
@@ -125,7 +126,24 @@ public:
     void updateOctree(Model *model);
     inline const ccstd::vector<DrawBatch2D *> &getBatches() const { return _batches; }
 
+    /**
+     * @en Whether to update the transforms of models on the job system. UBO uploads and octree
+     * reinsertion still happen on the calling thread, in model order, so the result is the same as the serial path.
+     * Models implemented in JS receive their UpdateTransform event before any model uploads its UBOs, rather than
+     * interleaved with the uploads of the models before them.
+     * @zh 是否在 JobSystem 上并行更新模型的变换。UBO 上传与八叉树更新仍按模型顺序在调用线程执行，结果与串行路径一致。
+     * JS 实现的模型会在所有模型上传 UBO 之前收到 UpdateTransform 事件，而不是与前面模型的上传交错进行。
+     */
+    inline void setParallelUpdateEnabled(bool val) { _parallelUpdateEnabled = val; }
+    inline bool isParallelUpdateEnabled() const { return _parallelUpdateEnabled; }
+
+    inline void setTransformStore(TransformStore *store) { _transformStore = store; }
+    inline TransformStore *getTransformStore() const { return _transformStore; }
+
 private:
+    void updateModels(uint32_t stamp);
+    void updateModelsParallelly(uint32_t stamp);
+
     ccstd::string _name;
     uint64_t _modelId{0};
     IntrusivePtr<DirectionalLight> _mainLight;
@@ -140,6 +158,9 @@ private:
     ccstd::vector<IntrusivePtr<RangedDirectionalLight>> _rangedDirLights;
     ccstd::vector<DrawBatch2D *> _batches;
     Octree *_octree{nullptr};
+    TransformStore *_transformStore{nullptr};
+    ccstd::vector<Model *> _parallelModels;
+    bool _parallelUpdateEnabled{false};
 
     CC_DISALLOW_COPY_MOVE_ASSIGN(RenderScene);
 };
@@ -28,6 +28,7 @@
 #include "pipeline/Define.h"
 #include "pipeline/InstancedBuffer.h"
 #include "renderer/pipeline/PipelineSceneData.h"
+#include "renderer/pipeline/PipelineStateManager.h"
 #include "renderer/pipeline/custom/RenderInterfaceTypes.h"
 #include "renderer/pipeline/forward/ForwardPipeline.h"
 #include "scene/Model.h"
@@ -358,6 +359,7 @@ void SubModel::flushPassInfo() {
     _shaders.resize(passes.size());
     for (size_t i = 0; i < passes.size(); ++i) {
         _shaders[i] = passes[i]->getShaderVariant(_patches);
+        pipeline::PipelineStateManager::prewarm(passes[i].get(), _shaders[i].get(), _inputAssembler.get());
     }
 }
 
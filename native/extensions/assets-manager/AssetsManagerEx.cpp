@@ -518,13 +518,17 @@ void AssetsManagerEx::decompressDownloadedZip(const std::string &customId, const
         }
         delete dataInner;
     };
-    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, decompressFinished, static_cast<void *>(asyncData), [this, asyncData]() {
+    std::function<void(void *)> decompressCanceled = [](void *param) {
+        delete reinterpret_cast<AsyncData *>(param);
+    };
+    auto decompressTask = [this, asyncData]() {
         // Decompress all compressed files
         if (decompress(asyncData->zipFile)) {
             asyncData->succeed = true;
         }
         _fileUtils->removeFile(asyncData->zipFile);
-    });
+    };
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, decompressFinished, static_cast<void *>(asyncData), decompressTask, decompressCanceled);
 }
 
 void AssetsManagerEx::dispatchUpdateEvent(EventAssetsManagerEx::EventCode code, const std::string &assetId /* = ""*/, const std::string &message /* = ""*/, int curleCode /* = CURLE_OK*/, int curlmCode /* = CURLM_OK*/) {
@@ -45,6 +45,64 @@ void AsyncTaskPool::destroyInstance() {
 
 AsyncTaskPool::AsyncTaskPool() = default;
 
-AsyncTaskPool::~AsyncTaskPool() = default;
+AsyncTaskPool::~AsyncTaskPool() {
+    for (auto &lane : _lanes) {
+        lane.clear();
+    }
+    for (auto &lane : _lanes) {
+        lane.join();
+    }
+}
+
+void AsyncTaskPool::TaskLane::enqueue(AsyncTask &&task) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _tasks.push(std::move(task));
+    if (_draining) {
+        return;
+    }
+    _draining = true;
+    lock.unlock();
+    ThreadPool::getInstance()->dispatch([this]() { drain(); }, _priority);
+}
+
+void AsyncTaskPool::TaskLane::clear() {
+    std::queue<AsyncTask> dropped;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::swap(dropped, _tasks);
+    }
+    for (; !dropped.empty(); dropped.pop()) {
+        const auto &task = dropped.front();
+        if (task.cancelCallback) {
+            task.cancelCallback(task.callbackParam);
+        }
+    }
+}
+
+void AsyncTaskPool::TaskLane::join() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _idle.wait(lock, [this]() { return !_draining; });
+}
+
+void AsyncTaskPool::TaskLane::drain() {
+    for (;;) {
+        AsyncTask task;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_tasks.empty()) {
+                _draining = false;
+                _idle.notify_all();
+                return;
+            }
+            task = std::move(_tasks.front());
+            _tasks.pop();
+        }
+
+        task.task();
+        CC_CURRENT_ENGINE()->getScheduler()->performFunctionInCocosThread([callback = std::move(task.callback), callbackParam = task.callbackParam]() {
+            callback(callbackParam);
+        });
+    }
+}
 
 } // namespace cc
@@ -26,16 +26,13 @@ Permission is hereby granted, free of charge, to any person obtaining a copy
 #pragma once
 
 #include "application/ApplicationManager.h"
+#include "base/threading/ThreadPool.h"
 
+#include <array>
 #include <condition_variable>
 #include <functional>
-#include <future>
-#include <memory>
 #include <mutex>
 #include <queue>
-#include <stdexcept>
-#include <thread>
-#include <vector>
 
 /**
 * @addtogroup base
@@ -82,123 +79,61 @@ public:
     /**
      * Enqueue a asynchronous task.
      *
-     * @param type task type is io task, network task or others, each type of task has a thread to deal with it.
+     * @param type task type is io task, network task or others, tasks of the same type run one after another on the shared ThreadPool.
      * @param callback callback when the task is finished. The callback is called in the main thread instead of task thread.
      * @param callbackParam parameter used by the callback.
      * @param f task can be lambda function.
+     * @param cancelCallback called with callbackParam instead of callback if the task is stopped before it runs, so that the parameter can be released.
+     *        It is called on the thread which stops the tasks.
      * @lua NA
      */
     template <class F>
-    inline void enqueue(TaskType type, const TaskCallBack &callback, void *callbackParam, F &&f);
+    inline void enqueue(TaskType type, const TaskCallBack &callback, void *callbackParam, F &&f, const TaskCallBack &cancelCallback = nullptr);
 
 protected:
-    // thread tasks internally used
-    class ThreadTasks {
-        struct AsyncTaskCallBack {
-            TaskCallBack callback;
-            void *callbackParam;
-        };
+    struct AsyncTask {
+        std::function<void()> task;
+        TaskCallBack callback;
+        TaskCallBack cancelCallback;
+        void *callbackParam{nullptr};
+    };
 
+    // Tasks of one type run serially: a single drain job on the shared ThreadPool runs them in order.
+    class TaskLane {
     public:
-        ThreadTasks() {
-            _thread = std::thread(
-                [this] {
-                    for (;;) {
-                        std::function<void()> task;
-                        AsyncTaskCallBack callback;
-                        {
-                            std::unique_lock<std::mutex> lock(this->_queueMutex);
-                            this->_condition.wait(lock,
-                                                  [this] { return this->_stop || !this->_tasks.empty(); });
-                            if (this->_stop && this->_tasks.empty()) {
-                                return;
-                            }
-                            task = std::move(this->_tasks.front());
-                            callback = std::move(this->_taskCallBacks.front());
-                            this->_tasks.pop();
-                            this->_taskCallBacks.pop();
-                        }
-
-                        task();
-                        CC_CURRENT_ENGINE()->getScheduler()->performFunctionInCocosThread([&, callback] { callback.callback(callback.callbackParam); });
-                    }
-                });
-        }
-        ~ThreadTasks() {
-            {
-                std::unique_lock<std::mutex> lock(_queueMutex);
-                _stop = true;
-
-                while (!_tasks.empty()) {
-                    _tasks.pop();
-                }
-                while (!_taskCallBacks.empty()) {
-                    _taskCallBacks.pop();
-                }
-            }
-            _condition.notify_all();
-            _thread.join();
-        }
-        void clear() {
-            std::unique_lock<std::mutex> lock(_queueMutex);
-            while (!_tasks.empty()) {
-                _tasks.pop();
-            }
-            while (!_taskCallBacks.empty()) {
-                _taskCallBacks.pop();
-            }
-        }
-        template <class F>
-        void enqueue(const TaskCallBack &callback, void *callbackParam, F &&f) {
-            auto task = f; //std::bind(std::forward<F>(f), std::forward<Args>(args)...);
-
-            {
-                std::unique_lock<std::mutex> lock(_queueMutex);
-
-                // don't allow enqueueing after stopping the pool
-                if (_stop) {
-                    CC_ASSERT(0 && "already stop");
-                    return;
-                }
-
-                AsyncTaskCallBack taskCallBack;
-                taskCallBack.callback = callback;
-                taskCallBack.callbackParam = callbackParam;
-                _tasks.emplace([task]() { task(); });
-                _taskCallBacks.emplace(taskCallBack);
-            }
-            _condition.notify_one();
-        }
+        explicit TaskLane(TaskPriority priority) : _priority(priority) {}
+
+        void enqueue(AsyncTask &&task);
+        void clear();
+        // Waits for the task being run, if any.
+        void join();
 
     private:
-        // need to keep track of thread so we can join them
-        std::thread _thread;
-        // the task queue
-        std::queue<std::function<void()>> _tasks;
-        std::queue<AsyncTaskCallBack> _taskCallBacks;
-
-        // synchronization
-        std::mutex _queueMutex;
-        std::condition_variable _condition;
-        bool _stop{false};
+        void drain();
+
+        std::mutex _mutex;
+        std::condition_variable _idle;
+        std::queue<AsyncTask> _tasks;
+        TaskPriority _priority;
+        bool _draining{false};
     };
 
-    //tasks
-    ThreadTasks _threadTasks[static_cast<int>(TaskType::TASK_MAX_TYPE)];
+    std::array<TaskLane, static_cast<int>(TaskType::TASK_MAX_TYPE)> _lanes{
+        TaskLane{TaskPriority::NORMAL},
+        TaskLane{TaskPriority::NORMAL},
+        TaskLane{TaskPriority::LOW},
+    };
 
     static AsyncTaskPool *sAsyncTaskPool;
 };
 
 inline void AsyncTaskPool::stopTasks(TaskType type) {
-    auto &threadTask = _threadTasks[static_cast<int>(type)];
-    threadTask.clear();
+    _lanes[static_cast<int>(type)].clear();
 }
 
 template <class F>
-inline void AsyncTaskPool::enqueue(AsyncTaskPool::TaskType type, const TaskCallBack &callback, void *callbackParam, F &&f) {
-    auto &threadTask = _threadTasks[static_cast<int>(type)];
-
-    threadTask.enqueue(callback, callbackParam, f);
+inline void AsyncTaskPool::enqueue(AsyncTaskPool::TaskType type, const TaskCallBack &callback, void *callbackParam, F &&f, const TaskCallBack &cancelCallback) {
+    _lanes[static_cast<int>(type)].enqueue(AsyncTask{std::forward<F>(f), callback, cancelCallback, callbackParam});
 }
 
 } // namespace cc
@@ -0,0 +1,166 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "audio/common/mixer/AudioMixerKernels.h"
+#include "audio/common/mixer/SoftwareMixer.h"
+#include "gtest/gtest.h"
+
+using namespace cc;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t SAMPLE_RATE = 48000;
+constexpr float GAIN_L = 0.75F / 32768.F;
+constexpr float GAIN_R = 0.25F / 32768.F;
+
+std::vector<int16_t> makePcm(uint32_t frames, uint32_t channels) {
+    std::vector<int16_t> pcm(frames * channels);
+    for (uint32_t i = 0; i < pcm.size(); ++i) {
+        pcm[i] = static_cast<int16_t>(std::sin(static_cast<float>(i) * 0.05F) * 30000.F);
+    }
+    return pcm;
+}
+
+float lerpSample(const std::vector<int16_t> &pcm, uint32_t channels, uint64_t phase, uint32_t channel) {
+    const auto index = static_cast<uint32_t>(phase >> 32);
+    const float t = static_cast<float>(phase & 0xFFFFFFFFULL) / 4294967296.F;
+    const float a = pcm[index * channels + channel];
+    const float b = pcm[(index + 1) * channels + channel];
+    return a + (b - a) * t;
+}
+} // namespace
+
+TEST(AudioMixerTest, kernelsMatchScalar) {
+    // odd frame counts exercise the scalar tails of the SIMD paths
+    constexpr uint32_t frames = 1027;
+    for (uint32_t channels = 1; channels <= 2; ++channels) {
+        const auto pcm = makePcm(frames + 1, channels);
+        std::vector<float> out(frames * 2, 0.5F);
+        if (channels == 1) {
+            AudioMixerKernels::mixMonoI16(out.data(), pcm.data(), frames, GAIN_L, GAIN_R);
+        } else {
+            AudioMixerKernels::mixStereoI16(out.data(), pcm.data(), frames, GAIN_L, GAIN_R);
+        }
+        for (uint32_t i = 0; i < frames; ++i) {
+            EXPECT_NEAR(out[i * 2], 0.5F + pcm[i * channels] * GAIN_L, 1e-5F);
+            EXPECT_NEAR(out[i * 2 + 1], 0.5F + pcm[i * channels + channels - 1] * GAIN_R, 1e-5F);
+        }
+
+        // 44.1kHz source played at 48kHz
+        const uint64_t step = (44100ULL << 32) / SAMPLE_RATE;
+        const uint32_t outFrames = static_cast<uint32_t>((static_cast<uint64_t>(frames - 1) << 32) / step);
+        std::vector<float> resampled(outFrames * 2, 0.F);
+        uint64_t phase = 0;
+        if (channels == 1) {
+            phase = AudioMixerKernels::resampleMixMonoI16(resampled.data(), pcm.data(), outFrames, 0, step, GAIN_L, GAIN_R);
+        } else {
+            phase = AudioMixerKernels::resampleMixStereoI16(resampled.data(), pcm.data(), outFrames, 0, step, GAIN_L, GAIN_R);
+        }
+        EXPECT_EQ(phase, step * outFrames);
+        for (uint32_t i = 0; i < outFrames; ++i) {
+            EXPECT_NEAR(resampled[i * 2], lerpSample(pcm, channels, step * i, 0) * GAIN_L, 1e-4F);
+            EXPECT_NEAR(resampled[i * 2 + 1], lerpSample(pcm, channels, step * i, channels - 1) * GAIN_R, 1e-4F);
+        }
+    }
+
+    const std::vector<float> samples{0.F, 0.5F, -0.5F, 1.F, -1.F, 2.F, -2.F, 0.25F, 1e10F, -1e10F, 0.0001F};
+    std::vector<int16_t> converted(samples.size());
+    AudioMixerKernels::floatToI16(converted.data(), samples.data(), static_cast<uint32_t>(samples.size()));
+    const std::vector<int16_t> expected{0, 16384, -16384, 32767, -32768, 32767, -32768, 8192, 32767, -32768, 3};
+    for (size_t i = 0; i < samples.size(); ++i) {
+        EXPECT_NEAR(converted[i], expected[i], 1);
+    }
+}
+
+TEST(AudioMixerTest, voiceLifetime) {
+    const auto pcm = makePcm(1000, 1);
+    SoftwareMixer mixer(SAMPLE_RATE, 256);
+    const int once = mixer.addVoice(pcm.data(), 1000, 1, SAMPLE_RATE);
+    const int looped = mixer.addVoice(pcm.data(), 1000, 1, SAMPLE_RATE, true);
+    const int slow = mixer.addVoice(pcm.data(), 1000, 1, SAMPLE_RATE / 2);
+    EXPECT_EQ(mixer.addVoice(pcm.data(), 1000, 3, SAMPLE_RATE), SoftwareMixer::INVALID_VOICE_ID);
+    EXPECT_EQ(mixer.getActiveVoiceCount(), 3);
+
+    std::vector<int16_t> out(1500 * SoftwareMixer::OUTPUT_CHANNEL_COUNT);
+    mixer.renderToBuffer(out.data(), 1500);
+    EXPECT_FALSE(mixer.isVoiceActive(once));
+    EXPECT_TRUE(mixer.isVoiceActive(looped));
+    // half the source rate doubles the duration
+    EXPECT_TRUE(mixer.isVoiceActive(slow));
+
+    mixer.renderToBuffer(out.data(), 1500);
+    EXPECT_FALSE(mixer.isVoiceActive(slow));
+    EXPECT_TRUE(mixer.isVoiceActive(looped));
+    EXPECT_EQ(mixer.getActiveVoiceCount(), 1);
+
+    mixer.removeVoice(looped);
+    EXPECT_EQ(mixer.getActiveVoiceCount(), 0);
+    mixer.renderToBuffer(out.data(), 64);
+    for (uint32_t i = 0; i < 128; ++i) {
+        EXPECT_EQ(out[i], 0);
+    }
+
+    // a single voice at unity rate and full volume is rendered bit exact
+    const int exact = mixer.addVoice(pcm.data(), 1000, 1, SAMPLE_RATE);
+    EXPECT_EQ(exact, once);
+    mixer.renderToBuffer(out.data(), 1000);
+    for (uint32_t i = 0; i < 1000; ++i) {
+        EXPECT_EQ(out[i * 2], pcm[i]);
+        EXPECT_EQ(out[i * 2 + 1], pcm[i]);
+    }
+}
+
+// Timing only, run with --gtest_also_run_disabled_tests.
+TEST(AudioMixerTest, DISABLED_offlineThroughput) {
+    constexpr uint32_t voiceCount = 256;
+    constexpr uint32_t renderFrames = SAMPLE_RATE;
+    const auto mono = makePcm(SAMPLE_RATE / 4, 1);
+    const auto stereo = makePcm(SAMPLE_RATE / 4, 2);
+
+    SoftwareMixer mixer(SAMPLE_RATE);
+    for (uint32_t i = 0; i < voiceCount; ++i) {
+        // a quarter of the voices are resampled, the others play at the output rate
+        const bool isMono = i % 2 == 0;
+        const uint32_t rate = i % 4 == 1 ? 44100 : SAMPLE_RATE;
+        const int id = mixer.addVoice(isMono ? mono.data() : stereo.data(), SAMPLE_RATE / 4, isMono ? 1 : 2, rate, true);
+        mixer.setVolume(id, 1.F / voiceCount, 0.5F / voiceCount);
+    }
+
+    std::vector<int16_t> out(renderFrames * SoftwareMixer::OUTPUT_CHANNEL_COUNT);
+    const auto start = Clock::now();
+    mixer.renderToBuffer(out.data(), renderFrames);
+    const double elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    EXPECT_EQ(mixer.getActiveVoiceCount(), voiceCount);
+
+    // how many voices one millisecond of cpu time mixes for one millisecond of output
+    const double audioMs = 1000.0 * renderFrames / SAMPLE_RATE;
+    printf("[AudioMixerTest] %u voices, %.0f ms of audio rendered in %.3f ms, %.1f voices per ms\n",
+           voiceCount, audioMs, elapsedMs, voiceCount * audioMs / elapsedMs);
+}
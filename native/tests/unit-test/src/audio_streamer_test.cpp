@@ -0,0 +1,213 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "audio/include/AudioDef.h"
+
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS || CC_PLATFORM == CC_PLATFORM_OHOS || CC_PLATFORM == CC_PLATFORM_LINUX || CC_PLATFORM == CC_PLATFORM_QNX
+
+    #include <atomic>
+    #include <chrono>
+    #include <cstring>
+    #include <thread>
+    #include <vector>
+    #include "audio/common/decoder/AudioDecoder.h"
+    #include "audio/oalsoft/AudioStreamer.h"
+    #include "gtest/gtest.h"
+
+using namespace cc;
+
+namespace {
+
+constexpr uint32_t CHUNK_FRAMES = 64;
+// Not a multiple of CHUNK_FRAMES, so the last chunk of each pass is partial.
+constexpr uint32_t TOTAL_FRAMES = 1000;
+
+/**
+ * Every frame holds its own index, so the consumer can check continuity. A decoder with a
+ * limit only decodes frames below it, which simulates a decode thread lagging behind playback.
+ */
+class StubDecoder : public AudioDecoder {
+public:
+    explicit StubDecoder(uint32_t limit = TOTAL_FRAMES) : _limit(limit) {
+        _pcmHeader.totalFrames = TOTAL_FRAMES;
+        _pcmHeader.bytesPerFrame = sizeof(uint32_t);
+        _pcmHeader.sampleRate = 44100;
+        _pcmHeader.channelCount = 1;
+        _isOpened = true;
+    }
+
+    bool open(const char * /*path*/) override { return true; }
+    void close() override {}
+
+    uint32_t read(uint32_t framesToRead, char *pcmBuf) override {
+        uint32_t frames = 0;
+        for (; frames < framesToRead && _position < TOTAL_FRAMES; ++frames, ++_position) {
+            while (_position >= _limit.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            memcpy(pcmBuf + frames * sizeof(uint32_t), &_position, sizeof(uint32_t));
+        }
+        return frames;
+    }
+
+    bool seek(uint32_t frameOffset) override {
+        _position = frameOffset;
+        return true;
+    }
+    uint32_t tell() const override { return _position; }
+
+    void release(uint32_t limit) { _limit.store(limit); }
+
+private:
+    uint32_t _position{0};
+    std::atomic<uint32_t> _limit;
+};
+
+// Reads |count| frames, waiting for the decode thread when the ring runs dry like the rotate buffer thread does.
+std::vector<uint32_t> readFrames(AudioStreamer &streamer, AudioStream &stream, uint32_t count) {
+    std::vector<uint32_t> frames;
+    std::vector<uint32_t> chunk(CHUNK_FRAMES);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (frames.size() < count && !stream.isFinished() && std::chrono::steady_clock::now() < deadline) {
+        const uint32_t wanted = std::min<uint32_t>(CHUNK_FRAMES, count - static_cast<uint32_t>(frames.size()));
+        const uint32_t read = stream.read(reinterpret_cast<char *>(chunk.data()), wanted);
+        streamer.notify();
+        if (read == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        frames.insert(frames.end(), chunk.begin(), chunk.begin() + read);
+    }
+    return frames;
+}
+
+} // namespace
+
+TEST(AudioStreamerTest, readsContinuouslyUntilEnd) {
+    AudioStreamer streamer;
+    auto stream = streamer.open(new StubDecoder(), CHUNK_FRAMES, 0, false);
+
+    auto frames = readFrames(streamer, *stream, TOTAL_FRAMES * 2);
+    ASSERT_EQ(frames.size(), TOTAL_FRAMES);
+    for (uint32_t i = 0; i < TOTAL_FRAMES; ++i) {
+        ASSERT_EQ(frames[i], i);
+    }
+    EXPECT_TRUE(stream->isFinished());
+    streamer.close(stream);
+}
+
+TEST(AudioStreamerTest, startsAtStartFrame) {
+    constexpr uint32_t START_FRAME = 3 * CHUNK_FRAMES;
+    AudioStreamer streamer;
+    auto stream = streamer.open(new StubDecoder(), CHUNK_FRAMES, START_FRAME, false);
+
+    auto frames = readFrames(streamer, *stream, TOTAL_FRAMES);
+    ASSERT_EQ(frames.size(), TOTAL_FRAMES - START_FRAME);
+    for (uint32_t i = 0; i < frames.size(); ++i) {
+        ASSERT_EQ(frames[i], START_FRAME + i);
+    }
+    EXPECT_TRUE(stream->isFinished());
+    streamer.close(stream);
+}
+
+TEST(AudioStreamerTest, loopWrapsAroundRing) {
+    AudioStreamer streamer;
+    auto stream = streamer.open(new StubDecoder(), CHUNK_FRAMES, 0, true);
+
+    // Several passes over a file larger than the ring, so both the ring and the file wrap many times.
+    constexpr uint32_t COUNT = TOTAL_FRAMES * 3 + TOTAL_FRAMES / 2;
+    auto frames = readFrames(streamer, *stream, COUNT);
+    ASSERT_EQ(frames.size(), COUNT);
+    for (uint32_t i = 0; i < COUNT; ++i) {
+        ASSERT_EQ(frames[i], i % TOTAL_FRAMES);
+    }
+    EXPECT_FALSE(stream->isFinished());
+
+    // Turning the loop off lets the stream end at the end of the current pass.
+    stream->setLoop(false);
+    frames = readFrames(streamer, *stream, TOTAL_FRAMES * 2);
+    ASSERT_FALSE(frames.empty());
+    EXPECT_EQ(frames.back(), TOTAL_FRAMES - 1);
+    for (uint32_t i = 1; i < frames.size(); ++i) {
+        ASSERT_EQ(frames[i], (frames[i - 1] + 1) % TOTAL_FRAMES);
+    }
+    EXPECT_TRUE(stream->isFinished());
+    streamer.close(stream);
+}
+
+TEST(AudioStreamerTest, seekDiscardsQueuedFrames) {
+    constexpr uint32_t SEEK_FRAME = 700;
+    AudioStreamer streamer;
+    auto stream = streamer.open(new StubDecoder(), CHUNK_FRAMES, 0, false);
+
+    auto frames = readFrames(streamer, *stream, CHUNK_FRAMES);
+    ASSERT_EQ(frames.size(), CHUNK_FRAMES);
+    EXPECT_EQ(frames.back(), CHUNK_FRAMES - 1);
+
+    stream->seek(SEEK_FRAME);
+    streamer.notify();
+    // No frame decoded before the seek is read afterwards.
+    frames = readFrames(streamer, *stream, TOTAL_FRAMES);
+    ASSERT_EQ(frames.size(), TOTAL_FRAMES - SEEK_FRAME);
+    for (uint32_t i = 0; i < frames.size(); ++i) {
+        ASSERT_EQ(frames[i], SEEK_FRAME + i);
+    }
+    EXPECT_TRUE(stream->isFinished());
+
+    // Seeking back after the end restarts the stream.
+    stream->seek(0);
+    EXPECT_FALSE(stream->isFinished());
+    frames = readFrames(streamer, *stream, TOTAL_FRAMES);
+    ASSERT_EQ(frames.size(), TOTAL_FRAMES);
+    EXPECT_EQ(frames.front(), 0);
+    EXPECT_EQ(frames.back(), TOTAL_FRAMES - 1);
+    streamer.close(stream);
+}
+
+TEST(AudioStreamerTest, laggingDecoderIsNotFinished) {
+    constexpr uint32_t LIMIT = 2 * CHUNK_FRAMES;
+    AudioStreamer streamer;
+    auto *decoder = new StubDecoder(LIMIT);
+    auto stream = streamer.open(decoder, CHUNK_FRAMES, 0, false);
+
+    auto frames = readFrames(streamer, *stream, LIMIT);
+    ASSERT_EQ(frames.size(), LIMIT);
+
+    // The ring is dry but the file isn't, the consumer has to keep its buffers and retry.
+    std::vector<uint32_t> chunk(CHUNK_FRAMES);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_EQ(stream->read(reinterpret_cast<char *>(chunk.data()), CHUNK_FRAMES), 0);
+    EXPECT_FALSE(stream->isFinished());
+
+    decoder->release(TOTAL_FRAMES);
+    frames = readFrames(streamer, *stream, TOTAL_FRAMES);
+    ASSERT_EQ(frames.size(), TOTAL_FRAMES - LIMIT);
+    EXPECT_EQ(frames.front(), LIMIT);
+    EXPECT_EQ(frames.back(), TOTAL_FRAMES - 1);
+    EXPECT_TRUE(stream->isFinished());
+    streamer.close(stream);
+}
+
+#endif
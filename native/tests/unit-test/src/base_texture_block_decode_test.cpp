@@ -0,0 +1,668 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <random>
+#include "cocos/base/astc.h"
+#include "cocos/base/etc2.h"
+#include "cocos/base/std/container/vector.h"
+#include "cocos/platform/FileUtils.h"
+#include "cocos/platform/TextureTranscoder.h"
+#include "gtest/gtest.h"
+
+using cc::TextureTranscoder;
+
+namespace {
+
+constexpr uint8_t MAGENTA[4] = {0xFF, 0x00, 0xFF, 0xFF};
+
+// ASTC blocks are little endian bit streams, weights are written from the top bit down.
+struct AstcBlockWriter {
+    uint8_t bytes[16]{};
+
+    void write(int pos, uint32_t value, int count) {
+        for (int i = 0; i < count; ++i) {
+            setBit(pos + i, (value >> i) & 1);
+        }
+    }
+
+    void writeReversed(int pos, uint32_t value, int count) {
+        for (int i = 0; i < count; ++i) {
+            setBit(127 - (pos + i), (value >> i) & 1);
+        }
+    }
+
+    void setBit(int pos, uint32_t bit) {
+        if (bit) {
+            bytes[pos / 8] |= static_cast<uint8_t>(1U << (pos % 8));
+        }
+    }
+};
+
+// ETC blocks are big endian 64 bit words.
+void storeBE64(uint64_t value, uint8_t *out) {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (56 - i * 8));
+    }
+}
+
+constexpr int ETC2_DISTANCES[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+// Fills the unused bits of a differential mode block so that the channels before `overflow` stay in range
+// and channel `overflow` leaves it: red selects T mode, green H mode and blue planar mode.
+bool selectEtc2Mode(uint64_t *bits, std::initializer_list<int> freeBits, int overflow) {
+    for (uint32_t combination = 0; combination < (1U << freeBits.size()); ++combination) {
+        uint64_t candidate = *bits;
+        int i = 0;
+        for (int bit : freeBits) {
+            candidate |= static_cast<uint64_t>((combination >> i++) & 1) << bit;
+        }
+        auto inRange = [&](int c) {
+            const int color = static_cast<int>((candidate >> (59 - c * 8)) & 0x1F);
+            const int delta = static_cast<int>((candidate >> (56 - c * 8)) & 7);
+            const int sum = color + (delta >= 4 ? delta - 8 : delta);
+            return sum >= 0 && sum <= 31;
+        };
+        bool selected = !inRange(overflow);
+        for (int c = 0; c < overflow; ++c) {
+            selected = selected && inRange(c);
+        }
+        if (selected) {
+            *bits = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 2 bit pixel indices in the same layout as ETC1, pixels are numbered column first.
+uint64_t etcPixelIndices(const uint32_t indices[16]) {
+    uint64_t bits = 0;
+    for (int i = 0; i < 16; ++i) {
+        bits |= static_cast<uint64_t>(indices[i] >> 1) << (i + 16);
+        bits |= static_cast<uint64_t>(indices[i] & 1) << i;
+    }
+    return bits;
+}
+
+// Checks a T or H mode block against its four paint colors.
+void expectPaintColors(const uint8_t *pixels, const uint32_t indices[16], const int paint[4][3]) {
+    for (int x = 0; x < 4; ++x) {
+        for (int y = 0; y < 4; ++y) {
+            const uint8_t *pixel = pixels + (y * 4 + x) * 4;
+            for (int c = 0; c < 3; ++c) {
+                EXPECT_EQ(pixel[c], std::min(255, std::max(0, paint[indices[x * 4 + y]][c]))) << x << "," << y << " channel " << c;
+            }
+            EXPECT_EQ(pixel[3], 255);
+        }
+    }
+}
+
+uint8_t lerpUnorm(uint8_t c0, uint8_t c1, uint32_t w) {
+    const uint32_t e0 = c0 * 257U;
+    const uint32_t e1 = c1 * 257U;
+    return static_cast<uint8_t>(((e0 * (64 - w) + e1 * w + 32) >> 6) >> 8);
+}
+
+// 2 bit weights of a 4x4 grid are bit replicated to 6 bits and 63 maps to 64.
+uint32_t unquantize2BitWeight(uint32_t q) {
+    const uint32_t w = (q << 4) | (q << 2) | q;
+    return w > 32 ? w + 1 : w;
+}
+
+// A single partition block with a 4x4 grid of 2 bit weights and RGBA direct endpoints (CEM 12),
+// the endpoints fit in 8 bits so they are stored unquantized.
+void writeRGBADirectBlock(const uint8_t e0[4], const uint8_t e1[4], const uint8_t weights[16], uint8_t *out) {
+    AstcBlockWriter writer;
+    writer.write(0, 2 | (2 << 5), 11); // 4x4 grid, QUANT_4, single plane
+    writer.write(11, 0, 2);           // one partition
+    writer.write(13, 12, 4);          // CEM 12
+    for (int c = 0; c < 4; ++c) {
+        writer.write(17 + c * 16, e0[c], 8);
+        writer.write(17 + c * 16 + 8, e1[c], 8);
+    }
+    for (int i = 0; i < 16; ++i) {
+        writer.writeReversed(i * 2, weights[i], 2);
+    }
+    memcpy(out, writer.bytes, 16);
+}
+
+} // namespace
+
+TEST(TextureBlockDecodeTest, etc1IndividualMode) {
+    const uint32_t base1[3] = {0xA, 0x5, 0x3};
+    const uint32_t base2[3] = {0x1, 0xF, 0x8};
+    const int table1[4] = {9, 29, -9, -29};
+    const int table2[4] = {24, 80, -24, -80};
+    uint64_t bits = 0;
+    for (int c = 0; c < 3; ++c) {
+        bits |= static_cast<uint64_t>(base1[c]) << (60 - c * 8);
+        bits |= static_cast<uint64_t>(base2[c]) << (56 - c * 8);
+    }
+    bits |= 2ULL << 37; // codeword 1
+    bits |= 5ULL << 34; // codeword 2
+    for (int x = 0; x < 4; ++x) {
+        for (int y = 0; y < 4; ++y) {
+            const uint32_t index = (x + 3 * y) & 3;
+            bits |= static_cast<uint64_t>(index >> 1) << (x * 4 + y + 16);
+            bits |= static_cast<uint64_t>(index & 1) << (x * 4 + y);
+        }
+    }
+    uint8_t block[8];
+    storeBE64(bits, block);
+    uint8_t pixels[4 * 4 * 4];
+    etc2_decode_block_rgb(block, pixels, 16);
+
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            const uint32_t index = (x + 3 * y) & 3;
+            const uint32_t *base = x < 2 ? base1 : base2;
+            const int modifier = (x < 2 ? table1 : table2)[index];
+            for (int c = 0; c < 3; ++c) {
+                const int expected = std::min(255, std::max(0, static_cast<int>(base[c] * 17) + modifier));
+                EXPECT_EQ(pixels[(y * 4 + x) * 4 + c], expected) << x << "," << y;
+            }
+            EXPECT_EQ(pixels[(y * 4 + x) * 4 + 3], 255);
+        }
+    }
+}
+
+TEST(TextureBlockDecodeTest, etc2PlanarMode) {
+    // 6/7/6 bit origin, horizontal and vertical colors
+    const uint32_t o[3] = {20, 100, 40};
+    const uint32_t h[3] = {60, 10, 40};
+    const uint32_t v[3] = {0, 127, 63};
+    uint64_t bits = 1ULL << 33;
+    bits |= static_cast<uint64_t>(o[0]) << 57;
+    bits |= static_cast<uint64_t>(o[1] >> 6) << 56 | static_cast<uint64_t>(o[1] & 0x3F) << 49;
+    bits |= static_cast<uint64_t>(o[2] >> 5) << 48 | static_cast<uint64_t>((o[2] >> 3) & 3) << 43 | static_cast<uint64_t>(o[2] & 7) << 39;
+    bits |= static_cast<uint64_t>(h[0] >> 1) << 34 | static_cast<uint64_t>(h[0] & 1) << 32;
+    bits |= static_cast<uint64_t>(h[1]) << 25 | static_cast<uint64_t>(h[2]) << 19;
+    bits |= static_cast<uint64_t>(v[0]) << 13 | static_cast<uint64_t>(v[1]) << 6 | static_cast<uint64_t>(v[2]);
+
+    // the unused bits select planar mode: red and green differential colors stay in range, blue overflows
+    const int freeBits[] = {63, 55, 47, 46, 45, 42};
+    bool found = false;
+    for (uint32_t combination = 0; combination < 64 && !found; ++combination) {
+        uint64_t candidate = bits;
+        for (int i = 0; i < 6; ++i) {
+            candidate |= static_cast<uint64_t>((combination >> i) & 1) << freeBits[i];
+        }
+        auto inRange = [&](int c) {
+            const int color = static_cast<int>((candidate >> (59 - c * 8)) & 0x1F);
+            const int delta = static_cast<int>((candidate >> (56 - c * 8)) & 7);
+            const int sum = color + (delta >= 4 ? delta - 8 : delta);
+            return sum >= 0 && sum <= 31;
+        };
+        if (inRange(0) && inRange(1) && !inRange(2)) {
+            bits = candidate;
+            found = true;
+        }
+    }
+    ASSERT_TRUE(found);
+
+    uint8_t block[8];
+    storeBE64(bits, block);
+    uint8_t pixels[4 * 4 * 4];
+    etc2_decode_block_rgb(block, pixels, 16);
+
+    const int bitCount[3] = {6, 7, 6};
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            for (int c = 0; c < 3; ++c) {
+                auto extend = [&](uint32_t value) { return static_cast<int>((value << (8 - bitCount[c])) | (value >> (2 * bitCount[c] - 8))); };
+                const int expected = (x * (extend(h[c]) - extend(o[c])) + y * (extend(v[c]) - extend(o[c])) + 4 * extend(o[c]) + 2) >> 2;
+                EXPECT_EQ(pixels[(y * 4 + x) * 4 + c], std::min(255, std::max(0, expected))) << x << "," << y << " channel " << c;
+            }
+        }
+    }
+}
+
+TEST(TextureBlockDecodeTest, etc2TMode) {
+    // 4 bit colors, the red of the first one is split around a free bit
+    const int c1[3] = {0xE, 0x3, 0x9};
+    const int c2[3] = {0x1, 0xC, 0xF};
+    const uint32_t distance = 5;
+    uint32_t indices[16];
+    for (uint32_t i = 0; i < 16; ++i) {
+        indices[i] = (i * 3 + i / 4) & 3;
+    }
+    uint64_t bits = 1ULL << 33 | etcPixelIndices(indices);
+    bits |= static_cast<uint64_t>(c1[0] >> 2) << 59 | static_cast<uint64_t>(c1[0] & 3) << 56;
+    bits |= static_cast<uint64_t>(c1[1]) << 52 | static_cast<uint64_t>(c1[2]) << 48;
+    bits |= static_cast<uint64_t>(c2[0]) << 44 | static_cast<uint64_t>(c2[1]) << 40 | static_cast<uint64_t>(c2[2]) << 36;
+    bits |= static_cast<uint64_t>(distance >> 1) << 34 | static_cast<uint64_t>(distance & 1) << 32;
+    ASSERT_TRUE(selectEtc2Mode(&bits, {63, 62, 61, 58}, 0));
+
+    uint8_t block[8];
+    storeBE64(bits, block);
+    uint8_t pixels[4 * 4 * 4];
+    etc2_decode_block_rgb(block, pixels, 16);
+
+    // the first color as is, the second one moved by the distance both ways; red and blue clamp
+    const int d = ETC2_DISTANCES[distance];
+    int paint[4][3];
+    for (int c = 0; c < 3; ++c) {
+        paint[0][c] = c1[c] * 17;
+        paint[1][c] = c2[c] * 17 + d;
+        paint[2][c] = c2[c] * 17;
+        paint[3][c] = c2[c] * 17 - d;
+    }
+    expectPaintColors(pixels, indices, paint);
+}
+
+TEST(TextureBlockDecodeTest, etc2HMode) {
+    struct Case {
+        int c1[3];
+        int c2[3];
+        uint32_t distance;
+    };
+    // the lowest bit of the distance isn't stored, it is whether the first color is the larger one
+    const Case cases[] = {
+        {{0x9, 0x5, 0xB}, {0x3, 0xE, 0x1}, 7},
+        {{0x1, 0xA, 0x6}, {0xC, 0x0, 0xF}, 2},
+    };
+    for (const auto &test : cases) {
+        const int v1 = test.c1[0] << 8 | test.c1[1] << 4 | test.c1[2];
+        const int v2 = test.c2[0] << 8 | test.c2[1] << 4 | test.c2[2];
+        ASSERT_EQ(static_cast<uint32_t>(v1 >= v2), test.distance & 1);
+
+        uint32_t indices[16];
+        for (uint32_t i = 0; i < 16; ++i) {
+            indices[i] = (i * 5 + test.distance) & 3;
+        }
+        uint64_t bits = 1ULL << 33 | etcPixelIndices(indices);
+        bits |= static_cast<uint64_t>(test.c1[0]) << 59;
+        bits |= static_cast<uint64_t>(test.c1[1] >> 1) << 56 | static_cast<uint64_t>(test.c1[1] & 1) << 52;
+        bits |= static_cast<uint64_t>(test.c1[2] >> 3) << 51 | static_cast<uint64_t>(test.c1[2] & 7) << 47;
+        bits |= static_cast<uint64_t>(test.c2[0]) << 43 | static_cast<uint64_t>(test.c2[1]) << 39 | static_cast<uint64_t>(test.c2[2]) << 35;
+        bits |= static_cast<uint64_t>(test.distance >> 2) << 34 | static_cast<uint64_t>((test.distance >> 1) & 1) << 32;
+        ASSERT_TRUE(selectEtc2Mode(&bits, {63, 55, 54, 53, 50}, 1));
+
+        uint8_t block[8];
+        storeBE64(bits, block);
+        uint8_t pixels[4 * 4 * 4];
+        etc2_decode_block_rgb(block, pixels, 16);
+
+        // both colors moved by the distance both ways
+        const int d = ETC2_DISTANCES[test.distance];
+        int paint[4][3];
+        for (int c = 0; c < 3; ++c) {
+            paint[0][c] = test.c1[c] * 17 + d;
+            paint[1][c] = test.c1[c] * 17 - d;
+            paint[2][c] = test.c2[c] * 17 + d;
+            paint[3][c] = test.c2[c] * 17 - d;
+        }
+        expectPaintColors(pixels, indices, paint);
+    }
+}
+
+TEST(TextureBlockDecodeTest, eacAlpha) {
+    const int modifiers[8] = {-2, -5, -7, -10, 1, 4, 6, 9}; // table 11
+    const uint64_t base = 250;
+    const uint64_t multiplier = 3;
+    uint64_t bits = base << 56 | multiplier << 52 | 11ULL << 48;
+    for (int i = 0; i < 16; ++i) {
+        bits |= static_cast<uint64_t>(i & 7) << (45 - i * 3);
+    }
+    uint8_t block[8];
+    storeBE64(bits, block);
+    uint8_t pixels[4 * 4 * 4] = {};
+    etc2_decode_block_alpha(block, pixels, 16);
+    for (int x = 0; x < 4; ++x) {
+        for (int y = 0; y < 4; ++y) {
+            const int expected = std::min(255, std::max(0, static_cast<int>(base) + modifiers[(x * 4 + y) & 7] * static_cast<int>(multiplier)));
+            EXPECT_EQ(pixels[(y * 4 + x) * 4 + 3], expected);
+            EXPECT_EQ(pixels[(y * 4 + x) * 4], 0);
+        }
+    }
+}
+
+TEST(TextureBlockDecodeTest, astcVoidExtent) {
+    AstcBlockWriter writer;
+    writer.write(0, 0x1FC, 9);
+    writer.write(10, 3, 2);
+    for (int i = 12; i < 64; ++i) {
+        writer.setBit(i, 1);
+    }
+    const uint32_t color[4] = {0x1234, 0xFFFF, 0x0000, 0x80FF};
+    for (int c = 0; c < 4; ++c) {
+        writer.write(64 + c * 16, color[c], 16);
+    }
+    uint8_t pixels[6 * 6 * 4];
+    EXPECT_TRUE(astcDecodeBlock(writer.bytes, 6, 6, false, pixels, 6 * 4));
+    for (int i = 0; i < 36; ++i) {
+        EXPECT_EQ(pixels[i * 4 + 0], 0x12);
+        EXPECT_EQ(pixels[i * 4 + 1], 0xFF);
+        EXPECT_EQ(pixels[i * 4 + 2], 0x00);
+        EXPECT_EQ(pixels[i * 4 + 3], 0x80);
+    }
+}
+
+TEST(TextureBlockDecodeTest, astcReservedBlockIsError) {
+    const uint8_t block[16] = {};
+    uint8_t pixels[4 * 4 * 4];
+    EXPECT_FALSE(astcDecodeBlock(block, 4, 4, false, pixels, 16));
+    for (int i = 0; i < 16; ++i) {
+        EXPECT_EQ(0, memcmp(pixels + i * 4, MAGENTA, 4));
+    }
+}
+
+TEST(TextureBlockDecodeTest, astcDirectEndpoints) {
+    const uint8_t e0[4] = {10, 200, 30, 255};
+    const uint8_t e1[4] = {250, 20, 90, 7};
+    uint8_t weights[16];
+    for (int i = 0; i < 16; ++i) {
+        weights[i] = static_cast<uint8_t>((i * 7 + 1) & 3);
+    }
+    uint8_t block[16];
+    writeRGBADirectBlock(e0, e1, weights, block);
+
+    uint8_t pixels[4 * 4 * 4];
+    ASSERT_TRUE(astcDecodeBlock(block, 4, 4, false, pixels, 16));
+    for (int i = 0; i < 16; ++i) {
+        const uint32_t w = unquantize2BitWeight(weights[i]);
+        for (int c = 0; c < 4; ++c) {
+            EXPECT_EQ(pixels[i * 4 + c], lerpUnorm(e0[c], e1[c], w)) << "texel " << i << " channel " << c;
+        }
+    }
+}
+
+TEST(TextureBlockDecodeTest, astcTritWeights) {
+    // 4x4 grid of 3 level weights (0, 32, 64); five trits per 8 bit group
+    AstcBlockWriter writer;
+    writer.write(0, 1 | (1 << 4) | (2 << 5), 11);
+    writer.write(13, 12, 4);
+    const uint8_t e0[4] = {0, 64, 128, 255};
+    const uint8_t e1[4] = {255, 192, 128, 0};
+    for (int c = 0; c < 4; ++c) {
+        writer.write(17 + c * 16, e0[c], 8);
+        writer.write(17 + c * 16 + 8, e1[c], 8);
+    }
+    // trits 2 and 4 of a group stay below 2, which keeps the packed byte a plain bit concatenation
+    uint8_t trits[16];
+    for (int i = 0; i < 16; ++i) {
+        trits[i] = static_cast<uint8_t>((i % 5 == 2 || i % 5 == 4) ? (i & 1) : (i % 3));
+    }
+    const int shifts[5] = {0, 2, 4, 5, 7};
+    int pos = 0;
+    for (int group = 0; group < 16; group += 5) {
+        uint32_t packed = 0;
+        for (int j = 0; j < 5 && group + j < 16; ++j) {
+            packed |= static_cast<uint32_t>(trits[group + j]) << shifts[j];
+        }
+        const int bits = std::min(8, (8 * (16 - group) + 4) / 5);
+        writer.writeReversed(pos, packed, bits);
+        pos += bits;
+    }
+
+    uint8_t pixels[4 * 4 * 4];
+    ASSERT_TRUE(astcDecodeBlock(writer.bytes, 4, 4, false, pixels, 16));
+    const uint32_t levels[3] = {0, 32, 64};
+    for (int i = 0; i < 16; ++i) {
+        for (int c = 0; c < 4; ++c) {
+            EXPECT_EQ(pixels[i * 4 + c], lerpUnorm(e0[c], e1[c], levels[trits[i]])) << "texel " << i << " channel " << c;
+        }
+    }
+}
+
+TEST(TextureBlockDecodeTest, astcTwoPartitions) {
+    // both partitions share their endpoints, so the pattern doesn't show; 16 values leave room for 4 bit endpoints
+    AstcBlockWriter writer;
+    writer.write(0, 2 | (2 << 5), 11);
+    writer.write(11, 1, 2);
+    writer.write(13, 0x2A5, 10); // partition pattern
+    writer.write(23, 12 << 2, 6);  // shared CEM 12
+    const uint8_t e0[4] = {3, 9, 1, 15};
+    const uint8_t e1[4] = {12, 14, 6, 2};
+    for (int p = 0; p < 2; ++p) {
+        for (int c = 0; c < 4; ++c) {
+            writer.write(29 + p * 32 + c * 8, e0[c], 4);
+            writer.write(29 + p * 32 + c * 8 + 4, e1[c], 4);
+        }
+    }
+    uint8_t weights[16];
+    for (int i = 0; i < 16; ++i) {
+        weights[i] = static_cast<uint8_t>((i * 5 + 2) & 3);
+        writer.writeReversed(i * 2, weights[i], 2);
+    }
+
+    uint8_t pixels[4 * 4 * 4];
+    ASSERT_TRUE(astcDecodeBlock(writer.bytes, 4, 4, false, pixels, 16));
+    for (int i = 0; i < 16; ++i) {
+        const uint32_t w = unquantize2BitWeight(weights[i]);
+        for (int c = 0; c < 4; ++c) {
+            EXPECT_EQ(pixels[i * 4 + c], lerpUnorm(e0[c] * 17, e1[c] * 17, w)) << "texel " << i << " channel " << c;
+        }
+    }
+}
+
+TEST(TextureBlockDecodeTest, astcDualPlane) {
+    // luminance + alpha direct endpoints (CEM 4), the second plane of weights drives the selected channel
+    const uint8_t l0 = 40;
+    const uint8_t l1 = 220;
+    const uint8_t a0 = 250;
+    const uint8_t a1 = 10;
+    const uint8_t e0[4] = {l0, l0, l0, a0};
+    const uint8_t e1[4] = {l1, l1, l1, a1};
+    for (uint32_t component = 0; component < 4; ++component) {
+        AstcBlockWriter writer;
+        writer.write(0, 2 | (2 << 5) | (1 << 10), 11); // 4x4 grid, QUANT_4, dual plane
+        writer.write(13, 4, 4);
+        writer.write(17, l0, 8);
+        writer.write(25, l1, 8);
+        writer.write(33, a0, 8);
+        writer.write(41, a1, 8);
+        // the weights of both planes are interleaved per texel, the selector sits right below them
+        uint8_t weights[2][16];
+        for (int i = 0; i < 16; ++i) {
+            weights[0][i] = static_cast<uint8_t>((i * 3 + 1) & 3);
+            weights[1][i] = static_cast<uint8_t>((i * 7 + 2) & 3);
+            writer.writeReversed(i * 4, weights[0][i], 2);
+            writer.writeReversed(i * 4 + 2, weights[1][i], 2);
+        }
+        writer.write(128 - 64 - 2, component, 2);
+
+        uint8_t pixels[4 * 4 * 4];
+        ASSERT_TRUE(astcDecodeBlock(writer.bytes, 4, 4, false, pixels, 16));
+        for (int i = 0; i < 16; ++i) {
+            for (uint32_t c = 0; c < 4; ++c) {
+                const uint32_t w = unquantize2BitWeight(weights[c == component ? 1 : 0][i]);
+                EXPECT_EQ(pixels[i * 4 + c], lerpUnorm(e0[c], e1[c], w)) << "component " << component << " texel " << i << " channel " << c;
+            }
+        }
+    }
+}
+
+TEST(TextureBlockDecodeTest, transcodeLevelMatchesBlocks) {
+    // 6x6 blocks with partial blocks on the right and bottom edges
+    const uint32_t width = 250;
+    const uint32_t height = 130;
+    const uint32_t blocksX = (width + 5) / 6;
+    const uint32_t blocksY = (height + 5) / 6;
+    std::mt19937 rng(7);
+    ccstd::vector<uint8_t> data(blocksX * blocksY * 16);
+    for (uint32_t i = 0; i < blocksX * blocksY; ++i) {
+        uint8_t e0[4];
+        uint8_t e1[4];
+        uint8_t weights[16];
+        for (int c = 0; c < 4; ++c) {
+            e0[c] = static_cast<uint8_t>(rng());
+            e1[c] = static_cast<uint8_t>(rng());
+        }
+        for (auto &w : weights) {
+            w = static_cast<uint8_t>(rng() & 3);
+        }
+        writeRGBADirectBlock(e0, e1, weights, data.data() + i * 16);
+    }
+
+    ccstd::vector<uint8_t> rgba(width * height * 4);
+    ASSERT_TRUE(TextureTranscoder::decodeLevel(data.data(), static_cast<uint32_t>(data.size()), width, height, cc::gfx::Format::ASTC_RGBA_6X6, rgba.data()));
+    EXPECT_FALSE(TextureTranscoder::decodeLevel(data.data(), static_cast<uint32_t>(data.size()) - 1, width, height, cc::gfx::Format::ASTC_RGBA_6X6, rgba.data()));
+
+    uint8_t tile[6 * 6 * 4];
+    for (uint32_t by = 0; by < blocksY; ++by) {
+        for (uint32_t bx = 0; bx < blocksX; ++bx) {
+            astcDecodeBlock(data.data() + (by * blocksX + bx) * 16, 6, 6, false, tile, 6 * 4);
+            for (uint32_t y = by * 6; y < std::min(height, by * 6 + 6); ++y) {
+                for (uint32_t x = bx * 6; x < std::min(width, bx * 6 + 6); ++x) {
+                    ASSERT_EQ(0, memcmp(rgba.data() + (y * width + x) * 4, tile + ((y - by * 6) * 6 + (x - bx * 6)) * 4, 4)) << x << "," << y;
+                }
+            }
+        }
+    }
+
+    ccstd::vector<uint32_t> levelDataSize;
+    uint8_t *levels = TextureTranscoder::transcode(data.data(), static_cast<uint32_t>(data.size()), width, height, cc::gfx::Format::ASTC_RGBA_6X6, {}, &levelDataSize);
+    ASSERT_NE(levels, nullptr);
+    ASSERT_EQ(levelDataSize.size(), 1U);
+    EXPECT_EQ(levelDataSize[0], width * height * 4);
+    EXPECT_EQ(0, memcmp(levels, rgba.data(), rgba.size()));
+    free(levels);
+    EXPECT_EQ(TextureTranscoder::getTranscodedFormat(cc::gfx::Format::ASTC_SRGBA_6X6), cc::gfx::Format::SRGB8_A8);
+    EXPECT_EQ(TextureTranscoder::getTranscodedFormat(cc::gfx::Format::ETC2_RGBA8), cc::gfx::Format::RGBA8);
+    EXPECT_EQ(TextureTranscoder::getTranscodedFormat(cc::gfx::Format::PVRTC_RGBA4), cc::gfx::Format::UNKNOWN);
+}
+
+TEST(TextureBlockDecodeTest, transcodeCacheRoundTrip) {
+    std::unique_ptr<cc::FileUtils> ownedFileUtils;
+    if (!cc::FileUtils::getInstance()) {
+        ownedFileUtils.reset(cc::createFileUtils());
+    }
+    auto *fileUtils = cc::FileUtils::getInstance();
+    const ccstd::string dir = fileUtils->getWritablePath() + "transcode-cache-test/";
+    fileUtils->removeDirectory(dir);
+
+    // two levels of a 8x8 ASTC 4x4 texture
+    std::mt19937 rng(3);
+    ccstd::vector<uint8_t> data(5 * 16);
+    for (uint32_t i = 0; i < 5; ++i) {
+        uint8_t e0[4];
+        uint8_t e1[4];
+        uint8_t weights[16];
+        for (int c = 0; c < 4; ++c) {
+            e0[c] = static_cast<uint8_t>(rng());
+            e1[c] = static_cast<uint8_t>(rng());
+        }
+        for (auto &w : weights) {
+            w = static_cast<uint8_t>(rng() & 3);
+        }
+        writeRGBADirectBlock(e0, e1, weights, data.data() + i * 16);
+    }
+    const ccstd::vector<uint32_t> levels{4 * 16, 16};
+    const ccstd::vector<uint32_t> rgbaLevels{8 * 8 * 4, 4 * 4 * 4};
+    const auto format = cc::gfx::Format::ASTC_RGBA_4X4;
+
+    TextureTranscoder::setCacheDirectory(dir.substr(0, dir.size() - 1));
+    EXPECT_EQ(TextureTranscoder::getCacheDirectory(), dir);
+    ASSERT_TRUE(fileUtils->isDirectoryExist(dir));
+
+    ccstd::vector<uint32_t> levelDataSize;
+    uint8_t *decoded = TextureTranscoder::transcode(data.data(), static_cast<uint32_t>(data.size()), 8, 8, format, levels, &levelDataSize);
+    ASSERT_NE(decoded, nullptr);
+    EXPECT_EQ(levelDataSize, rgbaLevels);
+    const ccstd::vector<uint8_t> expected(decoded, decoded + rgbaLevels[0] + rgbaLevels[1]);
+    free(decoded);
+
+    // the result was written to the cache
+    const auto files = fileUtils->listFiles(dir);
+    ccstd::string cachePath;
+    for (const auto &file : files) {
+        if (fileUtils->isFileExist(file)) {
+            EXPECT_TRUE(cachePath.empty());
+            cachePath = file;
+        }
+    }
+    ASSERT_FALSE(cachePath.empty());
+    cc::Data cached = fileUtils->getDataFromFile(cachePath);
+    ASSERT_GT(cached.getSize(), expected.size());
+    const uint32_t headerSize = cached.getSize() - static_cast<uint32_t>(expected.size());
+    EXPECT_EQ(0, memcmp(cached.getBytes() + headerSize, expected.data(), expected.size()));
+
+    // a marked pixel in the file comes back, so the second transcode read the cache instead of decoding
+    ccstd::vector<uint8_t> marked(cached.getBytes(), cached.getBytes() + cached.getSize());
+    marked.back() ^= 0xFF;
+    cc::Data markedData;
+    markedData.copy(marked.data(), static_cast<uint32_t>(marked.size()));
+    ASSERT_TRUE(fileUtils->writeDataToFile(markedData, cachePath));
+    levelDataSize.clear();
+    decoded = TextureTranscoder::transcode(data.data(), static_cast<uint32_t>(data.size()), 8, 8, format, levels, &levelDataSize);
+    ASSERT_NE(decoded, nullptr);
+    EXPECT_EQ(levelDataSize, rgbaLevels);
+    EXPECT_EQ(0, memcmp(decoded, marked.data() + headerSize, expected.size()));
+    free(decoded);
+
+    // a truncated file is ignored and replaced
+    cc::Data truncated;
+    truncated.copy(marked.data(), static_cast<uint32_t>(marked.size() - 1));
+    ASSERT_TRUE(fileUtils->writeDataToFile(truncated, cachePath));
+    decoded = TextureTranscoder::transcode(data.data(), static_cast<uint32_t>(data.size()), 8, 8, format, levels, &levelDataSize);
+    ASSERT_NE(decoded, nullptr);
+    EXPECT_EQ(0, memcmp(decoded, expected.data(), expected.size()));
+    free(decoded);
+    EXPECT_EQ(fileUtils->getDataFromFile(cachePath).getSize(), cached.getSize());
+
+    // other data of the same size gets its own entry
+    data[0] ^= 1;
+    decoded = TextureTranscoder::transcode(data.data(), static_cast<uint32_t>(data.size()), 8, 8, format, levels, &levelDataSize);
+    ASSERT_NE(decoded, nullptr);
+    free(decoded);
+    EXPECT_EQ(fileUtils->listFiles(dir).size(), files.size() + 1);
+
+    TextureTranscoder::setCacheDirectory("");
+    EXPECT_TRUE(TextureTranscoder::getCacheDirectory().empty());
+    fileUtils->removeDirectory(dir);
+}
+
+// Timing only, run with --gtest_also_run_disabled_tests.
+TEST(TextureBlockDecodeTest, DISABLED_transcode4KAstc6x6) {
+    const uint32_t size = 4096;
+    const uint32_t blocks = (size + 5) / 6;
+    std::mt19937 rng(11);
+    ccstd::vector<uint8_t> data(blocks * blocks * 16);
+    for (uint32_t i = 0; i < blocks * blocks; ++i) {
+        uint8_t e0[4];
+        uint8_t e1[4];
+        uint8_t weights[16];
+        for (int c = 0; c < 4; ++c) {
+            e0[c] = static_cast<uint8_t>(rng());
+            e1[c] = static_cast<uint8_t>(rng());
+        }
+        for (auto &w : weights) {
+            w = static_cast<uint8_t>(rng() & 3);
+        }
+        writeRGBADirectBlock(e0, e1, weights, data.data() + i * 16);
+    }
+
+    ccstd::vector<uint8_t> rgba(size * size * 4);
+    const auto begin = std::chrono::steady_clock::now();
+    ASSERT_TRUE(TextureTranscoder::decodeLevel(data.data(), static_cast<uint32_t>(data.size()), size, size, cc::gfx::Format::ASTC_RGBA_6X6, rgba.data()));
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    printf("ASTC 6x6 %ux%u: %.1f ms, %.1f Mpixel/s\n", size, size, seconds * 1000.0, size * size / seconds / 1e6);
+}
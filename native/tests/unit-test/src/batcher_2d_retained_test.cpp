@@ -0,0 +1,316 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <memory>
+#include "2d/renderer/Batcher2d.h"
+#include "2d/renderer/RenderDrawInfo.h"
+#include "2d/renderer/RenderEntity.h"
+#include "2d/renderer/UIMeshBuffer.h"
+#include "base/std/container/array.h"
+#include "base/std/container/vector.h"
+#include "bindings/jswrapper/SeApi.h"
+#include "core/Root.h"
+#include "core/assets/Material.h"
+#include "core/scene-graph/Scene.h"
+#include "gtest/gtest.h"
+#include "renderer/GFXDeviceManager.h"
+#include "renderer/core/ProgramLib.h"
+#include "scene/DrawBatch2D.h"
+#include "scene/Pass.h"
+#include "scene/RenderScene.h"
+
+using namespace cc;
+
+namespace {
+constexpr uint32_t ROOT_COUNT = 2;
+constexpr uint32_t SPRITES_PER_ROOT = 12;
+constexpr uint32_t SPRITE_COUNT = ROOT_COUNT * SPRITES_PER_ROOT;
+constexpr uint32_t FRAME_COUNT = 8;
+constexpr uint32_t QUAD_VERTEX_COUNT = 4;
+constexpr uint32_t QUAD_INDEX_COUNT = 6;
+// xyz, uv and rgba
+constexpr uint8_t STRIDE = 9;
+constexpr uint32_t LAYER_2D = 1U << 25;
+constexpr uint32_t LAYER_3D = 1U << 23;
+const char *const PROGRAM_NAME = "batcher-2d-retained-test";
+
+class SpritePass final : public scene::Pass {
+public:
+    SpritePass(Root *root, gfx::Shader *shader, gfx::DescriptorSet *descriptorSet, ccstd::hash_t hash) : Pass(root) {
+        _programName = PROGRAM_NAME;
+        _phaseID = 0;
+        _shader = shader;
+        _descriptorSet = descriptorSet;
+        _hash = hash;
+    }
+};
+
+class SpriteMaterial final : public Material {
+public:
+    SpriteMaterial(scene::Pass *pass, ccstd::hash_t hash) {
+        _passes->emplace_back(pass);
+        _hash = hash;
+    }
+};
+
+EntityAttrLayout *getEntityAttrs(RenderEntity *entity) {
+    // the attributes are written through the buffer shared with the script side
+    uint8_t *data = nullptr;
+    size_t length = 0;
+    entity->getEntitySharedBufferForJS()->getArrayBufferData(&data, &length);
+    return reinterpret_cast<EntityAttrLayout *>(data);
+}
+
+// Two canvases of sprites sharing one mesh buffer, batched by its own Batcher2d.
+struct SpriteWorld {
+    IntrusivePtr<Scene> scene;
+    ccstd::vector<IntrusivePtr<Node>> roots;
+    ccstd::vector<IntrusivePtr<Node>> sprites;
+    // owned by the sprite nodes
+    ccstd::vector<RenderEntity *> entities;
+    ccstd::vector<ccstd::vector<float>> localVertices;
+    ccstd::vector<ccstd::array<uint16_t, QUAD_INDEX_COUNT>> indices;
+    ccstd::vector<float> vData;
+    ccstd::vector<uint16_t> iData;
+    UIMeshBuffer meshBuffer;
+    Batcher2d batcher;
+
+    SpriteWorld(Root *root, Material *material)
+    : localVertices(SPRITE_COUNT),
+      indices(SPRITE_COUNT),
+      vData(SPRITE_COUNT * QUAD_VERTEX_COUNT * STRIDE),
+      iData(SPRITE_COUNT * QUAD_INDEX_COUNT),
+      batcher(root) {
+        meshBuffer.initialize(ccstd::vector<gfx::Attribute>(*batcher.getDefaultAttribute()), true);
+        meshBuffer.setVData(vData.data());
+        meshBuffer.setIData(iData.data());
+        meshBuffer.setByteOffset(static_cast<uint32_t>(vData.size() * sizeof(float)));
+        meshBuffer.setVertexOffset(SPRITE_COUNT * QUAD_VERTEX_COUNT);
+        batcher.syncMeshBuffersToNative(0, {&meshBuffer});
+
+        scene = ccnew Scene("batcher-2d");
+        for (uint32_t i = 0; i < ROOT_COUNT; ++i) {
+            IntrusivePtr<Node> canvas = ccnew Node();
+            canvas->setParent(scene);
+            canvas->setPosition(static_cast<float>(i) * 100.0F, 0.0F, 0.0F);
+            roots.emplace_back(canvas);
+        }
+        for (uint32_t i = 0; i < SPRITE_COUNT; ++i) {
+            IntrusivePtr<Node> sprite = ccnew Node();
+            sprite->setParent(roots[i / SPRITES_PER_ROOT]);
+            sprite->setPosition(static_cast<float>(i) * 3.0F, static_cast<float>(i), 0.0F);
+            sprite->setLayer(i < SPRITES_PER_ROOT ? LAYER_2D : LAYER_3D);
+            sprites.emplace_back(sprite);
+            addSprite(sprite, i, material);
+        }
+        scene->load();
+        scene->setActiveInHierarchy(true);
+        scene->walk([](Node *node) { node->setActiveInHierarchy(true); });
+        batcher.syncRootNodesToNative(ccstd::vector<Node *>(roots.begin(), roots.end()));
+    }
+
+    void addSprite(Node *node, uint32_t index, Material *material) {
+        auto &local = localVertices[index];
+        local.resize(QUAD_VERTEX_COUNT * STRIDE);
+        for (uint32_t v = 0; v < QUAD_VERTEX_COUNT; ++v) {
+            float *vertex = &local[v * STRIDE];
+            vertex[0] = static_cast<float>(v % 2) * 8.0F;
+            vertex[1] = static_cast<float>(v / 2) * 8.0F;
+            vertex[3] = static_cast<float>(v % 2);
+            vertex[4] = static_cast<float>(v / 2);
+        }
+        const auto vertexOffset = static_cast<uint16_t>(index * QUAD_VERTEX_COUNT);
+        indices[index] = {vertexOffset, static_cast<uint16_t>(vertexOffset + 1), static_cast<uint16_t>(vertexOffset + 2),
+                          static_cast<uint16_t>(vertexOffset + 2), static_cast<uint16_t>(vertexOffset + 1), static_cast<uint16_t>(vertexOffset + 3)};
+
+        auto *entity = ccnew RenderEntity(RenderEntityType::STATIC);
+        entity->setNode(node);
+        entity->setStaticDrawInfoSize(1);
+        getEntityAttrs(entity)->enabledIndex = 1;
+        entities.emplace_back(entity);
+
+        auto *drawInfo = entity->getStaticRenderDrawInfo(0);
+        drawInfo->setDrawInfoType(static_cast<uint32_t>(RenderDrawInfoType::COMP));
+        drawInfo->setMeshBuffer(&meshBuffer);
+        drawInfo->setVDataBuffer(vData.data());
+        drawInfo->setIDataBuffer(iData.data());
+        drawInfo->setVertexOffset(vertexOffset);
+        drawInfo->setVbBuffer(&vData[vertexOffset * STRIDE]);
+        drawInfo->setIbBuffer(indices[index].data());
+        drawInfo->setVbCount(QUAD_VERTEX_COUNT);
+        drawInfo->setIbCount(QUAD_INDEX_COUNT);
+        drawInfo->setStride(STRIDE);
+        drawInfo->setMaterial(material);
+        // every four sprites share a texture
+        drawInfo->setDataHash(index / 4 + 1);
+        drawInfo->setRender2dBufferToNative(reinterpret_cast<uint8_t *>(local.data()));
+        drawInfo->setVertDirty(true);
+    }
+
+    // The same edits the script side makes to both worlds.
+    void edit(uint32_t frame, Material *otherMaterial) {
+        switch (frame) {
+            case 2:
+                sprites[3]->setPosition(40.0F, -12.0F, 0.0F);
+                break;
+            case 3: {
+                auto *attrs = getEntityAttrs(entities[SPRITES_PER_ROOT + 5]);
+                attrs->colorR = 64;
+                attrs->colorA = 128;
+                attrs->colorDirtyBit = 1;
+                break;
+            }
+            case 4: {
+                auto *drawInfo = entities[6]->getStaticRenderDrawInfo(0);
+                drawInfo->setMaterial(otherMaterial);
+                drawInfo->setDataHash(100);
+                break;
+            }
+            case 5:
+                sprites[SPRITES_PER_ROOT + 2]->setActiveInHierarchy(false);
+                break;
+            case 6:
+                roots[1]->setPosition(120.0F, 30.0F, 0.0F);
+                break;
+            case 7:
+                sprites[SPRITES_PER_ROOT + 7]->setLayer(LAYER_2D);
+                break;
+            default:
+                break;
+        }
+    }
+};
+
+struct BatchSnapshot {
+    uint32_t visFlags{0};
+    uint32_t firstIndex{0};
+    uint32_t indexCount{0};
+    gfx::Shader *shader{nullptr};
+    ccstd::hash_t passHash{0};
+    bool hasDescriptorSet{false};
+};
+
+struct FrameSnapshot {
+    ccstd::vector<BatchSnapshot> batches;
+    ccstd::vector<float> vertices;
+    ccstd::vector<uint16_t> indices;
+};
+
+FrameSnapshot batchFrame(SpriteWorld &world) {
+    world.batcher.update();
+
+    FrameSnapshot snapshot;
+    for (const auto *batch : world.scene->getRenderScene()->getBatches()) {
+        auto &batchSnapshot = snapshot.batches.emplace_back();
+        batchSnapshot.visFlags = batch->getVisFlags();
+        batchSnapshot.firstIndex = batch->getInputAssembler()->getFirstIndex();
+        batchSnapshot.indexCount = batch->getInputAssembler()->getIndexCount();
+        batchSnapshot.shader = batch->getShaders().at(0);
+        batchSnapshot.passHash = batch->getPasses().at(0)->getHash();
+        batchSnapshot.hasDescriptorSet = batch->getDescriptorSet() != nullptr;
+    }
+    snapshot.vertices = world.vData;
+    snapshot.indices.assign(world.iData.begin(), world.iData.begin() + world.meshBuffer.getIndexOffset());
+    return snapshot;
+}
+
+void endFrame(SpriteWorld &world) {
+    world.batcher.uploadBuffers();
+    world.scene->getRenderScene()->removeBatches();
+    world.batcher.reset();
+}
+} // namespace
+
+TEST(Batcher2dTest, retainedMatchesImmediate) {
+    auto *device = gfx::DeviceManager::createHeadless(gfx::DeviceInfo{});
+    ASSERT_NE(device, nullptr);
+    {
+        Root root(device);
+        std::unique_ptr<ProgramLib> programLib;
+        if (ProgramLib::getInstance() == nullptr) {
+            programLib = std::make_unique<ProgramLib>();
+        }
+        IShaderInfo shaderInfo;
+        shaderInfo.name = PROGRAM_NAME;
+        shaderInfo.hash = 1;
+        ProgramLib::getInstance()->define(shaderInfo);
+
+        IntrusivePtr<gfx::Shader> shader = device->createShader(gfx::ShaderInfo{});
+        IntrusivePtr<gfx::DescriptorSetLayout> materialSetLayout = device->createDescriptorSetLayout({});
+        IntrusivePtr<gfx::DescriptorSet> materialSet = device->createDescriptorSet({materialSetLayout});
+        IntrusivePtr<scene::Pass> spritePass = ccnew SpritePass(&root, shader, materialSet, 1);
+        IntrusivePtr<scene::Pass> otherPass = ccnew SpritePass(&root, shader, materialSet, 2);
+        IntrusivePtr<Material> spriteMaterial = ccnew SpriteMaterial(spritePass, 1);
+        IntrusivePtr<Material> otherMaterial = ccnew SpriteMaterial(otherPass, 2);
+
+        {
+            SpriteWorld immediate(&root, spriteMaterial);
+            SpriteWorld retained(&root, spriteMaterial);
+
+            // rebatched and reused entities of the retained world, the first frame is batched before switching
+            const uint32_t rebatched[FRAME_COUNT] = {SPRITE_COUNT, SPRITE_COUNT, 0, 0, SPRITES_PER_ROOT, SPRITES_PER_ROOT - 1, 0, SPRITES_PER_ROOT - 1};
+            const uint32_t reused[FRAME_COUNT] = {0, 0, SPRITE_COUNT, SPRITE_COUNT, SPRITES_PER_ROOT, SPRITES_PER_ROOT, SPRITE_COUNT - 1, SPRITES_PER_ROOT};
+
+            for (uint32_t frame = 0; frame < FRAME_COUNT; ++frame) {
+                Node::resetChangedFlags();
+                immediate.edit(frame, otherMaterial);
+                retained.edit(frame, otherMaterial);
+
+                const auto expected = batchFrame(immediate);
+                const auto actual = batchFrame(retained);
+                if (frame == 0) {
+                    // takes effect once the batches of this frame are reset
+                    retained.batcher.setRetainedMode(true);
+                    EXPECT_TRUE(retained.batcher.isRetainedMode());
+                    EXPECT_EQ(retained.scene->getRenderScene()->getBatches().size(), expected.batches.size());
+                }
+                EXPECT_EQ(retained.batcher.getRebatchedEntityCount(), rebatched[frame]) << "frame " << frame;
+                EXPECT_EQ(retained.batcher.getRetainedEntityCount(), reused[frame]) << "frame " << frame;
+
+                ASSERT_FALSE(expected.batches.empty());
+                ASSERT_EQ(expected.batches.size(), actual.batches.size()) << "frame " << frame;
+                for (size_t i = 0; i < expected.batches.size(); ++i) {
+                    EXPECT_EQ(expected.batches[i].visFlags, actual.batches[i].visFlags) << "frame " << frame << " batch " << i;
+                    EXPECT_EQ(expected.batches[i].firstIndex, actual.batches[i].firstIndex) << "frame " << frame << " batch " << i;
+                    EXPECT_EQ(expected.batches[i].indexCount, actual.batches[i].indexCount) << "frame " << frame << " batch " << i;
+                    EXPECT_EQ(expected.batches[i].shader, actual.batches[i].shader) << "frame " << frame << " batch " << i;
+                    EXPECT_EQ(expected.batches[i].passHash, actual.batches[i].passHash) << "frame " << frame << " batch " << i;
+                    EXPECT_TRUE(actual.batches[i].hasDescriptorSet);
+                }
+                EXPECT_EQ(expected.vertices, actual.vertices) << "frame " << frame;
+                EXPECT_EQ(expected.indices, actual.indices) << "frame " << frame;
+
+                endFrame(immediate);
+                endFrame(retained);
+            }
+        }
+
+        otherMaterial = nullptr;
+        spriteMaterial = nullptr;
+        otherPass->destroy();
+        spritePass->destroy();
+    }
+    CC_SAFE_DESTROY_AND_DELETE(device);
+}
@@ -0,0 +1,218 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <cstring>
+#include <random>
+#include "base/std/container/vector.h"
+#include "core/scene-graph/Node.h"
+#include "core/scene-graph/TransformStore.h"
+#include "gtest/gtest.h"
+#include "math/Mat4.h"
+#include "math/Math.h"
+
+using namespace cc;
+
+namespace {
+
+constexpr float EPSILON = 1e-3F;
+
+struct Hierarchy {
+    IntrusivePtr<Node> root;
+    ccstd::vector<IntrusivePtr<Node>> nodes;
+    std::mt19937 rng{3};
+
+    explicit Hierarchy(uint32_t count) {
+        root = ccnew Node();
+        nodes.emplace_back(root);
+        for (uint32_t i = 1; i < count; ++i) {
+            IntrusivePtr<Node> node = ccnew Node();
+            std::uniform_int_distribution<uint32_t> pick(0, i - 1);
+            node->setParent(nodes[pick(rng)]);
+            randomize(node);
+            nodes.emplace_back(node);
+        }
+    }
+
+    void randomize(Node *node) {
+        std::uniform_real_distribution<float> offset(-10.0F, 10.0F);
+        std::uniform_real_distribution<float> angle(0.0F, math::PI_2);
+        std::uniform_real_distribution<float> scale(0.5F, 1.5F);
+        Quaternion rotation;
+        Quaternion::fromEuler(angle(rng), angle(rng), angle(rng), &rotation);
+        node->setPosition(offset(rng), offset(rng), offset(rng));
+        node->setRotation(rotation);
+        node->setScale(scale(rng), scale(rng), scale(rng));
+    }
+};
+
+// World matrix composed from the local transforms, independent of any cached state.
+Mat4 expectedWorldMatrix(const Node *node) { // NOLINT(misc-no-recursion)
+    Mat4 local;
+    Mat4::fromRTS(node->getRotation(), node->getPosition(), node->getScale(), &local);
+    if (!node->getParent()) {
+        return local;
+    }
+    Mat4 world;
+    Mat4::multiply(expectedWorldMatrix(node->getParent()), local, &world);
+    return world;
+}
+
+bool isUnder(const Node *node, const Node *root) {
+    for (; node; node = node->getParent()) {
+        if (node == root) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Checks the nodes which belong to the hierarchy of root.
+void expectResolved(const ccstd::vector<IntrusivePtr<Node>> &nodes, const Node *root) {
+    for (const auto &node : nodes) {
+        if (!isUnder(node, root)) {
+            continue;
+        }
+        ASSERT_FALSE(node->isTransformDirty());
+        const Mat4 expected = expectedWorldMatrix(node);
+        const Mat4 &actual = node->getWorldMatrix();
+        for (int i = 0; i < 16; ++i) {
+            ASSERT_NEAR(actual.m[i], expected.m[i], EPSILON);
+        }
+    }
+}
+
+void expectResolved(const Hierarchy &hierarchy) {
+    expectResolved(hierarchy.nodes, hierarchy.root);
+}
+
+} // namespace
+
+TEST(TransformStoreTest, resolvesWholeHierarchy) {
+    Hierarchy hierarchy(500);
+    TransformStore store;
+    store.rebuild(hierarchy.root);
+    EXPECT_EQ(store.size(), 500U);
+    store.update();
+    EXPECT_EQ(store.getLastSweepSize(), 500U);
+    expectResolved(hierarchy);
+
+    // the store keeps a copy of every world matrix
+    for (const auto &node : hierarchy.nodes) {
+        bool found = false;
+        for (const auto &matrix : store.getWorldMatrices()) {
+            found = found || memcmp(matrix.m, node->getWorldMatrix().m, sizeof(matrix.m)) == 0;
+        }
+        EXPECT_TRUE(found);
+    }
+}
+
+TEST(TransformStoreTest, sweepsOnlyInvalidatedSubtrees) {
+    Hierarchy hierarchy(500);
+    TransformStore store;
+    store.rebuild(hierarchy.root);
+    store.update();
+
+    store.update();
+    EXPECT_EQ(store.getLastSweepSize(), 0U);
+
+    Node *leaf = nullptr;
+    for (const auto &node : hierarchy.nodes) {
+        if (node->getChildren().empty()) {
+            leaf = node;
+            break;
+        }
+    }
+    ASSERT_NE(leaf, nullptr);
+    hierarchy.randomize(leaf);
+    store.update();
+    EXPECT_EQ(store.getLastSweepSize(), 1U);
+    expectResolved(hierarchy);
+
+    // moving an inner node sweeps its subtree, twice-invalidated nodes are swept once
+    Node *inner = hierarchy.nodes[1];
+    uint32_t subtreeSize = 0;
+    ccstd::vector<Node *> stack{inner};
+    while (!stack.empty()) {
+        Node *node = stack.back();
+        stack.pop_back();
+        ++subtreeSize;
+        for (const auto &child : node->getChildren()) {
+            stack.emplace_back(child);
+        }
+    }
+    hierarchy.randomize(inner);
+    hierarchy.randomize(inner->getChildren().empty() ? inner : inner->getChildren()[0].get());
+    store.update();
+    EXPECT_EQ(store.getLastSweepSize(), subtreeSize);
+    expectResolved(hierarchy);
+}
+
+TEST(TransformStoreTest, nodesResolvedOnDemandStayConsistent) {
+    Hierarchy hierarchy(200);
+    TransformStore store;
+    store.rebuild(hierarchy.root);
+    store.update();
+
+    for (uint32_t i = 1; i < 200; i += 7) {
+        hierarchy.randomize(hierarchy.nodes[i]);
+        if (i % 2) {
+            hierarchy.nodes[i]->getWorldMatrix();
+        }
+    }
+    store.update();
+    expectResolved(hierarchy);
+}
+
+TEST(TransformStoreTest, hierarchyChanges) {
+    Hierarchy hierarchy(300);
+    Hierarchy other(50);
+    TransformStore store;
+    store.rebuild(hierarchy.root);
+    store.update();
+
+    // reparenting outside of the store does not relayout it
+    other.nodes[10]->setParent(other.nodes[3]);
+    store.update();
+    EXPECT_EQ(store.getLastSweepSize(), 0U);
+
+    // a subtree moved in from another hierarchy joins the store
+    other.nodes[1]->setParent(hierarchy.nodes[5]);
+    // a subtree moved within the store keeps its local transforms
+    hierarchy.nodes[200]->setParent(hierarchy.nodes[2]);
+    store.update();
+    EXPECT_GT(store.size(), 300U);
+    expectResolved(hierarchy);
+    expectResolved(other.nodes, hierarchy.root);
+
+    // removed and released nodes leave the store
+    IntrusivePtr<Node> removed = hierarchy.nodes[100];
+    removed->setParent(nullptr);
+    hierarchy.nodes.erase(hierarchy.nodes.begin() + 100);
+    const uint32_t sizeBefore = store.size();
+    removed = nullptr;
+    store.update();
+    EXPECT_LT(store.size(), sizeBefore);
+    expectResolved(hierarchy);
+}
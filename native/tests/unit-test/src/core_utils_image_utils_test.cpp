@@ -0,0 +1,145 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include "cocos/core/utils/ImageUtils.h"
+#include "gtest/gtest.h"
+
+using cc::ImageUtils;
+
+namespace {
+
+ccstd::vector<uint8_t> makePixels(uint32_t pixelCount, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint32_t> dist(0, 255);
+    ccstd::vector<uint8_t> pixels(pixelCount * 4);
+    for (auto &c : pixels) {
+        c = static_cast<uint8_t>(dist(rng));
+    }
+    return pixels;
+}
+
+// Straightforward box filter, one level at a time.
+ccstd::vector<uint8_t> downsampleReference(const uint8_t *src, uint32_t width, uint32_t height) {
+    const uint32_t dstWidth = std::max(width >> 1, 1U);
+    const uint32_t dstHeight = std::max(height >> 1, 1U);
+    ccstd::vector<uint8_t> dst(dstWidth * dstHeight * 4);
+    for (uint32_t y = 0; y < dstHeight; ++y) {
+        const uint32_t y0 = std::min(y * 2, height - 1);
+        const uint32_t y1 = std::min(y * 2 + 1, height - 1);
+        for (uint32_t x = 0; x < dstWidth; ++x) {
+            const uint32_t x0 = std::min(x * 2, width - 1);
+            const uint32_t x1 = std::min(x * 2 + 1, width - 1);
+            for (uint32_t c = 0; c < 4; ++c) {
+                const uint32_t sum = src[(y0 * width + x0) * 4 + c] + src[(y0 * width + x1) * 4 + c] +
+                                     src[(y1 * width + x0) * 4 + c] + src[(y1 * width + x1) * 4 + c];
+                dst[(y * dstWidth + x) * 4 + c] = static_cast<uint8_t>((sum + 2) >> 2);
+            }
+        }
+    }
+    return dst;
+}
+
+} // namespace
+
+TEST(ImageUtilsTest, premultiplyAlpha) {
+    // every (color, alpha) pair, plus an odd tail for the scalar path
+    const uint32_t pixelCount = 256 * 256 + 3;
+    ccstd::vector<uint8_t> pixels(pixelCount * 4);
+    for (uint32_t i = 0; i < pixelCount; ++i) {
+        const auto color = static_cast<uint8_t>(i & 0xff);
+        pixels[i * 4 + 0] = color;
+        pixels[i * 4 + 1] = static_cast<uint8_t>(255 - color);
+        pixels[i * 4 + 2] = static_cast<uint8_t>(color ^ 0x5a);
+        pixels[i * 4 + 3] = static_cast<uint8_t>((i >> 8) & 0xff);
+    }
+    const ccstd::vector<uint8_t> source = pixels;
+    ImageUtils::premultiplyAlpha(pixels.data(), pixelCount);
+
+    for (uint32_t i = 0; i < pixelCount; ++i) {
+        const uint32_t alpha = source[i * 4 + 3];
+        EXPECT_EQ(pixels[i * 4 + 3], alpha);
+        for (uint32_t c = 0; c < 3; ++c) {
+            const uint32_t expected = (source[i * 4 + c] * alpha + 127) / 255;
+            ASSERT_EQ(pixels[i * 4 + c], expected) << "pixel " << i << " channel " << c;
+        }
+    }
+}
+
+TEST(ImageUtilsTest, mipmapChainSize) {
+    EXPECT_EQ(ImageUtils::getMipmapChainSize(1, 1), 4U);
+    EXPECT_EQ(ImageUtils::getMipmapChainSize(4, 4), (16U + 4U + 1U) * 4U);
+    EXPECT_EQ(ImageUtils::getMipmapChainSize(5, 3), (15U + 2U + 1U) * 4U);
+    EXPECT_EQ(ImageUtils::getMipmapChainSize(8, 1), (8U + 4U + 2U + 1U) * 4U);
+}
+
+TEST(ImageUtilsTest, generateMipmaps) {
+    const uint32_t sizes[][2] = {{1, 1}, {2, 2}, {7, 5}, {16, 16}, {33, 9}, {1, 12}, {64, 3}, {257, 130}};
+    for (const auto &size : sizes) {
+        uint32_t width = size[0];
+        uint32_t height = size[1];
+        const uint32_t chainSize = ImageUtils::getMipmapChainSize(width, height);
+        ccstd::vector<uint8_t> chain = makePixels(chainSize / 4, width * 31 + height);
+        ccstd::vector<uint32_t> levelDataSize;
+        ImageUtils::generateMipmaps(chain.data(), width, height, &levelDataSize);
+
+        ccstd::vector<uint8_t> level(chain.begin(), chain.begin() + width * height * 4);
+        uint32_t offset = 0;
+        uint32_t total = 0;
+        for (uint32_t size : levelDataSize) {
+            total += size;
+        }
+        EXPECT_EQ(total, chainSize);
+        ASSERT_EQ(levelDataSize[0], width * height * 4);
+        for (size_t i = 1; i < levelDataSize.size(); ++i) {
+            offset += levelDataSize[i - 1];
+            level = downsampleReference(level.data(), width, height);
+            width = std::max(width >> 1, 1U);
+            height = std::max(height >> 1, 1U);
+            ASSERT_EQ(levelDataSize[i], level.size());
+            ASSERT_EQ(0, memcmp(chain.data() + offset, level.data(), level.size())) << size[0] << "x" << size[1] << " level " << i;
+        }
+        EXPECT_EQ(width, 1U);
+        EXPECT_EQ(height, 1U);
+    }
+}
+
+// Timing only, run with --gtest_also_run_disabled_tests.
+TEST(ImageUtilsTest, DISABLED_mipmapThroughput) {
+    const uint32_t width = 2048;
+    const uint32_t height = 2048;
+    ccstd::vector<uint8_t> chain = makePixels(ImageUtils::getMipmapChainSize(width, height) / 4, 7);
+    ccstd::vector<uint32_t> levelDataSize;
+
+    const auto begin = std::chrono::steady_clock::now();
+    ImageUtils::premultiplyAlpha(chain.data(), width * height);
+    ImageUtils::generateMipmaps(chain.data(), width, height, &levelDataSize);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    printf("premultiply + mipmaps %ux%u: %.2f ms, %.1f MB/s\n", width, height, seconds * 1000.0,
+           static_cast<double>(width * height * 4) / (1024.0 * 1024.0) / seconds);
+    EXPECT_EQ(levelDataSize.size(), 12U);
+}
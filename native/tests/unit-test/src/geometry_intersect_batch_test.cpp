@@ -0,0 +1,241 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include "cocos/base/std/container/deque.h"
+#include "cocos/core/geometry/AABB.h"
+#include "cocos/core/geometry/Frustum.h"
+#include "cocos/core/geometry/Intersect.h"
+#include "cocos/core/geometry/IntersectBatch.h"
+#include "cocos/core/geometry/Obb.h"
+#include "cocos/core/geometry/Sphere.h"
+#include "cocos/math/Mat4.h"
+#include "cocos/math/Quaternion.h"
+#include "gtest/gtest.h"
+
+using namespace cc;
+using namespace cc::geometry;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// A camera a little off the origin, looking down a tilted direction.
+void makeFrustum(Frustum &frustum, bool accurate) {
+    Quaternion rotation;
+    Quaternion::fromEuler(-20.F, 35.F, 5.F, &rotation);
+    Mat4 transform;
+    Mat4::fromRT(rotation, Vec3(3.F, 2.F, -4.F), &transform);
+    Frustum::createPerspective(&frustum, 1.0F, 16.F / 9.F, 0.5F, 60.F, transform);
+    frustum.setAccurate(accurate);
+}
+
+// Random shapes around the frustum, plus boxes sitting exactly on a plane of the test box.
+struct Shapes {
+    ccstd::vector<AABB> aabbs;
+    // Sphere can not be moved, a deque constructs it in place
+    ccstd::deque<Sphere> spheres;
+    ccstd::vector<OBB> obbs;
+    AABBBatch aabbBatch;
+    SphereBatch sphereBatch;
+    OBBBatch obbBatch;
+
+    explicit Shapes(uint32_t count) {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> position(-70.F, 70.F);
+        std::uniform_real_distribution<float> extent(0.F, 6.F);
+        std::uniform_real_distribution<float> angle(-180.F, 180.F);
+        for (uint32_t i = 0; i < count; ++i) {
+            const Vec3 center(position(rng), position(rng) * 0.3F, position(rng));
+            const Vec3 halfExtents(extent(rng), extent(rng), extent(rng));
+            aabbs.emplace_back(center.x, center.y, center.z, halfExtents.x, halfExtents.y, halfExtents.z);
+            spheres.emplace_back(center.x, center.y, center.z, halfExtents.x);
+            Quaternion rotation;
+            Quaternion::fromEuler(angle(rng), angle(rng), angle(rng), &rotation);
+            OBB obb(center.x, center.y, center.z, halfExtents.x, halfExtents.y, halfExtents.z);
+            Mat3::fromQuat(rotation, &obb.orientation);
+            obbs.push_back(obb);
+        }
+        // touching the unit box at the origin on each face
+        for (float side : {-2.F, 2.F}) {
+            aabbs.emplace_back(side, 0.F, 0.F, 1.F, 1.F, 1.F);
+            aabbs.emplace_back(0.F, side, 0.F, 1.F, 1.F, 1.F);
+            aabbs.emplace_back(0.F, 0.F, side, 1.F, 1.F, 1.F);
+        }
+        for (const auto &aabb : aabbs) {
+            aabbBatch.push(aabb);
+        }
+        for (const auto &sphere : spheres) {
+            sphereBatch.push(sphere);
+        }
+        for (const auto &obb : obbs) {
+            obbBatch.push(obb);
+        }
+    }
+};
+
+uint32_t countBits(const BatchMask &mask) {
+    uint32_t count = 0;
+    for (uint32_t word : mask) {
+        for (; word; word &= word - 1) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+TEST(geometryIntersectBatchTest, matchesScalarTests) {
+    // odd sizes leave a partly filled group at the end
+    for (uint32_t count : {0U, 1U, 3U, 37U, 4001U}) {
+        const Shapes shapes(count);
+        Frustum frustum;
+        Frustum accurate;
+        makeFrustum(frustum, false);
+        makeFrustum(accurate, true);
+        BatchMask intersects;
+        BatchMask inside;
+
+        aabbFrustumBatch(shapes.aabbBatch, frustum, intersects, &inside);
+        EXPECT_EQ(intersects.size(), (shapes.aabbs.size() + 31) / 32);
+        if (count > 1000) {
+            // the shapes straddle the frustum
+            EXPECT_GT(countBits(intersects), countBits(inside));
+            EXPECT_GT(countBits(inside), 0);
+            EXPECT_LT(countBits(intersects), count);
+        }
+        for (uint32_t i = 0; i < shapes.aabbs.size(); ++i) {
+            EXPECT_EQ(testBatchMask(intersects, i), aabbFrustum(shapes.aabbs[i], frustum) != 0) << i;
+            EXPECT_EQ(testBatchMask(inside, i), aabbFrustumCompletelyInside(shapes.aabbs[i], frustum) != 0) << i;
+        }
+
+        for (const Frustum *f : {&frustum, &accurate}) {
+            dynAabbFrustumBatch(shapes.aabbBatch, *f, intersects);
+            for (uint32_t i = 0; i < shapes.aabbs.size(); ++i) {
+                EXPECT_EQ(testBatchMask(intersects, i), dynAabbFrustum(shapes.aabbs[i], *f) != 0) << i;
+            }
+        }
+
+        sphereFrustumBatch(shapes.sphereBatch, frustum, intersects);
+        for (uint32_t i = 0; i < shapes.spheres.size(); ++i) {
+            EXPECT_EQ(testBatchMask(intersects, i), sphereFrustum(shapes.spheres[i], frustum) != 0) << i;
+        }
+
+        obbFrustumBatch(shapes.obbBatch, frustum, intersects);
+        for (uint32_t i = 0; i < shapes.obbs.size(); ++i) {
+            EXPECT_EQ(testBatchMask(intersects, i), obbFrustum(shapes.obbs[i], frustum) != 0) << i;
+        }
+
+        const AABB unit(0.F, 0.F, 0.F, 1.F, 1.F, 1.F);
+        aabbWithAABBBatch(shapes.aabbBatch, unit, intersects);
+        for (uint32_t i = 0; i < shapes.aabbs.size(); ++i) {
+            EXPECT_EQ(testBatchMask(intersects, i), aabbWithAABB(shapes.aabbs[i], unit)) << i;
+        }
+    }
+}
+
+TEST(geometryIntersectBatchTest, clearAndReuse) {
+    AABBBatch batch;
+    batch.reserve(10);
+    for (uint32_t i = 0; i < 5; ++i) {
+        batch.push(Vec3(static_cast<float>(i), 0.F, 0.F), Vec3(0.1F, 0.1F, 0.1F));
+    }
+    EXPECT_EQ(batch.size(), 5);
+    EXPECT_EQ(batch.centerX.size(), 8);
+
+    const AABB probe(2.F, 0.F, 0.F, 0.5F, 0.5F, 0.5F);
+    BatchMask mask;
+    aabbWithAABBBatch(batch, probe, mask);
+    ASSERT_EQ(mask.size(), 1);
+    EXPECT_EQ(mask[0], 1U << 2);
+
+    batch.clear();
+    EXPECT_TRUE(batch.empty());
+    aabbWithAABBBatch(batch, probe, mask);
+    EXPECT_TRUE(mask.empty());
+}
+
+// Timing only, run with --gtest_also_run_disabled_tests.
+TEST(geometryIntersectBatchTest, DISABLED_throughput) {
+    constexpr uint32_t COUNT = 100000;
+    constexpr uint32_t ROUNDS = 20;
+    const Shapes shapes(COUNT);
+    Frustum frustum;
+    makeFrustum(frustum, false);
+    BatchMask mask;
+
+    auto measure = [](auto &&body) {
+        const auto begin = Clock::now();
+        uint32_t visible = 0;
+        for (uint32_t round = 0; round < ROUNDS; ++round) {
+            visible += body();
+        }
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+        return std::make_pair(static_cast<double>(COUNT) * ROUNDS / ns, visible);
+    };
+
+    const auto aabbScalar = measure([&]() {
+        uint32_t visible = 0;
+        for (const auto &aabb : shapes.aabbs) {
+            visible += aabbFrustum(aabb, frustum);
+        }
+        return visible;
+    });
+    const auto aabbBatch = measure([&]() {
+        aabbFrustumBatch(shapes.aabbBatch, frustum, mask);
+        return countBits(mask);
+    });
+    const auto sphereScalar = measure([&]() {
+        uint32_t visible = 0;
+        for (const auto &sphere : shapes.spheres) {
+            visible += sphereFrustum(sphere, frustum);
+        }
+        return visible;
+    });
+    const auto sphereBatch = measure([&]() {
+        sphereFrustumBatch(shapes.sphereBatch, frustum, mask);
+        return countBits(mask);
+    });
+    const auto obbScalar = measure([&]() {
+        uint32_t visible = 0;
+        for (const auto &obb : shapes.obbs) {
+            visible += obbFrustum(obb, frustum);
+        }
+        return visible;
+    });
+    const auto obbBatch = measure([&]() {
+        obbFrustumBatch(shapes.obbBatch, frustum, mask);
+        return countBits(mask);
+    });
+
+    EXPECT_EQ(aabbScalar.second, aabbBatch.second);
+    EXPECT_EQ(sphereScalar.second, sphereBatch.second);
+    EXPECT_EQ(obbScalar.second, obbBatch.second);
+    printf("[geometryIntersectBatchTest] objects/ns, scalar vs batch: aabb %.3f vs %.3f, sphere %.3f vs %.3f, obb %.3f vs %.3f\n",
+           aabbScalar.first, aabbBatch.first, sphereScalar.first, sphereBatch.first, obbScalar.first, obbBatch.first);
+}
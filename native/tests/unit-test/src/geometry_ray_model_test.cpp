@@ -0,0 +1,381 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <cmath>
+#include <random>
+#include "3d/assets/Mesh.h"
+#include "base/std/container/vector.h"
+#include "core/Root.h"
+#include "core/assets/RenderingSubMesh.h"
+#include "core/geometry/AABB.h"
+#include "core/geometry/Intersect.h"
+#include "core/geometry/Ray.h"
+#include "core/geometry/Triangle.h"
+#include "core/scene-graph/Node.h"
+#include "gtest/gtest.h"
+#include "renderer/GFXDeviceManager.h"
+#include "scene/Model.h"
+#include "scene/SubModel.h"
+
+using namespace cc;
+using namespace cc::geometry;
+
+namespace {
+
+constexpr uint32_t GRID_SIZE = 24;
+constexpr uint32_t GRID_ROW = GRID_SIZE + 1;
+constexpr uint32_t GRID_VERTICES = GRID_ROW * GRID_ROW;
+constexpr uint32_t GRID_INDICES = GRID_SIZE * GRID_SIZE * 6;
+// the first grid floats above the second one
+constexpr float GRID_LIFT = 1.5F;
+constexpr uint32_t RAY_COUNT = 403;
+
+class RaySubModel final : public scene::SubModel {
+public:
+    explicit RaySubModel(RenderingSubMesh *subMesh) {
+        _subMesh = subMesh;
+    }
+};
+
+class RayModel final : public scene::Model {
+public:
+    void addSubModel(scene::SubModel *subModel) {
+        _subModels.emplace_back(subModel);
+    }
+};
+
+// Two wavy height fields sharing one vertex bundle, each of them is a sub mesh.
+struct TestMesh {
+    IntrusivePtr<Mesh> mesh;
+    ccstd::vector<IntrusivePtr<RenderingSubMesh>> subMeshes;
+    ccstd::vector<ccstd::vector<Triangle>> triangles;
+
+    TestMesh() {
+        constexpr uint32_t vertexBytes = GRID_VERTICES * 2 * 3 * sizeof(float);
+        constexpr uint32_t indexBytes = GRID_INDICES * sizeof(uint32_t);
+        Uint8Array data(vertexBytes + 2 * indexBytes);
+        Float32Array positions(data.buffer(), 0, GRID_VERTICES * 2 * 3);
+        Uint32Array indices(data.buffer(), vertexBytes, GRID_INDICES * 2);
+        for (uint32_t grid = 0; grid < 2; ++grid) {
+            const float lift = grid == 0 ? GRID_LIFT : 0.0F;
+            for (uint32_t z = 0; z < GRID_ROW; ++z) {
+                for (uint32_t x = 0; x < GRID_ROW; ++x) {
+                    const uint32_t i = (grid * GRID_VERTICES + z * GRID_ROW + x) * 3;
+                    positions[i] = static_cast<float>(x);
+                    positions[i + 1] = std::sin(static_cast<float>(x) * 0.37F) * std::cos(static_cast<float>(z) * 0.23F) + lift;
+                    positions[i + 2] = static_cast<float>(z);
+                }
+            }
+            uint32_t n = grid * GRID_INDICES;
+            for (uint32_t z = 0; z < GRID_SIZE; ++z) {
+                for (uint32_t x = 0; x < GRID_SIZE; ++x) {
+                    const uint32_t i = grid * GRID_VERTICES + z * GRID_ROW + x;
+                    for (uint32_t index : {i, i + GRID_ROW, i + 1, i + 1, i + GRID_ROW, i + GRID_ROW + 1}) {
+                        indices[n++] = index;
+                    }
+                }
+            }
+        }
+
+        Mesh::ICreateInfo info;
+        auto &bundle = info.structInfo.vertexBundles.emplace_back();
+        bundle.view = {0, vertexBytes, GRID_VERTICES * 2, 3 * sizeof(float)};
+        bundle.attributes.emplace_back(gfx::Attribute{gfx::ATTR_NAME_POSITION, gfx::Format::RGB32F});
+        for (uint32_t grid = 0; grid < 2; ++grid) {
+            auto &primitive = info.structInfo.primitives.emplace_back();
+            primitive.vertexBundelIndices.emplace_back(0);
+            primitive.primitiveMode = gfx::PrimitiveMode::TRIANGLE_LIST;
+            primitive.indexView = Mesh::IBufferView{vertexBytes + grid * indexBytes, indexBytes, GRID_INDICES, sizeof(uint32_t)};
+        }
+        info.data = data;
+        mesh = ccnew Mesh();
+        mesh->reset(std::move(info));
+
+        for (uint32_t grid = 0; grid < 2; ++grid) {
+            IntrusivePtr<RenderingSubMesh> subMesh = ccnew RenderingSubMesh(gfx::BufferList{}, bundle.attributes, gfx::PrimitiveMode::TRIANGLE_LIST);
+            subMesh->setMesh(mesh);
+            subMesh->setSubMeshIdx(grid);
+            subMeshes.emplace_back(subMesh);
+        }
+        updateTriangles();
+    }
+
+    // What raySubMesh tested before the BVH, every triangle in primitive order.
+    void updateTriangles() {
+        const Float32Array positions(mesh->getData().buffer(), 0, GRID_VERTICES * 2 * 3);
+        const Uint32Array indices(mesh->getData().buffer(), GRID_VERTICES * 2 * 3 * sizeof(float), GRID_INDICES * 2);
+        triangles.assign(2, {});
+        for (uint32_t grid = 0; grid < 2; ++grid) {
+            for (uint32_t i = grid * GRID_INDICES; i < (grid + 1) * GRID_INDICES; i += 3) {
+                const uint32_t a = indices[i] * 3;
+                const uint32_t b = indices[i + 1] * 3;
+                const uint32_t c = indices[i + 2] * 3;
+                triangles[grid].emplace_back(positions[a], positions[a + 1], positions[a + 2],
+                                             positions[b], positions[b + 1], positions[b + 2],
+                                             positions[c], positions[c + 1], positions[c + 2]);
+            }
+        }
+    }
+
+    void scanAll(uint32_t grid, const Ray &ray, const IRaySubMeshOptions &opt, ccstd::vector<IRaySubMeshResult> &hits) const {
+        hits.clear();
+        for (uint32_t t = 0; t < triangles[grid].size(); ++t) {
+            const float dist = rayTriangle(ray, triangles[grid][t], opt.doubleSided);
+            if (dist == 0.0F || dist > opt.distance) continue;
+            const uint32_t first = grid * GRID_VERTICES + (t / 2) / GRID_SIZE * GRID_ROW + (t / 2) % GRID_SIZE;
+            if (t % 2 == 0) {
+                hits.push_back({dist, first, first + GRID_ROW, first + 1});
+            } else {
+                hits.push_back({dist, first + 1, first + GRID_ROW, first + GRID_ROW + 1});
+            }
+        }
+    }
+
+    float scanClosest(uint32_t grid, const Ray &ray, const IRaySubMeshOptions &opt) const {
+        ccstd::vector<IRaySubMeshResult> hits;
+        scanAll(grid, ray, opt, hits);
+        float closest = 0.0F;
+        for (const auto &hit : hits) {
+            if (closest == 0.0F || hit.distance < closest) closest = hit.distance;
+        }
+        return closest;
+    }
+};
+
+ccstd::vector<Ray> makeRays(uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-2.0F, GRID_SIZE + 2.0F);
+    std::uniform_real_distribution<float> direction(-1.0F, 1.0F);
+    ccstd::vector<Ray> rays;
+    for (uint32_t i = 0; i < RAY_COUNT; ++i) {
+        switch (i % 3) {
+            case 0: // picking from above, through both grids
+                rays.emplace_back(position(rng), 10.0F, position(rng), direction(rng) * 0.3F, -1.0F, direction(rng) * 0.3F);
+                break;
+            case 1: // line of sight between the grids
+                rays.emplace_back(position(rng), GRID_LIFT * 0.5F, -1.0F, direction(rng), direction(rng) * 0.2F, 1.0F);
+                break;
+            default: // from below, only double sided tests see the grids
+                rays.emplace_back(position(rng), -5.0F, position(rng), direction(rng), 1.0F, direction(rng));
+                break;
+        }
+        rays.back().d.normalize();
+    }
+    return rays;
+}
+
+IRayModelOptions makeOptions(ERaycastMode mode, bool doubleSided, float distance) {
+    IRayModelOptions opt;
+    opt.mode = mode;
+    opt.doubleSided = doubleSided;
+    opt.distance = distance;
+    return opt;
+}
+
+} // namespace
+
+TEST(geometryRayModelTest, raySubMeshMatchesLinearScan) {
+    const TestMesh mesh;
+    const auto rays = makeRays(3);
+    ccstd::vector<IRaySubMeshResult> expected;
+    uint32_t hitCount = 0;
+    for (bool doubleSided : {false, true}) {
+        for (float distance : {FLT_MAX, 9.0F}) {
+            for (uint32_t grid = 0; grid < 2; ++grid) {
+                const auto &subMesh = *mesh.subMeshes[grid];
+                for (const auto &ray : rays) {
+                    auto opt = makeOptions(ERaycastMode::CLOSEST, doubleSided, distance);
+                    opt.result.emplace();
+                    const float closest = mesh.scanClosest(grid, ray, opt);
+                    hitCount += closest != 0.0F ? 1 : 0;
+                    EXPECT_EQ(raySubMesh(ray, subMesh, &opt), closest);
+                    EXPECT_EQ(opt.result->size(), closest != 0.0F ? 1U : 0U);
+
+                    // any hit is fine as long as a triangle is there
+                    opt.mode = ERaycastMode::ANY;
+                    const float any = raySubMesh(ray, subMesh, &opt);
+                    EXPECT_EQ(any != 0.0F, closest != 0.0F);
+                    EXPECT_GE(any, closest);
+
+                    // every hit in primitive order, the last one is returned
+                    opt.mode = ERaycastMode::ALL;
+                    opt.result->clear();
+                    mesh.scanAll(grid, ray, opt, expected);
+                    EXPECT_EQ(raySubMesh(ray, subMesh, &opt), expected.empty() ? 0.0F : expected.back().distance);
+                    ASSERT_EQ(opt.result->size(), expected.size());
+                    for (uint32_t i = 0; i < expected.size(); ++i) {
+                        EXPECT_EQ((*opt.result)[i].distance, expected[i].distance);
+                        EXPECT_EQ((*opt.result)[i].vertexIndex0, expected[i].vertexIndex0);
+                        EXPECT_EQ((*opt.result)[i].vertexIndex1, expected[i].vertexIndex1);
+                        EXPECT_EQ((*opt.result)[i].vertexIndex2, expected[i].vertexIndex2);
+                    }
+                }
+            }
+        }
+    }
+    EXPECT_GT(hitCount, rays.size());
+
+    // without options the first hit of a one sided test is reported
+    const Ray down(3.5F, 10.0F, 4.5F, 0.0F, -1.0F, 0.0F);
+    EXPECT_GT(raySubMesh(down, *mesh.subMeshes[0]), 0.0F);
+    EXPECT_EQ(raySubMesh(Ray(3.5F, -10.0F, 4.5F, 0.0F, 1.0F, 0.0F), *mesh.subMeshes[0]), 0.0F);
+}
+
+TEST(geometryRayModelTest, raySubMeshBatchMatchesRaySubMesh) {
+    const TestMesh mesh;
+    const auto rays = makeRays(5);
+    ccstd::vector<float> distances;
+    for (auto mode : {ERaycastMode::ANY, ERaycastMode::CLOSEST, ERaycastMode::ALL}) {
+        for (bool doubleSided : {false, true}) {
+            for (float distance : {FLT_MAX, 9.0F}) {
+                auto opt = makeOptions(mode, doubleSided, distance);
+                for (uint32_t grid = 0; grid < 2; ++grid) {
+                    raySubMeshBatch(rays, *mesh.subMeshes[grid], distances, &opt);
+                    ASSERT_EQ(distances.size(), rays.size());
+                    for (uint32_t i = 0; i < rays.size(); ++i) {
+                        // ALL reports the closest hit as well
+                        const float closest = mesh.scanClosest(grid, rays[i], opt);
+                        if (mode == ERaycastMode::ANY) {
+                            EXPECT_EQ(distances[i] != 0.0F, closest != 0.0F) << i;
+                            EXPECT_GE(distances[i], closest) << i;
+                        } else {
+                            EXPECT_EQ(distances[i], closest) << i;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    // the results are resized to the rays
+    raySubMeshBatch({}, *mesh.subMeshes[0], distances);
+    EXPECT_TRUE(distances.empty());
+}
+
+TEST(geometryRayModelTest, rayModelBatchMatchesRayModel) {
+    auto *device = gfx::DeviceManager::createHeadless(gfx::DeviceInfo{});
+    ASSERT_NE(device, nullptr);
+    {
+        Root root(device);
+        const TestMesh mesh;
+        IntrusivePtr<Node> node = ccnew Node();
+        node->setPosition(5.0F, -2.0F, 3.0F);
+        node->setRotationFromEuler(10.0F, 30.0F, -5.0F);
+        node->setScale(2.0F, 0.5F, 1.5F);
+        node->updateWorldTransform();
+        const Mat4 &world = node->getWorldMatrix();
+
+        IntrusivePtr<RayModel> model = ccnew RayModel();
+        model->setNode(node);
+        for (const auto &subMesh : mesh.subMeshes) {
+            model->addSubModel(ccnew RaySubModel(subMesh));
+        }
+        // bounds around the sub meshes, rays passing by them are rejected early
+        AABB localBounds;
+        AABB::fromPoints(Vec3(0.0F, -1.0F, 0.0F), Vec3(GRID_SIZE, GRID_LIFT + 1.0F, GRID_SIZE), &localBounds);
+        IntrusivePtr<AABB> worldBounds = ccnew AABB();
+        localBounds.transform(world, worldBounds.get());
+        model->setWorldBounds(worldBounds);
+
+        // the rays are made in model space, so distances are the same as in the sub mesh tests
+        auto rays = makeRays(11);
+        for (auto &ray : rays) {
+            Vec3::transformMat4(Vec3(ray.o), world, &ray.o);
+            Vec3::transformMat4Normal(Vec3(ray.d), world, &ray.d);
+        }
+
+        ccstd::vector<float> distances;
+        uint32_t hitCount = 0;
+        for (auto mode : {ERaycastMode::ANY, ERaycastMode::CLOSEST, ERaycastMode::ALL}) {
+            for (bool doubleSided : {false, true}) {
+                for (float distance : {FLT_MAX, 9.0F}) {
+                    auto opt = makeOptions(mode, doubleSided, distance);
+                    rayModelBatch(rays, *model, distances, &opt);
+                    ASSERT_EQ(distances.size(), rays.size());
+                    for (uint32_t i = 0; i < rays.size(); ++i) {
+                        auto scalarOpt = makeOptions(mode, doubleSided, distance);
+                        const float expected = rayModel(rays[i], *model, &scalarOpt);
+                        if (mode == ERaycastMode::CLOSEST) {
+                            EXPECT_EQ(distances[i], expected) << i;
+                            hitCount += expected != 0.0F ? 1 : 0;
+                        } else if (mode == ERaycastMode::ANY) {
+                            EXPECT_EQ(distances[i] != 0.0F, expected != 0.0F) << i;
+                        } else {
+                            // rayModel reports the last hit, the batch the closest one
+                            auto closestOpt = makeOptions(ERaycastMode::CLOSEST, doubleSided, distance);
+                            EXPECT_EQ(distances[i], rayModel(rays[i], *model, &closestOpt)) << i;
+                            EXPECT_EQ(distances[i] != 0.0F, expected != 0.0F) << i;
+                            EXPECT_LE(distances[i], expected) << i;
+                        }
+                    }
+                }
+            }
+        }
+        EXPECT_GT(hitCount, rays.size());
+
+        // straight down through both grids
+        Ray down;
+        Vec3::transformMat4(Vec3(3.5F, 10.0F, 4.5F), world, &down.o);
+        Vec3::transformMat4Normal(Vec3(0.0F, -1.0F, 0.0F), world, &down.d);
+        auto opt = makeOptions(ERaycastMode::ALL, false, FLT_MAX);
+        const float last = rayModel(down, *model, &opt);
+        rayModelBatch({down}, *model, distances, &opt);
+        ASSERT_EQ(distances.size(), 1U);
+        EXPECT_NEAR(last - distances[0], GRID_LIFT, 1e-4F);
+    }
+    CC_SAFE_DESTROY_AND_DELETE(device);
+}
+
+TEST(geometryRayModelTest, invalidateGeometricInfoRebuildsBVH) {
+    TestMesh mesh;
+    auto &subMesh = *mesh.subMeshes[1];
+    const Ray down(3.5F, 10.0F, 4.5F, 0.0F, -1.0F, 0.0F);
+    auto opt = makeOptions(ERaycastMode::CLOSEST, false, FLT_MAX);
+    const float before = raySubMesh(down, subMesh, &opt);
+    ASSERT_GT(before, 0.0F);
+    // the sub meshes share their vertex bundle, so the bounds cover both grids
+    const float maxY = subMesh.getGeometricInfo().boundingBox.max.y;
+    EXPECT_EQ(subMesh.getTriangleBVH().getTriangleCount(), GRID_INDICES / 3);
+
+    // raise the lower grid above the other one in place, the cached geometry does not see it
+    constexpr float raise = 4.0F;
+    Float32Array positions(mesh.mesh->getData().buffer(), 0, GRID_VERTICES * 2 * 3);
+    for (uint32_t i = GRID_VERTICES; i < GRID_VERTICES * 2; ++i) {
+        positions[i * 3 + 1] += raise;
+    }
+    mesh.updateTriangles();
+    EXPECT_EQ(raySubMesh(down, subMesh, &opt), before);
+
+    subMesh.invalidateGeometricInfo();
+    EXPECT_FLOAT_EQ(subMesh.getGeometricInfo().boundingBox.max.y, maxY - GRID_LIFT + raise);
+    const float after = raySubMesh(down, subMesh, &opt);
+    EXPECT_NEAR(before - after, raise, 1e-4F);
+    EXPECT_EQ(after, mesh.scanClosest(1, down, opt));
+    EXPECT_EQ(subMesh.getTriangleBVH().getTriangleCount(), GRID_INDICES / 3);
+
+    ccstd::vector<float> distances;
+    raySubMeshBatch({down}, subMesh, distances, &opt);
+    ASSERT_EQ(distances.size(), 1U);
+    EXPECT_EQ(distances[0], after);
+}
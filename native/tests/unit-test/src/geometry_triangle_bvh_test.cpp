@@ -0,0 +1,293 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include "cocos/core/geometry/Intersect.h"
+#include "cocos/core/geometry/Ray.h"
+#include "cocos/core/geometry/Triangle.h"
+#include "cocos/core/geometry/TriangleBVH.h"
+#include "gtest/gtest.h"
+
+using cc::Float32Array;
+using cc::IBArray;
+using cc::Uint32Array;
+using cc::geometry::Ray;
+using cc::geometry::TriangleBVH;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct TestMesh {
+    Float32Array positions;
+    IBArray indices;
+};
+
+// A wavy height field of size * size quads in the xz plane. The first triangles are repeated at the
+// end of the index buffer so equally distant hits have to be resolved by primitive order.
+TestMesh makeTerrain(uint32_t size, uint32_t repeated) {
+    const uint32_t row = size + 1;
+    TestMesh mesh;
+    mesh.positions = Float32Array(row * row * 3);
+    for (uint32_t z = 0; z < row; ++z) {
+        for (uint32_t x = 0; x < row; ++x) {
+            const uint32_t i = (z * row + x) * 3;
+            mesh.positions[i] = static_cast<float>(x);
+            mesh.positions[i + 1] = std::sin(static_cast<float>(x) * 0.37F) * std::cos(static_cast<float>(z) * 0.23F) * 2.0F;
+            mesh.positions[i + 2] = static_cast<float>(z);
+        }
+    }
+    const uint32_t triangleCount = size * size * 2;
+    Uint32Array indices((triangleCount + repeated) * 3);
+    uint32_t n = 0;
+    for (uint32_t z = 0; z < size; ++z) {
+        for (uint32_t x = 0; x < size; ++x) {
+            const uint32_t i = z * row + x;
+            indices[n++] = i;
+            indices[n++] = i + row;
+            indices[n++] = i + 1;
+            indices[n++] = i + 1;
+            indices[n++] = i + row;
+            indices[n++] = i + row + 1;
+        }
+    }
+    for (uint32_t i = 0; i < repeated * 3; ++i) {
+        indices[n++] = indices[i];
+    }
+    mesh.indices = indices;
+    return mesh;
+}
+
+// What raySubMesh did before the BVH: every triangle in primitive order.
+struct LinearScan {
+    ccstd::vector<cc::geometry::Triangle> triangles;
+
+    LinearScan(const TestMesh &mesh, const TriangleBVH &bvh) {
+        for (uint32_t t = 0; t < bvh.getTriangleCount(); ++t) {
+            const auto &v = bvh.getVertexIndices(t);
+            const auto &p = mesh.positions;
+            triangles.emplace_back(p[v[0] * 3], p[v[0] * 3 + 1], p[v[0] * 3 + 2],
+                                   p[v[1] * 3], p[v[1] * 3 + 1], p[v[1] * 3 + 2],
+                                   p[v[2] * 3], p[v[2] * 3 + 1], p[v[2] * 3 + 2]);
+        }
+    }
+
+    float distance(const Ray &ray, uint32_t triangle, bool doubleSided) const {
+        return cc::geometry::rayTriangle(ray, triangles[triangle], doubleSided);
+    }
+
+    void all(const Ray &ray, float maxDistance, bool doubleSided, ccstd::vector<TriangleBVH::Hit> &hits) const {
+        hits.clear();
+        for (uint32_t t = 0; t < triangles.size(); ++t) {
+            const float dist = distance(ray, t, doubleSided);
+            if (dist == 0.0F || dist > maxDistance) continue;
+            hits.push_back({dist, t});
+        }
+    }
+
+    bool closest(const Ray &ray, float maxDistance, bool doubleSided, TriangleBVH::Hit *hit) const {
+        bool found = false;
+        for (uint32_t t = 0; t < triangles.size(); ++t) {
+            const float dist = distance(ray, t, doubleSided);
+            if (dist == 0.0F || dist > maxDistance) continue;
+            if (!found || dist < hit->distance) {
+                *hit = {dist, t};
+                found = true;
+            }
+        }
+        return found;
+    }
+};
+
+ccstd::vector<Ray> makeRays(uint32_t count, float extent, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-2.0F, extent + 2.0F);
+    std::uniform_real_distribution<float> direction(-1.0F, 1.0F);
+    ccstd::vector<Ray> rays;
+    for (uint32_t i = 0; i < count; ++i) {
+        switch (i % 4) {
+            case 0: // picking from above
+                rays.emplace_back(position(rng), 10.0F, position(rng), direction(rng) * 0.3F, -1.0F, direction(rng) * 0.3F);
+                break;
+            case 1: // straight down through grid lines, zero direction components
+                rays.emplace_back(std::floor(position(rng)), 5.0F, std::floor(position(rng)) + 0.5F, 0.0F, -1.0F, 0.0F);
+                break;
+            case 2: // line of sight across the terrain
+                rays.emplace_back(position(rng), 0.5F, -1.0F, direction(rng), direction(rng) * 0.1F, 1.0F);
+                break;
+            default: // from below, only double sided tests see the terrain
+                rays.emplace_back(position(rng), -5.0F, position(rng), direction(rng), 1.0F, direction(rng));
+                break;
+        }
+        rays.back().d.normalize();
+    }
+    return rays;
+}
+
+} // namespace
+
+TEST(geometryTriangleBVHTest, queriesMatchLinearScan) {
+    const TestMesh mesh = makeTerrain(40, 50);
+    TriangleBVH bvh;
+    bvh.build(mesh.positions, mesh.indices, cc::gfx::PrimitiveMode::TRIANGLE_LIST);
+    ASSERT_EQ(bvh.getTriangleCount(), 40U * 40U * 2U + 50U);
+    const LinearScan scan(mesh, bvh);
+
+    const auto rays = makeRays(800, 40.0F, 7);
+    ccstd::vector<TriangleBVH::Hit> expectedHits;
+    ccstd::vector<TriangleBVH::Hit> hits;
+    uint32_t hitCount = 0;
+    for (bool doubleSided : {false, true}) {
+        for (float maxDistance : {FLT_MAX, 8.0F}) {
+            for (uint32_t i = 0; i < rays.size(); i += TriangleBVH::PACKET_SIZE) {
+                TriangleBVH::Hit closestHits[TriangleBVH::PACKET_SIZE];
+                TriangleBVH::Hit anyHits[TriangleBVH::PACKET_SIZE];
+                const Ray *packet[TriangleBVH::PACKET_SIZE];
+                const uint32_t count = std::min<uint32_t>(TriangleBVH::PACKET_SIZE, static_cast<uint32_t>(rays.size()) - i);
+                for (uint32_t lane = 0; lane < count; ++lane) packet[lane] = &rays[i + lane];
+                bvh.raycastPacket(packet, count, maxDistance, doubleSided, false, closestHits);
+                bvh.raycastPacket(packet, count, maxDistance, doubleSided, true, anyHits);
+
+                for (uint32_t lane = 0; lane < count; ++lane) {
+                    const Ray &ray = rays[i + lane];
+                    TriangleBVH::Hit expected;
+                    TriangleBVH::Hit hit;
+                    const bool found = scan.closest(ray, maxDistance, doubleSided, &expected);
+                    hitCount += found ? 1 : 0;
+                    ASSERT_EQ(bvh.raycastClosest(ray, maxDistance, doubleSided, &hit), found);
+                    if (found) {
+                        EXPECT_EQ(hit.distance, expected.distance);
+                        EXPECT_EQ(hit.triangle, expected.triangle);
+                    }
+                    EXPECT_EQ(closestHits[lane].distance, found ? expected.distance : 0.0F);
+                    if (found) EXPECT_EQ(closestHits[lane].triangle, expected.triangle);
+
+                    // any hit is fine as long as the scan would have accepted it
+                    ASSERT_EQ(bvh.raycastAny(ray, maxDistance, doubleSided, &hit), found);
+                    if (found) EXPECT_EQ(hit.distance, scan.distance(ray, hit.triangle, doubleSided));
+                    EXPECT_EQ(anyHits[lane].distance != 0.0F, found);
+                    if (found) EXPECT_EQ(anyHits[lane].distance, scan.distance(ray, anyHits[lane].triangle, doubleSided));
+
+                    scan.all(ray, maxDistance, doubleSided, expectedHits);
+                    bvh.raycastAll(ray, maxDistance, doubleSided, hits);
+                    ASSERT_EQ(hits.size(), expectedHits.size());
+                    for (uint32_t h = 0; h < hits.size(); ++h) {
+                        EXPECT_EQ(hits[h].triangle, expectedHits[h].triangle);
+                        EXPECT_EQ(hits[h].distance, expectedHits[h].distance);
+                    }
+                }
+            }
+        }
+    }
+    // make sure the rays actually exercise the tree
+    EXPECT_GT(hitCount, rays.size());
+}
+
+TEST(geometryTriangleBVHTest, primitiveModes) {
+    Float32Array positions(6 * 3);
+    for (uint32_t i = 0; i < 6; ++i) {
+        positions[i * 3] = static_cast<float>(i / 2);
+        positions[i * 3 + 2] = static_cast<float>(i % 2);
+    }
+    Uint32Array indices(6);
+    for (uint32_t i = 0; i < 6; ++i) indices[i] = i;
+
+    TriangleBVH bvh;
+    bvh.build(positions, indices, cc::gfx::PrimitiveMode::TRIANGLE_STRIP);
+    ASSERT_EQ(bvh.getTriangleCount(), 4U);
+    // odd strip triangles swap their first two vertices
+    EXPECT_EQ(bvh.getVertexIndices(0), (ccstd::array<uint32_t, 3>{0, 1, 2}));
+    EXPECT_EQ(bvh.getVertexIndices(1), (ccstd::array<uint32_t, 3>{2, 1, 3}));
+    EXPECT_EQ(bvh.getVertexIndices(3), (ccstd::array<uint32_t, 3>{4, 3, 5}));
+
+    bvh.build(positions, indices, cc::gfx::PrimitiveMode::TRIANGLE_FAN);
+    ASSERT_EQ(bvh.getTriangleCount(), 4U);
+    EXPECT_EQ(bvh.getVertexIndices(2), (ccstd::array<uint32_t, 3>{0, 3, 4}));
+
+    bvh.build(positions, indices, cc::gfx::PrimitiveMode::TRIANGLE_LIST);
+    ASSERT_EQ(bvh.getTriangleCount(), 2U);
+    TriangleBVH::Hit hit;
+    EXPECT_TRUE(bvh.raycastClosest(Ray(0.25F, 1.0F, 0.5F, 0.0F, -1.0F, 0.0F), FLT_MAX, true, &hit));
+    EXPECT_FLOAT_EQ(hit.distance, 1.0F);
+    EXPECT_EQ(hit.triangle, 0U);
+
+    // out of range vertices are dropped, a mesh without indices has no triangles
+    indices[5] = 100;
+    bvh.build(positions, indices, cc::gfx::PrimitiveMode::TRIANGLE_LIST);
+    EXPECT_EQ(bvh.getTriangleCount(), 1U);
+    bvh.build(positions, IBArray{}, cc::gfx::PrimitiveMode::TRIANGLE_LIST);
+    EXPECT_TRUE(bvh.empty());
+    EXPECT_FALSE(bvh.raycastAny(Ray(0.25F, 1.0F, 0.5F, 0.0F, -1.0F, 0.0F), FLT_MAX, true, &hit));
+}
+
+// Timing only, run with --gtest_also_run_disabled_tests.
+TEST(geometryTriangleBVHTest, DISABLED_throughput) {
+    // 51200 triangles, rays shot from a camera grid like editor picking does
+    const TestMesh mesh = makeTerrain(160, 0);
+    const auto buildStart = Clock::now();
+    TriangleBVH bvh;
+    bvh.build(mesh.positions, mesh.indices, cc::gfx::PrimitiveMode::TRIANGLE_LIST);
+    const double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - buildStart).count();
+    const LinearScan scan(mesh, bvh);
+
+    ccstd::vector<Ray> rays;
+    for (uint32_t y = 0; y < 64; ++y) {
+        for (uint32_t x = 0; x < 64; ++x) {
+            rays.emplace_back(80.0F, 60.0F, -40.0F, (static_cast<float>(x) - 32.0F) / 40.0F, -1.0F, 0.5F + static_cast<float>(y) / 40.0F);
+            rays.back().d.normalize();
+        }
+    }
+    constexpr uint32_t scannedRays = 256;
+
+    TriangleBVH::Hit hit;
+    float checksum = 0;
+    auto start = Clock::now();
+    for (uint32_t i = 0; i < scannedRays; ++i) {
+        if (scan.closest(rays[i * (rays.size() / scannedRays)], FLT_MAX, false, &hit)) checksum += hit.distance;
+    }
+    const double scanUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / scannedRays;
+
+    start = Clock::now();
+    for (const auto &ray : rays) {
+        if (bvh.raycastClosest(ray, FLT_MAX, false, &hit)) checksum += hit.distance;
+    }
+    const double singleUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / static_cast<double>(rays.size());
+
+    start = Clock::now();
+    TriangleBVH::Hit hits[TriangleBVH::PACKET_SIZE];
+    for (uint32_t i = 0; i < rays.size(); i += TriangleBVH::PACKET_SIZE) {
+        const Ray *packet[TriangleBVH::PACKET_SIZE] = {&rays[i], &rays[i + 1], &rays[i + 2], &rays[i + 3]};
+        bvh.raycastPacket(packet, TriangleBVH::PACKET_SIZE, FLT_MAX, false, false, hits);
+        for (const auto &h : hits) checksum += h.distance;
+    }
+    const double packetUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / static_cast<double>(rays.size());
+
+    EXPECT_GT(checksum, 0.0F);
+    printf("[geometryTriangleBVHTest] %u triangles, %u nodes, build %.2f ms, per ray: linear scan %.2f us, bvh %.3f us, bvh packets %.3f us\n",
+           bvh.getTriangleCount(), bvh.getNodeCount(), buildMs, scanUs, singleUs, packetUs);
+}
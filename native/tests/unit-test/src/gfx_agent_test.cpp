@@ -0,0 +1,201 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include "base/std/container/vector.h"
+#include "base/threading/MessageQueue.h"
+#include "gtest/gtest.h"
+#include "renderer/GFXDeviceManager.h"
+
+using namespace cc;
+using namespace cc::gfx;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t SECONDARY_COUNT = 8;
+constexpr uint32_t DRAWS_PER_SECONDARY = 20000;
+constexpr uint32_t FRAME_COUNT = 10;
+
+// records a frame of secondary command buffers, each on its own thread if parallel,
+// merges them into the primary and returns the time spent recording
+Clock::duration recordFrame(Device *device, const ccstd::vector<CommandBuffer *> &secondaries, bool parallel) {
+    auto *primary = device->getCommandBuffer();
+    primary->begin();
+
+    auto record = [](CommandBuffer *cmdBuff, uint32_t index) {
+        cmdBuff->begin();
+        DrawInfo info;
+        info.vertexCount = 3;
+        info.firstInstance = index;
+        for (uint32_t i = 0; i < DRAWS_PER_SECONDARY; ++i) {
+            cmdBuff->draw(info);
+        }
+        cmdBuff->end();
+    };
+
+    const auto begin = Clock::now();
+    if (parallel) {
+        ccstd::vector<std::thread> threads;
+        for (uint32_t i = 0; i < secondaries.size(); ++i) {
+            threads.emplace_back(record, secondaries[i], i);
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    } else {
+        for (uint32_t i = 0; i < secondaries.size(); ++i) {
+            record(secondaries[i], i);
+        }
+    }
+    const auto recordingTime = Clock::now() - begin;
+
+    primary->execute(secondaries.data(), static_cast<uint32_t>(secondaries.size()));
+    primary->end();
+
+    device->flushCommands(&primary, 1);
+    DeviceAgent::getInstance()->getMessageQueue()->kickAndWait();
+
+    return recordingTime;
+}
+
+double measureDrawsPerSecond(Device *device, const ccstd::vector<CommandBuffer *> &secondaries, bool parallel) {
+    Clock::duration recordingTime{0};
+    for (uint32_t i = 0; i < FRAME_COUNT; ++i) {
+        recordingTime += recordFrame(device, secondaries, parallel);
+    }
+    return FRAME_COUNT * SECONDARY_COUNT * DRAWS_PER_SECONDARY / std::chrono::duration<double>(recordingTime).count();
+}
+} // namespace
+
+TEST(GFXAgentTest, parallelSecondaryRecording) {
+    auto *device = DeviceManager::createHeadless(DeviceInfo{});
+    ASSERT_NE(device, nullptr);
+
+    ccstd::vector<CommandBuffer *> secondaries;
+    for (uint32_t i = 0; i < SECONDARY_COUNT; ++i) {
+        secondaries.push_back(device->createCommandBuffer({device->getQueue(), CommandBufferType::SECONDARY}));
+    }
+
+    // both with the device thread attached and detached
+    for (bool multithreaded : {true, false}) {
+        DeviceAgent::getInstance()->setMultithreaded(multithreaded);
+
+        for (bool parallel : {false, true}) {
+            recordFrame(device, secondaries, parallel);
+            EXPECT_EQ(device->getCommandBuffer()->getNumDrawCalls(), SECONDARY_COUNT * DRAWS_PER_SECONDARY);
+        }
+    }
+
+    for (auto *cmdBuff : secondaries) {
+        CC_SAFE_DESTROY_AND_DELETE(cmdBuff);
+    }
+    CC_SAFE_DESTROY_AND_DELETE(device);
+}
+
+// Timing only, run with --gtest_also_run_disabled_tests.
+TEST(GFXAgentTest, DISABLED_secondaryRecordingThroughput) {
+    auto *device = DeviceManager::createHeadless(DeviceInfo{});
+    ASSERT_NE(device, nullptr);
+
+    ccstd::vector<CommandBuffer *> secondaries;
+    for (uint32_t i = 0; i < SECONDARY_COUNT; ++i) {
+        secondaries.push_back(device->createCommandBuffer({device->getQueue(), CommandBufferType::SECONDARY}));
+    }
+
+    for (bool multithreaded : {true, false}) {
+        DeviceAgent::getInstance()->setMultithreaded(multithreaded);
+
+        const double serial = measureDrawsPerSecond(device, secondaries, false);
+        const double parallel = measureDrawsPerSecond(device, secondaries, true);
+        printf("GFXAgent (%s device thread): %u secondaries, recorded draws/s serial %.0f, parallel %.0f\n",
+               multithreaded ? "with" : "without", SECONDARY_COUNT, serial, parallel);
+    }
+
+    for (auto *cmdBuff : secondaries) {
+        CC_SAFE_DESTROY_AND_DELETE(cmdBuff);
+    }
+    CC_SAFE_DESTROY_AND_DELETE(device);
+}
+
+TEST(GFXAgentTest, secondariesOfRenderPassReplayOnExecute) {
+    auto *device = DeviceManager::createHeadless(DeviceInfo{});
+    ASSERT_NE(device, nullptr);
+
+    auto *texture = device->createTexture({TextureType::TEX2D, TextureUsageBit::COLOR_ATTACHMENT, Format::RGBA8, 4, 4});
+    RenderPassInfo renderPassInfo;
+    renderPassInfo.colorAttachments.emplace_back().format = Format::RGBA8;
+    auto *renderPass = device->createRenderPass(renderPassInfo);
+    auto *framebuffer = device->createFramebuffer({renderPass, {texture}});
+
+    ccstd::vector<CommandBuffer *> secondaries;
+    for (uint32_t i = 0; i < SECONDARY_COUNT; ++i) {
+        secondaries.push_back(device->createCommandBuffer({device->getQueue(), CommandBufferType::SECONDARY}));
+    }
+
+    for (bool multithreaded : {true, false}) {
+        DeviceAgent::getInstance()->setMultithreaded(multithreaded);
+
+        // the pass begins while the workers still record, so only execute() may close and replay the secondaries
+        ccstd::vector<std::thread> threads;
+        for (uint32_t i = 0; i < SECONDARY_COUNT; ++i) {
+            threads.emplace_back([cmdBuff = secondaries[i]]() {
+                cmdBuff->begin();
+                DrawInfo info;
+                info.vertexCount = 3;
+                cmdBuff->draw(info);
+                cmdBuff->end();
+            });
+        }
+
+        auto *primary = device->getCommandBuffer();
+        const Color clearColor{0.F, 0.F, 0.F, 1.F};
+        primary->begin();
+        primary->beginRenderPass(renderPass, framebuffer, Rect{0, 0, 4, 4}, &clearColor, 1.F, 0, secondaries.data(), SECONDARY_COUNT);
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        primary->execute(secondaries.data(), SECONDARY_COUNT);
+        primary->endRenderPass();
+        primary->end();
+        device->flushCommands(&primary, 1);
+        DeviceAgent::getInstance()->getMessageQueue()->kickAndWait();
+
+        for (auto *cmdBuff : secondaries) {
+            EXPECT_EQ(cmdBuff->getNumDrawCalls(), 1U);
+        }
+        EXPECT_EQ(primary->getNumDrawCalls(), SECONDARY_COUNT);
+    }
+
+    for (auto *cmdBuff : secondaries) {
+        CC_SAFE_DESTROY_AND_DELETE(cmdBuff);
+    }
+    CC_SAFE_DESTROY_AND_DELETE(framebuffer);
+    CC_SAFE_DESTROY_AND_DELETE(renderPass);
+    CC_SAFE_DESTROY_AND_DELETE(texture);
+    CC_SAFE_DESTROY_AND_DELETE(device);
+}
@@ -0,0 +1,179 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "gfx-base/SPIRVUtils.h"
+#include "gtest/gtest.h"
+#include "platform/FileUtils.h"
+
+using namespace cc;
+using gfx::SPIRVUtils;
+
+namespace {
+
+ccstd::string makeVertexSource(int variant) {
+    return "#version 450\n#define CC_VARIANT " + std::to_string(variant) +
+           "\nlayout(location = 0) in vec4 a_position;\nvoid main() { gl_Position = a_position * float(CC_VARIANT); }\n";
+}
+
+class SPIRVCacheTest : public testing::Test {
+protected:
+    void SetUp() override {
+        if (!FileUtils::getInstance()) {
+            _ownedFileUtils = createFileUtils();
+        }
+        FileUtils::getInstance()->createDirectory(FileUtils::getInstance()->getWritablePath());
+        FileUtils::getInstance()->removeFile(SPIRVUtils::getCachePath());
+        launch();
+    }
+
+    void TearDown() override {
+        _spirv->destroy();
+        _spirv->setCacheLimit(SPIRVUtils::DEFAULT_CACHE_LIMIT);
+        FileUtils::getInstance()->removeFile(SPIRVUtils::getCachePath());
+        delete _ownedFileUtils;
+    }
+
+    // a new launch: the cache written by the previous one is read back
+    void relaunch() {
+        _spirv->destroy();
+        launch();
+    }
+
+    void launch() {
+        _spirv = SPIRVUtils::getInstance();
+        _spirv->initialize(0);
+    }
+
+    // what the Vulkan backend does with a vertex stage: its attributes are moved to the locations the module reads
+    ccstd::vector<uint32_t> compileVertex(const ccstd::string &source, gfx::AttributeList *attributes) {
+        _spirv->compileGLSL(gfx::ShaderStageFlagBit::VERTEX, source);
+        _spirv->compressInputLocations(*attributes);
+        const auto *words = _spirv->getOutputData();
+        return {words, words + _spirv->getOutputSize() / sizeof(uint32_t)};
+    }
+
+    ccstd::vector<uint32_t> compile(int variant) {
+        _spirv->compileGLSL(gfx::ShaderStageFlagBit::VERTEX, makeVertexSource(variant));
+        const auto *words = _spirv->getOutputData();
+        return {words, words + _spirv->getOutputSize() / sizeof(uint32_t)};
+    }
+
+    FileUtils *_ownedFileUtils{nullptr};
+    SPIRVUtils *_spirv{nullptr};
+};
+
+} // namespace
+
+TEST_F(SPIRVCacheTest, persistLoadRoundTrip) {
+    const auto first = compile(1);
+    ASSERT_FALSE(first.empty());
+    EXPECT_EQ(_spirv->getCacheMisses(), 1U);
+
+    relaunch();
+    ASSERT_TRUE(FileUtils::getInstance()->isFileExist(SPIRVUtils::getCachePath()));
+    EXPECT_EQ(compile(1), first);
+    EXPECT_EQ(_spirv->getCacheHits(), 1U);
+    EXPECT_EQ(_spirv->getCacheMisses(), 0U);
+
+    // another variant of the same source is a separate module
+    compile(2);
+    EXPECT_EQ(_spirv->getCacheMisses(), 1U);
+}
+
+TEST_F(SPIRVCacheTest, flushWithoutDestroy) {
+    const auto first = compile(1);
+    _spirv->flushCache();
+    ASSERT_TRUE(FileUtils::getInstance()->isFileExist(SPIRVUtils::getCachePath()));
+
+    // as if the page was closed, nothing else gets written
+    FileUtils::getInstance()->renameFile(FileUtils::getInstance()->getWritablePath(), "spirv-cache.bin", "spirv-cache.bak");
+    relaunch();
+    EXPECT_FALSE(FileUtils::getInstance()->isFileExist(SPIRVUtils::getCachePath()));
+    FileUtils::getInstance()->renameFile(FileUtils::getInstance()->getWritablePath(), "spirv-cache.bak", "spirv-cache.bin");
+    relaunch();
+    EXPECT_EQ(compile(1), first);
+    EXPECT_EQ(_spirv->getCacheHits(), 1U);
+}
+
+TEST_F(SPIRVCacheTest, limitKeepsUsedModules) {
+    const auto a = compile(1);
+    const auto b = compile(2);
+    relaunch();
+
+    // this launch uses a and compiles c, only room for those two
+    compile(1);
+    const auto c = compile(3);
+    constexpr uint32_t headerBytes = 5 * sizeof(uint32_t);
+    // each entry also keeps its one active input location
+    constexpr uint32_t entryBytes = 9 * sizeof(uint32_t);
+    _spirv->setCacheLimit(headerBytes + 2 * entryBytes + static_cast<uint32_t>((a.size() + c.size()) * sizeof(uint32_t)));
+    relaunch();
+
+    EXPECT_LE(FileUtils::getInstance()->getFileSize(SPIRVUtils::getCachePath()), _spirv->getCacheLimit());
+    EXPECT_EQ(compile(1), a);
+    EXPECT_EQ(compile(3), c);
+    EXPECT_EQ(_spirv->getCacheHits(), 2U);
+    EXPECT_EQ(compile(2), b);
+    EXPECT_EQ(_spirv->getCacheMisses(), 1U);
+}
+
+TEST_F(SPIRVCacheTest, compressInputLocationsOnCacheHit) {
+    const ccstd::string source =
+        "#version 450\n"
+        "layout(location = 0) in vec4 a_position;\n"
+        "layout(location = 1) in vec4 a_color;\n"
+        "layout(location = 2) in vec2 a_texCoord;\n"
+        "layout(location = 0) out vec2 v_uv;\n"
+        "void main() { v_uv = a_texCoord; gl_Position = a_position; }\n";
+    const gfx::AttributeList declared{
+        {"a_position", gfx::Format::RGBA32F, false, 0, false, 0},
+        {"a_color", gfx::Format::RGBA32F, false, 0, false, 1},
+        {"a_texCoord", gfx::Format::RG32F, false, 0, false, 2},
+    };
+
+    auto compiled = declared;
+    const auto first = compileVertex(source, &compiled);
+    EXPECT_EQ(_spirv->getCacheMisses(), 1U);
+    // a_color is never read, so it goes behind the active inputs
+    ASSERT_EQ(compiled.size(), 3U);
+    EXPECT_EQ(compiled[0].location, 0U);
+    EXPECT_EQ(compiled[1].location, 2U);
+    EXPECT_EQ(compiled[2].location, 1U);
+
+    // the first module of a launch comes from the cache, another one compiled in between must not leak its inputs
+    for (bool compileOtherFirst : {false, true}) {
+        relaunch();
+        if (compileOtherFirst) {
+            compile(1);
+        }
+        auto cached = declared;
+        EXPECT_EQ(compileVertex(source, &cached), first);
+        EXPECT_EQ(_spirv->getCacheHits(), 1U);
+        ASSERT_EQ(cached.size(), compiled.size());
+        for (size_t i = 0; i < cached.size(); ++i) {
+            EXPECT_EQ(cached[i].location, compiled[i].location) << cached[i].name;
+        }
+    }
+}
@@ -22,11 +22,17 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
 #include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <vector>
 #include "cocos/math/Math.h"
+#include "cocos/math/Mat4.h"
 #include "cocos/math/MathUtil.h"
+#include "cocos/math/Quaternion.h"
 #include "cocos/math/Utils.h"
 #include "cocos/math/Vec2.h"
+#include "cocos/math/Vec3.h"
 #include "gtest/gtest.h"
 #include "utils.h"
 
@@ -108,4 +114,127 @@ TEST(mathUtilsTest, test9) {
     ExpectEq(IsEqualF(cc::mathutils::absMax(1.0F, 3.0F), 3.0F), true);
     ExpectEq(IsEqualF(cc::mathutils::absMax(-1.0F, 3.0F), 3.0F), true);
     ExpectEq(IsEqualF(cc::mathutils::absMax(1.0F, -3.0F), -3.0F), true);
-}
\ No newline at end of file
+}
+
+TEST(mathUtilsTest, jointKernels) {
+    logLabel = "test the MathUtil multiplyJointMatrices function";
+    cc::Mat4 worlds[2];
+    cc::Mat4 bindposes[2];
+    cc::Mat4::fromRTS(cc::Quaternion(0.F, 0.7071068F, 0.F, 0.7071068F), cc::Vec3(1.F, 2.F, 3.F), cc::Vec3(2.F, 2.F, 2.F), &worlds[0]);
+    cc::Mat4::fromRTS(cc::Quaternion(0.5F, 0.5F, 0.5F, 0.5F), cc::Vec3(-4.F, 0.F, 5.F), cc::Vec3(1.F, 3.F, 1.F), &worlds[1]);
+    cc::Mat4::fromRTS(cc::Quaternion::identity(), cc::Vec3(0.F, -1.F, 0.F), cc::Vec3::ONE, &bindposes[0]);
+    cc::Mat4::fromRTS(cc::Quaternion(0.F, 0.F, 0.7071068F, 0.7071068F), cc::Vec3(2.F, 0.F, 1.F), cc::Vec3::ONE, &bindposes[1]);
+    float palette[24];
+    cc::MathUtil::multiplyJointMatrices(worlds[0].m, bindposes[0].m, 2, palette);
+    for (uint32_t i = 0; i < 2; ++i) {
+        cc::Mat4 expected;
+        cc::Mat4::multiply(worlds[i], bindposes[i], &expected);
+        const float *entry = palette + i * 12;
+        for (uint32_t col = 0; col < 3; ++col) {
+            for (uint32_t row = 0; row < 3; ++row) {
+                ExpectEq(IsEqualF(entry[col * 4 + row], expected.m[col * 4 + row]), true);
+            }
+            ExpectEq(IsEqualF(entry[col * 4 + 3], expected.m[12 + col]), true);
+        }
+    }
+
+    logLabel = "test the MathUtil mergeTransformedAABBs function";
+    const float centers[6] = {0.F, 1.F, 0.F, 1.F, -1.F, 2.F};
+    const float halfExtents[6] = {1.F, 0.5F, 0.25F, 0.5F, 0.5F, 2.F};
+    float boundMin[3] = {INFINITY, INFINITY, INFINITY};
+    float boundMax[3] = {-INFINITY, -INFINITY, -INFINITY};
+    cc::MathUtil::mergeTransformedAABBs(worlds[0].m, centers, halfExtents, 2, boundMin, boundMax);
+    float expectedMin[3] = {INFINITY, INFINITY, INFINITY};
+    float expectedMax[3] = {-INFINITY, -INFINITY, -INFINITY};
+    for (uint32_t i = 0; i < 2; ++i) {
+        const float *m = worlds[i].m;
+        for (uint32_t k = 0; k < 3; ++k) {
+            const float c = m[k] * centers[i * 3] + m[4 + k] * centers[i * 3 + 1] + m[8 + k] * centers[i * 3 + 2] + m[12 + k];
+            const float e = std::abs(m[k]) * halfExtents[i * 3] + std::abs(m[4 + k]) * halfExtents[i * 3 + 1] + std::abs(m[8 + k]) * halfExtents[i * 3 + 2];
+            expectedMin[k] = std::min(expectedMin[k], c - e);
+            expectedMax[k] = std::max(expectedMax[k], c + e);
+        }
+    }
+    for (uint32_t k = 0; k < 3; ++k) {
+        ExpectEq(IsEqualF(boundMin[k], expectedMin[k]), true);
+        ExpectEq(IsEqualF(boundMax[k], expectedMax[k]), true);
+    }
+}
+
+TEST(mathUtilsTest, vertexKernels) {
+    // the 2d vertex layout: xyz, uv, rgba
+    constexpr uint32_t stride = 9;
+    constexpr uint32_t vertexCount = 4099;
+    cc::Mat4 world;
+    cc::Mat4::fromRTS(cc::Quaternion(0.F, 0.F, 0.3826834F, 0.9238795F), cc::Vec3(10.F, -20.F, 1.F), cc::Vec3(1.5F, 0.5F, 1.F), &world);
+    std::vector<float> local(vertexCount * stride);
+    for (uint32_t i = 0; i < local.size(); ++i) {
+        local[i] = static_cast<float>(i % 97) * 0.25F - 12.F;
+    }
+
+    logLabel = "test the MathUtil transformVec3Strided function";
+    std::vector<float> scalar(local.size(), 0.F);
+    std::vector<float> simd(local.size(), 0.F);
+    for (uint32_t i = 0; i < vertexCount; ++i) {
+        reinterpret_cast<cc::Vec3 *>(scalar.data() + i * stride)->transformMat4(*reinterpret_cast<const cc::Vec3 *>(local.data() + i * stride), world);
+    }
+    cc::MathUtil::transformVec3Strided(world.m, local.data(), stride, simd.data(), stride, vertexCount);
+    for (uint32_t i = 0; i < local.size(); ++i) {
+        ExpectEq(IsEqualF(scalar[i], simd[i]), true);
+    }
+
+    logLabel = "test the MathUtil transformVec2Strided function";
+    cc::MathUtil::transformVec2Strided(world.m, local.data(), stride, simd.data(), stride, vertexCount);
+    for (uint32_t i = 0; i < vertexCount; ++i) {
+        cc::Vec3 expected{local[i * stride], local[i * stride + 1], 0.F};
+        expected.transformMat4(expected, world);
+        ExpectEq(IsEqualF(simd[i * stride], expected.x), true);
+        ExpectEq(IsEqualF(simd[i * stride + 1], expected.y), true);
+        ExpectEq(IsEqualF(simd[i * stride + 2], expected.z), true);
+    }
+
+    logLabel = "test the MathUtil fillVec4Strided function";
+    const float color[4] = {1.F, 0.5F, 0.25F, 0.75F};
+    cc::MathUtil::fillVec4Strided(color, simd.data() + 5, stride, vertexCount);
+    for (uint32_t i = 0; i < vertexCount; ++i) {
+        ExpectEq(IsEqualF(simd[i * stride + 3], scalar[i * stride + 3]), true);
+        ExpectEq(IsEqualF(simd[i * stride + 4], scalar[i * stride + 4]), true);
+        for (uint32_t k = 0; k < 4; ++k) {
+            ExpectEq(IsEqualF(simd[i * stride + 5 + k], color[k]), true);
+        }
+    }
+}
+
+// Timing only, run with --gtest_also_run_disabled_tests.
+TEST(mathUtilsTest, DISABLED_vertexKernelsThroughput) {
+    constexpr uint32_t stride = 9;
+    constexpr uint32_t vertexCount = 4099;
+    cc::Mat4 world;
+    cc::Mat4::fromRTS(cc::Quaternion(0.F, 0.F, 0.3826834F, 0.9238795F), cc::Vec3(10.F, -20.F, 1.F), cc::Vec3(1.5F, 0.5F, 1.F), &world);
+    std::vector<float> local(vertexCount * stride);
+    for (uint32_t i = 0; i < local.size(); ++i) {
+        local[i] = static_cast<float>(i % 97) * 0.25F - 12.F;
+    }
+    std::vector<float> scalar(local.size(), 0.F);
+    std::vector<float> simd(local.size(), 0.F);
+
+    // scalar Vec3::transformMat4 per vertex, which the 2d batcher used before, against the kernel
+    using Clock = std::chrono::steady_clock;
+    constexpr uint32_t rounds = 200;
+    auto start = Clock::now();
+    for (uint32_t r = 0; r < rounds; ++r) {
+        for (uint32_t i = 0; i < vertexCount; ++i) {
+            reinterpret_cast<cc::Vec3 *>(scalar.data() + i * stride)->transformMat4(*reinterpret_cast<const cc::Vec3 *>(local.data() + i * stride), world);
+        }
+    }
+    const auto scalarTime = Clock::now() - start;
+    start = Clock::now();
+    for (uint32_t r = 0; r < rounds; ++r) {
+        cc::MathUtil::transformVec3Strided(world.m, local.data(), stride, simd.data(), stride, vertexCount);
+    }
+    const auto simdTime = Clock::now() - start;
+    auto toMs = [](Clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count() / rounds;
+    };
+    printf("Transforming %u vertices: scalar %.3fms, kernel %.3fms\n", vertexCount, toMs(scalarTime), toMs(simdTime));
+}
@@ -0,0 +1,112 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include "base/std/container/vector.h"
+#include "base/threading/MessageQueue.h"
+#include "gtest/gtest.h"
+
+using namespace cc;
+
+namespace {
+
+constexpr uint32_t PRODUCER_COUNT = 4;
+constexpr uint32_t MESSAGE_COUNT = 4096;
+constexpr uint32_t PAYLOAD_SIZE = 1024;
+constexpr uint32_t FREE_INTERVAL = 256;
+
+struct ConsumerState {
+    uint32_t expected{0};
+    uint32_t mismatches{0};
+};
+
+// Each producer thread owns a deferred queue, so chunks are requested through the producer's
+// thread cache and recycled through the consumer's, switching chunks every ~60 messages.
+void produce(std::atomic<uint64_t> &payloadBytes, std::atomic<uint32_t> &mismatches) {
+    auto *queue = ccnew MessageQueue;
+    queue->setImmediateMode(false);
+    queue->runConsumerThread();
+
+    ConsumerState state;
+    ConsumerState *const pState = &state;
+    uint8_t pattern[PAYLOAD_SIZE];
+    for (uint32_t i = 0; i < MESSAGE_COUNT; ++i) {
+        memset(pattern, static_cast<int>(i & 0xFF), sizeof(pattern));
+        const uint8_t *payload = queue->allocateAndCopy<uint8_t>(PAYLOAD_SIZE, pattern);
+
+        ENQUEUE_MESSAGE_3(
+            queue, CheckPayload,
+            state, pState,
+            index, i,
+            payload, payload,
+            {
+                bool valid = index == state->expected++;
+                for (uint32_t j = 0; j < PAYLOAD_SIZE; ++j) {
+                    valid &= payload[j] == static_cast<uint8_t>(index & 0xFF);
+                }
+                state->mismatches += valid ? 0 : 1;
+            });
+
+        if (i % FREE_INTERVAL == FREE_INTERVAL - 1) {
+            // recycled chunks of every queue are handed back to the pool from this queue's consumer
+            MessageQueue::freeChunksInFreeQueue(queue);
+        } else {
+            queue->kick();
+        }
+    }
+    queue->kickAndWait();
+    queue->terminateConsumerThread();
+    delete queue;
+
+    EXPECT_EQ(state.expected, MESSAGE_COUNT);
+    mismatches.fetch_add(state.mismatches);
+    payloadBytes.fetch_add(static_cast<uint64_t>(MESSAGE_COUNT) * PAYLOAD_SIZE);
+}
+
+} // namespace
+
+TEST(MessageQueueTest, chunkCacheAcrossThreads) {
+    MessageQueue::fetchAndResetStats();
+
+    std::atomic<uint64_t> payloadBytes{0};
+    std::atomic<uint32_t> mismatches{0};
+    // several rounds, so that later threads start from chunks pooled by the exited ones
+    for (uint32_t round = 0; round < 3; ++round) {
+        ccstd::vector<std::thread> producers;
+        for (uint32_t i = 0; i < PRODUCER_COUNT; ++i) {
+            producers.emplace_back(produce, std::ref(payloadBytes), std::ref(mismatches));
+        }
+        for (auto &producer : producers) {
+            producer.join();
+        }
+    }
+
+    EXPECT_EQ(mismatches.load(), 0U);
+    const auto stats = MessageQueue::fetchAndResetStats();
+    EXPECT_GE(stats.enqueuedBytes, payloadBytes.load());
+    EXPECT_EQ(MessageQueue::fetchAndResetStats().enqueuedBytes, 0U);
+}
@@ -0,0 +1,153 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "editor-support/FrameCacheBudget.h"
+#include "gtest/gtest.h"
+
+using namespace cc::middleware;
+
+namespace {
+// V3F_T2F_C4B_C4B in 32 bits words
+constexpr uint32_t STRIDE = 7;
+
+class FakeEntry : public FrameCacheEntry {
+public:
+    explicit FakeEntry(std::size_t bytes) : _bytes(bytes) { setCacheBytes(bytes); }
+
+    void use() { touch(); }
+
+    uint32_t packCount = 0;
+    uint32_t unpackCount = 0;
+    bool released = false;
+
+protected:
+    bool isPackable() const override { return true; }
+    bool isEvictable() const override { return true; }
+    std::size_t packFrames() override {
+        ++packCount;
+        return _bytes / 4;
+    }
+    std::size_t unpackFrames() override {
+        ++unpackCount;
+        return _bytes;
+    }
+    std::size_t releaseFrames() override {
+        released = true;
+        return 0;
+    }
+
+private:
+    std::size_t _bytes = 0;
+};
+} // namespace
+
+TEST(MiddlewareFrameCacheTest, packedFrameBuffersRoundTrip) {
+    constexpr uint32_t vertexCount = 300;
+    IOBuffer vb;
+    IOBuffer ib;
+    vb.checkSpace(vertexCount * STRIDE * sizeof(float), true);
+    ib.checkSpace(vertexCount * sizeof(uint16_t), true);
+
+    std::vector<float> source(vertexCount * STRIDE);
+    for (uint32_t v = 0; v < vertexCount; ++v) {
+        float *vertex = source.data() + v * STRIDE;
+        vertex[0] = std::sin(static_cast<float>(v)) * 500.F;
+        vertex[1] = std::cos(static_cast<float>(v) * 0.3F) * 800.F + 100.F;
+        vertex[2] = 0.F;
+        vertex[3] = static_cast<float>(v % 17) / 16.F;
+        vertex[4] = static_cast<float>(v % 29) / 28.F;
+        // colors change every 25 vertices
+        uint32_t color = 0xFF000000U | (v / 25);
+        uint32_t darkColor = 0x00FFFFFFU;
+        memcpy(vertex + 5, &color, sizeof(color));
+        memcpy(vertex + 6, &darkColor, sizeof(darkColor));
+        ib.writeUint16(static_cast<uint16_t>(vertexCount - 1 - v));
+    }
+    vb.writeBytes(reinterpret_cast<const char *>(source.data()), source.size() * sizeof(float));
+
+    const std::size_t rawBytes = vb.getCapacity() + ib.getCapacity();
+    PackedFrameBuffers packed;
+    packed.pack(vb, ib, 2);
+    EXPECT_EQ(vb.getCapacity(), 0);
+    EXPECT_EQ(ib.getCapacity(), 0);
+    EXPECT_LT(packed.getByteSize() * 2, rawBytes);
+
+    packed.unpack(vb, ib);
+    EXPECT_TRUE(packed.empty());
+    ASSERT_EQ(vb.getCurPos(), source.size() * sizeof(float));
+    ASSERT_EQ(ib.getCurPos(), vertexCount * sizeof(uint16_t));
+
+    const auto *result = reinterpret_cast<const float *>(vb.getBuffer());
+    const auto *indices = reinterpret_cast<const uint16_t *>(ib.getBuffer());
+    for (uint32_t v = 0; v < vertexCount; ++v) {
+        const float *expected = source.data() + v * STRIDE;
+        const float *actual = result + v * STRIDE;
+        // half of a quantization step over the attribute range
+        EXPECT_NEAR(actual[0], expected[0], 1000.F / 65535.F);
+        EXPECT_NEAR(actual[1], expected[1], 1600.F / 65535.F);
+        EXPECT_EQ(actual[2], 0.F);
+        EXPECT_NEAR(actual[3], expected[3], 1.F / 65535.F);
+        EXPECT_NEAR(actual[4], expected[4], 1.F / 65535.F);
+        EXPECT_EQ(memcmp(actual + 5, expected + 5, 2 * sizeof(uint32_t)), 0);
+        EXPECT_EQ(indices[v], vertexCount - 1 - v);
+    }
+}
+
+TEST(MiddlewareFrameCacheTest, budgetPacksThenEvictsLeastRecentlyUsed) {
+    auto *budget = FrameCacheBudget::getInstance();
+    budget->setBudget(10000);
+    {
+        FakeEntry oldest(800);
+        FakeEntry older(800);
+        FakeEntry recent(800);
+        EXPECT_EQ(budget->getUsedBytes(), 2400);
+        budget->update();
+        older.use();
+        recent.use();
+        budget->update();
+        EXPECT_EQ(oldest.packCount, 0);
+
+        budget->setBudget(1000);
+        // entries used in this frame are kept as they are
+        recent.use();
+        budget->update();
+        EXPECT_EQ(recent.packCount, 0);
+        EXPECT_EQ(oldest.packCount, 1);
+        EXPECT_EQ(older.packCount, 1);
+        // packing alone does not fit, the least recently used one goes first
+        EXPECT_TRUE(oldest.released);
+        EXPECT_FALSE(older.released);
+        EXPECT_EQ(budget->getUsedBytes(), 1000);
+
+        older.use();
+        EXPECT_EQ(older.unpackCount, 1);
+        EXPECT_EQ(budget->getUsedBytes(), 1600);
+    }
+    EXPECT_EQ(budget->getUsedBytes(), 0);
+    budget->setBudget(FrameCacheBudget::DEFAULT_BUDGET);
+}
@@ -0,0 +1,512 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include "2d/renderer/RenderDrawInfo.h"
+#include "2d/renderer/RenderEntity.h"
+#include "base/Ptr.h"
+#include "core/assets/Material.h"
+#include "core/assets/Texture2D.h"
+#include "core/scene-graph/Node.h"
+#include "editor-support/MeshBuffer.h"
+#include "editor-support/MiddlewareManager.h"
+#include "editor-support/spine-creator-support/AttachmentVertices.h"
+#include "editor-support/spine-creator-support/SkeletonAnimation.h"
+#include "editor-support/spine-creator-support/spine-cocos2dx.h"
+#include "editor-support/spine/spine.h"
+#include "gtest/gtest.h"
+
+using namespace spine;
+using cc::middleware::IMiddleware;
+using cc::middleware::MiddlewareManager;
+
+namespace {
+
+constexpr int SKELETON_COUNT = 24;
+constexpr int SLOT_COUNT = 12;
+constexpr int FRAME_COUNT = 6;
+constexpr float FRAME_TIME = 1.0F / 10.0F;
+
+uint16_t quadTriangles[6] = {0, 1, 2, 2, 3, 0};
+
+// Gives every region and mesh attachment vertices on one of two textures, without an atlas.
+class TexturedAttachmentLoader : public AttachmentLoader {
+public:
+    explicit TexturedAttachmentLoader(cc::middleware::Texture2D **textures) : _textures(textures) {}
+
+    RegionAttachment *newRegionAttachment(Skin & /*skin*/, const String &name, const String & /*path*/) override {
+        return new (__FILE__, __LINE__) RegionAttachment(name);
+    }
+    MeshAttachment *newMeshAttachment(Skin & /*skin*/, const String &name, const String & /*path*/) override {
+        return new (__FILE__, __LINE__) MeshAttachment(name);
+    }
+    BoundingBoxAttachment *newBoundingBoxAttachment(Skin & /*skin*/, const String &name) override {
+        return new (__FILE__, __LINE__) BoundingBoxAttachment(name);
+    }
+    PathAttachment *newPathAttachment(Skin & /*skin*/, const String &name) override {
+        return new (__FILE__, __LINE__) PathAttachment(name);
+    }
+    PointAttachment *newPointAttachment(Skin & /*skin*/, const String &name) override {
+        return new (__FILE__, __LINE__) PointAttachment(name);
+    }
+    ClippingAttachment *newClippingAttachment(Skin & /*skin*/, const String &name) override {
+        return new (__FILE__, __LINE__) ClippingAttachment(name);
+    }
+
+    void configureAttachment(Attachment *attachment) override {
+        // every three attachments switch the texture, so draw infos are split by texture and blend mode
+        auto *texture = _textures[(_count++ / 3) % 2];
+        if (attachment->getRTTI().isExactly(RegionAttachment::rtti)) {
+            auto *region = static_cast<RegionAttachment *>(attachment);
+            auto *vertices = new AttachmentVertices(texture, 4, quadTriangles, 6);
+            for (int i = 0; i < 4; ++i) {
+                vertices->_triangles->verts[i].texCoord.u = static_cast<float>(i % 2);
+                vertices->_triangles->verts[i].texCoord.v = static_cast<float>(i / 2);
+            }
+            region->setRendererObject(vertices, [](void *object) { delete static_cast<AttachmentVertices *>(object); });
+        } else if (attachment->getRTTI().isExactly(MeshAttachment::rtti)) {
+            auto *mesh = static_cast<MeshAttachment *>(attachment);
+            auto *vertices = new AttachmentVertices(texture, static_cast<int>(mesh->getWorldVerticesLength() >> 1),
+                                                    mesh->getTriangles().buffer(), static_cast<int>(mesh->getTriangles().size()));
+            for (size_t i = 0, ii = 0; ii < mesh->getWorldVerticesLength(); ++i, ii += 2) {
+                vertices->_triangles->verts[i].texCoord.u = mesh->getUVs()[ii];
+                vertices->_triangles->verts[i].texCoord.v = mesh->getUVs()[ii + 1];
+            }
+            mesh->setRendererObject(vertices, [](void *object) { delete static_cast<AttachmentVertices *>(object); });
+        }
+    }
+
+private:
+    cc::middleware::Texture2D **_textures;
+    int _count{0};
+};
+
+std::string num(float value) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%g", value);
+    return buffer;
+}
+
+// Region, mesh and clipping attachments with all blend modes, animated bones and slot colors and two events.
+std::string makeRigJson() {
+    std::string json = R"({"skeleton":{"hash":"mw","spine":"3.8.99"},"bones":[{"name":"root"})";
+    for (int i = 1; i <= 6; ++i) {
+        json += R"(,{"name":"b)" + std::to_string(i) + R"(","parent":")" + (i == 1 ? std::string("root") : "b" + std::to_string(i / 2)) +
+                R"(","length":20,"x":)" + num(static_cast<float>(i) * 6.0F) + R"(,"rotation":)" + num(static_cast<float>(i) * 15.0F) + "}";
+    }
+    const char *blends[] = {"normal", "additive", "multiply", "screen"};
+    json += R"(],"slots":[)";
+    for (int i = 0; i < SLOT_COUNT; ++i) {
+        json += i ? "," : "";
+        json += R"({"name":"s)" + std::to_string(i) + R"(","bone":"b)" + std::to_string(1 + i % 6) + R"(","attachment":"a)" + std::to_string(i) +
+                R"(","blend":")" + blends[(i / 4) % 4] + R"("})";
+    }
+    json += R"(],"skins":[{"name":"default","attachments":{)";
+    for (int i = 0; i < SLOT_COUNT; ++i) {
+        json += i ? "," : "";
+        json += R"("s)" + std::to_string(i) + R"(":{"a)" + std::to_string(i) + R"(":)";
+        if (i == 5) {
+            json += R"({"type":"clipping","end":"s8","vertexCount":4,"vertices":[-30,-30,40,-20,35,45,-25,30]})";
+        } else if (i % 2 == 0) {
+            json += R"({"x":)" + num(static_cast<float>(i)) + R"(,"y":2,"width":24,"height":16})";
+        } else {
+            json += R"({"type":"mesh","uvs":[0,0,1,0,1,1,0,1],"triangles":[0,1,2,2,3,0],"vertices":[-12,-12,12,-12,12,12,-12,12],"hull":4,"width":24,"height":24})";
+        }
+        json += "}";
+    }
+    json += R"(}}],"events":{"hit":{"int":1}},"animations":{"walk":{"bones":{)";
+    for (int i = 1; i <= 6; ++i) {
+        json += i > 1 ? "," : "";
+        json += R"("b)" + std::to_string(i) + R"(":{"rotate":[{"angle":0},{"time":0.3,"angle":)" + num(static_cast<float>(i) * 20.0F) +
+                R"(},{"time":0.6,"angle":0}],"translate":[{"x":0},{"time":0.6,"x":)" + num(static_cast<float>(i)) + "}]}";
+    }
+    json += R"(},"slots":{"s2":{"color":[{"color":"ffffffff"},{"time":0.6,"color":"ff000080"}]}},"events":[{"time":0.15,"name":"hit"},{"time":0.45,"name":"hit","int":2}]}}})";
+    return json;
+}
+
+// requestMaterial recompiles shaders, the cache is primed with plain materials for every blend mode instead.
+class TestSkeleton : public SkeletonAnimation {
+public:
+    TestSkeleton(SkeletonData *data, cc::Node *node) {
+        initWithData(data, false);
+        // the node keeps the entity as its user data and deletes it
+        auto *entity = ccnew cc::RenderEntity(cc::RenderEntityType::DYNAMIC);
+        entity->setNode(node);
+        setRenderEntity(entity);
+        using cc::gfx::BlendFactor;
+        const BlendFactor factors[][2] = {
+            {BlendFactor::SRC_ALPHA, BlendFactor::ONE_MINUS_SRC_ALPHA},
+            {BlendFactor::SRC_ALPHA, BlendFactor::ONE},
+            {BlendFactor::DST_COLOR, BlendFactor::ONE_MINUS_SRC_ALPHA},
+            {BlendFactor::ONE, BlendFactor::ONE_MINUS_SRC_COLOR},
+        };
+        for (const auto &factor : factors) {
+            _materialCaches[static_cast<uint32_t>(factor[0]) << 16 | static_cast<uint32_t>(factor[1])] = new cc::Material();
+        }
+        setEventListener([this](TrackEntry * /*entry*/, Event *event) {
+            events.push_back(event->getIntValue());
+            eventThreads.push_back(std::this_thread::get_id());
+        });
+        setAnimation(0, "walk", true);
+    }
+
+    cc::RenderEntity *entity() const { return _entity; }
+
+    ccstd::vector<int> events;
+    ccstd::vector<std::thread::id> eventThreads;
+};
+
+template <typename T, typename F>
+void forEachOnThreads(const ccstd::vector<T *> &items, F func) {
+    std::atomic<size_t> next{0};
+    ccstd::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&]() {
+            for (size_t i = next++; i < items.size(); i = next++) {
+                func(items[i]);
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+struct DrawCapture {
+    cc::Material *material;
+    cc::UIMeshBuffer *meshBuffer;
+    uint32_t indexOffset;
+    uint32_t ibCount;
+};
+
+struct FrameCapture {
+    ccstd::vector<ccstd::vector<DrawCapture>> draws;
+    ccstd::vector<uint8_t> vertices[2];
+    ccstd::vector<uint8_t> indices[2];
+};
+
+// Clipped vertices leave z untouched, it holds whatever the buffer held before, so only z is skipped.
+void expectSameVertices(const ccstd::vector<uint8_t> &actual, const ccstd::vector<uint8_t> &expected, size_t stride, int frame) {
+    ASSERT_EQ(actual.size(), expected.size()) << "frame " << frame;
+    constexpr size_t Z_OFFSET = 2 * sizeof(float);
+    for (size_t offset = 0; offset < expected.size(); offset += stride) {
+        EXPECT_EQ(memcmp(&actual[offset], &expected[offset], Z_OFFSET), 0) << "frame " << frame << " vertex " << offset / stride;
+        EXPECT_EQ(memcmp(&actual[offset + Z_OFFSET + sizeof(float)], &expected[offset + Z_OFFSET + sizeof(float)], stride - Z_OFFSET - sizeof(float)), 0)
+            << "frame " << frame << " vertex " << offset / stride;
+    }
+}
+
+// Skeletons sharing one skeleton data, each on its own node.
+struct SkeletonWorld {
+    ccstd::vector<cc::IntrusivePtr<cc::Node>> nodes;
+    ccstd::vector<TestSkeleton *> skeletons;
+
+    explicit SkeletonWorld(SkeletonData *data) {
+        for (int i = 0; i < SKELETON_COUNT; ++i) {
+            cc::IntrusivePtr<cc::Node> node = ccnew cc::Node();
+            node->setPosition(static_cast<float>(i) * 10.0F, static_cast<float>(i % 5), 0.0F);
+            nodes.emplace_back(node);
+            auto *skeleton = new TestSkeleton(data, node);
+            // batched skeletons bake the node transform into the vertices
+            skeleton->setBatchEnabled(i % 2 == 0);
+            skeleton->setUseTint(i % 3 == 0);
+            skeletons.push_back(skeleton);
+        }
+    }
+
+    ~SkeletonWorld() {
+        for (auto *skeleton : skeletons) {
+            delete skeleton;
+        }
+    }
+
+    // Same steps as MiddlewareManager::update, with the poses evaluated on several threads.
+    void update(bool parallel) {
+        if (!parallel) {
+            for (auto *skeleton : skeletons) {
+                skeleton->update(FRAME_TIME);
+            }
+            return;
+        }
+        ccstd::vector<TestSkeleton *> posing;
+        for (auto *skeleton : skeletons) {
+            if (skeleton->preUpdate(FRAME_TIME)) {
+                posing.push_back(skeleton);
+            }
+        }
+        EXPECT_EQ(posing.size(), skeletons.size());
+        forEachOnThreads(posing, [](TestSkeleton *skeleton) { skeleton->updatePose(); });
+        for (auto *skeleton : posing) {
+            skeleton->postUpdate();
+        }
+    }
+
+    // Does what MiddlewareManager::render does before the mesh buffers are handed to the batcher.
+    FrameCapture render(bool parallel) {
+        auto *mgr = MiddlewareManager::getInstance();
+        for (int format : {VF_XYZUVC, VF_XYZUVCC}) {
+            mgr->getMeshBuffer(format)->reset();
+        }
+        mgr->getAttachInfoMgr()->reset();
+        mgr->isRendering = true;
+        if (parallel) {
+            ccstd::vector<TestSkeleton *> emitting;
+            for (auto *skeleton : skeletons) {
+                if (skeleton->prepareVertices()) {
+                    emitting.push_back(skeleton);
+                }
+            }
+            EXPECT_EQ(emitting.size(), skeletons.size());
+            forEachOnThreads(emitting, [](TestSkeleton *skeleton) { skeleton->emitVertices(); });
+        }
+        for (auto *skeleton : skeletons) {
+            skeleton->render(FRAME_TIME);
+        }
+        mgr->isRendering = false;
+
+        FrameCapture capture;
+        for (auto *skeleton : skeletons) {
+            auto &draws = capture.draws.emplace_back();
+            for (auto *drawInfo : skeleton->entity()->getDynamicRenderDrawInfos()) {
+                draws.push_back({drawInfo->getMaterial(), drawInfo->getMeshBuffer(), drawInfo->getIndexOffset(), drawInfo->getIbCount()});
+            }
+        }
+        const int formats[] = {VF_XYZUVC, VF_XYZUVCC};
+        for (int i = 0; i < 2; ++i) {
+            auto *mb = mgr->getMeshBuffer(formats[i]);
+            EXPECT_EQ(mb->getBufferPos(), 0);
+            const auto *vb = mb->getVB().getBuffer();
+            capture.vertices[i].assign(vb, vb + mb->getVB().length());
+            const auto *ib = mb->getIB().getBuffer();
+            capture.indices[i].assign(ib, ib + mb->getIB().length());
+        }
+        return capture;
+    }
+};
+
+class CountingMiddleware : public IMiddleware {
+public:
+    explicit CountingMiddleware(bool twoPhase) : _twoPhase(twoPhase) {}
+
+    void update(float /*dt*/) override { ++updates; }
+    void render(float /*dt*/) override { ++renders; }
+    bool preUpdate(float dt) override {
+        if (!_twoPhase) {
+            return IMiddleware::preUpdate(dt);
+        }
+        ++preUpdates;
+        return true;
+    }
+    void updatePose() override { ++poses; }
+    void postUpdate() override {
+        ++postUpdates;
+        if (onPostUpdate) onPostUpdate();
+    }
+    bool prepareVertices() override { return _twoPhase; }
+    void emitVertices() override { ++emits; }
+
+    std::function<void()> onPostUpdate;
+    int updates{0};
+    int renders{0};
+    int preUpdates{0};
+    std::atomic<int> poses{0};
+    int postUpdates{0};
+    std::atomic<int> emits{0};
+
+private:
+    bool _twoPhase;
+};
+
+// Two atlas page textures, the attachments keep them alive until the skeleton data is deleted.
+struct RigTextures {
+    cc::IntrusivePtr<cc::Texture2D> realTextures[2]{ccnew cc::Texture2D(), ccnew cc::Texture2D()};
+    cc::IntrusivePtr<cc::middleware::Texture2D> textures[2]{new cc::middleware::Texture2D(), new cc::middleware::Texture2D()};
+    cc::middleware::Texture2D *pointers[2]{};
+
+    RigTextures() {
+        for (int i = 0; i < 2; ++i) {
+            textures[i]->setRealTexture(realTextures[i].get());
+            pointers[i] = textures[i].get();
+        }
+    }
+};
+
+// Without the script bindings nothing tracks the disposed spine objects.
+SkeletonData *readRig(SkeletonJson &json) {
+    setSpineObjectDisposeCallback([](void * /*object*/) {});
+    return json.readSkeletonData(makeRigJson().c_str());
+}
+
+class EventCounter : public AnimationStateListenerObject {
+public:
+    void callback(AnimationState * /*state*/, EventType type, TrackEntry * /*entry*/, Event * /*event*/) override {
+        if (type == EventType_Event) ++events;
+    }
+
+    int events{0};
+};
+
+} // namespace
+
+TEST(MiddlewareParallelUpdateTest, deferredDrainRestoresPreviousState) {
+    RigTextures textures;
+    TexturedAttachmentLoader loader(textures.pointers);
+    SkeletonJson json(&loader);
+    SkeletonData *data = readRig(json);
+    ASSERT_NE(data, nullptr) << json.getError().buffer();
+
+    AnimationStateData stateData(data);
+    AnimationState state(&stateData);
+    EventCounter counter;
+    state.setListener(&counter);
+    Skeleton skeleton(data);
+    state.setAnimation(0, "walk", true);
+
+    EXPECT_FALSE(state.setEventDrainDeferred(true));
+    // An outer deferral has to survive an inner one, as in SkeletonAnimation::updatePose.
+    bool wasDeferred = state.setEventDrainDeferred(true);
+    EXPECT_TRUE(wasDeferred);
+    state.update(0.2F);
+    state.apply(skeleton);
+    EXPECT_TRUE(state.setEventDrainDeferred(wasDeferred));
+    state.drainEvents();
+    EXPECT_EQ(counter.events, 0);
+
+    EXPECT_TRUE(state.setEventDrainDeferred(false));
+    state.drainEvents();
+    EXPECT_EQ(counter.events, 1);
+
+    state.clearTracks();
+    delete data;
+}
+
+TEST(MiddlewareParallelUpdateTest, twoPhaseUpdateAndTombstones) {
+    // without mesh buffers render doesn't sync to the batcher
+    MiddlewareManager::destroyInstance();
+    auto *mgr = MiddlewareManager::getInstance();
+    ccstd::vector<std::unique_ptr<CountingMiddleware>> editors;
+    for (int i = 0; i < 40; ++i) {
+        editors.emplace_back(std::make_unique<CountingMiddleware>(i % 4 != 0));
+        mgr->addTimer(editors.back().get());
+    }
+    // Removing from a callback tombstones the editor, it is neither posed again nor rendered.
+    editors[1]->onPostUpdate = [&]() { mgr->removeTimer(editors[3].get()); };
+    mgr->addTimer(editors[0].get());
+
+    mgr->setParallelUpdateEnabled(true);
+    mgr->update(FRAME_TIME);
+    mgr->update(FRAME_TIME);
+    mgr->render(FRAME_TIME);
+    mgr->setParallelUpdateEnabled(false);
+    mgr->update(FRAME_TIME);
+    mgr->render(FRAME_TIME);
+
+    for (int i = 0; i < 40; ++i) {
+        const auto &editor = *editors[i];
+        if (i % 4 == 0) {
+            EXPECT_EQ(editor.updates, 3) << i;
+            EXPECT_EQ(editor.poses, 0) << i;
+            EXPECT_EQ(editor.emits, 0) << i;
+            EXPECT_EQ(editor.renders, 2) << i;
+        } else if (i == 3) {
+            // removed in the post update of an earlier editor, after it was posed
+            EXPECT_EQ(editor.preUpdates, 1);
+            EXPECT_EQ(editor.poses, 1);
+            EXPECT_EQ(editor.postUpdates, 0);
+            EXPECT_EQ(editor.updates, 0);
+            EXPECT_EQ(editor.renders, 0);
+        } else {
+            EXPECT_EQ(editor.preUpdates, 2) << i;
+            EXPECT_EQ(editor.poses, 2) << i;
+            EXPECT_EQ(editor.postUpdates, 2) << i;
+            EXPECT_EQ(editor.updates, 1) << i;
+            EXPECT_EQ(editor.emits, 1) << i;
+            EXPECT_EQ(editor.renders, 2) << i;
+        }
+    }
+
+    for (auto &editor : editors) {
+        mgr->removeTimer(editor.get());
+    }
+    mgr->update(FRAME_TIME);
+    MiddlewareManager::destroyInstance();
+}
+
+TEST(MiddlewareParallelUpdateTest, parallelMatchesSerial) {
+    RigTextures textures;
+    TexturedAttachmentLoader loader(textures.pointers);
+    SkeletonJson json(&loader);
+    SkeletonData *data = readRig(json);
+    ASSERT_NE(data, nullptr) << json.getError().buffer();
+
+    {
+        SkeletonWorld serial(data);
+        SkeletonWorld parallel(data);
+        const auto mainThread = std::this_thread::get_id();
+
+        for (int frame = 0; frame < FRAME_COUNT; ++frame) {
+            serial.update(false);
+            auto expected = serial.render(false);
+            parallel.update(true);
+            auto actual = parallel.render(true);
+
+            ASSERT_EQ(actual.draws.size(), expected.draws.size());
+            for (size_t i = 0; i < expected.draws.size(); ++i) {
+                ASSERT_EQ(actual.draws[i].size(), expected.draws[i].size()) << "frame " << frame << " skeleton " << i;
+                // textures and blend modes change along the draw order
+                EXPECT_GT(expected.draws[i].size(), 2U);
+                for (size_t d = 0; d < expected.draws[i].size(); ++d) {
+                    const auto &e = expected.draws[i][d];
+                    const auto &a = actual.draws[i][d];
+                    EXPECT_EQ(a.meshBuffer, e.meshBuffer);
+                    EXPECT_EQ(a.indexOffset, e.indexOffset) << "frame " << frame << " skeleton " << i << " draw " << d;
+                    EXPECT_EQ(a.ibCount, e.ibCount) << "frame " << frame << " skeleton " << i << " draw " << d;
+                    EXPECT_NE(a.material, nullptr);
+                }
+            }
+            expectSameVertices(actual.vertices[0], expected.vertices[0], sizeof(cc::middleware::V3F_T2F_C4B), frame);
+            expectSameVertices(actual.vertices[1], expected.vertices[1], sizeof(cc::middleware::V3F_T2F_C4B_C4B), frame);
+            for (int i = 0; i < 2; ++i) {
+                EXPECT_EQ(actual.indices[i], expected.indices[i]) << "frame " << frame;
+            }
+        }
+
+        EXPECT_FALSE(serial.skeletons[0]->events.empty());
+        for (int i = 0; i < SKELETON_COUNT; ++i) {
+            EXPECT_EQ(parallel.skeletons[i]->events, serial.skeletons[i]->events);
+            for (auto thread : parallel.skeletons[i]->eventThreads) {
+                EXPECT_EQ(thread, mainThread);
+            }
+        }
+    }
+    delete data;
+    MiddlewareManager::destroyInstance();
+}
@@ -0,0 +1,145 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <tuple>
+#include "base/std/container/vector.h"
+#include "gtest/gtest.h"
+#include "renderer/pipeline/custom/NativePipelineTypes.h"
+
+using namespace cc;
+using namespace cc::render;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t DRAW_COUNT = 20000;
+constexpr uint32_t FRAME_COUNT = 20;
+
+// The fields the queues were sorted by before the keys were packed into 64 bits.
+struct LegacyDrawInstance {
+    uint32_t priority{0};
+    uint32_t hash{0};
+    float depth{0};
+    uint32_t shaderID{0};
+};
+
+bool lessOpaqueOrCutout(const LegacyDrawInstance &lhs, const LegacyDrawInstance &rhs) {
+    return std::forward_as_tuple(lhs.hash, lhs.depth, lhs.shaderID) <
+           std::forward_as_tuple(rhs.hash, rhs.depth, rhs.shaderID);
+}
+
+bool lessTransparent(const LegacyDrawInstance &lhs, const LegacyDrawInstance &rhs) {
+    return std::forward_as_tuple(lhs.priority, lhs.hash, -lhs.depth, lhs.shaderID) <
+           std::forward_as_tuple(rhs.priority, rhs.hash, -rhs.depth, rhs.shaderID);
+}
+
+ccstd::vector<LegacyDrawInstance> makeDraws() {
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<uint32_t> priority(0, 3);
+    std::uniform_int_distribution<uint32_t> passPriority(127, 129);
+    std::uniform_int_distribution<uint32_t> passIndex(0, 2);
+    std::uniform_int_distribution<int32_t> depth(-1000, 3000);
+    std::uniform_int_distribution<uint32_t> shader(0, 0xFFFF);
+
+    ccstd::vector<LegacyDrawInstance> draws(DRAW_COUNT);
+    for (auto &draw : draws) {
+        draw.priority = priority(rng);
+        draw.hash = (passPriority(rng) << 16) | (128 << 8) | passIndex(rng);
+        draw.depth = static_cast<float>(depth(rng)) * 0.25F;
+        draw.shaderID = shader(rng);
+    }
+    return draws;
+}
+
+bool lessTransparentWithoutShader(const LegacyDrawInstance &lhs, const LegacyDrawInstance &rhs) {
+    return std::forward_as_tuple(lhs.priority, lhs.hash, -lhs.depth) <
+           std::forward_as_tuple(rhs.priority, rhs.hash, -rhs.depth);
+}
+
+template <class Less, class OrderLess, class Sort>
+void compareSorts(const char *name, Less less, OrderLess orderLess, Sort sort, uint32_t frameCount, bool printTimings) {
+    const auto draws = makeDraws();
+    RenderDrawQueue queue(boost::container::pmr::get_default_resource());
+
+    Clock::duration legacyTime{0};
+    Clock::duration radixTime{0};
+    for (uint32_t frame = 0; frame < frameCount; ++frame) {
+        auto legacy = draws;
+        auto begin = Clock::now();
+        std::sort(legacy.begin(), legacy.end(), less);
+        legacyTime += Clock::now() - begin;
+
+        queue.instances.clear();
+        for (uint32_t i = 0; i < DRAW_COUNT; ++i) {
+            const auto &draw = draws[i];
+            queue.instances.emplace_back(DrawInstance{nullptr, draw.priority, draw.hash, draw.depth, draw.shaderID, i});
+        }
+        begin = Clock::now();
+        sort(queue);
+        radixTime += Clock::now() - begin;
+    }
+
+    // same order as the comparator, ties keep their insertion order
+    for (uint32_t i = 1; i < DRAW_COUNT; ++i) {
+        const auto &prev = draws[queue.instances[i - 1].passIndex];
+        const auto &curr = draws[queue.instances[i].passIndex];
+        EXPECT_FALSE(orderLess(curr, prev));
+    }
+
+    if (printTimings) {
+        auto toMs = [frameCount](Clock::duration duration) {
+            return std::chrono::duration<double, std::milli>(duration).count() / frameCount;
+        };
+        printf("Sorting %u %s draws: comparator %.3fms, radix %.3fms\n", DRAW_COUNT, name, toMs(legacyTime), toMs(radixTime));
+    }
+}
+} // namespace
+
+TEST(NativeRenderQueueTest, sortOpaqueOrCutout) {
+    compareSorts(
+        "opaque", lessOpaqueOrCutout, lessOpaqueOrCutout,
+        [](RenderDrawQueue &queue) { queue.sortOpaqueOrCutout(); }, 1, false);
+}
+
+TEST(NativeRenderQueueTest, sortTransparent) {
+    // the transparent key has no room for the shader, it only breaks ties of the comparator
+    compareSorts(
+        "transparent", lessTransparent, lessTransparentWithoutShader,
+        [](RenderDrawQueue &queue) { queue.sortTransparent(); }, 1, false);
+}
+
+// Timing only, run with --gtest_also_run_disabled_tests.
+TEST(NativeRenderQueueTest, DISABLED_sortThroughput) {
+    compareSorts(
+        "opaque", lessOpaqueOrCutout, lessOpaqueOrCutout,
+        [](RenderDrawQueue &queue) { queue.sortOpaqueOrCutout(); }, FRAME_COUNT, true);
+    compareSorts(
+        "transparent", lessTransparent, lessTransparentWithoutShader,
+        [](RenderDrawQueue &queue) { queue.sortTransparent(); }, FRAME_COUNT, true);
+}
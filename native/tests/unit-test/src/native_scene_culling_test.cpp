@@ -0,0 +1,315 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <random>
+#include "base/std/container/unordered_map.h"
+#include "base/std/container/unordered_set.h"
+#include "base/std/container/vector.h"
+#include "core/Root.h"
+#include "core/geometry/Frustum.h"
+#include "core/scene-graph/Node.h"
+#include "gtest/gtest.h"
+#include "math/Math.h"
+#include "renderer/GFXDeviceManager.h"
+#include "renderer/pipeline/InstancedBuffer.h"
+#include "renderer/pipeline/custom/NativeSceneCulling.h"
+#include "scene/Camera.h"
+#include "scene/Model.h"
+#include "scene/Pass.h"
+#include "scene/RenderScene.h"
+#include "scene/SubModel.h"
+
+using namespace cc;
+using namespace cc::render;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+using PassList = ccstd::vector<IntrusivePtr<scene::Pass>>;
+
+constexpr uint32_t MODEL_COUNT = 4000;
+constexpr uint32_t CAMERA_COUNT = 8;
+constexpr uint32_t POINT_MODEL_STRIDE = 100;
+constexpr uint32_t FRAME_COUNT = 2;
+constexpr uint32_t BENCHMARK_MODEL_COUNT = 20000;
+constexpr uint32_t BENCHMARK_FRAME_COUNT = 20;
+
+class CullingPass final : public scene::Pass {
+public:
+    CullingPass(Root *root, uint32_t passID, bool transparent, bool instancing) : Pass(root) {
+        _passID = passID;
+        _phaseID = passID;
+        _blendState.targets[0].blend = transparent;
+        _batchingScheme = instancing ? scene::BatchingSchemes::INSTANCING : scene::BatchingSchemes::NONE;
+    }
+};
+
+// A sub model with its own input assembler and descriptor set, and one float per instance.
+class CullingSubModel final : public scene::SubModel {
+public:
+    CullingSubModel(gfx::Device *device, gfx::DescriptorSetLayout *layout, const std::shared_ptr<PassList> &passes, float value) {
+        _device = device;
+        _passes = passes;
+        _inputAssembler = device->createInputAssembler({{{"a_position", gfx::Format::RGB32F}}});
+        _descriptorSet = device->createDescriptorSet({layout});
+        _instancedAttributeBlock.buffer = Uint8Array(sizeof(value));
+        std::memcpy(_instancedAttributeBlock.buffer.buffer()->getData(), &value, sizeof(value));
+        _instancedAttributeBlock.attributes.emplace_back(gfx::Attribute{"a_value", gfx::Format::R32F});
+    }
+};
+
+class CullingModel final : public scene::Model {
+public:
+    void addSubModel(scene::SubModel *subModel) {
+        _subModels.emplace_back(subModel);
+    }
+};
+
+struct CameraSnapshot {
+    ccstd::vector<DrawInstance> opaque;
+    ccstd::vector<DrawInstance> transparent;
+    ccstd::vector<pipeline::InstancedBuffer *> opaqueInstancing;
+    ccstd::vector<pipeline::InstancedBuffer *> transparentInstancing;
+};
+
+struct InstancedSnapshot {
+    uint32_t count{0};
+    ccstd::vector<uint8_t> data;
+};
+
+void clearInstancedBuffers(const ccstd::vector<IntrusivePtr<scene::Pass>> &passes) {
+    for (const auto &pass : passes) {
+        if (pass->getBatchingScheme() == scene::BatchingSchemes::INSTANCING) {
+            pass->getInstancedBuffer()->clear();
+        }
+    }
+}
+
+double buildQueues(SceneRenderQueues &sceneQueues, const ccstd::vector<IntrusivePtr<scene::Pass>> &passes, bool parallel, uint32_t frameCount) {
+    const auto begin = Clock::now();
+    for (uint32_t frame = 0; frame < frameCount; ++frame) {
+        clearInstancedBuffers(passes);
+        buildCameraRenderQueues(LayoutGraphData::null_vertex(), nullptr, sceneQueues, parallel);
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count() / frameCount;
+}
+
+ccstd::vector<CameraSnapshot> snapshotQueues(SceneRenderQueues &sceneQueues, const scene::RenderScene *scene,
+                                             const ccstd::vector<IntrusivePtr<scene::Camera>> &cameras) {
+    ccstd::vector<CameraSnapshot> snapshots;
+    for (const auto &camera : cameras) {
+        const auto &queue = sceneQueues[scene][camera.get()];
+        auto &snapshot = snapshots.emplace_back();
+        snapshot.opaque.assign(queue.opaqueQueue.instances.begin(), queue.opaqueQueue.instances.end());
+        snapshot.transparent.assign(queue.transparentQueue.instances.begin(), queue.transparentQueue.instances.end());
+        snapshot.opaqueInstancing.assign(queue.opaqueInstancingQueue.sortedBatches.begin(), queue.opaqueInstancingQueue.sortedBatches.end());
+        snapshot.transparentInstancing.assign(queue.transparentInstancingQueue.sortedBatches.begin(), queue.transparentInstancingQueue.sortedBatches.end());
+    }
+    return snapshots;
+}
+
+ccstd::vector<InstancedSnapshot> snapshotInstances(const ccstd::vector<IntrusivePtr<scene::Pass>> &passes) {
+    ccstd::vector<InstancedSnapshot> snapshots;
+    for (const auto &pass : passes) {
+        if (pass->getBatchingScheme() != scene::BatchingSchemes::INSTANCING) {
+            continue;
+        }
+        for (const auto &instance : pass->getInstancedBuffer()->getInstances()) {
+            auto &snapshot = snapshots.emplace_back();
+            snapshot.count = instance.count;
+            snapshot.data.assign(instance.data, instance.data + instance.stride * instance.count);
+        }
+    }
+    return snapshots;
+}
+
+void expectSameInstances(const ccstd::vector<DrawInstance> &expected, const ccstd::vector<DrawInstance> &actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(expected[i].subModel, actual[i].subModel);
+        EXPECT_EQ(expected[i].passIndex, actual[i].passIndex);
+        EXPECT_EQ(expected[i].priority, actual[i].priority);
+        EXPECT_EQ(expected[i].hash, actual[i].hash);
+        EXPECT_EQ(expected[i].depth, actual[i].depth);
+        EXPECT_EQ(expected[i].shaderID, actual[i].shaderID);
+    }
+}
+
+// builds the queues of every camera one by one and in parallel jobs, both must match
+void buildCameraQueues(uint32_t modelCount, uint32_t frameCount, bool printTimings) {
+    auto *device = gfx::DeviceManager::createHeadless(gfx::DeviceInfo{});
+    ASSERT_NE(device, nullptr);
+    {
+        Root root(device);
+        IntrusivePtr<scene::RenderScene> scene = ccnew scene::RenderScene();
+        scene->initialize(scene::IRenderSceneInfo{"culling-benchmark"});
+
+        // two materials, each pass of a material is drawn by a different layout pass:
+        // layout pass 0 gets opaque plain and transparent instanced objects,
+        // layout pass 1 gets opaque instanced and transparent plain objects.
+        ccstd::vector<IntrusivePtr<scene::Pass>> allPasses{
+            ccnew CullingPass(&root, 0, false, false),
+            ccnew CullingPass(&root, 1, false, true),
+            ccnew CullingPass(&root, 0, true, true),
+            ccnew CullingPass(&root, 1, true, false),
+        };
+        ccstd::vector<std::shared_ptr<PassList>> materials{
+            std::make_shared<PassList>(PassList{allPasses[0], allPasses[1]}),
+            std::make_shared<PassList>(PassList{allPasses[2], allPasses[3]}),
+        };
+        IntrusivePtr<gfx::DescriptorSetLayout> localSetLayout = device->createDescriptorSetLayout({});
+
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> position(-500.0F, 500.0F);
+        std::uniform_real_distribution<float> size(0.5F, 5.0F);
+
+        ccstd::vector<IntrusivePtr<Node>> nodes;
+        ccstd::vector<IntrusivePtr<CullingModel>> models;
+        // where each plain draw is sorted from
+        ccstd::unordered_map<const scene::SubModel *, Vec3> sortPositions;
+        ccstd::unordered_set<const scene::SubModel *> pointSubModels;
+        for (uint32_t i = 0; i < modelCount; ++i) {
+            IntrusivePtr<Node> node = ccnew Node();
+            IntrusivePtr<CullingModel> model = ccnew CullingModel();
+            model->initialize();
+            model->setNode(node);
+            model->setTransform(node);
+            const Vec3 center{position(rng), position(rng), position(rng)};
+            if (i % POINT_MODEL_STRIDE == 0) {
+                // no bounds, sorted by its node, which stays dirty until culling
+                node->setPosition(center);
+            } else {
+                const Vec3 halfExtents{size(rng), size(rng), size(rng)};
+                model->createBoundingShape(center - halfExtents, center + halfExtents);
+            }
+            model->addSubModel(ccnew CullingSubModel(device, localSetLayout, materials[i % 2], static_cast<float>(i)));
+            if (i % POINT_MODEL_STRIDE == 0) {
+                pointSubModels.emplace(model->getSubModels()[0].get());
+            }
+            sortPositions.emplace(model->getSubModels()[0].get(), center);
+            scene->addModel(model);
+            nodes.emplace_back(node);
+            models.emplace_back(model);
+        }
+
+        // split-screen, probes and cascades: cameras looking in different directions
+        SceneRenderQueues sceneQueues(boost::container::pmr::get_default_resource());
+        ccstd::vector<IntrusivePtr<scene::Camera>> cameras;
+        for (uint32_t i = 0; i < CAMERA_COUNT; ++i) {
+            IntrusivePtr<scene::Camera> camera = ccnew scene::Camera(device);
+            Mat4 transform;
+            Mat4::createRotation(Vec3::UNIT_Y, static_cast<float>(i) * math::PI_2 / static_cast<float>(CAMERA_COUNT), &transform);
+            geometry::Frustum frustum;
+            frustum.setAccurate(true);
+            geometry::Frustum::createPerspective(&frustum, 1.0F, 1.2F, 1.0F, 600.0F, transform);
+            camera->setFrustum(frustum);
+
+            auto &queue = sceneQueues[scene.get()][camera.get()];
+            queue.sceneFlags = SceneFlags::OPAQUE_OBJECT | SceneFlags::TRANSPARENT_OBJECT;
+            queue.layoutPassID = i % 2;
+            cameras.emplace_back(camera);
+        }
+
+        const double serialMs = buildQueues(sceneQueues, allPasses, false, frameCount);
+        const auto serialQueues = snapshotQueues(sceneQueues, scene, cameras);
+        const auto serialInstances = snapshotInstances(allPasses);
+        const double parallelMs = buildQueues(sceneQueues, allPasses, true, frameCount);
+        if (printTimings) {
+            printf("Building render queues of %u cameras over %u models, per frame: serial %.2fms, parallel %.2fms\n",
+                   CAMERA_COUNT, modelCount, serialMs, parallelMs);
+        }
+
+        // merged queues keep the flags assigned by the render graph
+        for (uint32_t i = 0; i < CAMERA_COUNT; ++i) {
+            const auto &queue = sceneQueues[scene.get()][cameras[i].get()];
+            EXPECT_EQ(queue.sceneFlags, SceneFlags::OPAQUE_OBJECT | SceneFlags::TRANSPARENT_OBJECT);
+            EXPECT_EQ(queue.layoutPassID, i % 2);
+            if (i % 2 == 0) {
+                EXPECT_FALSE(queue.opaqueQueue.instances.empty());
+                EXPECT_FALSE(queue.transparentInstancingQueue.sortedBatches.empty());
+                EXPECT_TRUE(queue.transparentQueue.instances.empty());
+                EXPECT_TRUE(queue.opaqueInstancingQueue.sortedBatches.empty());
+            } else {
+                EXPECT_FALSE(queue.transparentQueue.instances.empty());
+                EXPECT_FALSE(queue.opaqueInstancingQueue.sortedBatches.empty());
+                EXPECT_TRUE(queue.opaqueQueue.instances.empty());
+                EXPECT_TRUE(queue.transparentInstancingQueue.sortedBatches.empty());
+            }
+        }
+
+        // parallel culling builds the same queues and instance data as culling the cameras one by one
+        const auto parallelQueues = snapshotQueues(sceneQueues, scene, cameras);
+        ASSERT_EQ(serialQueues.size(), parallelQueues.size());
+        for (size_t i = 0; i < serialQueues.size(); ++i) {
+            expectSameInstances(serialQueues[i].opaque, parallelQueues[i].opaque);
+            expectSameInstances(serialQueues[i].transparent, parallelQueues[i].transparent);
+            EXPECT_EQ(serialQueues[i].opaqueInstancing, parallelQueues[i].opaqueInstancing);
+            EXPECT_EQ(serialQueues[i].transparentInstancing, parallelQueues[i].transparentInstancing);
+        }
+        // plain draws are sorted by the centre of their world bounds or by the node of point models
+        uint32_t pointDraws = 0;
+        for (size_t i = 0; i < parallelQueues.size(); ++i) {
+            const auto &camera = *cameras[i];
+            for (const auto *draws : {&parallelQueues[i].opaque, &parallelQueues[i].transparent}) {
+                for (const auto &draw : *draws) {
+                    const auto &sortPosition = sortPositions.at(draw.subModel);
+                    EXPECT_FLOAT_EQ(draw.depth, (sortPosition - camera.getPosition()).dot(camera.getForward()));
+                    pointDraws += static_cast<uint32_t>(pointSubModels.count(draw.subModel));
+                }
+            }
+        }
+        EXPECT_GT(pointDraws, 0U);
+
+        const auto parallelInstances = snapshotInstances(allPasses);
+        ASSERT_EQ(serialInstances.size(), parallelInstances.size());
+        ASSERT_FALSE(serialInstances.empty());
+        for (size_t i = 0; i < serialInstances.size(); ++i) {
+            EXPECT_EQ(serialInstances[i].count, parallelInstances[i].count);
+            EXPECT_EQ(serialInstances[i].data, parallelInstances[i].data);
+        }
+
+        scene->destroy();
+        for (const auto &model : models) {
+            model->destroy();
+        }
+        for (const auto &pass : allPasses) {
+            pass->destroy();
+        }
+    }
+    CC_SAFE_DESTROY_AND_DELETE(device);
+}
+} // namespace
+
+TEST(NativeSceneCullingTest, parallelCameraQueues) {
+    buildCameraQueues(MODEL_COUNT, FRAME_COUNT, false);
+}
+
+// Timing only, run with --gtest_also_run_disabled_tests.
+TEST(NativeSceneCullingTest, DISABLED_parallelCameraQueuesThroughput) {
+    buildCameraQueues(BENCHMARK_MODEL_COUNT, BENCHMARK_FRAME_COUNT, true);
+}
@@ -0,0 +1,194 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <random>
+#include "base/std/container/vector.h"
+#include "core/Root.h"
+#include "core/geometry/Frustum.h"
+#include "core/geometry/Intersect.h"
+#include "core/scene-graph/Node.h"
+#include "gtest/gtest.h"
+#include "renderer/GFXDeviceManager.h"
+#include "renderer/pipeline/SceneCulling.h"
+#include "renderer/pipeline/shadow/CSMLayers.h"
+#include "scene/Camera.h"
+#include "scene/DirectionalLight.h"
+#include "scene/Model.h"
+
+using namespace cc;
+using namespace cc::pipeline;
+
+namespace {
+constexpr uint32_t MODEL_COUNT = 4000;
+constexpr uint32_t VISIBLE_LAYER = 1U << 0;
+constexpr uint32_t HIDDEN_LAYER = 1U << 1;
+
+// What shadowCulling did for each cascade before the masks: valid casters inside the cascade are taken,
+// with REMOVE_DUPLICATES the ones completely inside are dropped before the next cascade.
+ccstd::vector<uint8_t> cullPerLayer(CSMLayers &csmLayers, const scene::Camera *camera, const scene::DirectionalLight *light) {
+    const auto &objects = csmLayers.getLayerObjects();
+    ccstd::vector<uint8_t> masks(objects.size(), 0);
+    ccstd::vector<uint32_t> remaining(objects.size());
+    for (uint32_t i = 0; i < remaining.size(); ++i) {
+        remaining[i] = i;
+    }
+
+    const uint32_t visibility = camera->getVisibility();
+    const auto levelCount = static_cast<uint32_t>(light->getCSMLevel());
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        const auto &frustum = csmLayers.getLayers()[level]->getValidFrustum();
+        for (auto it = remaining.begin(); it != remaining.end();) {
+            const auto *model = objects[*it].model;
+            const auto *node = model->getNode();
+            if (!model->isEnabled() || !node ||
+                (((visibility & node->getLayer()) != node->getLayer()) && !(visibility & static_cast<uint32_t>(model->getVisFlags()))) ||
+                !model->getWorldBounds() || !model->isCastShadow()) {
+                it = remaining.erase(it);
+                continue;
+            }
+            if (!model->getWorldBounds()->aabbFrustum(frustum)) {
+                ++it;
+                continue;
+            }
+            masks[*it] |= 1U << level;
+            if (light->getCSMOptimizationMode() == scene::CSMOptimizationMode::REMOVE_DUPLICATES &&
+                geometry::aabbFrustumCompletelyInside(*model->getWorldBounds(), frustum)) {
+                it = remaining.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    return masks;
+}
+} // namespace
+
+TEST(CSMCullingTest, masksMatchPerLayerCulling) {
+    auto *device = gfx::DeviceManager::createHeadless(gfx::DeviceInfo{});
+    ASSERT_NE(device, nullptr);
+    {
+        Root root(device);
+        CSMLayers csmLayers;
+        // nested cascades looking down -z, each twice as large and deep as the one before
+        for (uint32_t level = 0; level < static_cast<uint32_t>(scene::CSMLevel::LEVEL_4); ++level) {
+            const float size = 20.0F * static_cast<float>(1U << level);
+            geometry::Frustum frustum;
+            frustum.setAccurate(true);
+            geometry::Frustum::createOrtho(&frustum, size, size, 0.1F, 2.5F * size, Mat4::IDENTITY);
+            csmLayers.getLayers()[level]->copyToValidFrustum(frustum);
+        }
+
+        IntrusivePtr<scene::Camera> camera = ccnew scene::Camera(device);
+        camera->setVisibility(VISIBLE_LAYER);
+        IntrusivePtr<scene::DirectionalLight> light = ccnew scene::DirectionalLight();
+
+        std::mt19937 rng(15);
+        std::uniform_real_distribution<float> planar(-90.0F, 90.0F);
+        std::uniform_real_distribution<float> depth(-220.0F, 10.0F);
+        std::uniform_real_distribution<float> size(0.2F, 12.0F);
+        std::uniform_int_distribution<uint32_t> kind(0, 15);
+
+        ccstd::vector<IntrusivePtr<Node>> nodes;
+        ccstd::vector<IntrusivePtr<scene::Model>> models;
+        for (uint32_t i = 0; i < MODEL_COUNT; ++i) {
+            IntrusivePtr<Node> node = ccnew Node();
+            IntrusivePtr<scene::Model> model = ccnew scene::Model();
+            model->initialize();
+            model->setNode(node);
+            model->setTransform(node);
+            model->setCastShadow(true);
+            node->setLayer(VISIBLE_LAYER);
+            switch (kind(rng)) {
+                case 0:
+                    model->setEnabled(false);
+                    break;
+                case 1:
+                    model->setCastShadow(false);
+                    break;
+                case 2:
+                    node->setLayer(HIDDEN_LAYER);
+                    break;
+                case 3:
+                    // hidden by its layer but visible through its flags
+                    node->setLayer(HIDDEN_LAYER);
+                    model->setVisFlags(static_cast<Layers::Enum>(VISIBLE_LAYER));
+                    break;
+                default:
+                    break;
+            }
+            // a few models have no bounds at all
+            if (i % 97 != 0) {
+                const Vec3 center{planar(rng), planar(rng), depth(rng)};
+                const Vec3 halfExtents{size(rng), size(rng), size(rng)};
+                model->createBoundingShape(center - halfExtents, center + halfExtents);
+            }
+            csmLayers.addLayerObject(RenderObject{0.0F, model});
+            nodes.emplace_back(node);
+            models.emplace_back(model);
+        }
+
+        for (auto level : {scene::CSMLevel::LEVEL_2, scene::CSMLevel::LEVEL_3, scene::CSMLevel::LEVEL_4}) {
+            ccstd::vector<uint8_t> withDuplicates;
+            for (auto mode : {scene::CSMOptimizationMode::NONE, scene::CSMOptimizationMode::REMOVE_DUPLICATES}) {
+                light->setCSMLevel(level);
+                light->setCSMOptimizationMode(mode);
+
+                const auto expected = cullPerLayer(csmLayers, camera, light);
+                cullCSMLayerObjects(&csmLayers, camera, light);
+                const auto &masks = csmLayers.getLayerObjectMasks();
+                ASSERT_EQ(masks.size(), expected.size());
+
+                uint32_t casters = 0;
+                uint32_t duplicates = 0;
+                for (size_t i = 0; i < expected.size(); ++i) {
+                    EXPECT_EQ(masks[i], expected[i]) << "object " << i << " levels " << static_cast<int>(level) << " mode " << static_cast<int>(mode);
+                    casters += expected[i] != 0;
+                    duplicates += (expected[i] & (expected[i] - 1)) != 0;
+                }
+                // the scene has casters in the cascades, and some overlap several of them
+                EXPECT_GT(casters, 0U);
+                EXPECT_GT(duplicates, 0U);
+                if (mode == scene::CSMOptimizationMode::NONE) {
+                    withDuplicates = expected;
+                } else {
+                    // objects completely inside a cascade were dropped from the ones after it
+                    EXPECT_NE(expected, withDuplicates);
+                }
+            }
+        }
+
+        // the culling buffers of the previous frames are reused for fewer objects
+        RenderObjectList fewer(csmLayers.getLayerObjects().begin(), csmLayers.getLayerObjects().begin() + MODEL_COUNT / 3);
+        csmLayers.setLayerObjects(std::move(fewer));
+        const auto expected = cullPerLayer(csmLayers, camera, light);
+        cullCSMLayerObjects(&csmLayers, camera, light);
+        EXPECT_EQ(csmLayers.getLayerObjectMasks(), expected);
+
+        for (const auto &model : models) {
+            model->destroy();
+        }
+    }
+    CC_SAFE_DESTROY_AND_DELETE(device);
+}
@@ -0,0 +1,171 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <chrono>
+#include <thread>
+#include "core/Root.h"
+#include "gtest/gtest.h"
+#include "platform/FileUtils.h"
+#include "renderer/GFXDeviceManager.h"
+#include "renderer/pipeline/PipelineStateManager.h"
+#include "scene/Pass.h"
+
+using namespace cc;
+using pipeline::PipelineStateManager;
+
+namespace {
+
+// a pass with just enough state to build pipeline states from
+class CachedPass : public scene::Pass {
+public:
+    CachedPass(Root *root, gfx::PipelineLayout *pipelineLayout) : Pass(root) {
+        _pipelineLayout = pipelineLayout;
+    }
+};
+
+class PipelineStateCacheTest : public testing::Test {
+protected:
+    void SetUp() override {
+        if (!FileUtils::getInstance()) {
+            _ownedFileUtils = createFileUtils();
+        }
+        FileUtils::getInstance()->createDirectory(FileUtils::getInstance()->getWritablePath());
+        FileUtils::getInstance()->removeFile(PipelineStateManager::getCachePath());
+        PipelineStateManager::beginLaunch();
+
+        _device = gfx::DeviceManager::createHeadless(gfx::DeviceInfo{});
+        ASSERT_NE(_device, nullptr);
+        _root = std::make_unique<Root>(_device);
+
+        _pipelineLayout = _device->createPipelineLayout({});
+        _pass = ccnew CachedPass(_root.get(), _pipelineLayout);
+        gfx::ShaderInfo shaderInfo;
+        shaderInfo.name = "pipeline-state-cache-test";
+        _shader = _device->createShader(shaderInfo);
+        _inputAssembler = _device->createInputAssembler({{{"a_position", gfx::Format::RGB32F}}});
+        gfx::RenderPassInfo renderPassInfo;
+        renderPassInfo.colorAttachments.emplace_back().format = gfx::Format::RGBA8;
+        _renderPass = _device->createRenderPass(renderPassInfo);
+    }
+
+    void TearDown() override {
+        PipelineStateManager::destroyAll();
+        FileUtils::getInstance()->removeFile(PipelineStateManager::getCachePath());
+
+        _pass = nullptr;
+        CC_SAFE_DESTROY_NULL(_renderPass);
+        CC_SAFE_DESTROY_NULL(_inputAssembler);
+        CC_SAFE_DESTROY_NULL(_shader);
+        CC_SAFE_DESTROY_NULL(_pipelineLayout);
+        _root.reset();
+        CC_SAFE_DESTROY_AND_DELETE(_device);
+        delete _ownedFileUtils;
+    }
+
+    gfx::PipelineState *getPipelineState() {
+        return PipelineStateManager::getOrCreatePipelineState(_pass, _shader, _inputAssembler, _renderPass);
+    }
+
+    FileUtils *_ownedFileUtils{nullptr};
+    gfx::Device *_device{nullptr};
+    std::unique_ptr<Root> _root;
+    IntrusivePtr<gfx::PipelineLayout> _pipelineLayout;
+    IntrusivePtr<scene::Pass> _pass;
+    IntrusivePtr<gfx::Shader> _shader;
+    IntrusivePtr<gfx::InputAssembler> _inputAssembler;
+    IntrusivePtr<gfx::RenderPass> _renderPass;
+};
+
+} // namespace
+
+TEST_F(PipelineStateCacheTest, prewarmsFromPreviousLaunch) {
+    const auto stats = PipelineStateManager::getCacheStats();
+
+    // first launch: created lazily and recorded
+    EXPECT_NE(getPipelineState(), nullptr);
+    EXPECT_EQ(PipelineStateManager::getCacheStats().misses, stats.misses + 1);
+    PipelineStateManager::destroyAll();
+    PipelineStateManager::beginLaunch();
+    ASSERT_TRUE(FileUtils::getInstance()->isFileExist(PipelineStateManager::getCachePath()));
+
+    // next launch: the cache is read on a worker, the queued pass is prewarmed by update()
+    PipelineStateManager::prewarm(_pass, _shader, _inputAssembler);
+    for (uint32_t i = 0; i < 1000 && PipelineStateManager::getCacheStats().prewarmed == stats.prewarmed; ++i) {
+        PipelineStateManager::update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(PipelineStateManager::getRecordCount(), 1U);
+    EXPECT_EQ(PipelineStateManager::getCacheStats().prewarmed, stats.prewarmed + 1);
+
+    EXPECT_NE(getPipelineState(), nullptr);
+    EXPECT_EQ(PipelineStateManager::getCacheStats().hits, stats.hits + 1);
+    EXPECT_EQ(PipelineStateManager::getCacheStats().misses, stats.misses + 1);
+}
+
+TEST_F(PipelineStateCacheTest, agesOutUnusedRecords) {
+    getPipelineState();
+    PipelineStateManager::destroyAll();
+
+    // launches that never draw it keep the record for MAX_RECORD_AGE generations
+    for (uint32_t i = 0; i < PipelineStateManager::MAX_RECORD_AGE; ++i) {
+        PipelineStateManager::beginLaunch();
+        EXPECT_TRUE(PipelineStateManager::loadCache());
+        EXPECT_EQ(PipelineStateManager::getRecordCount(), 1U);
+        PipelineStateManager::destroyAll();
+    }
+    PipelineStateManager::beginLaunch();
+    PipelineStateManager::loadCache();
+    EXPECT_EQ(PipelineStateManager::getRecordCount(), 0U);
+}
+
+TEST_F(PipelineStateCacheTest, usedRecordsStay) {
+    getPipelineState();
+    PipelineStateManager::destroyAll();
+
+    for (uint32_t i = 0; i < PipelineStateManager::MAX_RECORD_AGE * 2; ++i) {
+        PipelineStateManager::beginLaunch();
+        EXPECT_TRUE(PipelineStateManager::loadCache());
+        EXPECT_EQ(PipelineStateManager::getRecordCount(), 1U);
+        getPipelineState();
+        PipelineStateManager::destroyAll();
+    }
+}
+
+TEST_F(PipelineStateCacheTest, reloadsKeepTheLaunchGeneration) {
+    getPipelineState();
+    PipelineStateManager::destroyAll();
+
+    // rebuilding the pipeline reloads and saves the cache, that is not a new launch and must not age the records
+    IntrusivePtr<gfx::InputAssembler> otherInputAssembler = _device->createInputAssembler({{{"a_normal", gfx::Format::RGB32F}}});
+    for (uint32_t i = 0; i < PipelineStateManager::MAX_RECORD_AGE * 2; ++i) {
+        EXPECT_TRUE(PipelineStateManager::loadCache());
+        EXPECT_GE(PipelineStateManager::getRecordCount(), 1U);
+        PipelineStateManager::getOrCreatePipelineState(_pass, _shader, otherInputAssembler, _renderPass);
+        PipelineStateManager::destroyAll();
+    }
+    PipelineStateManager::loadCache();
+    EXPECT_EQ(PipelineStateManager::getRecordCount(), 2U);
+    CC_SAFE_DESTROY_NULL(otherInputAssembler);
+}
@@ -0,0 +1,168 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "cocos/base/std/container/vector.h"
+#include "cocos/platform/FileUtils.h"
+#include "gtest/gtest.h"
+
+#if CC_PLATFORM == CC_PLATFORM_LINUX
+    #include <unistd.h>
+#endif
+
+using cc::FileUtils;
+using cc::FileView;
+using cc::IntrusivePtr;
+
+namespace {
+
+class FileViewTest : public testing::Test {
+protected:
+    void SetUp() override {
+        if (!FileUtils::getInstance()) {
+            _ownedFileUtils = cc::createFileUtils();
+        }
+        _dir = FileUtils::getInstance()->getWritablePath();
+        FileUtils::getInstance()->createDirectory(_dir);
+    }
+
+    void TearDown() override {
+        delete _ownedFileUtils;
+    }
+
+    ccstd::string writeFile(const char *name, uint32_t size) {
+        ccstd::vector<uint8_t> bytes(size);
+        for (uint32_t i = 0; i < size; ++i) {
+            bytes[i] = static_cast<uint8_t>(i * 31 + (i >> 8));
+        }
+        ccstd::string path = _dir + name;
+        FILE *fp = fopen(path.c_str(), "wb");
+        EXPECT_NE(fp, nullptr);
+        if (fp) {
+            fwrite(bytes.data(), 1, bytes.size(), fp);
+            fclose(fp);
+        }
+        return path;
+    }
+
+    FileUtils *_ownedFileUtils{nullptr};
+    ccstd::string _dir;
+};
+
+#if CC_PLATFORM == CC_PLATFORM_LINUX
+size_t residentBytes() {
+    size_t pages = 0;
+    size_t resident = 0;
+    FILE *fp = fopen("/proc/self/statm", "r");
+    if (fp) {
+        if (fscanf(fp, "%zu %zu", &pages, &resident) != 2) {
+            resident = 0;
+        }
+        fclose(fp);
+    }
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+#endif
+
+} // namespace
+
+TEST_F(FileViewTest, matchesGetContents) {
+    auto *fu = FileUtils::getInstance();
+    for (uint32_t size : {0U, 100U, 1U << 20}) {
+        const ccstd::string path = writeFile("file_view_test.bin", size);
+        cc::Data data = fu->getDataFromFile(path);
+        IntrusivePtr<FileView> view = fu->getFileView(path);
+        ASSERT_NE(view, nullptr);
+        ASSERT_EQ(view->getSize(), size);
+        if (size > 0) {
+            EXPECT_EQ(0, memcmp(view->getBytes(), data.getBytes(), size));
+        }
+#if CC_PLATFORM == CC_PLATFORM_LINUX
+        EXPECT_EQ(view->isMapped(), size >= (1U << 20));
+#endif
+        fu->removeFile(path);
+    }
+    EXPECT_EQ(fu->getFileView(_dir + "file_view_test_missing.bin"), nullptr);
+}
+
+TEST_F(FileViewTest, sharedViewOutlivesFile) {
+    auto *fu = FileUtils::getInstance();
+    const ccstd::string path = writeFile("file_view_test.bin", 256 * 1024);
+    IntrusivePtr<FileView> shared;
+    uint8_t last = 0;
+    {
+        IntrusivePtr<FileView> view = fu->getFileView(path);
+        ASSERT_NE(view, nullptr);
+        last = view->getBytes()[view->getSize() - 1];
+        shared = view;
+    }
+    fu->removeFile(path);
+    ASSERT_EQ(shared->getSize(), 256U * 1024U);
+    EXPECT_EQ(shared->getBytes()[shared->getSize() - 1], last);
+}
+
+// Timing only, run with --gtest_also_run_disabled_tests.
+TEST_F(FileViewTest, DISABLED_load64MB) {
+    auto *fu = FileUtils::getInstance();
+    const uint32_t size = 64U << 20;
+    const ccstd::string path = writeFile("file_view_test.bin", size);
+
+#if CC_PLATFORM == CC_PLATFORM_LINUX
+    size_t rss = residentBytes();
+#endif
+    auto begin = std::chrono::steady_clock::now();
+    {
+        cc::Data data = fu->getDataFromFile(path);
+        ASSERT_EQ(data.getSize(), size);
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+#if CC_PLATFORM == CC_PLATFORM_LINUX
+        printf("getDataFromFile 64 MB: %.2f ms, RSS +%.1f MB\n", ms, static_cast<double>(residentBytes() - rss) / (1 << 20));
+#else
+        printf("getDataFromFile 64 MB: %.2f ms\n", ms);
+#endif
+    }
+
+#if CC_PLATFORM == CC_PLATFORM_LINUX
+    rss = residentBytes();
+#endif
+    begin = std::chrono::steady_clock::now();
+    {
+        IntrusivePtr<FileView> view = fu->getFileView(path);
+        ASSERT_NE(view, nullptr);
+        ASSERT_EQ(view->getSize(), size);
+        // Touch the header only, the way a loader peeks at a pack before reading a few entries.
+        volatile uint8_t header = view->getBytes()[0];
+        (void)header;
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+#if CC_PLATFORM == CC_PLATFORM_LINUX
+        printf("getFileView 64 MB: %.2f ms, RSS +%.1f MB\n", ms, static_cast<double>(residentBytes() - rss) / (1 << 20));
+#else
+        printf("getFileView 64 MB: %.2f ms\n", ms);
+#endif
+    }
+    fu->removeFile(path);
+}
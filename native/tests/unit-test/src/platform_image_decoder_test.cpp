@@ -0,0 +1,256 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include "base/std/container/vector.h"
+#include "base/threading/ThreadPool.h"
+#include "core/utils/ImageUtils.h"
+#include "gtest/gtest.h"
+#include "platform/ImageDecoder.h"
+
+using namespace cc;
+
+namespace {
+
+// 2x2, 8 bit gray: 0 85 / 170 255
+constexpr uint8_t GRAY_PNG[] = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x02, 0x08, 0x00, 0x00, 0x00, 0x00, 0x57, 0xdd, 0x52,
+    0xf8, 0x00, 0x00, 0x00, 0x0e, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x60, 0x08, 0x65, 0x58,
+    0xf5, 0x1f, 0x00, 0x03, 0xad, 0x01, 0xff, 0x7a, 0x93, 0x84, 0x7f, 0x00, 0x00, 0x00, 0x00, 0x49,
+    0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82};
+
+// 8x8 RGB filled with (200, 100, 50), quality 100 without chroma subsampling
+constexpr uint8_t RGB_JPEG[] = {
+    0xff, 0xd8, 0xff, 0xe0, 0x00, 0x10, 0x4a, 0x46, 0x49, 0x46, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01,
+    0x00, 0x01, 0x00, 0x00, 0xff, 0xdb, 0x00, 0x43, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0xff, 0xdb, 0x00, 0x43, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0xff, 0xc0,
+    0x00, 0x11, 0x08, 0x00, 0x08, 0x00, 0x08, 0x03, 0x01, 0x11, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11,
+    0x01, 0xff, 0xc4, 0x00, 0x14, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0xff, 0xc4, 0x00, 0x14, 0x10, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xc4, 0x00,
+    0x14, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x09, 0xff, 0xc4, 0x00, 0x14, 0x11, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xda, 0x00, 0x0c, 0x03, 0x01, 0x00,
+    0x02, 0x11, 0x03, 0x11, 0x00, 0x3f, 0x00, 0x3e, 0x2b, 0xcd, 0x83, 0xff, 0xd9};
+
+// The decoder takes ownership of the data it decodes.
+unsigned char *copyPng() {
+    auto *data = static_cast<unsigned char *>(malloc(sizeof(GRAY_PNG)));
+    memcpy(data, GRAY_PNG, sizeof(GRAY_PNG));
+    return data;
+}
+
+void waitFor(const std::atomic<uint32_t> &counter, uint32_t value) {
+    while (counter.load() < value) {
+        std::this_thread::yield();
+    }
+}
+
+// Keeps the worker that calls it back busy until released.
+struct Blocker {
+    std::atomic<uint32_t> blocked{0};
+    std::atomic<bool> released{false};
+
+    ImageDecoder::Callback callback() {
+        return [this](ImageDecoder::Result &result) {
+            free(result.data);
+            blocked.fetch_add(1);
+            while (!released.load()) {
+                std::this_thread::yield();
+            }
+        };
+    }
+};
+
+} // namespace
+
+TEST(ImageDecoderTest, servesHighestPriorityFirst) {
+    ImageDecoder decoder(1);
+    Blocker blocker;
+    decoder.decodeData(copyPng(), sizeof(GRAY_PNG), {}, blocker.callback());
+    waitFor(blocker.blocked, 1);
+
+    std::mutex mutex;
+    ccstd::vector<uint32_t> order;
+    const TaskPriority priorities[] = {TaskPriority::LOW, TaskPriority::NORMAL, TaskPriority::HIGH, TaskPriority::LOW, TaskPriority::HIGH};
+    for (uint32_t i = 0; i < 5; ++i) {
+        ImageDecoder::Options options;
+        options.priority = priorities[i];
+        decoder.decodeData(copyPng(), sizeof(GRAY_PNG), options, [&, i](ImageDecoder::Result &result) {
+            EXPECT_TRUE(result.succeed);
+            free(result.data);
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(i);
+        });
+    }
+    blocker.released.store(true);
+    decoder.waitForAll();
+
+    // requests of the same priority keep their order
+    EXPECT_EQ(order, (ccstd::vector<uint32_t>{2, 4, 1, 0, 3}));
+    EXPECT_EQ(decoder.getStats().imageCount, 6U);
+}
+
+TEST(ImageDecoderTest, boundsDecodesInFlight) {
+    constexpr uint32_t CONCURRENCY = 2;
+    constexpr uint32_t REQUEST_COUNT = 16;
+    ImageDecoder decoder(CONCURRENCY);
+    std::atomic<uint32_t> active{0};
+    std::atomic<uint32_t> maxActive{0};
+    std::atomic<uint32_t> done{0};
+    for (uint32_t i = 0; i < REQUEST_COUNT; ++i) {
+        decoder.decodeData(copyPng(), sizeof(GRAY_PNG), {}, [&](ImageDecoder::Result &result) {
+            free(result.data);
+            const uint32_t current = active.fetch_add(1) + 1;
+            uint32_t seen = maxActive.load();
+            while (current > seen && !maxActive.compare_exchange_weak(seen, current)) {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            active.fetch_sub(1);
+            done.fetch_add(1);
+        });
+    }
+    decoder.waitForAll();
+
+    EXPECT_EQ(done.load(), REQUEST_COUNT);
+    EXPECT_GE(maxActive.load(), 1U);
+    EXPECT_LE(maxActive.load(), CONCURRENCY);
+}
+
+TEST(ImageDecoderTest, destroyDropsQueuedRequests) {
+    auto *decoder = ccnew ImageDecoder(1);
+    Blocker blocker;
+    decoder->decodeData(copyPng(), sizeof(GRAY_PNG), {}, blocker.callback());
+    waitFor(blocker.blocked, 1);
+
+    std::atomic<uint32_t> called{0};
+    for (uint32_t i = 0; i < 8; ++i) {
+        decoder->decodeData(copyPng(), sizeof(GRAY_PNG), {}, [&called](ImageDecoder::Result &result) {
+            free(result.data);
+            called.fetch_add(1);
+        });
+    }
+
+    // the destructor waits for the decode in flight, the queued ones are dropped with their data
+    std::atomic<bool> destroyed{false};
+    std::thread destroyer([&]() {
+        delete decoder;
+        destroyed.store(true);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(destroyed.load());
+    blocker.released.store(true);
+    destroyer.join();
+    EXPECT_EQ(called.load(), 0U);
+}
+
+TEST(ImageDecoderTest, destroyDoesNotWaitForWorkersNotStarted) {
+    // every worker of the pool is busy, so the decoder's workers are dispatched but can't start
+    auto *pool = ThreadPool::getInstance();
+    std::atomic<uint32_t> blocked{0};
+    std::atomic<bool> released{false};
+    const uint32_t workerCount = pool->getWorkerCount();
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        pool->dispatch([&]() {
+            blocked.fetch_add(1);
+            while (!released.load()) {
+                std::this_thread::yield();
+            }
+        },
+                       TaskPriority::HIGH);
+    }
+    waitFor(blocked, workerCount);
+
+    auto *decoder = ccnew ImageDecoder(2);
+    std::atomic<uint32_t> called{0};
+    for (uint32_t i = 0; i < 4; ++i) {
+        decoder->decodeData(copyPng(), sizeof(GRAY_PNG), {}, [&called](ImageDecoder::Result &result) {
+            free(result.data);
+            called.fetch_add(1);
+        });
+    }
+    delete decoder;
+
+    // the dispatched workers find the decoder cancelled once they get to run
+    auto future = pool->dispatchTask([]() { return true; });
+    released.store(true);
+    EXPECT_TRUE(future.get());
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(called.load(), 0U);
+}
+
+TEST(ImageDecoderTest, expandsJpegRGBToRGBA) {
+    auto result = ImageDecoder::decode({}, RGB_JPEG, sizeof(RGB_JPEG), {});
+    ASSERT_TRUE(result.succeed);
+    EXPECT_EQ(result.format, gfx::Format::RGBA8);
+    EXPECT_FALSE(result.compressed);
+    EXPECT_EQ(result.width, 8U);
+    EXPECT_EQ(result.height, 8U);
+    ASSERT_EQ(result.length, 8U * 8U * 4U);
+    for (uint32_t i = 0; i < 8 * 8; ++i) {
+        EXPECT_NEAR(result.data[i * 4], 200, 2) << i;
+        EXPECT_NEAR(result.data[i * 4 + 1], 100, 2) << i;
+        EXPECT_NEAR(result.data[i * 4 + 2], 50, 2) << i;
+        EXPECT_EQ(result.data[i * 4 + 3], 255) << i;
+    }
+    free(result.data);
+}
+
+TEST(ImageDecoderTest, expandsPngGrayToRGBA) {
+    auto result = ImageDecoder::decode({}, GRAY_PNG, sizeof(GRAY_PNG), {});
+    ASSERT_TRUE(result.succeed);
+    EXPECT_EQ(result.format, gfx::Format::RGBA8);
+    ASSERT_EQ(result.length, 2U * 2U * 4U);
+    const uint8_t expected[] = {0, 0, 0, 255, 85, 85, 85, 255, 170, 170, 170, 255, 255, 255, 255, 255};
+    EXPECT_EQ(0, memcmp(result.data, expected, sizeof(expected)));
+    free(result.data);
+
+    // the mipmap chain is appended to the same buffer
+    ImageDecoder::Options options;
+    options.premultiplyAlpha = true;
+    options.generateMipmaps = true;
+    result = ImageDecoder::decode({}, GRAY_PNG, sizeof(GRAY_PNG), options);
+    ASSERT_TRUE(result.succeed);
+    EXPECT_TRUE(result.premultiplied);
+    ASSERT_EQ(result.length, ImageUtils::getMipmapChainSize(2, 2));
+    EXPECT_EQ(result.mipmapLevelDataSize, (ccstd::vector<uint32_t>{16, 4}));
+    EXPECT_EQ(0, memcmp(result.data, expected, sizeof(expected)));
+    const uint8_t average[] = {128, 128, 128, 255};
+    EXPECT_EQ(0, memcmp(result.data + 16, average, sizeof(average)));
+    free(result.data);
+}
@@ -0,0 +1,129 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <thread>
+#include "cocos/platform/FileUtils.h"
+#include "cocos/profiler/Profiler.h"
+#include "gtest/gtest.h"
+
+using namespace cc;
+
+namespace {
+
+class ProfilerTraceTest : public testing::Test {
+protected:
+    void SetUp() override {
+        if (!FileUtils::getInstance()) {
+            _ownedFileUtils = createFileUtils();
+        }
+        const ccstd::string dir = FileUtils::getInstance()->getWritablePath();
+        FileUtils::getInstance()->createDirectory(dir);
+        _path = dir + "profiler_trace_test.json";
+        FileUtils::getInstance()->removeFile(_path);
+    }
+
+    void TearDown() override {
+        FileUtils::getInstance()->removeFile(_path);
+        delete _ownedFileUtils;
+    }
+
+    // a profiled block as CC_PROFILE records it, without a Profiler instance, as on a thread running after shutdown
+    static void profiledBlock() {
+        AutoProfiler profiler(nullptr, "TracedBlock");
+    }
+
+    FileUtils *_ownedFileUtils{nullptr};
+    ccstd::string _path;
+};
+
+} // namespace
+
+TEST(TraceEventRingTest, allocatesOnFirstEvent) {
+    TraceEventRing ring(0U);
+    EXPECT_FALSE(ring.isAllocated());
+
+    uint32_t drained = 0U;
+    ring.drain([&drained](const TraceEventRing::Event & /*event*/) { ++drained; });
+    EXPECT_FALSE(ring.isAllocated());
+
+    for (uint32_t i = 0; i < TraceEventRing::CAPACITY + 1; ++i) {
+        ring.push({"Block", 5U, i, i + 1});
+    }
+    EXPECT_TRUE(ring.isAllocated());
+    EXPECT_EQ(ring.fetchAndResetDropped(), 1U);
+
+    ring.drain([&drained](const TraceEventRing::Event & /*event*/) { ++drained; });
+    EXPECT_EQ(drained, TraceEventRing::CAPACITY);
+}
+
+TEST_F(ProfilerTraceTest, savesEventsOfAllThreads) {
+    ProfilerTrace trace;
+    profiledBlock(); // not recording yet
+    trace.start(_path, 0U);
+    EXPECT_TRUE(ProfilerTrace::isRecording());
+
+    profiledBlock();
+    std::thread worker([]() {
+        ProfilerTrace::setThreadName("TraceWorker");
+        profiledBlock();
+        profiledBlock();
+    });
+    worker.join();
+
+    EXPECT_FALSE(trace.collect());
+    EXPECT_TRUE(trace.stop());
+    EXPECT_FALSE(ProfilerTrace::isRecording());
+
+    const ccstd::string json = FileUtils::getInstance()->getStringFromFile(_path);
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0U);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"TraceWorker\"}"), ccstd::string::npos);
+    uint32_t blocks = 0U;
+    for (size_t pos = json.find("\"TracedBlock\""); pos != ccstd::string::npos; pos = json.find("\"TracedBlock\"", pos + 1)) {
+        ++blocks;
+    }
+    EXPECT_EQ(blocks, 3U);
+}
+
+TEST_F(ProfilerTraceTest, stopsAfterFrameCount) {
+    ProfilerTrace trace;
+    trace.start(_path, 2U);
+    profiledBlock();
+    EXPECT_FALSE(trace.collect());
+    EXPECT_TRUE(trace.collect());
+    EXPECT_TRUE(trace.stop());
+    EXPECT_TRUE(FileUtils::getInstance()->isFileExist(_path));
+}
+
+TEST_F(ProfilerTraceTest, cancelWritesNothing) {
+    ProfilerTrace trace;
+    trace.start(_path, 0U);
+    profiledBlock();
+    trace.cancel();
+
+    EXPECT_FALSE(trace.isActive());
+    EXPECT_FALSE(ProfilerTrace::isRecording());
+    EXPECT_FALSE(trace.stop());
+    EXPECT_FALSE(FileUtils::getInstance()->isFileExist(_path));
+}
@@ -0,0 +1,178 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include "base/std/container/unordered_map.h"
+#include "base/std/container/vector.h"
+#include "core/Root.h"
+#include "core/geometry/Frustum.h"
+#include "core/scene-graph/Layers.h"
+#include "gtest/gtest.h"
+#include "renderer/GFXDeviceManager.h"
+#include "scene/Camera.h"
+#include "scene/Model.h"
+#include "scene/Octree.h"
+
+using namespace cc;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t MODEL_COUNT = 2000;
+constexpr uint32_t FRAME_COUNT = 3;
+constexpr uint32_t BENCHMARK_MODEL_COUNT = 100000;
+constexpr uint32_t BENCHMARK_FRAME_COUNT = 10;
+
+struct Timings {
+    Clock::duration update{0};
+    Clock::duration query{0};
+};
+
+// A model keeps the node it is indexed under, so every index gets its own models with the same bounds.
+struct ModelSet {
+    ccstd::vector<IntrusivePtr<scene::Model>> models;
+    ccstd::unordered_map<const scene::Model *, uint32_t> indices;
+
+    void add(const Vec3 &minPos, const Vec3 &maxPos) {
+        IntrusivePtr<scene::Model> model = ccnew scene::Model();
+        model->initialize();
+        model->setVisFlags(Layers::Enum::DEFAULT);
+        model->createBoundingShape(minPos, maxPos);
+        indices.emplace(model.get(), static_cast<uint32_t>(models.size()));
+        models.emplace_back(model);
+    }
+};
+
+void updateAndQuery(scene::Octree &index, const ModelSet &set, const scene::Camera *camera,
+                    const geometry::Frustum &frustum, Timings &timings, ccstd::vector<uint32_t> &results) {
+    auto begin = Clock::now();
+    for (const auto &model : set.models) {
+        index.update(model);
+    }
+    timings.update += Clock::now() - begin;
+
+    ccstd::vector<scene::Model *> visible;
+    begin = Clock::now();
+    index.queryVisibility(camera, frustum, false, visible);
+    timings.query += Clock::now() - begin;
+
+    results.clear();
+    for (const auto *model : visible) {
+        results.push_back(set.indices.at(model));
+    }
+    std::sort(results.begin(), results.end());
+}
+
+// moves the models for a few frames, the aabb tree must report the same visible set as the octree
+void cullMovingModels(uint32_t modelCount, uint32_t frameCount, bool printTimings) {
+    auto *device = gfx::DeviceManager::createHeadless(gfx::DeviceInfo{});
+    ASSERT_NE(device, nullptr);
+    {
+        Root root(device);
+        IntrusivePtr<scene::Camera> camera = ccnew scene::Camera(device);
+
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> position(-500.0F, 500.0F);
+        std::uniform_real_distribution<float> size(0.5F, 5.0F);
+        std::uniform_real_distribution<float> speed(-0.5F, 0.5F);
+
+        ModelSet octreeModels;
+        ModelSet treeModels;
+        ccstd::vector<Vec3> velocities;
+        for (uint32_t i = 0; i < modelCount; ++i) {
+            const Vec3 center{position(rng), position(rng), position(rng)};
+            const Vec3 halfExtents{size(rng), size(rng), size(rng)};
+            octreeModels.add(center - halfExtents, center + halfExtents);
+            treeModels.add(center - halfExtents, center + halfExtents);
+            velocities.emplace_back(speed(rng), speed(rng), speed(rng));
+        }
+
+        scene::OctreeInfo info;
+        info.setEnabled(true);
+        scene::Octree octree;
+        octree.initialize(info);
+        info.setSpatialIndex(scene::SpatialIndexType::AABB_TREE);
+        scene::Octree tree;
+        tree.initialize(info);
+        EXPECT_EQ(tree.getSpatialIndex(), scene::SpatialIndexType::AABB_TREE);
+        for (uint32_t i = 0; i < modelCount; ++i) {
+            octree.insert(octreeModels.models[i]);
+            tree.insert(treeModels.models[i]);
+        }
+
+        Mat4 transform;
+        Mat4::createRotation(Vec3(0.3F, 1.0F, 0.2F).getNormalized(), 0.7F, &transform);
+        geometry::Frustum frustum;
+        frustum.setAccurate(true);
+        geometry::Frustum::createPerspective(&frustum, 1.0F, 1.5F, 1.0F, 400.0F, transform);
+
+        Timings octreeTimings;
+        Timings treeTimings;
+        ccstd::vector<uint32_t> octreeResults;
+        ccstd::vector<uint32_t> treeResults;
+        for (uint32_t frame = 0; frame < frameCount; ++frame) {
+            for (uint32_t i = 0; i < modelCount; ++i) {
+                octreeModels.models[i]->getWorldBounds()->center += velocities[i];
+                treeModels.models[i]->getWorldBounds()->center += velocities[i];
+            }
+            updateAndQuery(octree, octreeModels, camera, frustum, octreeTimings, octreeResults);
+            updateAndQuery(tree, treeModels, camera, frustum, treeTimings, treeResults);
+            EXPECT_FALSE(octreeResults.empty());
+            EXPECT_EQ(octreeResults, treeResults);
+        }
+
+        if (printTimings) {
+            auto toMs = [frameCount](Clock::duration duration) {
+                return std::chrono::duration<double, std::milli>(duration).count() / frameCount;
+            };
+            printf("Culling %u moving models, per frame: octree update %.2fms query %.2fms, aabb tree update %.2fms query %.2fms\n",
+                   modelCount, toMs(octreeTimings.update), toMs(octreeTimings.query), toMs(treeTimings.update), toMs(treeTimings.query));
+        }
+
+        // switching back keeps every model indexed
+        tree.setSpatialIndex(scene::SpatialIndexType::OCTREE);
+        updateAndQuery(tree, treeModels, camera, frustum, treeTimings, treeResults);
+        EXPECT_EQ(octreeResults, treeResults);
+
+        for (uint32_t i = 0; i < modelCount; ++i) {
+            octree.remove(octreeModels.models[i]);
+            tree.remove(treeModels.models[i]);
+        }
+    }
+    CC_SAFE_DESTROY_AND_DELETE(device);
+}
+} // namespace
+
+TEST(SceneAABBTreeTest, movingModelsAgainstOctree) {
+    cullMovingModels(MODEL_COUNT, FRAME_COUNT, false);
+}
+
+// Timing only, run with --gtest_also_run_disabled_tests.
+TEST(SceneAABBTreeTest, DISABLED_movingModelsThroughput) {
+    cullMovingModels(BENCHMARK_MODEL_COUNT, BENCHMARK_FRAME_COUNT, true);
+}
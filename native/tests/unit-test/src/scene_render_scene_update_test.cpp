@@ -0,0 +1,161 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include "base/std/container/vector.h"
+#include "core/Root.h"
+#include "core/geometry/AABB.h"
+#include "core/scene-graph/Node.h"
+#include "gtest/gtest.h"
+#include "renderer/GFXDeviceManager.h"
+#include "scene/Model.h"
+#include "scene/RenderScene.h"
+
+using namespace cc;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t PARENT_COUNT = 128;
+constexpr uint32_t CHILDREN_PER_PARENT = 32;
+constexpr uint32_t FRAME_COUNT = 10;
+constexpr uint32_t BENCHMARK_FRAME_COUNT = 100;
+
+struct SceneFixture {
+    IntrusivePtr<scene::RenderScene> scene;
+    ccstd::vector<IntrusivePtr<Node>> parents;
+    ccstd::vector<IntrusivePtr<Node>> children;
+    ccstd::vector<IntrusivePtr<scene::Model>> models;
+    std::mt19937 rng{7};
+
+    explicit SceneFixture(bool parallel) {
+        scene = ccnew scene::RenderScene();
+        scene->initialize(scene::IRenderSceneInfo{"update-test"});
+        scene->setParallelUpdateEnabled(parallel);
+
+        std::uniform_real_distribution<float> offset(-50.0F, 50.0F);
+        for (uint32_t i = 0; i < PARENT_COUNT; ++i) {
+            IntrusivePtr<Node> parent = ccnew Node();
+            parent->setPosition(offset(rng), offset(rng), offset(rng));
+            for (uint32_t j = 0; j < CHILDREN_PER_PARENT; ++j) {
+                IntrusivePtr<Node> child = ccnew Node();
+                child->setParent(parent);
+                child->setPosition(offset(rng), offset(rng), offset(rng));
+
+                IntrusivePtr<scene::Model> model = ccnew scene::Model();
+                model->initialize();
+                model->setNode(child);
+                model->setTransform(child);
+                model->createBoundingShape(Vec3{-1.0F, -2.0F, -3.0F}, Vec3{1.0F, 2.0F, 3.0F});
+                scene->addModel(model);
+                children.emplace_back(child);
+                models.emplace_back(model);
+            }
+            parents.emplace_back(parent);
+        }
+    }
+
+    ~SceneFixture() {
+        scene->destroy();
+    }
+
+    // Both fixtures are seeded alike, so they receive the same edits.
+    void animate() {
+        std::uniform_int_distribution<uint32_t> pickParent(0, PARENT_COUNT - 1);
+        std::uniform_int_distribution<uint32_t> pickChild(0, PARENT_COUNT * CHILDREN_PER_PARENT - 1);
+        std::uniform_real_distribution<float> angle(0.0F, math::PI_2);
+        std::uniform_real_distribution<float> scale(0.5F, 2.0F);
+        for (uint32_t i = 0; i < PARENT_COUNT / 4; ++i) {
+            Quaternion rotation;
+            Quaternion::createFromAxisAngle(Vec3::UNIT_Y, angle(rng), &rotation);
+            parents[pickParent(rng)]->setRotation(rotation);
+        }
+        for (uint32_t i = 0; i < PARENT_COUNT; ++i) {
+            const float s = scale(rng);
+            children[pickChild(rng)]->setScale(s, s, s);
+        }
+    }
+};
+
+void expectSameWorldBounds(const SceneFixture &a, const SceneFixture &b) {
+    ASSERT_EQ(a.models.size(), b.models.size());
+    for (size_t i = 0; i < a.models.size(); ++i) {
+        const geometry::AABB *boundsA = a.models[i]->getWorldBounds();
+        const geometry::AABB *boundsB = b.models[i]->getWorldBounds();
+        ASSERT_NE(boundsA, nullptr);
+        ASSERT_NE(boundsB, nullptr);
+        EXPECT_EQ(boundsA->center, boundsB->center) << "model " << i;
+        EXPECT_EQ(boundsA->halfExtents, boundsB->halfExtents) << "model " << i;
+    }
+}
+
+// applies the same edits to a serially and a parallel updated scene, their models must match every frame
+void updateScenes(uint32_t frameCount, bool printTimings) {
+    auto *device = gfx::DeviceManager::createHeadless(gfx::DeviceInfo{});
+    ASSERT_NE(device, nullptr);
+    {
+        Root root(device);
+        SceneFixture serial(false);
+        SceneFixture parallel(true);
+
+        double serialMs = 0.0;
+        double parallelMs = 0.0;
+        for (uint32_t frame = 0; frame < frameCount; ++frame) {
+            Node::resetChangedFlags();
+            serial.animate();
+            parallel.animate();
+
+            auto begin = Clock::now();
+            serial.scene->update(frame);
+            serialMs += std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+
+            begin = Clock::now();
+            parallel.scene->update(frame);
+            parallelMs += std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+
+            expectSameWorldBounds(serial, parallel);
+            for (const auto &model : parallel.models) {
+                EXPECT_FALSE(model->getTransform()->isTransformDirty());
+            }
+        }
+        if (printTimings) {
+            printf("Updating %u models, per frame: serial %.2fms, parallel %.2fms\n",
+                   PARENT_COUNT * CHILDREN_PER_PARENT, serialMs / frameCount, parallelMs / frameCount);
+        }
+    }
+    CC_SAFE_DESTROY_AND_DELETE(device);
+}
+} // namespace
+
+TEST(RenderSceneUpdateTest, parallelMatchesSerial) {
+    updateScenes(FRAME_COUNT, false);
+}
+
+// Timing only, run with --gtest_also_run_disabled_tests.
+TEST(RenderSceneUpdateTest, DISABLED_updateThroughput) {
+    updateScenes(BENCHMARK_FRAME_COUNT, true);
+}
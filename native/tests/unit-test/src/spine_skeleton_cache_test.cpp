@@ -0,0 +1,169 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <cstring>
+#include <string>
+#include "editor-support/middleware-adapter.h"
+#include "editor-support/spine-creator-support/SkeletonCache.h"
+#include "editor-support/spine-creator-support/spine-cocos2dx.h"
+#include "editor-support/spine/spine.h"
+#include "gtest/gtest.h"
+
+using namespace spine;
+
+namespace {
+
+// One page with a single region that every slot shows.
+const char *const ATLAS = R"(
+rig.png
+size: 64,64
+format: RGBA8888
+filter: Linear,Linear
+repeat: none
+quad
+  rotate: false
+  xy: 0, 0
+  size: 32, 32
+  orig: 32, 32
+  offset: 0, 0
+  index: -1
+)";
+
+// Two bones swing and a slot fades over half a second, so every frame has a different pose.
+const char *const SKELETON = R"({
+"skeleton": {"hash": "cache", "spine": "3.8.99", "width": 64, "height": 64},
+"bones": [{"name": "root"}, {"name": "arm", "parent": "root", "length": 40, "x": 5}, {"name": "hand", "parent": "arm", "length": 20, "x": 40}],
+"slots": [{"name": "body", "bone": "root", "attachment": "quad"}, {"name": "arm", "bone": "arm", "attachment": "quad", "blend": "additive"},
+          {"name": "hand", "bone": "hand", "attachment": "quad"}],
+"skins": [{"name": "default", "attachments": {
+    "body": {"quad": {"width": 32, "height": 32}},
+    "arm": {"quad": {"x": 20, "width": 40, "height": 8}},
+    "hand": {"quad": {"x": 10, "width": 16, "height": 16}}}}],
+"animations": {"swing": {
+    "bones": {"arm": {"rotate": [{"angle": 0}, {"time": 0.5, "angle": 90}]},
+              "hand": {"rotate": [{"angle": 0}, {"time": 0.5, "angle": -45}], "translate": [{"x": 0}, {"time": 0.5, "x": 10, "y": 5}]}},
+    "slots": {"hand": {"color": [{"color": "ffffffff"}, {"time": 0.5, "color": "ff000080"}]}}
+}}
+})";
+
+void expectSameBuffer(const cc::middleware::IOBuffer &a, const cc::middleware::IOBuffer &b) {
+    ASSERT_EQ(a.getCurPos(), b.getCurPos());
+    EXPECT_EQ(0, memcmp(a.getBuffer(), b.getBuffer(), a.getCurPos()));
+}
+
+class SkeletonCacheTest : public testing::Test {
+protected:
+    void SetUp() override {
+        // without the script bindings nothing tracks the disposed spine objects
+        setSpineObjectDisposeCallback([](void * /*object*/) {});
+        _texture = new cc::middleware::Texture2D();
+        _texture->addRef();
+        _texture->setPixelsWide(64);
+        _texture->setPixelsHigh(64);
+        spAtlasPage_setCustomTextureLoader([](const char * /*path*/) { return texture; });
+        texture = _texture;
+
+        _atlas = new Atlas(ATLAS, static_cast<int>(strlen(ATLAS)), "", &_textureLoader);
+        _attachmentLoader = new Cocos2dAtlasAttachmentLoader(_atlas);
+        SkeletonJson json(_attachmentLoader);
+        _data = json.readSkeletonData(SKELETON);
+        ASSERT_NE(_data, nullptr) << json.getError().buffer();
+    }
+
+    void TearDown() override {
+        delete _data;
+        delete _attachmentLoader;
+        delete _atlas;
+        spAtlasPage_setCustomTextureLoader(nullptr);
+        texture = nullptr;
+        _texture->release();
+    }
+
+    SkeletonCache *createCache() {
+        auto *cache = new SkeletonCache();
+        cache->addRef();
+        cache->initWithData(_data);
+        cache->buildAnimationData("swing");
+        return cache;
+    }
+
+    static cc::middleware::Texture2D *texture;
+    cc::middleware::Texture2D *_texture{nullptr};
+    Cocos2dTextureLoader _textureLoader;
+    Atlas *_atlas{nullptr};
+    AttachmentLoader *_attachmentLoader{nullptr};
+    SkeletonData *_data{nullptr};
+};
+
+cc::middleware::Texture2D *SkeletonCacheTest::texture = nullptr;
+
+} // namespace
+
+TEST_F(SkeletonCacheTest, backgroundBakeMatchesUpdateToFrame) {
+    SkeletonCache *sync = createCache();
+    sync->updateToFrame("swing");
+    auto *expected = sync->getAnimationData("swing");
+    ASSERT_TRUE(expected->isComplete());
+    ASSERT_GT(expected->getFrameCount(), 10U);
+
+    SkeletonCache *async = createCache();
+    async->bakeAnimationAsync("swing");
+    auto *baked = async->getAnimationData("swing");
+    // the frames stay hidden until they are published
+    EXPECT_TRUE(async->isBaking());
+    EXPECT_EQ(baked->getFrameCount(), 0U);
+    EXPECT_EQ(baked->getFrameData(0), nullptr);
+    async->waitForBaking();
+    EXPECT_FALSE(async->isBaking());
+    EXPECT_TRUE(baked->isComplete());
+
+    ASSERT_EQ(baked->getFrameCount(), expected->getFrameCount());
+    for (std::size_t i = 0; i < expected->getFrameCount(); ++i) {
+        SCOPED_TRACE(i);
+        auto *a = expected->getFrameData(i);
+        auto *b = baked->getFrameData(i);
+        ASSERT_NE(b, nullptr);
+        expectSameBuffer(a->vb, b->vb);
+        expectSameBuffer(a->ib, b->ib);
+        ASSERT_EQ(a->getSegmentCount(), b->getSegmentCount());
+        for (std::size_t j = 0; j < a->getSegmentCount(); ++j) {
+            EXPECT_EQ(a->getSegments()[j]->indexCount, b->getSegments()[j]->indexCount);
+            EXPECT_EQ(a->getSegments()[j]->vertexFloatCount, b->getSegments()[j]->vertexFloatCount);
+            EXPECT_EQ(a->getSegments()[j]->blendMode, b->getSegments()[j]->blendMode);
+            EXPECT_EQ(b->getSegments()[j]->getTexture(), _texture);
+        }
+        ASSERT_EQ(a->getColorCount(), b->getColorCount());
+        ASSERT_EQ(a->getBoneCount(), b->getBoneCount());
+        for (std::size_t j = 0; j < a->getBoneCount(); ++j) {
+            const auto &expectedMat = a->getBones()[j]->globalTransformMatrix;
+            EXPECT_EQ(0, memcmp(expectedMat.m, b->getBones()[j]->globalTransformMatrix.m, sizeof(expectedMat.m)));
+        }
+    }
+    // the pose moves, so consecutive frames differ
+    EXPECT_NE(0, memcmp(baked->getFrameData(0)->vb.getBuffer(), baked->getFrameData(1)->vb.getBuffer(), baked->getFrameData(0)->vb.getCurPos()));
+
+    async->release();
+    sync->release();
+}
@@ -0,0 +1,557 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "editor-support/spine-creator-support/SkeletonBinaryConverter.h"
+#include "editor-support/spine-creator-support/SkeletonDataArena.h"
+#include "editor-support/spine-creator-support/spine-cocos2dx.h"
+#include "editor-support/spine/spine.h"
+#include "gtest/gtest.h"
+
+using namespace spine;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Creates attachments without an atlas so skeleton data loads without textures.
+class PlainAttachmentLoader : public AttachmentLoader {
+public:
+    RegionAttachment *newRegionAttachment(Skin & /*skin*/, const String &name, const String & /*path*/) override {
+        return new (__FILE__, __LINE__) RegionAttachment(name);
+    }
+    MeshAttachment *newMeshAttachment(Skin & /*skin*/, const String &name, const String & /*path*/) override {
+        return new (__FILE__, __LINE__) MeshAttachment(name);
+    }
+    BoundingBoxAttachment *newBoundingBoxAttachment(Skin & /*skin*/, const String &name) override {
+        return new (__FILE__, __LINE__) BoundingBoxAttachment(name);
+    }
+    PathAttachment *newPathAttachment(Skin & /*skin*/, const String &name) override {
+        return new (__FILE__, __LINE__) PathAttachment(name);
+    }
+    PointAttachment *newPointAttachment(Skin & /*skin*/, const String &name) override {
+        return new (__FILE__, __LINE__) PointAttachment(name);
+    }
+    ClippingAttachment *newClippingAttachment(Skin & /*skin*/, const String &name) override {
+        return new (__FILE__, __LINE__) ClippingAttachment(name);
+    }
+    void configureAttachment(Attachment * /*attachment*/) override {}
+};
+
+std::string num(double value) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%g", value);
+    return buffer;
+}
+
+std::string bone(int index) {
+    return index == 0 ? "root" : "b" + std::to_string(index);
+}
+
+std::string slot(int index) {
+    return "s" + std::to_string(index);
+}
+
+// Every slot i carries one attachment of kind i % 7, animations touch every
+// bone and slot so all timeline types are exercised.
+std::string makeRigJson(int boneCount, int slotCount, int animationCount) {
+    std::string json = R"({"skeleton":{"hash":"rig","spine":"3.8.99","x":-10,"y":-5,"width":200,"height":300,"fps":24,"images":"./images/","audio":"./audio/"},"bones":[)";
+    for (int i = 0; i < boneCount; ++i) {
+        json += i ? "," : "";
+        json += R"({"name":")" + bone(i) + "\"";
+        if (i > 0) {
+            json += R"(,"parent":")" + bone((i - 1) / 2) + R"(","length":)" + num(10 + i) + R"(,"x":)" + num(i * 1.5) +
+                    R"(,"y":)" + num(-i * 0.25) + R"(,"rotation":)" + num(i * 7.5) + R"(,"scaleX":)" + num(1 + i * 0.01);
+        }
+        if (i % 9 == 3) json += R"(,"transform":"noScale")";
+        if (i == 7) json += R"(,"skin":true)";
+        json += "}";
+    }
+
+    json += R"(],"slots":[)";
+    const char *blends[] = {"normal", "additive", "multiply", "screen"};
+    auto attachmentName = [](int i) {
+        const char *prefixes[] = {"r", "m", "w", "bb", "p", "pt", "c"};
+        return prefixes[i % 7] + std::to_string(i);
+    };
+    for (int i = 0; i < slotCount; ++i) {
+        json += i ? "," : "";
+        json += R"({"name":")" + slot(i) + R"(","bone":")" + bone(1 + i % (boneCount - 1)) + R"(","attachment":")" + attachmentName(i) +
+                R"(","blend":")" + blends[i % 4] + "\"";
+        if (i % 3 == 0) json += R"(,"color":"ff8040c0","dark":"102030")";
+        json += "}";
+    }
+
+    json += R"(],"ik":[{"name":"ik0","order":1,"bones":["b1","b3"],"target":"b6","mix":0.75,"softness":2,"bendPositive":false,"stretch":true}])";
+    json += R"(,"transform":[{"name":"tc0","order":2,"bones":["b4"],"target":"b2","rotation":10,"x":2,"y":-1,"scaleX":0.5,"translateMix":0.5,"scaleMix":0.25,"local":true}])";
+    json += R"(,"path":[{"name":"pc0","order":3,"bones":["b5"],"target":"s4","positionMode":"fixed","spacingMode":"percent","rotateMode":"chain","position":12,"spacing":0.5,"rotateMix":0.8}])";
+
+    json += R"(,"skins":[{"name":"default","attachments":{)";
+    for (int i = 0; i < slotCount; ++i) {
+        json += i ? "," : "";
+        std::string name = attachmentName(i);
+        json += "\"" + slot(i) + R"(":{")" + name + R"(":)";
+        switch (i % 7) {
+            case 0:
+                json += R"({"x":)" + num(i) + R"(,"y":3,"rotation":)" + num(i * 3) + R"(,"width":64,"height":48,"color":"ffffff80"})";
+                json += R"(,"alt)" + name + R"(":{"name":"alt)" + name + R"(","path":"images/alt","scaleX":2})";
+                break;
+            case 1:
+                json += R"({"type":"mesh","uvs":[0,0,1,0,1,1,0,1],"triangles":[0,1,2,2,3,0],"vertices":[-10,-10,10,-10,10,10,-10,10],"hull":4,"edges":[0,2,2,4,4,6,6,0],"width":20,"height":20})";
+                if (i % 2 == 0) json += R"(,"l)" + name + R"(":{"type":"linkedmesh","parent":")" + name + R"("})";
+                break;
+            case 2:
+                json += R"({"type":"mesh","uvs":[0,0,1,0,0.5,1],"triangles":[0,1,2],"vertices":[2,1,-5,0,0.5,2,5,0,0.5,1,3,5,0,1,1,4,0,5,1],"hull":3})";
+                break;
+            case 3:
+                json += R"({"type":"boundingbox","vertexCount":3,"vertices":[0,0,10,0,5,8]})";
+                break;
+            case 4:
+                json += R"({"type":"path","closed":false,"vertexCount":6,"vertices":[0,0,5,5,10,0,15,-5,20,0,25,5],"lengths":[10,20]})";
+                break;
+            case 5:
+                json += R"({"type":"point","x":4,"y":-4,"rotation":45})";
+                break;
+            default:
+                json += R"({"type":"clipping","end":")" + slot(std::min(i + 2, slotCount - 1)) + R"(","vertexCount":3,"vertices":[0,0,10,0,5,8]})";
+                break;
+        }
+        json += "}";
+    }
+    json += R"(}},{"name":"alt","bones":["b7"],"ik":["ik0"],"attachments":{"s1":{"lm":{"type":"linkedmesh","parent":"m1","skin":"default","deform":false}}}}])";
+
+    json += R"(,"events":{"hit":{"int":3,"float":0.5,"string":"boom"},"step":{"audio":"step.mp3","volume":0.8,"balance":-0.2}})";
+
+    json += R"(,"animations":{)";
+    for (int a = 0; a < animationCount; ++a) {
+        const double d = 1 + a * 0.1;
+        auto t = [d](double time) { return num(time * d); };
+        json += a ? "," : "";
+        json += "\"anim" + std::to_string(a) + R"(":{"slots":{)";
+        bool first = true;
+        for (int i = 0; i < slotCount; ++i) {
+            if (i % 4 == 1 || i % 4 == 3) continue;
+            json += first ? "" : ",";
+            first = false;
+            json += "\"" + slot(i) + "\":{";
+            if (i % 4 == 0) {
+                json += R"("color":[{"time":0,"color":"ff0000ff","curve":0.25,"c2":0.1,"c3":0.75,"c4":0.9},{"time":)" + t(1) + R"(,"color":"00ff0080"}])";
+            } else {
+                json += R"("twoColor":[{"time":0,"light":"ffffffff","dark":"000000","curve":"stepped"},{"time":)" + t(1) + R"(,"light":"80808080","dark":"ff0000"}])";
+            }
+            if (i % 7 == 0) {
+                json += R"(,"attachment":[{"time":0,"name":"alt)" + attachmentName(i) + R"("},{"time":)" + t(0.5) + R"(,"name":null}])";
+            }
+            json += "}";
+        }
+        json += R"(},"bones":{)";
+        for (int i = 1; i < boneCount; ++i) {
+            json += i > 1 ? "," : "";
+            json += "\"" + bone(i) + R"(":{"rotate":[{"time":0,"angle":10,"curve":0.3,"c2":0,"c3":0.6,"c4":1},{"time":)" + t(0.5) +
+                    R"(,"angle":-20},{"time":)" + t(1) + R"(,"angle":)" + num(i) + R"(}],"translate":[{"time":0,"x":1,"curve":"stepped"},{"time":)" +
+                    t(0.7) + R"(,"x":-3,"y":4}],"scale":[{"time":)" + t(0.3) + R"(,"x":1.5}])";
+            if (i % 5 == 0) json += R"(,"shear":[{"time":0},{"time":)" + t(1) + R"(,"y":15}])";
+            json += "}";
+        }
+        json += R"(},"ik":{"ik0":[{"time":0,"mix":0.5,"bendPositive":false,"compress":true},{"time":)" + t(1) + R"(,"softness":3}]})";
+        json += R"(,"transform":{"tc0":[{"time":0,"rotateMix":0.2,"scaleMix":0.5},{"time":)" + t(1) + R"(}]})";
+        json += R"(,"path":{"pc0":{"position":[{"time":0,"position":5},{"time":)" + t(1) + R"(,"position":15}],"spacing":[{"time":0,"spacing":0.2}],"mix":[{"time":)" +
+                t(0.5) + R"(,"rotateMix":0.5,"translateMix":0.2}]}})";
+        json += R"(,"deform":{"default":{)";
+        first = true;
+        for (int i = 0; i < slotCount; ++i) {
+            if (i % 7 != 1 && i % 7 != 2) continue;
+            json += first ? "" : ",";
+            first = false;
+            json += "\"" + slot(i) + R"(":{")" + attachmentName(i) + R"(":)";
+            if (i % 7 == 1) {
+                json += R"([{"time":0},{"time":)" + t(0.5) + R"(,"offset":2,"vertices":[1,2,3,4],"curve":0.5},{"time":)" + t(1) + R"(,"vertices":[1,1,1,1,1,1,1,1]}])";
+            } else {
+                json += R"([{"time":0,"vertices":[1,1,1,1,1,1,1,1]},{"time":)" + t(1) + "}]";
+            }
+            json += "}";
+        }
+        json += "}}";
+        json += R"(,"drawOrder":[{"time":)" + t(0.25) + R"(,"offsets":[{"slot":"s0","offset":3},{"slot":"s3","offset":-2}]},{"time":)" + t(0.75) + "}]";
+        json += R"(,"events":[{"time":)" + t(0.1) + R"(,"name":"hit"},{"time":)" + t(0.6) + R"(,"name":"hit","int":7,"string":"override"},{"time":)" + t(0.9) +
+                R"(,"name":"step","volume":0.5}])";
+        json += "}";
+    }
+    json += "}}";
+    return json;
+}
+
+SkeletonData *readJson(const std::string &json, AttachmentLoader *loader) {
+    SkeletonJson reader(loader);
+    reader.setScale(0.5F);
+    return reader.readSkeletonData(json.c_str());
+}
+
+SkeletonData *readBinary(const std::vector<uint8_t> &binary, AttachmentLoader *loader) {
+    SkeletonBinary reader(loader);
+    reader.setScale(0.5F);
+    return reader.readSkeletonData(binary.data(), static_cast<int>(binary.size()));
+}
+
+void expectSameVector(Vector<float> &a, Vector<float> &b) {
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) EXPECT_FLOAT_EQ(a[i], b[i]);
+}
+
+void expectSameColor(const Color &a, const Color &b) {
+    EXPECT_FLOAT_EQ(a.r, b.r);
+    EXPECT_FLOAT_EQ(a.g, b.g);
+    EXPECT_FLOAT_EQ(a.b, b.b);
+    EXPECT_FLOAT_EQ(a.a, b.a);
+}
+
+void expectSameStructure(SkeletonData &a, SkeletonData &b) {
+    EXPECT_EQ(a.getHash(), b.getHash());
+    EXPECT_EQ(a.getVersion(), b.getVersion());
+    EXPECT_FLOAT_EQ(a.getWidth(), b.getWidth());
+    EXPECT_FLOAT_EQ(a.getFps(), b.getFps());
+    EXPECT_EQ(a.getAudioPath(), b.getAudioPath());
+    ASSERT_EQ(a.getBones().size(), b.getBones().size());
+    for (size_t i = 0; i < a.getBones().size(); ++i) {
+        BoneData *boneA = a.getBones()[i];
+        BoneData *boneB = b.getBones()[i];
+        EXPECT_EQ(boneA->getName(), boneB->getName());
+        EXPECT_EQ(boneA->getParent() ? boneA->getParent()->getIndex() : -1, boneB->getParent() ? boneB->getParent()->getIndex() : -1);
+        EXPECT_FLOAT_EQ(boneA->getLength(), boneB->getLength());
+        EXPECT_EQ(boneA->getTransformMode(), boneB->getTransformMode());
+        EXPECT_EQ(boneA->isSkinRequired(), boneB->isSkinRequired());
+    }
+    ASSERT_EQ(a.getSlots().size(), b.getSlots().size());
+    for (size_t i = 0; i < a.getSlots().size(); ++i) {
+        SlotData *slotA = a.getSlots()[i];
+        SlotData *slotB = b.getSlots()[i];
+        EXPECT_EQ(slotA->getName(), slotB->getName());
+        EXPECT_EQ(slotA->getAttachmentName(), slotB->getAttachmentName());
+        EXPECT_EQ(slotA->getBlendMode(), slotB->getBlendMode());
+        EXPECT_EQ(slotA->hasDarkColor(), slotB->hasDarkColor());
+        expectSameColor(slotA->getColor(), slotB->getColor());
+        expectSameColor(slotA->getDarkColor(), slotB->getDarkColor());
+    }
+    ASSERT_EQ(a.getSkins().size(), b.getSkins().size());
+    for (size_t i = 0; i < a.getSkins().size(); ++i) {
+        Skin *skinA = a.getSkins()[i];
+        Skin *skinB = b.findSkin(skinA->getName());
+        ASSERT_NE(skinB, nullptr);
+        EXPECT_EQ(skinA->getBones().size(), skinB->getBones().size());
+        EXPECT_EQ(skinA->getConstraints().size(), skinB->getConstraints().size());
+        auto entries = skinA->getAttachments();
+        while (entries.hasNext()) {
+            auto &entry = entries.next();
+            Attachment *attachmentB = skinB->getAttachment(entry._slotIndex, entry._name);
+            ASSERT_NE(attachmentB, nullptr) << entry._name.buffer();
+            Attachment *attachmentA = entry._attachment;
+            EXPECT_EQ(attachmentA->getName(), attachmentB->getName());
+            ASSERT_TRUE(attachmentA->getRTTI().isExactly(attachmentB->getRTTI()));
+            if (attachmentA->getRTTI().isExactly(RegionAttachment::rtti)) {
+                auto *regionA = static_cast<RegionAttachment *>(attachmentA);
+                auto *regionB = static_cast<RegionAttachment *>(attachmentB);
+                EXPECT_EQ(regionA->getPath(), regionB->getPath());
+                EXPECT_FLOAT_EQ(regionA->getX(), regionB->getX());
+                EXPECT_FLOAT_EQ(regionA->getRotation(), regionB->getRotation());
+                EXPECT_FLOAT_EQ(regionA->getScaleX(), regionB->getScaleX());
+                EXPECT_FLOAT_EQ(regionA->getHeight(), regionB->getHeight());
+                expectSameColor(regionA->getColor(), regionB->getColor());
+            } else if (attachmentA->getRTTI().instanceOf(VertexAttachment::rtti)) {
+                auto *vertexA = static_cast<VertexAttachment *>(attachmentA);
+                auto *vertexB = static_cast<VertexAttachment *>(attachmentB);
+                expectSameVector(vertexA->getVertices(), vertexB->getVertices());
+                EXPECT_EQ(vertexA->getBones().size(), vertexB->getBones().size());
+                EXPECT_EQ(vertexA->getWorldVerticesLength(), vertexB->getWorldVerticesLength());
+                if (attachmentA->getRTTI().isExactly(MeshAttachment::rtti)) {
+                    auto *meshA = static_cast<MeshAttachment *>(attachmentA);
+                    auto *meshB = static_cast<MeshAttachment *>(attachmentB);
+                    expectSameVector(meshA->getRegionUVs(), meshB->getRegionUVs());
+                    EXPECT_EQ(meshA->getTriangles().size(), meshB->getTriangles().size());
+                    EXPECT_EQ(meshA->getEdges().size(), meshB->getEdges().size());
+                    EXPECT_EQ(meshA->getParentMesh() != nullptr, meshB->getParentMesh() != nullptr);
+                    EXPECT_EQ(meshA->getDeformAttachment() == meshA, meshB->getDeformAttachment() == meshB);
+                    EXPECT_FLOAT_EQ(meshA->getWidth(), meshB->getWidth());
+                } else if (attachmentA->getRTTI().isExactly(PathAttachment::rtti)) {
+                    expectSameVector(static_cast<PathAttachment *>(attachmentA)->getLengths(), static_cast<PathAttachment *>(attachmentB)->getLengths());
+                } else if (attachmentA->getRTTI().isExactly(ClippingAttachment::rtti)) {
+                    EXPECT_EQ(static_cast<ClippingAttachment *>(attachmentA)->getEndSlot()->getName(),
+                              static_cast<ClippingAttachment *>(attachmentB)->getEndSlot()->getName());
+                }
+            }
+        }
+    }
+    ASSERT_EQ(a.getEvents().size(), b.getEvents().size());
+    for (size_t i = 0; i < a.getEvents().size(); ++i) {
+        EXPECT_EQ(a.getEvents()[i]->getName(), b.getEvents()[i]->getName());
+        EXPECT_EQ(a.getEvents()[i]->getIntValue(), b.getEvents()[i]->getIntValue());
+        EXPECT_EQ(a.getEvents()[i]->getStringValue(), b.getEvents()[i]->getStringValue());
+        EXPECT_FLOAT_EQ(a.getEvents()[i]->getVolume(), b.getEvents()[i]->getVolume());
+    }
+    ASSERT_EQ(a.getAnimations().size(), b.getAnimations().size());
+    for (size_t i = 0; i < a.getAnimations().size(); ++i) {
+        Animation *animationA = a.getAnimations()[i];
+        Animation *animationB = b.getAnimations()[i];
+        EXPECT_EQ(animationA->getName(), animationB->getName());
+        EXPECT_FLOAT_EQ(animationA->getDuration(), animationB->getDuration());
+        ASSERT_EQ(animationA->getTimelines().size(), animationB->getTimelines().size());
+        for (size_t t = 0; t < animationA->getTimelines().size(); ++t) {
+            Timeline *timelineA = animationA->getTimelines()[t];
+            Timeline *timelineB = animationB->getTimelines()[t];
+            ASSERT_TRUE(timelineA->getRTTI().isExactly(timelineB->getRTTI()));
+            // Deform timeline ids are derived from attachment addresses.
+            if (!timelineA->getRTTI().isExactly(DeformTimeline::rtti)) {
+                EXPECT_EQ(timelineA->getPropertyId(), timelineB->getPropertyId());
+            }
+        }
+    }
+}
+
+// Poses both skeletons through every animation and compares what the renderer would see.
+void expectSamePoses(SkeletonData &a, SkeletonData &b) {
+    Skeleton skeletonA(&a);
+    Skeleton skeletonB(&b);
+    for (size_t i = 0; i < a.getAnimations().size(); ++i) {
+        Animation *animationA = a.getAnimations()[i];
+        Animation *animationB = b.getAnimations()[i];
+        float lastTime = -1;
+        for (float time : {0.F, 0.13F, 0.37F, 0.55F, 0.81F, 0.95F, 1.2F}) {
+            Vector<Event *> eventsA;
+            Vector<Event *> eventsB;
+            skeletonA.setToSetupPose();
+            skeletonB.setToSetupPose();
+            animationA->apply(skeletonA, lastTime, time, false, &eventsA, 1, MixBlend_Setup, MixDirection_In);
+            animationB->apply(skeletonB, lastTime, time, false, &eventsB, 1, MixBlend_Setup, MixDirection_In);
+            lastTime = time;
+            skeletonA.updateWorldTransform();
+            skeletonB.updateWorldTransform();
+
+            for (size_t j = 0; j < skeletonA.getBones().size(); ++j) {
+                Bone *boneA = skeletonA.getBones()[j];
+                Bone *boneB = skeletonB.getBones()[j];
+                EXPECT_FLOAT_EQ(boneA->getWorldX(), boneB->getWorldX());
+                EXPECT_FLOAT_EQ(boneA->getWorldY(), boneB->getWorldY());
+                EXPECT_FLOAT_EQ(boneA->getA(), boneB->getA());
+                EXPECT_FLOAT_EQ(boneA->getB(), boneB->getB());
+                EXPECT_FLOAT_EQ(boneA->getC(), boneB->getC());
+                EXPECT_FLOAT_EQ(boneA->getD(), boneB->getD());
+            }
+            for (size_t j = 0; j < skeletonA.getSlots().size(); ++j) {
+                Slot *slotA = skeletonA.getSlots()[j];
+                Slot *slotB = skeletonB.getSlots()[j];
+                expectSameColor(slotA->getColor(), slotB->getColor());
+                expectSameColor(slotA->getDarkColor(), slotB->getDarkColor());
+                ASSERT_EQ(slotA->getAttachment() != nullptr, slotB->getAttachment() != nullptr);
+                if (slotA->getAttachment()) {
+                    EXPECT_EQ(slotA->getAttachment()->getName(), slotB->getAttachment()->getName());
+                }
+                expectSameVector(slotA->getDeform(), slotB->getDeform());
+                EXPECT_EQ(skeletonA.getDrawOrder()[j]->getData().getIndex(), skeletonB.getDrawOrder()[j]->getData().getIndex());
+            }
+            ASSERT_EQ(eventsA.size(), eventsB.size());
+            for (size_t j = 0; j < eventsA.size(); ++j) {
+                EXPECT_FLOAT_EQ(eventsA[j]->getTime(), eventsB[j]->getTime());
+                EXPECT_EQ(eventsA[j]->getIntValue(), eventsB[j]->getIntValue());
+                EXPECT_EQ(eventsA[j]->getStringValue(), eventsB[j]->getStringValue());
+                EXPECT_FLOAT_EQ(eventsA[j]->getVolume(), eventsB[j]->getVolume());
+            }
+        }
+    }
+}
+
+// Without the script bindings nothing tracks the disposed spine objects.
+void ignoreDisposedObjects() {
+    setSpineObjectDisposeCallback([](void * /*object*/) {});
+}
+
+template <typename F>
+double averageMs(int iterations, F &&load) {
+    const auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i) load();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / iterations;
+}
+
+} // namespace
+
+TEST(SpineSkeletonDataTest, convertedBinaryMatchesJson) {
+    ignoreDisposedObjects();
+    const std::string json = makeRigJson(16, 22, 3);
+    PlainAttachmentLoader loader;
+
+    SkeletonBinaryConverter converter;
+    std::vector<uint8_t> binary;
+    ASSERT_TRUE(converter.convert(json.c_str(), binary)) << converter.getError();
+    EXPECT_LT(binary.size(), json.size());
+
+    SkeletonData *fromJson = readJson(json, &loader);
+    SkeletonData *fromBinary = readBinary(binary, &loader);
+    ASSERT_NE(fromJson, nullptr);
+    ASSERT_NE(fromBinary, nullptr);
+    expectSameStructure(*fromJson, *fromBinary);
+    expectSamePoses(*fromJson, *fromBinary);
+    delete fromBinary;
+    delete fromJson;
+
+    EXPECT_FALSE(converter.convert(R"({"bones":[{"name":"root"},{"name":"a","parent":"missing"}]})", binary));
+    EXPECT_NE(converter.getError().find("missing"), std::string::npos);
+}
+
+TEST(SpineSkeletonDataTest, arenaBackedDataStaysEditable) {
+    ignoreDisposedObjects();
+    const std::string json = makeRigJson(16, 22, 3);
+    PlainAttachmentLoader loader;
+    SkeletonBinaryConverter converter;
+    std::vector<uint8_t> binary;
+    ASSERT_TRUE(converter.convert(json.c_str(), binary));
+
+    auto *arena = new SkeletonDataArena();
+    SkeletonData *data = nullptr;
+    {
+        SkeletonDataArena::Scope scope(arena);
+        data = readBinary(binary, &loader);
+    }
+    ASSERT_NE(data, nullptr);
+    EXPECT_GT(arena->getUsedBytes(), 0U);
+    EXPECT_LE(arena->getUsedBytes(), arena->getReservedBytes());
+    EXPECT_TRUE(SkeletonDataArena::owns(data));
+    EXPECT_TRUE(SkeletonDataArena::owns(data->getBones()[0]));
+
+    SkeletonData *reference = readBinary(binary, &loader);
+    EXPECT_FALSE(SkeletonDataArena::owns(reference));
+    expectSameStructure(*reference, *data);
+    expectSamePoses(*reference, *data);
+
+    // Edits after loading move strings and containers out of the arena.
+    data->findEvent("hit")->setStringValue("changed");
+    EXPECT_EQ(data->findEvent("hit")->getStringValue(), "changed");
+    EXPECT_FALSE(SkeletonDataArena::owns(data->findEvent("hit")->getStringValue().buffer()));
+    Skin *skin = data->getDefaultSkin();
+    for (int i = 0; i < 64; ++i) {
+        skin->setAttachment(0, String(std::to_string(i).c_str()), new (__FILE__, __LINE__) PointAttachment("extra"));
+    }
+    EXPECT_NE(skin->getAttachment(0, "63"), nullptr);
+    data->getBones()[1]->setX(42);
+
+    delete reference;
+    delete data;
+    delete arena;
+}
+
+TEST(SpineSkeletonDataTest, arenaTagsBlocks) {
+    auto *heap = static_cast<uint8_t *>(SkeletonDataArena::allocate(24, true));
+    ASSERT_NE(heap, nullptr);
+    EXPECT_FALSE(SkeletonDataArena::owns(heap));
+    EXPECT_EQ(heap[23], 0);
+
+    SkeletonDataArena arena;
+    uint8_t *block = nullptr;
+    {
+        SkeletonDataArena::Scope scope(&arena);
+        block = static_cast<uint8_t *>(SkeletonDataArena::allocate(8));
+        memcpy(block, "abcdefg", 8);
+        // the newest block grows in place
+        EXPECT_EQ(SkeletonDataArena::reallocate(block, 32), block);
+        // heap blocks stay on the heap
+        heap = static_cast<uint8_t *>(SkeletonDataArena::reallocate(heap, 48));
+        EXPECT_FALSE(SkeletonDataArena::owns(heap));
+    }
+    EXPECT_TRUE(SkeletonDataArena::owns(block));
+
+    // out of a scope arena blocks are copied to the heap, the old one stays until the arena goes
+    auto *moved = static_cast<char *>(SkeletonDataArena::reallocate(block, 64));
+    EXPECT_FALSE(SkeletonDataArena::owns(moved));
+    EXPECT_STREQ(moved, "abcdefg");
+    SkeletonDataArena::release(block);
+    EXPECT_STREQ(reinterpret_cast<char *>(block), "abcdefg");
+
+    SkeletonDataArena::release(moved);
+    SkeletonDataArena::release(heap);
+}
+
+TEST(SpineSkeletonDataTest, zeroSizedReallocFrees) {
+    // the heap block is released, leak checkers report it otherwise
+    Cocos2dExtension extension;
+    void *block = extension._alloc(32, __FILE__, __LINE__);
+    ASSERT_NE(block, nullptr);
+    EXPECT_FALSE(SkeletonDataArena::owns(block));
+    EXPECT_EQ(extension._realloc(block, 0, __FILE__, __LINE__), nullptr);
+}
+
+TEST(SpineSkeletonDataTest, loadFromBinaryAndArena) {
+    ignoreDisposedObjects();
+    const std::string json = makeRigJson(80, 60, 12);
+    PlainAttachmentLoader loader;
+
+    SkeletonBinaryConverter converter;
+    std::vector<uint8_t> binary;
+    converter.convert(json.c_str(), binary);
+    ASSERT_FALSE(binary.empty());
+    // Binary data skips json parsing and number formatting and is a lot smaller.
+    EXPECT_LT(binary.size(), json.size() / 2);
+
+    SkeletonDataArena arena;
+    SkeletonData *data = nullptr;
+    {
+        SkeletonDataArena::Scope scope(&arena);
+        data = readBinary(binary, &loader);
+    }
+    ASSERT_NE(data, nullptr);
+    EXPECT_TRUE(SkeletonDataArena::owns(data));
+    EXPECT_GT(arena.getUsedBytes(), 0U);
+    delete data;
+}
+
+// Timing only, run with --gtest_also_run_disabled_tests.
+TEST(SpineSkeletonDataTest, DISABLED_loadThroughput) {
+    ignoreDisposedObjects();
+    constexpr int rigCount = 20;
+    const std::string json = makeRigJson(80, 60, 12);
+    PlainAttachmentLoader loader;
+
+    SkeletonBinaryConverter converter;
+    std::vector<uint8_t> binary;
+    const double convertMs = averageMs(rigCount, [&]() { converter.convert(json.c_str(), binary); });
+
+    auto load = [](SkeletonData *data) {
+        delete data;
+    };
+    const double jsonMs = averageMs(rigCount, [&]() { load(readJson(json, &loader)); });
+    const double binaryMs = averageMs(rigCount, [&]() { load(readBinary(binary, &loader)); });
+    const double arenaMs = averageMs(rigCount, [&]() {
+        SkeletonDataArena arena;
+        SkeletonData *data = nullptr;
+        {
+            SkeletonDataArena::Scope scope(&arena);
+            data = readBinary(binary, &loader);
+        }
+        load(data);
+    });
+
+    printf("[SpineSkeletonDataTest] %zu KB json, %zu KB binary, per rig: json %.3f ms, binary %.3f ms, arena binary %.3f ms, convert %.3f ms\n",
+           json.size() / 1024, binary.size() / 1024, jsonMs, binaryMs, arenaMs, convertMs);
+}
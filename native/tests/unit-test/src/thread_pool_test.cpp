@@ -0,0 +1,164 @@
+/****************************************************************************
+ Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include "base/threading/ThreadPool.h"
+#include "gtest/gtest.h"
+
+#include "utils.h"
+
+using namespace cc;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t TASK_COUNT = 100000;
+constexpr uint32_t NESTED_PARENT_COUNT = 1000;
+constexpr uint32_t NESTED_CHILD_COUNT = 100;
+
+void waitFor(const std::atomic<uint32_t> &counter, uint32_t value) {
+    while (counter.load() < value) {
+        std::this_thread::yield();
+    }
+}
+
+double toMicroseconds(Clock::duration duration) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()) / 1000.0;
+}
+} // namespace
+
+TEST(ThreadPoolTest, runsAllPriorities) {
+    ThreadPool pool;
+    pool.start();
+
+    std::atomic<uint32_t> done{0};
+    for (uint32_t i = 0; i < TASK_COUNT; ++i) {
+        pool.dispatch([&done]() { done.fetch_add(1); }, static_cast<TaskPriority>(i % static_cast<uint32_t>(TaskPriority::COUNT)));
+    }
+    waitFor(done, TASK_COUNT);
+    EXPECT_EQ(done.load(), TASK_COUNT);
+
+    auto future = pool.dispatchTask([](int a, int b) { return a * b; }, 6, 7);
+    EXPECT_EQ(future.get(), 42);
+
+    pool.stop();
+}
+
+TEST(ThreadPoolTest, stopRunsQueuedTasks) {
+    ThreadPool pool;
+    pool.start();
+
+    // keep every worker busy so that the tasks below are still queued when stop() is called
+    std::atomic<uint32_t> blocked{0};
+    std::atomic<bool> release{false};
+    auto blocker = [&]() {
+        blocked.fetch_add(1);
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    };
+    const uint32_t workerCount = pool.getWorkerCount();
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        pool.dispatch(blocker, TaskPriority::HIGH);
+    }
+    waitFor(blocked, workerCount);
+
+    std::atomic<uint32_t> done{0};
+    for (uint32_t i = 0; i < NESTED_CHILD_COUNT; ++i) {
+        pool.dispatch([&done]() { done.fetch_add(1); }, TaskPriority::LOW);
+    }
+    auto future = pool.dispatchTask([]() { return 7; });
+
+    std::thread releaser([&release]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        release.store(true);
+    });
+    pool.stop();
+    releaser.join();
+
+    EXPECT_EQ(done.load(), NESTED_CHILD_COUNT);
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+    EXPECT_EQ(future.get(), 7);
+}
+
+TEST(ThreadPoolTest, nestedDispatchRunsAll) {
+    ThreadPool pool;
+    pool.start();
+
+    // every worker spawns children into its own deque while idle workers steal
+    std::atomic<uint32_t> done{0};
+    for (uint32_t i = 0; i < NESTED_PARENT_COUNT; ++i) {
+        pool.dispatch([&pool, &done]() {
+            for (uint32_t j = 0; j < NESTED_CHILD_COUNT; ++j) {
+                pool.dispatch([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+            }
+        });
+    }
+    waitFor(done, NESTED_PARENT_COUNT * NESTED_CHILD_COUNT);
+    EXPECT_EQ(done.load(), NESTED_PARENT_COUNT * NESTED_CHILD_COUNT);
+
+    pool.stop();
+}
+
+// Timing only, run with --gtest_also_run_disabled_tests.
+TEST(ThreadPoolTest, DISABLED_benchmark) {
+    ThreadPool pool;
+    pool.start();
+
+    // spawn latency: time from dispatch until the task starts running on an idle pool
+    constexpr uint32_t LATENCY_SAMPLES = 1000;
+    double latencyTotal = 0.0;
+    for (uint32_t i = 0; i < LATENCY_SAMPLES; ++i) {
+        std::atomic<uint32_t> started{0};
+        Clock::time_point startTime;
+        const auto dispatchTime = Clock::now();
+        pool.dispatch([&]() {
+            startTime = Clock::now();
+            started.store(1);
+        });
+        waitFor(started, 1);
+        latencyTotal += toMicroseconds(startTime - dispatchTime);
+    }
+
+    // throughput under contention: every worker spawns children into its own deque while idle workers steal
+    std::atomic<uint32_t> done{0};
+    const auto begin = Clock::now();
+    for (uint32_t i = 0; i < NESTED_PARENT_COUNT; ++i) {
+        pool.dispatch([&pool, &done]() {
+            for (uint32_t j = 0; j < NESTED_CHILD_COUNT; ++j) {
+                pool.dispatch([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+            }
+        });
+    }
+    waitFor(done, NESTED_PARENT_COUNT * NESTED_CHILD_COUNT);
+    const double elapsed = toMicroseconds(Clock::now() - begin);
+
+    printf("ThreadPool: %u workers, spawn latency %.2f us, throughput %.2f tasks/us\n",
+           pool.getWorkerCount(), latencyTotal / LATENCY_SAMPLES, NESTED_PARENT_COUNT * NESTED_CHILD_COUNT / elapsed);
+    EXPECT_EQ(done.load(), NESTED_PARENT_COUNT * NESTED_CHILD_COUNT);
+
+    pool.stop();
+}
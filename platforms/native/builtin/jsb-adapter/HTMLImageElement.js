@@ -12,6 +12,7 @@ class HTMLImageElement extends HTMLElement {
         this.height = height ? height : 0;
         this._data = null;
         this._src = null;
+        this._format = undefined;
         this.complete = false;
         this.crossOrigin = null;
     }
@@ -39,6 +40,8 @@ class HTMLImageElement extends HTMLElement {
             this._data = info.data;
             this.complete = true;
             this._mipmapLevelDataSize = info.mipmapLevelDataSize;
+            // the pixel format of data, compressed textures the device can't sample arrive transcoded to RGBA8
+            this._format = info.format;
 
             var event = new Event('load');
             this.dispatchEvent(event);